@@ -0,0 +1,144 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Micro-benchmark of the CPU-side math used by probe placement and culling tools.
+// Usage: rtxgi-math-benchmark [iterations]
+
+#include "rtxgi/Math.h"
+#include "rtxgi/ddgi/DDGIVolume.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace rtxgi;
+
+namespace
+{
+    const int c_numRepeats = 5;
+
+    /**
+     * A CPU-only volume, enough to call the DDGIVolumeBase helpers.
+     */
+    class BenchmarkVolume : public DDGIVolumeBase
+    {
+    public:
+        explicit BenchmarkVolume(const DDGIVolumeDesc& desc)
+        {
+            m_desc = desc;
+            m_rotationMatrix = EulerAnglesToRotationMatrix(desc.eulerAngles);
+            m_rotationQuaternion = RotationMatrixToQuaternion(m_rotationMatrix);
+        }
+
+        void Destroy() override {}
+    };
+
+    // Accumulates results so the benchmarked code isn't optimized away
+    volatile float g_sink = 0.f;
+
+    /**
+     * Runs the function for the given number of iterations (best of c_numRepeats) and prints the time per call.
+     */
+    template<typename Function>
+    void Run(const char* name, uint32_t iterations, Function function)
+    {
+        double best = 0.0;
+        for (int repeat = 0; repeat < c_numRepeats; repeat++)
+        {
+            float sum = 0.f;
+            auto start = std::chrono::steady_clock::now();
+            for (uint32_t iteration = 0; iteration < iterations; iteration++) sum += function(iteration);
+            auto end = std::chrono::steady_clock::now();
+            g_sink = g_sink + sum;
+
+            double ns = std::chrono::duration<double, std::nano>(end - start).count() / (double)iterations;
+            if (repeat == 0 || ns < best) best = ns;
+        }
+        printf("%-32s %10.2f ns/call\n", name, best);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t iterations = 10000000;
+    if (argc > 1) iterations = (uint32_t)strtoul(argv[1], nullptr, 10);
+    if (iterations == 0) iterations = 1;
+
+#if RTXGI_MATH_SIMD_SSE2
+    printf("RTXGI math: SSE2, %u iterations\n", iterations);
+#elif RTXGI_MATH_SIMD_NEON
+    printf("RTXGI math: NEON, %u iterations\n", iterations);
+#else
+    printf("RTXGI math: scalar, %u iterations\n", iterations);
+#endif
+
+    DDGIVolumeDesc desc = {};
+    desc.origin = { 1.f, 2.f, 3.f };
+    desc.eulerAngles = { 0.1f, 0.7f, 0.3f };
+    desc.probeSpacing = { 1.f, 0.5f, 2.f };
+    desc.probeCounts = { 22, 22, 22 };
+    BenchmarkVolume volume(desc);
+    int numProbes = volume.GetNumProbes();
+
+    float3x3 rotation = EulerAnglesToRotationMatrix(desc.eulerAngles);
+    float4 quaternion = RotationMatrixToQuaternion(rotation);
+
+    Run("GetProbeWorldPosition", iterations, [&](uint32_t i)
+    {
+        float3 p = volume.GetProbeWorldPosition((int)(i % (uint32_t)numProbes));
+        return p.x + p.y + p.z;
+    });
+
+    Run("GetAxisAlignedBoundingBox", iterations, [&](uint32_t)
+    {
+        AABB aabb = volume.GetAxisAlignedBoundingBox();
+        return aabb.min.x + aabb.max.z;
+    });
+
+    Run("EulerAnglesToRotationMatrix", iterations, [&](uint32_t i)
+    {
+        float3x3 m = EulerAnglesToRotationMatrix({ (float)(i & 255) * 0.01f, 0.7f, 0.3f });
+        return m.r0.x + m.r2.z;
+    });
+
+    Run("RotationMatrixToQuaternion", iterations, [&](uint32_t i)
+    {
+        rotation.r0.x += (i & 1) ? 1e-7f : -1e-7f;
+        float4 q = RotationMatrixToQuaternion(rotation);
+        return q.x + q.w;
+    });
+
+    Run("QuaternionRotate", iterations, [&](uint32_t i)
+    {
+        float3 v = QuaternionRotate({ (float)(i & 255), 1.f, 2.f }, quaternion);
+        return v.x + v.y + v.z;
+    });
+
+    Run("QuaternionConjugate", iterations, [&](uint32_t i)
+    {
+        float4 q = QuaternionConjugate(quaternion) * (float)(i & 255);
+        return q.x + q.w;
+    });
+
+    Run("float4 multiply-add", iterations, [&](uint32_t i)
+    {
+        float4 a = { (float)(i & 255), 1.f, 2.f, 3.f };
+        float4 r = (a * quaternion) + (a - quaternion) / 2.f;
+        return r.x + r.y + r.z + r.w;
+    });
+
+    Run("float3 Normalize(Cross)", iterations, [&](uint32_t i)
+    {
+        float3 n = Normalize(Cross({ (float)(i & 255) + 1.f, 1.f, 2.f }, desc.probeSpacing));
+        return n.x + n.y + n.z;
+    });
+
+    return 0;
+}
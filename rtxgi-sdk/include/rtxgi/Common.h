@@ -65,11 +65,24 @@ namespace rtxgi
         ERROR_DDGI_MAP_FAILURE_RESOURCE_INDICES_UPLOAD_BUFFER,
         ERROR_DDGI_MAP_FAILURE_CONSTANTS_UPLOAD_BUFFER,
         ERROR_DDGI_MAP_FAILURE_VARIABILITY_READBACK_BUFFER,
+        ERROR_DDGI_INVALID_VOLUME,
+        ERROR_DDGI_INVALID_MERGED_DISPATCH_TABLE_BUFFER,
+        ERROR_DDGI_INVALID_MERGED_DISPATCH_TABLE_UPLOAD_BUFFER,
+        ERROR_DDGI_MAP_FAILURE_MERGED_DISPATCH_TABLE_UPLOAD_BUFFER,
+        ERROR_DDGI_MERGED_DISPATCH_REQUIRES_BINDLESS_RESOURCES,
+        ERROR_DDGI_INVALID_PROBE_COMPACTION_BUFFER,
+        ERROR_DDGI_PROBE_COMPACTION_REQUIRES_BINDLESS_RESOURCES,
+        ERROR_DDGI_INVALID_SNAPSHOT,
+        ERROR_DDGI_INVALID_SNAPSHOT_VERSION,
+        ERROR_DDGI_INVALID_SNAPSHOT_DATA,
+        ERROR_DDGI_SNAPSHOT_INCOMPATIBLE_VOLUME,
 
         ERROR_DDGI_D3D12_INVALID_RESOURCE_DESCRIPTOR_HEAP,
+        ERROR_DDGI_D3D12_INVALID_PROBE_COMPACTION_COMMAND_SIGNATURE,
 
         ERROR_DDGI_VK_INVALID_RESOURCE_INDICES_UPLOAD_MEMORY,
         ERROR_DDGI_VK_INVALID_CONSTANTS_UPLOAD_MEMORY,
+        ERROR_DDGI_VK_INVALID_MERGED_DISPATCH_TABLE_UPLOAD_MEMORY,
 
         // --- DDGI Status Codes -----------------------------------------
 
@@ -121,6 +134,7 @@ namespace rtxgi
         ERROR_DDGI_D3D12_INVALID_PSO_PROBE_CLASSIFICATION_RESET,
         ERROR_DDGI_D3D12_INVALID_PSO_PROBE_REDUCTION,
         ERROR_DDGI_D3D12_INVALID_PSO_PROBE_EXTRA_REDUCTION,
+        ERROR_DDGI_D3D12_INVALID_PSO_PROBE_COMPACTION,
 
         ERROR_DDGI_VK_INVALID_DESCRIPTOR_SET,
         ERROR_DDGI_VK_INVALID_PIPELINE_LAYOUT,
@@ -154,6 +168,7 @@ namespace rtxgi
         ERROR_DDGI_VK_INVALID_PIPELINE_PROBE_CLASSIFICATION_RESET,
         ERROR_DDGI_VK_INVALID_PIPELINE_PROBE_VARIABILITY_REDUCTION,
         ERROR_DDGI_VK_INVALID_PIPELINE_PROBE_VARIABILITY_EXTRA_REDUCTION,
+        ERROR_DDGI_VK_INVALID_PIPELINE_PROBE_COMPACTION,
 
         // ---------------------------------------------------------------
     };
@@ -11,8 +11,33 @@
 #pragma once
 
 #include "Common.h"
+#include "Defines.h"
 #include "Types.h"
 
+#include <math.h>
+
+// --- SIMD ----------------------------------------------------------------------------------------
+
+// Define RTXGI_MATH_SIMD to specify if float4 arithmetic uses SSE2 (x64) or NEON (ARM64) instructions.
+// 0: scalar code only (default). 1: use SIMD instructions when available.
+// Each float4 operator loads and stores its operands, so composed expressions don't stay in SIMD registers and
+// the SIMD path is slower than the scalar code (which compilers vectorize on their own) at /O2 and -O2.
+// Measure with rtxgi-math-benchmark before enabling it.
+// The math functions are defined inline in this header (they are no longer exported from the SDK library),
+// so the define applies to the code that includes it.
+#ifndef RTXGI_MATH_SIMD
+#define RTXGI_MATH_SIMD 0
+#endif
+
+#if RTXGI_MATH_SIMD && (defined(__SSE2__) || defined(_M_X64))
+    #include <emmintrin.h>
+    #define RTXGI_MATH_SIMD_SSE2 1
+#elif RTXGI_MATH_SIMD && ((defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64))
+    #include <arm_neon.h>
+    #define RTXGI_MATH_SIMD_NEON 1
+#endif
+
+
 namespace rtxgi
 {
 
@@ -27,164 +52,400 @@ namespace rtxgi
         RH_ZUP,
     };
 
-    RTXGI_API int    abs(const int value);
-    RTXGI_API float  abs(const float value);
-    RTXGI_API int    AbsFloor(const float f);
-    RTXGI_API float  Distance(const float3& a, const float3& b);
-    RTXGI_API float  Dot(const float3& a, const float3& b);
-    RTXGI_API float3 Cross(const float3& a, const float3& b);
-    RTXGI_API float3 Normalize(const float3& v);
-    RTXGI_API float3 Min(const float3& a, const float3& b);
-    RTXGI_API float3 Max(const float3& a, const float3& b);
-    RTXGI_API int    Sign(const int value);
-    RTXGI_API int    Sign(const float value);
-
-    template<typename T>
-    RTXGI_API T RadiansToDegrees(const T& radians) { return radians * 180.f / RTXGI_PI; }
-
-    template<typename T>
-    RTXGI_API T DegreesToRadians(const T& degrees) { return degrees * RTXGI_PI / 180.f; }
-
-    RTXGI_API float3 ConvertEulerAngles(const float3& input, ECoordinateSystem target);
-    RTXGI_API float4 QuaternionConjugate(const float4& q);
-    RTXGI_API float4 RotationMatrixToQuaternion(const float3x3& m);
-
-    RTXGI_API float3x3 EulerAnglesToRotationMatrix(const float3& eulerAngles);
-
-    // --- Addition ------------------------------------------------------------
-
-    RTXGI_API int2 operator+(const int2& lhs, const int2& rhs);
-    RTXGI_API int2 operator+(const int2& lhs, const float2& rhs);
-    RTXGI_API int2 operator+(const int2& lhs, const int& rhs);
-
-    RTXGI_API int3 operator+(const int3& lhs, const int3& rhs);
-    RTXGI_API int3 operator+(const int3& lhs, const float3& rhs);
-    RTXGI_API int3 operator+(const int3& lhs, const int& rhs);
-
-    RTXGI_API void operator+=(int2& lhs, const int2& rhs);
-    RTXGI_API void operator+=(int3& lhs, const int3& rhs);
-    RTXGI_API void operator+=(int4& lhs, const int4& rhs);
-
-    RTXGI_API float2 operator+(const float2& lhs, const float2& rhs);
-    RTXGI_API float2 operator+(const float2& lhs, const int2& rhs);
-    RTXGI_API float2 operator+(const float2& lhs, const float& rhs);
-    RTXGI_API float2 operator+(const float2& lhs, const int& rhs);
-
-    RTXGI_API float3 operator+(const float3& lhs, const float3& rhs);
-    RTXGI_API float3 operator+(const float3& lhs, const int3& rhs);
-    RTXGI_API float3 operator+(const float3& lhs, const float& rhs);
-    RTXGI_API float3 operator+(const float3& lhs, const int& rhs);
-
-    RTXGI_API float4 operator+(const float4& lhs, const float4& rhs);
-    RTXGI_API float4 operator+(const float4& lhs, const float& rhs);
-    RTXGI_API float4 operator+(const float4& lhs, const int& rhs);
-
-    RTXGI_API void operator+=(float2& lhs, const float2& rhs);
-    RTXGI_API void operator+=(float3& lhs, const float3& rhs);
-    RTXGI_API void operator+=(float4& lhs, const float4& rhs);
-
-    // --- Subtraction ---------------------------------------------------------
-
-    RTXGI_API int2 operator-(const int2 &lhs, const int2& rhs);
-    RTXGI_API int2 operator-(const int2 &lhs, const float2& rhs);
-    RTXGI_API int2 operator-(const int2 &lhs, const int& rhs);
-    RTXGI_API int2 operator-(const int2 &lhs, const float& rhs);
-
-    RTXGI_API int3 operator-(const int3 &lhs, const int3& rhs);
-    RTXGI_API int3 operator-(const int3 &lhs, const float3& rhs);
-    RTXGI_API int3 operator-(const int3 &lhs, const int& rhs);
-    RTXGI_API int3 operator-(const int3 &lhs, const float& rhs);
-
-    RTXGI_API float2 operator-(const float2 &lhs, const float2& rhs);
-    RTXGI_API float2 operator-(const float2 &lhs, const int2& rhs);
-    RTXGI_API float2 operator-(const float2 &lhs, const float& rhs);
-    RTXGI_API float2 operator-(const float2 &lhs, const int& rhs);
+    //------------------------------------------------------------------------
+    // SIMD Helpers
+    //------------------------------------------------------------------------
 
-    RTXGI_API float3 operator-(const float3 &lhs, const float3& rhs);
-    RTXGI_API float3 operator-(const float3 &lhs, const int3& rhs);
-    RTXGI_API float3 operator-(const float3 &lhs, const float& rhs);
-    RTXGI_API float3 operator-(const float3 &lhs, const int& rhs);
-
-    RTXGI_API float4 operator-(const float4 &lhs, const float4& rhs);
-    RTXGI_API float4 operator-(const float4 &lhs, const float& rhs);
-    RTXGI_API float4 operator-(const float4 &lhs, const int& rhs);
-
-    RTXGI_API void operator-=(float2& lhs, const float2& rhs);
-    RTXGI_API void operator-=(float3& lhs, const float3& rhs);
-    RTXGI_API void operator-=(float4& lhs, const float4& rhs);
-
-    // --- Multiplication ------------------------------------------------------
+#if RTXGI_MATH_SIMD_SSE2 || RTXGI_MATH_SIMD_NEON
+    namespace simd
+    {
+    #if RTXGI_MATH_SIMD_SSE2
+        typedef __m128 vec4;
+
+        inline vec4   Load(const float4& v) { return _mm_loadu_ps(&v.x); }
+        inline vec4   Splat(const float s) { return _mm_set1_ps(s); }
+        inline float4 Store(const vec4 v) { float4 result; _mm_storeu_ps(&result.x, v); return result; }
+        inline vec4   Add(const vec4 a, const vec4 b) { return _mm_add_ps(a, b); }
+        inline vec4   Sub(const vec4 a, const vec4 b) { return _mm_sub_ps(a, b); }
+        inline vec4   Mul(const vec4 a, const vec4 b) { return _mm_mul_ps(a, b); }
+        inline vec4   Div(const vec4 a, const vec4 b) { return _mm_div_ps(a, b); }
+    #elif RTXGI_MATH_SIMD_NEON
+        typedef float32x4_t vec4;
+
+        inline vec4   Load(const float4& v) { return vld1q_f32(&v.x); }
+        inline vec4   Splat(const float s) { return vdupq_n_f32(s); }
+        inline float4 Store(const vec4 v) { float4 result; vst1q_f32(&result.x, v); return result; }
+        inline vec4   Add(const vec4 a, const vec4 b) { return vaddq_f32(a, b); }
+        inline vec4   Sub(const vec4 a, const vec4 b) { return vsubq_f32(a, b); }
+        inline vec4   Mul(const vec4 a, const vec4 b) { return vmulq_f32(a, b); }
+        inline vec4   Div(const vec4 a, const vec4 b) { return vdivq_f32(a, b); }
+    #endif
+    }
+#endif
+
+    //------------------------------------------------------------------------
+    // Addition
+    //------------------------------------------------------------------------
+
+    inline int2 operator+(const int2& lhs, const int2& rhs) { return { lhs.x + rhs.x, lhs.y + rhs.y }; }
+    inline int2 operator+(const int2& lhs, const float2& rhs) { return { lhs.x + (int)rhs.x, lhs.y + (int)rhs.y }; }
+    inline int2 operator+(const int2& lhs, const int& rhs) { return { lhs.x + rhs, lhs.y + rhs }; }
+    inline int2 operator+(const int2& lhs, const float& rhs) { return { lhs.x + (int)rhs, lhs.y + (int)rhs }; }
+
+    inline int3 operator+(const int3& lhs, const int3& rhs) { return { lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z }; }
+    inline int3 operator+(const int3& lhs, const float3& rhs) { return { lhs.x + (int)rhs.x, lhs.y + (int)rhs.y, lhs.z + (int)rhs.z }; }
+    inline int3 operator+(const int3& lhs, const int& rhs) { return { lhs.x + rhs, lhs.y + rhs, lhs.z + rhs }; }
+    inline int3 operator+(const int3& lhs, const float& rhs) { return { lhs.x + (int)rhs, lhs.y + (int)rhs, lhs.z + (int)rhs }; }
+
+    inline void operator+=(int2& lhs, const int2& rhs) { lhs.x += rhs.x; lhs.y += rhs.y; }
+    inline void operator+=(int3& lhs, const int3& rhs) { lhs.x += rhs.x; lhs.y += rhs.y; lhs.z += rhs.z; }
+    inline void operator+=(int4& lhs, const int4& rhs) { lhs.x += rhs.x; lhs.y += rhs.y; lhs.z += rhs.z; lhs.w += rhs.w; }
+
+    inline float2 operator+(const float2& lhs, const float2& rhs) { return { lhs.x + rhs.x, lhs.y + rhs.y }; }
+    inline float2 operator+(const float2& lhs, const int2& rhs) { return { lhs.x + (float)rhs.x, lhs.y + (float)rhs.y }; }
+    inline float2 operator+(const float2& lhs, const float& rhs) { return { lhs.x + rhs, lhs.y + rhs }; }
+    inline float2 operator+(const float2& lhs, const int& rhs) { return { lhs.x + (float)rhs, lhs.y + (float)rhs }; }
+
+    inline float3 operator+(const float3& lhs, const float3& rhs) { return { lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z }; }
+    inline float3 operator+(const float3& lhs, const int3& rhs) { return { lhs.x + (float)rhs.x, lhs.y + (float)rhs.y, lhs.z + (float)rhs.z }; }
+    inline float3 operator+(const float3& lhs, const float& rhs) { return { lhs.x + rhs, lhs.y + rhs, lhs.z + rhs }; }
+    inline float3 operator+(const float3& lhs, const int& rhs) { return { lhs.x + (float)rhs, lhs.y + (float)rhs, lhs.z + (float)rhs }; }
+
+#if RTXGI_MATH_SIMD_SSE2 || RTXGI_MATH_SIMD_NEON
+    inline float4 operator+(const float4& lhs, const float4& rhs) { return simd::Store(simd::Add(simd::Load(lhs), simd::Load(rhs))); }
+    inline float4 operator+(const float4& lhs, const float& rhs) { return simd::Store(simd::Add(simd::Load(lhs), simd::Splat(rhs))); }
+#else
+    inline float4 operator+(const float4& lhs, const float4& rhs) { return { lhs.x + rhs.x, lhs.y + rhs.y, lhs.z + rhs.z, lhs.w + rhs.w }; }
+    inline float4 operator+(const float4& lhs, const float& rhs) { return { lhs.x + rhs, lhs.y + rhs, lhs.z + rhs, lhs.w + rhs }; }
+#endif
+    inline float4 operator+(const float4& lhs, const int& rhs) { return lhs + (float)rhs; }
+
+    inline void operator+=(float2& lhs, const float2& rhs) { lhs.x += rhs.x; lhs.y += rhs.y; }
+    inline void operator+=(float3& lhs, const float3& rhs) { lhs.x += rhs.x; lhs.y += rhs.y; lhs.z += rhs.z; }
+    inline void operator+=(float4& lhs, const float4& rhs) { lhs = lhs + rhs; }
+
+    //------------------------------------------------------------------------
+    // Subtraction
+    //------------------------------------------------------------------------
+
+    inline int2 operator-(const int2& lhs, const int2& rhs) { return { lhs.x - rhs.x, lhs.y - rhs.y }; }
+    inline int2 operator-(const int2& lhs, const float2& rhs) { return { lhs.x - (int)rhs.x, lhs.y - (int)rhs.y }; }
+    inline int2 operator-(const int2& lhs, const int& rhs) { return { lhs.x - rhs, lhs.y - rhs }; }
+    inline int2 operator-(const int2& lhs, const float& rhs) { return { lhs.x - (int)rhs, lhs.y - (int)rhs }; }
+
+    inline int3 operator-(const int3& lhs, const int3& rhs) { return { lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z }; }
+    inline int3 operator-(const int3& lhs, const float3& rhs) { return { lhs.x - (int)rhs.x, lhs.y - (int)rhs.y, lhs.z - (int)rhs.z }; }
+    inline int3 operator-(const int3& lhs, const int& rhs) { return { lhs.x - rhs, lhs.y - rhs, lhs.z - rhs }; }
+    inline int3 operator-(const int3& lhs, const float& rhs) { return { lhs.x - (int)rhs, lhs.y - (int)rhs, lhs.z - (int)rhs }; }
+
+    inline float2 operator-(const float2& lhs, const float2& rhs) { return { lhs.x - rhs.x, lhs.y - rhs.y }; }
+    inline float2 operator-(const float2& lhs, const int2& rhs) { return { lhs.x - (float)rhs.x, lhs.y - (float)rhs.y }; }
+    inline float2 operator-(const float2& lhs, const float& rhs) { return { lhs.x - rhs, lhs.y - rhs }; }
+    inline float2 operator-(const float2& lhs, const int& rhs) { return { lhs.x - (float)rhs, lhs.y - (float)rhs }; }
+
+    inline float3 operator-(const float3& lhs, const float3& rhs) { return { lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z }; }
+    inline float3 operator-(const float3& lhs, const int3& rhs) { return { lhs.x - (float)rhs.x, lhs.y - (float)rhs.y, lhs.z - (float)rhs.z }; }
+    inline float3 operator-(const float3& lhs, const float& rhs) { return { lhs.x - rhs, lhs.y - rhs, lhs.z - rhs }; }
+    inline float3 operator-(const float3& lhs, const int& rhs) { return { lhs.x - (float)rhs, lhs.y - (float)rhs, lhs.z - (float)rhs }; }
+
+#if RTXGI_MATH_SIMD_SSE2 || RTXGI_MATH_SIMD_NEON
+    inline float4 operator-(const float4& lhs, const float4& rhs) { return simd::Store(simd::Sub(simd::Load(lhs), simd::Load(rhs))); }
+    inline float4 operator-(const float4& lhs, const float& rhs) { return simd::Store(simd::Sub(simd::Load(lhs), simd::Splat(rhs))); }
+#else
+    inline float4 operator-(const float4& lhs, const float4& rhs) { return { lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z, lhs.w - rhs.w }; }
+    inline float4 operator-(const float4& lhs, const float& rhs) { return { lhs.x - rhs, lhs.y - rhs, lhs.z - rhs, lhs.w - rhs }; }
+#endif
+    inline float4 operator-(const float4& lhs, const int& rhs) { return lhs - (float)rhs; }
+
+    inline void operator-=(float2& lhs, const float2& rhs) { lhs.x -= rhs.x; lhs.y -= rhs.y; }
+    inline void operator-=(float3& lhs, const float3& rhs) { lhs.x -= rhs.x; lhs.y -= rhs.y; lhs.z -= rhs.z; }
+    inline void operator-=(float4& lhs, const float4& rhs) { lhs = lhs - rhs; }
+
+    //------------------------------------------------------------------------
+    // Multiplication
+    //------------------------------------------------------------------------
+
+    inline int2 operator*(const int2& lhs, const int2& rhs) { return { lhs.x * rhs.x, lhs.y * rhs.y }; }
+    inline int2 operator*(const int2& lhs, const float2& rhs) { return { lhs.x * (int)rhs.x, lhs.y * (int)rhs.y }; }
+    inline int2 operator*(const int2& lhs, const int& rhs) { return { lhs.x * rhs, lhs.y * rhs }; }
+    inline int2 operator*(const int2& lhs, const float& rhs) { return { lhs.x * (int)rhs, lhs.y * (int)rhs }; }
+
+    inline int3 operator*(const int3& lhs, const int3& rhs) { return { lhs.x * rhs.x, lhs.y * rhs.y, lhs.z * rhs.z }; }
+    inline int3 operator*(const int3& lhs, const float3& rhs) { return { lhs.x * (int)rhs.x, lhs.y * (int)rhs.y, lhs.z * (int)rhs.z }; }
+    inline int3 operator*(const int3& lhs, const int& rhs) { return { lhs.x * rhs, lhs.y * rhs, lhs.z * rhs }; }
+    inline int3 operator*(const int3& lhs, const float& rhs) { return { lhs.x * (int)rhs, lhs.y * (int)rhs, lhs.z * (int)rhs }; }
+
+    inline float3 operator*(const float3& lhs, const float3& rhs) { return { lhs.x * rhs.x, lhs.y * rhs.y, lhs.z * rhs.z }; }
+    inline float3 operator*(const float3& lhs, const int3& rhs) { return { lhs.x * (float)rhs.x, lhs.y * (float)rhs.y, lhs.z * (float)rhs.z }; }
+    inline float3 operator*(const float3& lhs, const float& rhs) { return { lhs.x * rhs, lhs.y * rhs, lhs.z * rhs }; }
+    inline float3 operator*(const float3& lhs, const int& rhs) { return { lhs.x * (float)rhs, lhs.y * (float)rhs, lhs.z * (float)rhs }; }
+
+#if RTXGI_MATH_SIMD_SSE2 || RTXGI_MATH_SIMD_NEON
+    inline float4 operator*(const float4& lhs, const float4& rhs) { return simd::Store(simd::Mul(simd::Load(lhs), simd::Load(rhs))); }
+    inline float4 operator*(const float4& lhs, const float& rhs) { return simd::Store(simd::Mul(simd::Load(lhs), simd::Splat(rhs))); }
+#else
+    inline float4 operator*(const float4& lhs, const float4& rhs) { return { lhs.x * rhs.x, lhs.y * rhs.y, lhs.z * rhs.z, lhs.w * rhs.w }; }
+    inline float4 operator*(const float4& lhs, const float& rhs) { return { lhs.x * rhs, lhs.y * rhs, lhs.z * rhs, lhs.w * rhs }; }
+#endif
+    inline float4 operator*(const float4& lhs, const int& rhs) { return lhs * (float)rhs; }
+
+    inline void operator*=(float2& lhs, const float2& rhs) { lhs.x *= rhs.x; lhs.y *= rhs.y; }
+    inline void operator*=(float3& lhs, const float3& rhs) { lhs.x *= rhs.x; lhs.y *= rhs.y; lhs.z *= rhs.z; }
+    inline void operator*=(float4& lhs, const float4& rhs) { lhs = lhs * rhs; }
+
+    //------------------------------------------------------------------------
+    // Division
+    //------------------------------------------------------------------------
+
+    inline int2 operator/(const int2& lhs, const int2& rhs) { return { lhs.x / rhs.x, lhs.y / rhs.y }; }
+    inline int2 operator/(const int2& lhs, const float2& rhs) { return { lhs.x / (int)rhs.x, lhs.y / (int)rhs.y }; }
+    inline int2 operator/(const int2& lhs, const int& rhs) { return { lhs.x / rhs, lhs.y / rhs }; }
+    inline int2 operator/(const int2& lhs, const float& rhs) { return { lhs.x / (int)rhs, lhs.y / (int)rhs }; }
+
+    inline int3 operator/(const int3& lhs, const int3& rhs) { return { lhs.x / rhs.x, lhs.y / rhs.y, lhs.z / rhs.z }; }
+    inline int3 operator/(const int3& lhs, const float3& rhs) { return { lhs.x / (int)rhs.x, lhs.y / (int)rhs.y, lhs.z / (int)rhs.z }; }
+    inline int3 operator/(const int3& lhs, const int& rhs) { return { lhs.x / rhs, lhs.y / rhs, lhs.z / rhs }; }
+    inline int3 operator/(const int3& lhs, const float& rhs) { return { lhs.x / (int)rhs, lhs.y / (int)rhs, lhs.z / (int)rhs }; }
+
+    inline float3 operator/(const float3& lhs, const float3& rhs) { return { lhs.x / rhs.x, lhs.y / rhs.y, lhs.z / rhs.z }; }
+    inline float3 operator/(const float3& lhs, const int3& rhs) { return { lhs.x / (float)rhs.x, lhs.y / (float)rhs.y, lhs.z / (float)rhs.z }; }
+    inline float3 operator/(const float3& lhs, const float& rhs) { return { lhs.x / rhs, lhs.y / rhs, lhs.z / rhs }; }
+    inline float3 operator/(const float3& lhs, const int& rhs) { return { lhs.x / (float)rhs, lhs.y / (float)rhs, lhs.z / (float)rhs }; }
+
+#if RTXGI_MATH_SIMD_SSE2 || RTXGI_MATH_SIMD_NEON
+    inline float4 operator/(const float4& lhs, const float4& rhs) { return simd::Store(simd::Div(simd::Load(lhs), simd::Load(rhs))); }
+    inline float4 operator/(const float4& lhs, const float& rhs) { return simd::Store(simd::Div(simd::Load(lhs), simd::Splat(rhs))); }
+#else
+    inline float4 operator/(const float4& lhs, const float4& rhs) { return { lhs.x / rhs.x, lhs.y / rhs.y, lhs.z / rhs.z, lhs.w / rhs.w }; }
+    inline float4 operator/(const float4& lhs, const float& rhs) { return { lhs.x / rhs, lhs.y / rhs, lhs.z / rhs, lhs.w / rhs }; }
+#endif
+    inline float4 operator/(const float4& lhs, const int& rhs) { return lhs / (float)rhs; }
+
+    inline void operator/=(float2& lhs, const float2& rhs) { lhs.x /= rhs.x; lhs.y /= rhs.y; }
+    inline void operator/=(float3& lhs, const float3& rhs) { lhs.x /= rhs.x; lhs.y /= rhs.y; lhs.z /= rhs.z; }
+    inline void operator/=(float4& lhs, const float4& rhs) { lhs = lhs / rhs; }
+
+    //------------------------------------------------------------------------
+    // Modulus
+    //------------------------------------------------------------------------
+
+    inline int2 operator%(const int2& lhs, const int2& rhs) { return { lhs.x % rhs.x, lhs.y % rhs.y }; }
+    inline int2 operator%(const int2& lhs, const int& rhs) { return { lhs.x % rhs, lhs.y % rhs }; }
+
+    inline int3 operator%(const int3& lhs, const int3& rhs) { return { lhs.x % rhs.x, lhs.y % rhs.y, lhs.z % rhs.z }; }
+    inline int3 operator%(const int3& lhs, const int& rhs) { return { lhs.x % rhs, lhs.y % rhs, lhs.z % rhs }; }
+
+    //------------------------------------------------------------------------
+    // Equalities
+    //------------------------------------------------------------------------
+
+    inline bool operator==(const int2& lhs, const int2& rhs) { return (lhs.x == rhs.x) && (lhs.y == rhs.y); }
+    inline bool operator==(const int3& lhs, const int3& rhs) { return (lhs.x == rhs.x) && (lhs.y == rhs.y) && (lhs.z == rhs.z); }
+    inline bool operator==(const float2& lhs, const float2& rhs) { return (lhs.x == rhs.x) && (lhs.y == rhs.y); }
+    inline bool operator==(const float3& lhs, const float3& rhs) { return (lhs.x == rhs.x) && (lhs.y == rhs.y) && (lhs.z == rhs.z); }
+    inline bool operator==(const float4& lhs, const float4& rhs) { return (lhs.x == rhs.x) && (lhs.y == rhs.y) && (lhs.z == rhs.z) && (lhs.w == rhs.w); }
+
+    //------------------------------------------------------------------------
+    // Inequalities
+    //------------------------------------------------------------------------
+
+    inline bool operator!=(const int2& lhs, const int2& rhs) { return !(lhs == rhs); }
+    inline bool operator!=(const int3& lhs, const int3& rhs) { return !(lhs == rhs); }
+    inline bool operator!=(const float2& lhs, const float2& rhs) { return !(lhs == rhs); }
+    inline bool operator!=(const float3& lhs, const float3& rhs) { return !(lhs == rhs); }
+    inline bool operator!=(const float4& lhs, const float4& rhs) { return !(lhs == rhs); }
+
+    //------------------------------------------------------------------------
+    // Functions
+    //------------------------------------------------------------------------
+
+    inline int abs(const int value)
+    {
+        return value < 0 ? -value : value;
+    }
 
-    RTXGI_API int2 operator*(const int2& lhs, const int2& rhs);
-    RTXGI_API int2 operator*(const int2& lhs, const float2& rhs);
-    RTXGI_API int2 operator*(const int2& lhs, const int& rhs);
-    RTXGI_API int2 operator*(const int2& lhs, const float& rhs);
+    inline float abs(const float value)
+    {
+        return value < 0.f ? -value : value;
+    }
 
-    RTXGI_API int3 operator*(const int3& lhs, const int3& rhs);
-    RTXGI_API int3 operator*(const int3& lhs, const float3& rhs);
-    RTXGI_API int3 operator*(const int3& lhs, const int& rhs);
-    RTXGI_API int3 operator*(const int3& lhs, const float& rhs);
+    inline int AbsFloor(const float value)
+    {
+        return value >= 0.f ? (int)floorf(value) : (int)ceilf(value);
+    }
 
-    RTXGI_API float3 operator*(const float3& lhs, const float3& rhs);
-    RTXGI_API float3 operator*(const float3& lhs, const int3& rhs);
-    RTXGI_API float3 operator*(const float3& lhs, const float& rhs);
-    RTXGI_API float3 operator*(const float3& lhs, const int& rhs);
+    inline float Dot(const float3& a, const float3& b)
+    {
+        return (a.x * b.x) + (a.y * b.y) + (a.z * b.z);
+    }
 
-    RTXGI_API float4 operator*(const float4& lhs, const float4& rhs);
-    RTXGI_API float4 operator*(const float4& lhs, const float& rhs);
-    RTXGI_API float4 operator*(const float4& lhs, const int& rhs);
+    inline float Distance(const float3& a, const float3& b)
+    {
+        float3 d = b - a;
+        return sqrtf(Dot(d, d));
+    }
 
-    RTXGI_API void operator*=(float2& lhs, const float2& rhs);
-    RTXGI_API void operator*=(float3& lhs, const float3& rhs);
-    RTXGI_API void operator*=(float4& lhs, const float4& rhs);
+    inline float3 Cross(const float3& a, const float3& b)
+    {
+        return { (a.y * b.z) - (a.z * b.y), (a.z * b.x) - (a.x * b.z), (a.x * b.y) - (a.y * b.x) };
+    }
 
-    // --- Division ------------------------------------------------------------
+    inline float3 Normalize(const float3& v)
+    {
+        float length = sqrtf(Dot(v, v));
+        return (v / length);
+    }
 
-    RTXGI_API int2 operator/(const int2& lhs, const int2& rhs);
-    RTXGI_API int2 operator/(const int2& lhs, const float2& rhs);
-    RTXGI_API int2 operator/(const int2& lhs, const int& rhs);
-    RTXGI_API int2 operator/(const int2& lhs, const float& rhs);
+    inline float3 Min(const float3& a, const float3& b)
+    {
+        return { fminf(a.x, b.x), fminf(a.y, b.y), fminf(a.z, b.z) };
+    }
 
-    RTXGI_API int3 operator/(const int3& lhs, const int3& rhs);
-    RTXGI_API int3 operator/(const int3& lhs, const float3& rhs);
-    RTXGI_API int3 operator/(const int3& lhs, const int& rhs);
-    RTXGI_API int3 operator/(const int3& lhs, const float& rhs);
+    inline float3 Max(const float3& a, const float3& b)
+    {
+        return { fmaxf(a.x, b.x), fmaxf(a.y, b.y), fmaxf(a.z, b.z) };
+    }
 
-    RTXGI_API float3 operator/(const float3& lhs, const float3& rhs);
-    RTXGI_API float3 operator/(const float3& lhs, const int3& rhs);
-    RTXGI_API float3 operator/(const float3& lhs, const float& rhs);
-    RTXGI_API float3 operator/(const float3& lhs, const int& rhs);
-
-    RTXGI_API float4 operator/(const float4& lhs, const float4& rhs);
-    RTXGI_API float4 operator/(const float4& lhs, const float& rhs);
-    RTXGI_API float4 operator/(const float4& lhs, const int& rhs);
-
-    RTXGI_API void operator/=(float2& lhs, const float2& rhs);
-    RTXGI_API void operator/=(float3& lhs, const float3& rhs);
-    RTXGI_API void operator/=(float4& lhs, const float4& rhs);
-
-    // --- Modulus ------------------------------------------------------------
+    inline int Sign(const int value)
+    {
+        return value >= 0 ? 1 : -1;
+    }
 
-    RTXGI_API int2 operator%(const int2& lhs, const int2& rhs);
-    RTXGI_API int2 operator%(const int2& lhs, const int& rhs);
+    inline int Sign(const float value)
+    {
+        return value >= 0.f ? 1 : -1;
+    }
 
-    RTXGI_API int3 operator%(const int3& lhs, const int3& rhs);
-    RTXGI_API int3 operator%(const int3& lhs, const int& rhs);
-
-    // --- Equalities ------------------------------------------------------------
+    template<typename T>
+    inline T RadiansToDegrees(const T& radians) { return radians * 180.f / RTXGI_PI; }
 
-    RTXGI_API bool operator==(const int2& lhs, const int2& rhs);
-    RTXGI_API bool operator==(const int3& lhs, const int3& rhs);
-    RTXGI_API bool operator==(const float2& lhs, const float2& rhs);
-    RTXGI_API bool operator==(const float3& lhs, const float3& rhs);
-    RTXGI_API bool operator==(const float4& lhs, const float4& rhs);
+    template<typename T>
+    inline T DegreesToRadians(const T& degrees) { return degrees * RTXGI_PI / 180.f; }
 
-    // --- Inequalities ------------------------------------------------------------
+    // Convert right handed, y-up Euler angles to the specified coordinate system
+    inline float3 ConvertEulerAngles(const float3& input, ECoordinateSystem target)
+    {
+        float3 result = input;
+        if (target == ECoordinateSystem::RH_ZUP)
+        {
+            result = { input.x + 90.f, input.y, input.z };
+        }
+        else if (target == ECoordinateSystem::LH_YUP)
+        {
+            result = { -input.x, -input.y, input.z };
+        }
+        else if (target == ECoordinateSystem::LH_ZUP)
+        {
+            result = { input.z, -input.x, -input.y };
+        }
+        return DegreesToRadians(result);
+    }
+
+    inline float4 QuaternionConjugate(const float4& q)
+    {
+        return { -q.x, -q.y, -q.z, q.w };
+    }
+
+    /**
+     * Rotates a vector by a quaternion (vector part in .xyz, scalar part in .w).
+     * Matches RTXGIQuaternionRotate() in the shader includes.
+     */
+    inline float3 QuaternionRotate(const float3& v, const float4& q)
+    {
+        float3 b = { q.x, q.y, q.z };
+        float b2 = Dot(b, b);
+        return (v * (q.w * q.w - b2)) + (b * (Dot(v, b) * 2.f)) + (Cross(b, v) * (q.w * 2.f));
+    }
 
-    RTXGI_API bool operator!=(const int2& lhs, const int2& rhs);
-    RTXGI_API bool operator!=(const int3& lhs, const int3& rhs);
-    RTXGI_API bool operator!=(const float2& lhs, const float2& rhs);
-    RTXGI_API bool operator!=(const float3& lhs, const float3& rhs);
-    RTXGI_API bool operator!=(const float4& lhs, const float4& rhs);
+    inline float4 RotationMatrixToQuaternion(const float3x3& m)
+    {
+        float4 q = { 0.f, 0.f, 0.f, 0.f };
+
+        float m00 = m.r0.x, m01 = m.r0.y, m02 = m.r0.z;
+        float m10 = m.r1.x, m11 = m.r1.y, m12 = m.r1.z;
+        float m20 = m.r2.x, m21 = m.r2.y, m22 = m.r2.z;
+        float diagSum = m00 + m11 + m22;
+
+        if (diagSum > 0.f)
+        {
+            q.w = sqrtf(diagSum + 1.f) * 0.5f;
+            float f = 0.25f / q.w;
+            q.x = (m21 - m12) * f;
+            q.y = (m02 - m20) * f;
+            q.z = (m10 - m01) * f;
+        }
+        else if ((m00 > m11) && (m00 > m22))
+        {
+            q.x = sqrtf(m00 - m11 - m22 + 1.f) * 0.5f;
+            float f = 0.25f / q.x;
+            q.y = (m10 + m01) * f;
+            q.z = (m02 + m20) * f;
+            q.w = (m21 - m12) * f;
+        }
+        else if (m11 > m22)
+        {
+            q.y = sqrtf(m11 - m00 - m22 + 1.f) * 0.5f;
+            float f = 0.25f / q.y;
+            q.x = (m10 + m01) * f;
+            q.z = (m21 + m12) * f;
+            q.w = (m02 - m20) * f;
+        }
+        else
+        {
+            q.z = sqrtf(m22 - m00 - m11 + 1.f) * 0.5f;
+            float f = 0.25f / q.z;
+            q.x = (m02 + m20) * f;
+            q.y = (m21 + m12) * f;
+            q.w = (m10 - m01) * f;
+        }
+
+        return q;
+    }
+
+    inline float3x3 EulerAnglesToRotationMatrix(const float3& eulerAngles)
+    {
+        float sx = sinf(eulerAngles.x);
+        float cx = cosf(eulerAngles.x);
+        float sy = sinf(eulerAngles.y);
+        float cy = cosf(eulerAngles.y);
+        float sz = sinf(eulerAngles.z);
+        float cz = cosf(eulerAngles.z);
+
+      //float3x3 Rx = {
+      //    { 1.f, 0.f, 0.f },
+      //    { 0.f,  cx, -sx },
+      //    { 0.f,  sx,  cx }
+      //};
+
+      //float3x3 Ry = {
+      //    {  cy,  0.f,  sy },
+      //    { 0.f,  1.f, 0.f },
+      //    { -sy,  0.f,  cy }
+      //};
+
+      //float3x3 Rz = {
+      //    {  cz, -sz, 0.f },
+      //    {  sz,  cz, 0.f },
+      //    { 0.f, 0.f, 1.f }
+      //};
+
+    #if RTXGI_COORDINATE_SYSTEM == RTXGI_COORDINATE_SYSTEM_LEFT_Z_UP
+        // Ryzx = Ry (pitch) * Rz (yaw) * Rx (roll)
+        float3x3 rotation = {
+            {  cy * cz, sx * sy - cx * cy * sz, cx * sy + cy * sx * sz },
+            {       sz,                cx * cz,               -cz * sx },
+            { -cz * sy, cy * sx + cx * sy * sz,  cx * cy - sx * sy * sz },
+        };
+    #else
+        // Rxyz = Rx (pitch) * Ry (yaw) * Rz (roll)
+        float3x3 rotation = {
+            {                cy * cz,               -cy * sz,       sy },
+            { cx * sz + cz * sx * sy, cx * cz - sx * sy * sz, -cy * sx },
+            { sx * sz - cx * cz * sy, cz * sx + cx * sy * sz,  cx * cy },
+        };
+    #endif
+
+        return rotation;
+    }
 
 }
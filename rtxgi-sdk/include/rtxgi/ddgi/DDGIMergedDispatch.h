@@ -0,0 +1,140 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include "DDGIVolume.h"
+
+namespace rtxgi
+{
+
+    //------------------------------------------------------------------------
+    // Merged Dispatch
+    //
+    // Probe blending, relocation, and classification dispatch once per volume by
+    // default. A merged dispatch processes the probes of many volumes with one
+    // dispatch per pass. A table of DDGIMergedDispatchEntry maps the probes of a
+    // merged dispatch to their volume, and shaders compiled with
+    // RTXGI_DDGI_MERGED_DISPATCH=1 find their volume with a binary search of the
+    // table. Merged dispatches require bindless resources.
+    //------------------------------------------------------------------------
+
+    /**
+     * The probe passes that support merged dispatch.
+     */
+    enum class EDDGIMergedDispatchPass
+    {
+        ProbeBlending = 0,          // DDGIProbeBlendingCS (irradiance and distance), one thread group per probe
+        ProbeRelocation,            // DDGIProbeRelocationCS, one thread per probe
+        ProbeClassification,        // DDGIProbeClassificationCS, one thread per probe
+        Count
+    };
+
+    /**
+     * Describes one merged dispatch of a pass.
+     */
+    struct DDGIMergedDispatchBatch
+    {
+        uint32_t volume = 0;        // Index (in the array passed to DDGIMergedDispatch::Build()) of the volume whose pipelines the batch uses
+        uint32_t firstEntry = 0;    // Index of the batch's first entry in the dispatch table
+        uint32_t numEntries = 0;    // Number of dispatch table entries (volumes) in the batch
+        uint32_t numProbes = 0;     // Number of probes in the batch, including thread group alignment padding
+        uint32_t numGroupsX = 0;    // Number of thread groups to dispatch on the X axis
+        uint32_t numGroupsY = 0;    // Number of thread groups to dispatch on the Y axis
+    };
+
+    /**
+     * Get the number of probes processed by each thread group of a pass.
+     * Dispatch table entries are aligned to this value so a thread group never spans two volumes.
+     */
+    RTXGI_API uint32_t GetDDGIMergedDispatchProbesPerGroup(EDDGIMergedDispatchPass pass);
+
+    /**
+     * Get the maximum number of dispatch table entries for the given number of volumes.
+     * Use this to size the GPU dispatch table buffer.
+     */
+    RTXGI_API uint32_t GetDDGIMergedDispatchMaxEntries(uint32_t numVolumes);
+
+    /**
+     * Get the root / push constants of a merged dispatch batch.
+     * In merged dispatch shaders, the root constants describe the batch instead of a single volume:
+     *  - volumeIndex: index of the batch's first dispatch table entry
+     *  - reductionInputSizeX: number of dispatch table entries in the batch
+     *  - reductionInputSizeY: number of probes in the batch
+     *  - reductionInputSizeZ: index of the dispatch table SRV on the descriptor heap (D3D12 descriptor heap bindless only)
+     * The constants and resource indices descriptor heap indices are copied from volumeConsts.
+     */
+    RTXGI_API DDGIRootConstants GetDDGIMergedDispatchRootConstants(const DDGIMergedDispatchBatch& batch, const DDGIRootConstants& volumeConsts, uint32_t tableDescriptorHeapIndex = 0);
+
+    /**
+     * Builds the dispatch table and batches of merged probe blending, relocation, and classification dispatches.
+     * Volumes are merged when their shaders are interchangeable: probe blending batches group volumes with the same
+     * number of irradiance and distance texels and rays per probe; relocation and classification batches group all
+     * volumes with the feature enabled. Each batch is dispatched with the pipelines of its first volume.
+     */
+    class RTXGI_API DDGIMergedDispatch
+    {
+    public:
+
+        DDGIMergedDispatch() {}
+        ~DDGIMergedDispatch();
+
+        DDGIMergedDispatch(const DDGIMergedDispatch&) = delete;
+        DDGIMergedDispatch& operator=(const DDGIMergedDispatch&) = delete;
+
+        /**
+         * Builds the dispatch table entries and batches of all passes.
+         * Table entries are stored by pass (blending, then relocation, then classification) and by batch.
+         * Within a batch, entries follow the order of the volumes array.
+         */
+        ERTXGIStatus Build(uint32_t numVolumes, const DDGIVolumeBase* const* volumes);
+
+        /**
+         * Finds the volume and probe that map to a probe of a merged dispatch batch.
+         * CPU equivalent of DDGIGetMergedDispatchProbe() in the shaders.
+         * Returns false when the probe index maps to thread group alignment padding.
+         */
+        bool GetProbe(const DDGIMergedDispatchBatch& batch, uint32_t dispatchProbeIndex, uint32_t& volumeIndex, uint32_t& probeIndex) const;
+
+        //------------------------------------------------------------------------
+        // Getters
+        //------------------------------------------------------------------------
+
+        uint32_t GetNumEntries() const { return m_numEntries; }
+        const DDGIMergedDispatchEntry* GetEntries() const { return m_entries; }
+        uint32_t GetEntriesSizeInBytes() const { return m_numEntries * (uint32_t)sizeof(DDGIMergedDispatchEntry); }
+
+        // Hash of the dispatch table entries (see GetDDGIVolumeDataHash()). Use to skip uploads of unchanged tables.
+        uint64_t GetEntriesHash() const { return m_entriesHash; }
+
+        uint32_t GetNumBatches(EDDGIMergedDispatchPass pass) const { return m_numBatches[(uint32_t)pass]; }
+        const DDGIMergedDispatchBatch* GetBatches(EDDGIMergedDispatchPass pass) const { return m_batches + m_firstBatch[(uint32_t)pass]; }
+
+        // Number of dispatches (batches) of all passes
+        uint32_t GetNumDispatches() const;
+
+    private:
+
+        void Resize(uint32_t numVolumes);
+
+        uint32_t m_maxVolumes = 0;
+
+        uint32_t m_numEntries = 0;
+        DDGIMergedDispatchEntry* m_entries = nullptr;
+        uint64_t m_entriesHash = 0;
+
+        DDGIMergedDispatchBatch* m_batches = nullptr;
+        uint32_t m_firstBatch[(uint32_t)EDDGIMergedDispatchPass::Count] = {};
+        uint32_t m_numBatches[(uint32_t)EDDGIMergedDispatchPass::Count] = {};
+
+        uint32_t* m_volumeBatch = nullptr;
+    };
+
+} // namespace rtxgi
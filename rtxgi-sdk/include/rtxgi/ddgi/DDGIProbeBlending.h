@@ -0,0 +1,81 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include "DDGIVolume.h"
+
+namespace rtxgi
+{
+    namespace cpu
+    {
+
+        //------------------------------------------------------------------------
+        // CPU Probe Blending
+        //
+        // A CPU reference implementation of DDGIProbeBlendingCS (ProbeBlendingCS.hlsl).
+        // Produces the same irradiance, distance, and variability texels as the
+        // GPU pass (within the precision of the GPU's transcendental functions)
+        // without requiring a graphics API or device.
+        //------------------------------------------------------------------------
+
+        /**
+         * Describes the CPU copies of a volume's texture arrays.
+         * Texels are tightly packed: x varies fastest, then y, then the array slice.
+         * Texture dimensions match those reported by GetDDGIVolumeTextureDimensions().
+         */
+        struct ProbeBlendingTextures
+        {
+            const void* rayData = nullptr;               // Probe ray data texels. float4 when probeRayDataFormat is F32x4, float2 (radiance packed into .x) when F32x2
+            const float4* probeData = nullptr;           // [Optional] Probe data texels (state in .w). Required when probe classification is enabled
+            float4* probeIrradiance = nullptr;           // [Optional] Probe irradiance texels (read and written). Irradiance blending is skipped when null
+            float2* probeDistance = nullptr;             // [Optional] Probe distance texels (read and written). Distance blending is skipped when null
+            float* probeVariability = nullptr;           // [Optional] Probe variability texels. Required when probe variability is enabled and irradiance is blended
+            const DDGIProbeRayAllocation* probeRayAllocations = nullptr;   // [Optional] Probe ray allocations (one per probe). Required when adaptive probe rays are enabled
+        };
+
+        /**
+         * Describes how the CPU probe blending reference executes.
+         */
+        struct ProbeBlendingDesc
+        {
+            uint32_t numThreads = 0;                                                            // Number of threads to blend probes with. 0: use all hardware threads
+            bool     useSIMD = true;                                                            // Blend texels with SIMD kernels (when available on the target), otherwise use the scalar kernels
+            bool     quantizeTexels = true;                                                     // Round texels written to the precision of the GPU texture formats below (and probeIrradianceFormat)
+            EDDGIVolumeTextureFormat probeDistanceFormat = EDDGIVolumeTextureFormat::F16x2;     // GPU texel format of the distance texture
+            EDDGIVolumeTextureFormat probeVariabilityFormat = EDDGIVolumeTextureFormat::F16;    // GPU texel format of the variability texture
+        };
+
+        /**
+         * Get the number of texels in each dimension of a volume's texture arrays, from the volume's GPU description.
+         */
+        RTXGI_API void GetDDGIVolumeTextureDimensions(const DDGIVolumeDescGPU& volume, EDDGIVolumeTextureType type, uint32_t& width, uint32_t& height, uint32_t& arraySize);
+
+        /**
+         * Averages the interior texels of each probe in a volume's probe variability texture array.
+         * probeVariability receives one value per probe, for use with DDGIProbeRayAllocator::Allocate().
+         */
+        RTXGI_API ERTXGIStatus GetDDGIVolumeProbeVariability(const DDGIVolumeDescGPU& volume, const float* variabilityTexels, float* probeVariability);
+
+        /**
+         * Returns true when the SIMD texel kernels are available on the target (SSE2 or NEON).
+         */
+        RTXGI_API bool IsProbeBlendingSIMDSupported();
+
+        /**
+         * Blends the ray data of all probes in a volume into the probe irradiance and distance texture arrays.
+         * Equivalent to dispatching the irradiance and distance variants of DDGIProbeBlendingCS, including
+         * hysteresis, the irradiance and brightness thresholds, probe variability, scrolled plane clears, probe resets,
+         * inactive probes, and the copy of border texels. Probes are distributed across desc.numThreads threads.
+         */
+        RTXGI_API ERTXGIStatus BlendDDGIVolumeProbes(const DDGIVolumeDescGPU& volume, const ProbeBlendingDesc& desc, const ProbeBlendingTextures& textures);
+
+    } // namespace cpu
+} // namespace rtxgi
@@ -0,0 +1,61 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include "DDGIVolume.h"
+
+namespace rtxgi
+{
+
+    //------------------------------------------------------------------------
+    // Probe Compaction
+    //
+    // Probe blending dispatches one thread group per probe by default, and the
+    // thread groups of inactive (and, with adaptive probe rays, converged) probes
+    // exit without blending. Probe compaction runs DDGIProbeCompactionCS (one
+    // thread per probe) to write the indices of the probes that need blending to
+    // a list in an application-owned buffer, along with indirect dispatch
+    // arguments sized to the list. Probe blending shaders compiled with
+    // RTXGI_DDGI_PROBE_COMPACTION=1 are then dispatched indirectly and read their
+    // probe from the list. Probe compaction requires bindless resources.
+    //
+    // The probe compaction buffer is a structured buffer of uints. Each volume
+    // has a region in the buffer: a DDGIProbeCompactionArgs header followed by
+    // a list of (up to) one index per probe. Regions are stored in the order of
+    // the volumes array passed to the compaction and update functions, so the
+    // same array must be used for both.
+    //------------------------------------------------------------------------
+
+    /**
+     * Get the size (in bytes) of a volume's region in the probe compaction buffer.
+     */
+    RTXGI_API uint32_t GetDDGIProbeCompactionRegionSizeInBytes(const DDGIVolumeBase* volume);
+
+    /**
+     * Get the size (in bytes) of a probe compaction buffer for numVolumes volumes with numProbes probes in total.
+     */
+    RTXGI_API uint32_t GetDDGIProbeCompactionBufferSizeInBytes(uint32_t numVolumes, uint32_t numProbes);
+
+    /**
+     * Get the offset (in bytes) of the indirect dispatch arguments of a volume's region in the probe compaction buffer.
+     */
+    RTXGI_API uint32_t GetDDGIProbeCompactionIndirectArgsOffsetInBytes(uint32_t regionOffsetInBytes);
+
+    /**
+     * Get the root / push constants of the probe compaction and compacted probe blending dispatches of a volume.
+     * The volume constants are copied from volumeConsts, and the reduction input size constants describe the volume's region:
+     *  - reductionInputSizeX: offset (in uints) of the volume's region in the probe compaction buffer
+     *  - reductionInputSizeY: 1 when clearing the volume's compaction arguments, 0 otherwise
+     *  - reductionInputSizeZ: index of the probe compaction buffer UAV (compaction) or SRV (blending) on the descriptor heap (D3D12 descriptor heap bindless only)
+     */
+    RTXGI_API DDGIRootConstants GetDDGIProbeCompactionRootConstants(const DDGIRootConstants& volumeConsts, uint32_t regionOffsetInBytes, bool clear, uint32_t bufferDescriptorHeapIndex = 0);
+
+} // namespace rtxgi
@@ -0,0 +1,109 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include "DDGIVolume.h"
+
+// The number of rays traced for probe relocation and probe classification (matches RTXGI_DDGI_NUM_FIXED_RAYS in Common.hlsl)
+#ifndef RTXGI_DDGI_NUM_FIXED_RAYS
+#define RTXGI_DDGI_NUM_FIXED_RAYS 32
+#endif
+
+namespace rtxgi
+{
+
+    //------------------------------------------------------------------------
+    // Adaptive Probe Rays
+    //
+    // By default, every probe traces DDGIVolumeDesc::probeNumRays rays per update.
+    // With adaptive probe rays, probeNumRays is the maximum number of rays per
+    // probe and a ray budget is distributed across the volume's probes by their
+    // variability: converged probes trace the minimum number of rays and volatile
+    // probes trace more. The rays of all probes are packed into the volume's
+    // RayData texture array (which is not reallocated when the budget changes),
+    // and a DDGIProbeRayAllocation per probe locates them. Shaders compiled with
+    // RTXGI_DDGI_ADAPTIVE_RAYS=1 read the allocations from an application-owned
+    // structured buffer. Adaptive probe rays require bindless resources.
+    //------------------------------------------------------------------------
+
+    /**
+     * Describes how a volume's ray budget is distributed across its probes.
+     */
+    struct DDGIProbeRayAllocatorDesc
+    {
+        uint32_t rayBudget = 0;                                 // Maximum number of rays to trace for the volume's probes per update. 0: number of probes * probeNumRays
+        uint32_t minProbeRays = RTXGI_DDGI_NUM_FIXED_RAYS;      // Number of rays traced for converged probes. At least RTXGI_DDGI_NUM_FIXED_RAYS when probe relocation or classification is enabled
+        uint32_t rayGranularity = 32;                           // Probe ray counts above the minimum are multiples of this value (e.g. the wave size of the ray tracing shader)
+        float    variabilityThreshold = 0.f;                    // Probes with variability at or below this value are considered converged and trace minProbeRays rays
+    };
+
+    /**
+     * Distributes a volume's ray budget across its probes and computes the location of each probe's rays
+     * in the packed RayData layout. Allocations are deterministic: the same inputs always produce the same allocations.
+     *
+     * Each probe traces at least minProbeRays rays. The rest of the budget is distributed to probes above the
+     * variability threshold, in proportion to their variability, and no probe traces more than probeNumRays rays.
+     * The budget is an upper bound: rays are not given to converged probes, so GetNumRays() may be lower.
+     */
+    class RTXGI_API DDGIProbeRayAllocator
+    {
+    public:
+
+        DDGIProbeRayAllocator() {}
+        ~DDGIProbeRayAllocator();
+
+        DDGIProbeRayAllocator(const DDGIProbeRayAllocator&) = delete;
+        DDGIProbeRayAllocator& operator=(const DDGIProbeRayAllocator&) = delete;
+
+        /**
+         * Computes the ray allocations of the volume's probes.
+         * probeVariability holds one value per probe (e.g. from rtxgi::cpu::GetDDGIVolumeProbeVariability()).
+         * Pass zero variability for inactive probes to trace the minimum number of rays.
+         */
+        ERTXGIStatus Allocate(const DDGIVolumeBase* volume, const DDGIProbeRayAllocatorDesc& desc, const float* probeVariability);
+
+        /**
+         * Sets the ray allocations of all probes to probeNumRays rays (the default, non-adaptive layout).
+         * Use when the volume's lighting changes to re-measure probe variability.
+         */
+        ERTXGIStatus AllocateUniform(const DDGIVolumeBase* volume);
+
+        //------------------------------------------------------------------------
+        // Getters
+        //------------------------------------------------------------------------
+
+        uint32_t GetNumProbes() const { return m_numProbes; }
+        const DDGIProbeRayAllocation* GetAllocations() const { return m_allocations; }
+        uint32_t GetAllocationsSizeInBytes() const { return m_numProbes * (uint32_t)sizeof(DDGIProbeRayAllocation); }
+
+        // Hash of the allocations (see GetDDGIVolumeDataHash()). Use to skip uploads of unchanged allocations.
+        uint64_t GetAllocationsHash() const { return m_allocationsHash; }
+
+        // Number of rays traced for all probes (the size of a one dimensional ray dispatch)
+        uint32_t GetNumRays() const { return m_numRays; }
+
+    private:
+
+        void Resize(uint32_t numProbes);
+        void Finalize();
+
+        uint32_t m_maxProbes = 0;
+        uint32_t m_numProbes = 0;
+        uint32_t m_numRays = 0;
+
+        DDGIProbeRayAllocation* m_allocations = nullptr;
+        uint64_t m_allocationsHash = 0;
+
+        double* m_shares = nullptr;             // Scratch: rays above the minimum given to each probe, before rounding
+        uint32_t* m_order = nullptr;            // Scratch: probe indices sorted by rounding remainder
+    };
+
+} // namespace rtxgi
@@ -24,6 +24,18 @@
 #error RTXGI_DDGI_RESOURCE_MANAGEMENT is not defined!
 #endif
 
+// --- Probe Variability Readback ------------------------------------------------------------------
+
+// Define RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE to specify the number of slots in each volume's probe variability readback buffer.
+// A slot written by the GPU in frame N is read on the CPU in frame N + (RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE - 1),
+// so this must be at least the number of frames the CPU can run ahead of the GPU plus one. Default is 3.
+#ifndef RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE
+#define RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE 3
+#endif
+
+// Frame index of a probe variability readback slot (or average variability value) that hasn't been written
+#define RTXGI_DDGI_VARIABILITY_READBACK_INVALID_FRAME 0xFFFFFFFFFFFFFFFFull
+
 namespace rtxgi
 {
     #include "DDGIRootConstants.h"
@@ -83,7 +95,7 @@ namespace rtxgi
     {
         char*           name = nullptr;                         // Name of the volume
         uint32_t        index = 0;                              // Index of the volume in the constants structured buffer
-        uint32_t        rngSeed = 0;                            // A seed for the random number generator (optional). A non-zero value manually initializes the seed used for rotation generation. Leave as zero to use the default (based on system time).
+        uint32_t        rngSeed = 0;                            // A seed for the random number generator (optional). A non-zero value manually initializes the seed used for rotation generation. Leave as zero to use a random seed (from std::random_device).
 
         bool            showProbes = false;                     // A flag for toggling probe visualizations for this volume
         bool            insertPerfMarkers = false;              // A flag for toggling volume-specific perf markers in the graphics command list (for debugging and tools)
@@ -158,6 +170,10 @@ namespace rtxgi
         // Probe variability tracks the change in probes between updates as a proxy for convergence
         bool            probeVariabilityEnabled = false;
 
+        // Adaptive probe rays trace a variable number of rays per probe (up to probeNumRays), see DDGIProbeRayAllocator.
+        // Requires bindless resources and shaders compiled with RTXGI_DDGI_ADAPTIVE_RAYS=1.
+        bool            probeAdaptiveRaysEnabled = false;
+
         // The type of movement the volume supports
         EDDGIVolumeMovementType movementType = EDDGIVolumeMovementType::Default;
 
@@ -212,6 +228,18 @@ namespace rtxgi
      */
     RTXGI_API void GetDDGIVolumeTextureDimensions(const DDGIVolumeDesc& desc, EDDGIVolumeTextureType type, uint32_t& width, uint32_t& height, uint32_t& arraySize);
 
+    /**
+     * Get a 64-bit hash (FNV-1a) of a block of GPU data. Never returns 0.
+     * Used to detect volumes whose constants or resource indices have not changed since they were last uploaded.
+     */
+    RTXGI_API uint64_t GetDDGIVolumeDataHash(const void* data, size_t size);
+
+    /**
+     * Get four uniform random floats in [0, 1) from a counter-based generator (Philox4x32-10).
+     * The result depends only on the arguments, so any counter can be evaluated directly and from any thread.
+     */
+    RTXGI_API float4 GetDDGIRandomFloat4(uint32_t seed, uint64_t counter, uint32_t stream = 0);
+
     /**
      * DDGIVolume abstract base class. Instantiate the API-specific subclass.
      */
@@ -226,10 +254,45 @@ namespace rtxgi
         void  SeedRNG(const int seed);
         float GetRandomFloat();
 
+        /**
+         * Set the frame index used for the next probe ray rotation. Update() increments the frame index,
+         * so setting it reproduces the rotations of a given frame without replaying the earlier ones.
+         */
+        void SetRNGFrame(uint64_t frameIndex) { m_rngFrame = frameIndex; }
+        uint64_t GetRNGFrame() const { return m_rngFrame; }
+        uint32_t GetRNGSeed() const { return m_rngSeed; }
+
+        /**
+         * Compute the random probe ray rotation for the given seed and frame index.
+         * Stateless and thread-safe; Update() uses the volume's seed and frame index.
+         */
+        static float3x3 ComputeRandomRotation(uint32_t seed, uint64_t frameIndex);
+
+        //------------------------------------------------------------------------
         // Event Handlers
-        virtual void OnGlobalLightChange() {}
-        virtual void OnLargeObjectChange() {}
-        virtual void OnSmallLightChange() {}
+        //
+        // Scene changes reset the probes they affect: in the next update, the probes
+        // blend with lowered hysteresis (as when a large lighting change is detected).
+        // The events that occur before the volume's next Update() are combined.
+        //------------------------------------------------------------------------
+
+        /**
+         * A change that affects the whole volume (e.g. the sun or the sky changed).
+         * Resets all probes and discards the probe variability readbacks.
+         */
+        virtual void OnGlobalLightChange();
+
+        /**
+         * An object moved, appeared, or disappeared within the given world-space bounds.
+         * Resets the probes within probeMaxRayDistance of the bounds.
+         */
+        virtual void OnLargeObjectChange(const AABB& bounds);
+
+        /**
+         * A light with the given world-space position and radius of influence changed.
+         * Resets the probes within probeMaxRayDistance of the light's sphere of influence.
+         */
+        virtual void OnSmallLightChange(const float3& position, float radius);
 
         // Releases resources owned by the volume
         virtual void Destroy() = 0;
@@ -259,6 +322,9 @@ namespace rtxgi
 
         void SetScrollAnchor(const float3& value) { m_probeScrollAnchor = value; }
 
+        // Sets the grid-space scroll offsets of a scrolling volume, e.g. to restore a DDGIVolumeSnapshot
+        void SetScrollOffsets(const int3& value) { m_probeScrollOffsets = value; }
+
         void SetProbeSpacing(const float3& value) { m_desc.probeSpacing = value; }
 
         void SetEulerAngles(const float3& eulerAngles);
@@ -299,6 +365,34 @@ namespace rtxgi
         void SetProbeVariabilityEnabled(bool value) { m_desc.probeVariabilityEnabled = value; }
 
         void SetVolumeAverageVariability(float value) { m_averageVariability = value; };
+        void SetVolumeAverageVariability(float value, uint64_t frameIndex) { m_averageVariability = value; m_averageVariabilityFrame = frameIndex; };
+
+        /**
+         * Tags the probe variability readback slot of the given frame as written by the GPU in that frame.
+         * Returns the slot index. Used by rtxgi::[d3d12|vulkan]::CalculateDDGIVolumeVariability().
+         */
+        uint32_t SetProbeVariabilityReadbackFrame(uint64_t frameIndex);
+
+        /**
+         * Discards all probe variability readback slots and the current average variability value.
+         */
+        void ResetProbeVariabilityReadback();
+
+        // Adaptive Probe Ray Setters
+        void SetProbeAdaptiveRaysEnabled(bool value) { m_desc.probeAdaptiveRaysEnabled = value; }
+
+        /**
+         * Sets the location of the volume's probe ray allocations: the index of the volume's first probe in the
+         * probe ray allocations structured buffer and (D3D12 descriptor heap bindless only) the buffer's SRV index.
+         */
+        void SetProbeRayAllocations(uint32_t offset, uint32_t descriptorHeapIndex = 0) { m_probeRayAllocationOffset = offset; m_probeRayAllocationsIndex = descriptorHeapIndex; }
+
+        // Upload Tracking
+        void SetConstantsHash(uint64_t value) { m_constantsHash = value; }
+
+        void SetResourceIndicesHash(uint64_t value) { m_resourceIndicesHash = value; }
+
+        void SetGPUDataDirty() { m_constantsHash = 0; m_resourceIndicesHash = 0; }
 
         //------------------------------------------------------------------------
         // Getters
@@ -387,10 +481,51 @@ namespace rtxgi
 
         float GetVolumeAverageVariability() const { return m_averageVariability; };
 
+        /**
+         * Gets the most recent average variability read back from the GPU and the frame index that produced it
+         * (RTXGI_DDGI_VARIABILITY_READBACK_INVALID_FRAME if no value has been read back). The value is
+         * (current frame - frameIndex) frames old.
+         */
+        float GetVolumeAverageVariability(uint64_t& frameIndex) const { frameIndex = m_averageVariabilityFrame; return m_averageVariability; };
+
+        /**
+         * Gets the newest probe variability readback slot that the GPU has finished writing by the given frame
+         * and that is newer than the current average variability value. Returns false if there is none.
+         * Used by rtxgi::[d3d12|vulkan]::ReadbackDDGIVolumeVariability().
+         */
+        bool GetProbeVariabilityReadbackSlot(uint64_t frameIndex, uint32_t& slot) const;
+
+        uint64_t GetProbeVariabilityReadbackFrame(uint32_t slot) const { return m_variabilityReadbackFrames[slot] - 1; }
+
+        // Probe Reset Getters
+
+        /**
+         * Whether scene change events are waiting for the volume's next Update() to reset probes.
+         * Volumes with pending resets should be updated even when their probes are converged.
+         */
+        bool GetProbeResetPending() const { return m_probeResetPending; }
+
+        /**
+         * Gets the grid-space (unscrolled) coordinates of the probes reset by the last Update(). Returns false if none are.
+         */
+        bool GetProbeReset(int3& probeMin, int3& probeMax) const { probeMin = m_probeResetMin; probeMax = m_probeResetMax; return m_probeReset; }
+
+        // Adaptive Probe Ray Getters
+        bool GetProbeAdaptiveRaysEnabled() const { return m_desc.probeAdaptiveRaysEnabled; }
+
+        uint32_t GetProbeRayAllocationOffset() const { return m_probeRayAllocationOffset; }
+
+        uint32_t GetProbeRayAllocationsIndex() const { return m_probeRayAllocationsIndex; }
+
+        // Upload Tracking
+        uint64_t GetConstantsHash() const { return m_constantsHash; }
+
+        uint64_t GetResourceIndicesHash() const { return m_resourceIndicesHash; }
+
     protected:
 
-        void ComputeRandomRotation();
         void ComputeScrolling();
+        void ComputeProbeReset();
         int3 GetProbeGridCoords(int probeIndex) const;
 
     protected:
@@ -416,10 +551,30 @@ namespace rtxgi
         int3           m_probeScrollDirections = { 0, 0, 0 };                  // Direction of scrolling movement
         bool           m_probeScrollClear[3] = { 0, 0, 0 };                    // If probes of a plane need to be cleared due to scrolling movement
 
+        bool           m_probeResetPending = false;                            // If scene change events occurred since the last update
+        bool           m_probeResetAll = false;                                // If a scene change event affects all probes
+        AABB           m_probeResetBounds = {};                                // World-space bounds of the scene change events since the last update
+        bool           m_probeReset = false;                                   // If probes need to be reset due to scene changes
+        int3           m_probeResetMin = { 0, 0, 0 };                          // Grid-space coordinates of the first probe to reset
+        int3           m_probeResetMax = { 0, 0, 0 };                          // Grid-space coordinates of the last probe to reset
+
         float          m_averageVariability = 0;                               // Average variability for last update's probe irradiance values
+        uint32_t       m_rngSeed = 0;                                          // Seed of the volume's random number generator
+        uint64_t       m_rngFrame = 0;                                         // Frame index of the next probe ray rotation
+        uint64_t       m_rngCounter = 0;                                       // Counter of the random numbers returned by GetRandomFloat()
+
+        uint64_t       m_averageVariabilityFrame = RTXGI_DDGI_VARIABILITY_READBACK_INVALID_FRAME; // Frame index that produced m_averageVariability
+
+        uint64_t       m_variabilityReadbackFrames[RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE] = {}; // Frame index (plus one) written to each probe variability readback slot (0: not written)
+
+        uint32_t       m_probeRayAllocationOffset = 0;                         // Index of the volume's first probe in the probe ray allocations structured buffer
+        uint32_t       m_probeRayAllocationsIndex = 0;                         // Index of the probe ray allocations structured buffer SRV on the descriptor heap
 
         bool           m_insertPerfMarkers = false;                            // Toggles whether the volume will insert performance markers in the graphics command list.
 
+        uint64_t       m_constantsHash = 0;                                    // Hash of the packed constants last uploaded to the GPU (0: upload required)
+        uint64_t       m_resourceIndicesHash = 0;                              // Hash of the resource indices last uploaded to the GPU (0: upload required)
+
     private:
 
         void ScrollReset();
@@ -40,6 +40,51 @@ struct DDGIVolumeResourceIndices
     //------------------------------------------------- 48B
 };
 
+// The maximum number of thread groups on the X axis of a merged dispatch.
+// Merged dispatches with more thread groups wrap onto the Y axis.
+#define RTXGI_DDGI_MERGED_DISPATCH_MAX_GROUPS_X 65535
+
+/**
+ * Describes a range of a DDGIVolume's probes in a merged (multi-volume) dispatch.
+ * See DDGIMergedDispatch.h.
+ */
+struct DDGIMergedDispatchEntry
+{
+    uint     volumeIndex;                        // Index of the volume in the DDGIVolume constants and resource indices structured buffers
+    uint     dispatchProbeOffset;                // Index of the range's first probe in the merged dispatch
+    uint     probeOffset;                        // Index of the range's first probe in the volume
+    uint     numProbes;                          // Number of probes in the range
+    //------------------------------------------------- 16B
+};
+
+/**
+ * Describes the rays traced for a probe when adaptive probe rays are enabled.
+ * Rays of all probes are packed into the volume's RayData texture array. See DDGIProbeRayAllocator.h.
+ */
+struct DDGIProbeRayAllocation
+{
+    uint     rayOffset;                          // Index of the probe's first ray in the volume's packed ray data
+    uint     numRays;                            // Number of rays traced for the probe
+    //------------------------------------------------- 8B
+};
+
+// The maximum number of thread groups on the X axis of an indirect (compacted) probe blending dispatch.
+// Compacted dispatches with more thread groups wrap onto the Y axis.
+#define RTXGI_DDGI_PROBE_COMPACTION_MAX_GROUPS_X 65535
+
+/**
+ * The header of a DDGIVolume's region in the probe compaction buffer, followed by the compacted probe list.
+ * See DDGIProbeCompaction.h.
+ */
+struct DDGIProbeCompactionArgs
+{
+    uint     numProbes;                          // Number of probes in the compacted probe list
+    uint     threadGroupCountX;                  // Indirect dispatch arguments of the compacted probe blending dispatches
+    uint     threadGroupCountY;
+    uint     threadGroupCountZ;
+    //------------------------------------------------- 16B
+};
+
 /**
  * Describes the properties of a DDGIVolume, with values packed to compact formats.
  * This version of the struct uses 128B to store some values at full precision.
@@ -75,7 +120,10 @@ struct DDGIVolumeDescGPUPacked
                             // probeScrollClear Y-Z plane (1), probeScrollClear X-Z plane (1), probeScrollClear X-Y plane (1)
                             // probeScrollDirection Y-Z plane (1), probeScrollDirection X-Z plane (1), probeScrollDirection X-Y plane (1)
     //------------------------------------------------- 112B
-    uint4    reserved;      // 16B reserved for future use
+    uint     packed5;       // probeAdaptiveRaysEnabled (1), probeResetEnabled (1), probeResetMin.x (10), probeResetMin.y (10), probeResetMin.z (10)
+    uint     probeRayAllocationOffset;
+    uint     probeRayAllocationsIndex;
+    uint     packed6;       // probeResetMax.x (10), probeResetMax.y (10), probeResetMax.z (10), unused (2)
     //------------------------------------------------- 128B
 };
 
@@ -124,6 +172,16 @@ struct DDGIVolumeDescGPU
     bool     probeRelocationEnabled;             // whether probe relocation is enabled for this volume
     bool     probeClassificationEnabled;         // whether probe classification is enabled for this volume
     bool     probeVariabilityEnabled;            // whether probe variability is enabled for this volume
+
+    // Adaptive Probe Rays
+    bool     probeAdaptiveRaysEnabled;           // whether probes trace a variable number of rays (see DDGIProbeRayAllocation)
+    uint     probeRayAllocationOffset;           // index of the volume's first probe in the probe ray allocations structured buffer
+    uint     probeRayAllocationsIndex;           // index of the probe ray allocations structured buffer SRV on the descriptor heap (D3D12 descriptor heap bindless only)
+
+    // Scene Change Events
+    bool     probeResetEnabled;                  // whether probes need to be reset due to scene changes (see DDGIVolumeBase::OnLargeObjectChange())
+    int3     probeResetMin;                      // grid-space (unscrolled) coordinates of the first probe to reset
+    int3     probeResetMax;                      // grid-space (unscrolled) coordinates of the last probe to reset
 };
 
 #ifndef HLSL // CPU only
@@ -178,6 +236,20 @@ static inline rtxgi::DDGIVolumeDescGPUPacked PackDDGIVolumeDescGPU(const rtxgi::
     output.packed4 = (output.packed4 & ~0x40000000) | (input.probeScrollDirections[1] << 30);
     output.packed4 = (output.packed4 & ~0x80000000) | (input.probeScrollDirections[2] << 31);
 
+    // Adaptive Probe Rays
+    output.packed5 = (uint32_t)input.probeAdaptiveRaysEnabled;
+    output.probeRayAllocationOffset = input.probeRayAllocationOffset;
+    output.probeRayAllocationsIndex = input.probeRayAllocationsIndex;
+
+    // Scene Change Events
+    output.packed5 |= (uint32_t)input.probeResetEnabled << 1;
+    output.packed5 |= (uint32_t)input.probeResetMin.x << 2;
+    output.packed5 |= (uint32_t)input.probeResetMin.y << 12;
+    output.packed5 |= (uint32_t)input.probeResetMin.z << 22;
+    output.packed6  = (uint32_t)input.probeResetMax.x;
+    output.packed6 |= (uint32_t)input.probeResetMax.y << 10;
+    output.packed6 |= (uint32_t)input.probeResetMax.z << 20;
+
     return output;
 }
 #endif // ifndef HLSL
@@ -241,6 +313,20 @@ DDGIVolumeDescGPU UnpackDDGIVolumeDescGPU(DDGIVolumeDescGPUPacked input)
     output.probeScrollDirections[1] = (bool)((input.packed4 >> 30) & 0x00000001);
     output.probeScrollDirections[2] = (bool)((input.packed4 >> 31) & 0x00000001);
 
+    // Adaptive Probe Rays
+    output.probeAdaptiveRaysEnabled = (bool)(input.packed5 & 0x00000001);
+    output.probeRayAllocationOffset = input.probeRayAllocationOffset;
+    output.probeRayAllocationsIndex = input.probeRayAllocationsIndex;
+
+    // Scene Change Events
+    output.probeResetEnabled = (bool)((input.packed5 >> 1) & 0x00000001);
+    output.probeResetMin.x = (input.packed5 >> 2) & 0x000003FF;
+    output.probeResetMin.y = (input.packed5 >> 12) & 0x000003FF;
+    output.probeResetMin.z = (input.packed5 >> 22) & 0x000003FF;
+    output.probeResetMax.x = input.packed6 & 0x000003FF;
+    output.probeResetMax.y = (input.packed6 >> 10) & 0x000003FF;
+    output.probeResetMax.z = (input.packed6 >> 20) & 0x000003FF;
+
     return output;
 }
 
@@ -0,0 +1,143 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include "DDGIVolume.h"
+
+namespace rtxgi
+{
+
+    //------------------------------------------------------------------------
+    // Volume Update Scheduling
+    //
+    // Selects which volumes are updated (ray traced and blended) each frame.
+    // Volumes are scored by visibility (frustum vs. oriented bounding box),
+    // distance to the camera, probe variability, and the number of frames since
+    // the volume was last updated. The highest priority volumes are selected
+    // until the frame's ray budget is exhausted.
+    //------------------------------------------------------------------------
+
+    /**
+     * A view frustum described by inward facing planes.
+     * A point p is inside a plane when dot(plane.xyz, p) + plane.w >= 0.
+     */
+    struct DDGIFrustum
+    {
+        float4   planes[6];
+        uint32_t numPlanes = 0;
+    };
+
+    /**
+     * Describes how volumes are prioritized.
+     */
+    struct DDGIVolumeSchedulerDesc
+    {
+        float    distanceFalloff = 10.f;     // World-space distance (from the camera to a volume's bounds) at which a volume's priority is halved
+        float    visibleWeight = 1.f;        // Priority multiplier of volumes that intersect the view frustum
+        float    invisibleWeight = 0.1f;     // Priority multiplier of volumes outside the view frustum. 0: volumes outside the frustum are never updated
+        float    variabilityWeight = 1.f;    // Priority contributed by a volume's average probe variability (volumes without variability enabled contribute 1)
+        float    stalenessWeight = 1.f;      // Priority contributed by the number of frames since a volume was last updated (scaled by stalenessFrames)
+        uint32_t stalenessFrames = 60;       // Number of frames without an update for a volume to reach the full stalenessWeight (staleness is clamped there)
+    };
+
+    /**
+     * Per-frame inputs to the scheduler.
+     */
+    struct DDGIVolumeSchedulerInputs
+    {
+        float3      cameraPosition = {};     // World-space position of the camera
+        DDGIFrustum frustum = {};            // View frustum. A frustum with no planes treats all volumes as visible
+        uint64_t    rayBudget = 0;           // Maximum number of probe rays traced per frame. 0: no limit
+    };
+
+    /**
+     * Computes the (far plane free) view frustum of a perspective camera from its world-space position and orthonormal basis.
+     * The right, up, and forward vectors follow the application's coordinate system convention.
+     */
+    RTXGI_API DDGIFrustum ComputeDDGIFrustum(const float3& position, const float3& forward, const float3& right, const float3& up, float tanHalfFovY, float aspect);
+
+    /**
+     * Returns true when a volume's oriented bounding box intersects (or is inside) the frustum.
+     */
+    RTXGI_API bool IntersectDDGIFrustum(const DDGIFrustum& frustum, const OBB& obb);
+
+    /**
+     * Returns the world-space distance from a point to an oriented bounding box (0 when the point is inside).
+     */
+    RTXGI_API float GetDistanceToOrientedBoundingBox(const float3& point, const OBB& obb);
+
+    /**
+     * Prioritizes volume updates and selects the volumes to update each frame.
+     * The scheduler tracks the number of frames since each volume was updated by
+     * the volume's position in the array passed to Schedule().
+     */
+    class RTXGI_API DDGIVolumeScheduler
+    {
+    public:
+
+        DDGIVolumeScheduler() {}
+        ~DDGIVolumeScheduler();
+
+        DDGIVolumeScheduler(const DDGIVolumeScheduler&) = delete;
+        DDGIVolumeScheduler& operator=(const DDGIVolumeScheduler&) = delete;
+
+        /**
+         * Scores the volumes and writes the array indices of the volumes to update this frame to selectedIndices,
+         * highest priority first. Volumes are selected greedily: a volume that does not fit in the remaining ray
+         * budget is skipped and lower priority volumes that do fit are still selected. When no volume fits, the
+         * highest priority volume is selected so the frame always makes progress.
+         * The enabled array is optional; volumes with a zero entry are never selected (e.g. converged volumes).
+         * The selectedIndices array must have room for numVolumes entries. Returns the number of selected volumes.
+         */
+        uint32_t Schedule(const DDGIVolumeSchedulerInputs& inputs, uint32_t numVolumes, const DDGIVolumeBase* const* volumes, const uint8_t* enabled, uint32_t* selectedIndices);
+
+        // Forget the update history of all volumes (e.g. when the set of volumes changes)
+        void Reset();
+
+        //------------------------------------------------------------------------
+        // Setters
+        //------------------------------------------------------------------------
+
+        void SetDesc(const DDGIVolumeSchedulerDesc& desc) { m_desc = desc; }
+
+        //------------------------------------------------------------------------
+        // Getters
+        //------------------------------------------------------------------------
+
+        DDGIVolumeSchedulerDesc GetDesc() const { return m_desc; }
+
+        // Priority of a volume computed by the last call to Schedule()
+        float GetVolumeScore(uint32_t volumeIndex) const { return (volumeIndex < m_numVolumes) ? m_scores[volumeIndex] : 0.f; }
+
+        // Whether a volume intersected the frustum in the last call to Schedule()
+        bool GetVolumeVisible(uint32_t volumeIndex) const { return (volumeIndex < m_numVolumes) ? m_visible[volumeIndex] : false; }
+
+        // Number of frames since a volume was last selected for update
+        uint32_t GetFramesSinceUpdate(uint32_t volumeIndex) const { return (volumeIndex < m_numVolumes) ? m_framesSinceUpdate[volumeIndex] : 0; }
+
+        // Number of probe rays traced by the volumes selected in the last call to Schedule()
+        uint64_t GetScheduledRayCount() const { return m_scheduledRays; }
+
+    private:
+
+        void Resize(uint32_t numVolumes);
+
+        DDGIVolumeSchedulerDesc m_desc = {};
+
+        uint32_t  m_numVolumes = 0;
+        uint32_t* m_framesSinceUpdate = nullptr;
+        float*    m_scores = nullptr;
+        bool*     m_visible = nullptr;
+        uint32_t* m_order = nullptr;
+        uint64_t  m_scheduledRays = 0;
+    };
+
+} // namespace rtxgi
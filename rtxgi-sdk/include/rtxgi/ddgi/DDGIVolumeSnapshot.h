@@ -0,0 +1,147 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include "DDGIVolume.h"
+
+// Version of the serialized snapshot format. Snapshots of other versions are rejected.
+#define RTXGI_DDGI_VOLUME_SNAPSHOT_VERSION 1
+
+namespace rtxgi
+{
+
+    //------------------------------------------------------------------------
+    // Volume Snapshots
+    //
+    // A snapshot holds the probe textures of a volume (irradiance, distance,
+    // probe data, and probe variability) in their native texel formats, along
+    // with the volume's GPU constants and scroll offsets. Snapshots are saved
+    // from converged volumes and loaded into freshly created volumes with the
+    // same probe layout, so lighting is available on the first frame.
+    //
+    // The SDK doesn't read back or upload textures. Applications copy the
+    // textures from the GPU into a captured snapshot (GetTextureData()) and
+    // serialize it, or deserialize a snapshot, restore the volume, and upload
+    // the textures. Texture data is tightly packed: rows, then array slices.
+    //------------------------------------------------------------------------
+
+    enum class EDDGIVolumeSnapshotCompression
+    {
+        None = 0,   // textures are stored as-is
+        LZ,         // textures are byte shuffled by texel and LZ compressed (LZ4 block format)
+        Count
+    };
+
+    /**
+     * Get the size (in bytes) of a texel of the specified texture format.
+     */
+    RTXGI_API uint32_t GetDDGIVolumeTextureFormatSize(EDDGIVolumeTextureFormat format);
+
+    /**
+     * Validate a serialized snapshot without deserializing it: checks the snapshot's layout, version, texture
+     * dimensions (against its constants), and data hashes, and that float texture data is finite.
+     */
+    RTXGI_API ERTXGIStatus ValidateDDGIVolumeSnapshot(const void* data, uint64_t size);
+
+    class RTXGI_API DDGIVolumeSnapshot
+    {
+    public:
+
+        DDGIVolumeSnapshot() {}
+        ~DDGIVolumeSnapshot();
+
+        DDGIVolumeSnapshot(const DDGIVolumeSnapshot&) = delete;
+        DDGIVolumeSnapshot& operator=(const DDGIVolumeSnapshot&) = delete;
+
+        /**
+         * Captures the volume's constants and scroll offsets and allocates storage for its probe textures.
+         * The probe data texture is included when probe relocation or classification is enabled and the
+         * probe variability texture is included when probe variability is enabled.
+         * Fill the textures with GetTextureData() before calling Serialize().
+         */
+        ERTXGIStatus Capture(const DDGIVolumeBase* volume);
+
+        /**
+         * Serializes the snapshot. Use GetSerializedData() to access the result.
+         * Textures that don't compress are stored without compression.
+         */
+        ERTXGIStatus Serialize(EDDGIVolumeSnapshotCompression compression);
+
+        /**
+         * Validates (see ValidateDDGIVolumeSnapshot()) and deserializes a snapshot.
+         */
+        ERTXGIStatus Deserialize(const void* data, uint64_t size);
+
+        /**
+         * Checks that the snapshot's textures can be loaded into the volume: the volumes must have the same
+         * movement type, probe counts, probe spacing, rotation (unless they scroll), probe texel counts, and
+         * texture formats.
+         */
+        ERTXGIStatus ValidateVolume(const DDGIVolumeBase* volume) const;
+
+        /**
+         * Restores the volume's origin and scroll offsets from the snapshot and clears its probe relocation and
+         * classification resets, so the probe data texture is kept. Upload the snapshot's textures to the volume
+         * before its next update.
+         */
+        ERTXGIStatus Restore(DDGIVolumeBase* volume) const;
+
+        //------------------------------------------------------------------------
+        // Getters
+        //------------------------------------------------------------------------
+
+        DDGIVolumeDescGPU GetDescGPU() const { return UnpackDDGIVolumeDescGPU(m_descGPU); }
+
+        DDGIVolumeDescGPUPacked GetDescGPUPacked() const { return m_descGPU; }
+
+        int3 GetScrollOffsets() const { return m_probeScrollOffsets; }
+
+        bool HasTexture(EDDGIVolumeTextureType type) const { return m_textures[(int)type].data != nullptr; }
+
+        EDDGIVolumeTextureFormat GetTextureFormat(EDDGIVolumeTextureType type) const { return m_textures[(int)type].format; }
+
+        void GetTextureDimensions(EDDGIVolumeTextureType type, uint32_t& width, uint32_t& height, uint32_t& arraySize) const;
+
+        uint64_t GetTextureSizeInBytes(EDDGIVolumeTextureType type) const { return m_textures[(int)type].sizeInBytes; }
+
+        uint8_t* GetTextureData(EDDGIVolumeTextureType type) { return m_textures[(int)type].data; }
+
+        const uint8_t* GetTextureData(EDDGIVolumeTextureType type) const { return m_textures[(int)type].data; }
+
+        const uint8_t* GetSerializedData() const { return m_serialized; }
+
+        uint64_t GetSerializedSizeInBytes() const { return m_serializedSize; }
+
+    private:
+
+        struct Texture
+        {
+            EDDGIVolumeTextureFormat format = EDDGIVolumeTextureFormat::Count;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t arraySize = 0;
+            uint64_t sizeInBytes = 0;
+            uint8_t* data = nullptr;
+        };
+
+        void Release();
+        bool AllocateTexture(EDDGIVolumeTextureType type, EDDGIVolumeTextureFormat format, uint32_t width, uint32_t height, uint32_t arraySize);
+
+        DDGIVolumeDescGPUPacked m_descGPU = {};
+        int3 m_probeScrollOffsets = { 0, 0, 0 };
+
+        Texture m_textures[(int)EDDGIVolumeTextureType::Count];
+
+        uint8_t* m_serialized = nullptr;
+        uint64_t m_serializedSize = 0;
+    };
+
+} // namespace rtxgi
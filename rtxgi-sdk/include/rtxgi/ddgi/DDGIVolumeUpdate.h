@@ -0,0 +1,95 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include "DDGIVolume.h"
+
+namespace rtxgi
+{
+
+    //------------------------------------------------------------------------
+    // Parallel Volume Updates
+    //
+    // Calls DDGIVolumeBase::Update() and packs the GPU constants of many
+    // volumes in parallel. Jobs are run by an application-provided job system
+    // (e.g. the engine's task scheduler) or by the SDK's DDGIThreadPool.
+    //------------------------------------------------------------------------
+
+    /**
+     * A job function. Called once for each job index in [0, numJobs) passed to DDGIJobSystem::Run().
+     */
+    typedef void (*DDGIJobFunction)(uint32_t jobIndex, void* context);
+
+    /**
+     * Interface to a job system. Implement Run() to execute jobs on the application's task scheduler.
+     */
+    class RTXGI_API DDGIJobSystem
+    {
+    public:
+
+        virtual ~DDGIJobSystem() {}
+
+        /**
+         * Calls function(jobIndex, context) for every jobIndex in [0, numJobs), in any order and on any threads,
+         * and returns once all jobs have completed.
+         */
+        virtual void Run(uint32_t numJobs, DDGIJobFunction function, void* context) = 0;
+    };
+
+    struct DDGIThreadPoolState;
+
+    /**
+     * The default job system: a pool of persistent worker threads.
+     * Each call to Run() splits the jobs into one contiguous range per thread (the calling thread included).
+     * Threads run the jobs of their own range and steal jobs from the other ranges once their own range is empty.
+     * Run() is not reentrant; calls from multiple threads are serialized.
+     */
+    class RTXGI_API DDGIThreadPool : public DDGIJobSystem
+    {
+    public:
+
+        /**
+         * Creates numThreads - 1 worker threads (the thread calling Run() also runs jobs). 0: use all hardware threads.
+         */
+        explicit DDGIThreadPool(uint32_t numThreads = 0);
+        ~DDGIThreadPool();
+
+        DDGIThreadPool(const DDGIThreadPool&) = delete;
+        DDGIThreadPool& operator=(const DDGIThreadPool&) = delete;
+
+        void Run(uint32_t numJobs, DDGIJobFunction function, void* context) override;
+
+        // Number of threads that run jobs, including the thread calling Run()
+        uint32_t GetNumThreads() const { return m_numThreads; }
+
+    private:
+
+        uint32_t             m_numThreads = 1;
+        DDGIThreadPoolState* m_state = nullptr;
+    };
+
+    /**
+     * Calls Update() and (optionally) GetDescGPUPacked() for one or more volumes in parallel on the job system.
+     * The volumeIndices array is optional and selects the volumes to update (e.g. the selectedIndices written by
+     * DDGIVolumeScheduler::Schedule()); numVolumes is then the number of indices. Without indices, the first
+     * numVolumes volumes are updated.
+     * The packedDescs array is optional; when provided, it must have room for numVolumes entries and receives the
+     * packed constants of the updated volumes, in update order (e.g. to pass to UploadDDGIVolumeConstants()).
+     * Volumes must be distinct: a volume is only thread-safe to update from one thread at a time.
+     */
+    RTXGI_API ERTXGIStatus UpdateDDGIVolumes(
+        DDGIJobSystem& jobSystem,
+        uint32_t numVolumes,
+        DDGIVolumeBase* const* volumes,
+        const uint32_t* volumeIndices = nullptr,
+        DDGIVolumeDescGPUPacked* packedDescs = nullptr);
+
+} // namespace rtxgi
@@ -11,6 +11,8 @@
 #pragma once
 
 #include "../DDGIVolume.h"
+#include "../DDGIMergedDispatch.h"
+#include "../DDGIProbeCompaction.h"
 
 #include <d3d12.h>
 
@@ -76,6 +78,8 @@ namespace rtxgi
             ProbeRelocationBytecode      probeRelocation;                                    // Probe Relocation bytecode
             ProbeClassificationBytecode  probeClassification;                                // Probe Classification bytecode
             ProbeVariabilityByteCode     probeVariability;                                   // Probe Classification bytecode
+
+            ShaderBytecode               probeCompactionCS;                                  // [Optional] Probe compaction compute shader bytecode (see DDGIProbeCompaction.h)
         };
 
         //------------------------------------------------------------------------
@@ -120,7 +124,7 @@ namespace rtxgi
             ID3D12Resource*             probeData = nullptr;                                // Probe data texture array - XYZ: world-space relocation offsets | W: classification state
             ID3D12Resource*             probeVariability = nullptr;                         // Probe variability texture array
             ID3D12Resource*             probeVariabilityAverage = nullptr;                  // Average of Probe variability for whole volume
-            ID3D12Resource*             probeVariabilityReadback = nullptr;                 // CPU-readable resource containing final Probe variability average
+            ID3D12Resource*             probeVariabilityReadback = nullptr;                 // CPU-readable resource containing final Probe variability average (see GetDDGIVolumeVariabilityReadbackSizeInBytes()). Persistently mapped by the SDK.
 
             // Pipeline State Objects
             ID3D12PipelineState*        probeBlendingIrradiancePSO = nullptr;               // Probe blending (irradiance) compute PSO
@@ -129,6 +133,8 @@ namespace rtxgi
             ProbeRelocationPSO          probeRelocation;                                    // Probe Relocation PSOs
             ProbeClassificationPSO      probeClassification;                                // Probe Classification PSOs
             ProbeVariabilityPSO         probeVariabilityPSOs;                               // Probe Variability PSOs
+
+            ID3D12PipelineState*        probeCompactionPSO = nullptr;                       // [Optional] Probe compaction compute PSO (see DDGIProbeCompaction.h)
         };
 
         //------------------------------------------------------------------------
@@ -157,6 +163,7 @@ namespace rtxgi
             // Provide these resources if you use UploadDDGIVolumeResourceIndices() to transfer volume resource indices to the GPU
             ID3D12Resource*                   resourceIndicesBufferUpload = nullptr;        // [Optional] Resource indices structured buffer resource pointer (upload)
             UINT64                            resourceIndicesBufferSizeInBytes = 0;         // [Optional] Size (in bytes) of the resource indices structured buffer
+            UINT8*                            resourceIndicesBufferUploadPtr = nullptr;     // [Optional] Persistently mapped pointer to the upload buffer. When null, the buffer is mapped on each upload
         };
 
         /**
@@ -175,6 +182,32 @@ namespace rtxgi
             // Provide these resources if you use UploadDDGIVolumeConstants() to transfer volume constants to the GPU
             ID3D12Resource*                   constantsBufferUpload = nullptr;              // [Optional] Constants structured buffer resource pointer (upload)
             UINT64                            constantsBufferSizeInBytes = 0;               // [Optional] Size (in bytes) of the constants structured buffer
+            UINT8*                            constantsBufferUploadPtr = nullptr;           // [Optional] Persistently mapped pointer to the upload buffer. When null, the buffer is mapped on each upload
+        };
+
+        /**
+         * Specifies the resources used by merged dispatches (see DDGIMergedDispatch).
+         * The application creates the table buffers and a SRV of the device buffer for the merged dispatch shaders.
+         */
+        struct DDGIMergedDispatchResources
+        {
+            ID3D12Resource*                   tableBuffer = nullptr;                        // Merged dispatch table structured buffer resource pointer (device)
+            ID3D12Resource*                   tableBufferUpload = nullptr;                  // Merged dispatch table structured buffer resource pointer (upload)
+            UINT64                            tableBufferSizeInBytes = 0;                   // Size (in bytes) of the device table buffer, and of each buffered copy in the upload buffer
+            UINT8*                            tableBufferUploadPtr = nullptr;               // [Optional] Persistently mapped pointer to the upload buffer. When null, the buffer is mapped on each upload
+        };
+
+        /**
+         * Specifies the resources used by probe compaction (see DDGIProbeCompaction.h).
+         * The application creates the probe compaction buffer (see GetDDGIProbeCompactionBufferSizeInBytes()), with a UAV for
+         * the probe compaction shader and a SRV for the probe blending shaders, and the command signature of the indirect dispatches.
+         */
+        struct DDGIProbeCompactionResources
+        {
+            ID3D12Resource*                   buffer = nullptr;                             // Probe compaction structured buffer resource pointer (device)
+            ID3D12CommandSignature*           commandSignature = nullptr;                   // Indirect dispatch command signature (see CreateDDGIProbeCompactionCommandSignature())
+            UINT                              uavDescriptorHeapIndex = 0;                   // [Descriptor heap bindless only] Index of the probe compaction buffer UAV on the resource descriptor heap
+            UINT                              srvDescriptorHeapIndex = 0;                   // [Descriptor heap bindless only] Index of the probe compaction buffer SRV on the resource descriptor heap
         };
 
         //------------------------------------------------------------------------
@@ -191,6 +224,12 @@ namespace rtxgi
          */
         RTXGI_API bool GetDDGIVolumeRootSignatureDesc(const DDGIVolumeDescriptorHeapDesc& heapDesc, ID3DBlob*& signature);
 
+        /**
+         * Get the size (in bytes) of a volume's probe variability readback buffer.
+         * The buffer stores RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE readback slots.
+         */
+        RTXGI_API UINT64 GetDDGIVolumeVariabilityReadbackSizeInBytes();
+
         //------------------------------------------------------------------------
         // DDGIVolume
         //------------------------------------------------------------------------
@@ -258,11 +297,13 @@ namespace rtxgi
             ID3D12Resource* GetResourceIndicesBuffer() const { return m_bindlessResources.resourceIndicesBuffer; }
             ID3D12Resource* GetResourceIndicesBufferUpload() const { return m_bindlessResources.resourceIndicesBufferUpload; }
             UINT64 GetResourceIndicesBufferSizeInBytes() const { return m_bindlessResources.resourceIndicesBufferSizeInBytes; }
+            UINT8* GetResourceIndicesBufferUploadPtr() const { return m_bindlessResources.resourceIndicesBufferUploadPtr; }
 
             // Constants
             ID3D12Resource* GetConstantsBuffer() const { return m_constantsBuffer; }
             ID3D12Resource* GetConstantsBufferUpload() const { return m_constantsBufferUpload; }
             UINT64 GetConstantsBufferSizeInBytes() const { return m_constantsBufferSizeInBytes; }
+            UINT8* GetConstantsBufferUploadPtr() const { return m_constantsBufferUploadPtr; }
 
             // Texture Arrays Format
             EDDGIVolumeTextureFormat GetRayDataFormat() const { return m_desc.probeRayDataFormat; }
@@ -279,6 +320,7 @@ namespace rtxgi
             ID3D12Resource* GetProbeVariability() const { return m_probeVariability; }
             ID3D12Resource* GetProbeVariabilityAverage() const { return m_probeVariabilityAverage; }
             ID3D12Resource* GetProbeVariabilityReadback() const { return m_probeVariabilityReadback; }
+            UINT8* GetProbeVariabilityReadbackPtr() const { return m_probeVariabilityReadbackPtr; }
 
             // Pipeline State Objects
             ID3D12PipelineState* GetProbeBlendingIrradiancePSO() const { return m_probeBlendingIrradiancePSO; }
@@ -289,6 +331,7 @@ namespace rtxgi
             ID3D12PipelineState* GetProbeClassificationResetPSO() const { return m_probeClassificationResetPSO; }
             ID3D12PipelineState* GetProbeVariabilityReductionPSO() const { return m_probeVariabilityReductionPSO; }
             ID3D12PipelineState* GetProbeVariabilityExtraReductionPSO() const { return m_probeVariabilityExtraReductionPSO; }
+            ID3D12PipelineState* GetProbeCompactionPSO() const { return m_probeCompactionPSO; }
 
             //------------------------------------------------------------------------
             // Resource Setters
@@ -313,11 +356,15 @@ namespace rtxgi
             void SetResourceIndicesBuffer(ID3D12Resource* ptr) { m_bindlessResources.resourceIndicesBuffer = ptr; }
             void SetResourceIndicesBufferUpload(ID3D12Resource* ptr) { m_bindlessResources.resourceIndicesBufferUpload = ptr; }
             void SetResourceIndicesBufferSizeInBytes(UINT64 value) { m_bindlessResources.resourceIndicesBufferSizeInBytes = value; }
+            void SetResourceIndicesBufferUploadPtr(UINT8* ptr) { m_bindlessResources.resourceIndicesBufferUploadPtr = ptr; }
 
             // Constants
             void SetConstantsBuffer(ID3D12Resource* ptr) { m_constantsBuffer = ptr; }
             void SetConstantsBufferUpload(ID3D12Resource* ptr) { m_constantsBufferUpload = ptr; }
             void SetConstantsBufferSizeInBytes(UINT64 value) { m_constantsBufferSizeInBytes = value; }
+            void SetConstantsBufferUploadPtr(UINT8* ptr) { m_constantsBufferUploadPtr = ptr; }
+
+            void SetProbeVariabilityReadbackPtr(UINT8* ptr) { m_probeVariabilityReadbackPtr = ptr; }
 
             // Texture Array Format
             void SetRayDataFormat(EDDGIVolumeTextureFormat format) { m_desc.probeRayDataFormat = format; }
@@ -345,6 +392,7 @@ namespace rtxgi
             ID3D12Resource*                 m_constantsBuffer = nullptr;                        // Structured buffer that stores the volume's constants (device)
             ID3D12Resource*                 m_constantsBufferUpload = nullptr;                  // Structured buffer that stores the volume's constants (upload)
             UINT64                          m_constantsBufferSizeInBytes = 0;                   // Size (in bytes) of the structured buffer that stores constants for *all* volumes
+            UINT8*                          m_constantsBufferUploadPtr = nullptr;               // Persistently mapped pointer to the constants upload structured buffer (optional)
 
             // Texture Arrays
             ID3D12Resource*                 m_probeRayData = nullptr;                           // Probe ray data texture array - RGB: radiance | A: hit distance
@@ -354,6 +402,7 @@ namespace rtxgi
             ID3D12Resource*                 m_probeVariability = nullptr;                       // Probe luminance difference from previous update
             ID3D12Resource*                 m_probeVariabilityAverage = nullptr;                // Average Probe variability for whole volume
             ID3D12Resource*                 m_probeVariabilityReadback = nullptr;               // CPU-readable buffer with average Probe variability
+            UINT8*                          m_probeVariabilityReadbackPtr = nullptr;            // Persistently mapped pointer to the probe variability readback buffer (mapped on first readback)
 
             // Render Target Views
             D3D12_CPU_DESCRIPTOR_HANDLE     m_probeIrradianceRTV = { 0 };                       // Probe irradiance render target view
@@ -380,6 +429,7 @@ namespace rtxgi
             ID3D12PipelineState*            m_probeClassificationResetPSO = nullptr;            // Probe classification reset compute shader pipeline state object
             ID3D12PipelineState*            m_probeVariabilityReductionPSO = nullptr;           // Probe variability reduction
             ID3D12PipelineState*            m_probeVariabilityExtraReductionPSO = nullptr;      // Probe variability extra reduction pass
+            ID3D12PipelineState*            m_probeCompactionPSO = nullptr;                     // [Optional] Probe compaction compute shader pipeline state object
 
         #if RTXGI_DDGI_RESOURCE_MANAGEMENT
             ID3D12DescriptorHeap*           m_rtvDescriptorHeap = nullptr;                      // Descriptor heap for render target views
@@ -422,8 +472,16 @@ namespace rtxgi
         /**
          * Uploads constants for one or more volumes to the GPU.
          * This function is for convenience and isn't necessary if you upload volume constants yourself.
+         * The packedDescs array is optional and provides the volumes' packed constants (e.g. from UpdateDDGIVolumes()).
+         * Without it, the constants are packed with DDGIVolume::GetDescGPUPacked().
+         */
+        RTXGI_API ERTXGIStatus UploadDDGIVolumeConstants(ID3D12GraphicsCommandList* cmdList, UINT bufferingIndex, UINT numVolumes, DDGIVolume** volumes, const DDGIVolumeDescGPUPacked* packedDescs = nullptr);
+
+        /**
+         * Uploads the dispatch table of a merged dispatch to the GPU.
+         * Size tableBufferSizeInBytes with GetDDGIMergedDispatchMaxEntries() to avoid resizing the buffers when volumes are added.
          */
-        RTXGI_API ERTXGIStatus UploadDDGIVolumeConstants(ID3D12GraphicsCommandList* cmdList, UINT bufferingIndex, UINT numVolumes, DDGIVolume** volumes);
+        RTXGI_API ERTXGIStatus UploadDDGIMergedDispatchTable(ID3D12GraphicsCommandList* cmdList, UINT bufferingIndex, const DDGIMergedDispatch& mergedDispatch, const DDGIMergedDispatchResources& resources);
 
         /**
          * Updates one or more volume's probes using data in the volume's radiance texture.
@@ -447,13 +505,55 @@ namespace rtxgi
         RTXGI_API ERTXGIStatus ClassifyDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes);
 
         /**
-         * Calculates average variability for all probes in each provided volume
+         * Updates one or more volume's probes with one dispatch per merged dispatch batch instead of one per volume.
+         * Requires bindless resources and probe blending PSOs compiled with RTXGI_DDGI_MERGED_DISPATCH=1.
+         * The merged dispatch must be built from the same volumes array and its table uploaded (see UploadDDGIMergedDispatchTable()).
+         * When using descriptor heap bindless, tableDescriptorHeapIndex is the index of the dispatch table SRV on the resource descriptor heap.
+         */
+        RTXGI_API ERTXGIStatus UpdateDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch, UINT tableDescriptorHeapIndex = 0);
+
+        /**
+         * Relocates one or more volume's probes with one dispatch per merged dispatch batch instead of one per volume.
+         * Requires bindless resources and probe relocation PSOs compiled with RTXGI_DDGI_MERGED_DISPATCH=1.
+         */
+        RTXGI_API ERTXGIStatus RelocateDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch, UINT tableDescriptorHeapIndex = 0);
+
+        /**
+         * Classifies one or more volume's probes with one dispatch per merged dispatch batch instead of one per volume.
+         * Requires bindless resources and probe classification PSOs compiled with RTXGI_DDGI_MERGED_DISPATCH=1.
+         */
+        RTXGI_API ERTXGIStatus ClassifyDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch, UINT tableDescriptorHeapIndex = 0);
+
+        /**
+         * Creates the command signature of the indirect probe blending dispatches of probe compaction.
+         */
+        RTXGI_API ERTXGIStatus CreateDDGIProbeCompactionCommandSignature(ID3D12Device* device, ID3D12CommandSignature** commandSignature);
+
+        /**
+         * Writes the list of probes that need blending, and the indirect dispatch arguments of the list, for one or more volumes.
+         * Requires bindless resources and the volume's probe compaction PSO. Call before UpdateDDGIVolumeProbes() with the same volumes array.
+         * Volume resources and the probe compaction buffer are expected to be in the D3D12_RESOURCE_STATE_UNORDERED_ACCESS state.
+         */
+        RTXGI_API ERTXGIStatus CompactDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, const DDGIProbeCompactionResources& resources);
+
+        /**
+         * Updates one or more volume's probes with indirect dispatches over the probes in the volumes' compacted probe lists.
+         * Requires probe blending PSOs compiled with RTXGI_DDGI_PROBE_COMPACTION=1 and probe lists written by CompactDDGIVolumeProbes().
+         * Volume resources and the probe compaction buffer are expected to be in the D3D12_RESOURCE_STATE_UNORDERED_ACCESS state.
+         */
+        RTXGI_API ERTXGIStatus UpdateDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, const DDGIProbeCompactionResources& resources);
+
+        /**
+         * Calculates average variability for all probes in each provided volume and copies it to the volume's readback slot for frameIndex.
+         * frameIndex must increase monotonically (e.g. a count of submitted frames).
          */
-        RTXGI_API ERTXGIStatus CalculateDDGIVolumeVariability(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes);
+        RTXGI_API ERTXGIStatus CalculateDDGIVolumeVariability(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, UINT64 frameIndex);
 
         /**
-         * Reads back average variability for each provided volume, at the time of the call
+         * Reads back the newest average variability that the GPU has finished writing for each provided volume, without waiting on the GPU.
+         * Values calculated in frame N are available in frame N + (RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE - 1).
+         * Use DDGIVolume::GetVolumeAverageVariability(frameIndex) to get the value and the frame that produced it.
          */
-        RTXGI_API ERTXGIStatus ReadbackDDGIVolumeVariability(UINT numVolumes, DDGIVolume** volumes);
+        RTXGI_API ERTXGIStatus ReadbackDDGIVolumeVariability(UINT numVolumes, DDGIVolume** volumes, UINT64 frameIndex);
     } // namespace d3d12
 } // namespace rtxgi
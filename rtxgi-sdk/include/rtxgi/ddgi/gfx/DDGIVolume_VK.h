@@ -11,6 +11,8 @@
 #pragma once
 
 #include "../DDGIVolume.h"
+#include "../DDGIMergedDispatch.h"
+#include "../DDGIProbeCompaction.h"
 
 #include <vulkan/vulkan.h>
 
@@ -74,6 +76,8 @@ namespace rtxgi
             ProbeRelocationBytecode      probeRelocation;                                    // Probe Relocation bytecode
             ProbeClassificationBytecode  probeClassification;                                // Probe Classification bytecode
             ProbeVariabilityByteCode     probeVariability;                                   // Probe Classification bytecode
+
+            ShaderBytecode               probeCompactionCS;                                  // [Optional] Probe compaction compute shader bytecode (see DDGIProbeCompaction.h)
         };
 
         //------------------------------------------------------------------------
@@ -130,7 +134,7 @@ namespace rtxgi
             VkDeviceMemory              probeDataMemory = nullptr;                          // Probe data texture array device memory
             VkDeviceMemory              probeVariabilityMemory = nullptr;                   // Probe variability texture array device memory
             VkDeviceMemory              probeVariabilityAverageMemory = nullptr;            // Probe variability average texture device memory
-            VkDeviceMemory              probeVariabilityReadbackMemory = nullptr;           // Probe variability readback texture device memory
+            VkDeviceMemory              probeVariabilityReadbackMemory = nullptr;           // Probe variability readback buffer device memory (see GetDDGIVolumeVariabilityReadbackSizeInBytes()). Persistently mapped by the SDK.
 
             // Texture Views
             VkImageView                 probeRayDataView = nullptr;                         // Probe ray data texture array view
@@ -151,6 +155,9 @@ namespace rtxgi
             ProbeRelocationPipeline     probeRelocation;                                     // Probe Relocation pipelines
             ProbeClassificationPipeline probeClassification;                                 // Probe Classification pipelines
             ProbeVariabilityPipeline    probeVariabilityPipelines;                           // Probe Variability pipelines
+
+            VkShaderModule              probeCompactionModule = nullptr;                     // [Optional] Probe compaction shader module (see DDGIProbeCompaction.h)
+            VkPipeline                  probeCompactionPipeline = nullptr;                   // [Optional] Probe compaction compute pipeline
         };
 
         //------------------------------------------------------------------------
@@ -169,6 +176,7 @@ namespace rtxgi
             VkBuffer                    resourceIndicesBufferUpload = nullptr;        // [Optional] Constants structured buffer (upload)
             VkDeviceMemory              resourceIndicesBufferUploadMemory = nullptr;  // [Optional] Constants structured buffer memory (upload)
             uint64_t                    resourceIndicesBufferSizeInBytes = 0;         // [Optional] Size (in bytes) of the constants structured buffer
+            uint8_t*                    resourceIndicesBufferUploadPtr = nullptr;     // [Optional] Persistently mapped pointer to the upload buffer memory. When null, the memory is mapped on each upload
         };
 
         /**
@@ -186,6 +194,31 @@ namespace rtxgi
             VkBuffer                constantsBufferUpload = nullptr;                        // [Optional] Constants structured buffer (upload)
             VkDeviceMemory          constantsBufferUploadMemory = nullptr;                  // [Optional] Constants structured buffer memory (upload)
             uint64_t                constantsBufferSizeInBytes = 0;                         // [Optional] Size (in bytes) of the constants structured buffer
+            uint8_t*                constantsBufferUploadPtr = nullptr;                     // [Optional] Persistently mapped pointer to the upload buffer memory. When null, the memory is mapped on each upload
+        };
+
+        /**
+         * Specifies the resources used by merged dispatches (see DDGIMergedDispatch).
+         * The application creates the table buffers and binds the device buffer to the merged dispatch shaders.
+         */
+        struct DDGIMergedDispatchResources
+        {
+            VkBuffer                tableBuffer = nullptr;                                  // Merged dispatch table structured buffer (device)
+            VkBuffer                tableBufferUpload = nullptr;                            // Merged dispatch table structured buffer (upload)
+            VkDeviceMemory          tableBufferUploadMemory = nullptr;                      // Merged dispatch table structured buffer memory (upload)
+            uint64_t                tableBufferSizeInBytes = 0;                             // Size (in bytes) of the device table buffer, and of each buffered copy in the upload buffer
+            uint8_t*                tableBufferUploadPtr = nullptr;                         // [Optional] Persistently mapped pointer to the upload buffer memory. When null, the memory is mapped on each upload
+        };
+
+        /**
+         * Specifies the resources used by probe compaction (see DDGIProbeCompaction.h).
+         * The application creates the probe compaction buffer (see GetDDGIProbeCompactionBufferSizeInBytes()) with storage and indirect buffer
+         * usage, and binds it to the probe compaction and probe blending shaders.
+         */
+        struct DDGIProbeCompactionResources
+        {
+            VkBuffer                buffer = nullptr;                                       // Probe compaction structured buffer (device)
+            uint64_t                bufferSizeInBytes = 0;                                  // Size (in bytes) of the probe compaction buffer
         };
 
         //------------------------------------------------------------------------
@@ -202,6 +235,12 @@ namespace rtxgi
          */
         RTXGI_API uint32_t GetDDGIVolumeLayoutBindingCount();
 
+        /**
+         * Get the size (in bytes) of a volume's probe variability readback buffer.
+         * The buffer stores RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE readback slots.
+         */
+        RTXGI_API uint64_t GetDDGIVolumeVariabilityReadbackSizeInBytes();
+
         /**
          * Get the DDGIVolume's descriptor set and pipeline layouts descriptors.
          */
@@ -275,12 +314,14 @@ namespace rtxgi
             VkBuffer GetResourceIndicesBufferUpload() const { return m_bindlessResources.resourceIndicesBufferUpload; }
             VkDeviceMemory GetResourceIndicesBufferUploadMemory() const { return m_bindlessResources.resourceIndicesBufferUploadMemory; }
             uint64_t GetResourceIndicesBufferSizeInBytes() const { return m_bindlessResources.resourceIndicesBufferSizeInBytes; }
+            uint8_t* GetResourceIndicesBufferUploadPtr() const { return m_bindlessResources.resourceIndicesBufferUploadPtr; }
 
             // Constants
             VkBuffer GetConstantsBuffer() const { return m_constantsBuffer; }
             VkBuffer GetConstantsBufferUpload() const { return m_constantsBufferUpload; }
             VkDeviceMemory GetConstantsBufferUploadMemory() const { return m_constantsBufferUploadMemory; }
             uint64_t GetConstantsBufferSizeInBytes() const { return m_constantsBufferSizeInBytes; }
+            uint8_t* GetConstantsBufferUploadPtr() const { return m_constantsBufferUploadPtr; }
 
             // Texture Arrays Format
             EDDGIVolumeTextureFormat GetRayDataFormat() const { return m_desc.probeRayDataFormat; }
@@ -306,6 +347,7 @@ namespace rtxgi
             VkDeviceMemory GetProbeVariabilityMemory() const { return m_probeVariabilityMemory; }
             VkDeviceMemory GetProbeVariabilityAverageMemory() const { return m_probeVariabilityAverageMemory; }
             VkDeviceMemory GetProbeVariabilityReadbackMemory() const { return m_probeVariabilityReadbackMemory; }
+            uint8_t* GetProbeVariabilityReadbackPtr() const { return m_probeVariabilityReadbackPtr; }
 
             // Texture Array Views
             VkImageView GetProbeRayDataView() const { return m_probeRayDataView; }
@@ -324,6 +366,7 @@ namespace rtxgi
             VkShaderModule GetProbeClassificationResetModule() const { return m_probeClassificationResetModule; }
             VkShaderModule GetProbeVariabilityReductionModule() const { return m_probeVariabilityReductionModule; }
             VkShaderModule GetProbeVariabilityExtraReductionModule() const { return m_probeVariabilityExtraReductionModule; }
+            VkShaderModule GetProbeCompactionModule() const { return m_probeCompactionModule; }
 
             // Pipelines
             VkPipeline GetProbeBlendingIrradiancePipeline() const { return m_probeBlendingIrradiancePipeline; }
@@ -334,6 +377,7 @@ namespace rtxgi
             VkPipeline GetProbeClassificationResetPipeline() const { return m_probeClassificationResetPipeline; }
             VkPipeline GetProbeVariabilityReductionPipeline() const { return m_probeVariabilityReductionPipeline; }
             VkPipeline GetProbeVariabilityExtraReductionPipeline() const { return m_probeVariabilityExtraReductionPipeline; }
+            VkPipeline GetProbeCompactionPipeline() const { return m_probeCompactionPipeline; }
 
             //------------------------------------------------------------------------
             // Resource Setters
@@ -348,12 +392,16 @@ namespace rtxgi
             void SetResourceIndicesBufferUpload(VkBuffer ptr) { m_bindlessResources.resourceIndicesBufferUpload = ptr; }
             void SetResourceIndicesBufferUploadMemory(VkDeviceMemory ptr) { m_bindlessResources.resourceIndicesBufferUploadMemory = ptr; }
             void SetResourceIndicesBufferSizeInBytes(uint64_t size) { m_bindlessResources.resourceIndicesBufferSizeInBytes = size; }
+            void SetResourceIndicesBufferUploadPtr(uint8_t* ptr) { m_bindlessResources.resourceIndicesBufferUploadPtr = ptr; }
 
             // Constants
             void SetConstantsBuffer(VkBuffer ptr) { m_constantsBuffer = ptr; }
             void SetConstantsBufferUpload(VkBuffer ptr) { m_constantsBufferUpload = ptr; }
             void SetConstantsBufferUploadMemory(VkDeviceMemory ptr) { m_constantsBufferUploadMemory = ptr; }
             void SetConstantsBufferSizeInBytes(uint64_t value) { m_constantsBufferSizeInBytes = value; }
+            void SetConstantsBufferUploadPtr(uint8_t* ptr) { m_constantsBufferUploadPtr = ptr; }
+
+            void SetProbeVariabilityReadbackPtr(uint8_t* ptr) { m_probeVariabilityReadbackPtr = ptr; }
 
             // Texture Array Format
             void SetRayDataFormat(EDDGIVolumeTextureFormat format) { m_desc.probeRayDataFormat = format; }
@@ -369,7 +417,7 @@ namespace rtxgi
             void SetProbeData(VkImage ptr, VkDeviceMemory memoryPtr, VkImageView viewPtr) { m_probeData = ptr; m_probeDataMemory = memoryPtr; m_probeDataView = viewPtr; }
             void SetProbeVariability(VkImage ptr, VkDeviceMemory memoryPtr, VkImageView viewPtr) { m_probeVariability = ptr; m_probeVariabilityMemory = memoryPtr; m_probeVariabilityView = viewPtr; }
             void SetProbeVariabilityAverage(VkImage ptr, VkDeviceMemory memoryPtr, VkImageView viewPtr) { m_probeVariabilityAverage = ptr; m_probeVariabilityAverageMemory = memoryPtr; m_probeVariabilityAverageView = viewPtr; }
-            void SetProbeVariabilityReadback(VkBuffer ptr, VkDeviceMemory memoryPtr) { m_probeVariabilityReadback = ptr; m_probeVariabilityReadbackMemory = memoryPtr; }
+            void SetProbeVariabilityReadback(VkBuffer ptr, VkDeviceMemory memoryPtr) { m_probeVariabilityReadback = ptr; m_probeVariabilityReadbackMemory = memoryPtr; m_probeVariabilityReadbackPtr = nullptr; }
         #endif
 
         private:
@@ -385,6 +433,7 @@ namespace rtxgi
             VkBuffer                        m_constantsBufferUpload = nullptr;                  // Structured buffer that stores the volume's constants (upload)
             VkDeviceMemory                  m_constantsBufferUploadMemory = nullptr;            // Memory for the volume's constants upload structured buffer
             uint64_t                        m_constantsBufferSizeInBytes = 0;                   // Size (in bytes) of the structured buffer that stores constants for *all* volumes
+            uint8_t*                        m_constantsBufferUploadPtr = nullptr;               // Persistently mapped pointer to the constants upload structured buffer memory (optional)
 
             // Texture Arrays
             VkImage                         m_probeRayData = nullptr;                           // Probe ray data texture array - RGB: radiance | A: hit distance
@@ -403,6 +452,7 @@ namespace rtxgi
             VkDeviceMemory                  m_probeVariabilityMemory = nullptr;                 // Probe variability memory
             VkDeviceMemory                  m_probeVariabilityAverageMemory = nullptr;          // Probe variability average memory
             VkDeviceMemory                  m_probeVariabilityReadbackMemory = nullptr;         // Probe variability readback memory
+            uint8_t*                        m_probeVariabilityReadbackPtr = nullptr;            // Persistently mapped pointer to the probe variability readback memory (mapped on first readback)
 
             // Texture Array Views
             VkImageView                     m_probeRayDataView = nullptr;                       // Probe ray data view
@@ -434,6 +484,7 @@ namespace rtxgi
             VkShaderModule                  m_probeClassificationResetModule = nullptr;         // Probe classification reset shader module
             VkShaderModule                  m_probeVariabilityReductionModule = nullptr;        // Probe variability reduction shader module
             VkShaderModule                  m_probeVariabilityExtraReductionModule = nullptr;   // Probe variability reduction extra passes shader module
+            VkShaderModule                  m_probeCompactionModule = nullptr;                  // [Optional] Probe compaction shader module
 
             // Pipelines
             VkPipeline                      m_probeBlendingIrradiancePipeline = nullptr;         // Probe blending (irradiance) compute shader pipeline
@@ -444,6 +495,7 @@ namespace rtxgi
             VkPipeline                      m_probeClassificationResetPipeline = nullptr;        // Probe classification reset compute shader pipeline
             VkPipeline                      m_probeVariabilityReductionPipeline = nullptr;       // Probe variability reduction compute shader pipeline
             VkPipeline                      m_probeVariabilityExtraReductionPipeline = nullptr;  // Probe variability reduction extra passes compute shader pipeline
+            VkPipeline                      m_probeCompactionPipeline = nullptr;                 // [Optional] Probe compaction compute shader pipeline
 
         #if RTXGI_DDGI_RESOURCE_MANAGEMENT
             ERTXGIStatus CreateManagedResources(const DDGIVolumeDesc& desc, const DDGIVolumeManagedResourcesDesc& managed);
@@ -487,8 +539,16 @@ namespace rtxgi
         /**
          * Uploads constants for one or more volumes to the GPU.
          * This function is for convenience and isn't necessary if you upload volume constants yourself.
+         * The packedDescs array is optional and provides the volumes' packed constants (e.g. from UpdateDDGIVolumes()).
+         * Without it, the constants are packed with DDGIVolume::GetDescGPUPacked().
+         */
+        RTXGI_API ERTXGIStatus UploadDDGIVolumeConstants(VkDevice device, VkCommandBuffer cmdBuffer, uint32_t bufferingIndex, uint32_t numVolumes, DDGIVolume** volumes, const DDGIVolumeDescGPUPacked* packedDescs = nullptr);
+
+        /**
+         * Uploads the dispatch table of a merged dispatch to the GPU.
+         * Size tableBufferSizeInBytes with GetDDGIMergedDispatchMaxEntries() to avoid resizing the buffers when volumes are added.
          */
-        RTXGI_API ERTXGIStatus UploadDDGIVolumeConstants(VkDevice device, VkCommandBuffer cmdBuffer, uint32_t bufferingIndex, uint32_t numVolumes, DDGIVolume** volumes);
+        RTXGI_API ERTXGIStatus UploadDDGIMergedDispatchTable(VkDevice device, VkCommandBuffer cmdBuffer, uint32_t bufferingIndex, const DDGIMergedDispatch& mergedDispatch, const DDGIMergedDispatchResources& resources);
 
         /**
          * Updates one or more volume's probes using data in the volume's radiance texture.
@@ -509,13 +569,47 @@ namespace rtxgi
         RTXGI_API ERTXGIStatus ClassifyDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes);
 
         /**
-         * Calculates average variability for all probes in each provided volume
+         * Updates one or more volume's probes with one dispatch per merged dispatch batch instead of one per volume.
+         * Requires bindless resources and probe blending pipelines compiled with RTXGI_DDGI_MERGED_DISPATCH=1.
+         * The merged dispatch must be built from the same volumes array and its table uploaded (see UploadDDGIMergedDispatchTable()).
+         */
+        RTXGI_API ERTXGIStatus UpdateDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch);
+
+        /**
+         * Relocates one or more volume's probes with one dispatch per merged dispatch batch instead of one per volume.
+         * Requires bindless resources and probe relocation pipelines compiled with RTXGI_DDGI_MERGED_DISPATCH=1.
+         */
+        RTXGI_API ERTXGIStatus RelocateDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch);
+
+        /**
+         * Classifies one or more volume's probes with one dispatch per merged dispatch batch instead of one per volume.
+         * Requires bindless resources and probe classification pipelines compiled with RTXGI_DDGI_MERGED_DISPATCH=1.
+         */
+        RTXGI_API ERTXGIStatus ClassifyDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch);
+
+        /**
+         * Writes the list of probes that need blending, and the indirect dispatch arguments of the list, for one or more volumes.
+         * Requires bindless resources and the volume's probe compaction pipeline. Call before UpdateDDGIVolumeProbes() with the same volumes array.
+         */
+        RTXGI_API ERTXGIStatus CompactDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, const DDGIProbeCompactionResources& resources);
+
+        /**
+         * Updates one or more volume's probes with indirect dispatches over the probes in the volumes' compacted probe lists.
+         * Requires probe blending pipelines compiled with RTXGI_DDGI_PROBE_COMPACTION=1 and probe lists written by CompactDDGIVolumeProbes().
+         */
+        RTXGI_API ERTXGIStatus UpdateDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, const DDGIProbeCompactionResources& resources);
+
+        /**
+         * Calculates average variability for all probes in each provided volume and copies it to the volume's readback slot for frameIndex.
+         * frameIndex must increase monotonically (e.g. a count of submitted frames).
          */
-        RTXGI_API ERTXGIStatus CalculateDDGIVolumeVariability(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes);
+        RTXGI_API ERTXGIStatus CalculateDDGIVolumeVariability(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, uint64_t frameIndex);
 
         /**
-         * Reads back average variability for each provided volume, at the time of the call
+         * Reads back the newest average variability that the GPU has finished writing for each provided volume, without waiting on the GPU.
+         * Values calculated in frame N are available in frame N + (RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE - 1).
+         * Use DDGIVolume::GetVolumeAverageVariability(frameIndex) to get the value and the frame that produced it.
          */
-        RTXGI_API ERTXGIStatus ReadbackDDGIVolumeVariability(VkDevice device, uint32_t numVolumes, DDGIVolume** volumes);
+        RTXGI_API ERTXGIStatus ReadbackDDGIVolumeVariability(VkDevice device, uint32_t numVolumes, DDGIVolume** volumes, uint64_t frameIndex);
     } // namespace vulkan
 } // namespace rtxgi
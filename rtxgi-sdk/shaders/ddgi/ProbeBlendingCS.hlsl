@@ -29,6 +29,15 @@
     #if RTXGI_DDGI_BINDLESS_RESOURCES
         #define VOLUME_RESOURCES_REG_DECL 
         #define RWTEX2DARRAY_REG_DECL 
+        #if RTXGI_DDGI_MERGED_DISPATCH
+        #define MERGED_DISPATCH_REG_DECL 
+        #endif
+        #if RTXGI_DDGI_ADAPTIVE_RAYS
+        #define PROBE_RAY_ALLOCATIONS_REG_DECL 
+        #endif
+        #if RTXGI_DDGI_PROBE_COMPACTION
+        #define PROBE_COMPACTION_REG_DECL 
+        #endif
     #else
         #define RAY_DATA_REG_DECL 
         #define OUTPUT_REG_DECL 
@@ -46,6 +55,15 @@
         #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_RESOURCE_ARRAYS
             #define VOLUME_RESOURCES_REG_DECL : register(VOLUME_RESOURCES_REGISTER, VOLUME_RESOURCES_SPACE)
             #define RWTEX2DARRAY_REG_DECL : register(RWTEX2DARRAY_REGISTER, RWTEX2DARRAY_SPACE)
+            #if RTXGI_DDGI_MERGED_DISPATCH
+            #define MERGED_DISPATCH_REG_DECL : register(MERGED_DISPATCH_REGISTER, MERGED_DISPATCH_SPACE)
+            #endif
+            #if RTXGI_DDGI_ADAPTIVE_RAYS
+            #define PROBE_RAY_ALLOCATIONS_REG_DECL : register(PROBE_RAY_ALLOCATIONS_REGISTER, PROBE_RAY_ALLOCATIONS_SPACE)
+            #endif
+            #if RTXGI_DDGI_PROBE_COMPACTION
+            #define PROBE_COMPACTION_REG_DECL : register(PROBE_COMPACTION_REGISTER, PROBE_COMPACTION_SPACE)
+            #endif
         #endif
     #else
         #define RAY_DATA_REG_DECL : register(RAY_DATA_REGISTER, RAY_DATA_SPACE)
@@ -62,6 +80,12 @@
 
 #include "include/ProbeCommon.hlsl"
 #include "include/DDGIRootConstants.hlsl"
+#if RTXGI_DDGI_MERGED_DISPATCH
+#include "include/DDGIMergedDispatch.hlsl"
+#endif
+#if RTXGI_DDGI_PROBE_COMPACTION
+#include "include/DDGIProbeCompaction.hlsl"
+#endif
 
 // -------- RESOURCE DECLARATIONS -----------------------------------------------------------------
 
@@ -81,6 +105,24 @@
         RTXGI_VK_BINDING(RWTEX2DARRAY_REGISTER, RWTEX2DARRAY_SPACE)
         RWTexture2DArray<float4> RWTex2DArray[] RWTEX2DARRAY_REG_DECL;
 
+        #if RTXGI_DDGI_MERGED_DISPATCH
+        // Merged dispatch table (maps the probes of a merged dispatch to their volume)
+        RTXGI_VK_BINDING(MERGED_DISPATCH_REGISTER, MERGED_DISPATCH_SPACE)
+        StructuredBuffer<DDGIMergedDispatchEntry> DDGIMergedDispatchTable MERGED_DISPATCH_REG_DECL;
+        #endif
+
+        #if RTXGI_DDGI_ADAPTIVE_RAYS
+        // Probe ray allocations (locates the rays of each probe in the packed RayData layout)
+        RTXGI_VK_BINDING(PROBE_RAY_ALLOCATIONS_REGISTER, PROBE_RAY_ALLOCATIONS_SPACE)
+        StructuredBuffer<DDGIProbeRayAllocation> DDGIProbeRayAllocations PROBE_RAY_ALLOCATIONS_REG_DECL;
+        #endif
+
+        #if RTXGI_DDGI_PROBE_COMPACTION
+        // Probe compaction buffer (compacted lists of the probes that need blending)
+        RTXGI_VK_BINDING(PROBE_COMPACTION_REGISTER, PROBE_COMPACTION_SPACE)
+        StructuredBuffer<uint> DDGIProbeCompaction PROBE_COMPACTION_REG_DECL;
+        #endif
+
     #endif
 
 #else
@@ -174,16 +216,20 @@
 #if RTXGI_DDGI_BLEND_SHARED_MEMORY
     // Cooperatively load the ray radiance and hit distance values into shared memory
     // Cooperatively compute probe ray directions
-    void LoadSharedMemory(int probeIndex, uint GroupIndex, RWTexture2DArray<float4> RayData, DDGIVolumeDescGPU volume)
+    void LoadSharedMemory(int probeIndex, DDGIProbeRayAllocation rayAllocation, uint GroupIndex, RWTexture2DArray<float4> RayData, DDGIVolumeDescGPU volume)
     {
         int totalIterations = int(ceil(float(RTXGI_DDGI_BLEND_RAYS_PER_PROBE) / float(RTXGI_DDGI_PROBE_NUM_TEXELS * RTXGI_DDGI_PROBE_NUM_TEXELS)));
         for (int iteration = 0; iteration < totalIterations; iteration++)
         {
             int rayIndex = (GroupIndex * totalIterations) + iteration;
-            if (rayIndex >= RTXGI_DDGI_BLEND_RAYS_PER_PROBE) break;
+            if (rayIndex >= RTXGI_DDGI_BLEND_RAYS_PER_PROBE || rayIndex >= int(rayAllocation.numRays)) break;
 
             // Get the coordinates for the probe ray in the RayData texture array
+        #if RTXGI_DDGI_ADAPTIVE_RAYS
+            uint3 rayDataTexCoords = DDGIGetRayDataTexelCoords(rayIndex, rayAllocation, volume);
+        #else
             uint3 rayDataTexCoords = DDGIGetRayDataTexelCoords(rayIndex, probeIndex, volume);
+        #endif
 
         #if RTXGI_DDGI_BLEND_RADIANCE
             // Load the ray radiance and store it in shared memory
@@ -194,7 +240,7 @@
             RayDistance[rayIndex] = DDGILoadProbeRayDistance(RayData, rayDataTexCoords, volume);
 
             // Get a random normalized probe ray direction and store it in shared memory
-            RayDirection[rayIndex] = DDGIGetProbeRayDirection(rayIndex, volume);
+            RayDirection[rayIndex] = DDGIGetProbeRayDirection(rayIndex, int(rayAllocation.numRays), volume);
         }
 
         // Wait for all threads in the group to finish their shared memory operations
@@ -278,8 +324,20 @@ void DDGIProbeBlendingCS(
     bool isBorderTexel = (GroupThreadID.x == 0 || GroupThreadID.x == (RTXGI_DDGI_PROBE_NUM_INTERIOR_TEXELS + 1)); // Border Columns
     isBorderTexel |= (GroupThreadID.y == 0 || GroupThreadID.y == (RTXGI_DDGI_PROBE_NUM_INTERIOR_TEXELS + 1));     // Border Rows
 
+#if RTXGI_DDGI_MERGED_DISPATCH
+    #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
+        // Get the merged dispatch table from the descriptor heap (SM6.6+ only)
+        StructuredBuffer<DDGIMergedDispatchEntry> DDGIMergedDispatchTable = ResourceDescriptorHeap[GetDDGIMergedDispatchTableIndex()];
+    #endif
+
+    // Get the volume and probe index of this thread group (one probe per thread group)
+    uint volumeIndex;
+    int mergedProbeIndex;
+    if (!DDGIGetMergedDispatchProbe(DDGIMergedDispatchTable, DDGIGetMergedDispatchGroupIndex(GroupID), volumeIndex, mergedProbeIndex)) return;
+#else
     // Get the volume's index
     uint volumeIndex = GetDDGIVolumeIndex();
+#endif
 
 #if RTXGI_DDGI_BINDLESS_RESOURCES
     #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
@@ -291,6 +349,25 @@ void DDGIProbeBlendingCS(
     // Get the volume's constants
     DDGIVolumeDescGPU volume = UnpackDDGIVolumeDescGPU(DDGIVolumes[volumeIndex]);
 
+#if RTXGI_DDGI_MERGED_DISPATCH
+    // Compute the thread IDs this thread has when the volume is dispatched by itself
+    GroupID = DDGIGetProbeTexelCoords(mergedProbeIndex, volume);
+    DispatchThreadID = (GroupID * uint3(RTXGI_DDGI_PROBE_NUM_TEXELS, RTXGI_DDGI_PROBE_NUM_TEXELS, 1)) + GroupThreadID;
+#elif RTXGI_DDGI_PROBE_COMPACTION
+    #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
+        // Get the probe compaction buffer from the descriptor heap (SM6.6+ only)
+        StructuredBuffer<uint> DDGIProbeCompaction = ResourceDescriptorHeap[GetDDGIProbeCompactionBufferIndex()];
+    #endif
+
+    // Get the probe of this thread group from the volume's compacted probe list (one probe per thread group)
+    int compactedProbeIndex;
+    if (!DDGIGetCompactedProbe(DDGIProbeCompaction, DDGIGetProbeCompactionGroupIndex(GroupID), compactedProbeIndex)) return;
+
+    // Compute the thread IDs this thread has when all of the volume's probes are dispatched
+    GroupID = DDGIGetProbeTexelCoords(compactedProbeIndex, volume);
+    DispatchThreadID = (GroupID * uint3(RTXGI_DDGI_PROBE_NUM_TEXELS, RTXGI_DDGI_PROBE_NUM_TEXELS, 1)) + GroupThreadID;
+#endif
+
     // Get the volume's resources
 #if RTXGI_DDGI_BINDLESS_RESOURCES
     #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
@@ -342,9 +419,21 @@ void DDGIProbeBlendingCS(
     // Early out: no probe maps to this thread
     if (probeIndex >= numProbes || probeIndex < 0) return;
 
+    // Get the location and number of the probe's rays in the RayData texture array
+#if RTXGI_DDGI_ADAPTIVE_RAYS
+    #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
+        // Get the probe ray allocations from the descriptor heap (SM6.6+ only)
+        StructuredBuffer<DDGIProbeRayAllocation> DDGIProbeRayAllocations = ResourceDescriptorHeap[volume.probeRayAllocationsIndex];
+    #endif
+    DDGIProbeRayAllocation rayAllocation = DDGILoadProbeRayAllocation(DDGIProbeRayAllocations, probeIndex, volume);
+#else
+    DDGIProbeRayAllocation rayAllocation = DDGIGetDefaultProbeRayAllocation(probeIndex, volume);
+#endif
+    int numRays = int(rayAllocation.numRays);
+
 #if RTXGI_DDGI_BLEND_SHARED_MEMORY
     // Cooperatively load the ray radiance and hit distance values into shared memory and cooperatively compute probe ray directions
-    LoadSharedMemory(probeIndex, GroupIndex, RayData, volume);
+    LoadSharedMemory(probeIndex, rayAllocation, GroupIndex, RayData, volume);
 #endif // RTXGI_DDGI_BLEND_SHARED_MEMORY
 
     if(!isBorderTexel)
@@ -391,7 +480,7 @@ void DDGIProbeBlendingCS(
         if (probeState == RTXGI_DDGI_PROBE_STATE_INACTIVE)
         {
         #if RTXGI_DDGI_BLEND_RADIANCE
-            ProbeVariability[DispatchThreadID].r = 0.f;
+            ProbeVariability[threadCoords].r = 0.f;
         #endif
             return;
         }
@@ -408,23 +497,26 @@ void DDGIProbeBlendingCS(
             rayIndex = RTXGI_DDGI_NUM_FIXED_RAYS;
         }
 
+        // Early out: the probe only traced the fixed rays this update (adaptive probe rays), keep its current value
+        if (rayIndex >= numRays) return;
+
     #if RTXGI_DDGI_BLEND_RADIANCE
         // Backface hits are ignored when blending radiance
         // If more than the backface threshold of the rays hit backfaces, the probe is probably inside geometry
         // In this case, don't blend anything into the probe
         uint backfaces = 0;
-        uint maxBackfaces = uint((volume.probeNumRays - rayIndex) * volume.probeRandomRayBackfaceThreshold);
+        uint maxBackfaces = uint((numRays - rayIndex) * volume.probeRandomRayBackfaceThreshold);
     #endif
 
         // Blend each ray's radiance or distance values to compute irradiance or fitered distance
         float4 result = float4(0.f, 0.f, 0.f, 0.f);
-        for ( ; rayIndex < volume.probeNumRays; rayIndex++)
+        for ( ; rayIndex < numRays; rayIndex++)
         {
             // Get the direction for this probe ray
         #if RTXGI_DDGI_BLEND_SHARED_MEMORY
             float3 rayDirection = RayDirection[rayIndex];
         #else
-            float3 rayDirection = DDGIGetProbeRayDirection(rayIndex, volume);
+            float3 rayDirection = DDGIGetProbeRayDirection(rayIndex, numRays, volume);
         #endif
 
             // Find the weight of the contribution for this ray
@@ -432,7 +524,11 @@ void DDGIProbeBlendingCS(
             float weight = max(0.f, dot(probeRayDirection, rayDirection));
 
             // Get the coordinates for the probe ray in the RayData texture array
+        #if RTXGI_DDGI_ADAPTIVE_RAYS
+            uint3 rayDataTexCoords = DDGIGetRayDataTexelCoords(rayIndex, rayAllocation, volume);
+        #else
             uint3 rayDataTexCoords = DDGIGetRayDataTexelCoords(rayIndex, probeIndex, volume);
+        #endif
 
         #if RTXGI_DDGI_BLEND_RADIANCE
             // Load the ray traced radiance and hit distance
@@ -484,7 +580,7 @@ void DDGIProbeBlendingCS(
         #endif // RTXGI_DDGI_BLEND_RADIANCE
         }
 
-        float epsilon = float(volume.probeNumRays);
+        float epsilon = float(numRays);
         if (volume.probeRelocationEnabled || volume.probeClassificationEnabled)
         {
             // If relocation or classification are enabled, fixed rays aren't blended since they will bias the result
@@ -510,6 +606,10 @@ void DDGIProbeBlendingCS(
         float  hysteresis = volume.probeHysteresis;
         if (dot(probeIrradianceMean, probeIrradianceMean) == 0) hysteresis = 0.f;
 
+        // Lower the hysteresis of probes reset by scene changes, as when a large lighting change is detected
+        bool probeReset = DDGIIsProbeReset(DDGIGetProbeCoords(probeIndex, volume), volume);
+        if (probeReset) hysteresis = max(0.f, hysteresis - 0.75f);
+
     #if RTXGI_DDGI_BLEND_RADIANCE
         // Tone-mapping gamma adjustment
         result.rgb = pow(result.rgb, (1.f / volume.probeIrradianceEncodingGamma));
@@ -520,15 +620,15 @@ void DDGIProbeBlendingCS(
         // Store the current irradiance (before interpolation) for use in probe variability
         float3 irradianceSample = result.rgb;
 
-        if (RTXGIMaxComponent(probeIrradianceMean.rgb - result.rgb) > volume.probeIrradianceThreshold)
+        if (!probeReset && RTXGIMaxComponent(probeIrradianceMean.rgb - result.rgb) > volume.probeIrradianceThreshold)
         {
             // Lower the hysteresis when a large lighting change is detected
             hysteresis = max(0.f, hysteresis - 0.75f);
         }
 
-        if (RTXGILinearRGBToLuminance(delta) > volume.probeBrightnessThreshold)
+        if (!probeReset && RTXGILinearRGBToLuminance(delta) > volume.probeBrightnessThreshold)
         {
-            // Clamp the maximum per-update change in irradiance when a large brightness change is detected
+            // Clamp the maximum per-update change in irradiance when a large brightness change is detected (unless the probe is reset)
             delta *= 0.25f;
         }
 
@@ -29,6 +29,12 @@
     #if RTXGI_DDGI_BINDLESS_RESOURCES
         #define VOLUME_RESOURCES_REG_DECL 
         #define RWTEX2DARRAY_REG_DECL 
+        #if RTXGI_DDGI_MERGED_DISPATCH
+        #define MERGED_DISPATCH_REG_DECL 
+        #endif
+        #if RTXGI_DDGI_ADAPTIVE_RAYS
+        #define PROBE_RAY_ALLOCATIONS_REG_DECL 
+        #endif
     #else
         #define RAY_DATA_REG_DECL 
         #define PROBE_DATA_REG_DECL 
@@ -42,6 +48,12 @@
         #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_RESOURCE_ARRAYS
             #define VOLUME_RESOURCES_REG_DECL : register(VOLUME_RESOURCES_REGISTER, VOLUME_RESOURCES_SPACE)
             #define RWTEX2DARRAY_REG_DECL : register(RWTEX2DARRAY_REGISTER, RWTEX2DARRAY_SPACE)
+            #if RTXGI_DDGI_MERGED_DISPATCH
+            #define MERGED_DISPATCH_REG_DECL : register(MERGED_DISPATCH_REGISTER, MERGED_DISPATCH_SPACE)
+            #endif
+            #if RTXGI_DDGI_ADAPTIVE_RAYS
+            #define PROBE_RAY_ALLOCATIONS_REG_DECL : register(PROBE_RAY_ALLOCATIONS_REGISTER, PROBE_RAY_ALLOCATIONS_SPACE)
+            #endif
         #endif
     #else
         #define RAY_DATA_REG_DECL : register(RAY_DATA_REGISTER, RAY_DATA_SPACE)
@@ -54,6 +66,9 @@
 
 #include "include/ProbeCommon.hlsl"
 #include "include/DDGIRootConstants.hlsl"
+#if RTXGI_DDGI_MERGED_DISPATCH
+#include "include/DDGIMergedDispatch.hlsl"
+#endif
 
 // -------- RESOURCE DECLARATIONS -----------------------------------------------------------------
 
@@ -72,6 +87,18 @@
         RTXGI_VK_BINDING(RWTEX2DARRAY_REGISTER, RWTEX2DARRAY_SPACE)
         RWTexture2DArray<float4> RWTex2DArray[] RWTEX2DARRAY_REG_DECL;
 
+        #if RTXGI_DDGI_MERGED_DISPATCH
+        // Merged dispatch table (maps the probes of a merged dispatch to their volume)
+        RTXGI_VK_BINDING(MERGED_DISPATCH_REGISTER, MERGED_DISPATCH_SPACE)
+        StructuredBuffer<DDGIMergedDispatchEntry> DDGIMergedDispatchTable MERGED_DISPATCH_REG_DECL;
+        #endif
+
+        #if RTXGI_DDGI_ADAPTIVE_RAYS
+        // Probe ray allocations (locates the rays of each probe in the packed RayData layout)
+        RTXGI_VK_BINDING(PROBE_RAY_ALLOCATIONS_REGISTER, PROBE_RAY_ALLOCATIONS_SPACE)
+        StructuredBuffer<DDGIProbeRayAllocation> DDGIProbeRayAllocations PROBE_RAY_ALLOCATIONS_REG_DECL;
+        #endif
+
     #endif
 #else
 
@@ -92,11 +119,26 @@
 [numthreads(32, 1, 1)]
 void DDGIProbeClassificationCS(uint3 DispatchThreadID : SV_DispatchThreadID)
 {
+#if RTXGI_DDGI_MERGED_DISPATCH
+    #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
+        // Get the merged dispatch table from the descriptor heap (SM6.6+ only)
+        StructuredBuffer<DDGIMergedDispatchEntry> DDGIMergedDispatchTable = ResourceDescriptorHeap[GetDDGIMergedDispatchTableIndex()];
+    #endif
+
+    // Get the volume and probe index of this thread (thread groups wrap onto the Y axis)
+    uint volumeIndex;
+    int mergedProbeIndex;
+    uint dispatchProbeIndex = (DispatchThreadID.y * RTXGI_DDGI_MERGED_DISPATCH_MAX_GROUPS_X * 32) + DispatchThreadID.x;
+    if (!DDGIGetMergedDispatchProbe(DDGIMergedDispatchTable, dispatchProbeIndex, volumeIndex, mergedProbeIndex)) return;
+
+    uint probeIndex = uint(mergedProbeIndex);
+#else
     // Get the volume's index
     uint volumeIndex = GetDDGIVolumeIndex();
 
     // Compute the probe index for this thread
     uint probeIndex = DispatchThreadID.x;
+#endif
 
 #if RTXGI_DDGI_BINDLESS_RESOURCES
     #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
@@ -131,6 +173,16 @@ void DDGIProbeClassificationCS(uint3 DispatchThreadID : SV_DispatchThreadID)
     #endif
 #endif
 
+#if RTXGI_DDGI_ADAPTIVE_RAYS
+    #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
+        // Get the probe ray allocations from the descriptor heap (SM6.6+ only)
+        StructuredBuffer<DDGIProbeRayAllocation> DDGIProbeRayAllocations = ResourceDescriptorHeap[volume.probeRayAllocationsIndex];
+    #endif
+
+    // Get the location of the probe's rays in the RayData texture array (the fixed rays are always traced)
+    DDGIProbeRayAllocation rayAllocation = DDGILoadProbeRayAllocation(DDGIProbeRayAllocations, probeIndex, volume);
+#endif
+
     // Get the number of ray samples to inspect
     int numRays = min(volume.probeNumRays, RTXGI_DDGI_NUM_FIXED_RAYS);
 
@@ -142,7 +194,11 @@ void DDGIProbeClassificationCS(uint3 DispatchThreadID : SV_DispatchThreadID)
     for (rayIndex = 0; rayIndex < RTXGI_DDGI_NUM_FIXED_RAYS; rayIndex++)
     {
         // Get the coordinates for the probe ray in the RayData texture array
+    #if RTXGI_DDGI_ADAPTIVE_RAYS
+        int3 rayDataTexCoords = DDGIGetRayDataTexelCoords(rayIndex, rayAllocation, volume);
+    #else
         int3 rayDataTexCoords = DDGIGetRayDataTexelCoords(rayIndex, probeIndex, volume);
+    #endif
 
         // Load the hit distance for the ray
         hitDistances[rayIndex] = DDGILoadProbeRayDistance(RayData, rayDataTexCoords, volume);
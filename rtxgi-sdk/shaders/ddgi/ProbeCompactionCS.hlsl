@@ -0,0 +1,202 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// For example usage, see DDGIVolume_[D3D12|VK].cpp::CompactDDGIVolumeProbes() function.
+
+// -------- CONFIG FILE ---------------------------------------------------------------------------
+
+#if RTXGI_DDGI_USE_SHADER_CONFIG_FILE
+#include <DDGIShaderConfig.h>
+#endif
+
+// -------- DEFINE VALIDATION ---------------------------------------------------------------------
+
+#include "include/validation/ProbeCompactionDefines.hlsl"
+
+// -------- REGISTER DECLARATIONS -----------------------------------------------------------------
+
+#if RTXGI_DDGI_SHADER_REFLECTION || defined(__spirv__)
+
+    // Don't declare registers when using reflection or cross-compiling to SPIRV
+    #define VOLUME_CONSTS_REG_DECL 
+    #define VOLUME_RESOURCES_REG_DECL 
+    #define RWTEX2DARRAY_REG_DECL 
+    #define PROBE_COMPACTION_REG_DECL 
+    #if RTXGI_DDGI_ADAPTIVE_RAYS
+    #define PROBE_RAY_ALLOCATIONS_REG_DECL 
+    #endif
+
+#else
+
+    // Declare registers and spaces when using D3D *without* reflection
+    #define VOLUME_CONSTS_REG_DECL : register(VOLUME_CONSTS_REGISTER, VOLUME_CONSTS_SPACE)
+    #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_RESOURCE_ARRAYS
+        #define VOLUME_RESOURCES_REG_DECL : register(VOLUME_RESOURCES_REGISTER, VOLUME_RESOURCES_SPACE)
+        #define RWTEX2DARRAY_REG_DECL : register(RWTEX2DARRAY_REGISTER, RWTEX2DARRAY_SPACE)
+        #define PROBE_COMPACTION_REG_DECL : register(PROBE_COMPACTION_REGISTER, PROBE_COMPACTION_SPACE)
+        #if RTXGI_DDGI_ADAPTIVE_RAYS
+        #define PROBE_RAY_ALLOCATIONS_REG_DECL : register(PROBE_RAY_ALLOCATIONS_REGISTER, PROBE_RAY_ALLOCATIONS_SPACE)
+        #endif
+    #endif
+
+#endif // RTXGI_DDGI_SHADER_REFLECTION || SPIRV
+
+// -------- ROOT / PUSH CONSTANT DECLARATIONS -----------------------------------------------------
+
+#include "include/ProbeCommon.hlsl"
+#include "include/DDGIRootConstants.hlsl"
+#include "include/DDGIProbeCompaction.hlsl"
+
+// -------- RESOURCE DECLARATIONS -----------------------------------------------------------------
+
+#if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_RESOURCE_ARRAYS
+
+    // DDGIVolume constants structured buffer
+    RTXGI_VK_BINDING(VOLUME_CONSTS_REGISTER, VOLUME_CONSTS_SPACE)
+    StructuredBuffer<DDGIVolumeDescGPUPacked> DDGIVolumes VOLUME_CONSTS_REG_DECL;
+
+    // DDGIVolume resource indices structured buffer
+    RTXGI_VK_BINDING(VOLUME_RESOURCES_REGISTER, VOLUME_RESOURCES_SPACE)
+    StructuredBuffer<DDGIVolumeResourceIndices> DDGIVolumeBindless VOLUME_RESOURCES_REG_DECL;
+
+    // DDGIVolume probe data and probe variability
+    RTXGI_VK_BINDING(RWTEX2DARRAY_REGISTER, RWTEX2DARRAY_SPACE)
+    RWTexture2DArray<float4> RWTex2DArray[] RWTEX2DARRAY_REG_DECL;
+
+    // Probe compaction buffer (compaction arguments and compacted probe lists of all volumes)
+    RTXGI_VK_BINDING(PROBE_COMPACTION_REGISTER, PROBE_COMPACTION_SPACE)
+    RWStructuredBuffer<uint> DDGIProbeCompaction PROBE_COMPACTION_REG_DECL;
+
+    #if RTXGI_DDGI_ADAPTIVE_RAYS
+    // Probe ray allocations (locates the rays of each probe in the packed RayData layout)
+    RTXGI_VK_BINDING(PROBE_RAY_ALLOCATIONS_REGISTER, PROBE_RAY_ALLOCATIONS_SPACE)
+    StructuredBuffer<DDGIProbeRayAllocation> DDGIProbeRayAllocations PROBE_RAY_ALLOCATIONS_REG_DECL;
+    #endif
+
+#endif
+
+// -------- ENTRY POINT ---------------------------------------------------------------------------
+
+[numthreads(32, 1, 1)]
+void DDGIProbeCompactionCS(uint3 DispatchThreadID : SV_DispatchThreadID)
+{
+#if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
+    // Get the probe compaction buffer from the descriptor heap (SM6.6+ only)
+    RWStructuredBuffer<uint> DDGIProbeCompaction = ResourceDescriptorHeap[GetDDGIProbeCompactionBufferIndex()];
+#endif
+
+    uint argsOffset = GetDDGIProbeCompactionRegionOffset();
+
+    // Clear the volume's compaction arguments before its probes are compacted
+    if (GetDDGIProbeCompactionClear())
+    {
+        if (DispatchThreadID.x == 0)
+        {
+            DDGIProbeCompaction[argsOffset] = 0;        // numProbes
+            DDGIProbeCompaction[argsOffset + 1] = 0;    // threadGroupCountX
+            DDGIProbeCompaction[argsOffset + 2] = 0;    // threadGroupCountY
+            DDGIProbeCompaction[argsOffset + 3] = 1;    // threadGroupCountZ
+        }
+        return;
+    }
+
+    // Get the volume's index
+    uint volumeIndex = GetDDGIVolumeIndex();
+
+#if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
+    // Get the DDGIVolume constants structured buffer from the descriptor heap (SM6.6+ only)
+    StructuredBuffer<DDGIVolumeDescGPUPacked> DDGIVolumes = ResourceDescriptorHeap[GetDDGIVolumeConstantsIndex()];
+#endif
+
+    // Get the volume's constants
+    DDGIVolumeDescGPU volume = UnpackDDGIVolumeDescGPU(DDGIVolumes[volumeIndex]);
+
+    // Compute the probe index for this thread
+    int probeIndex = int(DispatchThreadID.x);
+    int numProbes = (volume.probeCounts.x * volume.probeCounts.y * volume.probeCounts.z);
+
+    // Determine if the probe needs blending. Threads past the number of probes stay active for the wave operations below.
+    bool blend = false;
+    if (probeIndex < numProbes)
+    {
+    #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
+        // Get the volume's resource indices from the descriptor heap (SM6.6+ only)
+        StructuredBuffer<DDGIVolumeResourceIndices> DDGIVolumeBindless = ResourceDescriptorHeap[GetDDGIVolumeResourceIndicesIndex()];
+        DDGIVolumeResourceIndices resourceIndices = DDGIVolumeBindless[volumeIndex];
+
+        // Get the volume's probe data and probe variability UAVs from the descriptor heap (SM6.6+ only)
+        RWTexture2DArray<float4> ProbeData = ResourceDescriptorHeap[resourceIndices.probeDataUAVIndex];
+        RWTexture2DArray<float4> ProbeVariability = ResourceDescriptorHeap[resourceIndices.probeVariabilityUAVIndex];
+    #elif RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_RESOURCE_ARRAYS
+        // Get the volume's resource indices
+        DDGIVolumeResourceIndices resourceIndices = DDGIVolumeBindless[volumeIndex];
+
+        // Get the volume's probe data and probe variability UAVs
+        RWTexture2DArray<float4> ProbeData = RWTex2DArray[resourceIndices.probeDataUAVIndex];
+        RWTexture2DArray<float4> ProbeVariability = RWTex2DArray[resourceIndices.probeVariabilityUAVIndex];
+    #endif
+
+        // Probes in scrolled planes are cleared by probe blending
+        if (IsVolumeMovementScrolling(volume))
+        {
+            int3 probeCoords = DDGIGetProbeCoords(probeIndex, volume);
+            blend = DDGIClearScrolledPlane(probeCoords, 0, volume);
+            blend |= DDGIClearScrolledPlane(probeCoords, 1, volume);
+            blend |= DDGIClearScrolledPlane(probeCoords, 2, volume);
+        }
+
+        int probeState = DDGILoadProbeState(probeIndex, ProbeData, volume);
+        if (probeState == RTXGI_DDGI_PROBE_STATE_INACTIVE)
+        {
+            // Inactive probes are blended once more when they still have variability, to clear it
+            if (volume.probeVariabilityEnabled)
+            {
+                uint3 variabilityCoords = DDGIGetProbeTexelCoords(probeIndex, volume);
+                variabilityCoords.xy *= uint(volume.probeNumIrradianceInteriorTexels);
+                blend |= (ProbeVariability[variabilityCoords].r != 0.f);
+            }
+        }
+        else
+        {
+            // Get the number of rays the probe traced this update
+        #if RTXGI_DDGI_ADAPTIVE_RAYS
+            #if RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP
+            // Get the probe ray allocations from the descriptor heap (SM6.6+ only)
+            StructuredBuffer<DDGIProbeRayAllocation> DDGIProbeRayAllocations = ResourceDescriptorHeap[volume.probeRayAllocationsIndex];
+            #endif
+            DDGIProbeRayAllocation rayAllocation = DDGILoadProbeRayAllocation(DDGIProbeRayAllocations, probeIndex, volume);
+        #else
+            DDGIProbeRayAllocation rayAllocation = DDGIGetDefaultProbeRayAllocation(probeIndex, volume);
+        #endif
+
+            // Active probes are blended when they traced rays beyond the fixed rays (see DDGIProbeBlendingCS)
+            int firstRay = (volume.probeRelocationEnabled || volume.probeClassificationEnabled) ? RTXGI_DDGI_NUM_FIXED_RAYS : 0;
+            blend |= (int(rayAllocation.numRays) > firstRay);
+        }
+    }
+
+    // Append the wave's probes to the volume's compacted probe list
+    uint waveCount = WaveActiveCountBits(blend);
+    if (waveCount == 0) return;
+
+    uint waveOffset = 0;
+    if (WaveIsFirstLane()) InterlockedAdd(DDGIProbeCompaction[argsOffset], waveCount, waveOffset);
+    waveOffset = WaveReadLaneFirst(waveOffset);
+
+    if (blend) DDGIProbeCompaction[DDGIGetProbeCompactionListOffset() + waveOffset + WavePrefixCountBits(blend)] = uint(probeIndex);
+
+    // Grow the indirect dispatch arguments to cover the list (one thread group per probe, wrapping onto the Y axis)
+    if (WaveIsFirstLane())
+    {
+        uint numGroups = waveOffset + waveCount;
+        InterlockedMax(DDGIProbeCompaction[argsOffset + 1], min(numGroups, RTXGI_DDGI_PROBE_COMPACTION_MAX_GROUPS_X));
+        InterlockedMax(DDGIProbeCompaction[argsOffset + 2], ((numGroups - 1) / RTXGI_DDGI_PROBE_COMPACTION_MAX_GROUPS_X) + 1);
+    }
+}
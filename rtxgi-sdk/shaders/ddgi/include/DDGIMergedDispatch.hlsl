@@ -0,0 +1,75 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#ifndef RTXGI_DDGI_MERGED_DISPATCH_HLSL
+#define RTXGI_DDGI_MERGED_DISPATCH_HLSL
+
+#include "Common.hlsl"
+
+// When RTXGI_DDGI_MERGED_DISPATCH is enabled, the root / push constants describe a batch of
+// a merged dispatch instead of a single volume (see GetDDGIMergedDispatchRootConstants()):
+//  - volumeIndex: index of the batch's first entry in the merged dispatch table
+//  - reductionInputSizeX: number of entries in the batch
+//  - reductionInputSizeY: number of probes in the batch (including thread group alignment padding)
+//  - reductionInputSizeZ: index of the merged dispatch table SRV on the descriptor heap (D3D12 descriptor heap bindless only)
+
+uint GetDDGIMergedDispatchFirstEntry() { return GetDDGIVolumeIndex(); }
+uint GetDDGIMergedDispatchNumEntries() { return GetReductionInputSize().x; }
+uint GetDDGIMergedDispatchNumProbes() { return GetReductionInputSize().y; }
+uint GetDDGIMergedDispatchTableIndex() { return GetReductionInputSize().z; }
+
+/**
+ * Computes the linear index of a thread group in a merged dispatch.
+ * Merged dispatches wrap onto the Y axis after RTXGI_DDGI_MERGED_DISPATCH_MAX_GROUPS_X thread groups.
+ */
+uint DDGIGetMergedDispatchGroupIndex(uint3 groupID)
+{
+    return (groupID.y * RTXGI_DDGI_MERGED_DISPATCH_MAX_GROUPS_X) + groupID.x;
+}
+
+/**
+ * Finds the volume and probe that map to a probe of a merged dispatch.
+ * Returns false when the probe maps to thread group alignment padding.
+ * Matches DDGIMergedDispatch::GetProbe().
+ */
+bool DDGIGetMergedDispatchProbe(StructuredBuffer<DDGIMergedDispatchEntry> table, uint dispatchProbeIndex, out uint volumeIndex, out int probeIndex)
+{
+    volumeIndex = 0;
+    probeIndex = -1;
+
+    uint count = GetDDGIMergedDispatchNumEntries();
+    if (count == 0 || dispatchProbeIndex >= GetDDGIMergedDispatchNumProbes()) return false;
+
+    // Binary search for the last entry that starts at or before the probe
+    uint first = GetDDGIMergedDispatchFirstEntry();
+    while (count > 1)
+    {
+        uint step = count / 2;
+        if (table[first + step].dispatchProbeOffset <= dispatchProbeIndex)
+        {
+            first += step;
+            count -= step;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    DDGIMergedDispatchEntry entry = table[first];
+    uint offset = dispatchProbeIndex - entry.dispatchProbeOffset;
+    if (offset >= entry.numProbes) return false;
+
+    volumeIndex = entry.volumeIndex;
+    probeIndex = int(entry.probeOffset + offset);
+    return true;
+}
+
+#endif // RTXGI_DDGI_MERGED_DISPATCH_HLSL
@@ -0,0 +1,52 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#ifndef RTXGI_DDGI_PROBE_COMPACTION_HLSL
+#define RTXGI_DDGI_PROBE_COMPACTION_HLSL
+
+#include "Common.hlsl"
+
+// In probe compaction and compacted probe blending dispatches, the reduction input size
+// root / push constants describe the volume's region of the probe compaction buffer
+// (see GetDDGIProbeCompactionRootConstants()):
+//  - reductionInputSizeX: offset (in uints) of the volume's region in the probe compaction buffer
+//  - reductionInputSizeY: 1 when clearing the volume's compaction arguments, 0 otherwise
+//  - reductionInputSizeZ: index of the probe compaction buffer UAV or SRV on the descriptor heap (D3D12 descriptor heap bindless only)
+
+uint GetDDGIProbeCompactionRegionOffset() { return GetReductionInputSize().x; }
+bool GetDDGIProbeCompactionClear() { return (GetReductionInputSize().y != 0); }
+uint GetDDGIProbeCompactionBufferIndex() { return GetReductionInputSize().z; }
+
+// A volume's region starts with a DDGIProbeCompactionArgs (4 uints), followed by the compacted probe list
+uint DDGIGetProbeCompactionListOffset() { return GetDDGIProbeCompactionRegionOffset() + 4; }
+
+/**
+ * Computes the linear index of a thread group in a compacted probe blending dispatch.
+ * Compacted dispatches wrap onto the Y axis after RTXGI_DDGI_PROBE_COMPACTION_MAX_GROUPS_X thread groups.
+ */
+uint DDGIGetProbeCompactionGroupIndex(uint3 groupID)
+{
+    return (groupID.y * RTXGI_DDGI_PROBE_COMPACTION_MAX_GROUPS_X) + groupID.x;
+}
+
+/**
+ * Gets the probe at the given index of the volume's compacted probe list.
+ * Returns false when the index is past the end of the list.
+ */
+bool DDGIGetCompactedProbe(StructuredBuffer<uint> compaction, uint listIndex, out int probeIndex)
+{
+    probeIndex = -1;
+    if (listIndex >= compaction[GetDDGIProbeCompactionRegionOffset()]) return false;
+
+    probeIndex = int(compaction[DDGIGetProbeCompactionListOffset() + listIndex]);
+    return true;
+}
+
+#endif // RTXGI_DDGI_PROBE_COMPACTION_HLSL
@@ -15,6 +15,7 @@
 #include "ProbeDataCommon.hlsl"
 #include "ProbeRayCommon.hlsl"
 #include "ProbeIndexing.hlsl"
+#include "ProbeRayAllocation.hlsl"
 #include "ProbeOctahedral.hlsl"
 
 //------------------------------------------------------------------------
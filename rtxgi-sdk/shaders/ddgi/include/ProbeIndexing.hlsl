@@ -310,4 +310,25 @@ bool DDGIClearScrolledPlane(int3 probeCoords, int planeIndex, DDGIVolumeDescGPU
     return false;
 }
 
+//------------------------------------------------------------------------
+// Scene Change Events
+//------------------------------------------------------------------------
+
+/**
+ * Determines if a probe is reset due to scene changes (see DDGIVolumeBase::OnLargeObjectChange()).
+ * The probe coordinates are (scrolled) coordinates of the probe's texels, e.g. from DDGIGetProbeCoords().
+ */
+bool DDGIIsProbeReset(int3 probeCoords, DDGIVolumeDescGPU volume)
+{
+    if (!volume.probeResetEnabled) return false;
+
+    // Get the probe's unscrolled grid coordinates
+    if (IsVolumeMovementScrolling(volume))
+    {
+        probeCoords = (((probeCoords - volume.probeScrollOffsets) % volume.probeCounts) + volume.probeCounts) % volume.probeCounts;
+    }
+
+    return all(probeCoords >= volume.probeResetMin) && all(probeCoords <= volume.probeResetMax);
+}
+
 #endif // RTXGI_DDGI_PROBE_INDEXING_HLSL
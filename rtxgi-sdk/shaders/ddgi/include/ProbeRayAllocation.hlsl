@@ -0,0 +1,91 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#ifndef RTXGI_DDGI_PROBE_RAY_ALLOCATION_HLSL
+#define RTXGI_DDGI_PROBE_RAY_ALLOCATION_HLSL
+
+#include "ProbeIndexing.hlsl"
+
+//------------------------------------------------------------------------
+// Adaptive Probe Rays
+//------------------------------------------------------------------------
+
+// When adaptive probe rays are enabled, each probe traces the number of rays given by its
+// DDGIProbeRayAllocation (see DDGIProbeRayAllocator) and the rays of all probes are packed
+// in probe index order into the volume's RayData texture array. The RayData texture array
+// is sized for probeNumRays rays per probe, so packed ray indices wrap to the next row
+// after probeNumRays rays.
+
+/**
+ * Gets the ray allocation of a probe when all probes trace probeNumRays rays.
+ */
+DDGIProbeRayAllocation DDGIGetDefaultProbeRayAllocation(int probeIndex, DDGIVolumeDescGPU volume)
+{
+    DDGIProbeRayAllocation allocation;
+    allocation.rayOffset = uint(probeIndex * volume.probeNumRays);
+    allocation.numRays = uint(volume.probeNumRays);
+    return allocation;
+}
+
+/**
+ * Loads the ray allocation of a probe from the probe ray allocations structured buffer.
+ * Returns the default allocation when the volume does not have adaptive probe rays enabled.
+ */
+DDGIProbeRayAllocation DDGILoadProbeRayAllocation(StructuredBuffer<DDGIProbeRayAllocation> allocations, int probeIndex, DDGIVolumeDescGPU volume)
+{
+    if (!volume.probeAdaptiveRaysEnabled) return DDGIGetDefaultProbeRayAllocation(probeIndex, volume);
+    return allocations[volume.probeRayAllocationOffset + probeIndex];
+}
+
+/**
+ * Computes the RayData Texture2DArray coordinates of a probe ray from the probe's ray allocation.
+ * With the default allocation, matches DDGIGetRayDataTexelCoords(rayIndex, probeIndex, volume).
+ */
+uint3 DDGIGetRayDataTexelCoords(int rayIndex, DDGIProbeRayAllocation allocation, DDGIVolumeDescGPU volume)
+{
+    uint packedRayIndex = allocation.rayOffset + uint(rayIndex);
+    return DDGIGetRayDataTexelCoords(int(packedRayIndex % volume.probeNumRays), int(packedRayIndex / volume.probeNumRays), volume);
+}
+
+/**
+ * Finds the probe and probe ray that map to a packed ray index (e.g. the thread index of a one dimensional ray tracing dispatch).
+ * Returns false when the packed ray index is outside the volume's allocations.
+ */
+bool DDGIFindProbeRay(StructuredBuffer<DDGIProbeRayAllocation> allocations, uint packedRayIndex, DDGIVolumeDescGPU volume, out int probeIndex, out int rayIndex)
+{
+    probeIndex = -1;
+    rayIndex = -1;
+
+    // Binary search for the last probe whose rays start at or before the packed ray index
+    uint first = volume.probeRayAllocationOffset;
+    uint count = uint(volume.probeCounts.x * volume.probeCounts.y * volume.probeCounts.z);
+    while (count > 1)
+    {
+        uint step = count / 2;
+        if (allocations[first + step].rayOffset <= packedRayIndex)
+        {
+            first += step;
+            count -= step;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+
+    DDGIProbeRayAllocation allocation = allocations[first];
+    if (packedRayIndex < allocation.rayOffset || packedRayIndex >= (allocation.rayOffset + allocation.numRays)) return false;
+
+    probeIndex = int(first - volume.probeRayAllocationOffset);
+    rayIndex = int(packedRayIndex - allocation.rayOffset);
+    return true;
+}
+
+#endif // RTXGI_DDGI_PROBE_RAY_ALLOCATION_HLSL
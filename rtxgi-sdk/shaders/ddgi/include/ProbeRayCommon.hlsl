@@ -107,14 +107,14 @@ float DDGILoadProbeRayDistance(RWTexture2DArray<float4> RayData, uint3 coords, D
 //------------------------------------------------------------------------
 
 /**
- * Computes a spherically distributed, normalized ray direction for the given ray index in a set of ray samples.
+ * Computes a spherically distributed, normalized ray direction for the given ray index in a set of numRays ray samples.
  * Applies the volume's random probe ray rotation transformation to "non-fixed" ray direction samples.
+ * Use with the number of rays of a probe's DDGIProbeRayAllocation when adaptive probe rays are enabled.
  */
-float3 DDGIGetProbeRayDirection(int rayIndex, DDGIVolumeDescGPU volume)
+float3 DDGIGetProbeRayDirection(int rayIndex, int numRays, DDGIVolumeDescGPU volume)
 {
     bool isFixedRay = false;
     int sampleIndex = rayIndex;
-    int numRays = volume.probeNumRays;
 
     if (volume.probeRelocationEnabled || volume.probeClassificationEnabled)
     {
@@ -133,5 +133,14 @@ float3 DDGIGetProbeRayDirection(int rayIndex, DDGIVolumeDescGPU volume)
     return normalize(RTXGIQuaternionRotate(direction, RTXGIQuaternionConjugate(volume.probeRayRotation)));
 }
 
+/**
+ * Computes a spherically distributed, normalized ray direction for the given ray index in a set of ray samples.
+ * Applies the volume's random probe ray rotation transformation to "non-fixed" ray direction samples.
+ */
+float3 DDGIGetProbeRayDirection(int rayIndex, DDGIVolumeDescGPU volume)
+{
+    return DDGIGetProbeRayDirection(rayIndex, volume.probeNumRays, volume);
+}
+
 
 #endif // RTXGI_DDGI_PROBE_RAY_COMMON_HLSL
@@ -256,4 +256,95 @@
     #define RTXGI_DDGI_DEBUG_OCTAHEDRAL_INDEXING 0
 #endif
 
+// Define RTXGI_DDGI_MERGED_DISPATCH before compiling SDK HLSL shaders to process the probes
+// of many volumes in a single dispatch (see DDGIMergedDispatch.h). Requires bindless resources.
+// 0: Disabled (default).
+// 1: Enabled.
+#ifndef RTXGI_DDGI_MERGED_DISPATCH
+    #pragma message "Optional define RTXGI_DDGI_MERGED_DISPATCH is not defined, defaulting to 0."
+    #define RTXGI_DDGI_MERGED_DISPATCH 0
+#endif
+
+#if RTXGI_DDGI_MERGED_DISPATCH
+    #if !RTXGI_DDGI_BINDLESS_RESOURCES
+        #error RTXGI_DDGI_MERGED_DISPATCH requires RTXGI_DDGI_BINDLESS_RESOURCES for ProbeBlendingCS.hlsl!
+    #endif
+
+    // MERGED_DISPATCH_REGISTER and MERGED_DISPATCH_SPACE must be passed in as defines at shader compilation time
+    // *not* using reflection and using bindless resource arrays.
+    // These defines specify the shader register and space used for the DDGIMergedDispatchEntry structured buffer.
+    // Ex: MERGED_DISPATCH_REGISTER t7
+    // Ex: MERGED_DISPATCH_SPACE space0
+    #if !RTXGI_DDGI_SHADER_REFLECTION && RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_RESOURCE_ARRAYS
+        #ifndef MERGED_DISPATCH_REGISTER
+            #error Required define MERGED_DISPATCH_REGISTER is not defined for ProbeBlendingCS.hlsl!
+        #endif
+        #ifndef MERGED_DISPATCH_SPACE
+            #error Required define MERGED_DISPATCH_SPACE is not defined for ProbeBlendingCS.hlsl!
+        #endif
+    #endif
+#endif
+
+// Define RTXGI_DDGI_ADAPTIVE_RAYS before compiling SDK HLSL shaders to read a variable number of rays
+// per probe from the probe ray allocations structured buffer (see DDGIProbeRayAllocator.h).
+// Requires bindless resources.
+// 0: Disabled (default).
+// 1: Enabled.
+#ifndef RTXGI_DDGI_ADAPTIVE_RAYS
+    #pragma message "Optional define RTXGI_DDGI_ADAPTIVE_RAYS is not defined, defaulting to 0."
+    #define RTXGI_DDGI_ADAPTIVE_RAYS 0
+#endif
+
+#if RTXGI_DDGI_ADAPTIVE_RAYS
+    #if !RTXGI_DDGI_BINDLESS_RESOURCES
+        #error RTXGI_DDGI_ADAPTIVE_RAYS requires RTXGI_DDGI_BINDLESS_RESOURCES for ProbeBlendingCS.hlsl!
+    #endif
+
+    // PROBE_RAY_ALLOCATIONS_REGISTER and PROBE_RAY_ALLOCATIONS_SPACE must be passed in as defines at shader compilation time
+    // *not* using reflection and using bindless resource arrays.
+    // These defines specify the shader register and space used for the DDGIProbeRayAllocation structured buffer.
+    // Ex: PROBE_RAY_ALLOCATIONS_REGISTER t8
+    // Ex: PROBE_RAY_ALLOCATIONS_SPACE space0
+    #if !RTXGI_DDGI_SHADER_REFLECTION && RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_RESOURCE_ARRAYS
+        #ifndef PROBE_RAY_ALLOCATIONS_REGISTER
+            #error Required define PROBE_RAY_ALLOCATIONS_REGISTER is not defined for ProbeBlendingCS.hlsl!
+        #endif
+        #ifndef PROBE_RAY_ALLOCATIONS_SPACE
+            #error Required define PROBE_RAY_ALLOCATIONS_SPACE is not defined for ProbeBlendingCS.hlsl!
+        #endif
+    #endif
+#endif
+
+// Define RTXGI_DDGI_PROBE_COMPACTION before compiling SDK HLSL shaders to blend only the probes in the
+// volume's compacted probe list, using indirect dispatches (see DDGIProbeCompaction.h). Requires bindless resources.
+// 0: Disabled (default).
+// 1: Enabled.
+#ifndef RTXGI_DDGI_PROBE_COMPACTION
+    #pragma message "Optional define RTXGI_DDGI_PROBE_COMPACTION is not defined, defaulting to 0."
+    #define RTXGI_DDGI_PROBE_COMPACTION 0
+#endif
+
+#if RTXGI_DDGI_PROBE_COMPACTION
+    #if !RTXGI_DDGI_BINDLESS_RESOURCES
+        #error RTXGI_DDGI_PROBE_COMPACTION requires RTXGI_DDGI_BINDLESS_RESOURCES for ProbeBlendingCS.hlsl!
+    #endif
+    #if RTXGI_DDGI_MERGED_DISPATCH
+        #error RTXGI_DDGI_PROBE_COMPACTION and RTXGI_DDGI_MERGED_DISPATCH cannot be enabled together for ProbeBlendingCS.hlsl!
+    #endif
+
+    // PROBE_COMPACTION_REGISTER and PROBE_COMPACTION_SPACE must be passed in as defines at shader compilation time
+    // *not* using reflection and using bindless resource arrays.
+    // These defines specify the shader register and space used for the probe compaction structured buffer.
+    // Ex: PROBE_COMPACTION_REGISTER t9
+    // Ex: PROBE_COMPACTION_SPACE space0
+    #if !RTXGI_DDGI_SHADER_REFLECTION && RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_RESOURCE_ARRAYS
+        #ifndef PROBE_COMPACTION_REGISTER
+            #error Required define PROBE_COMPACTION_REGISTER is not defined for ProbeBlendingCS.hlsl!
+        #endif
+        #ifndef PROBE_COMPACTION_SPACE
+            #error Required define PROBE_COMPACTION_SPACE is not defined for ProbeBlendingCS.hlsl!
+        #endif
+    #endif
+#endif
+
 // -------------------------------------------------------------------------------------------
@@ -0,0 +1,124 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// -------- SHADER REFLECTION DEFINES -------------------------------------------------------------
+
+// RTXGI_DDGI_SHADER_REFLECTION must be passed in as a define at shader compilation time.
+// This define specifies if the shader resources will be determined using shader reflection.
+// Ex: RTXGI_DDGI_SHADER_REFLECTION [0|1]
+#ifndef RTXGI_DDGI_SHADER_REFLECTION
+    #error Required define RTXGI_DDGI_SHADER_REFLECTION is not defined for ProbeCompactionCS.hlsl!
+#else
+    #if !RTXGI_DDGI_SHADER_REFLECTION
+        // REGISTERs AND SPACEs (SHADER REFLECTION DISABLED)
+
+        // VOLUME_CONSTS_REGISTER and VOLUME_CONSTS_SPACE must be passed in as defines at shader compilation time *when not using reflection*.
+        // These defines specify the shader register and space used for the DDGIVolumeDescGPUPacked structured buffer.
+        // Ex: VOLUME_CONSTS_REGISTER t5
+        // Ex: VOLUME_CONSTS_SPACE space0
+        #ifndef VOLUME_CONSTS_REGISTER
+            #error Required define VOLUME_CONSTS_REGISTER is not defined for ProbeCompactionCS.hlsl!
+        #endif
+        #ifndef VOLUME_CONSTS_SPACE
+            #error Required define VOLUME_CONSTS_SPACE is not defined for ProbeCompactionCS.hlsl!
+        #endif
+    #endif // !RTXGI_DDGI_SHADER_REFLECTION
+#endif // RTXGI_DDGI_SHADER_REFLECTION
+
+// -------- RESOURCE BINDING DEFINES --------------------------------------------------------------
+
+// RTXGI_DDGI_BINDLESS_RESOURCES must be passed in as a define at shader compilation time.
+// Probe compaction requires bindless resources (see DDGIProbeCompaction.h).
+// Ex: RTXGI_DDGI_BINDLESS_RESOURCES 1
+#ifndef RTXGI_DDGI_BINDLESS_RESOURCES
+    #error Required define RTXGI_DDGI_BINDLESS_RESOURCES is not defined for ProbeCompactionCS.hlsl!
+#else
+    #if !RTXGI_DDGI_BINDLESS_RESOURCES
+        #error ProbeCompactionCS.hlsl requires RTXGI_DDGI_BINDLESS_RESOURCES!
+    #endif
+
+    // RTXGI_BINDLESS_TYPE must be passed in as a define at shader compilation time.
+    // This define specifies whether bindless resources will be accessed through bindless resource arrays or the (D3D12) descriptor heap.
+    // Ex: RTXGI_BINDLESS_TYPE [RTXGI_BINDLESS_TYPE_RESOURCE_ARRAYS(0)|RTXGI_BINDLESS_TYPE_DESCRIPTOR_HEAP(1)]
+    #ifndef RTXGI_BINDLESS_TYPE
+        #error Required define RTXGI_BINDLESS_TYPE is not defined for ProbeCompactionCS.hlsl!
+    #endif
+
+    #if !RTXGI_DDGI_SHADER_REFLECTION && RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_RESOURCE_ARRAYS
+        // Bindless resources are accessed using SM6.5 and below style resource arrays
+
+        // VOLUME_RESOURCES_REGISTER and VOLUME_RESOURCES_SPACE must be passed in as defines at shader compilation time
+        // *not* using reflection and using bindless resource arrays.
+        // These defines specify the shader register and space used for the DDGIVolumeResourceIndices structured buffer.
+        // Ex: VOLUME_RESOURCES_REGISTER t6
+        // Ex: VOLUME_RESOURCES_SPACE space0
+        #ifndef VOLUME_RESOURCES_REGISTER
+            #error Required define VOLUME_RESOURCES_REGISTER is not defined for ProbeCompactionCS.hlsl!
+        #endif
+        #ifndef VOLUME_RESOURCES_SPACE
+            #error Required define VOLUME_RESOURCES_SPACE is not defined for ProbeCompactionCS.hlsl!
+        #endif
+
+        // RWTEX2DARRAY_REGISTER and RWTEX2DARRAY_SPACE must be passed in as defines at shader compilation time
+        // *not* using reflection and using bindless resource arrays.
+        // These defines specify the shader register and space of the RWTexture2DArray resource array that the DDGIVolume's
+        // probe data and probe variability texture arrays are retrieved from bindlessly.
+        // Ex: RWTEX2DARRAY_REGISTER u6
+        // Ex: RWTEX2DARRAY_SPACE space1
+        #ifndef RWTEX2DARRAY_REGISTER
+            #error Required bindless mode define RWTEX2DARRAY_REGISTER is not defined for ProbeCompactionCS.hlsl!
+        #endif
+        #ifndef RWTEX2DARRAY_SPACE
+            #error Required bindless mode define RWTEX2DARRAY_SPACE is not defined for ProbeCompactionCS.hlsl!
+        #endif
+
+        // PROBE_COMPACTION_REGISTER and PROBE_COMPACTION_SPACE must be passed in as defines at shader compilation time
+        // *not* using reflection and using bindless resource arrays.
+        // These defines specify the shader register and space used for the probe compaction RWStructuredBuffer.
+        // Ex: PROBE_COMPACTION_REGISTER u7
+        // Ex: PROBE_COMPACTION_SPACE space0
+        #ifndef PROBE_COMPACTION_REGISTER
+            #error Required define PROBE_COMPACTION_REGISTER is not defined for ProbeCompactionCS.hlsl!
+        #endif
+        #ifndef PROBE_COMPACTION_SPACE
+            #error Required define PROBE_COMPACTION_SPACE is not defined for ProbeCompactionCS.hlsl!
+        #endif
+    #endif
+#endif // RTXGI_DDGI_BINDLESS_RESOURCES
+
+// -------- OPTIONAL DEFINES -----------------------------------------------------------------
+
+// Define RTXGI_DDGI_ADAPTIVE_RAYS before compiling SDK HLSL shaders to read a variable number of rays
+// per probe from the probe ray allocations structured buffer (see DDGIProbeRayAllocator.h).
+// When enabled, probes that only trace the fixed rays are not added to the compacted probe list.
+// 0: Disabled (default).
+// 1: Enabled.
+#ifndef RTXGI_DDGI_ADAPTIVE_RAYS
+    #pragma message "Optional define RTXGI_DDGI_ADAPTIVE_RAYS is not defined, defaulting to 0."
+    #define RTXGI_DDGI_ADAPTIVE_RAYS 0
+#endif
+
+#if RTXGI_DDGI_ADAPTIVE_RAYS
+    // PROBE_RAY_ALLOCATIONS_REGISTER and PROBE_RAY_ALLOCATIONS_SPACE must be passed in as defines at shader compilation time
+    // *not* using reflection and using bindless resource arrays.
+    // These defines specify the shader register and space used for the DDGIProbeRayAllocation structured buffer.
+    // Ex: PROBE_RAY_ALLOCATIONS_REGISTER t8
+    // Ex: PROBE_RAY_ALLOCATIONS_SPACE space0
+    #if !RTXGI_DDGI_SHADER_REFLECTION && RTXGI_BINDLESS_TYPE == RTXGI_BINDLESS_TYPE_RESOURCE_ARRAYS
+        #ifndef PROBE_RAY_ALLOCATIONS_REGISTER
+            #error Required define PROBE_RAY_ALLOCATIONS_REGISTER is not defined for ProbeCompactionCS.hlsl!
+        #endif
+        #ifndef PROBE_RAY_ALLOCATIONS_SPACE
+            #error Required define PROBE_RAY_ALLOCATIONS_SPACE is not defined for ProbeCompactionCS.hlsl!
+        #endif
+    #endif
+#endif
+
+// -------------------------------------------------------------------------------------------
@@ -0,0 +1,230 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "rtxgi/ddgi/DDGIMergedDispatch.h"
+
+namespace rtxgi
+{
+
+    namespace
+    {
+        const uint32_t c_numPasses = (uint32_t)EDDGIMergedDispatchPass::Count;
+
+        /**
+         * Returns true when a volume is processed by a pass.
+         */
+        bool IsVolumeInPass(const DDGIVolumeBase* volume, EDDGIMergedDispatchPass pass)
+        {
+            if (pass == EDDGIMergedDispatchPass::ProbeRelocation) return volume->GetProbeRelocationEnabled();
+            if (pass == EDDGIMergedDispatchPass::ProbeClassification) return volume->GetProbeClassificationEnabled();
+            return true;
+        }
+
+        /**
+         * Returns true when two volumes can share the shaders of a pass.
+         * Probe blending shaders are compiled for a specific number of probe texels (thread group size)
+         * and rays per probe (shared memory size). Relocation and classification shaders are not.
+         */
+        bool AreVolumesCompatible(const DDGIVolumeBase* a, const DDGIVolumeBase* b, EDDGIMergedDispatchPass pass)
+        {
+            if (pass != EDDGIMergedDispatchPass::ProbeBlending) return true;
+
+            const DDGIVolumeDesc& descA = a->GetDesc();
+            const DDGIVolumeDesc& descB = b->GetDesc();
+            if (descA.probeNumIrradianceInteriorTexels != descB.probeNumIrradianceInteriorTexels) return false;
+            if (descA.probeNumDistanceInteriorTexels != descB.probeNumDistanceInteriorTexels) return false;
+            if (descA.probeNumRays != descB.probeNumRays) return false;
+            return true;
+        }
+
+        uint32_t DivRoundUp(uint32_t value, uint32_t divisor)
+        {
+            return (value + divisor - 1) / divisor;
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Public RTXGI Namespace Merged Dispatch Functions
+    //------------------------------------------------------------------------
+
+    uint32_t GetDDGIMergedDispatchProbesPerGroup(EDDGIMergedDispatchPass pass)
+    {
+        // Relocation and classification thread groups are 32 threads (see [numthreads] in ProbeRelocationCS.hlsl and ProbeClassificationCS.hlsl)
+        if (pass == EDDGIMergedDispatchPass::ProbeBlending) return 1;
+        return 32;
+    }
+
+    uint32_t GetDDGIMergedDispatchMaxEntries(uint32_t numVolumes)
+    {
+        // One entry per volume per pass
+        return numVolumes * c_numPasses;
+    }
+
+    DDGIRootConstants GetDDGIMergedDispatchRootConstants(const DDGIMergedDispatchBatch& batch, const DDGIRootConstants& volumeConsts, uint32_t tableDescriptorHeapIndex)
+    {
+        DDGIRootConstants consts = {};
+        consts.volumeIndex = batch.firstEntry;
+        consts.volumeConstantsIndex = volumeConsts.volumeConstantsIndex;
+        consts.volumeResourceIndicesIndex = volumeConsts.volumeResourceIndicesIndex;
+        consts.reductionInputSizeX = batch.numEntries;
+        consts.reductionInputSizeY = batch.numProbes;
+        consts.reductionInputSizeZ = tableDescriptorHeapIndex;
+        return consts;
+    }
+
+    //------------------------------------------------------------------------
+    // DDGIMergedDispatch
+    //------------------------------------------------------------------------
+
+    DDGIMergedDispatch::~DDGIMergedDispatch()
+    {
+        delete[] m_entries;
+        delete[] m_batches;
+        delete[] m_volumeBatch;
+    }
+
+    void DDGIMergedDispatch::Resize(uint32_t numVolumes)
+    {
+        if (numVolumes <= m_maxVolumes) return;
+
+        delete[] m_entries;
+        delete[] m_batches;
+        delete[] m_volumeBatch;
+
+        // A pass has at most one entry and one batch per volume
+        m_maxVolumes = numVolumes;
+        m_entries = new DDGIMergedDispatchEntry[GetDDGIMergedDispatchMaxEntries(numVolumes)]();
+        m_batches = new DDGIMergedDispatchBatch[numVolumes * c_numPasses]();
+        m_volumeBatch = new uint32_t[numVolumes]();
+    }
+
+    ERTXGIStatus DDGIMergedDispatch::Build(uint32_t numVolumes, const DDGIVolumeBase* const* volumes)
+    {
+        Resize(numVolumes);
+
+        m_numEntries = 0;
+        m_entriesHash = 0;
+
+        uint32_t numBatches = 0;
+        for (uint32_t passIndex = 0; passIndex < c_numPasses; passIndex++)
+        {
+            EDDGIMergedDispatchPass pass = (EDDGIMergedDispatchPass)passIndex;
+            uint32_t probesPerGroup = GetDDGIMergedDispatchProbesPerGroup(pass);
+
+            m_firstBatch[passIndex] = numBatches;
+            m_numBatches[passIndex] = 0;
+
+            DDGIMergedDispatchBatch* batches = m_batches + numBatches;
+
+            // Assign the volumes to batches and count the entries of each batch
+            for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                const DDGIVolumeBase* volume = volumes[volumeIndex];
+                if (volume == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+                if (!IsVolumeInPass(volume, pass)) continue;
+
+                uint32_t batchIndex;
+                for (batchIndex = 0; batchIndex < m_numBatches[passIndex]; batchIndex++)
+                {
+                    if (AreVolumesCompatible(volumes[batches[batchIndex].volume], volume, pass)) break;
+                }
+
+                if (batchIndex == m_numBatches[passIndex])
+                {
+                    batches[batchIndex] = {};
+                    batches[batchIndex].volume = volumeIndex;
+                    m_numBatches[passIndex]++;
+                }
+
+                batches[batchIndex].numEntries++;
+                m_volumeBatch[volumeIndex] = batchIndex;
+            }
+
+            // Allocate the table entries of each batch
+            for (uint32_t batchIndex = 0; batchIndex < m_numBatches[passIndex]; batchIndex++)
+            {
+                batches[batchIndex].firstEntry = m_numEntries;
+                m_numEntries += batches[batchIndex].numEntries;
+                batches[batchIndex].numEntries = 0;
+            }
+
+            // Write the table entries, aligning each volume's probes to the pass' thread group size
+            for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                const DDGIVolumeBase* volume = volumes[volumeIndex];
+                if (!IsVolumeInPass(volume, pass)) continue;
+
+                DDGIMergedDispatchBatch& batch = batches[m_volumeBatch[volumeIndex]];
+
+                DDGIMergedDispatchEntry& entry = m_entries[batch.firstEntry + batch.numEntries];
+                entry.volumeIndex = volume->GetIndex();
+                entry.dispatchProbeOffset = batch.numProbes;
+                entry.probeOffset = 0;
+                entry.numProbes = (uint32_t)volume->GetNumProbes();
+
+                batch.numEntries++;
+                batch.numProbes += DivRoundUp(entry.numProbes, probesPerGroup) * probesPerGroup;
+            }
+
+            // Compute the dispatch dimensions of each batch
+            for (uint32_t batchIndex = 0; batchIndex < m_numBatches[passIndex]; batchIndex++)
+            {
+                DDGIMergedDispatchBatch& batch = batches[batchIndex];
+                uint32_t numGroups = batch.numProbes / probesPerGroup;
+                batch.numGroupsX = (numGroups < RTXGI_DDGI_MERGED_DISPATCH_MAX_GROUPS_X) ? numGroups : RTXGI_DDGI_MERGED_DISPATCH_MAX_GROUPS_X;
+                batch.numGroupsY = DivRoundUp(numGroups, RTXGI_DDGI_MERGED_DISPATCH_MAX_GROUPS_X);
+            }
+
+            numBatches += m_numBatches[passIndex];
+        }
+
+        m_entriesHash = GetDDGIVolumeDataHash(m_entries, GetEntriesSizeInBytes());
+
+        return ERTXGIStatus::OK;
+    }
+
+    bool DDGIMergedDispatch::GetProbe(const DDGIMergedDispatchBatch& batch, uint32_t dispatchProbeIndex, uint32_t& volumeIndex, uint32_t& probeIndex) const
+    {
+        if (batch.numEntries == 0 || dispatchProbeIndex >= batch.numProbes) return false;
+
+        // Binary search for the last entry that starts at or before the probe (matches DDGIGetMergedDispatchProbe())
+        uint32_t first = batch.firstEntry;
+        uint32_t count = batch.numEntries;
+        while (count > 1)
+        {
+            uint32_t step = count / 2;
+            if (m_entries[first + step].dispatchProbeOffset <= dispatchProbeIndex)
+            {
+                first += step;
+                count -= step;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+
+        const DDGIMergedDispatchEntry& entry = m_entries[first];
+        uint32_t offset = dispatchProbeIndex - entry.dispatchProbeOffset;
+        if (offset >= entry.numProbes) return false;
+
+        volumeIndex = entry.volumeIndex;
+        probeIndex = entry.probeOffset + offset;
+        return true;
+    }
+
+    uint32_t DDGIMergedDispatch::GetNumDispatches() const
+    {
+        uint32_t numDispatches = 0;
+        for (uint32_t passIndex = 0; passIndex < c_numPasses; passIndex++) numDispatches += m_numBatches[passIndex];
+        return numDispatches;
+    }
+
+} // namespace rtxgi
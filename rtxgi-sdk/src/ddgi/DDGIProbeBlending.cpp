@@ -0,0 +1,1255 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "rtxgi/ddgi/DDGIProbeBlending.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define RTXGI_CPU_SIMD_SSE2 1
+#elif (defined(__ARM_NEON) && defined(__aarch64__)) || defined(_M_ARM64)
+    #include <arm_neon.h>
+    #define RTXGI_CPU_SIMD_NEON 1
+#endif
+
+namespace rtxgi
+{
+    namespace cpu
+    {
+
+        //------------------------------------------------------------------------
+        // Private Constants and Helpers
+        //------------------------------------------------------------------------
+
+        namespace
+        {
+            // Must match the values in shaders/ddgi/include/Common.hlsl
+            const int   c_numFixedRays = 32;                // RTXGI_DDGI_NUM_FIXED_RAYS
+            const float c_probeStateInactive = 1.f;         // RTXGI_DDGI_PROBE_STATE_INACTIVE
+
+            // Must match ProbeBlendingCS.hlsl
+            const float c_threshold = 1.f / 1024.f;
+
+            // Number of probes a thread claims at a time
+            const uint32_t c_probesPerJob = 8;
+
+            const float c_luminanceWeights[3] = { 0.2126f, 0.7152f, 0.0722f };
+
+            float Luminance(float r, float g, float b)
+            {
+                return (r * c_luminanceWeights[0]) + (g * c_luminanceWeights[1]) + (b * c_luminanceWeights[2]);
+            }
+
+            float MaxComponent(float r, float g, float b)
+            {
+                return std::max(r, std::max(g, b));
+            }
+
+            float Sign(float v)
+            {
+                return (v > 0.f) ? 1.f : ((v < 0.f) ? -1.f : 0.f);
+            }
+
+            float SignNotZero(float v)
+            {
+                return (v >= 0.f) ? 1.f : -1.f;
+            }
+
+            float3 NormalizeVector(float3 v)
+            {
+                float invLength = 1.f / std::sqrt((v.x * v.x) + (v.y * v.y) + (v.z * v.z));
+                return { v.x * invLength, v.y * invLength, v.z * invLength };
+            }
+
+            /**
+             * Matches RTXGISphericalFibonacci.
+             */
+            float3 SphericalFibonacci(float sampleIndex, float numSamples)
+            {
+                const float b = (std::sqrt(5.f) * 0.5f + 0.5f) - 1.f;
+                float x = sampleIndex * b;
+                float phi = 6.2831853071795864f * (x - std::floor(x));
+                float cosTheta = 1.f - (2.f * sampleIndex + 1.f) * (1.f / numSamples);
+                float sinTheta = std::sqrt(std::min(std::max(1.f - (cosTheta * cosTheta), 0.f), 1.f));
+                return { (std::cos(phi) * sinTheta), (std::sin(phi) * sinTheta), cosTheta };
+            }
+
+            /**
+             * Matches DDGIGetProbeRayDirection.
+             */
+            float3 GetProbeRayDirection(int rayIndex, int numRays, const DDGIVolumeDescGPU& volume)
+            {
+                bool isFixedRay = false;
+                int sampleIndex = rayIndex;
+
+                if (volume.probeRelocationEnabled || volume.probeClassificationEnabled)
+                {
+                    isFixedRay = (rayIndex < c_numFixedRays);
+                    sampleIndex = isFixedRay ? rayIndex : (rayIndex - c_numFixedRays);
+                    numRays = isFixedRay ? c_numFixedRays : (numRays - c_numFixedRays);
+                }
+
+                float3 direction = SphericalFibonacci((float)sampleIndex, (float)numRays);
+                if (isFixedRay) return NormalizeVector(direction);
+
+                float4 conjugate = { -volume.probeRayRotation.x, -volume.probeRayRotation.y, -volume.probeRayRotation.z, volume.probeRayRotation.w };
+                return NormalizeVector(QuaternionRotate(direction, conjugate));
+            }
+
+            /**
+             * Matches DDGIGetOctahedralDirection(DDGIGetNormalizedOctahedralCoordinates(...)).
+             */
+            float3 GetOctahedralDirection(int x, int y, int numTexels)
+            {
+                float u = (((float)x + 0.5f) / (float)numTexels) * 2.f - 1.f;
+                float v = (((float)y + 0.5f) / (float)numTexels) * 2.f - 1.f;
+
+                float3 direction = { u, v, 1.f - std::abs(u) - std::abs(v) };
+                if (direction.z < 0.f)
+                {
+                    direction.x = (1.f - std::abs(v)) * SignNotZero(u);
+                    direction.y = (1.f - std::abs(u)) * SignNotZero(v);
+                }
+                return NormalizeVector(direction);
+            }
+
+            /**
+             * Unpack a R10G10B10 packed radiance value (matches RTXGIUintToFloat3).
+             */
+            float3 UintToFloat3(uint32_t input)
+            {
+                float3 output;
+                output.x = (float)(input & 0x000003FF) / 1023.f;
+                output.y = (float)((input >> 10) & 0x000003FF) / 1023.f;
+                output.z = (float)((input >> 20) & 0x000003FF) / 1023.f;
+                return output;
+            }
+
+            /**
+             * Round a float to the nearest half precision value (round to nearest even), returned as a float.
+             */
+            float QuantizeToHalf(float value)
+            {
+                uint32_t bits;
+                memcpy(&bits, &value, sizeof(float));
+
+                uint32_t sign = bits & 0x80000000u;
+                uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+                if (magnitude >= 0x7F800000u) return value;     // Inf and NaN
+                if (magnitude <= 0x33000000u) magnitude = 0;    // Rounds to zero (<= 2^-25)
+                else if (magnitude < 0x33800000u) magnitude = 0x33800000u; // Rounds to the smallest denormal (2^-24)
+                else
+                {
+                    // Number of float mantissa bits that don't fit in a half (more for half denormals)
+                    int exponent = (int)(magnitude >> 23) - 127;
+                    uint32_t shift = (exponent < -14) ? (uint32_t)(13 + (-14 - exponent)) : 13u;
+
+                    uint32_t halfway = 1u << (shift - 1);
+                    uint32_t remainder = magnitude & ((1u << shift) - 1);
+                    magnitude -= remainder;
+                    if (remainder > halfway || (remainder == halfway && (magnitude & (1u << shift)))) magnitude += (1u << shift);
+
+                    if (magnitude >= 0x47800000u) magnitude = 0x7F800000u; // Overflows to Inf
+                }
+
+                bits = sign | magnitude;
+                memcpy(&value, &bits, sizeof(float));
+                return value;
+            }
+
+            /**
+             * Round a float to the nearest value of an n-bit unsigned normalized format.
+             */
+            float QuantizeToUnorm(float value, float maxValue)
+            {
+                if (!(value > 0.f)) return 0.f;     // Also handles NaN
+                if (value >= 1.f) return 1.f;
+                return std::floor(value * maxValue + 0.5f) / maxValue;
+            }
+
+            void QuantizeTexel(EDDGIVolumeTextureFormat format, float* texel, int numChannels)
+            {
+                if (format == EDDGIVolumeTextureFormat::U32)
+                {
+                    for (int channel = 0; channel < std::min(numChannels, 3); channel++) texel[channel] = QuantizeToUnorm(texel[channel], 1023.f);
+                    if (numChannels == 4) texel[3] = QuantizeToUnorm(texel[3], 3.f);
+                }
+                else if (format == EDDGIVolumeTextureFormat::F16 || format == EDDGIVolumeTextureFormat::F16x2 || format == EDDGIVolumeTextureFormat::F16x4)
+                {
+                    for (int channel = 0; channel < numChannels; channel++) texel[channel] = QuantizeToHalf(texel[channel]);
+                }
+            }
+
+            void GetProbeCountsPerPlane(const DDGIVolumeDescGPU& volume, int& countX, int& countY, int& numPlanes)
+            {
+            #if RTXGI_COORDINATE_SYSTEM == RTXGI_COORDINATE_SYSTEM_LEFT || RTXGI_COORDINATE_SYSTEM == RTXGI_COORDINATE_SYSTEM_RIGHT
+                countX = volume.probeCounts.x;
+                countY = volume.probeCounts.z;
+                numPlanes = volume.probeCounts.y;
+            #elif RTXGI_COORDINATE_SYSTEM == RTXGI_COORDINATE_SYSTEM_LEFT_Z_UP
+                countX = volume.probeCounts.y;
+                countY = volume.probeCounts.x;
+                numPlanes = volume.probeCounts.z;
+            #elif RTXGI_COORDINATE_SYSTEM == RTXGI_COORDINATE_SYSTEM_RIGHT_Z_UP
+                countX = volume.probeCounts.x;
+                countY = volume.probeCounts.y;
+                numPlanes = volume.probeCounts.z;
+            #endif
+            }
+
+            /**
+             * Matches DDGIGetProbeCoords.
+             */
+            int3 GetProbeCoords(int probeIndex, const DDGIVolumeDescGPU& volume)
+            {
+                int3 probeCoords;
+            #if RTXGI_COORDINATE_SYSTEM == RTXGI_COORDINATE_SYSTEM_LEFT || RTXGI_COORDINATE_SYSTEM == RTXGI_COORDINATE_SYSTEM_RIGHT
+                probeCoords.x = probeIndex % volume.probeCounts.x;
+                probeCoords.y = probeIndex / (volume.probeCounts.x * volume.probeCounts.z);
+                probeCoords.z = (probeIndex / volume.probeCounts.x) % volume.probeCounts.z;
+            #elif RTXGI_COORDINATE_SYSTEM == RTXGI_COORDINATE_SYSTEM_LEFT_Z_UP
+                probeCoords.x = (probeIndex / volume.probeCounts.y) % volume.probeCounts.x;
+                probeCoords.y = probeIndex % volume.probeCounts.y;
+                probeCoords.z = probeIndex / (volume.probeCounts.x * volume.probeCounts.y);
+            #elif RTXGI_COORDINATE_SYSTEM == RTXGI_COORDINATE_SYSTEM_RIGHT_Z_UP
+                probeCoords.x = probeIndex % volume.probeCounts.x;
+                probeCoords.y = (probeIndex / volume.probeCounts.x) % volume.probeCounts.y;
+                probeCoords.z = probeIndex / (volume.probeCounts.y * volume.probeCounts.x);
+            #endif
+                return probeCoords;
+            }
+
+            /**
+             * Matches DDGIClearScrolledPlane.
+             */
+            bool ClearScrolledPlane(const int3& probeCoords, size_t planeIndex, const DDGIVolumeDescGPU& volume)
+            {
+                if (volume.probeScrollClear[planeIndex])
+                {
+                    int offset = volume.probeScrollOffsets[planeIndex];
+                    int probeCount = volume.probeCounts[planeIndex];
+                    bool direction = volume.probeScrollDirections[planeIndex];
+
+                    int coord = 0;
+                    if (direction) coord = (probeCount + (offset - 1)) % probeCount; // scrolling in positive direction
+                    else coord = (probeCount + (offset % probeCount)) % probeCount;  // scrolling in negative direction
+
+                    if (probeCoords[planeIndex] == coord) return true;
+                }
+                return false;
+            }
+
+            /**
+             * Matches DDGIIsProbeReset.
+             */
+            bool IsProbeReset(int3 probeCoords, const DDGIVolumeDescGPU& volume)
+            {
+                if (!volume.probeResetEnabled) return false;
+
+                for (size_t axis = 0; axis < 3; axis++)
+                {
+                    int coord = probeCoords[axis];
+                    if (volume.movementType == (uint32_t)EDDGIVolumeMovementType::Scrolling)
+                    {
+                        int probeCount = volume.probeCounts[axis];
+                        coord = (((coord - volume.probeScrollOffsets[axis]) % probeCount) + probeCount) % probeCount;
+                    }
+                    if (coord < volume.probeResetMin[axis] || coord > volume.probeResetMax[axis]) return false;
+                }
+                return true;
+            }
+
+            // Polynomial coefficients used by the fast pow() approximation.
+            // log2(m) = (2 / ln(2)) * (t + t^3/3 + t^5/5 + t^7/7 + t^9/9), with t = (m - 1) / (m + 1)
+            // exp2(f) = sum(ln(2)^k / k! * f^k), k = [0, 7], with f in [-0.5, 0.5]
+            const float c_log2Coefficients[5] = { 2.885390082f, 0.9617966939f, 0.5770780164f, 0.4121985831f, 0.3205988980f };
+            const float c_exp2Coefficients[8] = { 1.f, 0.6931471806f, 0.2402265070f, 0.05550410866f, 0.009618129108f, 0.001333355815f, 0.0001540353039f, 0.00001525273380f };
+            const float c_sqrt2 = 1.414213562f;
+
+            /**
+             * Approximates log2(x) for positive, normal x.
+             */
+            float FastLog2(float x)
+            {
+                uint32_t bits;
+                memcpy(&bits, &x, sizeof(float));
+
+                // Split into exponent and mantissa, then move the mantissa to [sqrt(2)/2, sqrt(2)]
+                float exponent = (float)((int)(bits >> 23) - 127);
+                uint32_t mantissaBits = (bits & 0x007FFFFFu) | 0x3F800000u;
+                float mantissa;
+                memcpy(&mantissa, &mantissaBits, sizeof(float));
+                if (mantissa > c_sqrt2)
+                {
+                    mantissa = mantissa * 0.5f;
+                    exponent = exponent + 1.f;
+                }
+
+                float t = (mantissa - 1.f) / (mantissa + 1.f);
+                float t2 = t * t;
+                float p = c_log2Coefficients[4];
+                p = (p * t2) + c_log2Coefficients[3];
+                p = (p * t2) + c_log2Coefficients[2];
+                p = (p * t2) + c_log2Coefficients[1];
+                p = (p * t2) + c_log2Coefficients[0];
+                return exponent + (t * p);
+            }
+
+            /**
+             * Approximates exp2(y). Results smaller than 2^-126 flush to zero.
+             */
+            float FastExp2(float y)
+            {
+                if (y < -126.f) return 0.f;
+                y = std::min(y, 127.f);
+
+                int n = (int)std::nearbyint(y);
+                float f = y - (float)n;
+                float p = c_exp2Coefficients[7];
+                for (int k = 6; k >= 0; k--) p = (p * f) + c_exp2Coefficients[k];
+
+                uint32_t scaleBits = (uint32_t)(n + 127) << 23;
+                float scale;
+                memcpy(&scale, &scaleBits, sizeof(float));
+                return p * scale;
+            }
+
+            /**
+             * Approximates pow(x, e) for x >= 0 and e > 0.
+             * The GPU evaluates pow() as exp2(e * log2(x)) with approximate transcendentals too.
+             */
+            float FastPow(float x, float e)
+            {
+                return (x > 0.f) ? FastExp2(e * FastLog2(x)) : 0.f;
+            }
+
+            /**
+             * Computes pow(x, n) for positive integer n by repeated squaring.
+             */
+            float PowInt(float x, uint32_t n)
+            {
+                float result = 1.f;
+                float base = x;
+                for (;;)
+                {
+                    if (n & 1) result *= base;
+                    n >>= 1;
+                    if (n == 0) break;
+                    base *= base;
+                }
+                return result;
+            }
+
+            /**
+             * Describes how distance blending weights are raised to the volume's distance exponent.
+             * Integer exponents (the common case) use repeated squaring, other positive exponents use FastPow().
+             */
+            struct DistanceExponent
+            {
+                float    exponent = 0.f;
+                uint32_t integerExponent = 0;   // 0 when the exponent isn't a positive integer
+                float    minWeight = 0.f;       // weights below this flush to zero (the result would be denormal)
+            };
+
+            DistanceExponent GetDistanceExponent(float exponent)
+            {
+                DistanceExponent result;
+                result.exponent = exponent;
+                if (exponent > 0.f && exponent <= 4096.f && exponent == std::floor(exponent))
+                {
+                    result.integerExponent = (uint32_t)exponent;
+                    result.minWeight = std::pow(2.f, -125.f / exponent);
+                }
+                return result;
+            }
+
+            float ApplyDistanceExponent(float weight, const DistanceExponent& exponent)
+            {
+                if (exponent.integerExponent > 0) return (weight >= exponent.minWeight) ? PowInt(weight, exponent.integerExponent) : 0.f;
+                if (exponent.exponent > 0.f) return FastPow(weight, exponent.exponent);
+                return std::pow(weight, exponent.exponent);
+            }
+
+            //------------------------------------------------------------------------
+            // SIMD Wrappers
+            //------------------------------------------------------------------------
+
+        #if RTXGI_CPU_SIMD_SSE2
+            #define RTXGI_CPU_SIMD 1
+            typedef __m128 simd4;
+            inline simd4 SimdLoad(const float* p) { return _mm_loadu_ps(p); }
+            inline void  SimdStore(float* p, simd4 v) { _mm_storeu_ps(p, v); }
+            inline simd4 SimdSet(float v) { return _mm_set1_ps(v); }
+            inline simd4 SimdZero() { return _mm_setzero_ps(); }
+            inline simd4 SimdAdd(simd4 a, simd4 b) { return _mm_add_ps(a, b); }
+            inline simd4 SimdMul(simd4 a, simd4 b) { return _mm_mul_ps(a, b); }
+            inline simd4 SimdMax(simd4 a, simd4 b) { return _mm_max_ps(a, b); }
+            inline bool  SimdAnyPositive(simd4 v) { return _mm_movemask_ps(_mm_cmpgt_ps(v, _mm_setzero_ps())) != 0; }
+            inline simd4 SimdZeroBelow(simd4 v, simd4 threshold) { return _mm_and_ps(_mm_cmpge_ps(v, threshold), v); }
+
+            /**
+             * SIMD version of FastPow(), produces identical results.
+             */
+            inline simd4 SimdFastPow(simd4 x, float e)
+            {
+                const simd4 one = _mm_set1_ps(1.f);
+                __m128i bits = _mm_castps_si128(x);
+
+                // FastLog2()
+                simd4 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+                simd4 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)));
+                simd4 mask = _mm_cmpgt_ps(mantissa, _mm_set1_ps(c_sqrt2));
+                mantissa = _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(mantissa, _mm_set1_ps(0.5f))), _mm_andnot_ps(mask, mantissa));
+                exponent = _mm_or_ps(_mm_and_ps(mask, _mm_add_ps(exponent, one)), _mm_andnot_ps(mask, exponent));
+
+                simd4 t = _mm_div_ps(_mm_sub_ps(mantissa, one), _mm_add_ps(mantissa, one));
+                simd4 t2 = _mm_mul_ps(t, t);
+                simd4 p = _mm_set1_ps(c_log2Coefficients[4]);
+                for (int k = 3; k >= 0; k--) p = _mm_add_ps(_mm_mul_ps(p, t2), _mm_set1_ps(c_log2Coefficients[k]));
+                simd4 y = _mm_mul_ps(_mm_set1_ps(e), _mm_add_ps(exponent, _mm_mul_ps(t, p)));
+
+                // FastExp2()
+                simd4 flush = _mm_or_ps(_mm_cmplt_ps(y, _mm_set1_ps(-126.f)), _mm_cmple_ps(x, _mm_setzero_ps()));
+                y = _mm_min_ps(_mm_max_ps(y, _mm_set1_ps(-126.f)), _mm_set1_ps(127.f));
+
+                __m128i n = _mm_cvtps_epi32(y);
+                simd4 f = _mm_sub_ps(y, _mm_cvtepi32_ps(n));
+                p = _mm_set1_ps(c_exp2Coefficients[7]);
+                for (int k = 6; k >= 0; k--) p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(c_exp2Coefficients[k]));
+
+                simd4 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+                return _mm_andnot_ps(flush, _mm_mul_ps(p, scale));
+            }
+        #elif RTXGI_CPU_SIMD_NEON
+            #define RTXGI_CPU_SIMD 1
+            typedef float32x4_t simd4;
+            inline simd4 SimdLoad(const float* p) { return vld1q_f32(p); }
+            inline void  SimdStore(float* p, simd4 v) { vst1q_f32(p, v); }
+            inline simd4 SimdSet(float v) { return vdupq_n_f32(v); }
+            inline simd4 SimdZero() { return vdupq_n_f32(0.f); }
+            inline simd4 SimdAdd(simd4 a, simd4 b) { return vaddq_f32(a, b); }
+            inline simd4 SimdMul(simd4 a, simd4 b) { return vmulq_f32(a, b); }
+            inline simd4 SimdMax(simd4 a, simd4 b) { return vmaxq_f32(a, b); }
+            inline bool  SimdAnyPositive(simd4 v) { return vmaxvq_f32(v) > 0.f; }
+            inline simd4 SimdZeroBelow(simd4 v, simd4 threshold) { return vreinterpretq_f32_u32(vandq_u32(vcgeq_f32(v, threshold), vreinterpretq_u32_f32(v))); }
+
+            /**
+             * SIMD version of FastPow(), produces identical results.
+             */
+            inline simd4 SimdFastPow(simd4 x, float e)
+            {
+                const simd4 one = vdupq_n_f32(1.f);
+                uint32x4_t bits = vreinterpretq_u32_f32(x);
+
+                // FastLog2()
+                simd4 exponent = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)), vdupq_n_s32(127)));
+                simd4 mantissa = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007FFFFF)), vdupq_n_u32(0x3F800000)));
+                uint32x4_t mask = vcgtq_f32(mantissa, vdupq_n_f32(c_sqrt2));
+                mantissa = vbslq_f32(mask, vmulq_f32(mantissa, vdupq_n_f32(0.5f)), mantissa);
+                exponent = vbslq_f32(mask, vaddq_f32(exponent, one), exponent);
+
+                simd4 t = vdivq_f32(vsubq_f32(mantissa, one), vaddq_f32(mantissa, one));
+                simd4 t2 = vmulq_f32(t, t);
+                simd4 p = vdupq_n_f32(c_log2Coefficients[4]);
+                for (int k = 3; k >= 0; k--) p = vaddq_f32(vmulq_f32(p, t2), vdupq_n_f32(c_log2Coefficients[k]));
+                simd4 y = vmulq_f32(vdupq_n_f32(e), vaddq_f32(exponent, vmulq_f32(t, p)));
+
+                // FastExp2()
+                uint32x4_t flush = vorrq_u32(vcltq_f32(y, vdupq_n_f32(-126.f)), vcleq_f32(x, vdupq_n_f32(0.f)));
+                y = vminq_f32(vmaxq_f32(y, vdupq_n_f32(-126.f)), vdupq_n_f32(127.f));
+
+                int32x4_t n = vcvtnq_s32_f32(y);
+                simd4 f = vsubq_f32(y, vcvtq_f32_s32(n));
+                p = vdupq_n_f32(c_exp2Coefficients[7]);
+                for (int k = 6; k >= 0; k--) p = vaddq_f32(vmulq_f32(p, f), vdupq_n_f32(c_exp2Coefficients[k]));
+
+                simd4 scale = vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(n, vdupq_n_s32(127)), 23));
+                return vreinterpretq_f32_u32(vbicq_u32(vreinterpretq_u32_f32(vmulq_f32(p, scale)), flush));
+            }
+        #else
+            #define RTXGI_CPU_SIMD 0
+        #endif
+
+        #if RTXGI_CPU_SIMD
+            /**
+             * SIMD version of PowInt(), produces identical results.
+             */
+            inline simd4 SimdPowInt(simd4 x, uint32_t n)
+            {
+                simd4 result = SimdSet(1.f);
+                simd4 base = x;
+                for (;;)
+                {
+                    if (n & 1) result = SimdMul(result, base);
+                    n >>= 1;
+                    if (n == 0) break;
+                    base = SimdMul(base, base);
+                }
+                return result;
+            }
+        #endif
+
+            //------------------------------------------------------------------------
+            // Blending Context
+            //------------------------------------------------------------------------
+
+            /**
+             * Per-pass data shared (read-only) by all blending threads.
+             * Directions are stored as structures of arrays, padded to a multiple of 4 texels.
+             */
+            struct BlendPass
+            {
+                bool  enabled = false;
+                bool  radiance = false;
+                int   numInteriorTexels = 0;
+                int   numTexels = 0;
+                int   numTexelsPadded = 0;
+                int   width = 0;
+                int   height = 0;
+                std::vector<float> texelDirectionX;
+                std::vector<float> texelDirectionY;
+                std::vector<float> texelDirectionZ;
+            };
+
+            struct BlendContext
+            {
+                const DDGIVolumeDescGPU* volume = nullptr;
+                const ProbeBlendingDesc* desc = nullptr;
+                const ProbeBlendingTextures* textures = nullptr;
+
+                int  numProbes = 0;
+                int  probesPerPlane = 0;
+                int  probeCountX = 0;
+                int  firstRay = 0;
+                bool scrolling = false;
+                bool useSIMD = false;
+                float epsilon = 0.f;
+                float probeMaxRayDistance = 0.f;
+                DistanceExponent distanceExponent;
+
+                std::vector<float> rayDirectionX;
+                std::vector<float> rayDirectionY;
+                std::vector<float> rayDirectionZ;
+
+                BlendPass irradiance;
+                BlendPass distance;
+            };
+
+            /**
+             * Per-thread scratch memory.
+             */
+            struct BlendScratch
+            {
+                std::vector<float> rayX, rayY, rayZ;        // ray directions of the rays that are blended
+                std::vector<float> directionX, directionY, directionZ;  // probe ray directions of adaptive ray counts
+                int directionsNumRays = 0;                  // number of rays the probe ray directions were computed for
+                std::vector<float> rayR, rayG, rayB;        // ray radiance (or filtered distance terms)
+                std::vector<float> texelR, texelG, texelB, texelA;
+                std::vector<float> weights;
+            };
+
+            void InitBlendPass(BlendPass& pass, int numInteriorTexels, int probeCountX, int probeCountY, bool radiance)
+            {
+                pass.enabled = true;
+                pass.radiance = radiance;
+                pass.numInteriorTexels = numInteriorTexels;
+                pass.numTexels = numInteriorTexels + 2;
+                pass.width = probeCountX * pass.numTexels;
+                pass.height = probeCountY * pass.numTexels;
+
+                int numInterior = numInteriorTexels * numInteriorTexels;
+                pass.numTexelsPadded = (numInterior + 3) & ~3;
+                pass.texelDirectionX.assign((size_t)pass.numTexelsPadded, 0.f);
+                pass.texelDirectionY.assign((size_t)pass.numTexelsPadded, 0.f);
+                pass.texelDirectionZ.assign((size_t)pass.numTexelsPadded, 0.f);
+
+                for (int y = 0; y < numInteriorTexels; y++)
+                {
+                    for (int x = 0; x < numInteriorTexels; x++)
+                    {
+                        float3 direction = GetOctahedralDirection(x, y, numInteriorTexels);
+                        size_t index = (size_t)(y * numInteriorTexels + x);
+                        pass.texelDirectionX[index] = direction.x;
+                        pass.texelDirectionY[index] = direction.y;
+                        pass.texelDirectionZ[index] = direction.z;
+                    }
+                }
+            }
+
+            //------------------------------------------------------------------------
+            // Texel Kernels
+            //------------------------------------------------------------------------
+
+            /**
+             * Accumulates cosine weighted ray values into each interior texel of a probe.
+             * For distance blending, the weights are raised to the volume's distance exponent.
+             * Rays are visited in increasing index order for every texel, matching the shader's summation order.
+             */
+            void AccumulateScalar(const BlendPass& pass, BlendScratch& scratch, int numRays, const DistanceExponent& exponent)
+            {
+                int numInterior = pass.numInteriorTexels * pass.numInteriorTexels;
+                for (int texelIndex = 0; texelIndex < numInterior; texelIndex++)
+                {
+                    float tx = pass.texelDirectionX[(size_t)texelIndex];
+                    float ty = pass.texelDirectionY[(size_t)texelIndex];
+                    float tz = pass.texelDirectionZ[(size_t)texelIndex];
+
+                    float r = 0.f, g = 0.f, b = 0.f, a = 0.f;
+                    for (int rayIndex = 0; rayIndex < numRays; rayIndex++)
+                    {
+                        size_t ray = (size_t)rayIndex;
+                        float weight = std::max(0.f, (tx * scratch.rayX[ray]) + (ty * scratch.rayY[ray]) + (tz * scratch.rayZ[ray]));
+                        if (!pass.radiance) weight = ApplyDistanceExponent(weight, exponent);
+
+                        r += scratch.rayR[ray] * weight;
+                        g += scratch.rayG[ray] * weight;
+                        b += scratch.rayB[ray] * weight;
+                        a += weight;
+                    }
+
+                    scratch.texelR[(size_t)texelIndex] = r;
+                    scratch.texelG[(size_t)texelIndex] = g;
+                    scratch.texelB[(size_t)texelIndex] = b;
+                    scratch.texelA[(size_t)texelIndex] = a;
+                }
+            }
+
+        #if RTXGI_CPU_SIMD
+            /**
+             * SIMD version of AccumulateScalar(). Blends 4 texels at a time and produces
+             * the same results, provided the compiler doesn't contract the scalar multiply-adds.
+             */
+            void AccumulateSIMD(const BlendPass& pass, BlendScratch& scratch, int numRays, const DistanceExponent& exponent)
+            {
+                const simd4 zero = SimdZero();
+                const simd4 minWeight = SimdSet(exponent.minWeight);
+                float weights[4];
+
+                for (int texelIndex = 0; texelIndex < pass.numTexelsPadded; texelIndex += 4)
+                {
+                    simd4 tx = SimdLoad(&pass.texelDirectionX[(size_t)texelIndex]);
+                    simd4 ty = SimdLoad(&pass.texelDirectionY[(size_t)texelIndex]);
+                    simd4 tz = SimdLoad(&pass.texelDirectionZ[(size_t)texelIndex]);
+
+                    simd4 r = zero, g = zero, b = zero, a = zero;
+                    for (int rayIndex = 0; rayIndex < numRays; rayIndex++)
+                    {
+                        size_t ray = (size_t)rayIndex;
+                        simd4 dot = SimdAdd(SimdAdd(SimdMul(tx, SimdSet(scratch.rayX[ray])), SimdMul(ty, SimdSet(scratch.rayY[ray]))), SimdMul(tz, SimdSet(scratch.rayZ[ray])));
+                        simd4 weight = SimdMax(dot, zero);
+
+                        if (!pass.radiance)
+                        {
+                            if (exponent.integerExponent > 0)
+                            {
+                                // Rays facing away from all 4 texels contribute nothing
+                                weight = SimdZeroBelow(weight, minWeight);
+                                if (!SimdAnyPositive(weight)) continue;
+                                weight = SimdPowInt(weight, exponent.integerExponent);
+                            }
+                            else if (exponent.exponent > 0.f)
+                            {
+                                if (!SimdAnyPositive(weight)) continue;
+                                weight = SimdFastPow(weight, exponent.exponent);
+                            }
+                            else
+                            {
+                                SimdStore(weights, weight);
+                                for (int lane = 0; lane < 4; lane++) weights[lane] = std::pow(weights[lane], exponent.exponent);
+                                weight = SimdLoad(weights);
+                            }
+                        }
+
+                        r = SimdAdd(r, SimdMul(SimdSet(scratch.rayR[ray]), weight));
+                        g = SimdAdd(g, SimdMul(SimdSet(scratch.rayG[ray]), weight));
+                        b = SimdAdd(b, SimdMul(SimdSet(scratch.rayB[ray]), weight));
+                        a = SimdAdd(a, weight);
+                    }
+
+                    SimdStore(&scratch.texelR[(size_t)texelIndex], r);
+                    SimdStore(&scratch.texelG[(size_t)texelIndex], g);
+                    SimdStore(&scratch.texelB[(size_t)texelIndex], b);
+                    SimdStore(&scratch.texelA[(size_t)texelIndex], a);
+                }
+            }
+        #endif
+
+            //------------------------------------------------------------------------
+            // Probe Blending
+            //------------------------------------------------------------------------
+
+            /**
+             * Copies interior texels to the probe's 1-texel border (matches UpdateBorderTexel).
+             */
+            template<typename T>
+            void UpdateBorderTexels(T* output, const BlendPass& pass, int probeX, int probeY, int plane)
+            {
+                const int n = pass.numTexels;
+                T* slice = output + (size_t)plane * (size_t)pass.width * (size_t)pass.height;
+                const int baseX = probeX * n;
+                const int baseY = probeY * n;
+
+                for (int y = 0; y < n; y++)
+                {
+                    for (int x = 0; x < n; x++)
+                    {
+                        bool isBorderTexel = (x == 0 || x == n - 1 || y == 0 || y == n - 1);
+                        if (!isBorderTexel) continue;
+
+                        bool isCornerTexel = (x == 0 || x == n - 1) && (y == 0 || y == n - 1);
+                        bool isRowTexel = (x > 0 && x < n - 1);
+
+                        int copyX = x;
+                        int copyY = y;
+                        if (isCornerTexel)
+                        {
+                            copyX = (x > 0) ? 1 : pass.numInteriorTexels;
+                            copyY = (y > 0) ? 1 : pass.numInteriorTexels;
+                        }
+                        else if (isRowTexel)
+                        {
+                            copyX = (n - 1) - x;
+                            copyY += (y > 0) ? -1 : 1;
+                        }
+                        else
+                        {
+                            copyX += (x > 0) ? -1 : 1;
+                            copyY = (n - 1) - y;
+                        }
+
+                        slice[(size_t)(baseY + y) * (size_t)pass.width + (size_t)(baseX + x)] = slice[(size_t)(baseY + copyY) * (size_t)pass.width + (size_t)(baseX + copyX)];
+                    }
+                }
+            }
+
+            float* GetTexel(float4* texels, const BlendPass& pass, int x, int y, int plane)
+            {
+                return &texels[((size_t)plane * (size_t)pass.height + (size_t)y) * (size_t)pass.width + (size_t)x].x;
+            }
+
+            float* GetTexel(float2* texels, const BlendPass& pass, int x, int y, int plane)
+            {
+                return &texels[((size_t)plane * (size_t)pass.height + (size_t)y) * (size_t)pass.width + (size_t)x].x;
+            }
+
+            void LoadRay(const BlendContext& context, size_t rayOffset, int rayIndex, float3& radiance, float& distance)
+            {
+                const DDGIVolumeDescGPU& volume = *context.volume;
+                size_t index = rayOffset + (size_t)rayIndex;
+                if (volume.probeRayDataFormat == (uint32_t)EDDGIVolumeTextureFormat::F32x4)
+                {
+                    const float4& texel = static_cast<const float4*>(context.textures->rayData)[index];
+                    radiance = { texel.x, texel.y, texel.z };
+                    distance = texel.w;
+                }
+                else
+                {
+                    const float2& texel = static_cast<const float2*>(context.textures->rayData)[index];
+                    uint32_t packed;
+                    memcpy(&packed, &texel.x, sizeof(uint32_t));
+                    radiance = UintToFloat3(packed);
+                    distance = texel.y;
+                }
+            }
+
+            /**
+             * Blends the probe's rays into one texture array (irradiance or distance). Returns false if the
+             * shader would exit before writing the probe's interior texels.
+             */
+            bool BlendProbeInterior(const BlendContext& context, const BlendPass& pass, BlendScratch& scratch, int probeIndex, int probeX, int probeY, int plane)
+            {
+                const DDGIVolumeDescGPU& volume = *context.volume;
+                const ProbeBlendingDesc& desc = *context.desc;
+
+                // Get the number of rays traced for the probe and the location of its rays in the ray data
+                int probeNumRays = volume.probeNumRays;
+                size_t rayOffset = (size_t)probeIndex * (size_t)volume.probeNumRays;
+                if (volume.probeAdaptiveRaysEnabled)
+                {
+                    const DDGIProbeRayAllocation& allocation = context.textures->probeRayAllocations[probeIndex];
+                    probeNumRays = (int)allocation.numRays;
+                    rayOffset = (size_t)allocation.rayOffset;
+                }
+
+                // Early out: the probe only traced fixed rays, don't blend anything into the probe
+                if (context.firstRay >= probeNumRays) return false;
+
+                // Get the probe ray directions, these are the same for all probes that trace the same number of rays
+                const float* rayDirectionX = context.rayDirectionX.data();
+                const float* rayDirectionY = context.rayDirectionY.data();
+                const float* rayDirectionZ = context.rayDirectionZ.data();
+                if (probeNumRays != volume.probeNumRays)
+                {
+                    if (scratch.directionsNumRays != probeNumRays)
+                    {
+                        for (int rayIndex = 0; rayIndex < probeNumRays; rayIndex++)
+                        {
+                            float3 direction = GetProbeRayDirection(rayIndex, probeNumRays, volume);
+                            scratch.directionX[(size_t)rayIndex] = direction.x;
+                            scratch.directionY[(size_t)rayIndex] = direction.y;
+                            scratch.directionZ[(size_t)rayIndex] = direction.z;
+                        }
+                        scratch.directionsNumRays = probeNumRays;
+                    }
+                    rayDirectionX = scratch.directionX.data();
+                    rayDirectionY = scratch.directionY.data();
+                    rayDirectionZ = scratch.directionZ.data();
+                }
+
+                // Gather the rays to blend
+                int numRays = 0;
+                if (pass.radiance)
+                {
+                    // Backface hits are ignored when blending radiance
+                    // If more than the backface threshold of the rays hit backfaces, the probe is probably inside geometry
+                    // In this case, don't blend anything into the probe
+                    uint32_t backfaces = 0;
+                    uint32_t maxBackfaces = (uint32_t)((float)(probeNumRays - context.firstRay) * volume.probeRandomRayBackfaceThreshold);
+                    for (int rayIndex = context.firstRay; rayIndex < probeNumRays; rayIndex++)
+                    {
+                        float3 radiance;
+                        float distance;
+                        LoadRay(context, rayOffset, rayIndex, radiance, distance);
+                        if (distance < 0.f)
+                        {
+                            backfaces++;
+                            if (backfaces >= maxBackfaces) return false;
+                            continue;
+                        }
+
+                        size_t ray = (size_t)numRays++;
+                        scratch.rayX[ray] = rayDirectionX[rayIndex];
+                        scratch.rayY[ray] = rayDirectionY[rayIndex];
+                        scratch.rayZ[ray] = rayDirectionZ[rayIndex];
+                        scratch.rayR[ray] = radiance.x;
+                        scratch.rayG[ray] = radiance.y;
+                        scratch.rayB[ray] = radiance.z;
+                    }
+                }
+                else
+                {
+                    for (int rayIndex = context.firstRay; rayIndex < probeNumRays; rayIndex++)
+                    {
+                        float3 radiance;
+                        float distance;
+                        LoadRay(context, rayOffset, rayIndex, radiance, distance);
+
+                        // Hit distance is negative on backface hits (for probe relocation), so take the absolute value
+                        distance = std::min(std::abs(distance), context.probeMaxRayDistance);
+
+                        size_t ray = (size_t)numRays++;
+                        scratch.rayX[ray] = rayDirectionX[rayIndex];
+                        scratch.rayY[ray] = rayDirectionY[rayIndex];
+                        scratch.rayZ[ray] = rayDirectionZ[rayIndex];
+                        scratch.rayR[ray] = distance;
+                        scratch.rayG[ray] = distance * distance;
+                        scratch.rayB[ray] = 0.f;
+                    }
+                }
+
+                // Blend the rays into each texel
+                const DistanceExponent& exponent = context.distanceExponent;
+            #if RTXGI_CPU_SIMD
+                if (context.useSIMD) AccumulateSIMD(pass, scratch, numRays, exponent);
+                else AccumulateScalar(pass, scratch, numRays, exponent);
+            #else
+                AccumulateScalar(pass, scratch, numRays, exponent);
+            #endif
+
+                // If relocation or classification are enabled, fixed rays aren't blended since they will bias the result
+                float epsilon = context.epsilon;
+                if (probeNumRays != volume.probeNumRays)
+                {
+                    epsilon = (float)probeNumRays;
+                    if (context.firstRay > 0) epsilon -= (float)c_numFixedRays;
+                    epsilon *= 1e-9f;
+                }
+
+                // Lower the hysteresis of probes reset by scene changes
+                bool probeReset = IsProbeReset(GetProbeCoords(probeIndex, volume), volume);
+
+                // Normalize, apply hysteresis, and write the interior texels
+                for (int y = 0; y < pass.numInteriorTexels; y++)
+                {
+                    for (int x = 0; x < pass.numInteriorTexels; x++)
+                    {
+                        size_t texelIndex = (size_t)(y * pass.numInteriorTexels + x);
+                        int outputX = probeX * pass.numTexels + x + 1;
+                        int outputY = probeY * pass.numTexels + y + 1;
+
+                        float scale = 1.f / (2.f * std::max(scratch.texelA[texelIndex], epsilon));
+                        float result[4] = { scratch.texelR[texelIndex] * scale, scratch.texelG[texelIndex] * scale, scratch.texelB[texelIndex] * scale, 1.f };
+
+                        if (pass.radiance)
+                        {
+                            float* output = GetTexel(context.textures->probeIrradiance, pass, outputX, outputY, plane);
+                            float mean[3] = { output[0], output[1], output[2] };
+
+                            // If the probe was previously cleared to completely black, set the hysteresis to zero
+                            float hysteresis = volume.probeHysteresis;
+                            if (((mean[0] * mean[0]) + (mean[1] * mean[1]) + (mean[2] * mean[2])) == 0.f) hysteresis = 0.f;
+                            if (probeReset) hysteresis = std::max(0.f, hysteresis - 0.75f);
+
+                            // Tone-mapping gamma adjustment
+                            float invGamma = 1.f / volume.probeIrradianceEncodingGamma;
+                            for (int c = 0; c < 3; c++) result[c] = std::pow(result[c], invGamma);
+
+                            float delta[3] = { result[0] - mean[0], result[1] - mean[1], result[2] - mean[2] };
+                            float sample[3] = { result[0], result[1], result[2] };
+
+                            // Lower the hysteresis when a large lighting change is detected
+                            if (!probeReset && MaxComponent(mean[0] - result[0], mean[1] - result[1], mean[2] - result[2]) > volume.probeIrradianceThreshold)
+                            {
+                                hysteresis = std::max(0.f, hysteresis - 0.75f);
+                            }
+
+                            // Clamp the maximum per-update change in irradiance when a large brightness change is detected
+                            if (!probeReset && Luminance(delta[0], delta[1], delta[2]) > volume.probeBrightnessThreshold)
+                            {
+                                for (int c = 0; c < 3; c++) delta[c] *= 0.25f;
+                            }
+
+                            // When darkening, step at least the minimum value a 10-bit/channel format can represent
+                            float lerpDelta[3] = { (1.f - hysteresis) * delta[0], (1.f - hysteresis) * delta[1], (1.f - hysteresis) * delta[2] };
+                            if (MaxComponent(result[0], result[1], result[2]) < MaxComponent(mean[0], mean[1], mean[2]))
+                            {
+                                for (int c = 0; c < 3; c++)
+                                {
+                                    lerpDelta[c] = std::min(std::max(c_threshold, std::abs(lerpDelta[c])), std::abs(delta[c])) * Sign(lerpDelta[c]);
+                                }
+                            }
+
+                            for (int c = 0; c < 3; c++) result[c] = mean[c] + lerpDelta[c];
+                            result[3] = 1.f;
+
+                            if (volume.probeVariabilityEnabled)
+                            {
+                                // Compute the coefficient of variation
+                                float luminanceSigma2 = Luminance(
+                                    (sample[0] - mean[0]) * (sample[0] - result[0]),
+                                    (sample[1] - mean[1]) * (sample[1] - result[1]),
+                                    (sample[2] - mean[2]) * (sample[2] - result[2]));
+                                float luminanceMean = Luminance(result[0], result[1], result[2]);
+                                float coefficientOfVariation = (luminanceMean <= c_threshold) ? 0.f : std::sqrt(luminanceSigma2) / luminanceMean;
+
+                                int variabilityWidth = context.probeCountX * pass.numInteriorTexels;
+                                int variabilityHeight = pass.height / pass.numTexels * pass.numInteriorTexels;
+                                size_t variabilityIndex = ((size_t)plane * (size_t)variabilityHeight + (size_t)(probeY * pass.numInteriorTexels + y)) * (size_t)variabilityWidth + (size_t)(probeX * pass.numInteriorTexels + x);
+                                if (desc.quantizeTexels) QuantizeTexel(desc.probeVariabilityFormat, &coefficientOfVariation, 1);
+                                context.textures->probeVariability[variabilityIndex] = coefficientOfVariation;
+                            }
+
+                            if (desc.quantizeTexels) QuantizeTexel((EDDGIVolumeTextureFormat)volume.probeIrradianceFormat, result, 4);
+                            memcpy(output, result, sizeof(float) * 4);
+                        }
+                        else
+                        {
+                            float* output = GetTexel(context.textures->probeDistance, pass, outputX, outputY, plane);
+                            float hysteresis = volume.probeHysteresis;
+                            if (((output[0] * output[0]) + (output[1] * output[1])) == 0.f) hysteresis = 0.f;
+                            if (probeReset) hysteresis = std::max(0.f, hysteresis - 0.75f);
+
+                            // Interpolate the new filtered distance with the existing filtered distance in the probe
+                            result[0] = result[0] + hysteresis * (output[0] - result[0]);
+                            result[1] = result[1] + hysteresis * (output[1] - result[1]);
+
+                            if (desc.quantizeTexels) QuantizeTexel(desc.probeDistanceFormat, result, 2);
+                            output[0] = result[0];
+                            output[1] = result[1];
+                        }
+                    }
+                }
+                return true;
+            }
+
+            void BlendProbe(const BlendContext& context, BlendScratch& scratch, int probeIndex)
+            {
+                const DDGIVolumeDescGPU& volume = *context.volume;
+                const ProbeBlendingTextures& textures = *context.textures;
+
+                int plane = probeIndex / context.probesPerPlane;
+                int probeIndexInPlane = probeIndex - (plane * context.probesPerPlane);
+                int probeX = probeIndexInPlane % context.probeCountX;
+                int probeY = probeIndexInPlane / context.probeCountX;
+
+                // Determine if a scrolled probe should be cleared
+                bool scrollClear = false;
+                if (context.scrolling)
+                {
+                    int3 probeCoords = GetProbeCoords(probeIndex, volume);
+                    scrollClear |= ClearScrolledPlane(probeCoords, 0, volume);
+                    scrollClear |= ClearScrolledPlane(probeCoords, 1, volume);
+                    scrollClear |= ClearScrolledPlane(probeCoords, 2, volume);
+                }
+
+                // Get the probe's state
+                bool inactive = false;
+                if (!scrollClear && volume.probeClassificationEnabled)
+                {
+                    inactive = (textures.probeData[(size_t)probeIndex].w == c_probeStateInactive);
+                }
+
+                const BlendPass* passes[2] = { &context.irradiance, &context.distance };
+                for (const BlendPass* pass : passes)
+                {
+                    if (!pass->enabled) continue;
+
+                    if (scrollClear)
+                    {
+                        for (int y = 0; y < pass->numInteriorTexels; y++)
+                        {
+                            for (int x = 0; x < pass->numInteriorTexels; x++)
+                            {
+                                int outputX = probeX * pass->numTexels + x + 1;
+                                int outputY = probeY * pass->numTexels + y + 1;
+                                if (pass->radiance) *reinterpret_cast<float4*>(GetTexel(textures.probeIrradiance, *pass, outputX, outputY, plane)) = { 0.f, 0.f, 0.f, 1.f };
+                                else *reinterpret_cast<float2*>(GetTexel(textures.probeDistance, *pass, outputX, outputY, plane)) = { 0.f, 0.f };
+                            }
+                        }
+                    }
+                    else if (inactive)
+                    {
+                        // Don't blend rays for inactive probes, only reset their variability.
+                        // Like the shader, this clears the probe's own (interior) texels of the variability texture.
+                        if (pass->radiance && textures.probeVariability)
+                        {
+                            int variabilityWidth = context.probeCountX * pass->numInteriorTexels;
+                            int variabilityHeight = pass->height / pass->numTexels * pass->numInteriorTexels;
+                            for (int y = 0; y < pass->numInteriorTexels; y++)
+                            {
+                                size_t row = ((size_t)plane * (size_t)variabilityHeight + (size_t)(probeY * pass->numInteriorTexels + y)) * (size_t)variabilityWidth;
+                                for (int x = 0; x < pass->numInteriorTexels; x++)
+                                {
+                                    textures.probeVariability[row + (size_t)(probeX * pass->numInteriorTexels + x)] = 0.f;
+                                }
+                            }
+                        }
+                    }
+                    else
+                    {
+                        BlendProbeInterior(context, *pass, scratch, probeIndex, probeX, probeY, plane);
+                    }
+
+                    // Update the border texels with the latest blended data
+                    if (pass->radiance) UpdateBorderTexels(textures.probeIrradiance, *pass, probeX, probeY, plane);
+                    else UpdateBorderTexels(textures.probeDistance, *pass, probeX, probeY, plane);
+                }
+            }
+
+            void BlendProbes(const BlendContext& context, std::atomic<uint32_t>& nextProbe)
+            {
+                const size_t numRays = (size_t)context.volume->probeNumRays;
+                const size_t numTexels = (size_t)std::max(context.irradiance.numTexelsPadded, context.distance.numTexelsPadded);
+
+                BlendScratch scratch;
+                scratch.rayX.resize(numRays);
+                scratch.rayY.resize(numRays);
+                scratch.rayZ.resize(numRays);
+                scratch.rayR.resize(numRays);
+                scratch.rayG.resize(numRays);
+                scratch.rayB.resize(numRays);
+                if (context.volume->probeAdaptiveRaysEnabled)
+                {
+                    scratch.directionX.resize(numRays);
+                    scratch.directionY.resize(numRays);
+                    scratch.directionZ.resize(numRays);
+                }
+                scratch.texelR.resize(numTexels);
+                scratch.texelG.resize(numTexels);
+                scratch.texelB.resize(numTexels);
+                scratch.texelA.resize(numTexels);
+
+                const uint32_t numProbes = (uint32_t)context.numProbes;
+                for (;;)
+                {
+                    uint32_t first = nextProbe.fetch_add(c_probesPerJob);
+                    if (first >= numProbes) break;
+
+                    uint32_t last = std::min(first + c_probesPerJob, numProbes);
+                    for (uint32_t probeIndex = first; probeIndex < last; probeIndex++)
+                    {
+                        BlendProbe(context, scratch, (int)probeIndex);
+                    }
+                }
+            }
+
+        } // anonymous namespace
+
+        //------------------------------------------------------------------------
+        // Public CPU Probe Blending Functions
+        //------------------------------------------------------------------------
+
+        void GetDDGIVolumeTextureDimensions(const DDGIVolumeDescGPU& volume, EDDGIVolumeTextureType type, uint32_t& width, uint32_t& height, uint32_t& arraySize)
+        {
+            int countX, countY, numPlanes;
+            GetProbeCountsPerPlane(volume, countX, countY, numPlanes);
+
+            width = (uint32_t)countX;
+            height = (uint32_t)countY;
+            arraySize = (uint32_t)numPlanes;
+
+            if (type == EDDGIVolumeTextureType::RayData)
+            {
+                height = width * height;
+                width = (uint32_t)volume.probeNumRays;
+            }
+            else if (type == EDDGIVolumeTextureType::Irradiance)
+            {
+                width *= (uint32_t)(volume.probeNumIrradianceInteriorTexels + 2);
+                height *= (uint32_t)(volume.probeNumIrradianceInteriorTexels + 2);
+            }
+            else if (type == EDDGIVolumeTextureType::Distance)
+            {
+                width *= (uint32_t)(volume.probeNumDistanceInteriorTexels + 2);
+                height *= (uint32_t)(volume.probeNumDistanceInteriorTexels + 2);
+            }
+            else if (type == EDDGIVolumeTextureType::Variability)
+            {
+                width *= (uint32_t)volume.probeNumIrradianceInteriorTexels;
+                height *= (uint32_t)volume.probeNumIrradianceInteriorTexels;
+            }
+        }
+
+        ERTXGIStatus GetDDGIVolumeProbeVariability(const DDGIVolumeDescGPU& volume, const float* variabilityTexels, float* probeVariability)
+        {
+            if (volume.probeCounts.x <= 0 || volume.probeCounts.y <= 0 || volume.probeCounts.z <= 0) return ERTXGIStatus::ERROR_DDGI_INVALID_PROBE_COUNTS;
+            if (variabilityTexels == nullptr || probeVariability == nullptr || volume.probeNumIrradianceInteriorTexels <= 0) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_VARIABILITY;
+
+            int probeCountX, probeCountY, numPlanes;
+            GetProbeCountsPerPlane(volume, probeCountX, probeCountY, numPlanes);
+
+            const int numTexels = volume.probeNumIrradianceInteriorTexels;
+            const size_t width = (size_t)(probeCountX * numTexels);
+            const size_t height = (size_t)(probeCountY * numTexels);
+            const float scale = 1.f / (float)(numTexels * numTexels);
+
+            // Probes are laid out in the variability texture array the same way as in the irradiance texture array (without borders)
+            int probeIndex = 0;
+            for (int plane = 0; plane < numPlanes; plane++)
+            {
+                for (int probeY = 0; probeY < probeCountY; probeY++)
+                {
+                    for (int probeX = 0; probeX < probeCountX; probeX++)
+                    {
+                        float sum = 0.f;
+                        for (int y = 0; y < numTexels; y++)
+                        {
+                            const float* row = &variabilityTexels[((size_t)plane * height + (size_t)(probeY * numTexels + y)) * width + (size_t)(probeX * numTexels)];
+                            for (int x = 0; x < numTexels; x++) sum += row[x];
+                        }
+                        probeVariability[probeIndex++] = sum * scale;
+                    }
+                }
+            }
+            return ERTXGIStatus::OK;
+        }
+
+        bool IsProbeBlendingSIMDSupported()
+        {
+            return (RTXGI_CPU_SIMD != 0);
+        }
+
+        ERTXGIStatus BlendDDGIVolumeProbes(const DDGIVolumeDescGPU& volume, const ProbeBlendingDesc& desc, const ProbeBlendingTextures& textures)
+        {
+            // Validate the volume and its textures
+            if (volume.probeCounts.x <= 0 || volume.probeCounts.y <= 0 || volume.probeCounts.z <= 0) return ERTXGIStatus::ERROR_DDGI_INVALID_PROBE_COUNTS;
+            if (textures.rayData == nullptr || volume.probeNumRays <= 0) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_RAY_DATA;
+            if (volume.probeRayDataFormat != (uint32_t)EDDGIVolumeTextureFormat::F32x2
+                && volume.probeRayDataFormat != (uint32_t)EDDGIVolumeTextureFormat::F32x4) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_RAY_DATA;
+            if (textures.probeIrradiance && volume.probeNumIrradianceInteriorTexels <= 0) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_IRRADIANCE;
+            if (textures.probeDistance && volume.probeNumDistanceInteriorTexels <= 0) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_DISTANCE;
+            if (volume.probeClassificationEnabled && textures.probeData == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_DATA;
+            if (volume.probeVariabilityEnabled && textures.probeIrradiance && textures.probeVariability == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_VARIABILITY;
+            if (volume.probeAdaptiveRaysEnabled)
+            {
+                // Probe rays must be within the capacity of the ray data texture array
+                if (textures.probeRayAllocations == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_RAY_DATA;
+
+                uint64_t numProbes = (uint64_t)volume.probeCounts.x * (uint64_t)volume.probeCounts.y * (uint64_t)volume.probeCounts.z;
+                uint64_t maxRays = numProbes * (uint64_t)volume.probeNumRays;
+                for (uint64_t probeIndex = 0; probeIndex < numProbes; probeIndex++)
+                {
+                    const DDGIProbeRayAllocation& allocation = textures.probeRayAllocations[probeIndex];
+                    if (allocation.numRays > (uint32_t)volume.probeNumRays) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_RAY_DATA;
+                    if ((uint64_t)allocation.rayOffset + allocation.numRays > maxRays) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_RAY_DATA;
+                }
+            }
+
+            BlendContext context;
+            context.volume = &volume;
+            context.desc = &desc;
+            context.textures = &textures;
+
+            int probeCountY, numPlanes;
+            GetProbeCountsPerPlane(volume, context.probeCountX, probeCountY, numPlanes);
+            context.probesPerPlane = context.probeCountX * probeCountY;
+            context.numProbes = context.probesPerPlane * numPlanes;
+            context.scrolling = (volume.movementType == (uint32_t)EDDGIVolumeMovementType::Scrolling);
+        #if RTXGI_CPU_SIMD
+            context.useSIMD = desc.useSIMD;
+        #endif
+
+            // If relocation or classification are enabled, don't blend the fixed rays since they will bias the result
+            float epsilon = (float)volume.probeNumRays;
+            if (volume.probeRelocationEnabled || volume.probeClassificationEnabled)
+            {
+                context.firstRay = std::min(c_numFixedRays, volume.probeNumRays);
+                epsilon -= (float)c_numFixedRays;
+            }
+            context.epsilon = epsilon * 1e-9f;
+
+            // Initialize the max probe hit distance to 50% larger the maximum distance between probe grid cells
+            float3 spacing = volume.probeSpacing;
+            context.probeMaxRayDistance = std::sqrt((spacing.x * spacing.x) + (spacing.y * spacing.y) + (spacing.z * spacing.z)) * 1.5f;
+            context.distanceExponent = GetDistanceExponent(volume.probeDistanceExponent);
+
+            // Compute the probe ray directions, these are the same for all probes in the volume
+            context.rayDirectionX.resize((size_t)volume.probeNumRays);
+            context.rayDirectionY.resize((size_t)volume.probeNumRays);
+            context.rayDirectionZ.resize((size_t)volume.probeNumRays);
+            for (int rayIndex = 0; rayIndex < volume.probeNumRays; rayIndex++)
+            {
+                float3 direction = GetProbeRayDirection(rayIndex, volume.probeNumRays, volume);
+                context.rayDirectionX[(size_t)rayIndex] = direction.x;
+                context.rayDirectionY[(size_t)rayIndex] = direction.y;
+                context.rayDirectionZ[(size_t)rayIndex] = direction.z;
+            }
+
+            // Compute the octahedral texel directions, these are the same for all probes in the volume
+            if (textures.probeIrradiance) InitBlendPass(context.irradiance, volume.probeNumIrradianceInteriorTexels, context.probeCountX, probeCountY, true);
+            if (textures.probeDistance) InitBlendPass(context.distance, volume.probeNumDistanceInteriorTexels, context.probeCountX, probeCountY, false);
+
+            // Blend the probes
+            uint32_t numThreads = desc.numThreads;
+            if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+            numThreads = std::min(numThreads, ((uint32_t)context.numProbes + c_probesPerJob - 1) / c_probesPerJob);
+
+            std::atomic<uint32_t> nextProbe(0);
+            std::vector<std::thread> threads;
+            threads.reserve(numThreads - 1);
+            for (uint32_t threadIndex = 1; threadIndex < numThreads; threadIndex++)
+            {
+                threads.emplace_back(BlendProbes, std::cref(context), std::ref(nextProbe));
+            }
+            BlendProbes(context, nextProbe);
+            for (std::thread& thread : threads) thread.join();
+
+            return ERTXGIStatus::OK;
+        }
+
+    } // namespace cpu
+} // namespace rtxgi
@@ -0,0 +1,46 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "rtxgi/ddgi/DDGIProbeCompaction.h"
+
+namespace rtxgi
+{
+
+    //------------------------------------------------------------------------
+    // Public RTXGI Namespace Probe Compaction Functions
+    //------------------------------------------------------------------------
+
+    uint32_t GetDDGIProbeCompactionRegionSizeInBytes(const DDGIVolumeBase* volume)
+    {
+        if (volume == nullptr) return 0;
+        return (uint32_t)sizeof(DDGIProbeCompactionArgs) + ((uint32_t)volume->GetNumProbes() * (uint32_t)sizeof(uint32_t));
+    }
+
+    uint32_t GetDDGIProbeCompactionBufferSizeInBytes(uint32_t numVolumes, uint32_t numProbes)
+    {
+        return (numVolumes * (uint32_t)sizeof(DDGIProbeCompactionArgs)) + (numProbes * (uint32_t)sizeof(uint32_t));
+    }
+
+    uint32_t GetDDGIProbeCompactionIndirectArgsOffsetInBytes(uint32_t regionOffsetInBytes)
+    {
+        // The dispatch arguments follow the number of probes in the compacted list
+        return regionOffsetInBytes + (uint32_t)sizeof(uint32_t);
+    }
+
+    DDGIRootConstants GetDDGIProbeCompactionRootConstants(const DDGIRootConstants& volumeConsts, uint32_t regionOffsetInBytes, bool clear, uint32_t bufferDescriptorHeapIndex)
+    {
+        DDGIRootConstants consts = volumeConsts;
+        consts.reductionInputSizeX = regionOffsetInBytes / (uint32_t)sizeof(uint32_t);
+        consts.reductionInputSizeY = clear ? 1 : 0;
+        consts.reductionInputSizeZ = bufferDescriptorHeapIndex;
+        return consts;
+    }
+
+} // namespace rtxgi
@@ -0,0 +1,177 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "rtxgi/ddgi/DDGIProbeRayAllocator.h"
+
+#include <algorithm>
+
+namespace rtxgi
+{
+
+    //------------------------------------------------------------------------
+    // DDGIProbeRayAllocator
+    //------------------------------------------------------------------------
+
+    DDGIProbeRayAllocator::~DDGIProbeRayAllocator()
+    {
+        delete[] m_allocations;
+        delete[] m_shares;
+        delete[] m_order;
+    }
+
+    void DDGIProbeRayAllocator::Resize(uint32_t numProbes)
+    {
+        m_numProbes = numProbes;
+        if (numProbes <= m_maxProbes) return;
+
+        delete[] m_allocations;
+        delete[] m_shares;
+        delete[] m_order;
+
+        m_maxProbes = numProbes;
+        m_allocations = new DDGIProbeRayAllocation[numProbes]();
+        m_shares = new double[numProbes]();
+        m_order = new uint32_t[numProbes]();
+    }
+
+    void DDGIProbeRayAllocator::Finalize()
+    {
+        // Pack the probes' rays in probe index order
+        m_numRays = 0;
+        for (uint32_t probeIndex = 0; probeIndex < m_numProbes; probeIndex++)
+        {
+            m_allocations[probeIndex].rayOffset = m_numRays;
+            m_numRays += m_allocations[probeIndex].numRays;
+        }
+
+        m_allocationsHash = GetDDGIVolumeDataHash(m_allocations, GetAllocationsSizeInBytes());
+    }
+
+    ERTXGIStatus DDGIProbeRayAllocator::AllocateUniform(const DDGIVolumeBase* volume)
+    {
+        if (volume == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+        if (volume->GetNumProbes() <= 0) return ERTXGIStatus::ERROR_DDGI_INVALID_PROBE_COUNTS;
+
+        Resize((uint32_t)volume->GetNumProbes());
+
+        uint32_t maxRays = (uint32_t)volume->GetNumRaysPerProbe();
+        for (uint32_t probeIndex = 0; probeIndex < m_numProbes; probeIndex++) m_allocations[probeIndex].numRays = maxRays;
+
+        Finalize();
+        return ERTXGIStatus::OK;
+    }
+
+    ERTXGIStatus DDGIProbeRayAllocator::Allocate(const DDGIVolumeBase* volume, const DDGIProbeRayAllocatorDesc& desc, const float* probeVariability)
+    {
+        if (volume == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+        if (volume->GetNumProbes() <= 0) return ERTXGIStatus::ERROR_DDGI_INVALID_PROBE_COUNTS;
+        if (probeVariability == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_VARIABILITY;
+
+        Resize((uint32_t)volume->GetNumProbes());
+
+        // Relocation and classification read the fixed rays of every probe
+        uint32_t maxRays = (uint32_t)volume->GetNumRaysPerProbe();
+        uint32_t minRays = std::max(desc.minProbeRays, 1u);
+        if (volume->GetProbeRelocationEnabled() || volume->GetProbeClassificationEnabled()) minRays = std::max(minRays, (uint32_t)RTXGI_DDGI_NUM_FIXED_RAYS);
+        minRays = std::min(minRays, maxRays);
+
+        uint32_t granularity = std::max(desc.rayGranularity, 1u);
+        uint32_t maxExtraRays = maxRays - minRays;
+
+        // Clamp the budget to the capacity of the RayData texture array
+        uint64_t minBudget = (uint64_t)m_numProbes * minRays;
+        uint64_t maxBudget = (uint64_t)m_numProbes * maxRays;
+        uint64_t budget = (desc.rayBudget == 0) ? maxBudget : std::min(std::max((uint64_t)desc.rayBudget, minBudget), maxBudget);
+
+        // Distribute the rays above the minimum in proportion to probe variability ("water filling"):
+        // probes whose share exceeds their capacity are capped and their excess is redistributed to the others
+        uint32_t numActive = 0;
+        for (uint32_t probeIndex = 0; probeIndex < m_numProbes; probeIndex++)
+        {
+            m_shares[probeIndex] = 0.0;
+            if (probeVariability[probeIndex] > desc.variabilityThreshold) m_order[numActive++] = probeIndex;  // NaN variability is treated as converged
+        }
+
+        double remaining = (double)(budget - minBudget);
+        while (numActive > 0 && remaining > 0.0 && maxExtraRays > 0)
+        {
+            double sum = 0.0;
+            for (uint32_t index = 0; index < numActive; index++) sum += (double)probeVariability[m_order[index]];
+            if (sum <= 0.0) break;
+
+            // Cap the probes that reach their capacity
+            uint32_t numUncapped = 0;
+            double capped = 0.0;
+            for (uint32_t index = 0; index < numActive; index++)
+            {
+                uint32_t probeIndex = m_order[index];
+                double share = remaining * ((double)probeVariability[probeIndex] / sum);
+                if (m_shares[probeIndex] + share >= (double)maxExtraRays)
+                {
+                    capped += (double)maxExtraRays - m_shares[probeIndex];
+                    m_shares[probeIndex] = (double)maxExtraRays;
+                }
+                else
+                {
+                    m_order[numUncapped++] = probeIndex;
+                }
+            }
+
+            if (numUncapped == numActive)
+            {
+                // No probe reached its capacity, distribute the remaining rays
+                for (uint32_t index = 0; index < numActive; index++)
+                {
+                    uint32_t probeIndex = m_order[index];
+                    m_shares[probeIndex] += remaining * ((double)probeVariability[probeIndex] / sum);
+                }
+                break;
+            }
+
+            remaining -= capped;
+            numActive = numUncapped;
+        }
+
+        // Round the shares down to the ray granularity
+        uint64_t numExtraRays = 0;
+        uint32_t numRemainders = 0;
+        for (uint32_t probeIndex = 0; probeIndex < m_numProbes; probeIndex++)
+        {
+            uint32_t extraRays = std::min((uint32_t)(m_shares[probeIndex] / (double)granularity) * granularity, maxExtraRays);
+            m_allocations[probeIndex].numRays = minRays + extraRays;
+            numExtraRays += extraRays;
+
+            m_shares[probeIndex] -= (double)extraRays;
+            if (m_shares[probeIndex] > 0.0 && extraRays < maxExtraRays) m_order[numRemainders++] = probeIndex;
+        }
+
+        // Give the rays lost to rounding to the probes with the largest remainders (lowest probe index first on ties)
+        std::sort(m_order, m_order + numRemainders, [this](uint32_t a, uint32_t b)
+        {
+            if (m_shares[a] != m_shares[b]) return m_shares[a] > m_shares[b];
+            return a < b;
+        });
+
+        uint64_t leftover = (budget - minBudget) - std::min(numExtraRays, budget - minBudget);
+        for (uint32_t index = 0; index < numRemainders; index++)
+        {
+            DDGIProbeRayAllocation& allocation = m_allocations[m_order[index]];
+            uint32_t rays = std::min(granularity, maxRays - allocation.numRays);
+            if (rays > leftover) break;
+
+            allocation.numRays += rays;
+            leftover -= rays;
+        }
+
+        Finalize();
+        return ERTXGIStatus::OK;
+    }
+
+} // namespace rtxgi
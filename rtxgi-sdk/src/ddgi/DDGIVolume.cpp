@@ -12,8 +12,8 @@
 
 #include <algorithm>
 #include <assert.h>
+#include <cfloat>
 #include <cmath>
-#include <random>
 
 namespace rtxgi
 {
@@ -96,6 +96,50 @@ namespace rtxgi
         }
     }
 
+    uint64_t GetDDGIVolumeDataHash(const void* data, size_t size)
+    {
+        const uint8_t* bytes = (const uint8_t*)data;
+
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t byteIndex = 0; byteIndex < size; byteIndex++)
+        {
+            hash ^= (uint64_t)bytes[byteIndex];
+            hash *= 1099511628211ull;
+        }
+
+        // 0 is reserved for data that has never been uploaded
+        return (hash == 0) ? 1 : hash;
+    }
+
+    float4 GetDDGIRandomFloat4(uint32_t seed, uint64_t counter, uint32_t stream)
+    {
+        // Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC 2011)
+        uint32_t c[4] = { (uint32_t)counter, (uint32_t)(counter >> 32), stream, 0 };
+        uint32_t k[2] = { seed, 0x5EED5EEDu };
+
+        for (int round = 0; round < 10; round++)
+        {
+            uint64_t p0 = (uint64_t)0xD2511F53u * c[0];
+            uint64_t p1 = (uint64_t)0xCD9E8D57u * c[2];
+
+            uint32_t r[4] =
+            {
+                (uint32_t)(p1 >> 32) ^ c[1] ^ k[0],
+                (uint32_t)p1,
+                (uint32_t)(p0 >> 32) ^ c[3] ^ k[1],
+                (uint32_t)p0
+            };
+            c[0] = r[0]; c[1] = r[1]; c[2] = r[2]; c[3] = r[3];
+
+            k[0] += 0x9E3779B9u;
+            k[1] += 0xBB67AE85u;
+        }
+
+        // Use the upper 24 bits of each word, so values are exactly representable and less than 1
+        const float scale = 1.f / 16777216.f;
+        return { (float)(c[0] >> 8) * scale, (float)(c[1] >> 8) * scale, (float)(c[2] >> 8) * scale, (float)(c[3] >> 8) * scale };
+    }
+
     //------------------------------------------------------------------------
     // Public DDGIVolume Functions
     //------------------------------------------------------------------------
@@ -103,10 +147,47 @@ namespace rtxgi
     void DDGIVolumeBase::Update()
     {
         // Update the random probe ray rotation transform
-        ComputeRandomRotation();
+        m_probeRayRotationMatrix = ComputeRandomRotation(m_rngSeed, m_rngFrame++);
+        m_probeRayRotationQuaternion = RotationMatrixToQuaternion(m_probeRayRotationMatrix);
 
         // Update scrolling offsets and clear flags
         if(m_desc.movementType == EDDGIVolumeMovementType::Scrolling) ComputeScrolling();
+
+        // Find the probes to reset for the scene change events since the last update (after scrolling moves the probes)
+        ComputeProbeReset();
+    }
+
+    void DDGIVolumeBase::OnGlobalLightChange()
+    {
+        m_probeResetPending = true;
+        m_probeResetAll = true;
+
+        // The measured variability no longer describes the volume's light field
+        ResetProbeVariabilityReadback();
+    }
+
+    void DDGIVolumeBase::OnLargeObjectChange(const AABB& bounds)
+    {
+        // Probes within the maximum ray distance of the object can trace rays that reach it
+        float3 extent = { m_desc.probeMaxRayDistance, m_desc.probeMaxRayDistance, m_desc.probeMaxRayDistance };
+        AABB influence = { bounds.min - extent, bounds.max + extent };
+
+        if (m_probeResetPending)
+        {
+            m_probeResetBounds.min = Min(m_probeResetBounds.min, influence.min);
+            m_probeResetBounds.max = Max(m_probeResetBounds.max, influence.max);
+        }
+        else
+        {
+            m_probeResetBounds = influence;
+            m_probeResetPending = true;
+        }
+    }
+
+    void DDGIVolumeBase::OnSmallLightChange(const float3& position, float radius)
+    {
+        // Probes see the light through the surfaces it lights
+        OnLargeObjectChange({ position - radius, position + radius });
     }
 
 #if _DEBUG
@@ -147,6 +228,20 @@ namespace rtxgi
         assert(l.probeScrollDirections[0] == r.probeScrollDirections[0]);
         assert(l.probeScrollDirections[1] == r.probeScrollDirections[1]);
         assert(l.probeScrollDirections[2] == r.probeScrollDirections[2]);
+
+        // Packed5
+        assert(l.probeAdaptiveRaysEnabled == r.probeAdaptiveRaysEnabled);
+        assert(l.probeResetEnabled == r.probeResetEnabled);
+        assert(l.probeResetMin.x == r.probeResetMin.x);
+        assert(l.probeResetMin.y == r.probeResetMin.y);
+        assert(l.probeResetMin.z == r.probeResetMin.z);
+        assert(l.probeRayAllocationOffset == r.probeRayAllocationOffset);
+        assert(l.probeRayAllocationsIndex == r.probeRayAllocationsIndex);
+
+        // Packed6
+        assert(l.probeResetMax.x == r.probeResetMax.x);
+        assert(l.probeResetMax.y == r.probeResetMax.y);
+        assert(l.probeResetMax.z == r.probeResetMax.z);
     }
 #endif
 
@@ -191,12 +286,18 @@ namespace rtxgi
         descGPU.probeRelocationEnabled = m_desc.probeRelocationEnabled;
         descGPU.probeClassificationEnabled = m_desc.probeClassificationEnabled;
         descGPU.probeVariabilityEnabled = m_desc.probeVariabilityEnabled;
+        descGPU.probeAdaptiveRaysEnabled = m_desc.probeAdaptiveRaysEnabled;
+        descGPU.probeRayAllocationOffset = m_probeRayAllocationOffset;
+        descGPU.probeRayAllocationsIndex = m_probeRayAllocationsIndex;
         descGPU.probeScrollClear[0] = m_probeScrollClear[0];
         descGPU.probeScrollClear[1] = m_probeScrollClear[1];
         descGPU.probeScrollClear[2] = m_probeScrollClear[2];
         descGPU.probeScrollDirections[0] = (m_probeScrollDirections[0] > 0);
         descGPU.probeScrollDirections[1] = (m_probeScrollDirections[1] > 0);
         descGPU.probeScrollDirections[2] = (m_probeScrollDirections[2] > 0);
+        descGPU.probeResetEnabled = m_probeReset;
+        descGPU.probeResetMin = m_probeResetMin;
+        descGPU.probeResetMax = m_probeResetMax;
 
         return descGPU;
     }
@@ -376,20 +477,63 @@ namespace rtxgi
     }
 
     //------------------------------------------------------------------------
-    // Random number generation
+    // Probe Variability Readback
     //------------------------------------------------------------------------
 
-    static std::uniform_real_distribution<float> s_distribution(0.f, 1.f);
-    static std::mt19937 m_rng;
+    uint32_t DDGIVolumeBase::SetProbeVariabilityReadbackFrame(uint64_t frameIndex)
+    {
+        uint32_t slot = (uint32_t)(frameIndex % RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE);
+        m_variabilityReadbackFrames[slot] = frameIndex + 1;
+        return slot;
+    }
+
+    void DDGIVolumeBase::ResetProbeVariabilityReadback()
+    {
+        for (uint32_t slot = 0; slot < RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE; slot++) m_variabilityReadbackFrames[slot] = 0;
+        m_averageVariability = 0.f;
+        m_averageVariabilityFrame = RTXGI_DDGI_VARIABILITY_READBACK_INVALID_FRAME;
+    }
+
+    bool DDGIVolumeBase::GetProbeVariabilityReadbackSlot(uint64_t frameIndex, uint32_t& slot) const
+    {
+        // Slots written in the last (ring size - 1) frames may still be in flight on the GPU
+        const uint64_t latency = RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE - 1;
+        if (frameIndex < latency) return false;
+
+        bool found = false;
+        uint64_t newestFrame = 0;
+        for (uint32_t index = 0; index < RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE; index++)
+        {
+            if (m_variabilityReadbackFrames[index] == 0) continue;  // Skip slots that haven't been written
+
+            uint64_t writeFrame = m_variabilityReadbackFrames[index] - 1;
+            if (writeFrame > (frameIndex - latency)) continue;      // Skip slots the GPU may not have finished writing
+            if (m_averageVariabilityFrame != RTXGI_DDGI_VARIABILITY_READBACK_INVALID_FRAME && writeFrame <= m_averageVariabilityFrame) continue;  // Skip slots that have already been read
+            if (found && writeFrame <= newestFrame) continue;
+
+            found = true;
+            newestFrame = writeFrame;
+            slot = index;
+        }
+        return found;
+    }
+
+    //------------------------------------------------------------------------
+    // Random number generation
+    //------------------------------------------------------------------------
 
     void DDGIVolumeBase::SeedRNG(const int seed)
     {
-        m_rng.seed((uint32_t)seed);
+        m_rngSeed = (uint32_t)seed;
+        m_rngFrame = 0;
+        m_rngCounter = 0;
     }
 
     float DDGIVolumeBase::GetRandomFloat()
     {
-        return s_distribution(m_rng);
+        // Stream 1 keeps these numbers independent of the probe ray rotations (stream 0)
+        float4 values = GetDDGIRandomFloat4(m_rngSeed, m_rngCounter / 4, 1);
+        return values[(size_t)(m_rngCounter++ % 4)];
     }
 
     //------------------------------------------------------------------------
@@ -437,21 +581,23 @@ namespace rtxgi
         }
     }
 
-    void DDGIVolumeBase::ComputeRandomRotation()
+    float3x3 DDGIVolumeBase::ComputeRandomRotation(uint32_t seed, uint64_t frameIndex)
     {
         // This approach is based on James Arvo's implementation from Graphics Gems 3 (pg 117-120).
         // Also available at: http://citeseerx.ist.psu.edu/viewdoc/download?doi=10.1.1.53.1357&rep=rep1&type=pdf
 
         // Setup a random rotation matrix using 3 uniform RVs
-        float u1 = RTXGI_2PI * GetRandomFloat();
+        float4 random = GetDDGIRandomFloat4(seed, frameIndex);
+
+        float u1 = RTXGI_2PI * random.x;
         float cos1 = cosf(u1);
         float sin1 = sinf(u1);
 
-        float u2 = RTXGI_2PI * GetRandomFloat();
+        float u2 = RTXGI_2PI * random.y;
         float cos2 = cosf(u2);
         float sin2 = sinf(u2);
 
-        float u3 = GetRandomFloat();
+        float u3 = random.z;
         float sq3 = 2.f * sqrtf(u3 * (1.f - u3));
 
         float s2 = 2.f * u3 * sin2 * sin2 - 1.f;
@@ -477,8 +623,7 @@ namespace rtxgi
         transform.r1 = { _21, _22, _23 };
         transform.r2 = { _31, _32, _33 };
 
-        m_probeRayRotationMatrix = transform;
-        m_probeRayRotationQuaternion = RotationMatrixToQuaternion(m_probeRayRotationMatrix);
+        return transform;
     }
 
     int3 DDGIVolumeBase::GetProbeGridCoords(int probeIndex) const
@@ -503,6 +648,61 @@ namespace rtxgi
     // Private Helper Functions
     //------------------------------------------------------------------------
 
+    void DDGIVolumeBase::ComputeProbeReset()
+    {
+        m_probeReset = false;
+        if (!m_probeResetPending) return;
+
+        bool resetAll = m_probeResetAll;
+        AABB bounds = m_probeResetBounds;
+        m_probeResetPending = false;
+        m_probeResetAll = false;
+
+        int3 probeMax = m_desc.probeCounts - 1;
+        if (resetAll)
+        {
+            m_probeResetMin = { 0, 0, 0 };
+            m_probeResetMax = probeMax;
+            m_probeReset = true;
+            return;
+        }
+
+        // Transform the corners of the bounds to the volume's (unscrolled) probe grid space
+        // Matches DDGIGetProbeWorldPosition(): rotation is only applied to volumes that don't scroll
+        float3 origin = GetOrigin();
+        float3 probeGridShift = (m_desc.probeSpacing * probeMax) / 2.f;
+        bool rotated = (m_desc.movementType == EDDGIVolumeMovementType::Default);
+        float4 rotation = QuaternionConjugate(m_rotationQuaternion);
+
+        float3 gridMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+        float3 gridMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+        for (int cornerIndex = 0; cornerIndex < 8; cornerIndex++)
+        {
+            float3 corner =
+            {
+                (cornerIndex & 1) ? bounds.max.x : bounds.min.x,
+                (cornerIndex & 2) ? bounds.max.y : bounds.min.y,
+                (cornerIndex & 4) ? bounds.max.z : bounds.min.z
+            };
+
+            float3 position = corner - origin;
+            if (rotated) position = QuaternionRotate(position, rotation);
+            position = (position + probeGridShift) / m_desc.probeSpacing;
+
+            gridMin = Min(gridMin, position);
+            gridMax = Max(gridMax, position);
+        }
+
+        // Include the next probe outside the bounds on each side, to cover probes moved by relocation
+        for (int axis = 0; axis < 3; axis++)
+        {
+            if (gridMax[axis] < -1.f || gridMin[axis] > (float)(probeMax[axis] + 1)) return; // Early out: the bounds don't overlap the volume
+            m_probeResetMin[axis] = (int)std::max(0.f, std::floor(gridMin[axis]));
+            m_probeResetMax[axis] = (int)std::min((float)probeMax[axis], std::ceil(gridMax[axis]));
+        }
+        m_probeReset = true;
+    }
+
     void DDGIVolumeBase::ScrollReset()
     {
         // Reset the volume's origin and scroll offsets (if necessary) for each axis
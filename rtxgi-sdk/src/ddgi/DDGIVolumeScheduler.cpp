@@ -0,0 +1,215 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "rtxgi/ddgi/DDGIVolumeScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace rtxgi
+{
+
+    namespace
+    {
+        float4 MakePlane(const float3& normal, const float3& point)
+        {
+            float3 n = Normalize(normal);
+            return { n.x, n.y, n.z, -Dot(n, point) };
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Public RTXGI Namespace Scheduling Functions
+    //------------------------------------------------------------------------
+
+    DDGIFrustum ComputeDDGIFrustum(const float3& position, const float3& forward, const float3& right, const float3& up, float tanHalfFovY, float aspect)
+    {
+        float tanHalfFovX = tanHalfFovY * aspect;
+
+        DDGIFrustum frustum = {};
+        frustum.planes[0] = MakePlane(forward, position);                                   // Near (at the camera position)
+        frustum.planes[1] = MakePlane((forward * tanHalfFovX) - right, position);           // Right
+        frustum.planes[2] = MakePlane((forward * tanHalfFovX) + right, position);           // Left
+        frustum.planes[3] = MakePlane((forward * tanHalfFovY) - up, position);              // Top
+        frustum.planes[4] = MakePlane((forward * tanHalfFovY) + up, position);              // Bottom
+        frustum.numPlanes = 5;
+        return frustum;
+    }
+
+    bool IntersectDDGIFrustum(const DDGIFrustum& frustum, const OBB& obb)
+    {
+        float3 axes[3] =
+        {
+            QuaternionRotate({ 1.f, 0.f, 0.f }, obb.rotation),
+            QuaternionRotate({ 0.f, 1.f, 0.f }, obb.rotation),
+            QuaternionRotate({ 0.f, 0.f, 1.f }, obb.rotation)
+        };
+
+        for (uint32_t planeIndex = 0; planeIndex < frustum.numPlanes; planeIndex++)
+        {
+            const float4& plane = frustum.planes[planeIndex];
+            float3 n = { plane.x, plane.y, plane.z };
+
+            // Project the box's extents onto the plane normal
+            float radius = (obb.e.x * std::fabs(Dot(n, axes[0])))
+                         + (obb.e.y * std::fabs(Dot(n, axes[1])))
+                         + (obb.e.z * std::fabs(Dot(n, axes[2])));
+
+            // The box is entirely behind the plane
+            if ((Dot(n, obb.origin) + plane.w + radius) < 0.f) return false;
+        }
+        return true;
+    }
+
+    float GetDistanceToOrientedBoundingBox(const float3& point, const OBB& obb)
+    {
+        // Transform the point into the box's local space
+        float3 local = QuaternionRotate(point - obb.origin, QuaternionConjugate(obb.rotation));
+
+        float3 d = { std::max(std::fabs(local.x) - obb.e.x, 0.f),
+                     std::max(std::fabs(local.y) - obb.e.y, 0.f),
+                     std::max(std::fabs(local.z) - obb.e.z, 0.f) };
+
+        return std::sqrt(Dot(d, d));
+    }
+
+    //------------------------------------------------------------------------
+    // DDGIVolumeScheduler
+    //------------------------------------------------------------------------
+
+    DDGIVolumeScheduler::~DDGIVolumeScheduler()
+    {
+        delete[] m_framesSinceUpdate;
+        delete[] m_scores;
+        delete[] m_visible;
+        delete[] m_order;
+    }
+
+    void DDGIVolumeScheduler::Reset()
+    {
+        for (uint32_t volumeIndex = 0; volumeIndex < m_numVolumes; volumeIndex++)
+        {
+            m_framesSinceUpdate[volumeIndex] = m_desc.stalenessFrames;
+            m_scores[volumeIndex] = 0.f;
+            m_visible[volumeIndex] = false;
+        }
+        m_scheduledRays = 0;
+    }
+
+    void DDGIVolumeScheduler::Resize(uint32_t numVolumes)
+    {
+        if (numVolumes == m_numVolumes) return;
+
+        // Preserve the update history of existing volumes. New volumes start fully stale.
+        uint32_t* framesSinceUpdate = new uint32_t[numVolumes];
+        for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+        {
+            framesSinceUpdate[volumeIndex] = (volumeIndex < m_numVolumes) ? m_framesSinceUpdate[volumeIndex] : m_desc.stalenessFrames;
+        }
+
+        delete[] m_framesSinceUpdate;
+        delete[] m_scores;
+        delete[] m_visible;
+        delete[] m_order;
+
+        m_numVolumes = numVolumes;
+        m_framesSinceUpdate = framesSinceUpdate;
+        m_scores = new float[numVolumes]();
+        m_visible = new bool[numVolumes]();
+        m_order = new uint32_t[numVolumes]();
+    }
+
+    uint32_t DDGIVolumeScheduler::Schedule(const DDGIVolumeSchedulerInputs& inputs, uint32_t numVolumes, const DDGIVolumeBase* const* volumes, const uint8_t* enabled, uint32_t* selectedIndices)
+    {
+        Resize(numVolumes);
+        m_scheduledRays = 0;
+        if (numVolumes == 0) return 0;
+
+        float stalenessFrames = (float)std::max(m_desc.stalenessFrames, 1u);
+        float distanceFalloff = std::max(m_desc.distanceFalloff, std::numeric_limits<float>::min());
+
+        // Score the volumes
+        uint32_t numCandidates = 0;
+        for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+        {
+            const DDGIVolumeBase* volume = volumes[volumeIndex];
+
+            // Scrolling volumes are centered on their (scrolled) origin and are not rotated
+            OBB obb = volume->GetOrientedBoundingBox();
+            if (volume->GetMovementType() == EDDGIVolumeMovementType::Scrolling)
+            {
+                obb.origin = volume->GetOrigin();
+                obb.rotation = { 0.f, 0.f, 0.f, 1.f };
+            }
+
+            bool visible = (inputs.frustum.numPlanes == 0) || IntersectDDGIFrustum(inputs.frustum, obb);
+            float distance = GetDistanceToOrientedBoundingBox(inputs.cameraPosition, obb);
+            float variability = volume->GetProbeVariabilityEnabled() ? volume->GetVolumeAverageVariability() : 1.f;
+            float staleness = std::min(1.f, (float)m_framesSinceUpdate[volumeIndex] / stalenessFrames);
+
+            float visibilityWeight = visible ? m_desc.visibleWeight : m_desc.invisibleWeight;
+
+            float score = (m_desc.variabilityWeight * variability) + (m_desc.stalenessWeight * staleness);
+            score *= visibilityWeight;
+            score /= (1.f + (distance / distanceFalloff));
+
+            m_visible[volumeIndex] = visible;
+            m_scores[volumeIndex] = score;
+
+            // Disabled volumes and volumes excluded by their visibility are not candidates for update
+            bool candidate = (enabled == nullptr || enabled[volumeIndex] != 0) && (visibilityWeight > 0.f);
+            if (candidate) m_order[numCandidates++] = volumeIndex;
+        }
+
+        // Sort the candidates by priority (ties are broken by array index to keep the schedule deterministic)
+        const float* scores = m_scores;
+        std::sort(m_order, m_order + numCandidates, [scores](uint32_t a, uint32_t b)
+        {
+            if (scores[a] != scores[b]) return scores[a] > scores[b];
+            return a < b;
+        });
+
+        // Select volumes, highest priority first, until the ray budget is exhausted
+        uint32_t numSelected = 0;
+        for (uint32_t candidateIndex = 0; candidateIndex < numCandidates; candidateIndex++)
+        {
+            uint32_t volumeIndex = m_order[candidateIndex];
+            const DDGIVolumeBase* volume = volumes[volumeIndex];
+            uint64_t numRays = (uint64_t)volume->GetNumProbes() * (uint64_t)volume->GetNumRaysPerProbe();
+
+            if (inputs.rayBudget > 0 && (m_scheduledRays + numRays) > inputs.rayBudget) continue;
+
+            selectedIndices[numSelected++] = volumeIndex;
+            m_scheduledRays += numRays;
+        }
+
+        // Always make progress, even when the highest priority volume exceeds the budget by itself
+        if (numSelected == 0 && numCandidates > 0)
+        {
+            uint32_t volumeIndex = m_order[0];
+            selectedIndices[numSelected++] = volumeIndex;
+            m_scheduledRays = (uint64_t)volumes[volumeIndex]->GetNumProbes() * (uint64_t)volumes[volumeIndex]->GetNumRaysPerProbe();
+        }
+
+        // Update the frame counters
+        for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+        {
+            if (m_framesSinceUpdate[volumeIndex] < std::numeric_limits<uint32_t>::max()) m_framesSinceUpdate[volumeIndex]++;
+        }
+        for (uint32_t selectedIndex = 0; selectedIndex < numSelected; selectedIndex++)
+        {
+            m_framesSinceUpdate[selectedIndices[selectedIndex]] = 0;
+        }
+
+        return numSelected;
+    }
+
+} // namespace rtxgi
@@ -0,0 +1,725 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "rtxgi/ddgi/DDGIVolumeSnapshot.h"
+
+#include <string.h>
+
+// "DDGS", the first four bytes of a serialized snapshot
+#define RTXGI_DDGI_VOLUME_SNAPSHOT_MAGIC 0x53474444
+
+namespace rtxgi
+{
+
+    //------------------------------------------------------------------------
+    // Serialized Format
+    //
+    // A serialized snapshot is a header, followed by a table that describes
+    // each texture, followed by the (possibly compressed) texture data in
+    // table order. Values are little endian.
+    //------------------------------------------------------------------------
+
+    struct DDGIVolumeSnapshotHeader
+    {
+        uint32_t magic;                         // RTXGI_DDGI_VOLUME_SNAPSHOT_MAGIC
+        uint32_t version;                       // RTXGI_DDGI_VOLUME_SNAPSHOT_VERSION
+        uint32_t numTextures;                   // Number of entries in the texture table
+        uint32_t reserved0;
+        //------------------------------------------------- 16B
+        DDGIVolumeDescGPUPacked descGPU;        // Constants of the volume
+        //------------------------------------------------- 144B
+        int3     probeScrollOffsets;            // Scroll offsets of the volume
+        uint32_t reserved1;
+        //------------------------------------------------- 160B
+        uint64_t hash;                          // Hash of the header (with a zero hash) and the texture table
+        //------------------------------------------------- 168B
+    };
+
+    struct DDGIVolumeSnapshotTexture
+    {
+        uint32_t type;                          // EDDGIVolumeTextureType
+        uint32_t format;                        // EDDGIVolumeTextureFormat
+        uint32_t width;
+        uint32_t height;
+        uint32_t arraySize;
+        uint32_t compression;                   // EDDGIVolumeSnapshotCompression
+        //------------------------------------------------- 24B
+        uint64_t offset;                        // Location of the texture data in the snapshot
+        uint64_t sizeInBytes;                   // Size of the texture data
+        uint64_t storedSizeInBytes;             // Size of the texture data in the snapshot (after compression)
+        uint64_t hash;                          // Hash of the texture data (before compression)
+        //------------------------------------------------- 56B
+    };
+
+    static_assert(sizeof(DDGIVolumeSnapshotHeader) == 168, "DDGIVolumeSnapshotHeader must be 168B");
+    static_assert(sizeof(DDGIVolumeSnapshotTexture) == 56, "DDGIVolumeSnapshotTexture must be 56B");
+
+    //------------------------------------------------------------------------
+    // Compression
+    //
+    // Texels are byte shuffled first (byte N of every texel is stored
+    // together), which groups the slowly changing sign and exponent bytes
+    // of float texels, then LZ compressed. The compressed stream uses the
+    // LZ4 block format: sequences of a token (literal length and match
+    // length nibbles), literals, a 16-bit match offset, and a match.
+    //------------------------------------------------------------------------
+
+    const uint32_t LZMinMatch = 4;          // Minimum match length
+    const uint32_t LZMaxOffset = 65535;     // Maximum match offset
+    const uint32_t LZLastLiterals = 5;      // The last bytes of a stream are always literals
+    const uint32_t LZMatchLimit = 12;       // Matches don't start in the last bytes of a stream
+    const uint32_t LZHashBits = 16;
+
+    uint64_t GetLZBound(uint64_t size)
+    {
+        return size + (size / 255) + 16;
+    }
+
+    /**
+     * Returns the smallest compressed size that can decompress to size bytes.
+     * Each byte of a sequence's match length extension adds at most 255 bytes of output.
+     */
+    uint64_t GetLZMinSize(uint64_t size)
+    {
+        return (size + 254) / 255;
+    }
+
+    uint32_t LZRead32(const uint8_t* src)
+    {
+        uint32_t value;
+        memcpy(&value, src, sizeof(uint32_t));
+        return value;
+    }
+
+    uint32_t LZHash(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - LZHashBits);
+    }
+
+    uint8_t* LZWriteLength(uint8_t* dst, uint64_t length)
+    {
+        while (length >= 255)
+        {
+            *dst++ = 255;
+            length -= 255;
+        }
+        *dst++ = (uint8_t)length;
+        return dst;
+    }
+
+    bool LZReadLength(const uint8_t* src, uint64_t srcSize, uint64_t& srcIndex, uint64_t maxLength, uint64_t& length)
+    {
+        uint8_t value = 255;
+        while (value == 255)
+        {
+            if (srcIndex >= srcSize || length > maxLength) return false;
+            value = src[srcIndex++];
+            length += value;
+        }
+        return true;
+    }
+
+    uint8_t* LZWriteSequence(uint8_t* dst, const uint8_t* literals, uint64_t numLiterals, uint32_t offset, uint64_t matchLength)
+    {
+        uint8_t* token = dst++;
+        *token = (uint8_t)(((numLiterals >= 15) ? 15 : numLiterals) << 4);
+        if (numLiterals >= 15) dst = LZWriteLength(dst, numLiterals - 15);
+        memcpy(dst, literals, numLiterals);
+        dst += numLiterals;
+
+        // The last sequence has no match
+        if (offset == 0) return dst;
+
+        matchLength -= LZMinMatch;
+        *token |= (uint8_t)((matchLength >= 15) ? 15 : matchLength);
+        *dst++ = (uint8_t)(offset & 0xFF);
+        *dst++ = (uint8_t)(offset >> 8);
+        if (matchLength >= 15) dst = LZWriteLength(dst, matchLength - 15);
+        return dst;
+    }
+
+    /**
+     * Compresses the source data. The destination must hold GetLZBound(size) bytes and the hash table
+     * (1 << LZHashBits) entries. Returns the compressed size.
+     */
+    uint64_t CompressLZ(const uint8_t* src, uint64_t size, uint8_t* dst, uint32_t* table)
+    {
+        uint8_t* out = dst;
+        uint64_t anchor = 0;
+
+        if (size > LZMatchLimit)
+        {
+            // Table entries are source positions + 1, 0 is empty
+            memset(table, 0, sizeof(uint32_t) << LZHashBits);
+
+            uint64_t position = 0;
+            while (position < size - LZMatchLimit)
+            {
+                uint32_t sequence = LZRead32(src + position);
+                uint32_t hash = LZHash(sequence);
+                uint64_t candidate = table[hash];
+                table[hash] = (uint32_t)(position + 1);
+
+                if (candidate == 0 || (position - (candidate - 1)) > LZMaxOffset || LZRead32(src + candidate - 1) != sequence)
+                {
+                    // Skip ahead faster through data that doesn't compress
+                    position += 1 + ((position - anchor) >> 6);
+                    continue;
+                }
+                candidate--;
+
+                // Extend the match
+                uint64_t matchEnd = position + LZMinMatch;
+                while (matchEnd < size - LZLastLiterals && src[matchEnd] == src[candidate + (matchEnd - position)]) matchEnd++;
+
+                out = LZWriteSequence(out, src + anchor, position - anchor, (uint32_t)(position - candidate), matchEnd - position);
+                position = anchor = matchEnd;
+            }
+        }
+
+        out = LZWriteSequence(out, src + anchor, size - anchor, 0, 0);
+        return (uint64_t)(out - dst);
+    }
+
+    /**
+     * Decompresses the source data. Returns false if the data is corrupt or doesn't decompress to exactly dstSize bytes.
+     */
+    bool DecompressLZ(const uint8_t* src, uint64_t srcSize, uint8_t* dst, uint64_t dstSize)
+    {
+        uint64_t srcIndex = 0;
+        uint64_t dstIndex = 0;
+        while (srcIndex < srcSize)
+        {
+            uint8_t token = src[srcIndex++];
+
+            // Literals
+            uint64_t numLiterals = (token >> 4);
+            if (numLiterals == 15 && !LZReadLength(src, srcSize, srcIndex, dstSize, numLiterals)) return false;
+            if (numLiterals > (srcSize - srcIndex) || numLiterals > (dstSize - dstIndex)) return false;
+            memcpy(dst + dstIndex, src + srcIndex, numLiterals);
+            srcIndex += numLiterals;
+            dstIndex += numLiterals;
+
+            // The last sequence has no match
+            if (srcIndex == srcSize) break;
+
+            // Match
+            if ((srcSize - srcIndex) < 2) return false;
+            uint64_t offset = (uint64_t)src[srcIndex] | ((uint64_t)src[srcIndex + 1] << 8);
+            srcIndex += 2;
+            if (offset == 0 || offset > dstIndex) return false;
+
+            uint64_t matchLength = (token & 0xF);
+            if (matchLength == 15 && !LZReadLength(src, srcSize, srcIndex, dstSize, matchLength)) return false;
+            matchLength += LZMinMatch;
+            if (matchLength > (dstSize - dstIndex)) return false;
+
+            // Matches may overlap the bytes they write
+            const uint8_t* match = dst + dstIndex - offset;
+            if (offset >= matchLength) memcpy(dst + dstIndex, match, matchLength);
+            else for (uint64_t byteIndex = 0; byteIndex < matchLength; byteIndex++) dst[dstIndex + byteIndex] = match[byteIndex];
+            dstIndex += matchLength;
+        }
+        return (dstIndex == dstSize);
+    }
+
+    void ShuffleTexels(const uint8_t* src, uint8_t* dst, uint64_t numTexels, uint32_t texelSize)
+    {
+        for (uint32_t byteIndex = 0; byteIndex < texelSize; byteIndex++)
+        {
+            uint8_t* plane = dst + (byteIndex * numTexels);
+            for (uint64_t texelIndex = 0; texelIndex < numTexels; texelIndex++) plane[texelIndex] = src[(texelIndex * texelSize) + byteIndex];
+        }
+    }
+
+    void UnshuffleTexels(const uint8_t* src, uint8_t* dst, uint64_t numTexels, uint32_t texelSize)
+    {
+        for (uint32_t byteIndex = 0; byteIndex < texelSize; byteIndex++)
+        {
+            const uint8_t* plane = src + (byteIndex * numTexels);
+            for (uint64_t texelIndex = 0; texelIndex < numTexels; texelIndex++) dst[(texelIndex * texelSize) + byteIndex] = plane[texelIndex];
+        }
+    }
+
+    //------------------------------------------------------------------------
+    // Validation
+    //------------------------------------------------------------------------
+
+    bool IsSnapshotTextureType(EDDGIVolumeTextureType type)
+    {
+        // Ray data and variability average textures are recomputed every update
+        return (type == EDDGIVolumeTextureType::Irradiance
+            || type == EDDGIVolumeTextureType::Distance
+            || type == EDDGIVolumeTextureType::Data
+            || type == EDDGIVolumeTextureType::Variability);
+    }
+
+    bool IsSnapshotTextureFormat(EDDGIVolumeTextureType type, EDDGIVolumeTextureFormat format)
+    {
+        if (type == EDDGIVolumeTextureType::Irradiance)
+        {
+            return (format == EDDGIVolumeTextureFormat::U32 || format == EDDGIVolumeTextureFormat::F16x4 || format == EDDGIVolumeTextureFormat::F32x4);
+        }
+        else if (type == EDDGIVolumeTextureType::Distance)
+        {
+            return (format == EDDGIVolumeTextureFormat::F16x2 || format == EDDGIVolumeTextureFormat::F32x2);
+        }
+        else if (type == EDDGIVolumeTextureType::Data)
+        {
+            return (format == EDDGIVolumeTextureFormat::F16x4 || format == EDDGIVolumeTextureFormat::F32x4);
+        }
+        else if (type == EDDGIVolumeTextureType::Variability)
+        {
+            return (format == EDDGIVolumeTextureFormat::F16 || format == EDDGIVolumeTextureFormat::F32);
+        }
+        return false;
+    }
+
+    /**
+     * Get the texture dimensions of a volume from its (unpacked) constants.
+     */
+    void GetSnapshotTextureDimensions(const DDGIVolumeDescGPU& descGPU, EDDGIVolumeTextureType type, uint32_t& width, uint32_t& height, uint32_t& arraySize)
+    {
+        DDGIVolumeDesc desc;
+        desc.probeCounts = descGPU.probeCounts;
+        desc.probeNumRays = descGPU.probeNumRays;
+        desc.probeNumIrradianceInteriorTexels = descGPU.probeNumIrradianceInteriorTexels;
+        desc.probeNumIrradianceTexels = descGPU.probeNumIrradianceInteriorTexels + 2;
+        desc.probeNumDistanceInteriorTexels = descGPU.probeNumDistanceInteriorTexels;
+        desc.probeNumDistanceTexels = descGPU.probeNumDistanceInteriorTexels + 2;
+        GetDDGIVolumeTextureDimensions(desc, type, width, height, arraySize);
+    }
+
+    /**
+     * Checks that float texel data has no infinities or NaNs.
+     */
+    bool IsSnapshotTextureFinite(const uint8_t* data, uint64_t size, EDDGIVolumeTextureFormat format)
+    {
+        if (format == EDDGIVolumeTextureFormat::U32) return true;
+
+        if (format == EDDGIVolumeTextureFormat::F16 || format == EDDGIVolumeTextureFormat::F16x2 || format == EDDGIVolumeTextureFormat::F16x4)
+        {
+            for (uint64_t offset = 0; offset < size; offset += sizeof(uint16_t))
+            {
+                uint16_t value;
+                memcpy(&value, data + offset, sizeof(uint16_t));
+                if ((value & 0x7C00) == 0x7C00) return false;
+            }
+            return true;
+        }
+
+        for (uint64_t offset = 0; offset < size; offset += sizeof(uint32_t))
+        {
+            uint32_t value;
+            memcpy(&value, data + offset, sizeof(uint32_t));
+            if ((value & 0x7F800000) == 0x7F800000) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Validates the header and texture table of a serialized snapshot.
+     */
+    ERTXGIStatus ValidateSnapshotLayout(const uint8_t* data, uint64_t size, DDGIVolumeSnapshotHeader& header)
+    {
+        if (data == nullptr || size < sizeof(DDGIVolumeSnapshotHeader)) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+        memcpy(&header, data, sizeof(DDGIVolumeSnapshotHeader));
+        if (header.magic != RTXGI_DDGI_VOLUME_SNAPSHOT_MAGIC) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+        if (header.version != RTXGI_DDGI_VOLUME_SNAPSHOT_VERSION) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT_VERSION;
+        if (header.numTextures == 0 || header.numTextures > (uint32_t)EDDGIVolumeTextureType::Count) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+        uint64_t tableEnd = sizeof(DDGIVolumeSnapshotHeader) + (header.numTextures * sizeof(DDGIVolumeSnapshotTexture));
+        if (size < tableEnd) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+        // Check the hash of the header and texture table
+        uint64_t hash = header.hash;
+        header.hash = 0;
+        uint64_t expected = GetDDGIVolumeDataHash(&header, sizeof(DDGIVolumeSnapshotHeader));
+        header.hash = hash;
+
+        const uint8_t* table = data + sizeof(DDGIVolumeSnapshotHeader);
+        uint64_t tableHash = GetDDGIVolumeDataHash(table, tableEnd - sizeof(DDGIVolumeSnapshotHeader));
+        if ((expected ^ tableHash) != hash) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+        DDGIVolumeDescGPU descGPU = UnpackDDGIVolumeDescGPU(header.descGPU);
+        if (descGPU.probeCounts.x <= 0 || descGPU.probeCounts.y <= 0 || descGPU.probeCounts.z <= 0) return ERTXGIStatus::ERROR_DDGI_INVALID_PROBE_COUNTS;
+
+        // Check the textures
+        uint32_t types = 0;
+        uint64_t offset = tableEnd;
+        for (uint32_t textureIndex = 0; textureIndex < header.numTextures; textureIndex++)
+        {
+            DDGIVolumeSnapshotTexture texture;
+            memcpy(&texture, table + (textureIndex * sizeof(DDGIVolumeSnapshotTexture)), sizeof(DDGIVolumeSnapshotTexture));
+
+            EDDGIVolumeTextureType type = (EDDGIVolumeTextureType)texture.type;
+            EDDGIVolumeTextureFormat format = (EDDGIVolumeTextureFormat)texture.format;
+            if (texture.type >= (uint32_t)EDDGIVolumeTextureType::Count || !IsSnapshotTextureType(type)) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+            if (texture.format >= (uint32_t)EDDGIVolumeTextureFormat::Count || !IsSnapshotTextureFormat(type, format)) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+            if (texture.compression >= (uint32_t)EDDGIVolumeSnapshotCompression::Count) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+            // Each texture type is stored once
+            if (types & (1u << texture.type)) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+            types |= (1u << texture.type);
+
+            // Texture dimensions must match the volume's constants
+            uint32_t width, height, arraySize;
+            GetSnapshotTextureDimensions(descGPU, type, width, height, arraySize);
+            if (texture.width != width || texture.height != height || texture.arraySize != arraySize) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+            uint64_t sizeInBytes = (uint64_t)width * height * arraySize * GetDDGIVolumeTextureFormatSize(format);
+            if (texture.sizeInBytes != sizeInBytes) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+            // Texture data is stored in table order, without gaps
+            if (texture.offset != offset) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+            if (texture.compression == (uint32_t)EDDGIVolumeSnapshotCompression::None && texture.storedSizeInBytes != sizeInBytes) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+            if (texture.storedSizeInBytes > GetLZBound(sizeInBytes) || texture.storedSizeInBytes > (size - offset)) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+            // Reject compressed data too small to expand to the texture size before anything is allocated for it
+            if (texture.compression == (uint32_t)EDDGIVolumeSnapshotCompression::LZ && texture.storedSizeInBytes < GetLZMinSize(sizeInBytes)) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+            offset += texture.storedSizeInBytes;
+        }
+        if (offset != size) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+        return ERTXGIStatus::OK;
+    }
+
+    /**
+     * Decodes a texture of a serialized snapshot (with a valid layout) and checks its data.
+     * Compressed textures need a scratch buffer of the texture's size.
+     */
+    ERTXGIStatus DecodeSnapshotTexture(const uint8_t* data, const DDGIVolumeSnapshotTexture& texture, uint8_t* dst, uint8_t* scratch)
+    {
+        EDDGIVolumeTextureFormat format = (EDDGIVolumeTextureFormat)texture.format;
+        if (texture.compression == (uint32_t)EDDGIVolumeSnapshotCompression::LZ)
+        {
+            if (!DecompressLZ(data + texture.offset, texture.storedSizeInBytes, scratch, texture.sizeInBytes)) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT_DATA;
+
+            uint32_t texelSize = GetDDGIVolumeTextureFormatSize(format);
+            UnshuffleTexels(scratch, dst, texture.sizeInBytes / texelSize, texelSize);
+        }
+        else
+        {
+            memcpy(dst, data + texture.offset, texture.sizeInBytes);
+        }
+
+        if (GetDDGIVolumeDataHash(dst, texture.sizeInBytes) != texture.hash) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT_DATA;
+        if (!IsSnapshotTextureFinite(dst, texture.sizeInBytes, format)) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT_DATA;
+        return ERTXGIStatus::OK;
+    }
+
+    //------------------------------------------------------------------------
+    // Public RTXGI Namespace DDGI Functions
+    //------------------------------------------------------------------------
+
+    uint32_t GetDDGIVolumeTextureFormatSize(EDDGIVolumeTextureFormat format)
+    {
+        if (format == EDDGIVolumeTextureFormat::F16) return 2;
+        if (format == EDDGIVolumeTextureFormat::U32 || format == EDDGIVolumeTextureFormat::F16x2 || format == EDDGIVolumeTextureFormat::F32) return 4;
+        if (format == EDDGIVolumeTextureFormat::F16x4 || format == EDDGIVolumeTextureFormat::F32x2) return 8;
+        if (format == EDDGIVolumeTextureFormat::F32x4) return 16;
+        return 0;
+    }
+
+    ERTXGIStatus ValidateDDGIVolumeSnapshot(const void* data, uint64_t size)
+    {
+        const uint8_t* bytes = (const uint8_t*)data;
+
+        DDGIVolumeSnapshotHeader header;
+        ERTXGIStatus status = ValidateSnapshotLayout(bytes, size, header);
+        if (status != ERTXGIStatus::OK) return status;
+
+        for (uint32_t textureIndex = 0; textureIndex < header.numTextures && status == ERTXGIStatus::OK; textureIndex++)
+        {
+            DDGIVolumeSnapshotTexture texture;
+            memcpy(&texture, bytes + sizeof(DDGIVolumeSnapshotHeader) + (textureIndex * sizeof(DDGIVolumeSnapshotTexture)), sizeof(DDGIVolumeSnapshotTexture));
+
+            uint8_t* decoded = new uint8_t[texture.sizeInBytes];
+            uint8_t* scratch = (texture.compression == (uint32_t)EDDGIVolumeSnapshotCompression::LZ) ? new uint8_t[texture.sizeInBytes] : nullptr;
+            status = DecodeSnapshotTexture(bytes, texture, decoded, scratch);
+            delete[] decoded;
+            delete[] scratch;
+        }
+        return status;
+    }
+
+    //------------------------------------------------------------------------
+    // DDGIVolumeSnapshot
+    //------------------------------------------------------------------------
+
+    DDGIVolumeSnapshot::~DDGIVolumeSnapshot()
+    {
+        Release();
+    }
+
+    void DDGIVolumeSnapshot::Release()
+    {
+        for (Texture& texture : m_textures)
+        {
+            delete[] texture.data;
+            texture = Texture();
+        }
+
+        delete[] m_serialized;
+        m_serialized = nullptr;
+        m_serializedSize = 0;
+
+        m_descGPU = {};
+        m_probeScrollOffsets = { 0, 0, 0 };
+    }
+
+    bool DDGIVolumeSnapshot::AllocateTexture(EDDGIVolumeTextureType type, EDDGIVolumeTextureFormat format, uint32_t width, uint32_t height, uint32_t arraySize)
+    {
+        uint32_t texelSize = GetDDGIVolumeTextureFormatSize(format);
+        if (texelSize == 0 || width == 0 || height == 0 || arraySize == 0) return false;
+
+        Texture& texture = m_textures[(int)type];
+        texture.format = format;
+        texture.width = width;
+        texture.height = height;
+        texture.arraySize = arraySize;
+        texture.sizeInBytes = (uint64_t)width * height * arraySize * texelSize;
+        texture.data = new uint8_t[texture.sizeInBytes]();
+        return true;
+    }
+
+    void DDGIVolumeSnapshot::GetTextureDimensions(EDDGIVolumeTextureType type, uint32_t& width, uint32_t& height, uint32_t& arraySize) const
+    {
+        const Texture& texture = m_textures[(int)type];
+        width = texture.width;
+        height = texture.height;
+        arraySize = texture.arraySize;
+    }
+
+    ERTXGIStatus DDGIVolumeSnapshot::Capture(const DDGIVolumeBase* volume)
+    {
+        if (volume == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+        if (volume->GetNumProbes() <= 0) return ERTXGIStatus::ERROR_DDGI_INVALID_PROBE_COUNTS;
+
+        Release();
+
+        m_descGPU = volume->GetDescGPUPacked();
+        m_probeScrollOffsets = volume->GetScrollOffsets();
+
+        DDGIVolumeDesc desc = volume->GetDesc();
+        uint32_t width, height, arraySize;
+
+        GetDDGIVolumeTextureDimensions(desc, EDDGIVolumeTextureType::Irradiance, width, height, arraySize);
+        if (!AllocateTexture(EDDGIVolumeTextureType::Irradiance, desc.probeIrradianceFormat, width, height, arraySize)) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_IRRADIANCE;
+
+        GetDDGIVolumeTextureDimensions(desc, EDDGIVolumeTextureType::Distance, width, height, arraySize);
+        if (!AllocateTexture(EDDGIVolumeTextureType::Distance, desc.probeDistanceFormat, width, height, arraySize)) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_DISTANCE;
+
+        if (desc.probeRelocationEnabled || desc.probeClassificationEnabled)
+        {
+            GetDDGIVolumeTextureDimensions(desc, EDDGIVolumeTextureType::Data, width, height, arraySize);
+            if (!AllocateTexture(EDDGIVolumeTextureType::Data, desc.probeDataFormat, width, height, arraySize)) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_DATA;
+        }
+
+        if (desc.probeVariabilityEnabled)
+        {
+            GetDDGIVolumeTextureDimensions(desc, EDDGIVolumeTextureType::Variability, width, height, arraySize);
+            if (!AllocateTexture(EDDGIVolumeTextureType::Variability, desc.probeVariabilityFormat, width, height, arraySize)) return ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_VARIABILITY;
+        }
+
+        return ERTXGIStatus::OK;
+    }
+
+    ERTXGIStatus DDGIVolumeSnapshot::Serialize(EDDGIVolumeSnapshotCompression compression)
+    {
+        if (compression >= EDDGIVolumeSnapshotCompression::Count) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+        DDGIVolumeSnapshotHeader header = {};
+        header.magic = RTXGI_DDGI_VOLUME_SNAPSHOT_MAGIC;
+        header.version = RTXGI_DDGI_VOLUME_SNAPSHOT_VERSION;
+        header.descGPU = m_descGPU;
+        header.probeScrollOffsets = m_probeScrollOffsets;
+
+        // Size the serialized data for the worst case
+        uint64_t maxTextureSize = 0;
+        uint64_t maxSize = sizeof(DDGIVolumeSnapshotHeader);
+        for (const Texture& texture : m_textures)
+        {
+            if (texture.data == nullptr) continue;
+            header.numTextures++;
+            maxSize += sizeof(DDGIVolumeSnapshotTexture) + GetLZBound(texture.sizeInBytes);
+            if (texture.sizeInBytes > maxTextureSize) maxTextureSize = texture.sizeInBytes;
+        }
+        if (header.numTextures == 0) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+        delete[] m_serialized;
+        m_serialized = new uint8_t[maxSize];
+        m_serializedSize = 0;
+
+        uint8_t* shuffled = nullptr;
+        uint32_t* table = nullptr;
+        if (compression == EDDGIVolumeSnapshotCompression::LZ)
+        {
+            shuffled = new uint8_t[maxTextureSize];
+            table = new uint32_t[1u << LZHashBits];
+        }
+
+        uint8_t* entries = m_serialized + sizeof(DDGIVolumeSnapshotHeader);
+        uint64_t offset = sizeof(DDGIVolumeSnapshotHeader) + (header.numTextures * sizeof(DDGIVolumeSnapshotTexture));
+
+        uint32_t textureIndex = 0;
+        for (uint32_t type = 0; type < (uint32_t)EDDGIVolumeTextureType::Count; type++)
+        {
+            const Texture& texture = m_textures[type];
+            if (texture.data == nullptr) continue;
+
+            DDGIVolumeSnapshotTexture entry = {};
+            entry.type = type;
+            entry.format = (uint32_t)texture.format;
+            entry.width = texture.width;
+            entry.height = texture.height;
+            entry.arraySize = texture.arraySize;
+            entry.compression = (uint32_t)EDDGIVolumeSnapshotCompression::None;
+            entry.offset = offset;
+            entry.sizeInBytes = texture.sizeInBytes;
+            entry.storedSizeInBytes = texture.sizeInBytes;
+            entry.hash = GetDDGIVolumeDataHash(texture.data, (size_t)texture.sizeInBytes);
+
+            if (compression == EDDGIVolumeSnapshotCompression::LZ)
+            {
+                uint32_t texelSize = GetDDGIVolumeTextureFormatSize(texture.format);
+                ShuffleTexels(texture.data, shuffled, texture.sizeInBytes / texelSize, texelSize);
+
+                uint64_t compressedSize = CompressLZ(shuffled, texture.sizeInBytes, m_serialized + offset, table);
+                if (compressedSize < texture.sizeInBytes)
+                {
+                    entry.compression = (uint32_t)EDDGIVolumeSnapshotCompression::LZ;
+                    entry.storedSizeInBytes = compressedSize;
+                }
+            }
+
+            // Store textures that don't compress as-is
+            if (entry.compression == (uint32_t)EDDGIVolumeSnapshotCompression::None) memcpy(m_serialized + offset, texture.data, texture.sizeInBytes);
+
+            memcpy(entries + (textureIndex * sizeof(DDGIVolumeSnapshotTexture)), &entry, sizeof(DDGIVolumeSnapshotTexture));
+            offset += entry.storedSizeInBytes;
+            textureIndex++;
+        }
+
+        delete[] shuffled;
+        delete[] table;
+
+        // Hash the header and texture table
+        header.hash = GetDDGIVolumeDataHash(&header, sizeof(DDGIVolumeSnapshotHeader)) ^ GetDDGIVolumeDataHash(entries, header.numTextures * sizeof(DDGIVolumeSnapshotTexture));
+        memcpy(m_serialized, &header, sizeof(DDGIVolumeSnapshotHeader));
+
+        m_serializedSize = offset;
+        return ERTXGIStatus::OK;
+    }
+
+    ERTXGIStatus DDGIVolumeSnapshot::Deserialize(const void* data, uint64_t size)
+    {
+        const uint8_t* bytes = (const uint8_t*)data;
+
+        DDGIVolumeSnapshotHeader header;
+        ERTXGIStatus status = ValidateSnapshotLayout(bytes, size, header);
+        if (status != ERTXGIStatus::OK) return status;
+
+        Release();
+
+        m_descGPU = header.descGPU;
+        m_probeScrollOffsets = header.probeScrollOffsets;
+
+        uint8_t* scratch = nullptr;
+        for (uint32_t textureIndex = 0; textureIndex < header.numTextures; textureIndex++)
+        {
+            DDGIVolumeSnapshotTexture entry;
+            memcpy(&entry, bytes + sizeof(DDGIVolumeSnapshotHeader) + (textureIndex * sizeof(DDGIVolumeSnapshotTexture)), sizeof(DDGIVolumeSnapshotTexture));
+
+            EDDGIVolumeTextureType type = (EDDGIVolumeTextureType)entry.type;
+            AllocateTexture(type, (EDDGIVolumeTextureFormat)entry.format, entry.width, entry.height, entry.arraySize);
+
+            if (entry.compression == (uint32_t)EDDGIVolumeSnapshotCompression::LZ)
+            {
+                delete[] scratch;
+                scratch = new uint8_t[entry.sizeInBytes];
+            }
+
+            status = DecodeSnapshotTexture(bytes, entry, m_textures[(int)type].data, scratch);
+            if (status != ERTXGIStatus::OK) break;
+        }
+        delete[] scratch;
+
+        if (status != ERTXGIStatus::OK) Release();
+        return status;
+    }
+
+    ERTXGIStatus DDGIVolumeSnapshot::ValidateVolume(const DDGIVolumeBase* volume) const
+    {
+        if (volume == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+        if (m_textures[(int)EDDGIVolumeTextureType::Irradiance].data == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT;
+
+        DDGIVolumeDescGPU snapshot = GetDescGPU();
+        DDGIVolumeDesc desc = volume->GetDesc();
+
+        if (snapshot.movementType != (uint32_t)desc.movementType) return ERTXGIStatus::ERROR_DDGI_SNAPSHOT_INCOMPATIBLE_VOLUME;
+        if (snapshot.probeCounts.x != desc.probeCounts.x || snapshot.probeCounts.y != desc.probeCounts.y || snapshot.probeCounts.z != desc.probeCounts.z) return ERTXGIStatus::ERROR_DDGI_SNAPSHOT_INCOMPATIBLE_VOLUME;
+        if (snapshot.probeSpacing.x != desc.probeSpacing.x || snapshot.probeSpacing.y != desc.probeSpacing.y || snapshot.probeSpacing.z != desc.probeSpacing.z) return ERTXGIStatus::ERROR_DDGI_SNAPSHOT_INCOMPATIBLE_VOLUME;
+        if (snapshot.probeNumIrradianceInteriorTexels != desc.probeNumIrradianceInteriorTexels) return ERTXGIStatus::ERROR_DDGI_SNAPSHOT_INCOMPATIBLE_VOLUME;
+        if (snapshot.probeNumDistanceInteriorTexels != desc.probeNumDistanceInteriorTexels) return ERTXGIStatus::ERROR_DDGI_SNAPSHOT_INCOMPATIBLE_VOLUME;
+
+        // Volumes that don't scroll place their probes with the volume's rotation (q and -q are the same rotation)
+        if (desc.movementType == EDDGIVolumeMovementType::Default)
+        {
+            float4 a = snapshot.rotation;
+            float4 b = volume->GetDescGPU().rotation;
+            if (abs((a.x * b.x) + (a.y * b.y) + (a.z * b.z) + (a.w * b.w)) < 0.99999f) return ERTXGIStatus::ERROR_DDGI_SNAPSHOT_INCOMPATIBLE_VOLUME;
+        }
+
+        const EDDGIVolumeTextureFormat formats[] =
+        {
+            desc.probeRayDataFormat,
+            desc.probeIrradianceFormat,
+            desc.probeDistanceFormat,
+            desc.probeDataFormat,
+            desc.probeVariabilityFormat,
+            EDDGIVolumeTextureFormat::Count
+        };
+
+        for (uint32_t type = 0; type < (uint32_t)EDDGIVolumeTextureType::Count; type++)
+        {
+            if (m_textures[type].data == nullptr) continue;
+            if (m_textures[type].format != formats[type]) return ERTXGIStatus::ERROR_DDGI_SNAPSHOT_INCOMPATIBLE_VOLUME;
+        }
+
+        return ERTXGIStatus::OK;
+    }
+
+    ERTXGIStatus DDGIVolumeSnapshot::Restore(DDGIVolumeBase* volume) const
+    {
+        ERTXGIStatus status = ValidateVolume(volume);
+        if (status != ERTXGIStatus::OK) return status;
+
+        DDGIVolumeDescGPU snapshot = GetDescGPU();
+
+        volume->SetOrigin(snapshot.origin);
+        if (volume->GetMovementType() == EDDGIVolumeMovementType::Scrolling)
+        {
+            volume->SetScrollOffsets(m_probeScrollOffsets);
+            volume->SetScrollAnchor(volume->GetOrigin());
+        }
+
+        // Keep the probe relocation offsets and classification states of the snapshot
+        if (HasTexture(EDDGIVolumeTextureType::Data))
+        {
+            if (snapshot.probeRelocationEnabled) volume->SetProbeRelocationNeedsReset(false);
+            if (snapshot.probeClassificationEnabled) volume->SetProbeClassificationNeedsReset(false);
+        }
+
+        return ERTXGIStatus::OK;
+    }
+
+} // namespace rtxgi
@@ -0,0 +1,205 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "rtxgi/ddgi/DDGIVolumeUpdate.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rtxgi
+{
+
+    //------------------------------------------------------------------------
+    // DDGIThreadPool
+    //------------------------------------------------------------------------
+
+    /**
+     * A range of job indices owned by one thread. Other threads steal from the range once their own is empty.
+     * Aligned to a cache line so threads claiming jobs from different ranges don't contend.
+     */
+    struct alignas(64) DDGIJobRange
+    {
+        std::atomic<uint32_t> next;
+        uint32_t              end = 0;
+    };
+
+    struct DDGIThreadPoolState
+    {
+        std::vector<std::thread>        threads;
+        std::unique_ptr<DDGIJobRange[]> ranges;
+
+        std::mutex                      runMutex;           // Serializes calls to Run()
+        std::mutex                      mutex;              // Guards the members below
+        std::condition_variable         wake;               // Signals the workers that jobs are available (or to quit)
+        std::condition_variable         done;               // Signals Run() that all workers have finished
+
+        uint64_t                        generation = 0;     // Incremented by each Run() that wakes the workers
+        uint32_t                        numWorking = 0;     // Number of workers still running the current generation's jobs
+        bool                            quit = false;
+
+        DDGIJobFunction                 function = nullptr;
+        void*                           context = nullptr;
+    };
+
+    namespace
+    {
+        void RunJobs(DDGIThreadPoolState& state, uint32_t numRanges, uint32_t threadIndex)
+        {
+            // Run the jobs of the thread's own range, then steal from the other ranges
+            for (uint32_t rangeOffset = 0; rangeOffset < numRanges; rangeOffset++)
+            {
+                DDGIJobRange& range = state.ranges[(threadIndex + rangeOffset) % numRanges];
+                for (;;)
+                {
+                    uint32_t jobIndex = range.next.fetch_add(1, std::memory_order_relaxed);
+                    if (jobIndex >= range.end) break;
+                    state.function(jobIndex, state.context);
+                }
+            }
+        }
+
+        void WorkerThread(DDGIThreadPoolState* state, uint32_t numRanges, uint32_t threadIndex)
+        {
+            uint64_t generation = 0;
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(state->mutex);
+                    state->wake.wait(lock, [&]() { return state->quit || state->generation != generation; });
+                    if (state->quit) return;
+                    generation = state->generation;
+                }
+
+                RunJobs(*state, numRanges, threadIndex);
+
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (--state->numWorking == 0) state->done.notify_one();
+            }
+        }
+    }
+
+    DDGIThreadPool::DDGIThreadPool(uint32_t numThreads)
+    {
+        if (numThreads == 0) numThreads = std::max(1u, std::thread::hardware_concurrency());
+        m_numThreads = numThreads;
+
+        m_state = new DDGIThreadPoolState();
+        m_state->ranges.reset(new DDGIJobRange[numThreads]);
+        m_state->threads.reserve(numThreads - 1);
+        for (uint32_t threadIndex = 1; threadIndex < numThreads; threadIndex++)
+        {
+            m_state->threads.emplace_back(WorkerThread, m_state, numThreads, threadIndex);
+        }
+    }
+
+    DDGIThreadPool::~DDGIThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            m_state->quit = true;
+        }
+        m_state->wake.notify_all();
+        for (std::thread& thread : m_state->threads) thread.join();
+
+        delete m_state;
+    }
+
+    void DDGIThreadPool::Run(uint32_t numJobs, DDGIJobFunction function, void* context)
+    {
+        if (numJobs == 0 || function == nullptr) return;
+
+        // Run small workloads on the calling thread
+        if (m_numThreads == 1 || numJobs == 1)
+        {
+            for (uint32_t jobIndex = 0; jobIndex < numJobs; jobIndex++) function(jobIndex, context);
+            return;
+        }
+
+        std::lock_guard<std::mutex> runLock(m_state->runMutex);
+
+        // Split the jobs into one contiguous range per thread
+        for (uint32_t threadIndex = 0; threadIndex < m_numThreads; threadIndex++)
+        {
+            DDGIJobRange& range = m_state->ranges[threadIndex];
+            range.next.store((uint32_t)(((uint64_t)numJobs * threadIndex) / m_numThreads), std::memory_order_relaxed);
+            range.end = (uint32_t)(((uint64_t)numJobs * (threadIndex + 1)) / m_numThreads);
+        }
+
+        // Wake the workers
+        {
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            m_state->function = function;
+            m_state->context = context;
+            m_state->numWorking = m_numThreads - 1;
+            m_state->generation++;
+        }
+        m_state->wake.notify_all();
+
+        // The calling thread runs jobs too
+        RunJobs(*m_state, m_numThreads, 0);
+
+        // Wait for the workers to finish
+        std::unique_lock<std::mutex> lock(m_state->mutex);
+        m_state->done.wait(lock, [&]() { return m_state->numWorking == 0; });
+    }
+
+    //------------------------------------------------------------------------
+    // Public RTXGI Namespace DDGI Functions
+    //------------------------------------------------------------------------
+
+    namespace
+    {
+        const uint32_t c_volumesPerJob = 8;
+
+        struct DDGIVolumeUpdateContext
+        {
+            uint32_t                 numVolumes;
+            DDGIVolumeBase* const*   volumes;
+            const uint32_t*          volumeIndices;
+            DDGIVolumeDescGPUPacked* packedDescs;
+        };
+
+        void UpdateVolumes(uint32_t jobIndex, void* data)
+        {
+            const DDGIVolumeUpdateContext& context = *(const DDGIVolumeUpdateContext*)data;
+
+            uint32_t first = jobIndex * c_volumesPerJob;
+            uint32_t last = std::min(first + c_volumesPerJob, context.numVolumes);
+            for (uint32_t index = first; index < last; index++)
+            {
+                DDGIVolumeBase* volume = context.volumes[context.volumeIndices ? context.volumeIndices[index] : index];
+                volume->Update();
+                if (context.packedDescs) context.packedDescs[index] = volume->GetDescGPUPacked();
+            }
+        }
+    }
+
+    ERTXGIStatus UpdateDDGIVolumes(DDGIJobSystem& jobSystem, uint32_t numVolumes, DDGIVolumeBase* const* volumes, const uint32_t* volumeIndices, DDGIVolumeDescGPUPacked* packedDescs)
+    {
+        if (numVolumes == 0) return ERTXGIStatus::OK;
+        if (volumes == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+
+        for (uint32_t index = 0; index < numVolumes; index++)
+        {
+            if (volumes[volumeIndices ? volumeIndices[index] : index] == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+        }
+
+        DDGIVolumeUpdateContext context = { numVolumes, volumes, volumeIndices, packedDescs };
+        jobSystem.Run((numVolumes + c_volumesPerJob - 1) / c_volumesPerJob, UpdateVolumes, &context);
+
+        return ERTXGIStatus::OK;
+    }
+
+} // namespace rtxgi
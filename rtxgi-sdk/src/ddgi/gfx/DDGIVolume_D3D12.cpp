@@ -14,6 +14,7 @@
 #include <pix.h>
 #endif
 
+#include <algorithm>
 #include <random>
 #include <string>
 #include <vector>
@@ -75,6 +76,228 @@ namespace rtxgi
             return ERTXGIStatus::OK;
         }
 
+        /**
+         * Resets the probe relocation data of volumes that have the reset flag set.
+         */
+        void ResetDDGIVolumeProbeRelocation(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes)
+        {
+            UINT volumeIndex;
+            std::vector<D3D12_RESOURCE_BARRIER> barriers;
+
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+
+            // Probe Relocation Reset
+            for(volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                // Get the volume
+                const DDGIVolume* volume = volumes[volumeIndex];
+                if (!volume->GetProbeRelocationNeedsReset()) continue;  // Skip if the volume doesn't need to be reset
+
+                // Set the descriptor heap(s)
+                std::vector<ID3D12DescriptorHeap*> heaps;
+                heaps.push_back(volume->GetResourceDescriptorHeap());
+                if (volume->GetSamplerDescriptorHeap()) heaps.push_back(volume->GetSamplerDescriptorHeap());
+                cmdList->SetDescriptorHeaps((UINT)heaps.size(), heaps.data());
+
+                // Set root signature and root constants
+                cmdList->SetComputeRootSignature(volume->GetRootSignature());
+                cmdList->SetComputeRoot32BitConstants(volume->GetRootParamSlotRootConstants(), DDGIRootConstants::GetNum32BitValues(), volume->GetRootConstants().GetData(), 0);
+
+                // Set the descriptor tables (when relevant)
+                if (volume->GetBindlessEnabled())
+                {
+                    // Bindless resources, using application's root signature
+                    if (volume->GetBindlessType() == EBindlessType::RESOURCE_ARRAYS)
+                    {
+                        // Only need to set descriptor tables when using traditional resource array bindless
+                        cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotResourceDescriptorTable(), volume->GetResourceDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
+                        if (volume->GetSamplerDescriptorHeap()) cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotSamplerDescriptorTable(), volume->GetSamplerDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
+                    }
+                }
+                else
+                {
+                    // Bound resources, using the SDK's root signature
+                    cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotResourceDescriptorTable(), volume->GetResourceDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
+                }
+
+                // Reset all probe offsets to zero
+                const float groupSizeX = 32.f;
+                UINT numGroupsX = (UINT)ceil((float)volume->GetNumProbes() / groupSizeX);
+                cmdList->SetPipelineState(volume->GetProbeRelocationResetPSO());
+                cmdList->Dispatch(numGroupsX, 1, 1);
+
+                // Update the reset flag
+                volumes[volumeIndex]->SetProbeRelocationNeedsReset(false);
+
+                // Add a barrier
+                barrier.UAV.pResource = volume->GetProbeData();
+                barriers.push_back(barrier);
+            }
+
+            // Probe Relocation Reset Barrier(s)
+            if (!barriers.empty()) cmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+        }
+
+        /**
+         * Resets the probe classification data of volumes that have the reset flag set.
+         */
+        void ResetDDGIVolumeProbeClassification(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes)
+        {
+            UINT volumeIndex;
+            std::vector<D3D12_RESOURCE_BARRIER> barriers;
+
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+
+            // Probe Classification Reset
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                const DDGIVolume* volume = volumes[volumeIndex];
+                if (!volume->GetProbeClassificationNeedsReset()) continue;  // Skip if the volume doesn't need to be reset
+
+                // Set the descriptor heap(s)
+                std::vector<ID3D12DescriptorHeap*> heaps;
+                heaps.push_back(volume->GetResourceDescriptorHeap());
+                if (volume->GetSamplerDescriptorHeap()) heaps.push_back(volume->GetSamplerDescriptorHeap());
+                cmdList->SetDescriptorHeaps((UINT)heaps.size(), heaps.data());
+
+                // Set root signature and root constants
+                cmdList->SetComputeRootSignature(volume->GetRootSignature());
+                cmdList->SetComputeRoot32BitConstants(volume->GetRootParamSlotRootConstants(), DDGIRootConstants::GetNum32BitValues(), volume->GetRootConstants().GetData(), 0);
+ 
+                // Set the descriptor tables (when relevant)
+                if (volume->GetBindlessEnabled())
+                {
+                    // Bindless resources, using application's root signature
+                    if (volume->GetBindlessType() == EBindlessType::RESOURCE_ARRAYS)
+                    {
+                        // Only need to set descriptor tables when using traditional resource array bindless
+                        cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotResourceDescriptorTable(), volume->GetResourceDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
+                        if (volume->GetSamplerDescriptorHeap()) cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotSamplerDescriptorTable(), volume->GetSamplerDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
+                    }
+                }
+                else
+                {
+                    // Bound resources, using the SDK's root signature
+                    cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotResourceDescriptorTable(), volume->GetResourceDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
+                }
+
+                // Reset all probe offsets to zero
+                const float groupSizeX = 32.f;
+                UINT numGroupsX = (UINT)ceil((float)volume->GetNumProbes() / groupSizeX);
+                cmdList->SetPipelineState(volume->GetProbeClassificationResetPSO());
+                cmdList->Dispatch(numGroupsX, 1, 1);
+
+                // Update the reset flag
+                volumes[volumeIndex]->SetProbeClassificationNeedsReset(false);
+
+                // Add a barrier
+                barrier.UAV.pResource = volume->GetProbeData();
+                barriers.push_back(barrier);
+            }
+
+            // Probe Classification Reset Barrier(s)
+            if (!barriers.empty()) cmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+        }
+
+        /**
+         * Validates the volumes and batches of a merged dispatch.
+         */
+        ERTXGIStatus ValidateMergedDispatch(UINT numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch)
+        {
+            for (UINT volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                if (volumes[volumeIndex] == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+                if (!volumes[volumeIndex]->GetBindlessEnabled()) return ERTXGIStatus::ERROR_DDGI_MERGED_DISPATCH_REQUIRES_BINDLESS_RESOURCES;
+            }
+
+            for (UINT passIndex = 0; passIndex < (UINT)EDDGIMergedDispatchPass::Count; passIndex++)
+            {
+                EDDGIMergedDispatchPass pass = (EDDGIMergedDispatchPass)passIndex;
+                const DDGIMergedDispatchBatch* batches = mergedDispatch.GetBatches(pass);
+                for (UINT batchIndex = 0; batchIndex < mergedDispatch.GetNumBatches(pass); batchIndex++)
+                {
+                    if (batches[batchIndex].volume >= numVolumes) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+                }
+            }
+
+            return ERTXGIStatus::OK;
+        }
+
+        /**
+         * Sets the descriptor heaps, root signature, and the given root constants of a volume for a bindless compute dispatch.
+         */
+        void SetBindlessComputeRootArguments(ID3D12GraphicsCommandList* cmdList, const DDGIVolume* volume, const DDGIRootConstants& consts)
+        {
+            // Set the descriptor heap(s)
+            std::vector<ID3D12DescriptorHeap*> heaps;
+            heaps.push_back(volume->GetResourceDescriptorHeap());
+            if (volume->GetSamplerDescriptorHeap()) heaps.push_back(volume->GetSamplerDescriptorHeap());
+            cmdList->SetDescriptorHeaps((UINT)heaps.size(), heaps.data());
+
+            // Set root signature and root constants
+            cmdList->SetComputeRootSignature(volume->GetRootSignature());
+            cmdList->SetComputeRoot32BitConstants(volume->GetRootParamSlotRootConstants(), DDGIRootConstants::GetNum32BitValues(), consts.GetData(), 0);
+
+            // Only need to set descriptor tables when using traditional resource array bindless
+            if (volume->GetBindlessType() == EBindlessType::RESOURCE_ARRAYS)
+            {
+                cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotResourceDescriptorTable(), volume->GetResourceDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
+                if (volume->GetSamplerDescriptorHeap()) cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotSamplerDescriptorTable(), volume->GetSamplerDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
+            }
+        }
+
+        /**
+         * Dispatches a batch of a merged probe dispatch with the root signature and descriptor heaps of the batch's volume.
+         */
+        void DispatchMergedBatch(ID3D12GraphicsCommandList* cmdList, const DDGIVolume* volume, const DDGIMergedDispatchBatch& batch, UINT tableDescriptorHeapIndex, ID3D12PipelineState* pso)
+        {
+            // Set the root arguments (with the batch's range of the dispatch table)
+            SetBindlessComputeRootArguments(cmdList, volume, GetDDGIMergedDispatchRootConstants(batch, volume->GetRootConstants(), tableDescriptorHeapIndex));
+
+            // Set the PSO and dispatch threads
+            cmdList->SetPipelineState(pso);
+            cmdList->Dispatch(batch.numGroupsX, batch.numGroupsY, 1);
+        }
+
+        /**
+         * Validates the volumes and resources of probe compaction.
+         */
+        ERTXGIStatus ValidateProbeCompaction(UINT numVolumes, DDGIVolume** volumes, const DDGIProbeCompactionResources& resources)
+        {
+            if (resources.buffer == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_PROBE_COMPACTION_BUFFER;
+
+            UINT64 sizeInBytes = 0;
+            for (UINT volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                if (volumes[volumeIndex] == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+                if (!volumes[volumeIndex]->GetBindlessEnabled()) return ERTXGIStatus::ERROR_DDGI_PROBE_COMPACTION_REQUIRES_BINDLESS_RESOURCES;
+                sizeInBytes += GetDDGIProbeCompactionRegionSizeInBytes(volumes[volumeIndex]);
+            }
+
+            // The buffer must hold the regions of all volumes
+            if (sizeInBytes > resources.buffer->GetDesc().Width) return ERTXGIStatus::ERROR_DDGI_INVALID_PROBE_COMPACTION_BUFFER;
+
+            return ERTXGIStatus::OK;
+        }
+
+        /**
+         * Transitions the probe compaction buffer between compaction (unordered access) and indirect dispatch / shader read states.
+         */
+        void TransitionProbeCompactionBuffer(ID3D12GraphicsCommandList* cmdList, ID3D12Resource* buffer, bool toIndirectArgument)
+        {
+            const D3D12_RESOURCE_STATES indirectStates = (D3D12_RESOURCE_STATE_INDIRECT_ARGUMENT | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE);
+
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            barrier.Transition.pResource = buffer;
+            barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            barrier.Transition.StateBefore = toIndirectArgument ? D3D12_RESOURCE_STATE_UNORDERED_ACCESS : indirectStates;
+            barrier.Transition.StateAfter = toIndirectArgument ? indirectStates : D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+            cmdList->ResourceBarrier(1, &barrier);
+        }
+
         //------------------------------------------------------------------------
         // Public RTXGI D3D12 Namespace Functions
         //------------------------------------------------------------------------
@@ -114,6 +337,21 @@ namespace rtxgi
             return DXGI_FORMAT_UNKNOWN;
         }
 
+        /**
+         * Get the offset (in bytes) of a slot in a probe variability readback buffer.
+         * Texture to buffer copy destinations must be aligned to D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT.
+         */
+        UINT64 GetVariabilityReadbackSlotOffset(UINT slot)
+        {
+            return (UINT64)slot * D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT;
+        }
+
+        UINT64 GetDDGIVolumeVariabilityReadbackSizeInBytes()
+        {
+            // Each slot stores one R32G32 texel
+            return GetVariabilityReadbackSlotOffset(RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE - 1) + (sizeof(float) * 2);
+        }
+
         bool GetDDGIVolumeRootSignatureDesc(const DDGIVolumeDescriptorHeapDesc& heapDesc, ID3DBlob*& signature)
         {
             // Resource Descriptor Table
@@ -216,92 +454,219 @@ namespace rtxgi
             return true;
         }
 
+        /**
+         * Describes a copy from an upload buffer to a device buffer.
+         */
+        struct BufferCopyRegion
+        {
+            UINT64 srcOffset;
+            UINT64 dstOffset;
+            UINT64 size;
+        };
+
+        /**
+         * Sorts buffer copy regions by offset and merges regions that are contiguous in both buffers.
+         */
+        void MergeBufferCopyRegions(std::vector<BufferCopyRegion>& regions)
+        {
+            if (regions.size() < 2) return;
+
+            std::sort(regions.begin(), regions.end(), [](const BufferCopyRegion& a, const BufferCopyRegion& b) { return a.srcOffset < b.srcOffset; });
+
+            size_t numRegions = 1;
+            for (size_t regionIndex = 1; regionIndex < regions.size(); regionIndex++)
+            {
+                BufferCopyRegion& last = regions[numRegions - 1];
+                const BufferCopyRegion& region = regions[regionIndex];
+                if ((last.srcOffset + last.size) == region.srcOffset && (last.dstOffset + last.size) == region.dstOffset)
+                {
+                    last.size += region.size;
+                    continue;
+                }
+                regions[numRegions++] = region;
+            }
+            regions.resize(numRegions);
+        }
+
         ERTXGIStatus UploadDDGIVolumeResourceIndices(ID3D12GraphicsCommandList* cmdList, UINT bufferingIndex, UINT numVolumes, DDGIVolume** volumes)
         {
-            // Copy the resource indices for each volume
-            for (UINT volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            std::vector<BufferCopyRegion> regions;
+            regions.reserve(numVolumes);
+
+            UINT volumeIndex = 0;
+            while (volumeIndex < numVolumes)
             {
-                // Get the volume
-                const DDGIVolume* volume = volumes[volumeIndex];
+                // Get the first volume of the batch
+                const DDGIVolume* first = volumes[volumeIndex];
 
                 // Validate the upload and device buffers
-                if (volume->GetResourceIndicesBuffer() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_RESOURCE_INDICES_BUFFER;
-                if (volume->GetResourceIndicesBufferUpload() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_RESOURCE_INDICES_UPLOAD_BUFFER;
+                if (first->GetResourceIndicesBuffer() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_RESOURCE_INDICES_BUFFER;
+                if (first->GetResourceIndicesBufferUpload() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_RESOURCE_INDICES_UPLOAD_BUFFER;
 
-                // Map the resource indices buffer and update it
-                UINT8* pData = nullptr;
-                HRESULT hr = volume->GetResourceIndicesBufferUpload()->Map(0, nullptr, reinterpret_cast<void**>(&pData));
-                if (FAILED(hr)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_RESOURCE_INDICES_UPLOAD_BUFFER;
+                // Find the consecutive volumes that share the same upload and device buffers
+                UINT batchEnd = volumeIndex + 1;
+                while (batchEnd < numVolumes
+                    && volumes[batchEnd]->GetResourceIndicesBuffer() == first->GetResourceIndicesBuffer()
+                    && volumes[batchEnd]->GetResourceIndicesBufferUpload() == first->GetResourceIndicesBufferUpload()) batchEnd++;
 
                 // Offset to the resource indices data to write to (e.g. double buffering)
-                UINT64 bufferOffset = volume->GetResourceIndicesBufferSizeInBytes() * bufferingIndex;
+                UINT64 bufferOffset = first->GetResourceIndicesBufferSizeInBytes() * bufferingIndex;
 
-                // Offset to the volume in current resource indices buffer
-                UINT volumeOffset = (volume->GetIndex() * sizeof(DDGIVolumeResourceIndices));
+                // Use the persistently mapped upload buffer when available, otherwise map the buffer (once for the batch) when the first changed volume is found
+                UINT8* pData = first->GetResourceIndicesBufferUploadPtr();
+                bool mapped = false;
 
-                // Offset to the volume resource indices in the upload buffer
-                UINT64 srcOffset = (bufferOffset + volumeOffset);
+                regions.clear();
+                for (; volumeIndex < batchEnd; volumeIndex++)
+                {
+                    // Get the volume
+                    DDGIVolume* volume = volumes[volumeIndex];
 
-                // Get the DDGIVolume's bindless resource indices
-                DDGIVolumeResourceIndices resourceIndices = volume->GetResourceIndices();
+                    // Get the DDGIVolume's bindless resource indices, skip the volume if they haven't changed since the last upload
+                    const DDGIVolumeResourceIndices resourceIndices = volume->GetResourceIndices();
+                    uint64_t hash = GetDDGIVolumeDataHash(&resourceIndices, sizeof(DDGIVolumeResourceIndices));
+                    if (hash == volume->GetResourceIndicesHash()) continue;
+
+                    if (pData == nullptr)
+                    {
+                        HRESULT hr = first->GetResourceIndicesBufferUpload()->Map(0, nullptr, reinterpret_cast<void**>(&pData));
+                        if (FAILED(hr)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_RESOURCE_INDICES_UPLOAD_BUFFER;
+                        mapped = true;
+                    }
 
-                pData += srcOffset;
-                memcpy(pData, &resourceIndices, sizeof(DDGIVolumeResourceIndices));
+                    // Offset to the volume in current resource indices buffer
+                    UINT volumeOffset = (volume->GetIndex() * sizeof(DDGIVolumeResourceIndices));
 
-                volume->GetResourceIndicesBufferUpload()->Unmap(0, nullptr);
+                    // Offset to the volume resource indices in the upload buffer
+                    UINT64 srcOffset = (bufferOffset + volumeOffset);
 
-                // Schedule a copy of the upload buffer to the device buffer
-                cmdList->CopyBufferRegion(volume->GetResourceIndicesBuffer(), volumeOffset, volume->GetResourceIndicesBufferUpload(), srcOffset, sizeof(DDGIVolumeResourceIndices));
+                    memcpy(pData + srcOffset, &resourceIndices, sizeof(DDGIVolumeResourceIndices));
+                    regions.push_back({ srcOffset, volumeOffset, sizeof(DDGIVolumeResourceIndices) });
+
+                    volume->SetResourceIndicesHash(hash);
+                }
+
+                if (mapped) first->GetResourceIndicesBufferUpload()->Unmap(0, nullptr);
+
+                // Schedule copies of the changed regions of the upload buffer to the device buffer (contiguous regions are copied together)
+                MergeBufferCopyRegions(regions);
+                for (const BufferCopyRegion& region : regions)
+                {
+                    cmdList->CopyBufferRegion(first->GetResourceIndicesBuffer(), region.dstOffset, first->GetResourceIndicesBufferUpload(), region.srcOffset, region.size);
+                }
             }
 
             return ERTXGIStatus::OK;
         }
 
-        ERTXGIStatus UploadDDGIVolumeConstants(ID3D12GraphicsCommandList* cmdList, UINT bufferingIndex, UINT numVolumes, DDGIVolume** volumes)
+        ERTXGIStatus UploadDDGIVolumeConstants(ID3D12GraphicsCommandList* cmdList, UINT bufferingIndex, UINT numVolumes, DDGIVolume** volumes, const DDGIVolumeDescGPUPacked* packedDescs)
         {
-            // Copy the constants for each volume
-            for(UINT volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            std::vector<BufferCopyRegion> regions;
+            regions.reserve(numVolumes);
+
+            UINT volumeIndex = 0;
+            while (volumeIndex < numVolumes)
             {
-                // Get the volume
-                const DDGIVolume* volume = volumes[volumeIndex];
+                // Get the first volume of the batch
+                const DDGIVolume* first = volumes[volumeIndex];
 
                 // Validate the upload and device buffers
-                if (volume->GetConstantsBuffer() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_CONSTANTS_BUFFER;
-                if (volume->GetConstantsBufferUpload() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_CONSTANTS_UPLOAD_BUFFER;
+                if (first->GetConstantsBuffer() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_CONSTANTS_BUFFER;
+                if (first->GetConstantsBufferUpload() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_CONSTANTS_UPLOAD_BUFFER;
 
-                // Map the constant buffer and update it
-                UINT8* pData = nullptr;
-                HRESULT hr = volume->GetConstantsBufferUpload()->Map(0, nullptr, reinterpret_cast<void**>(&pData));
-                if (FAILED(hr)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_CONSTANTS_UPLOAD_BUFFER;
+                // Find the consecutive volumes that share the same upload and device buffers
+                UINT batchEnd = volumeIndex + 1;
+                while (batchEnd < numVolumes
+                    && volumes[batchEnd]->GetConstantsBuffer() == first->GetConstantsBuffer()
+                    && volumes[batchEnd]->GetConstantsBufferUpload() == first->GetConstantsBufferUpload()) batchEnd++;
 
                 // Offset to the constants data to write to (e.g. double buffering)
-                UINT64 bufferOffset = volume->GetConstantsBufferSizeInBytes() * bufferingIndex;
+                UINT64 bufferOffset = first->GetConstantsBufferSizeInBytes() * bufferingIndex;
+
+                // Use the persistently mapped upload buffer when available, otherwise map the buffer (once for the batch) when the first changed volume is found
+                UINT8* pData = first->GetConstantsBufferUploadPtr();
+                bool mapped = false;
+
+                regions.clear();
+                for (; volumeIndex < batchEnd; volumeIndex++)
+                {
+                    // Get the volume
+                    DDGIVolume* volume = volumes[volumeIndex];
 
-                // Offset to the volume in current constants buffer
-                UINT volumeOffset = (volume->GetIndex() * sizeof(DDGIVolumeDescGPUPacked));
+                    // Get the packed DDGIVolume GPU descriptor, skip the volume if it hasn't changed since the last upload
+                    const DDGIVolumeDescGPUPacked gpuDesc = packedDescs ? packedDescs[volumeIndex] : volume->GetDescGPUPacked();
+                    uint64_t hash = GetDDGIVolumeDataHash(&gpuDesc, sizeof(DDGIVolumeDescGPUPacked));
+                    if (hash == volume->GetConstantsHash()) continue;
+
+                #ifdef _DEBUG
+                    volume->ValidatePackedData(gpuDesc);
+                #endif
+
+                    if (pData == nullptr)
+                    {
+                        HRESULT hr = first->GetConstantsBufferUpload()->Map(0, nullptr, reinterpret_cast<void**>(&pData));
+                        if (FAILED(hr)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_CONSTANTS_UPLOAD_BUFFER;
+                        mapped = true;
+                    }
 
-                // Offset to the volume constants in the upload buffer
-                UINT64 srcOffset = (bufferOffset + volumeOffset);
+                    // Offset to the volume in current constants buffer
+                    UINT volumeOffset = (volume->GetIndex() * sizeof(DDGIVolumeDescGPUPacked));
 
-                // Get the packed DDGIVolume GPU descriptor
-                const DDGIVolumeDescGPUPacked gpuDesc = volume->GetDescGPUPacked();
+                    // Offset to the volume constants in the upload buffer
+                    UINT64 srcOffset = (bufferOffset + volumeOffset);
 
-            #ifdef _DEBUG
-                volume->ValidatePackedData(gpuDesc);
-            #endif
+                    memcpy(pData + srcOffset, &gpuDesc, sizeof(DDGIVolumeDescGPUPacked));
+                    regions.push_back({ srcOffset, volumeOffset, sizeof(DDGIVolumeDescGPUPacked) });
 
-                pData += srcOffset;
-                memcpy(pData, &gpuDesc, sizeof(DDGIVolumeDescGPUPacked));
+                    volume->SetConstantsHash(hash);
+                }
 
-                volume->GetConstantsBufferUpload()->Unmap(0, nullptr);
+                if (mapped) first->GetConstantsBufferUpload()->Unmap(0, nullptr);
 
-                // Schedule a copy of the upload buffer to the device buffer
-                cmdList->CopyBufferRegion(volume->GetConstantsBuffer(), volumeOffset, volume->GetConstantsBufferUpload(), srcOffset, sizeof(DDGIVolumeDescGPUPacked));
+                // Schedule copies of the changed regions of the upload buffer to the device buffer (contiguous regions are copied together)
+                MergeBufferCopyRegions(regions);
+                for (const BufferCopyRegion& region : regions)
+                {
+                    cmdList->CopyBufferRegion(first->GetConstantsBuffer(), region.dstOffset, first->GetConstantsBufferUpload(), region.srcOffset, region.size);
+                }
             }
 
             return ERTXGIStatus::OK;
         }
 
+        ERTXGIStatus UploadDDGIMergedDispatchTable(ID3D12GraphicsCommandList* cmdList, UINT bufferingIndex, const DDGIMergedDispatch& mergedDispatch, const DDGIMergedDispatchResources& resources)
+        {
+            // Validate the upload and device buffers
+            if (resources.tableBuffer == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_MERGED_DISPATCH_TABLE_BUFFER;
+            if (resources.tableBufferUpload == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_MERGED_DISPATCH_TABLE_UPLOAD_BUFFER;
+
+            UINT64 sizeInBytes = mergedDispatch.GetEntriesSizeInBytes();
+            if (sizeInBytes > resources.tableBufferSizeInBytes) return ERTXGIStatus::ERROR_DDGI_INVALID_MERGED_DISPATCH_TABLE_BUFFER;
+            if (sizeInBytes == 0) return ERTXGIStatus::OK;
+
+            // Offset to the table data to write to (e.g. double buffering)
+            UINT64 bufferOffset = resources.tableBufferSizeInBytes * bufferingIndex;
+
+            // Use the persistently mapped upload buffer when available, otherwise map the buffer
+            UINT8* pData = resources.tableBufferUploadPtr;
+            bool mapped = false;
+            if (pData == nullptr)
+            {
+                HRESULT hr = resources.tableBufferUpload->Map(0, nullptr, reinterpret_cast<void**>(&pData));
+                if (FAILED(hr)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_MERGED_DISPATCH_TABLE_UPLOAD_BUFFER;
+                mapped = true;
+            }
+
+            memcpy(pData + bufferOffset, mergedDispatch.GetEntries(), (size_t)sizeInBytes);
+
+            if (mapped) resources.tableBufferUpload->Unmap(0, nullptr);
+
+            // Schedule a copy of the upload buffer to the device buffer
+            cmdList->CopyBufferRegion(resources.tableBuffer, 0, resources.tableBufferUpload, bufferOffset, sizeInBytes);
+
+            return ERTXGIStatus::OK;
+        }
+
         ERTXGIStatus UpdateDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes)
         {
             if (bInsertPerfMarkers) PIXBeginEvent(cmdList, PIX_COLOR(RTXGI_PERF_MARKER_GREEN), "RTXGI DDGI Update Probes");
@@ -453,59 +818,7 @@ namespace rtxgi
             barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
 
             // Probe Relocation Reset
-            for(volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
-            {
-                // Get the volume
-                const DDGIVolume* volume = volumes[volumeIndex];
-                if (!volume->GetProbeRelocationNeedsReset()) continue;  // Skip if the volume doesn't need to be reset
-
-                // Set the descriptor heap(s)
-                std::vector<ID3D12DescriptorHeap*> heaps;
-                heaps.push_back(volume->GetResourceDescriptorHeap());
-                if (volume->GetSamplerDescriptorHeap()) heaps.push_back(volume->GetSamplerDescriptorHeap());
-                cmdList->SetDescriptorHeaps((UINT)heaps.size(), heaps.data());
-
-                // Set root signature and root constants
-                cmdList->SetComputeRootSignature(volume->GetRootSignature());
-                cmdList->SetComputeRoot32BitConstants(volume->GetRootParamSlotRootConstants(), DDGIRootConstants::GetNum32BitValues(), volume->GetRootConstants().GetData(), 0);
-
-                // Set the descriptor tables (when relevant)
-                if (volume->GetBindlessEnabled())
-                {
-                    // Bindless resources, using application's root signature
-                    if (volume->GetBindlessType() == EBindlessType::RESOURCE_ARRAYS)
-                    {
-                        // Only need to set descriptor tables when using traditional resource array bindless
-                        cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotResourceDescriptorTable(), volume->GetResourceDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
-                        if (volume->GetSamplerDescriptorHeap()) cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotSamplerDescriptorTable(), volume->GetSamplerDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
-                    }
-                }
-                else
-                {
-                    // Bound resources, using the SDK's root signature
-                    cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotResourceDescriptorTable(), volume->GetResourceDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
-                }
-
-                // Reset all probe offsets to zero
-                const float groupSizeX = 32.f;
-                UINT numGroupsX = (UINT)ceil((float)volume->GetNumProbes() / groupSizeX);
-                cmdList->SetPipelineState(volume->GetProbeRelocationResetPSO());
-                cmdList->Dispatch(numGroupsX, 1, 1);
-
-                // Update the reset flag
-                volumes[volumeIndex]->SetProbeRelocationNeedsReset(false);
-
-                // Add a barrier
-                barrier.UAV.pResource = volume->GetProbeData();
-                barriers.push_back(barrier);
-            }
-
-            // Probe Relocation Reset Barrier(s)
-            if (!barriers.empty())
-            {
-                cmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
-                barriers.clear();
-            }
+            ResetDDGIVolumeProbeRelocation(cmdList, numVolumes, volumes);
 
             // Probe Relocation
             for(volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
@@ -571,10 +884,14 @@ namespace rtxgi
             barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
 
             // Probe Classification Reset
+            ResetDDGIVolumeProbeClassification(cmdList, numVolumes, volumes);
+
+            // Probe Classification
             for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
             {
+                // Get the volume
                 const DDGIVolume* volume = volumes[volumeIndex];
-                if (!volume->GetProbeClassificationNeedsReset()) continue;  // Skip if the volume doesn't need to be reset
+                if (!volume->GetProbeClassificationEnabled()) continue;  // Skip if classification is not enabled for this volume
 
                 // Set the descriptor heap(s)
                 std::vector<ID3D12DescriptorHeap*> heaps;
@@ -585,7 +902,7 @@ namespace rtxgi
                 // Set root signature and root constants
                 cmdList->SetComputeRootSignature(volume->GetRootSignature());
                 cmdList->SetComputeRoot32BitConstants(volume->GetRootParamSlotRootConstants(), DDGIRootConstants::GetNum32BitValues(), volume->GetRootConstants().GetData(), 0);
- 
+
                 // Set the descriptor tables (when relevant)
                 if (volume->GetBindlessEnabled())
                 {
@@ -603,73 +920,293 @@ namespace rtxgi
                     cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotResourceDescriptorTable(), volume->GetResourceDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
                 }
 
-                // Reset all probe offsets to zero
+                // Probe classification
                 const float groupSizeX = 32.f;
                 UINT numGroupsX = (UINT)ceil((float)volume->GetNumProbes() / groupSizeX);
-                cmdList->SetPipelineState(volume->GetProbeClassificationResetPSO());
+                cmdList->SetPipelineState(volume->GetProbeClassificationPSO());
                 cmdList->Dispatch(numGroupsX, 1, 1);
 
-                // Update the reset flag
-                volumes[volumeIndex]->SetProbeClassificationNeedsReset(false);
-
                 // Add a barrier
                 barrier.UAV.pResource = volume->GetProbeData();
                 barriers.push_back(barrier);
             }
 
-            // Probe Classification Reset Barrier(s)
-            if (!barriers.empty())
+            // Probe Classification Barrier(s)
+            if (!barriers.empty()) cmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+
+            if (bInsertPerfMarkers) PIXEndEvent(cmdList);
+
+            return ERTXGIStatus::OK;
+        }
+
+        ERTXGIStatus UpdateDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch, UINT tableDescriptorHeapIndex)
+        {
+            ERTXGIStatus status = ValidateMergedDispatch(numVolumes, volumes, mergedDispatch);
+            if (status != ERTXGIStatus::OK) return status;
+
+            if (bInsertPerfMarkers) PIXBeginEvent(cmdList, PIX_COLOR(RTXGI_PERF_MARKER_GREEN), "RTXGI DDGI Update Probes (Merged)");
+
+            UINT volumeIndex, batchIndex;
+            std::vector<D3D12_RESOURCE_BARRIER> barriers;
+
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+
+            const DDGIMergedDispatchBatch* batches = mergedDispatch.GetBatches(EDDGIMergedDispatchPass::ProbeBlending);
+            UINT numBatches = mergedDispatch.GetNumBatches(EDDGIMergedDispatchPass::ProbeBlending);
+
+            // Irradiance Blending
+            if (bInsertPerfMarkers) PIXBeginEvent(cmdList, PIX_COLOR(RTXGI_PERF_MARKER_GREEN), "Probe Irradiance");
+            for (batchIndex = 0; batchIndex < numBatches; batchIndex++)
             {
-                cmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
-                barriers.clear();
+                const DDGIVolume* volume = volumes[batches[batchIndex].volume];
+                DispatchMergedBatch(cmdList, volume, batches[batchIndex], tableDescriptorHeapIndex, volume->GetProbeBlendingIrradiancePSO());
             }
+            if (bInsertPerfMarkers) PIXEndEvent(cmdList);
+
+            // Distance Blending
+            if (bInsertPerfMarkers) PIXBeginEvent(cmdList, PIX_COLOR(RTXGI_PERF_MARKER_GREEN), "Probe Distance");
+            for (batchIndex = 0; batchIndex < numBatches; batchIndex++)
+            {
+                const DDGIVolume* volume = volumes[batches[batchIndex].volume];
+                DispatchMergedBatch(cmdList, volume, batches[batchIndex], tableDescriptorHeapIndex, volume->GetProbeBlendingDistancePSO());
+            }
+            if (bInsertPerfMarkers) PIXEndEvent(cmdList);
+
+            // Barrier(s)
+            // Wait for the irradiance and distance blending passes to complete before using the textures
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                barrier.UAV.pResource = volumes[volumeIndex]->GetProbeIrradiance();
+                barriers.push_back(barrier);
+                barrier.UAV.pResource = volumes[volumeIndex]->GetProbeVariability();
+                barriers.push_back(barrier);
+                barrier.UAV.pResource = volumes[volumeIndex]->GetProbeDistance();
+                barriers.push_back(barrier);
+            }
+            if (!barriers.empty()) cmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+
+            if (bInsertPerfMarkers) PIXEndEvent(cmdList);
+
+            return ERTXGIStatus::OK;
+        }
+
+        ERTXGIStatus RelocateDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch, UINT tableDescriptorHeapIndex)
+        {
+            ERTXGIStatus status = ValidateMergedDispatch(numVolumes, volumes, mergedDispatch);
+            if (status != ERTXGIStatus::OK) return status;
+
+            if (bInsertPerfMarkers) PIXBeginEvent(cmdList, PIX_COLOR(RTXGI_PERF_MARKER_GREEN), "RTXGI DDGI Relocate Probes (Merged)");
+
+            UINT volumeIndex, batchIndex;
+            std::vector<D3D12_RESOURCE_BARRIER> barriers;
+
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+
+            // Probe Relocation Reset
+            ResetDDGIVolumeProbeRelocation(cmdList, numVolumes, volumes);
+
+            // Probe Relocation
+            const DDGIMergedDispatchBatch* batches = mergedDispatch.GetBatches(EDDGIMergedDispatchPass::ProbeRelocation);
+            for (batchIndex = 0; batchIndex < mergedDispatch.GetNumBatches(EDDGIMergedDispatchPass::ProbeRelocation); batchIndex++)
+            {
+                const DDGIVolume* volume = volumes[batches[batchIndex].volume];
+                DispatchMergedBatch(cmdList, volume, batches[batchIndex], tableDescriptorHeapIndex, volume->GetProbeRelocationPSO());
+            }
+
+            // Probe Relocation Barrier(s)
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                if (!volumes[volumeIndex]->GetProbeRelocationEnabled()) continue;
+                barrier.UAV.pResource = volumes[volumeIndex]->GetProbeData();
+                barriers.push_back(barrier);
+            }
+            if (!barriers.empty()) cmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+
+            if (bInsertPerfMarkers) PIXEndEvent(cmdList);
+
+            return ERTXGIStatus::OK;
+        }
+
+        ERTXGIStatus ClassifyDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch, UINT tableDescriptorHeapIndex)
+        {
+            ERTXGIStatus status = ValidateMergedDispatch(numVolumes, volumes, mergedDispatch);
+            if (status != ERTXGIStatus::OK) return status;
+
+            if (bInsertPerfMarkers) PIXBeginEvent(cmdList, PIX_COLOR(RTXGI_PERF_MARKER_GREEN), "RTXGI DDGI Classify Probes (Merged)");
+
+            UINT volumeIndex, batchIndex;
+            std::vector<D3D12_RESOURCE_BARRIER> barriers;
+
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+
+            // Probe Classification Reset
+            ResetDDGIVolumeProbeClassification(cmdList, numVolumes, volumes);
 
             // Probe Classification
+            const DDGIMergedDispatchBatch* batches = mergedDispatch.GetBatches(EDDGIMergedDispatchPass::ProbeClassification);
+            for (batchIndex = 0; batchIndex < mergedDispatch.GetNumBatches(EDDGIMergedDispatchPass::ProbeClassification); batchIndex++)
+            {
+                const DDGIVolume* volume = volumes[batches[batchIndex].volume];
+                DispatchMergedBatch(cmdList, volume, batches[batchIndex], tableDescriptorHeapIndex, volume->GetProbeClassificationPSO());
+            }
+
+            // Probe Classification Barrier(s)
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                if (!volumes[volumeIndex]->GetProbeClassificationEnabled()) continue;
+                barrier.UAV.pResource = volumes[volumeIndex]->GetProbeData();
+                barriers.push_back(barrier);
+            }
+            if (!barriers.empty()) cmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
+
+            if (bInsertPerfMarkers) PIXEndEvent(cmdList);
+
+            return ERTXGIStatus::OK;
+        }
+
+        ERTXGIStatus CreateDDGIProbeCompactionCommandSignature(ID3D12Device* device, ID3D12CommandSignature** commandSignature)
+        {
+            if (device == nullptr) return ERTXGIStatus::ERROR_DDGI_D3D12_INVALID_DEVICE;
+            if (commandSignature == nullptr) return ERTXGIStatus::ERROR_DDGI_D3D12_INVALID_PROBE_COMPACTION_COMMAND_SIGNATURE;
+
+            // The indirect arguments are the dispatch arguments of a DDGIProbeCompactionArgs
+            D3D12_INDIRECT_ARGUMENT_DESC argument = {};
+            argument.Type = D3D12_INDIRECT_ARGUMENT_TYPE_DISPATCH;
+
+            D3D12_COMMAND_SIGNATURE_DESC desc = {};
+            desc.ByteStride = sizeof(DDGIProbeCompactionArgs);
+            desc.NumArgumentDescs = 1;
+            desc.pArgumentDescs = &argument;
+
+            HRESULT hr = device->CreateCommandSignature(&desc, nullptr, IID_PPV_ARGS(commandSignature));
+            if (FAILED(hr)) return ERTXGIStatus::ERROR_DDGI_D3D12_INVALID_PROBE_COMPACTION_COMMAND_SIGNATURE;
+        #ifdef RTXGI_GFX_NAME_OBJECTS
+            (*commandSignature)->SetName(L"DDGI Probe Compaction Command Signature");
+        #endif
+
+            return ERTXGIStatus::OK;
+        }
+
+        ERTXGIStatus CompactDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, const DDGIProbeCompactionResources& resources)
+        {
+            ERTXGIStatus status = ValidateProbeCompaction(numVolumes, volumes, resources);
+            if (status != ERTXGIStatus::OK) return status;
+
+            UINT volumeIndex;
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                if (volumes[volumeIndex]->GetProbeCompactionPSO() == nullptr) return ERTXGIStatus::ERROR_DDGI_D3D12_INVALID_PSO_PROBE_COMPACTION;
+            }
+
+            if (bInsertPerfMarkers) PIXBeginEvent(cmdList, PIX_COLOR(RTXGI_PERF_MARKER_GREEN), "RTXGI DDGI Compact Probes");
+
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+            barrier.UAV.pResource = resources.buffer;
+
+            // Clear the compaction arguments of each volume's region
+            UINT regionOffset = 0;
             for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
             {
-                // Get the volume
                 const DDGIVolume* volume = volumes[volumeIndex];
-                if (!volume->GetProbeClassificationEnabled()) continue;  // Skip if classification is not enabled for this volume
+                SetBindlessComputeRootArguments(cmdList, volume, GetDDGIProbeCompactionRootConstants(volume->GetRootConstants(), regionOffset, true, resources.uavDescriptorHeapIndex));
 
-                // Set the descriptor heap(s)
-                std::vector<ID3D12DescriptorHeap*> heaps;
-                heaps.push_back(volume->GetResourceDescriptorHeap());
-                if (volume->GetSamplerDescriptorHeap()) heaps.push_back(volume->GetSamplerDescriptorHeap());
-                cmdList->SetDescriptorHeaps((UINT)heaps.size(), heaps.data());
+                cmdList->SetPipelineState(volume->GetProbeCompactionPSO());
+                cmdList->Dispatch(1, 1, 1);
 
-                // Set root signature and root constants
-                cmdList->SetComputeRootSignature(volume->GetRootSignature());
-                cmdList->SetComputeRoot32BitConstants(volume->GetRootParamSlotRootConstants(), DDGIRootConstants::GetNum32BitValues(), volume->GetRootConstants().GetData(), 0);
+                regionOffset += GetDDGIProbeCompactionRegionSizeInBytes(volume);
+            }
 
-                // Set the descriptor tables (when relevant)
-                if (volume->GetBindlessEnabled())
-                {
-                    // Bindless resources, using application's root signature
-                    if (volume->GetBindlessType() == EBindlessType::RESOURCE_ARRAYS)
-                    {
-                        // Only need to set descriptor tables when using traditional resource array bindless
-                        cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotResourceDescriptorTable(), volume->GetResourceDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
-                        if (volume->GetSamplerDescriptorHeap()) cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotSamplerDescriptorTable(), volume->GetSamplerDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
-                    }
-                }
-                else
-                {
-                    // Bound resources, using the SDK's root signature
-                    cmdList->SetComputeRootDescriptorTable(volume->GetRootParamSlotResourceDescriptorTable(), volume->GetResourceDescriptorHeap()->GetGPUDescriptorHandleForHeapStart());
-                }
+            // Wait for the clears to complete before appending probes
+            cmdList->ResourceBarrier(1, &barrier);
 
-                // Probe classification
-                const float groupSizeX = 32.f;
+            // Append the probes that need blending to each volume's compacted probe list
+            regionOffset = 0;
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                const DDGIVolume* volume = volumes[volumeIndex];
+                SetBindlessComputeRootArguments(cmdList, volume, GetDDGIProbeCompactionRootConstants(volume->GetRootConstants(), regionOffset, false, resources.uavDescriptorHeapIndex));
+
+                float groupSizeX = 32.f;
                 UINT numGroupsX = (UINT)ceil((float)volume->GetNumProbes() / groupSizeX);
-                cmdList->SetPipelineState(volume->GetProbeClassificationPSO());
+                cmdList->SetPipelineState(volume->GetProbeCompactionPSO());
                 cmdList->Dispatch(numGroupsX, 1, 1);
 
-                // Add a barrier
-                barrier.UAV.pResource = volume->GetProbeData();
-                barriers.push_back(barrier);
+                regionOffset += GetDDGIProbeCompactionRegionSizeInBytes(volume);
             }
 
-            // Probe Classification Barrier(s)
+            // Wait for the compaction to complete before using the probe lists
+            cmdList->ResourceBarrier(1, &barrier);
+
+            if (bInsertPerfMarkers) PIXEndEvent(cmdList);
+
+            return ERTXGIStatus::OK;
+        }
+
+        ERTXGIStatus UpdateDDGIVolumeProbes(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, const DDGIProbeCompactionResources& resources)
+        {
+            ERTXGIStatus status = ValidateProbeCompaction(numVolumes, volumes, resources);
+            if (status != ERTXGIStatus::OK) return status;
+            if (resources.commandSignature == nullptr) return ERTXGIStatus::ERROR_DDGI_D3D12_INVALID_PROBE_COMPACTION_COMMAND_SIGNATURE;
+
+            if (bInsertPerfMarkers) PIXBeginEvent(cmdList, PIX_COLOR(RTXGI_PERF_MARKER_GREEN), "RTXGI DDGI Update Probes (Compacted)");
+
+            UINT volumeIndex, regionOffset;
+            std::vector<D3D12_RESOURCE_BARRIER> barriers;
+
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+
+            // Read the indirect arguments and probe lists
+            TransitionProbeCompactionBuffer(cmdList, resources.buffer, true);
+
+            // Irradiance Blending
+            if (bInsertPerfMarkers) PIXBeginEvent(cmdList, PIX_COLOR(RTXGI_PERF_MARKER_GREEN), "Probe Irradiance");
+            for (volumeIndex = 0, regionOffset = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                const DDGIVolume* volume = volumes[volumeIndex];
+                SetBindlessComputeRootArguments(cmdList, volume, GetDDGIProbeCompactionRootConstants(volume->GetRootConstants(), regionOffset, false, resources.srvDescriptorHeapIndex));
+
+                // Set the PSO and dispatch one thread group per probe in the volume's compacted probe list
+                cmdList->SetPipelineState(volume->GetProbeBlendingIrradiancePSO());
+                cmdList->ExecuteIndirect(resources.commandSignature, 1, resources.buffer, GetDDGIProbeCompactionIndirectArgsOffsetInBytes(regionOffset), nullptr, 0);
+
+                regionOffset += GetDDGIProbeCompactionRegionSizeInBytes(volume);
+            }
+            if (bInsertPerfMarkers) PIXEndEvent(cmdList);
+
+            // Distance Blending
+            if (bInsertPerfMarkers) PIXBeginEvent(cmdList, PIX_COLOR(RTXGI_PERF_MARKER_GREEN), "Probe Distance");
+            for (volumeIndex = 0, regionOffset = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                const DDGIVolume* volume = volumes[volumeIndex];
+                SetBindlessComputeRootArguments(cmdList, volume, GetDDGIProbeCompactionRootConstants(volume->GetRootConstants(), regionOffset, false, resources.srvDescriptorHeapIndex));
+
+                // Set the PSO and dispatch one thread group per probe in the volume's compacted probe list
+                cmdList->SetPipelineState(volume->GetProbeBlendingDistancePSO());
+                cmdList->ExecuteIndirect(resources.commandSignature, 1, resources.buffer, GetDDGIProbeCompactionIndirectArgsOffsetInBytes(regionOffset), nullptr, 0);
+
+                regionOffset += GetDDGIProbeCompactionRegionSizeInBytes(volume);
+            }
+            if (bInsertPerfMarkers) PIXEndEvent(cmdList);
+
+            // Return the probe compaction buffer to the unordered access state
+            TransitionProbeCompactionBuffer(cmdList, resources.buffer, false);
+
+            // Barrier(s)
+            // Wait for the irradiance and distance blending passes to complete before using the textures
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                barrier.UAV.pResource = volumes[volumeIndex]->GetProbeIrradiance();
+                barriers.push_back(barrier);
+                barrier.UAV.pResource = volumes[volumeIndex]->GetProbeVariability();
+                barriers.push_back(barrier);
+                barrier.UAV.pResource = volumes[volumeIndex]->GetProbeDistance();
+                barriers.push_back(barrier);
+            }
             if (!barriers.empty()) cmdList->ResourceBarrier(static_cast<UINT>(barriers.size()), barriers.data());
 
             if (bInsertPerfMarkers) PIXEndEvent(cmdList);
@@ -677,7 +1214,7 @@ namespace rtxgi
             return ERTXGIStatus::OK;
         }
 
-        ERTXGIStatus CalculateDDGIVolumeVariability(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes)
+        ERTXGIStatus CalculateDDGIVolumeVariability(ID3D12GraphicsCommandList* cmdList, UINT numVolumes, DDGIVolume** volumes, UINT64 frameIndex)
         {
             if (bInsertPerfMarkers) PIXBeginEvent(cmdList, PIX_COLOR(RTXGI_PERF_MARKER_GREEN), "Probe Variability Calculation");
 
@@ -836,9 +1373,12 @@ namespace rtxgi
 
                 for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
                 {
-                    const DDGIVolume* volume = volumes[volumeIndex];
+                    DDGIVolume* volume = volumes[volumeIndex];
                     if (!volume->GetProbeVariabilityEnabled()) continue;  // Skip if the volume is not calculating variability
 
+                    // Copy to this frame's readback slot
+                    UINT slot = volume->SetProbeVariabilityReadbackFrame(frameIndex);
+
                     D3D12_TEXTURE_COPY_LOCATION copyLocSrc = {};
                     copyLocSrc.pResource = volume->GetProbeVariabilityAverage();
                     copyLocSrc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
@@ -847,7 +1387,7 @@ namespace rtxgi
                     D3D12_TEXTURE_COPY_LOCATION copyLocDst = {};
                     copyLocDst.pResource = volume->GetProbeVariabilityReadback();
                     copyLocDst.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
-                    copyLocDst.PlacedFootprint.Offset = 0;
+                    copyLocDst.PlacedFootprint.Offset = GetVariabilityReadbackSlotOffset(slot);
                     copyLocDst.PlacedFootprint.Footprint.Width = 1;
                     copyLocDst.PlacedFootprint.Footprint.Height = 1;
                     copyLocDst.PlacedFootprint.Footprint.Depth = 1;
@@ -869,7 +1409,7 @@ namespace rtxgi
             return ERTXGIStatus::OK;
         }
 
-        ERTXGIStatus ReadbackDDGIVolumeVariability(UINT numVolumes, DDGIVolume** volumes)
+        ERTXGIStatus ReadbackDDGIVolumeVariability(UINT numVolumes, DDGIVolume** volumes, UINT64 frameIndex)
         {
             for (UINT volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
             {
@@ -877,19 +1417,21 @@ namespace rtxgi
                 DDGIVolume* volume = volumes[volumeIndex];
                 if (!volume->GetProbeVariabilityEnabled()) continue;  // Skip if the volume is not calculating variability
 
-                // Get the probe variability readback buffer
-                ID3D12Resource* readback = volume->GetProbeVariabilityReadback();
+                UINT slot;
+                if (!volume->GetProbeVariabilityReadbackSlot(frameIndex, slot)) continue;  // Skip if no new value is available
 
-                // Read the first 32-bits of the readback buffer
-                float* pMappedMemory = nullptr;
-                D3D12_RANGE readRange = { 0, sizeof(float) };
-                D3D12_RANGE writeRange = {};
-                HRESULT hr = readback->Map(0, &readRange, (void**)&pMappedMemory);
-                if (FAILED(hr)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_VARIABILITY_READBACK_BUFFER;
-                float value = pMappedMemory[0];
-                readback->Unmap(0, &writeRange);
+                // Map the probe variability readback buffer the first time it is read (readback heap resources may remain mapped)
+                if (volume->GetProbeVariabilityReadbackPtr() == nullptr)
+                {
+                    UINT8* pData = nullptr;
+                    HRESULT hr = volume->GetProbeVariabilityReadback()->Map(0, nullptr, reinterpret_cast<void**>(&pData));
+                    if (FAILED(hr)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_VARIABILITY_READBACK_BUFFER;
+                    volume->SetProbeVariabilityReadbackPtr(pData);
+                }
 
-                volume->SetVolumeAverageVariability(value);
+                // Read the first 32-bits of the newest completed readback slot
+                const float* pValue = reinterpret_cast<const float*>(volume->GetProbeVariabilityReadbackPtr() + GetVariabilityReadbackSlotOffset(slot));
+                volume->SetVolumeAverageVariability(*pValue, volume->GetProbeVariabilityReadbackFrame(slot));
             }
             return ERTXGIStatus::OK;
         }
@@ -914,6 +1456,7 @@ namespace rtxgi
             RTXGI_SAFE_RELEASE(m_probeClassificationResetPSO);
             RTXGI_SAFE_RELEASE(m_probeVariabilityReductionPSO);
             RTXGI_SAFE_RELEASE(m_probeVariabilityExtraReductionPSO);
+            RTXGI_SAFE_RELEASE(m_probeCompactionPSO);
         }
 
         ERTXGIStatus DDGIVolume::CreateManagedResources(const DDGIVolumeDesc& desc, const DDGIVolumeManagedResourcesDesc& managed)
@@ -972,6 +1515,12 @@ namespace rtxgi
                     managed.probeVariability.extraReductionCS,
                     &m_probeVariabilityExtraReductionPSO,
                     "Probe Variability Extra Reduction")) return ERTXGIStatus::ERROR_DDGI_D3D12_CREATE_FAILURE_PSO;
+
+                // Probe compaction is optional
+                if (managed.probeCompactionCS.pData != nullptr && !CreateComputePSO(
+                    managed.probeCompactionCS,
+                    &m_probeCompactionPSO,
+                    "Probe Compaction")) return ERTXGIStatus::ERROR_DDGI_D3D12_CREATE_FAILURE_PSO;
             }
 
             // Create the textures
@@ -1027,6 +1576,7 @@ namespace rtxgi
             m_probeData = unmanaged.probeData;
             m_probeVariability = unmanaged.probeVariability;
             m_probeVariabilityAverage = unmanaged.probeVariabilityAverage;
+            if (m_probeVariabilityReadback != unmanaged.probeVariabilityReadback) m_probeVariabilityReadbackPtr = nullptr;
             m_probeVariabilityReadback = unmanaged.probeVariabilityReadback;
 
             // Render Target Views
@@ -1042,6 +1592,7 @@ namespace rtxgi
             m_probeClassificationResetPSO = unmanaged.probeClassification.resetPSO;
             m_probeVariabilityReductionPSO = unmanaged.probeVariabilityPSOs.reductionPSO;
             m_probeVariabilityExtraReductionPSO = unmanaged.probeVariabilityPSOs.extraReductionPSO;
+            m_probeCompactionPSO = unmanaged.probeCompactionPSO;
         }
     #endif
 
@@ -1089,6 +1640,10 @@ namespace rtxgi
             if (resources.constantsBuffer) m_constantsBuffer = resources.constantsBuffer;
             if (resources.constantsBufferUpload) m_constantsBufferUpload = resources.constantsBufferUpload;
             m_constantsBufferSizeInBytes = resources.constantsBufferSizeInBytes;
+            m_constantsBufferUploadPtr = resources.constantsBufferUploadPtr;
+
+            // Constants and resource indices must be uploaded again (the buffers may have changed)
+            SetGPUDataDirty();
 
             // Allocate or store pointers to the root signature, textures, and pipeline state objects
         #if RTXGI_DDGI_RESOURCE_MANAGEMENT
@@ -1101,6 +1656,9 @@ namespace rtxgi
             // Store the new volume descriptor
             m_desc = desc;
 
+            // Discard probe variability readbacks of the previous resources
+            ResetProbeVariabilityReadback();
+
         #if RTXGI_DDGI_RESOURCE_MANAGEMENT
             // Create the resource descriptors
             if (!CreateDescriptors()) return ERTXGIStatus::ERROR_DDGI_D3D12_CREATE_FAILURE_DESCRIPTORS;
@@ -1292,6 +1850,7 @@ namespace rtxgi
             m_constantsBuffer = nullptr;
             m_constantsBufferUpload = nullptr;
             m_constantsBufferSizeInBytes = 0;
+            m_constantsBufferUploadPtr = nullptr;
 
             m_rootParamSlotRootConstants = 0;
             m_rootParamSlotResourceDescriptorTable = 0;
@@ -1317,6 +1876,10 @@ namespace rtxgi
 
             m_probeScrollOffsets = {};
 
+            m_probeResetPending = false;
+            m_probeResetAll = false;
+            m_probeReset = false;
+
         #if RTXGI_DDGI_RESOURCE_MANAGEMENT
             m_device = nullptr;
 
@@ -1339,6 +1902,7 @@ namespace rtxgi
             RTXGI_SAFE_RELEASE(m_probeClassificationResetPSO);
             RTXGI_SAFE_RELEASE(m_probeVariabilityReductionPSO);
             RTXGI_SAFE_RELEASE(m_probeVariabilityExtraReductionPSO);
+            RTXGI_SAFE_RELEASE(m_probeCompactionPSO);
         #else
             m_rootSignature = nullptr;
 
@@ -1349,6 +1913,7 @@ namespace rtxgi
             m_probeVariability = nullptr;
             m_probeVariabilityAverage = nullptr;
             m_probeVariabilityReadback = nullptr;
+            m_probeVariabilityReadbackPtr = nullptr;
 
             m_probeBlendingIrradiancePSO = nullptr;
             m_probeBlendingDistancePSO = nullptr;
@@ -1358,6 +1923,7 @@ namespace rtxgi
             m_probeClassificationResetPSO = nullptr;
             m_probeVariabilityReductionPSO = nullptr;
             m_probeVariabilityExtraReductionPSO = nullptr;
+            m_probeCompactionPSO = nullptr;
         #endif;
         }
 
@@ -1741,6 +2307,7 @@ namespace rtxgi
 
             // Create the readback texture
             RTXGI_SAFE_RELEASE(m_probeVariabilityReadback);
+            m_probeVariabilityReadbackPtr = nullptr;
 
             // Readback texture is always in "full" format (R32G32F)
             format = GetDDGIVolumeTextureFormat(EDDGIVolumeTextureType::VariabilityAverage, desc.probeVariabilityFormat);
@@ -1750,7 +2317,7 @@ namespace rtxgi
 
                 D3D12_RESOURCE_DESC desc = {};
                 desc.Format = DXGI_FORMAT_UNKNOWN;
-                desc.Width = sizeof(float) * 2;
+                desc.Width = GetDDGIVolumeVariabilityReadbackSizeInBytes();
                 desc.Height = 1;
                 desc.MipLevels = 1;
                 desc.DepthOrArraySize = 1;
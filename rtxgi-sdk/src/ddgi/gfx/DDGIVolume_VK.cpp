@@ -12,6 +12,7 @@
 
 #include "rtxgi/VulkanExtensions.h"
 
+#include <algorithm>
 #include <cstring>
 #include <random>
 #include <string>
@@ -135,6 +136,206 @@ namespace rtxgi
             return ERTXGIStatus::OK;
         }
 
+        /**
+         * Resets the probe offsets of volumes that have the probe relocation reset flag set.
+         */
+        void ResetDDGIVolumeProbeRelocation(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes)
+        {
+            uint32_t volumeIndex;
+            std::vector<VkImageMemoryBarrier> barriers;
+
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            barrier.oldLayout = barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                // Get the volume
+                const DDGIVolume* volume = volumes[volumeIndex];
+                if (!volume->GetProbeRelocationNeedsReset()) continue;  // Skip if the volume doesn't need to be reset
+
+                // Bind descriptor set and push constants
+                vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetPipelineLayout(), 0, 1, volume->GetDescriptorSetConstPtr(), 0, nullptr);
+
+                // Update the push constants
+                vkCmdPushConstants(cmdBuffer, volume->GetPipelineLayout(), VK_SHADER_STAGE_ALL, volume->GetPushConstantsOffset(), DDGIRootConstants::GetSizeInBytes(), volume->GetPushConstants().GetData());
+
+                // Reset all probe offsets to zero
+                const float groupSizeX = 32.f;
+                uint32_t numGroupsX = (uint32_t)ceil((float)volume->GetNumProbes() / groupSizeX);
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeRelocationResetPipeline());
+                vkCmdDispatch(cmdBuffer, numGroupsX, 1, 1);
+
+                // Update the reset flag
+                volumes[volumeIndex]->SetProbeRelocationNeedsReset(false);
+
+                // Add a barrier
+                barrier.image = volume->GetProbeData();
+                barriers.push_back(barrier);
+            }
+
+            // Probe Relocation Reset Barrier(s)
+            if(!barriers.empty())
+            {
+                // Wait for the compute pass to complete
+                vkCmdPipelineBarrier(
+                    cmdBuffer,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    0,
+                    0, nullptr,
+                    0, nullptr,
+                    static_cast<uint32_t>(barriers.size()), barriers.data());
+            }
+        }
+
+        /**
+         * Resets the probe states of volumes that have the probe classification reset flag set.
+         */
+        void ResetDDGIVolumeProbeClassification(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes)
+        {
+            uint32_t volumeIndex;
+            std::vector<VkImageMemoryBarrier> barriers;
+
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            barrier.oldLayout = barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                // Get the volume
+                const DDGIVolume* volume = volumes[volumeIndex];
+                if (!volume->GetProbeClassificationNeedsReset()) continue;  // Skip if the volume doesn't need to be reset
+
+                // Bind descriptor set and push constants
+                vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetPipelineLayout(), 0, 1, volume->GetDescriptorSetConstPtr(), 0, nullptr);
+
+                // Update the push constants
+                vkCmdPushConstants(cmdBuffer, volume->GetPipelineLayout(), VK_SHADER_STAGE_ALL, volume->GetPushConstantsOffset(), DDGIRootConstants::GetSizeInBytes(), volume->GetPushConstants().GetData());
+
+                // Reset all probe states to the ACTIVE state
+                const float groupSizeX = 32.f;
+                uint32_t numGroupsX = (uint32_t)ceil((float)volume->GetNumProbes() / groupSizeX);
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeClassificationResetPipeline());
+                vkCmdDispatch(cmdBuffer, numGroupsX, 1, 1);
+
+                // Update the reset flag
+                volumes[volumeIndex]->SetProbeClassificationNeedsReset(false);
+
+                // Add a barrier
+                barrier.image = volume->GetProbeData();
+                barriers.push_back(barrier);
+            }
+
+            // Probe Classification Reset Barrier(s)
+            if (!barriers.empty())
+            {
+                // Wait for the compute pass to complete
+                vkCmdPipelineBarrier(
+                    cmdBuffer,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    0,
+                    0, nullptr,
+                    0, nullptr,
+                    static_cast<uint32_t>(barriers.size()), barriers.data());
+            }
+        }
+
+        /**
+         * Validates the volumes and batches of merged probe dispatches.
+         */
+        ERTXGIStatus ValidateMergedDispatch(uint32_t numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch)
+        {
+            for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                if (volumes[volumeIndex] == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+                if (!volumes[volumeIndex]->GetBindlessEnabled()) return ERTXGIStatus::ERROR_DDGI_MERGED_DISPATCH_REQUIRES_BINDLESS_RESOURCES;
+            }
+
+            for (uint32_t passIndex = 0; passIndex < (uint32_t)EDDGIMergedDispatchPass::Count; passIndex++)
+            {
+                EDDGIMergedDispatchPass pass = (EDDGIMergedDispatchPass)passIndex;
+                const DDGIMergedDispatchBatch* batches = mergedDispatch.GetBatches(pass);
+                for (uint32_t batchIndex = 0; batchIndex < mergedDispatch.GetNumBatches(pass); batchIndex++)
+                {
+                    if (batches[batchIndex].volume >= numVolumes) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+                }
+            }
+
+            return ERTXGIStatus::OK;
+        }
+
+        /**
+         * Dispatches a batch of a merged probe dispatch with the pipeline layout and descriptor set of the batch's volume.
+         */
+        void DispatchMergedBatch(VkCommandBuffer cmdBuffer, const DDGIVolume* volume, const DDGIMergedDispatchBatch& batch, VkPipeline pipeline)
+        {
+            // Bind the descriptor set
+            vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetPipelineLayout(), 0, 1, volume->GetDescriptorSetConstPtr(), 0, nullptr);
+
+            // Update the push constants with the batch's range of the dispatch table
+            DDGIRootConstants consts = GetDDGIMergedDispatchRootConstants(batch, volume->GetPushConstants());
+            vkCmdPushConstants(cmdBuffer, volume->GetPipelineLayout(), VK_SHADER_STAGE_ALL, volume->GetPushConstantsOffset(), DDGIRootConstants::GetSizeInBytes(), consts.GetData());
+
+            // Bind the pipeline and dispatch threads
+            vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+            vkCmdDispatch(cmdBuffer, batch.numGroupsX, batch.numGroupsY, 1);
+        }
+
+        /**
+         * Validates the volumes and resources of probe compaction.
+         */
+        ERTXGIStatus ValidateProbeCompaction(uint32_t numVolumes, DDGIVolume** volumes, const DDGIProbeCompactionResources& resources)
+        {
+            if (resources.buffer == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_PROBE_COMPACTION_BUFFER;
+
+            uint64_t sizeInBytes = 0;
+            for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                if (volumes[volumeIndex] == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME;
+                if (!volumes[volumeIndex]->GetBindlessEnabled()) return ERTXGIStatus::ERROR_DDGI_PROBE_COMPACTION_REQUIRES_BINDLESS_RESOURCES;
+                sizeInBytes += GetDDGIProbeCompactionRegionSizeInBytes(volumes[volumeIndex]);
+            }
+
+            // The buffer must hold the regions of all volumes
+            if (sizeInBytes > resources.bufferSizeInBytes) return ERTXGIStatus::ERROR_DDGI_INVALID_PROBE_COMPACTION_BUFFER;
+
+            return ERTXGIStatus::OK;
+        }
+
+        /**
+         * Binds a volume's descriptor set and the given push constants for a compute dispatch.
+         */
+        void SetComputePushConstants(VkCommandBuffer cmdBuffer, const DDGIVolume* volume, DDGIRootConstants consts)
+        {
+            vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetPipelineLayout(), 0, 1, volume->GetDescriptorSetConstPtr(), 0, nullptr);
+            vkCmdPushConstants(cmdBuffer, volume->GetPipelineLayout(), VK_SHADER_STAGE_ALL, volume->GetPushConstantsOffset(), DDGIRootConstants::GetSizeInBytes(), consts.GetData());
+        }
+
+        /**
+         * Adds a barrier on the probe compaction buffer.
+         */
+        void AddProbeCompactionBarrier(VkCommandBuffer cmdBuffer, VkBuffer buffer, VkAccessFlags srcAccessMask, VkAccessFlags dstAccessMask, VkPipelineStageFlags srcStageMask, VkPipelineStageFlags dstStageMask)
+        {
+            VkBufferMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+            barrier.srcAccessMask = srcAccessMask;
+            barrier.dstAccessMask = dstAccessMask;
+            barrier.srcQueueFamilyIndex = barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.buffer = buffer;
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+
+            vkCmdPipelineBarrier(cmdBuffer, srcStageMask, dstStageMask, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+        }
+
         //------------------------------------------------------------------------
         // Public RTXGI Namespace DDGI Functions
         //------------------------------------------------------------------------
@@ -176,6 +377,12 @@ namespace rtxgi
 
         uint32_t GetDDGIVolumeLayoutBindingCount() { return 7; }
 
+        uint64_t GetDDGIVolumeVariabilityReadbackSizeInBytes()
+        {
+            // Each slot stores one R32G32 texel
+            return RTXGI_DDGI_VARIABILITY_READBACK_RING_SIZE * (sizeof(float) * 2);
+        }
+
         void GetDDGIVolumeLayoutDescs(
             VkDescriptorSetLayoutCreateInfo& descriptorSetLayoutCreateInfo,
             VkPushConstantRange& pushConstantRange,
@@ -257,100 +464,213 @@ namespace rtxgi
             pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
         }
 
+        /**
+         * Sorts buffer copy regions by offset and merges regions that are contiguous in both buffers.
+         */
+        void MergeBufferCopyRegions(std::vector<VkBufferCopy>& regions)
+        {
+            if (regions.size() < 2) return;
+
+            std::sort(regions.begin(), regions.end(), [](const VkBufferCopy& a, const VkBufferCopy& b) { return a.srcOffset < b.srcOffset; });
+
+            size_t numRegions = 1;
+            for (size_t regionIndex = 1; regionIndex < regions.size(); regionIndex++)
+            {
+                VkBufferCopy& last = regions[numRegions - 1];
+                const VkBufferCopy& region = regions[regionIndex];
+                if ((last.srcOffset + last.size) == region.srcOffset && (last.dstOffset + last.size) == region.dstOffset)
+                {
+                    last.size += region.size;
+                    continue;
+                }
+                regions[numRegions++] = region;
+            }
+            regions.resize(numRegions);
+        }
+
         ERTXGIStatus UploadDDGIVolumeResourceIndices(VkDevice device, VkCommandBuffer cmdBuffer, uint32_t bufferingIndex, uint32_t numVolumes, DDGIVolume** volumes)
         {
-            // Copy the resource indices for each volume
-            for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            std::vector<VkBufferCopy> regions;
+            regions.reserve(numVolumes);
+
+            uint32_t volumeIndex = 0;
+            while (volumeIndex < numVolumes)
             {
-                // Get the volume
-                const DDGIVolume* volume = volumes[volumeIndex];
+                // Get the first volume of the batch
+                const DDGIVolume* first = volumes[volumeIndex];
 
                 // Validate the upload and device buffers
-                if (volume->GetResourceIndicesBuffer() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_RESOURCE_INDICES_BUFFER;
-                if (volume->GetResourceIndicesBufferUpload() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_RESOURCE_INDICES_UPLOAD_BUFFER;
-                if (volume->GetResourceIndicesBufferUploadMemory() == nullptr) return ERTXGIStatus::ERROR_DDGI_VK_INVALID_RESOURCE_INDICES_UPLOAD_MEMORY;
+                if (first->GetResourceIndicesBuffer() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_RESOURCE_INDICES_BUFFER;
+                if (first->GetResourceIndicesBufferUpload() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_RESOURCE_INDICES_UPLOAD_BUFFER;
+                if (first->GetResourceIndicesBufferUploadMemory() == nullptr) return ERTXGIStatus::ERROR_DDGI_VK_INVALID_RESOURCE_INDICES_UPLOAD_MEMORY;
+
+                // Find the consecutive volumes that share the same upload and device buffers
+                uint32_t batchEnd = volumeIndex + 1;
+                while (batchEnd < numVolumes
+                    && volumes[batchEnd]->GetResourceIndicesBuffer() == first->GetResourceIndicesBuffer()
+                    && volumes[batchEnd]->GetResourceIndicesBufferUpload() == first->GetResourceIndicesBufferUpload()) batchEnd++;
 
                 // Offset to the resource indices data to write to (e.g. double buffering)
-                uint64_t bufferOffset = volume->GetResourceIndicesBufferSizeInBytes() * bufferingIndex;
+                uint64_t bufferOffset = first->GetResourceIndicesBufferSizeInBytes() * bufferingIndex;
+
+                // Use the persistently mapped upload buffer when available, otherwise map the memory (once for the batch) when the first changed volume is found
+                uint8_t* pData = first->GetResourceIndicesBufferUploadPtr();
+                bool mapped = false;
+
+                regions.clear();
+                for (; volumeIndex < batchEnd; volumeIndex++)
+                {
+                    // Get the volume
+                    DDGIVolume* volume = volumes[volumeIndex];
 
-                // Offset to the volume in current resource indices buffer
-                uint32_t volumeOffset = (volume->GetIndex() * (uint32_t)sizeof(DDGIVolumeResourceIndices));
+                    // Get the DDGIVolume's bindless resource indices, skip the volume if they haven't changed since the last upload
+                    const DDGIVolumeResourceIndices resourceIndices = volume->GetResourceIndices();
+                    uint64_t hash = GetDDGIVolumeDataHash(&resourceIndices, sizeof(DDGIVolumeResourceIndices));
+                    if (hash == volume->GetResourceIndicesHash()) continue;
 
-                // Offset to the volume resource indices in the upload buffer
-                uint64_t srcOffset = (bufferOffset + volumeOffset);
+                    if (pData == nullptr)
+                    {
+                        VkResult result = vkMapMemory(device, first->GetResourceIndicesBufferUploadMemory(), 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&pData));
+                        if (VKFAILED(result)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_RESOURCE_INDICES_UPLOAD_BUFFER;
+                        mapped = true;
+                    }
 
-                // Map the resource indices buffer and update it
-                void* pData = nullptr;
-                VkResult result = vkMapMemory(device, volume->GetResourceIndicesBufferUploadMemory(), srcOffset, sizeof(DDGIVolumeResourceIndices), 0, &pData);
-                if (VKFAILED(result)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_RESOURCE_INDICES_UPLOAD_BUFFER;
+                    // Offset to the volume in current resource indices buffer
+                    uint32_t volumeOffset = (volume->GetIndex() * (uint32_t)sizeof(DDGIVolumeResourceIndices));
 
-                // Get the DDGIVolume's bindless resource indices
-                const DDGIVolumeResourceIndices gpuDesc = volume->GetResourceIndices();
+                    // Offset to the volume resource indices in the upload buffer
+                    uint64_t srcOffset = (bufferOffset + volumeOffset);
 
-                memcpy(pData, &gpuDesc, sizeof(DDGIVolumeResourceIndices));
+                    memcpy(pData + srcOffset, &resourceIndices, sizeof(DDGIVolumeResourceIndices));
+                    regions.push_back({ srcOffset, volumeOffset, sizeof(DDGIVolumeResourceIndices) });
 
-                vkUnmapMemory(device, volume->GetResourceIndicesBufferUploadMemory());
+                    volume->SetResourceIndicesHash(hash);
+                }
 
-                // Schedule a copy of the upload buffer to the device buffer
-                VkBufferCopy bufferCopy = {};
-                bufferCopy.size = sizeof(DDGIVolumeResourceIndices);
-                bufferCopy.srcOffset = srcOffset;
-                bufferCopy.dstOffset = volumeOffset;
-                vkCmdCopyBuffer(cmdBuffer, volume->GetResourceIndicesBufferUpload(), volume->GetResourceIndicesBuffer(), 1, &bufferCopy);
+                if (mapped) vkUnmapMemory(device, first->GetResourceIndicesBufferUploadMemory());
+
+                // Schedule a single copy of the changed regions of the upload buffer to the device buffer
+                MergeBufferCopyRegions(regions);
+                if (!regions.empty())
+                {
+                    vkCmdCopyBuffer(cmdBuffer, first->GetResourceIndicesBufferUpload(), first->GetResourceIndicesBuffer(), (uint32_t)regions.size(), regions.data());
+                }
             }
 
             return ERTXGIStatus::OK;
         }
 
-        ERTXGIStatus UploadDDGIVolumeConstants(VkDevice device, VkCommandBuffer cmdBuffer, uint32_t bufferingIndex, uint32_t numVolumes, DDGIVolume** volumes)
+        ERTXGIStatus UploadDDGIVolumeConstants(VkDevice device, VkCommandBuffer cmdBuffer, uint32_t bufferingIndex, uint32_t numVolumes, DDGIVolume** volumes, const DDGIVolumeDescGPUPacked* packedDescs)
         {
-            // Copy the constants for each volume
-            for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            std::vector<VkBufferCopy> regions;
+            regions.reserve(numVolumes);
+
+            uint32_t volumeIndex = 0;
+            while (volumeIndex < numVolumes)
             {
-                // Get the volume
-                const DDGIVolume* volume = volumes[volumeIndex];
+                // Get the first volume of the batch
+                const DDGIVolume* first = volumes[volumeIndex];
 
                 // Validate the upload and device buffers
-                if (volume->GetConstantsBuffer() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_CONSTANTS_BUFFER;
-                if (volume->GetConstantsBufferUpload() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_CONSTANTS_UPLOAD_BUFFER;
-                if (volume->GetConstantsBufferUploadMemory() == nullptr) return ERTXGIStatus::ERROR_DDGI_VK_INVALID_CONSTANTS_UPLOAD_MEMORY;
+                if (first->GetConstantsBuffer() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_CONSTANTS_BUFFER;
+                if (first->GetConstantsBufferUpload() == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_CONSTANTS_UPLOAD_BUFFER;
+                if (first->GetConstantsBufferUploadMemory() == nullptr) return ERTXGIStatus::ERROR_DDGI_VK_INVALID_CONSTANTS_UPLOAD_MEMORY;
+
+                // Find the consecutive volumes that share the same upload and device buffers
+                uint32_t batchEnd = volumeIndex + 1;
+                while (batchEnd < numVolumes
+                    && volumes[batchEnd]->GetConstantsBuffer() == first->GetConstantsBuffer()
+                    && volumes[batchEnd]->GetConstantsBufferUpload() == first->GetConstantsBufferUpload()) batchEnd++;
 
                 // Offset to the constants data to write to (e.g. double buffering)
-                uint64_t bufferOffset = volume->GetConstantsBufferSizeInBytes() * bufferingIndex;
+                uint64_t bufferOffset = first->GetConstantsBufferSizeInBytes() * bufferingIndex;
+
+                // Use the persistently mapped upload buffer when available, otherwise map the memory (once for the batch) when the first changed volume is found
+                uint8_t* pData = first->GetConstantsBufferUploadPtr();
+                bool mapped = false;
+
+                regions.clear();
+                for (; volumeIndex < batchEnd; volumeIndex++)
+                {
+                    // Get the volume
+                    DDGIVolume* volume = volumes[volumeIndex];
+
+                    // Get the packed DDGIVolume GPU descriptor, skip the volume if it hasn't changed since the last upload
+                    const DDGIVolumeDescGPUPacked gpuDesc = packedDescs ? packedDescs[volumeIndex] : volume->GetDescGPUPacked();
+                    uint64_t hash = GetDDGIVolumeDataHash(&gpuDesc, sizeof(DDGIVolumeDescGPUPacked));
+                    if (hash == volume->GetConstantsHash()) continue;
 
-                // Offset to the volume in current constants buffer
-                uint32_t volumeOffset = (volume->GetIndex() * (uint32_t)sizeof(DDGIVolumeDescGPUPacked));
+                #if _DEBUG
+                    volume->ValidatePackedData(gpuDesc);
+                #endif
 
-                // Offset to the volume constants in the upload buffer
-                uint64_t srcOffset = (bufferOffset + volumeOffset);
+                    if (pData == nullptr)
+                    {
+                        VkResult result = vkMapMemory(device, first->GetConstantsBufferUploadMemory(), 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&pData));
+                        if (VKFAILED(result)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_CONSTANTS_UPLOAD_BUFFER;
+                        mapped = true;
+                    }
 
-                // Map the constants buffer and update it
-                void* pData = nullptr;
-                VkResult result = vkMapMemory(device, volume->GetConstantsBufferUploadMemory(), srcOffset, sizeof(DDGIVolumeDescGPUPacked), 0, &pData);
-                if (VKFAILED(result)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_CONSTANTS_UPLOAD_BUFFER;
+                    // Offset to the volume in current constants buffer
+                    uint32_t volumeOffset = (volume->GetIndex() * (uint32_t)sizeof(DDGIVolumeDescGPUPacked));
 
-                // Get the packed DDGIVolume GPU descriptor
-                const DDGIVolumeDescGPUPacked gpuDesc = volume->GetDescGPUPacked();
+                    // Offset to the volume constants in the upload buffer
+                    uint64_t srcOffset = (bufferOffset + volumeOffset);
 
-            #if _DEBUG
-                volume->ValidatePackedData(gpuDesc);
-            #endif
+                    memcpy(pData + srcOffset, &gpuDesc, sizeof(DDGIVolumeDescGPUPacked));
+                    regions.push_back({ srcOffset, volumeOffset, sizeof(DDGIVolumeDescGPUPacked) });
 
-                memcpy(pData, &gpuDesc, sizeof(DDGIVolumeDescGPUPacked));
+                    volume->SetConstantsHash(hash);
+                }
 
-                vkUnmapMemory(device, volume->GetConstantsBufferUploadMemory());
+                if (mapped) vkUnmapMemory(device, first->GetConstantsBufferUploadMemory());
 
-                // Schedule a copy of the upload buffer to the device buffer
-                VkBufferCopy bufferCopy = {};
-                bufferCopy.size = sizeof(DDGIVolumeDescGPUPacked);
-                bufferCopy.srcOffset = srcOffset;
-                bufferCopy.dstOffset = volumeOffset;
-                vkCmdCopyBuffer(cmdBuffer, volume->GetConstantsBufferUpload(), volume->GetConstantsBuffer(), 1, &bufferCopy);
+                // Schedule a single copy of the changed regions of the upload buffer to the device buffer
+                MergeBufferCopyRegions(regions);
+                if (!regions.empty())
+                {
+                    vkCmdCopyBuffer(cmdBuffer, first->GetConstantsBufferUpload(), first->GetConstantsBuffer(), (uint32_t)regions.size(), regions.data());
+                }
             }
 
             return ERTXGIStatus::OK;
         }
 
+        ERTXGIStatus UploadDDGIMergedDispatchTable(VkDevice device, VkCommandBuffer cmdBuffer, uint32_t bufferingIndex, const DDGIMergedDispatch& mergedDispatch, const DDGIMergedDispatchResources& resources)
+        {
+            // Validate the upload and device buffers
+            if (resources.tableBuffer == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_MERGED_DISPATCH_TABLE_BUFFER;
+            if (resources.tableBufferUpload == nullptr) return ERTXGIStatus::ERROR_DDGI_INVALID_MERGED_DISPATCH_TABLE_UPLOAD_BUFFER;
+            if (resources.tableBufferUploadMemory == nullptr) return ERTXGIStatus::ERROR_DDGI_VK_INVALID_MERGED_DISPATCH_TABLE_UPLOAD_MEMORY;
+
+            uint64_t sizeInBytes = mergedDispatch.GetEntriesSizeInBytes();
+            if (sizeInBytes > resources.tableBufferSizeInBytes) return ERTXGIStatus::ERROR_DDGI_INVALID_MERGED_DISPATCH_TABLE_BUFFER;
+            if (sizeInBytes == 0) return ERTXGIStatus::OK;
+
+            // Offset to the table data to write to (e.g. double buffering)
+            uint64_t bufferOffset = resources.tableBufferSizeInBytes * bufferingIndex;
+
+            // Use the persistently mapped upload buffer when available, otherwise map the memory
+            uint8_t* pData = resources.tableBufferUploadPtr;
+            bool mapped = false;
+            if (pData == nullptr)
+            {
+                VkResult result = vkMapMemory(device, resources.tableBufferUploadMemory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&pData));
+                if (VKFAILED(result)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_MERGED_DISPATCH_TABLE_UPLOAD_BUFFER;
+                mapped = true;
+            }
+
+            memcpy(pData + bufferOffset, mergedDispatch.GetEntries(), (size_t)sizeInBytes);
+
+            if (mapped) vkUnmapMemory(device, resources.tableBufferUploadMemory);
+
+            // Schedule a copy of the upload buffer to the device buffer
+            VkBufferCopy region = { bufferOffset, 0, sizeInBytes };
+            vkCmdCopyBuffer(cmdBuffer, resources.tableBufferUpload, resources.tableBuffer, 1, &region);
+
+            return ERTXGIStatus::OK;
+        }
+
         ERTXGIStatus UpdateDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes)
         {
             if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "RTXGI DDGI Update Probes");
@@ -480,11 +800,14 @@ namespace rtxgi
             barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
 
             // Probe Relocation Reset
+            ResetDDGIVolumeProbeRelocation(cmdBuffer, numVolumes, volumes);
+
+            // Probe Relocation
             for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
             {
                 // Get the volume
                 const DDGIVolume* volume = volumes[volumeIndex];
-                if (!volume->GetProbeRelocationNeedsReset()) continue;  // Skip if the volume doesn't need to be reset
+                if (!volume->GetProbeRelocationEnabled()) continue;  // Skip if relocation is not enabled for this volume
 
                 // Bind descriptor set and push constants
                 vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetPipelineLayout(), 0, 1, volume->GetDescriptorSetConstPtr(), 0, nullptr);
@@ -492,22 +815,19 @@ namespace rtxgi
                 // Update the push constants
                 vkCmdPushConstants(cmdBuffer, volume->GetPipelineLayout(), VK_SHADER_STAGE_ALL, volume->GetPushConstantsOffset(), DDGIRootConstants::GetSizeInBytes(), volume->GetPushConstants().GetData());
 
-                // Reset all probe offsets to zero
-                const float groupSizeX = 32.f;
+                // Probe relocation
+                float groupSizeX = 32.f;
                 uint32_t numGroupsX = (uint32_t)ceil((float)volume->GetNumProbes() / groupSizeX);
-                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeRelocationResetPipeline());
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeRelocationPipeline());
                 vkCmdDispatch(cmdBuffer, numGroupsX, 1, 1);
 
-                // Update the reset flag
-                volumes[volumeIndex]->SetProbeRelocationNeedsReset(false);
-
                 // Add a barrier
                 barrier.image = volume->GetProbeData();
                 barriers.push_back(barrier);
             }
 
-            // Probe Relocation Reset Barrier(s)
-            if(!barriers.empty())
+            // Probe Relocation Barrier(s)
+            if (!barriers.empty())
             {
                 // Wait for the compute pass to complete
                 vkCmdPipelineBarrier(
@@ -520,14 +840,34 @@ namespace rtxgi
                     static_cast<uint32_t>(barriers.size()), barriers.data());
             }
 
-            barriers.clear();
+            if (bInsertPerfMarkers) vkCmdEndDebugUtilsLabelEXT(cmdBuffer);
 
-            // Probe Relocation
+            return ERTXGIStatus::OK;
+        }
+
+        ERTXGIStatus ClassifyDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes)
+        {
+            if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "RTXGI DDGI Classify Probes");
+
+            uint32_t volumeIndex;
+            std::vector<VkImageMemoryBarrier> barriers;
+
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            barrier.oldLayout = barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+            // Probe Classification Reset
+            ResetDDGIVolumeProbeClassification(cmdBuffer, numVolumes, volumes);
+
+            // Probe Classification
             for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
             {
                 // Get the volume
                 const DDGIVolume* volume = volumes[volumeIndex];
-                if (!volume->GetProbeRelocationEnabled()) continue;  // Skip if relocation is not enabled for this volume
+                if (!volume->GetProbeClassificationEnabled()) continue;  // Skip if classification is not enabled for this volume
 
                 // Bind descriptor set and push constants
                 vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetPipelineLayout(), 0, 1, volume->GetDescriptorSetConstPtr(), 0, nullptr);
@@ -535,10 +875,10 @@ namespace rtxgi
                 // Update the push constants
                 vkCmdPushConstants(cmdBuffer, volume->GetPipelineLayout(), VK_SHADER_STAGE_ALL, volume->GetPushConstantsOffset(), DDGIRootConstants::GetSizeInBytes(), volume->GetPushConstants().GetData());
 
-                // Probe relocation
-                float groupSizeX = 32.f;
+                // Probe classification
+                const float groupSizeX = 32.f;
                 uint32_t numGroupsX = (uint32_t)ceil((float)volume->GetNumProbes() / groupSizeX);
-                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeRelocationPipeline());
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeClassificationPipeline());
                 vkCmdDispatch(cmdBuffer, numGroupsX, 1, 1);
 
                 // Add a barrier
@@ -546,7 +886,7 @@ namespace rtxgi
                 barriers.push_back(barrier);
             }
 
-            // Probe Relocation Barrier(s)
+            // Probe Classification Barrier(s)
             if (!barriers.empty())
             {
                 // Wait for the compute pass to complete
@@ -565,11 +905,14 @@ namespace rtxgi
             return ERTXGIStatus::OK;
         }
 
-        ERTXGIStatus ClassifyDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes)
+        ERTXGIStatus UpdateDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch)
         {
-            if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "RTXGI DDGI Classify Probes");
+            ERTXGIStatus status = ValidateMergedDispatch(numVolumes, volumes, mergedDispatch);
+            if (status != ERTXGIStatus::OK) return status;
 
-            uint32_t volumeIndex;
+            if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "RTXGI DDGI Update Probes (Merged)");
+
+            uint32_t volumeIndex, batchIndex;
             std::vector<VkImageMemoryBarrier> barriers;
 
             VkImageMemoryBarrier barrier = {};
@@ -579,34 +922,93 @@ namespace rtxgi
             barrier.oldLayout = barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
             barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
 
-            // Probe Classification Reset
+            const DDGIMergedDispatchBatch* batches = mergedDispatch.GetBatches(EDDGIMergedDispatchPass::ProbeBlending);
+            uint32_t numBatches = mergedDispatch.GetNumBatches(EDDGIMergedDispatchPass::ProbeBlending);
+
+            // Irradiance Blending
+            if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "Probe Irradiance");
+            for (batchIndex = 0; batchIndex < numBatches; batchIndex++)
+            {
+                const DDGIVolume* volume = volumes[batches[batchIndex].volume];
+                DispatchMergedBatch(cmdBuffer, volume, batches[batchIndex], volume->GetProbeBlendingIrradiancePipeline());
+            }
+            if (bInsertPerfMarkers) vkCmdEndDebugUtilsLabelEXT(cmdBuffer);
+
+            // Distance Blending
+            if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "Probe Distance");
+            for (batchIndex = 0; batchIndex < numBatches; batchIndex++)
+            {
+                const DDGIVolume* volume = volumes[batches[batchIndex].volume];
+                DispatchMergedBatch(cmdBuffer, volume, batches[batchIndex], volume->GetProbeBlendingDistancePipeline());
+            }
+            if (bInsertPerfMarkers) vkCmdEndDebugUtilsLabelEXT(cmdBuffer);
+
+            // Irradiance pass must finish generating variability before possible reduction pass
+            // Also ensures that irradiance and distance complete before border update after reduction
             for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
             {
-                // Get the volume
-                const DDGIVolume* volume = volumes[volumeIndex];
-                if (!volume->GetProbeClassificationNeedsReset()) continue;  // Skip if the volume doesn't need to be reset
+                barrier.image = volumes[volumeIndex]->GetProbeIrradiance();
+                barriers.push_back(barrier);
+                barrier.image = volumes[volumeIndex]->GetProbeVariability();
+                barriers.push_back(barrier);
+                barrier.image = volumes[volumeIndex]->GetProbeDistance();
+                barriers.push_back(barrier);
+            }
 
-                // Bind descriptor set and push constants
-                vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetPipelineLayout(), 0, 1, volume->GetDescriptorSetConstPtr(), 0, nullptr);
+            if (!barriers.empty())
+            {
+                // Wait for the compute pass to complete
+                vkCmdPipelineBarrier(
+                    cmdBuffer,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    0,
+                    0, nullptr,
+                    0, nullptr,
+                    static_cast<uint32_t>(barriers.size()), barriers.data());
+            }
 
-                // Update the push constants
-                vkCmdPushConstants(cmdBuffer, volume->GetPipelineLayout(), VK_SHADER_STAGE_ALL, volume->GetPushConstantsOffset(), DDGIRootConstants::GetSizeInBytes(), volume->GetPushConstants().GetData());
+            if (bInsertPerfMarkers) vkCmdEndDebugUtilsLabelEXT(cmdBuffer);
 
-                // Reset all probe states to the ACTIVE state
-                const float groupSizeX = 32.f;
-                uint32_t numGroupsX = (uint32_t)ceil((float)volume->GetNumProbes() / groupSizeX);
-                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeClassificationResetPipeline());
-                vkCmdDispatch(cmdBuffer, numGroupsX, 1, 1);
+            return ERTXGIStatus::OK;
+        }
 
-                // Update the reset flag
-                volumes[volumeIndex]->SetProbeClassificationNeedsReset(false);
+        ERTXGIStatus RelocateDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch)
+        {
+            ERTXGIStatus status = ValidateMergedDispatch(numVolumes, volumes, mergedDispatch);
+            if (status != ERTXGIStatus::OK) return status;
 
-                // Add a barrier
-                barrier.image = volume->GetProbeData();
+            if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "RTXGI DDGI Relocate Probes (Merged)");
+
+            uint32_t volumeIndex, batchIndex;
+            std::vector<VkImageMemoryBarrier> barriers;
+
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            barrier.oldLayout = barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+            // Probe Relocation Reset
+            ResetDDGIVolumeProbeRelocation(cmdBuffer, numVolumes, volumes);
+
+            // Probe Relocation
+            const DDGIMergedDispatchBatch* batches = mergedDispatch.GetBatches(EDDGIMergedDispatchPass::ProbeRelocation);
+            for (batchIndex = 0; batchIndex < mergedDispatch.GetNumBatches(EDDGIMergedDispatchPass::ProbeRelocation); batchIndex++)
+            {
+                const DDGIVolume* volume = volumes[batches[batchIndex].volume];
+                DispatchMergedBatch(cmdBuffer, volume, batches[batchIndex], volume->GetProbeRelocationPipeline());
+            }
+
+            // Probe Relocation Barrier(s)
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                if (!volumes[volumeIndex]->GetProbeRelocationEnabled()) continue;
+                barrier.image = volumes[volumeIndex]->GetProbeData();
                 barriers.push_back(barrier);
             }
 
-            // Probe Classification Reset Barrier(s)
             if (!barriers.empty())
             {
                 // Wait for the compute pass to complete
@@ -620,33 +1022,197 @@ namespace rtxgi
                     static_cast<uint32_t>(barriers.size()), barriers.data());
             }
 
-            barriers.clear();
+            if (bInsertPerfMarkers) vkCmdEndDebugUtilsLabelEXT(cmdBuffer);
+
+            return ERTXGIStatus::OK;
+        }
+
+        ERTXGIStatus ClassifyDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, const DDGIMergedDispatch& mergedDispatch)
+        {
+            ERTXGIStatus status = ValidateMergedDispatch(numVolumes, volumes, mergedDispatch);
+            if (status != ERTXGIStatus::OK) return status;
+
+            if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "RTXGI DDGI Classify Probes (Merged)");
+
+            uint32_t volumeIndex, batchIndex;
+            std::vector<VkImageMemoryBarrier> barriers;
+
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            barrier.oldLayout = barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+            // Probe Classification Reset
+            ResetDDGIVolumeProbeClassification(cmdBuffer, numVolumes, volumes);
 
             // Probe Classification
+            const DDGIMergedDispatchBatch* batches = mergedDispatch.GetBatches(EDDGIMergedDispatchPass::ProbeClassification);
+            for (batchIndex = 0; batchIndex < mergedDispatch.GetNumBatches(EDDGIMergedDispatchPass::ProbeClassification); batchIndex++)
+            {
+                const DDGIVolume* volume = volumes[batches[batchIndex].volume];
+                DispatchMergedBatch(cmdBuffer, volume, batches[batchIndex], volume->GetProbeClassificationPipeline());
+            }
+
+            // Probe Classification Barrier(s)
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                if (!volumes[volumeIndex]->GetProbeClassificationEnabled()) continue;
+                barrier.image = volumes[volumeIndex]->GetProbeData();
+                barriers.push_back(barrier);
+            }
+
+            if (!barriers.empty())
+            {
+                // Wait for the compute pass to complete
+                vkCmdPipelineBarrier(
+                    cmdBuffer,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                    0,
+                    0, nullptr,
+                    0, nullptr,
+                    static_cast<uint32_t>(barriers.size()), barriers.data());
+            }
+
+            if (bInsertPerfMarkers) vkCmdEndDebugUtilsLabelEXT(cmdBuffer);
+
+            return ERTXGIStatus::OK;
+        }
+
+        ERTXGIStatus CompactDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, const DDGIProbeCompactionResources& resources)
+        {
+            ERTXGIStatus status = ValidateProbeCompaction(numVolumes, volumes, resources);
+            if (status != ERTXGIStatus::OK) return status;
+
+            uint32_t volumeIndex;
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                if (volumes[volumeIndex]->GetProbeCompactionPipeline() == nullptr) return ERTXGIStatus::ERROR_DDGI_VK_INVALID_PIPELINE_PROBE_COMPACTION;
+            }
+
+            if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "RTXGI DDGI Compact Probes");
+
+            // Wait for the previous probe blending dispatches to finish reading the probe compaction buffer
+            AddProbeCompactionBarrier(
+                cmdBuffer,
+                resources.buffer,
+                VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+                VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+            // Clear the compaction arguments of each volume's region
+            uint32_t regionOffset = 0;
             for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
             {
-                // Get the volume
                 const DDGIVolume* volume = volumes[volumeIndex];
-                if (!volume->GetProbeClassificationEnabled()) continue;  // Skip if classification is not enabled for this volume
+                SetComputePushConstants(cmdBuffer, volume, GetDDGIProbeCompactionRootConstants(volume->GetPushConstants(), regionOffset, true));
 
-                // Bind descriptor set and push constants
-                vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetPipelineLayout(), 0, 1, volume->GetDescriptorSetConstPtr(), 0, nullptr);
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeCompactionPipeline());
+                vkCmdDispatch(cmdBuffer, 1, 1, 1);
 
-                // Update the push constants
-                vkCmdPushConstants(cmdBuffer, volume->GetPipelineLayout(), VK_SHADER_STAGE_ALL, volume->GetPushConstantsOffset(), DDGIRootConstants::GetSizeInBytes(), volume->GetPushConstants().GetData());
+                regionOffset += GetDDGIProbeCompactionRegionSizeInBytes(volume);
+            }
 
-                // Probe classification
-                const float groupSizeX = 32.f;
+            // Wait for the clears to complete before appending probes
+            AddProbeCompactionBarrier(
+                cmdBuffer,
+                resources.buffer,
+                VK_ACCESS_SHADER_WRITE_BIT,
+                VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+            // Append the probes that need blending to each volume's compacted probe list
+            regionOffset = 0;
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                const DDGIVolume* volume = volumes[volumeIndex];
+                SetComputePushConstants(cmdBuffer, volume, GetDDGIProbeCompactionRootConstants(volume->GetPushConstants(), regionOffset, false));
+
+                float groupSizeX = 32.f;
                 uint32_t numGroupsX = (uint32_t)ceil((float)volume->GetNumProbes() / groupSizeX);
-                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeClassificationPipeline());
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeCompactionPipeline());
                 vkCmdDispatch(cmdBuffer, numGroupsX, 1, 1);
 
-                // Add a barrier
-                barrier.image = volume->GetProbeData();
+                regionOffset += GetDDGIProbeCompactionRegionSizeInBytes(volume);
+            }
+
+            // Wait for the compaction to complete before using the indirect arguments and probe lists
+            AddProbeCompactionBarrier(
+                cmdBuffer,
+                resources.buffer,
+                VK_ACCESS_SHADER_WRITE_BIT,
+                VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+
+            if (bInsertPerfMarkers) vkCmdEndDebugUtilsLabelEXT(cmdBuffer);
+
+            return ERTXGIStatus::OK;
+        }
+
+        ERTXGIStatus UpdateDDGIVolumeProbes(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, const DDGIProbeCompactionResources& resources)
+        {
+            ERTXGIStatus status = ValidateProbeCompaction(numVolumes, volumes, resources);
+            if (status != ERTXGIStatus::OK) return status;
+
+            if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "RTXGI DDGI Update Probes (Compacted)");
+
+            uint32_t volumeIndex, regionOffset;
+            std::vector<VkImageMemoryBarrier> barriers;
+
+            VkImageMemoryBarrier barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+            barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            barrier.oldLayout = barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+            barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+            // Irradiance Blending
+            if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "Probe Irradiance");
+            for (volumeIndex = 0, regionOffset = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                const DDGIVolume* volume = volumes[volumeIndex];
+                SetComputePushConstants(cmdBuffer, volume, GetDDGIProbeCompactionRootConstants(volume->GetPushConstants(), regionOffset, false));
+
+                // Bind the pipeline and dispatch one thread group per probe in the volume's compacted probe list
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeBlendingIrradiancePipeline());
+                vkCmdDispatchIndirect(cmdBuffer, resources.buffer, GetDDGIProbeCompactionIndirectArgsOffsetInBytes(regionOffset));
+
+                regionOffset += GetDDGIProbeCompactionRegionSizeInBytes(volume);
+            }
+            if (bInsertPerfMarkers) vkCmdEndDebugUtilsLabelEXT(cmdBuffer);
+
+            // Distance Blending
+            if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "Probe Distance");
+            for (volumeIndex = 0, regionOffset = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                const DDGIVolume* volume = volumes[volumeIndex];
+                SetComputePushConstants(cmdBuffer, volume, GetDDGIProbeCompactionRootConstants(volume->GetPushConstants(), regionOffset, false));
+
+                // Bind the pipeline and dispatch one thread group per probe in the volume's compacted probe list
+                vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, volume->GetProbeBlendingDistancePipeline());
+                vkCmdDispatchIndirect(cmdBuffer, resources.buffer, GetDDGIProbeCompactionIndirectArgsOffsetInBytes(regionOffset));
+
+                regionOffset += GetDDGIProbeCompactionRegionSizeInBytes(volume);
+            }
+            if (bInsertPerfMarkers) vkCmdEndDebugUtilsLabelEXT(cmdBuffer);
+
+            // Irradiance pass must finish generating variability before possible reduction pass
+            // Also ensures that irradiance and distance complete before border update after reduction
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                barrier.image = volumes[volumeIndex]->GetProbeIrradiance();
+                barriers.push_back(barrier);
+                barrier.image = volumes[volumeIndex]->GetProbeVariability();
+                barriers.push_back(barrier);
+                barrier.image = volumes[volumeIndex]->GetProbeDistance();
                 barriers.push_back(barrier);
             }
 
-            // Probe Classification Barrier(s)
             if (!barriers.empty())
             {
                 // Wait for the compute pass to complete
@@ -665,7 +1231,7 @@ namespace rtxgi
             return ERTXGIStatus::OK;
         }
 
-        ERTXGIStatus CalculateDDGIVolumeVariability(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes)
+        ERTXGIStatus CalculateDDGIVolumeVariability(VkCommandBuffer cmdBuffer, uint32_t numVolumes, DDGIVolume** volumes, uint64_t frameIndex)
         {
             if (bInsertPerfMarkers) AddPerfMarker(cmdBuffer, RTXGI_PERF_MARKER_GREEN, "Probe Variability Calculation");
 
@@ -834,10 +1400,14 @@ namespace rtxgi
 
                 for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
                 {
-                    const DDGIVolume* volume = volumes[volumeIndex];
+                    DDGIVolume* volume = volumes[volumeIndex];
                     if (!volume->GetProbeVariabilityEnabled()) continue;  // Skip if the volume is not calculating variability
 
+                    // Copy to this frame's readback slot
+                    uint32_t slot = volume->SetProbeVariabilityReadbackFrame(frameIndex);
+
                     VkBufferImageCopy copy = {};
+                    copy.bufferOffset = slot * (sizeof(float) * 2);
                     copy.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
                     copy.imageExtent = { 1, 1, 1 };
                     vkCmdCopyImageToBuffer(cmdBuffer,
@@ -868,25 +1438,57 @@ namespace rtxgi
             return ERTXGIStatus::OK;
         }
 
-        ERTXGIStatus ReadbackDDGIVolumeVariability(VkDevice device, uint32_t numVolumes, DDGIVolume** volumes)
+        ERTXGIStatus ReadbackDDGIVolumeVariability(VkDevice device, uint32_t numVolumes, DDGIVolume** volumes, uint64_t frameIndex)
         {
-            for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            uint32_t volumeIndex;
+            std::vector<VkMappedMemoryRange> ranges;
+
+            // Find the volumes with completed readback slots, mapping their readback memory the first time it is read
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
             {
                 // Get the volume
                 DDGIVolume* volume = volumes[volumeIndex];
                 if (!volume->GetProbeVariabilityEnabled()) continue;  // Skip if the volume is not calculating variability
 
+                uint32_t slot;
+                if (!volume->GetProbeVariabilityReadbackSlot(frameIndex, slot)) continue;  // Skip if no new value is available
+
                 // Get the probe variability readback buffer
                 VkDeviceMemory readback = volume->GetProbeVariabilityReadbackMemory();
 
-                // Read the first 32-bits of the readback buffer
-                float* pMappedMemory = nullptr;
-                VkResult result = vkMapMemory(device, readback, 0, sizeof(float), 0, (void**)&pMappedMemory);
-                if (VKFAILED(result)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_VARIABILITY_READBACK_BUFFER;
-                float value = pMappedMemory[0];
-                vkUnmapMemory(device, readback);
+                if (volume->GetProbeVariabilityReadbackPtr() == nullptr)
+                {
+                    uint8_t* pData = nullptr;
+                    VkResult result = vkMapMemory(device, readback, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&pData));
+                    if (VKFAILED(result)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_VARIABILITY_READBACK_BUFFER;
+                    volume->SetProbeVariabilityReadbackPtr(pData);
+                }
+
+                VkMappedMemoryRange range = {};
+                range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
+                range.memory = readback;
+                range.offset = 0;
+                range.size = VK_WHOLE_SIZE;
+                ranges.push_back(range);
+            }
+
+            if (ranges.empty()) return ERTXGIStatus::OK;
+
+            // Make GPU writes visible to the CPU (the readback memory may not be host coherent)
+            VkResult result = vkInvalidateMappedMemoryRanges(device, static_cast<uint32_t>(ranges.size()), ranges.data());
+            if (VKFAILED(result)) return ERTXGIStatus::ERROR_DDGI_MAP_FAILURE_VARIABILITY_READBACK_BUFFER;
+
+            // Read the first 32-bits of each volume's newest completed readback slot
+            for (volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
+            {
+                DDGIVolume* volume = volumes[volumeIndex];
+                if (!volume->GetProbeVariabilityEnabled()) continue;
 
-                volume->SetVolumeAverageVariability(value);
+                uint32_t slot;
+                if (!volume->GetProbeVariabilityReadbackSlot(frameIndex, slot)) continue;
+
+                const float* pValue = reinterpret_cast<const float*>(volume->GetProbeVariabilityReadbackPtr() + (slot * (sizeof(float) * 2)));
+                volume->SetVolumeAverageVariability(*pValue, volume->GetProbeVariabilityReadbackFrame(slot));
             }
             return ERTXGIStatus::OK;
         }
@@ -911,6 +1513,7 @@ namespace rtxgi
             vkDestroyShaderModule(m_device, m_probeClassificationResetModule, nullptr);
             vkDestroyShaderModule(m_device, m_probeVariabilityReductionModule, nullptr);
             vkDestroyShaderModule(m_device, m_probeVariabilityExtraReductionModule, nullptr);
+            vkDestroyShaderModule(m_device, m_probeCompactionModule, nullptr);
 
             // Release the existing compute pipelines
             vkDestroyPipeline(m_device, m_probeBlendingIrradiancePipeline, nullptr);
@@ -921,6 +1524,7 @@ namespace rtxgi
             vkDestroyPipeline(m_device, m_probeClassificationResetPipeline, nullptr);
             vkDestroyPipeline(m_device, m_probeVariabilityReductionPipeline, nullptr);
             vkDestroyPipeline(m_device, m_probeVariabilityExtraReductionPipeline, nullptr);
+            vkDestroyPipeline(m_device, m_probeCompactionPipeline, nullptr);
         }
 
         ERTXGIStatus DDGIVolume::CreateManagedResources(const DDGIVolumeDesc& desc, const DDGIVolumeManagedResourcesDesc& managed)
@@ -997,6 +1601,14 @@ namespace rtxgi
                     &m_probeVariabilityExtraReductionModule,
                     &m_probeVariabilityExtraReductionPipeline,
                     "Probe Variability Extra Reduction")) return ERTXGIStatus::ERROR_DDGI_VK_CREATE_FAILURE_PIPELINE;
+
+                // Probe compaction is optional
+                if (managed.probeCompactionCS.pData != nullptr && !CreateComputePipeline(
+                    managed.probeCompactionCS,
+                    "DDGIProbeCompactionCS",
+                    &m_probeCompactionModule,
+                    &m_probeCompactionPipeline,
+                    "Probe Compaction")) return ERTXGIStatus::ERROR_DDGI_VK_CREATE_FAILURE_PIPELINE;
             }
 
             // Create the textures
@@ -1057,6 +1669,7 @@ namespace rtxgi
             m_probeDataMemory = unmanaged.probeDataMemory;
             m_probeVariabilityMemory = unmanaged.probeVariabilityMemory;
             m_probeVariabilityAverageMemory = unmanaged.probeVariabilityAverageMemory;
+            if (m_probeVariabilityReadbackMemory != unmanaged.probeVariabilityReadbackMemory) m_probeVariabilityReadbackPtr = nullptr;
             m_probeVariabilityReadbackMemory = unmanaged.probeVariabilityReadbackMemory;
 
             // Texture Array Views
@@ -1076,6 +1689,7 @@ namespace rtxgi
             m_probeClassificationResetModule = unmanaged.probeClassification.resetModule;
             m_probeVariabilityReductionModule = unmanaged.probeVariabilityPipelines.reductionModule;
             m_probeVariabilityExtraReductionModule = unmanaged.probeVariabilityPipelines.extraReductionModule;
+            m_probeCompactionModule = unmanaged.probeCompactionModule;
 
             // Pipelines
             m_probeBlendingIrradiancePipeline = unmanaged.probeBlendingIrradiancePipeline;
@@ -1086,6 +1700,7 @@ namespace rtxgi
             m_probeClassificationResetPipeline = unmanaged.probeClassification.resetPipeline;
             m_probeVariabilityReductionPipeline = unmanaged.probeVariabilityPipelines.reductionPipeline;
             m_probeVariabilityExtraReductionPipeline = unmanaged.probeVariabilityPipelines.extraReductionPipeline;
+            m_probeCompactionPipeline = unmanaged.probeCompactionPipeline;
         }
     #endif
 
@@ -1138,6 +1753,10 @@ namespace rtxgi
             if (resources.constantsBufferUpload) m_constantsBufferUpload = resources.constantsBufferUpload;
             if (resources.constantsBufferUploadMemory) m_constantsBufferUploadMemory = resources.constantsBufferUploadMemory;
             m_constantsBufferSizeInBytes = resources.constantsBufferSizeInBytes;
+            m_constantsBufferUploadPtr = resources.constantsBufferUploadPtr;
+
+            // Constants and resource indices must be uploaded again (the buffers may have changed)
+            SetGPUDataDirty();
 
             // Allocate or store pointers to the pipeline layout, descriptor set, textures, and pipelines
         #if RTXGI_DDGI_RESOURCE_MANAGEMENT
@@ -1150,6 +1769,9 @@ namespace rtxgi
             // Store the new volume descriptor
             m_desc = desc;
 
+            // Discard probe variability readbacks of the previous resources
+            ResetProbeVariabilityReadback();
+
             // Vulkan only: Force relocation reset in case the allocated memory isn't zeroed
             if(m_desc.probeRelocationEnabled) m_desc.probeRelocationNeedsReset = true;
 
@@ -1213,6 +1835,7 @@ namespace rtxgi
             m_constantsBufferUpload = nullptr;
             m_constantsBufferUploadMemory = nullptr;
             m_constantsBufferSizeInBytes = 0;
+            m_constantsBufferUploadPtr = nullptr;
 
             m_desc = {};
 
@@ -1231,6 +1854,10 @@ namespace rtxgi
 
             m_probeScrollOffsets = {};
 
+            m_probeResetPending = false;
+            m_probeResetAll = false;
+            m_probeReset = false;
+
         #if RTXGI_DDGI_RESOURCE_MANAGEMENT
             // Layouts
             vkDestroyDescriptorSetLayout(m_device, m_descriptorSetLayout, nullptr);
@@ -1245,6 +1872,7 @@ namespace rtxgi
             vkDestroyShaderModule(m_device, m_probeClassificationResetModule, nullptr);
             vkDestroyShaderModule(m_device, m_probeVariabilityReductionModule, nullptr);
             vkDestroyShaderModule(m_device, m_probeVariabilityExtraReductionModule, nullptr);
+            vkDestroyShaderModule(m_device, m_probeCompactionModule, nullptr);
 
             // Pipelines
             vkDestroyPipeline(m_device, m_probeBlendingIrradiancePipeline, nullptr);
@@ -1255,6 +1883,7 @@ namespace rtxgi
             vkDestroyPipeline(m_device, m_probeClassificationResetPipeline, nullptr);
             vkDestroyPipeline(m_device, m_probeVariabilityReductionPipeline, nullptr);
             vkDestroyPipeline(m_device, m_probeVariabilityExtraReductionPipeline, nullptr);
+            vkDestroyPipeline(m_device, m_probeCompactionPipeline, nullptr);
 
             // Texture Arrays
             vkDestroyImage(m_device, m_probeRayData, nullptr);
@@ -1314,6 +1943,7 @@ namespace rtxgi
             m_probeVariabilityAverageView = nullptr;
             m_probeVariabilityReadback = nullptr;
             m_probeVariabilityReadbackMemory = nullptr;
+            m_probeVariabilityReadbackPtr = nullptr;
 
             // Shader Modules
             m_probeBlendingIrradianceModule = nullptr;
@@ -1324,6 +1954,7 @@ namespace rtxgi
             m_probeClassificationResetModule = nullptr;
             m_probeVariabilityReductionModule = nullptr;
             m_probeVariabilityExtraReductionModule = nullptr;
+            m_probeCompactionModule = nullptr;
 
             // Pipelines
             m_probeBlendingIrradiancePipeline = nullptr;
@@ -1334,6 +1965,7 @@ namespace rtxgi
             m_probeClassificationResetPipeline = nullptr;
             m_probeVariabilityReductionPipeline = nullptr;
             m_probeVariabilityExtraReductionPipeline = nullptr;
+            m_probeCompactionPipeline = nullptr;
         }
 
         uint32_t DDGIVolume::GetGPUMemoryUsedInBytes() const
@@ -1773,7 +2405,7 @@ namespace rtxgi
             if (width <= 0 || height <= 0 || arraySize <= 0) return false;
 
             VkFormat format = GetDDGIVolumeTextureFormat(EDDGIVolumeTextureType::Variability, desc.probeVariabilityFormat);
-            VkImageUsageFlags usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+            VkImageUsageFlags usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
 
             // Create the texture, allocate memory, and bind the memory
             bool result = CreateTexture(width, height, arraySize, format, usage, &m_probeVariability, &m_probeVariabilityMemory, &m_probeVariabilityView);
@@ -1818,15 +2450,17 @@ namespace rtxgi
             SetObjectName(m_device, reinterpret_cast<uint64_t>(m_probeVariabilityAverageView), view.c_str(), VK_OBJECT_TYPE_IMAGE_VIEW);
         #endif
 
-            // Create the readback texture
+            // Create the readback buffer (freeing the memory also unmaps it)
             vkDestroyBuffer(m_device, m_probeVariabilityReadback, nullptr);
+            vkFreeMemory(m_device, m_probeVariabilityReadbackMemory, nullptr);
+            m_probeVariabilityReadbackPtr = nullptr;
 
             // Readback texture is always in "full" format (R32G32F)
             format = GetDDGIVolumeTextureFormat(EDDGIVolumeTextureType::VariabilityAverage, desc.probeVariabilityFormat);
             {
                 VkBufferCreateInfo bufferCreateInfo = {};
                 bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-                bufferCreateInfo.size = sizeof(float) * 2;
+                bufferCreateInfo.size = GetDDGIVolumeVariabilityReadbackSizeInBytes();
                 bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT;
 
                 // Create the buffer
@@ -0,0 +1,250 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Unit test of the merged dispatch table (DDGIMergedDispatch): batching, dispatch counts, and the probe-to-volume mapping.
+// Usage: rtxgi-merged-dispatch-test
+
+#include "rtxgi/ddgi/DDGIMergedDispatch.h"
+
+#include "UnitTest.h"
+
+using namespace rtxgi;
+
+namespace
+{
+    const EDDGIMergedDispatchPass c_blending = EDDGIMergedDispatchPass::ProbeBlending;
+    const EDDGIMergedDispatchPass c_relocation = EDDGIMergedDispatchPass::ProbeRelocation;
+    const EDDGIMergedDispatchPass c_classification = EDDGIMergedDispatchPass::ProbeClassification;
+
+    /**
+     * A CPU-only volume, enough to build a dispatch table.
+     */
+    class TestVolume : public DDGIVolumeBase
+    {
+    public:
+        TestVolume(uint32_t index, int3 probeCounts, int irradianceTexels, bool relocation = false, bool classification = false)
+        {
+            m_desc.index = index;
+            m_desc.probeCounts = probeCounts;
+            m_desc.probeNumRays = 256;
+            m_desc.probeNumIrradianceInteriorTexels = irradianceTexels;
+            m_desc.probeNumDistanceInteriorTexels = 14;
+            m_desc.probeRelocationEnabled = relocation;
+            m_desc.probeClassificationEnabled = classification;
+        }
+
+        void Destroy() override {}
+    };
+
+    /**
+     * Returns true when the dispatch probe of the batch maps to the expected volume (DDGIVolumeDesc::index) and probe.
+     */
+    bool IsProbe(const DDGIMergedDispatch& dispatch, const DDGIMergedDispatchBatch& batch, uint32_t dispatchProbeIndex, uint32_t volumeIndex, uint32_t probeIndex)
+    {
+        uint32_t foundVolumeIndex = UINT32_MAX, foundProbeIndex = UINT32_MAX;
+        if (!dispatch.GetProbe(batch, dispatchProbeIndex, foundVolumeIndex, foundProbeIndex)) return false;
+        return (foundVolumeIndex == volumeIndex) && (foundProbeIndex == probeIndex);
+    }
+
+    /**
+     * Returns true when the dispatch probe of the batch is thread group alignment padding (or outside of the batch).
+     */
+    bool IsPadding(const DDGIMergedDispatch& dispatch, const DDGIMergedDispatchBatch& batch, uint32_t dispatchProbeIndex)
+    {
+        uint32_t volumeIndex, probeIndex;
+        return !dispatch.GetProbe(batch, dispatchProbeIndex, volumeIndex, probeIndex);
+    }
+
+    /**
+     * Volumes with different probe texel counts can't share probe blending shaders and split into batches.
+     * Relocation and classification batch all volumes with the feature enabled.
+     */
+    void TestMixedTexelCounts()
+    {
+        TestVolume a(10, { 2, 2, 2 }, 6, true);         // 8 probes
+        TestVolume b(11, { 4, 1, 1 }, 8);               // 4 probes
+        TestVolume c(12, { 3, 1, 1 }, 6);               // 3 probes
+        TestVolume d(13, { 5, 2, 4 }, 8, true);         // 40 probes
+        const DDGIVolumeBase* volumes[] = { &a, &b, &c, &d };
+
+        DDGIMergedDispatch dispatch;
+        EXPECT(dispatch.Build(4, volumes) == ERTXGIStatus::OK);
+
+        // Probe blending: { a, c } and { b, d }, one probe per thread group
+        EXPECT(dispatch.GetNumBatches(c_blending) == 2);
+        const DDGIMergedDispatchBatch* blending = dispatch.GetBatches(c_blending);
+
+        EXPECT(blending[0].volume == 0);
+        EXPECT(blending[0].firstEntry == 0);
+        EXPECT(blending[0].numEntries == 2);
+        EXPECT(blending[0].numProbes == 11);
+        EXPECT(blending[0].numGroupsX == 11 && blending[0].numGroupsY == 1);
+
+        EXPECT(blending[1].volume == 1);
+        EXPECT(blending[1].firstEntry == 2);
+        EXPECT(blending[1].numEntries == 2);
+        EXPECT(blending[1].numProbes == 44);
+        EXPECT(blending[1].numGroupsX == 44 && blending[1].numGroupsY == 1);
+
+        // Entries follow the order of the volumes array within a batch
+        const DDGIMergedDispatchEntry* entries = dispatch.GetEntries();
+        EXPECT(entries[0].volumeIndex == 10 && entries[0].dispatchProbeOffset == 0 && entries[0].numProbes == 8);
+        EXPECT(entries[1].volumeIndex == 12 && entries[1].dispatchProbeOffset == 8 && entries[1].numProbes == 3);
+        EXPECT(entries[2].volumeIndex == 11 && entries[2].dispatchProbeOffset == 0 && entries[2].numProbes == 4);
+        EXPECT(entries[3].volumeIndex == 13 && entries[3].dispatchProbeOffset == 4 && entries[3].numProbes == 40);
+
+        // First and last probe of each range
+        EXPECT(IsProbe(dispatch, blending[0], 0, 10, 0));
+        EXPECT(IsProbe(dispatch, blending[0], 7, 10, 7));
+        EXPECT(IsProbe(dispatch, blending[0], 8, 12, 0));
+        EXPECT(IsProbe(dispatch, blending[0], 10, 12, 2));
+        EXPECT(IsPadding(dispatch, blending[0], 11));
+        EXPECT(IsProbe(dispatch, blending[1], 3, 11, 3));
+        EXPECT(IsProbe(dispatch, blending[1], 4, 13, 0));
+        EXPECT(IsProbe(dispatch, blending[1], 43, 13, 39));
+        EXPECT(IsPadding(dispatch, blending[1], 44));
+
+        // Probe relocation: { a, d }, each volume's probes aligned to 32 probe thread groups
+        EXPECT(dispatch.GetNumBatches(c_relocation) == 1);
+        const DDGIMergedDispatchBatch* relocation = dispatch.GetBatches(c_relocation);
+        EXPECT(relocation[0].volume == 0);
+        EXPECT(relocation[0].firstEntry == 4);
+        EXPECT(relocation[0].numEntries == 2);
+        EXPECT(relocation[0].numProbes == 32 + 64);
+        EXPECT(relocation[0].numGroupsX == 3 && relocation[0].numGroupsY == 1);
+
+        EXPECT(IsProbe(dispatch, relocation[0], 0, 10, 0));
+        EXPECT(IsProbe(dispatch, relocation[0], 7, 10, 7));
+        EXPECT(IsPadding(dispatch, relocation[0], 8));
+        EXPECT(IsPadding(dispatch, relocation[0], 31));
+        EXPECT(IsProbe(dispatch, relocation[0], 32, 13, 0));
+        EXPECT(IsProbe(dispatch, relocation[0], 71, 13, 39));
+        EXPECT(IsPadding(dispatch, relocation[0], 72));
+        EXPECT(IsPadding(dispatch, relocation[0], 95));
+        EXPECT(IsPadding(dispatch, relocation[0], 96));
+
+        // Probe classification: no volume has it enabled
+        EXPECT(dispatch.GetNumBatches(c_classification) == 0);
+
+        // 2 blending + 1 relocation dispatches, instead of 4 + 2 without merging
+        EXPECT(dispatch.GetNumDispatches() == 3);
+        EXPECT(dispatch.GetNumEntries() == 6);
+        EXPECT(dispatch.GetNumEntries() <= GetDDGIMergedDispatchMaxEntries(4));
+        EXPECT(dispatch.GetEntriesSizeInBytes() == 6 * sizeof(DDGIMergedDispatchEntry));
+    }
+
+    /**
+     * An empty table has no dispatches, and rebuilding a table replaces its previous contents.
+     */
+    void TestEmpty()
+    {
+        DDGIMergedDispatch dispatch;
+        EXPECT(dispatch.Build(0, nullptr) == ERTXGIStatus::OK);
+        EXPECT(dispatch.GetNumEntries() == 0);
+        EXPECT(dispatch.GetNumDispatches() == 0);
+
+        TestVolume a(0, { 4, 4, 4 }, 6, true, true);
+        const DDGIVolumeBase* volumes[] = { &a };
+        EXPECT(dispatch.Build(1, volumes) == ERTXGIStatus::OK);
+        EXPECT(dispatch.GetNumEntries() == 3);
+        EXPECT(dispatch.GetNumDispatches() == 3);
+        uint64_t hash = dispatch.GetEntriesHash();
+
+        EXPECT(dispatch.Build(0, volumes) == ERTXGIStatus::OK);
+        EXPECT(dispatch.GetNumEntries() == 0);
+        EXPECT(dispatch.GetNumDispatches() == 0);
+        for (uint32_t passIndex = 0; passIndex < (uint32_t)EDDGIMergedDispatchPass::Count; passIndex++)
+        {
+            EXPECT(dispatch.GetNumBatches((EDDGIMergedDispatchPass)passIndex) == 0);
+        }
+
+        // Rebuilding the same volumes gives the same table
+        EXPECT(dispatch.Build(1, volumes) == ERTXGIStatus::OK);
+        EXPECT(dispatch.GetEntriesHash() == hash);
+
+        // A missing volume is an error
+        const DDGIVolumeBase* missing[] = { &a, nullptr };
+        EXPECT(dispatch.Build(2, missing) == ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME);
+    }
+
+    /**
+     * A volume without probes has an empty range that never maps to a probe.
+     */
+    void TestZeroProbeVolumes()
+    {
+        TestVolume a(0, { 2, 2, 2 }, 6);                // 8 probes
+        TestVolume empty(1, { 0, 0, 0 }, 6, true);      // no probes
+        TestVolume c(2, { 3, 1, 1 }, 6);                // 3 probes
+        const DDGIVolumeBase* volumes[] = { &a, &empty, &c };
+
+        DDGIMergedDispatch dispatch;
+        EXPECT(dispatch.Build(3, volumes) == ERTXGIStatus::OK);
+
+        EXPECT(dispatch.GetNumBatches(c_blending) == 1);
+        const DDGIMergedDispatchBatch* blending = dispatch.GetBatches(c_blending);
+        EXPECT(blending[0].numEntries == 3);
+        EXPECT(blending[0].numProbes == 11);
+
+        const DDGIMergedDispatchEntry* entries = dispatch.GetEntries();
+        EXPECT(entries[1].volumeIndex == 1 && entries[1].dispatchProbeOffset == 8 && entries[1].numProbes == 0);
+        EXPECT(entries[2].volumeIndex == 2 && entries[2].dispatchProbeOffset == 8);
+
+        // The empty range shares its offset with the next range, which owns the probe
+        EXPECT(IsProbe(dispatch, blending[0], 7, 0, 7));
+        EXPECT(IsProbe(dispatch, blending[0], 8, 2, 0));
+        EXPECT(IsProbe(dispatch, blending[0], 10, 2, 2));
+        EXPECT(IsPadding(dispatch, blending[0], 11));
+
+        // A batch of only empty volumes dispatches no thread groups
+        EXPECT(dispatch.GetNumBatches(c_relocation) == 1);
+        const DDGIMergedDispatchBatch* relocation = dispatch.GetBatches(c_relocation);
+        EXPECT(relocation[0].volume == 1);
+        EXPECT(relocation[0].numEntries == 1);
+        EXPECT(relocation[0].numProbes == 0);
+        EXPECT(relocation[0].numGroupsX == 0 && relocation[0].numGroupsY == 0);
+        EXPECT(IsPadding(dispatch, relocation[0], 0));
+
+        EXPECT(dispatch.GetNumDispatches() == 2);
+    }
+
+    /**
+     * Batches with more thread groups than a dispatch supports on the X axis spill into the Y axis.
+     */
+    void TestLargeDispatch()
+    {
+        TestVolume a(0, { 100, 20, 40 }, 6);            // 80000 probes
+        TestVolume b(1, { 10, 10, 10 }, 6);             // 1000 probes
+        const DDGIVolumeBase* volumes[] = { &a, &b };
+
+        DDGIMergedDispatch dispatch;
+        EXPECT(dispatch.Build(2, volumes) == ERTXGIStatus::OK);
+
+        const DDGIMergedDispatchBatch* blending = dispatch.GetBatches(c_blending);
+        EXPECT(blending[0].numProbes == 81000);
+        EXPECT(blending[0].numGroupsX == RTXGI_DDGI_MERGED_DISPATCH_MAX_GROUPS_X);
+        EXPECT(blending[0].numGroupsY == 2);
+
+        EXPECT(IsProbe(dispatch, blending[0], 79999, 0, 79999));
+        EXPECT(IsProbe(dispatch, blending[0], 80000, 1, 0));
+        EXPECT(IsProbe(dispatch, blending[0], 80999, 1, 999));
+        EXPECT(IsPadding(dispatch, blending[0], 81000));
+        EXPECT(IsPadding(dispatch, blending[0], 2 * RTXGI_DDGI_MERGED_DISPATCH_MAX_GROUPS_X - 1));
+    }
+}
+
+int main()
+{
+    TestMixedTexelCounts();
+    TestEmpty();
+    TestZeroProbeVolumes();
+    TestLargeDispatch();
+
+    return UnitTest::Finish();
+}
@@ -0,0 +1,282 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Unit test of the CPU probe blending reference (cpu::BlendDDGIVolumeProbes()): SIMD / scalar kernel parity,
+// thread count independence, and golden results that follow from DDGIProbeBlendingCS's normalization.
+// Usage: rtxgi-probe-blending-test
+
+#include "rtxgi/ddgi/DDGIProbeBlending.h"
+
+#include "UnitTest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace rtxgi;
+
+namespace
+{
+    /**
+     * Textures of a volume, sized with cpu::GetDDGIVolumeTextureDimensions().
+     */
+    struct Textures
+    {
+        std::vector<float4> rayData;
+        std::vector<float4> irradiance;
+        std::vector<float2> distance;
+        std::vector<float>  variability;
+
+        cpu::ProbeBlendingTextures Get()
+        {
+            cpu::ProbeBlendingTextures textures;
+            textures.rayData = rayData.data();
+            textures.probeIrradiance = irradiance.data();
+            textures.probeDistance = distance.data();
+            textures.probeVariability = variability.empty() ? nullptr : variability.data();
+            return textures;
+        }
+    };
+
+    size_t GetNumTexels(const DDGIVolumeDescGPU& volume, EDDGIVolumeTextureType type)
+    {
+        uint32_t width, height, arraySize;
+        cpu::GetDDGIVolumeTextureDimensions(volume, type, width, height, arraySize);
+        return (size_t)width * height * arraySize;
+    }
+
+    /**
+     * A small volume with probe variability, blended like the Test Harness blends its volumes.
+     */
+    DDGIVolumeDescGPU CreateVolume()
+    {
+        DDGIVolumeDescGPU volume = {};
+        volume.rotation = { 0.f, 0.f, 0.f, 1.f };
+        volume.probeRayRotation = { 0.f, 0.f, 0.f, 1.f };
+        volume.probeSpacing = { 1.f, 1.f, 1.f };
+        volume.probeCounts = { 4, 2, 3 };
+        volume.probeNumRays = 128;
+        volume.probeNumIrradianceInteriorTexels = 6;
+        volume.probeNumDistanceInteriorTexels = 14;
+        volume.probeHysteresis = 0.97f;
+        volume.probeMaxRayDistance = 100.f;
+        volume.probeDistanceExponent = 50.f;
+        volume.probeIrradianceEncodingGamma = 5.f;
+        volume.probeIrradianceThreshold = 0.2f;
+        volume.probeBrightnessThreshold = 0.1f;
+        volume.probeRandomRayBackfaceThreshold = 0.1f;
+        volume.probeFixedRayBackfaceThreshold = 0.25f;
+        volume.probeRayDataFormat = (uint32_t)EDDGIVolumeTextureFormat::F32x4;
+        volume.probeIrradianceFormat = (uint32_t)EDDGIVolumeTextureFormat::F32x4;
+        volume.probeVariabilityEnabled = true;
+        return volume;
+    }
+
+    /**
+     * Fills the textures with deterministic pseudo-random values. About 3% of the rays hit backfaces.
+     */
+    void CreateTextures(const DDGIVolumeDescGPU& volume, Textures& textures, uint32_t seed)
+    {
+        uint32_t state = seed;
+        auto random = [&state]()
+        {
+            state = (state * 1664525u) + 1013904223u;
+            return (float)(state >> 8) / 16777216.f;
+        };
+
+        textures.rayData.resize((size_t)volume.probeCounts.x * volume.probeCounts.y * volume.probeCounts.z * volume.probeNumRays);
+        for (float4& ray : textures.rayData)
+        {
+            float distance = 0.5f + (random() * 20.f);
+            if (random() < 0.03f) distance = -distance;
+            ray = { random() * 2.f, random() * 2.f, random() * 2.f, distance };
+        }
+
+        textures.irradiance.resize(GetNumTexels(volume, EDDGIVolumeTextureType::Irradiance));
+        for (float4& texel : textures.irradiance) texel = { random(), random(), random(), 1.f };
+
+        textures.distance.resize(GetNumTexels(volume, EDDGIVolumeTextureType::Distance));
+        for (float2& texel : textures.distance) { texel.x = random() * 10.f; texel.y = texel.x * texel.x; }
+
+        textures.variability.assign(GetNumTexels(volume, EDDGIVolumeTextureType::Variability), 0.f);
+    }
+
+    bool IsNear(float a, float b, float tolerance)
+    {
+        return std::abs(a - b) <= tolerance * std::max(1.f, std::abs(a));
+    }
+
+    /**
+     * Returns the largest relative difference between two texture copies, in floats.
+     */
+    float GetMaxDifference(const float* a, const float* b, size_t numFloats)
+    {
+        float maxDifference = 0.f;
+        for (size_t index = 0; index < numFloats; index++)
+        {
+            maxDifference = std::max(maxDifference, std::abs(a[index] - b[index]) / std::max(1.f, std::abs(a[index])));
+        }
+        return maxDifference;
+    }
+
+    /**
+     * The SIMD kernels match the scalar kernels, over several updates (so hysteresis and variability are exercised).
+     */
+    void TestSIMDParity()
+    {
+        if (!cpu::IsProbeBlendingSIMDSupported())
+        {
+            printf("SIMD kernels are not available on this target, skipping the SIMD parity test\n");
+            return;
+        }
+
+        DDGIVolumeDescGPU volume = CreateVolume();
+
+        Textures scalar, simd;
+        CreateTextures(volume, scalar, 1);
+        CreateTextures(volume, simd, 1);
+
+        cpu::ProbeBlendingDesc desc;
+        desc.numThreads = 2;
+        desc.quantizeTexels = false;
+
+        for (uint32_t updateIndex = 0; updateIndex < 3; updateIndex++)
+        {
+            desc.useSIMD = false;
+            EXPECT(cpu::BlendDDGIVolumeProbes(volume, desc, scalar.Get()) == ERTXGIStatus::OK);
+            desc.useSIMD = true;
+            EXPECT(cpu::BlendDDGIVolumeProbes(volume, desc, simd.Get()) == ERTXGIStatus::OK);
+        }
+
+        EXPECT(GetMaxDifference(&scalar.irradiance[0].x, &simd.irradiance[0].x, scalar.irradiance.size() * 4) <= 1e-5f);
+        EXPECT(GetMaxDifference(&scalar.distance[0].x, &simd.distance[0].x, scalar.distance.size() * 2) <= 1e-5f);
+        EXPECT(GetMaxDifference(scalar.variability.data(), simd.variability.data(), scalar.variability.size()) <= 1e-5f);
+
+        // The blend changed the textures
+        Textures initial;
+        CreateTextures(volume, initial, 1);
+        EXPECT(GetMaxDifference(&initial.irradiance[0].x, &scalar.irradiance[0].x, scalar.irradiance.size() * 4) > 0.f);
+    }
+
+    /**
+     * Probes blend independently, so the results don't depend on the number of threads.
+     */
+    void TestThreadCount()
+    {
+        DDGIVolumeDescGPU volume = CreateVolume();
+
+        Textures one, many;
+        CreateTextures(volume, one, 2);
+        CreateTextures(volume, many, 2);
+
+        cpu::ProbeBlendingDesc desc;
+        desc.numThreads = 1;
+        EXPECT(cpu::BlendDDGIVolumeProbes(volume, desc, one.Get()) == ERTXGIStatus::OK);
+        desc.numThreads = 5;
+        EXPECT(cpu::BlendDDGIVolumeProbes(volume, desc, many.Get()) == ERTXGIStatus::OK);
+
+        EXPECT(memcmp(one.irradiance.data(), many.irradiance.data(), one.irradiance.size() * sizeof(float4)) == 0);
+        EXPECT(memcmp(one.distance.data(), many.distance.data(), one.distance.size() * sizeof(float2)) == 0);
+        EXPECT(memcmp(one.variability.data(), many.variability.data(), one.variability.size() * sizeof(float)) == 0);
+    }
+
+    /**
+     * Blends rays with constant radiance and hit distance into cleared (black) probes.
+     */
+    void BlendConstantRays(DDGIVolumeDescGPU& volume, Textures& textures, bool useSIMD, float3 radiance, float distance)
+    {
+        CreateTextures(volume, textures, 3);
+        for (float4& ray : textures.rayData) ray = { radiance.x, radiance.y, radiance.z, distance };
+        for (float4& texel : textures.irradiance) texel = { 0.f, 0.f, 0.f, 0.f };
+        for (float2& texel : textures.distance) texel = { 0.f, 0.f };
+        textures.variability.clear();
+
+        cpu::ProbeBlendingDesc desc;
+        desc.useSIMD = useSIMD;
+        desc.quantizeTexels = false;
+        EXPECT(cpu::BlendDDGIVolumeProbes(volume, desc, textures.Get()) == ERTXGIStatus::OK);
+    }
+
+    /**
+     * Returns true when all irradiance texels (interior and border) are the expected value.
+     */
+    bool IsIrradiance(const Textures& textures, float3 expected)
+    {
+        bool result = true;
+        for (const float4& texel : textures.irradiance)
+        {
+            result &= IsNear(texel.x, expected.x, 1e-5f) && IsNear(texel.y, expected.y, 1e-5f) && IsNear(texel.z, expected.z, 1e-5f) && (texel.w == 1.f);
+        }
+        return result;
+    }
+
+    /**
+     * Returns true when all distance texels (interior and border) hold the blend of rays with a constant hit distance.
+     */
+    bool IsDistance(const Textures& textures, float hitDistance)
+    {
+        bool result = true;
+        for (const float2& texel : textures.distance) result &= IsNear(texel.x, 0.5f * hitDistance, 1e-5f) && IsNear(texel.y, 0.5f * hitDistance * hitDistance, 1e-5f);
+        return result;
+    }
+
+    /**
+     * Golden results of constant rays. Hysteresis is zero for black probes and DDGIProbeBlendingCS normalizes by twice
+     * the weight sum, so every texel is half the ray value (before the thresholds and clamps below).
+     */
+    void TestConstantRays(bool useSIMD)
+    {
+        DDGIVolumeDescGPU volume = CreateVolume();
+        volume.probeSpacing = { 4.f, 4.f, 4.f };
+        volume.probeIrradianceEncodingGamma = 1.f;
+        volume.probeBrightnessThreshold = 100.f;
+        volume.probeVariabilityEnabled = false;
+
+        Textures textures;
+        BlendConstantRays(volume, textures, useSIMD, { 0.5f, 0.25f, 1.f }, 4.f);
+        EXPECT(IsIrradiance(textures, { 0.25f, 0.125f, 0.5f }));
+        EXPECT(IsDistance(textures, 4.f));
+
+        // Irradiance encoding gamma
+        volume.probeIrradianceEncodingGamma = 2.f;
+        BlendConstantRays(volume, textures, useSIMD, { 0.5f, 0.5f, 2.f }, 4.f);
+        EXPECT(IsIrradiance(textures, { 0.5f, 0.5f, 1.f }));
+        volume.probeIrradianceEncodingGamma = 1.f;
+
+        // Large brightness changes are clamped to a quarter of the change
+        volume.probeBrightnessThreshold = 0.1f;
+        BlendConstantRays(volume, textures, useSIMD, { 0.5f, 0.25f, 1.f }, 4.f);
+        EXPECT(IsIrradiance(textures, { 0.0625f, 0.03125f, 0.125f }));
+
+        // Hit distances are clamped to 1.5x the probe spacing diagonal
+        volume.probeSpacing = { 1.f, 1.f, 1.f };
+        BlendConstantRays(volume, textures, useSIMD, { 0.5f, 0.25f, 1.f }, 4.f);
+        EXPECT(IsDistance(textures, 1.5f * std::sqrt(3.f)));
+
+        // Backface hits are ignored when blending irradiance (too many leave the probe unchanged), their distance is blended
+        volume.probeSpacing = { 4.f, 4.f, 4.f };
+        BlendConstantRays(volume, textures, useSIMD, { 0.5f, 0.25f, 1.f }, -4.f);
+        bool unchanged = true;
+        for (const float4& texel : textures.irradiance) unchanged &= (texel.x == 0.f && texel.y == 0.f && texel.z == 0.f);
+        EXPECT(unchanged);
+        EXPECT(IsDistance(textures, 4.f));
+    }
+}
+
+int main()
+{
+    TestSIMDParity();
+    TestThreadCount();
+    TestConstantRays(false);
+    TestConstantRays(true);
+
+    return UnitTest::Finish();
+}
@@ -0,0 +1,238 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Unit test of the adaptive probe ray allocator (DDGIProbeRayAllocator): ray count granularity and packing,
+// reuse of the allocator across volumes, and budget exhaustion.
+// Usage: rtxgi-probe-ray-allocator-test
+
+#include "rtxgi/ddgi/DDGIProbeRayAllocator.h"
+
+#include "UnitTest.h"
+
+#include <vector>
+
+using namespace rtxgi;
+
+namespace
+{
+    /**
+     * A CPU-only volume, enough to allocate probe rays.
+     */
+    class TestVolume : public DDGIVolumeBase
+    {
+    public:
+        TestVolume(int3 probeCounts, int probeNumRays, bool relocation = false)
+        {
+            m_desc.probeCounts = probeCounts;
+            m_desc.probeNumRays = probeNumRays;
+            m_desc.probeRelocationEnabled = relocation;
+            m_desc.probeClassificationEnabled = false;
+        }
+
+        void Destroy() override {}
+    };
+
+    /**
+     * Returns true when the probes' rays are packed in probe index order, without gaps, and add up to GetNumRays().
+     */
+    bool IsPacked(const DDGIProbeRayAllocator& allocator)
+    {
+        uint32_t numRays = 0;
+        for (uint32_t probeIndex = 0; probeIndex < allocator.GetNumProbes(); probeIndex++)
+        {
+            if (allocator.GetAllocations()[probeIndex].rayOffset != numRays) return false;
+            numRays += allocator.GetAllocations()[probeIndex].numRays;
+        }
+        return (numRays == allocator.GetNumRays());
+    }
+
+    /**
+     * Returns true when every probe traces between minRays and maxRays rays, in steps of granularity above minRays.
+     */
+    bool IsGranular(const DDGIProbeRayAllocator& allocator, uint32_t minRays, uint32_t maxRays, uint32_t granularity)
+    {
+        for (uint32_t probeIndex = 0; probeIndex < allocator.GetNumProbes(); probeIndex++)
+        {
+            uint32_t numRays = allocator.GetAllocations()[probeIndex].numRays;
+            if (numRays < minRays || numRays > maxRays) return false;
+            if (numRays != maxRays && ((numRays - minRays) % granularity) != 0) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Ray counts follow the granularity and rays are packed contiguously.
+     */
+    void TestGranularity()
+    {
+        TestVolume volume({ 4, 4, 4 }, 256);
+        std::vector<float> variability(64);
+        for (size_t probeIndex = 0; probeIndex < variability.size(); probeIndex++) variability[probeIndex] = (float)(probeIndex % 7) * 0.1f;
+
+        DDGIProbeRayAllocatorDesc desc;
+        desc.minProbeRays = 32;
+        desc.rayGranularity = 32;
+        desc.rayBudget = 64 * 100;
+
+        DDGIProbeRayAllocator allocator;
+        EXPECT(allocator.Allocate(&volume, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(allocator.GetNumProbes() == 64);
+        EXPECT(IsPacked(allocator));
+        EXPECT(IsGranular(allocator, 32, 256, 32));
+        EXPECT(allocator.GetNumRays() <= desc.rayBudget);
+        EXPECT(allocator.GetNumRays() > 64 * 32);
+
+        // Every ray offset is aligned to the granularity when the minimum is
+        bool aligned = true;
+        for (uint32_t probeIndex = 0; probeIndex < allocator.GetNumProbes(); probeIndex++) aligned &= (allocator.GetAllocations()[probeIndex].rayOffset % 32) == 0;
+        EXPECT(aligned);
+
+        // Converged probes trace the minimum, more variable probes trace at least as many rays
+        EXPECT(allocator.GetAllocations()[0].numRays == 32);
+        EXPECT(allocator.GetAllocations()[7].numRays == 32);
+        EXPECT(allocator.GetAllocations()[6].numRays >= allocator.GetAllocations()[1].numRays);
+
+        // Odd granularities and minimums
+        desc.minProbeRays = 5;
+        desc.rayGranularity = 24;
+        EXPECT(allocator.Allocate(&volume, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(IsPacked(allocator));
+        EXPECT(IsGranular(allocator, 5, 256, 24));
+        EXPECT(allocator.GetNumRays() <= desc.rayBudget);
+
+        // Relocation and classification need the fixed rays of every probe
+        TestVolume relocation({ 4, 4, 4 }, 256, true);
+        EXPECT(allocator.Allocate(&relocation, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(IsGranular(allocator, RTXGI_DDGI_NUM_FIXED_RAYS, 256, 24));
+    }
+
+    /**
+     * The allocator's storage is reused across volumes of different sizes, and allocations don't depend on earlier ones.
+     */
+    void TestReuse()
+    {
+        TestVolume large({ 8, 4, 8 }, 128);
+        TestVolume small({ 2, 2, 2 }, 128);
+        std::vector<float> variability(256, 0.5f);
+        variability[3] = 0.f;
+
+        DDGIProbeRayAllocatorDesc desc;
+        desc.rayBudget = 8 * 64;
+
+        DDGIProbeRayAllocator fresh;
+        EXPECT(fresh.Allocate(&small, desc, variability.data()) == ERTXGIStatus::OK);
+        std::vector<DDGIProbeRayAllocation> expected(fresh.GetAllocations(), fresh.GetAllocations() + fresh.GetNumProbes());
+
+        // Shrink: the large volume's storage is reused for the small volume
+        DDGIProbeRayAllocator allocator;
+        EXPECT(allocator.Allocate(&large, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(allocator.GetNumProbes() == 256);
+        EXPECT(allocator.Allocate(&small, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(allocator.GetNumProbes() == 8);
+        EXPECT(allocator.GetAllocationsSizeInBytes() == 8 * sizeof(DDGIProbeRayAllocation));
+        EXPECT(IsPacked(allocator));
+        EXPECT(allocator.GetAllocationsHash() == fresh.GetAllocationsHash());
+
+        bool same = true;
+        for (uint32_t probeIndex = 0; probeIndex < 8; probeIndex++)
+        {
+            same &= (allocator.GetAllocations()[probeIndex].rayOffset == expected[probeIndex].rayOffset);
+            same &= (allocator.GetAllocations()[probeIndex].numRays == expected[probeIndex].numRays);
+        }
+        EXPECT(same);
+
+        // Uniform allocations replace adaptive ones, and the hash changes with the allocations
+        EXPECT(allocator.AllocateUniform(&small) == ERTXGIStatus::OK);
+        EXPECT(allocator.GetNumRays() == 8 * 128);
+        EXPECT(allocator.GetAllocations()[3].numRays == 128 && allocator.GetAllocations()[3].rayOffset == 3 * 128);
+        EXPECT(allocator.GetAllocationsHash() != fresh.GetAllocationsHash());
+
+        // Grow again
+        EXPECT(allocator.Allocate(&large, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(allocator.GetNumProbes() == 256);
+        EXPECT(IsPacked(allocator));
+
+        // Invalid inputs
+        TestVolume empty({ 0, 0, 0 }, 128);
+        EXPECT(allocator.Allocate(nullptr, desc, variability.data()) == ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME);
+        EXPECT(allocator.Allocate(&empty, desc, variability.data()) == ERTXGIStatus::ERROR_DDGI_INVALID_PROBE_COUNTS);
+        EXPECT(allocator.Allocate(&small, desc, nullptr) == ERTXGIStatus::ERROR_DDGI_INVALID_TEXTURE_PROBE_VARIABILITY);
+        EXPECT(allocator.AllocateUniform(nullptr) == ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME);
+    }
+
+    /**
+     * Budgets are clamped to the RayData capacity, never exceeded, and probes at their capacity give their excess to others.
+     */
+    void TestExhaustion()
+    {
+        TestVolume volume({ 4, 2, 2 }, 128);
+        std::vector<float> variability(16, 0.f);
+
+        DDGIProbeRayAllocatorDesc desc;
+        desc.minProbeRays = 32;
+        desc.rayGranularity = 32;
+
+        DDGIProbeRayAllocator allocator;
+
+        // A budget below the minimum still traces the minimum number of rays for every probe
+        desc.rayBudget = 100;
+        variability.assign(16, 1.f);
+        EXPECT(allocator.Allocate(&volume, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(allocator.GetNumRays() == 16 * 32);
+
+        // A budget of 0 (or above the capacity) allows every probe to trace probeNumRays rays
+        desc.rayBudget = 0;
+        EXPECT(allocator.Allocate(&volume, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(allocator.GetNumRays() == 16 * 128);
+        desc.rayBudget = 1000000;
+        EXPECT(allocator.Allocate(&volume, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(allocator.GetNumRays() == 16 * 128);
+
+        // Converged probes don't use the budget
+        variability.assign(16, 0.f);
+        desc.rayBudget = 0;
+        EXPECT(allocator.Allocate(&volume, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(allocator.GetNumRays() == 16 * 32);
+
+        // One volatile probe reaches its capacity, the rest of the budget goes to the other volatile probes
+        variability[0] = 100.f;
+        variability[1] = 1.f;
+        variability[2] = 1.f;
+        desc.rayBudget = (16 * 32) + 96 + 128;
+        EXPECT(allocator.Allocate(&volume, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(allocator.GetAllocations()[0].numRays == 128);
+        EXPECT(allocator.GetAllocations()[1].numRays == 96);
+        EXPECT(allocator.GetAllocations()[2].numRays == 96);
+        EXPECT(allocator.GetAllocations()[3].numRays == 32);
+        EXPECT(allocator.GetNumRays() == desc.rayBudget);
+
+        // The rays lost to rounding go to the largest remainders, lowest probe index first, without exceeding the budget
+        variability.assign(16, 0.f);
+        variability[5] = 1.f;
+        variability[6] = 1.f;
+        variability[7] = 1.f;
+        desc.rayBudget = (16 * 32) + 64;
+        EXPECT(allocator.Allocate(&volume, desc, variability.data()) == ERTXGIStatus::OK);
+        EXPECT(allocator.GetAllocations()[5].numRays == 64);
+        EXPECT(allocator.GetAllocations()[6].numRays == 64);
+        EXPECT(allocator.GetAllocations()[7].numRays == 32);
+        EXPECT(allocator.GetNumRays() == desc.rayBudget);
+        EXPECT(IsPacked(allocator));
+    }
+}
+
+int main()
+{
+    TestGranularity();
+    TestReuse();
+    TestExhaustion();
+
+    return UnitTest::Finish();
+}
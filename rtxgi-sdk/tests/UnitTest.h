@@ -0,0 +1,50 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Minimal unit test support shared by the SDK and Test Harness unit tests (no test framework dependency).
+// EXPECT() reports failed checks and keeps going; return UnitTest::Finish() from main().
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+#define EXPECT(x) UnitTest::Expect((x), #x, __FILE__, __LINE__)
+
+namespace UnitTest
+{
+    inline int& GetNumFailures()
+    {
+        static int numFailures = 0;
+        return numFailures;
+    }
+
+    inline void Expect(bool passed, const char* expression, const char* file, int line)
+    {
+        if (passed) return;
+        printf("%s(%d): check failed: %s\n", file, line, expression);
+        GetNumFailures()++;
+    }
+
+    /**
+     * Prints the result of the test and returns the process exit code.
+     */
+    inline int Finish()
+    {
+        if (GetNumFailures() > 0)
+        {
+            printf("%d check(s) failed\n", GetNumFailures());
+            return EXIT_FAILURE;
+        }
+
+        printf("All checks passed\n");
+        return EXIT_SUCCESS;
+    }
+}
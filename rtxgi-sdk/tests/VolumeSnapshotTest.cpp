@@ -0,0 +1,268 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Unit test of volume snapshots (DDGIVolumeSnapshot): serialization round trips with and without LZ compression,
+// rejection of corrupt snapshots by ValidateDDGIVolumeSnapshot(), and restoring snapshots into volumes.
+// Usage: rtxgi-volume-snapshot-test
+
+#include "rtxgi/ddgi/DDGIVolumeSnapshot.h"
+
+#include "UnitTest.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace rtxgi;
+
+namespace
+{
+    /**
+     * A CPU-only volume, enough to capture and restore snapshots.
+     */
+    class TestVolume : public DDGIVolumeBase
+    {
+    public:
+        TestVolume(EDDGIVolumeMovementType movementType = EDDGIVolumeMovementType::Default, float3 eulerAngles = { 0.f, 0.5f, 0.f })
+        {
+            m_desc.probeCounts = { 4, 2, 3 };
+            m_desc.probeSpacing = { 1.f, 2.f, 1.f };
+            m_desc.probeNumRays = 64;
+            m_desc.probeNumIrradianceInteriorTexels = 6;
+            m_desc.probeNumIrradianceTexels = 8;
+            m_desc.probeNumDistanceInteriorTexels = 14;
+            m_desc.probeNumDistanceTexels = 16;
+            m_desc.probeRayDataFormat = EDDGIVolumeTextureFormat::F32x2;
+            m_desc.probeIrradianceFormat = EDDGIVolumeTextureFormat::F32x4;
+            m_desc.probeDistanceFormat = EDDGIVolumeTextureFormat::F16x2;
+            m_desc.probeDataFormat = EDDGIVolumeTextureFormat::F16x4;
+            m_desc.probeVariabilityFormat = EDDGIVolumeTextureFormat::F16;
+            m_desc.probeRelocationEnabled = true;
+            m_desc.probeVariabilityEnabled = true;
+            SetEulerAngles(eulerAngles);
+            SetMovementType(movementType);
+        }
+
+        void Destroy() override {}
+    };
+
+    /**
+     * Fills the snapshot's textures with finite, deterministic values. Irradiance is smooth (it compresses), distance is
+     * pseudo-random (it doesn't), and the probe data and variability textures are constant (long overlapping matches).
+     */
+    void FillTextures(DDGIVolumeSnapshot& snapshot)
+    {
+        float* irradiance = (float*)snapshot.GetTextureData(EDDGIVolumeTextureType::Irradiance);
+        for (uint64_t index = 0; index < snapshot.GetTextureSizeInBytes(EDDGIVolumeTextureType::Irradiance) / sizeof(float); index++)
+        {
+            irradiance[index] = (float)(index / 16) * 0.125f;
+        }
+
+        uint32_t state = 7;
+        uint8_t* distance = snapshot.GetTextureData(EDDGIVolumeTextureType::Distance);
+        for (uint64_t index = 0; index < snapshot.GetTextureSizeInBytes(EDDGIVolumeTextureType::Distance); index++)
+        {
+            state = (state * 1664525u) + 1013904223u;
+            distance[index] = (uint8_t)(state >> 24) & 0x3F;   // keeps the F16 exponents finite
+        }
+
+        memset(snapshot.GetTextureData(EDDGIVolumeTextureType::Data), 0, snapshot.GetTextureSizeInBytes(EDDGIVolumeTextureType::Data));
+
+        uint16_t* variability = (uint16_t*)snapshot.GetTextureData(EDDGIVolumeTextureType::Variability);
+        for (uint64_t index = 0; index < snapshot.GetTextureSizeInBytes(EDDGIVolumeTextureType::Variability) / sizeof(uint16_t); index++)
+        {
+            variability[index] = 0x3C00;    // 1.0
+        }
+    }
+
+    bool IsSameTextures(const DDGIVolumeSnapshot& a, const DDGIVolumeSnapshot& b)
+    {
+        for (uint32_t type = 0; type < (uint32_t)EDDGIVolumeTextureType::Count; type++)
+        {
+            EDDGIVolumeTextureType textureType = (EDDGIVolumeTextureType)type;
+            if (a.HasTexture(textureType) != b.HasTexture(textureType)) return false;
+            if (!a.HasTexture(textureType)) continue;
+            if (a.GetTextureFormat(textureType) != b.GetTextureFormat(textureType)) return false;
+            if (a.GetTextureSizeInBytes(textureType) != b.GetTextureSizeInBytes(textureType)) return false;
+            if (memcmp(a.GetTextureData(textureType), b.GetTextureData(textureType), a.GetTextureSizeInBytes(textureType)) != 0) return false;
+        }
+        return true;
+    }
+
+    /**
+     * Captures a filled snapshot of a volume and serializes it.
+     */
+    void CreateSnapshot(const TestVolume& volume, DDGIVolumeSnapshot& snapshot, EDDGIVolumeSnapshotCompression compression)
+    {
+        EXPECT(snapshot.Capture(&volume) == ERTXGIStatus::OK);
+        FillTextures(snapshot);
+        EXPECT(snapshot.Serialize(compression) == ERTXGIStatus::OK);
+    }
+
+    /**
+     * Snapshots deserialize to the captured textures and constants, with and without LZ compression.
+     */
+    void TestRoundTrip()
+    {
+        TestVolume volume;
+        volume.SetOrigin({ 1.f, 2.f, 3.f });
+
+        DDGIVolumeSnapshot uncompressed, compressed;
+        CreateSnapshot(volume, uncompressed, EDDGIVolumeSnapshotCompression::None);
+        CreateSnapshot(volume, compressed, EDDGIVolumeSnapshotCompression::LZ);
+        EXPECT(uncompressed.HasTexture(EDDGIVolumeTextureType::Data) && uncompressed.HasTexture(EDDGIVolumeTextureType::Variability));
+        EXPECT(!uncompressed.HasTexture(EDDGIVolumeTextureType::RayData));
+
+        // Smooth and constant textures compress, the random distance texture is stored as-is
+        uint64_t textureBytes = 0;
+        for (uint32_t type = 0; type < (uint32_t)EDDGIVolumeTextureType::Count; type++) textureBytes += uncompressed.GetTextureSizeInBytes((EDDGIVolumeTextureType)type);
+        EXPECT(uncompressed.GetSerializedSizeInBytes() > textureBytes);
+        EXPECT(compressed.GetSerializedSizeInBytes() < uncompressed.GetSerializedSizeInBytes() - (textureBytes / 4));
+        EXPECT(compressed.GetSerializedSizeInBytes() > uncompressed.GetTextureSizeInBytes(EDDGIVolumeTextureType::Distance));
+
+        const DDGIVolumeSnapshot* snapshots[] = { &uncompressed, &compressed };
+        for (const DDGIVolumeSnapshot* snapshot : snapshots)
+        {
+            EXPECT(ValidateDDGIVolumeSnapshot(snapshot->GetSerializedData(), snapshot->GetSerializedSizeInBytes()) == ERTXGIStatus::OK);
+
+            DDGIVolumeSnapshot loaded;
+            EXPECT(loaded.Deserialize(snapshot->GetSerializedData(), snapshot->GetSerializedSizeInBytes()) == ERTXGIStatus::OK);
+            EXPECT(IsSameTextures(*snapshot, loaded));
+            DDGIVolumeDescGPUPacked expected = snapshot->GetDescGPUPacked();
+            DDGIVolumeDescGPUPacked actual = loaded.GetDescGPUPacked();
+            EXPECT(memcmp(&expected, &actual, sizeof(DDGIVolumeDescGPUPacked)) == 0);
+            EXPECT(loaded.GetDescGPU().origin.x == 1.f && loaded.GetDescGPU().origin.y == 2.f && loaded.GetDescGPU().origin.z == 3.f);
+        }
+
+        // Scroll offsets round trip
+        TestVolume scrolling(EDDGIVolumeMovementType::Scrolling);
+        scrolling.SetScrollOffsets({ 1, -2, 5 });
+
+        DDGIVolumeSnapshot snapshot, loaded;
+        CreateSnapshot(scrolling, snapshot, EDDGIVolumeSnapshotCompression::LZ);
+        EXPECT(loaded.Deserialize(snapshot.GetSerializedData(), snapshot.GetSerializedSizeInBytes()) == ERTXGIStatus::OK);
+        EXPECT(loaded.GetScrollOffsets().x == 1 && loaded.GetScrollOffsets().y == -2 && loaded.GetScrollOffsets().z == 5);
+    }
+
+    ERTXGIStatus Validate(const std::vector<uint8_t>& data, uint64_t size)
+    {
+        return ValidateDDGIVolumeSnapshot(data.data(), size);
+    }
+
+    /**
+     * Corrupt snapshots are rejected, and a failed Deserialize() leaves the snapshot empty.
+     */
+    void TestValidation()
+    {
+        TestVolume volume;
+        DDGIVolumeSnapshot snapshot;
+        CreateSnapshot(volume, snapshot, EDDGIVolumeSnapshotCompression::LZ);
+
+        const std::vector<uint8_t> valid(snapshot.GetSerializedData(), snapshot.GetSerializedData() + snapshot.GetSerializedSizeInBytes());
+        const uint64_t size = valid.size();
+        EXPECT(Validate(valid, size) == ERTXGIStatus::OK);
+
+        // Bad magic and version
+        std::vector<uint8_t> data = valid;
+        data[0] ^= 0xFF;
+        EXPECT(Validate(data, size) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT);
+
+        data = valid;
+        data[4]++;
+        EXPECT(Validate(data, size) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT_VERSION);
+
+        // Truncated data
+        EXPECT(ValidateDDGIVolumeSnapshot(nullptr, size) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT);
+        EXPECT(Validate(valid, 0) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT);
+        EXPECT(Validate(valid, 100) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT);
+        EXPECT(Validate(valid, 200) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT);
+        EXPECT(Validate(valid, size / 2) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT);
+        EXPECT(Validate(valid, size - 1) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT);
+
+        // Size mismatch: trailing bytes
+        data = valid;
+        data.push_back(0);
+        EXPECT(Validate(data, size + 1) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT);
+
+        // A texture table change without a matching hash (the table follows the 168B header)
+        data = valid;
+        data[168 + 8]++;
+        EXPECT(Validate(data, size) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT);
+
+        // Changed texture data fails its hash or doesn't decompress
+        data = valid;
+        data[size - 1] ^= 0x01;
+        EXPECT(Validate(data, size) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT_DATA);
+
+        DDGIVolumeSnapshot loaded;
+        EXPECT(loaded.Deserialize(valid.data(), size) == ERTXGIStatus::OK);
+        EXPECT(loaded.Deserialize(data.data(), size) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT_DATA);
+        EXPECT(!loaded.HasTexture(EDDGIVolumeTextureType::Irradiance));
+        EXPECT(loaded.Deserialize(valid.data(), size - 1) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT);
+
+        // Non-finite texels
+        uint32_t infinity = 0x7F800000;
+        memcpy(snapshot.GetTextureData(EDDGIVolumeTextureType::Irradiance), &infinity, sizeof(uint32_t));
+        EXPECT(snapshot.Serialize(EDDGIVolumeSnapshotCompression::None) == ERTXGIStatus::OK);
+        EXPECT(ValidateDDGIVolumeSnapshot(snapshot.GetSerializedData(), snapshot.GetSerializedSizeInBytes()) == ERTXGIStatus::ERROR_DDGI_INVALID_SNAPSHOT_DATA);
+    }
+
+    /**
+     * Snapshots restore into volumes with the same layout and rotation.
+     */
+    void TestRestore()
+    {
+        TestVolume source;
+        source.SetOrigin({ 1.f, 2.f, 3.f });
+
+        DDGIVolumeSnapshot snapshot, loaded;
+        CreateSnapshot(source, snapshot, EDDGIVolumeSnapshotCompression::LZ);
+        EXPECT(loaded.Deserialize(snapshot.GetSerializedData(), snapshot.GetSerializedSizeInBytes()) == ERTXGIStatus::OK);
+
+        // The origin is restored and the loaded probe data isn't reset
+        TestVolume volume;
+        volume.SetProbeRelocationNeedsReset(true);
+        EXPECT(loaded.Restore(&volume) == ERTXGIStatus::OK);
+        EXPECT(volume.GetOrigin().x == 1.f && volume.GetOrigin().y == 2.f && volume.GetOrigin().z == 3.f);
+        EXPECT(!volume.GetProbeRelocationNeedsReset());
+
+        // Incompatible volumes
+        EXPECT(loaded.Restore(nullptr) == ERTXGIStatus::ERROR_DDGI_INVALID_VOLUME);
+
+        TestVolume rotated(EDDGIVolumeMovementType::Default, { 0.f, 0.25f, 0.f });
+        EXPECT(loaded.Restore(&rotated) == ERTXGIStatus::ERROR_DDGI_SNAPSHOT_INCOMPATIBLE_VOLUME);
+
+        TestVolume spacing;
+        spacing.SetProbeSpacing({ 1.f, 1.f, 1.f });
+        EXPECT(loaded.Restore(&spacing) == ERTXGIStatus::ERROR_DDGI_SNAPSHOT_INCOMPATIBLE_VOLUME);
+
+        TestVolume scrolling(EDDGIVolumeMovementType::Scrolling);
+        EXPECT(loaded.Restore(&scrolling) == ERTXGIStatus::ERROR_DDGI_SNAPSHOT_INCOMPATIBLE_VOLUME);
+
+        // Scrolling volumes aren't rotated, their scroll offsets are restored and the scroll anchor follows the origin
+        TestVolume scrollingSource(EDDGIVolumeMovementType::Scrolling, { 0.f, 0.f, 0.f });
+        scrollingSource.SetOrigin({ 4.f, 0.f, 0.f });
+        scrollingSource.SetScrollOffsets({ 2, 0, -1 });
+
+        DDGIVolumeSnapshot scrollingSnapshot;
+        CreateSnapshot(scrollingSource, scrollingSnapshot, EDDGIVolumeSnapshotCompression::None);
+        EXPECT(scrollingSnapshot.Restore(&scrolling) == ERTXGIStatus::OK);
+        EXPECT(scrolling.GetScrollOffsets().x == 2 && scrolling.GetScrollOffsets().y == 0 && scrolling.GetScrollOffsets().z == -1);
+        EXPECT(scrolling.GetScrollAnchor().x == scrolling.GetOrigin().x && scrolling.GetScrollAnchor().z == scrolling.GetOrigin().z);
+    }
+}
+
+int main()
+{
+    TestRoundTrip();
+    TestValidation();
+    TestRestore();
+
+    return UnitTest::Finish();
+}
@@ -0,0 +1,50 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Json
+{
+    enum class EType
+    {
+        NUL = 0,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    /**
+     * A parsed JSON value. Object members are kept in file order.
+     */
+    struct Value
+    {
+        EType type = EType::NUL;
+        bool boolean = false;
+        double number = 0;
+        std::string string;
+        std::vector<Value> array;
+        std::vector<std::pair<std::string, Value>> object;
+
+        // Get an object member, nullptr when the value isn't an object or doesn't have the member
+        const Value* Find(const std::string& key) const;
+
+        double GetNumber(const std::string& key, double fallback = 0) const;
+        std::string GetString(const std::string& key, const std::string& fallback = "") const;
+    };
+
+    bool Parse(const std::string& text, Value& value, std::string& error);
+    bool Load(const std::string& file, Value& value, std::string& error);
+}
@@ -0,0 +1,79 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include <vector>
+
+namespace Statistics
+{
+    /**
+     * The result of a Mann-Whitney U test of two samples (a and b).
+     */
+    struct MannWhitneyResult
+    {
+        double u = 0;               // U statistic of sample b: the number of (a, b) pairs where b is larger (ties count 1/2)
+        double z = 0;               // normal approximation of U (tie-corrected), positive when b tends to be larger
+        double pGreater = 1;        // one-sided p-value of "b tends to be larger than a"
+        double pLess = 1;           // one-sided p-value of "b tends to be smaller than a"
+        double pTwoSided = 1;
+        double effectSize = 0.5;    // probability that a value of b is larger than a value of a (ties count 1/2)
+    };
+
+    /**
+     * Test whether the values of two samples come from the same distribution (Mann-Whitney U test, also known
+     * as the Wilcoxon rank-sum test). Makes no assumption about the shape of the distributions, so it's robust to
+     * the long tails and outliers of frame times. Uses the normal approximation, which needs about 20 values
+     * per sample or more.
+     */
+    MannWhitneyResult MannWhitneyU(const std::vector<double>& a, const std::vector<double>& b);
+
+    /**
+     * Get a percentile (in [0, 100]) of the values (nearest rank).
+     */
+    double GetPercentile(std::vector<double> values, double percentile);
+
+    enum class EVerdict
+    {
+        Unchanged = 0,
+        Regression,
+        Improvement
+    };
+
+    /**
+     * Thresholds of a change. A change must be statistically significant and larger than both the relative and
+     * the absolute thresholds.
+     */
+    struct CompareDesc
+    {
+        double alpha = 0.01;        // significance level of the Mann-Whitney U test
+        double threshold = 0.05;    // relative increase of the median or p99 that is a regression
+        double minDelta = 0.05;     // increases (in milliseconds) below this are never regressions
+    };
+
+    /**
+     * The comparison of a stat's baseline and candidate samples.
+     */
+    struct Comparison
+    {
+        double baseMedian = 0;
+        double nextMedian = 0;
+        double baseP99 = 0;
+        double nextP99 = 0;
+        MannWhitneyResult test;
+        EVerdict verdict = EVerdict::Unchanged;
+    };
+
+    /**
+     * Compare the samples of a stat. The candidate (next) regresses when its values are significantly larger and
+     * its median or 99th percentile increased by more than the thresholds, and improves in the opposite case.
+     */
+    Comparison Compare(const std::vector<double>& base, const std::vector<double>& next, const CompareDesc& desc);
+}
@@ -0,0 +1,299 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "Json.h"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace Json
+{
+
+    //----------------------------------------------------------------------------------------------------------
+    // Private Functions
+    //----------------------------------------------------------------------------------------------------------
+
+    // Maximum nesting depth of arrays and objects
+    const static int MaxDepth = 64;
+
+    struct Parser
+    {
+        const char* cursor;
+        const char* end;
+        std::string error;
+    };
+
+    bool Fail(Parser& parser, const char* message)
+    {
+        if (parser.error.empty()) parser.error = message;
+        return false;
+    }
+
+    void SkipWhitespace(Parser& parser)
+    {
+        while (parser.cursor < parser.end && (*parser.cursor == ' ' || *parser.cursor == '\t' || *parser.cursor == '\n' || *parser.cursor == '\r')) parser.cursor++;
+    }
+
+    bool Match(Parser& parser, const char* literal)
+    {
+        size_t length = strlen(literal);
+        if (static_cast<size_t>(parser.end - parser.cursor) < length || strncmp(parser.cursor, literal, length) != 0) return false;
+        parser.cursor += length;
+        return true;
+    }
+
+    void AppendUTF8(std::string& out, uint32_t codepoint)
+    {
+        if (codepoint < 0x80)
+        {
+            out += static_cast<char>(codepoint);
+        }
+        else if (codepoint < 0x800)
+        {
+            out += static_cast<char>(0xC0 | (codepoint >> 6));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else if (codepoint < 0x10000)
+        {
+            out += static_cast<char>(0xE0 | (codepoint >> 12));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+        else
+        {
+            out += static_cast<char>(0xF0 | (codepoint >> 18));
+            out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    bool ParseHex4(Parser& parser, uint32_t& value)
+    {
+        if (parser.end - parser.cursor < 4) return Fail(parser, "truncated unicode escape");
+        value = 0;
+        for (int index = 0; index < 4; index++)
+        {
+            char c = *parser.cursor++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= static_cast<uint32_t>(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= static_cast<uint32_t>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= static_cast<uint32_t>(c - 'A' + 10);
+            else return Fail(parser, "invalid unicode escape");
+        }
+        return true;
+    }
+
+    bool ParseString(Parser& parser, std::string& out)
+    {
+        parser.cursor++; // opening quote
+        out.clear();
+        while (parser.cursor < parser.end)
+        {
+            char c = *parser.cursor++;
+            if (c == '"') return true;
+            if (static_cast<unsigned char>(c) < 0x20) return Fail(parser, "control character in string");
+            if (c != '\\')
+            {
+                out += c;
+                continue;
+            }
+
+            if (parser.cursor >= parser.end) break;
+            c = *parser.cursor++;
+            switch (c)
+            {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u':
+                {
+                    uint32_t codepoint;
+                    if (!ParseHex4(parser, codepoint)) return false;
+                    if (codepoint >= 0xD800 && codepoint < 0xDC00)
+                    {
+                        // Surrogate pair
+                        uint32_t low;
+                        if (!Match(parser, "\\u") || !ParseHex4(parser, low) || low < 0xDC00 || low > 0xDFFF) return Fail(parser, "invalid surrogate pair");
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    AppendUTF8(out, codepoint);
+                    break;
+                }
+                default: return Fail(parser, "invalid escape sequence");
+            }
+        }
+        return Fail(parser, "unterminated string");
+    }
+
+    bool ParseNumber(Parser& parser, double& out)
+    {
+        // Validate the JSON number grammar, then convert with strtod
+        const char* start = parser.cursor;
+        const char* c = parser.cursor;
+        if (c < parser.end && *c == '-') c++;
+        if (c >= parser.end || !isdigit(static_cast<unsigned char>(*c))) return Fail(parser, "invalid number");
+        if (*c == '0') c++;
+        else while (c < parser.end && isdigit(static_cast<unsigned char>(*c))) c++;
+        if (c < parser.end && *c == '.')
+        {
+            c++;
+            if (c >= parser.end || !isdigit(static_cast<unsigned char>(*c))) return Fail(parser, "invalid number");
+            while (c < parser.end && isdigit(static_cast<unsigned char>(*c))) c++;
+        }
+        if (c < parser.end && (*c == 'e' || *c == 'E'))
+        {
+            c++;
+            if (c < parser.end && (*c == '+' || *c == '-')) c++;
+            if (c >= parser.end || !isdigit(static_cast<unsigned char>(*c))) return Fail(parser, "invalid number");
+            while (c < parser.end && isdigit(static_cast<unsigned char>(*c))) c++;
+        }
+
+        std::string text(start, c);
+        out = strtod(text.c_str(), nullptr);
+        parser.cursor = c;
+        return true;
+    }
+
+    bool ParseValue(Parser& parser, Value& value, int depth)
+    {
+        if (depth > MaxDepth) return Fail(parser, "nesting too deep");
+
+        SkipWhitespace(parser);
+        if (parser.cursor >= parser.end) return Fail(parser, "unexpected end of input");
+
+        char c = *parser.cursor;
+        if (c == '{')
+        {
+            value.type = EType::OBJECT;
+            parser.cursor++;
+            SkipWhitespace(parser);
+            if (parser.cursor < parser.end && *parser.cursor == '}') { parser.cursor++; return true; }
+            while (true)
+            {
+                SkipWhitespace(parser);
+                if (parser.cursor >= parser.end || *parser.cursor != '"') return Fail(parser, "expected an object key");
+
+                std::pair<std::string, Value> member;
+                if (!ParseString(parser, member.first)) return false;
+                SkipWhitespace(parser);
+                if (!Match(parser, ":")) return Fail(parser, "expected ':'");
+                if (!ParseValue(parser, member.second, depth + 1)) return false;
+                value.object.push_back(std::move(member));
+
+                SkipWhitespace(parser);
+                if (Match(parser, ",")) continue;
+                if (Match(parser, "}")) return true;
+                return Fail(parser, "expected ',' or '}'");
+            }
+        }
+        if (c == '[')
+        {
+            value.type = EType::ARRAY;
+            parser.cursor++;
+            SkipWhitespace(parser);
+            if (parser.cursor < parser.end && *parser.cursor == ']') { parser.cursor++; return true; }
+            while (true)
+            {
+                value.array.emplace_back();
+                if (!ParseValue(parser, value.array.back(), depth + 1)) return false;
+
+                SkipWhitespace(parser);
+                if (Match(parser, ",")) continue;
+                if (Match(parser, "]")) return true;
+                return Fail(parser, "expected ',' or ']'");
+            }
+        }
+        if (c == '"')
+        {
+            value.type = EType::STRING;
+            return ParseString(parser, value.string);
+        }
+        if (Match(parser, "true")) { value.type = EType::BOOLEAN; value.boolean = true; return true; }
+        if (Match(parser, "false")) { value.type = EType::BOOLEAN; value.boolean = false; return true; }
+        if (Match(parser, "null")) { value.type = EType::NUL; return true; }
+
+        value.type = EType::NUMBER;
+        return ParseNumber(parser, value.number);
+    }
+
+    //----------------------------------------------------------------------------------------------------------
+    // Public Functions
+    //----------------------------------------------------------------------------------------------------------
+
+    const Value* Value::Find(const std::string& key) const
+    {
+        if (type != EType::OBJECT) return nullptr;
+        for (const std::pair<std::string, Value>& member : object)
+        {
+            if (member.first == key) return &member.second;
+        }
+        return nullptr;
+    }
+
+    double Value::GetNumber(const std::string& key, double fallback) const
+    {
+        const Value* member = Find(key);
+        return (member && member->type == EType::NUMBER) ? member->number : fallback;
+    }
+
+    std::string Value::GetString(const std::string& key, const std::string& fallback) const
+    {
+        const Value* member = Find(key);
+        return (member && member->type == EType::STRING) ? member->string : fallback;
+    }
+
+    /**
+     * Parse a JSON document. On failure, error describes the problem and its offset.
+     */
+    bool Parse(const std::string& text, Value& value, std::string& error)
+    {
+        Parser parser = { text.data(), text.data() + text.size(), "" };
+        value = Value();
+
+        bool result = ParseValue(parser, value, 0);
+        if (result)
+        {
+            SkipWhitespace(parser);
+            if (parser.cursor != parser.end) result = Fail(parser, "unexpected data after the document");
+        }
+
+        if (!result)
+        {
+            error = parser.error + " (at offset " + std::to_string(parser.cursor - text.data()) + ")";
+            value = Value();
+        }
+        return result;
+    }
+
+    bool Load(const std::string& file, Value& value, std::string& error)
+    {
+        std::ifstream in(file, std::ios::in | std::ios::binary);
+        if (!in.is_open())
+        {
+            error = "can't open the file";
+            return false;
+        }
+
+        std::stringstream text;
+        text << in.rdbuf();
+        return Parse(text.str(), value, error);
+    }
+
+}
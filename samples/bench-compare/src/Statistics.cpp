@@ -0,0 +1,120 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "Statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace Statistics
+{
+
+    //----------------------------------------------------------------------------------------------------------
+    // Private Functions
+    //----------------------------------------------------------------------------------------------------------
+
+    /**
+     * Probability that a standard normal variable is larger than z.
+     */
+    double GetNormalTail(double z)
+    {
+        return 0.5 * erfc(z / sqrt(2.0));
+    }
+
+    //----------------------------------------------------------------------------------------------------------
+    // Public Functions
+    //----------------------------------------------------------------------------------------------------------
+
+    MannWhitneyResult MannWhitneyU(const std::vector<double>& a, const std::vector<double>& b)
+    {
+        MannWhitneyResult result = {};
+        if (a.empty() || b.empty()) return result;
+
+        // Rank the values of both samples together (second: true for values of b)
+        std::vector<std::pair<double, bool>> values;
+        values.reserve(a.size() + b.size());
+        for (double value : a) values.push_back({ value, false });
+        for (double value : b) values.push_back({ value, true });
+        std::sort(values.begin(), values.end(), [](const std::pair<double, bool>& x, const std::pair<double, bool>& y) { return x.first < y.first; });
+
+        // Sum the ranks of b; tied values share the average of their ranks
+        double n = static_cast<double>(values.size());
+        double rankSumB = 0;
+        double tieCorrection = 0;   // sum of (t^3 - t) over groups of t tied values
+        size_t first = 0;
+        while (first < values.size())
+        {
+            size_t last = first;
+            while (last + 1 < values.size() && values[last + 1].first == values[first].first) last++;
+
+            double rank = (static_cast<double>(first + last) / 2.0) + 1.0;
+            for (size_t index = first; index <= last; index++)
+            {
+                if (values[index].second) rankSumB += rank;
+            }
+
+            double ties = static_cast<double>(last - first + 1);
+            tieCorrection += (ties * ties * ties) - ties;
+            first = last + 1;
+        }
+
+        double na = static_cast<double>(a.size());
+        double nb = static_cast<double>(b.size());
+        result.u = rankSumB - ((nb * (nb + 1.0)) / 2.0);
+        result.effectSize = result.u / (na * nb);
+
+        // Normal approximation of U, with tie and continuity corrections
+        double mean = (na * nb) / 2.0;
+        double variance = ((na * nb) / 12.0) * ((n + 1.0) - (tieCorrection / (n * (n - 1.0))));
+        if (variance <= 0) return result;   // all values are equal
+
+        double sigma = sqrt(variance);
+        double delta = result.u - mean;
+        result.z = delta / sigma;
+        result.pGreater = GetNormalTail((delta - 0.5) / sigma);
+        result.pLess = GetNormalTail((-delta - 0.5) / sigma);
+        result.pTwoSided = std::min(1.0, 2.0 * GetNormalTail((fabs(delta) - 0.5) / sigma));
+        return result;
+    }
+
+    double GetPercentile(std::vector<double> values, double percentile)
+    {
+        if (values.empty()) return 0;
+
+        double rank = ceil((std::min(std::max(percentile, 0.0), 100.0) / 100.0) * static_cast<double>(values.size()));
+        size_t index = static_cast<size_t>(std::max(rank, 1.0)) - 1;
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+
+    Comparison Compare(const std::vector<double>& base, const std::vector<double>& next, const CompareDesc& desc)
+    {
+        Comparison result;
+        result.baseMedian = GetPercentile(base, 50.0);
+        result.nextMedian = GetPercentile(next, 50.0);
+        result.baseP99 = GetPercentile(base, 99.0);
+        result.nextP99 = GetPercentile(next, 99.0);
+        result.test = MannWhitneyU(base, next);
+
+        auto isLarger = [&desc](double from, double to) { return (to - from) > std::max(from * desc.threshold, desc.minDelta); };
+
+        if (result.test.pGreater < desc.alpha && (isLarger(result.baseMedian, result.nextMedian) || isLarger(result.baseP99, result.nextP99)))
+        {
+            result.verdict = EVerdict::Regression;
+        }
+        else if (result.test.pLess < desc.alpha && (isLarger(result.nextMedian, result.baseMedian) || isLarger(result.nextP99, result.baseP99)))
+        {
+            result.verdict = EVerdict::Improvement;
+        }
+        return result;
+    }
+
+}
@@ -0,0 +1,292 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "Json.h"
+#include "Statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Exit codes
+const static int ExitNoRegression = 0;
+const static int ExitRegression = 1;
+const static int ExitError = 2;
+
+// The benchmark.json format version this tool reads (see Benchmark::BenchmarkResultsVersion)
+const static double BenchmarkResultsVersion = 1;
+
+// Stats with fewer samples aren't tested (the test's normal approximation needs about 20 samples)
+const static size_t MinSamples = 20;
+
+struct Options
+{
+    std::string baseline;
+    std::string candidate;
+    Statistics::CompareDesc compare;
+    bool cpu = true;
+    bool gpu = true;
+    std::vector<std::string> stats;
+};
+
+struct Stat
+{
+    std::string type;
+    std::string name;
+    std::vector<double> samples;
+};
+
+struct Results
+{
+    Json::Value document;
+    std::vector<Stat> stats;
+};
+
+void PrintUsage()
+{
+    printf(
+        "Usage: rtxgi-bench-compare <baseline.json> <candidate.json> [options]\n"
+        "\n"
+        "Compares the per-frame CPU and GPU times of two Test Harness benchmark results with a Mann-Whitney U test.\n"
+        "A stat regresses when the candidate's times are significantly larger and its median or 99th percentile\n"
+        "increased by more than the threshold (and by more than the minimum delta).\n"
+        "\n"
+        "Options:\n"
+        "  --alpha <p>          significance level (default 0.01)\n"
+        "  --threshold <ratio>  relative increase of the median or p99 that is a regression (default 0.05)\n"
+        "  --min-delta <ms>     smallest increase, in milliseconds, that is a regression (default 0.05)\n"
+        "  --stat <name>        compare the named stat only (repeatable), e.g. \"Frame\" or \"gpu:Frame\"\n"
+        "  --cpu                compare CPU stats only\n"
+        "  --gpu                compare GPU stats only\n"
+        "\n"
+        "Exits with 0 when no stat regressed, 1 when a stat regressed, and 2 on errors (including stats missing\n"
+        "from the candidate).\n");
+}
+
+bool ParseNumberArgument(const std::vector<std::string>& arguments, size_t& index, double& value)
+{
+    if (index + 1 >= arguments.size()) return false;
+    char* end = nullptr;
+    value = strtod(arguments[++index].c_str(), &end);
+    return (end != nullptr && *end == '\0' && std::isfinite(value) && value >= 0);
+}
+
+bool ParseCommandLine(const std::vector<std::string>& arguments, Options& options)
+{
+    std::vector<std::string> files;
+    for (size_t index = 0; index < arguments.size(); index++)
+    {
+        const std::string& argument = arguments[index];
+        if (argument == "--alpha") { if (!ParseNumberArgument(arguments, index, options.compare.alpha)) return false; }
+        else if (argument == "--threshold") { if (!ParseNumberArgument(arguments, index, options.compare.threshold)) return false; }
+        else if (argument == "--min-delta") { if (!ParseNumberArgument(arguments, index, options.compare.minDelta)) return false; }
+        else if (argument == "--stat")
+        {
+            if (index + 1 >= arguments.size()) return false;
+            options.stats.push_back(arguments[++index]);
+        }
+        else if (argument == "--cpu") { options.cpu = true; options.gpu = false; }
+        else if (argument == "--gpu") { options.cpu = false; options.gpu = true; }
+        else if (argument.size() > 1 && argument[0] == '-') return false;
+        else files.push_back(argument);
+    }
+
+    if (files.size() != 2) return false;
+    options.baseline = files[0];
+    options.candidate = files[1];
+    return true;
+}
+
+std::string Trim(const std::string& value)
+{
+    size_t first = value.find_first_not_of(' ');
+    if (first == std::string::npos) return "";
+    return value.substr(first, value.find_last_not_of(' ') - first + 1);
+}
+
+/**
+ * Load a benchmark.json file and gather the samples of its stats.
+ */
+bool LoadResults(const std::string& file, Results& results)
+{
+    std::string error;
+    if (!Json::Load(file, results.document, error))
+    {
+        fprintf(stderr, "Error: failed to read '%s': %s\n", file.c_str(), error.c_str());
+        return false;
+    }
+
+    if (results.document.GetString("format") != "rtxgi-benchmark")
+    {
+        fprintf(stderr, "Error: '%s' isn't a benchmark result file!\n", file.c_str());
+        return false;
+    }
+    if (results.document.GetNumber("version") != BenchmarkResultsVersion)
+    {
+        fprintf(stderr, "Error: '%s' has an unsupported version (%g)!\n", file.c_str(), results.document.GetNumber("version"));
+        return false;
+    }
+
+    const char* types[] = { "cpu", "gpu" };
+    for (const char* type : types)
+    {
+        const Json::Value* stats = results.document.Find(type);
+        if (stats == nullptr || stats->type != Json::EType::ARRAY) continue;
+
+        for (const Json::Value& value : stats->array)
+        {
+            const Json::Value* samples = value.Find("samples");
+            if (samples == nullptr || samples->type != Json::EType::ARRAY) continue;
+
+            Stat stat;
+            stat.type = type;
+            stat.name = Trim(value.GetString("name"));
+            for (const Json::Value& sample : samples->array)
+            {
+                if (sample.type == Json::EType::NUMBER && std::isfinite(sample.number)) stat.samples.push_back(sample.number);
+            }
+            results.stats.push_back(std::move(stat));
+        }
+    }
+    return true;
+}
+
+const Stat* FindStat(const Results& results, const std::string& type, const std::string& name)
+{
+    for (const Stat& stat : results.stats)
+    {
+        if (stat.type == type && stat.name == name) return &stat;
+    }
+    return nullptr;
+}
+
+bool IsSelected(const Options& options, const Stat& stat)
+{
+    if (stat.type == "cpu" && !options.cpu) return false;
+    if (stat.type == "gpu" && !options.gpu) return false;
+    if (options.stats.empty()) return true;
+
+    for (const std::string& selected : options.stats)
+    {
+        if (selected == stat.name || selected == (stat.type + ":" + stat.name)) return true;
+    }
+    return false;
+}
+
+/**
+ * Warn when the runs were made with different setups, which makes their times incomparable.
+ */
+void CompareMetadata(const Results& baseline, const Results& candidate)
+{
+    const Json::Value* baselineMetadata = baseline.document.Find("metadata");
+    const Json::Value* candidateMetadata = candidate.document.Find("metadata");
+    if (baselineMetadata == nullptr || candidateMetadata == nullptr) return;
+
+    const char* keys[] = { "gpu", "api", "config", "scene" };
+    for (const char* key : keys)
+    {
+        std::string baselineValue = baselineMetadata->GetString(key);
+        std::string candidateValue = candidateMetadata->GetString(key);
+        if (baselineValue != candidateValue)
+        {
+            printf("Warning: the runs have different %s values ('%s' and '%s')\n", key, baselineValue.c_str(), candidateValue.c_str());
+        }
+    }
+
+    if (baselineMetadata->GetNumber("width") != candidateMetadata->GetNumber("width") || baselineMetadata->GetNumber("height") != candidateMetadata->GetNumber("height"))
+    {
+        printf("Warning: the runs have different resolutions\n");
+    }
+
+    printf("Baseline:  %s (%s)\n", baselineMetadata->GetString("git").c_str(), baselineMetadata->GetString("gpu").c_str());
+    printf("Candidate: %s (%s)\n\n", candidateMetadata->GetString("git").c_str(), candidateMetadata->GetString("gpu").c_str());
+}
+
+double GetChange(double from, double to)
+{
+    return (from > 0) ? ((to - from) / from) * 100.0 : 0.0;
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<std::string> arguments(argv + 1, argv + argc);
+
+    Options options;
+    if (!ParseCommandLine(arguments, options))
+    {
+        PrintUsage();
+        return ExitError;
+    }
+
+    Results baseline, candidate;
+    if (!LoadResults(options.baseline, baseline)) return ExitError;
+    if (!LoadResults(options.candidate, candidate)) return ExitError;
+
+    CompareMetadata(baseline, candidate);
+
+    printf("%-4s %-24s %10s %10s %8s %10s %10s %8s %10s  %s\n", "", "Stat", "Base p50", "New p50", "p50 %", "Base p99", "New p99", "p99 %", "p-value", "Result");
+
+    uint32_t numCompared = 0;
+    uint32_t numRegressions = 0;
+    uint32_t numMissing = 0;
+    for (const Stat& base : baseline.stats)
+    {
+        if (!IsSelected(options, base)) continue;
+
+        const Stat* next = FindStat(candidate, base.type, base.name);
+        if (next == nullptr)
+        {
+            printf("%-4s %-24s %s\n", base.type.c_str(), base.name.c_str(), "MISSING from the candidate");
+            numMissing++;
+            continue;
+        }
+        if (base.samples.size() < MinSamples || next->samples.size() < MinSamples) continue;
+
+        Statistics::Comparison comparison = Statistics::Compare(base.samples, next->samples, options.compare);
+
+        const char* verdict = "";
+        if (comparison.verdict == Statistics::EVerdict::Regression)
+        {
+            verdict = "REGRESSION";
+            numRegressions++;
+        }
+        else if (comparison.verdict == Statistics::EVerdict::Improvement)
+        {
+            verdict = "improvement";
+        }
+
+        printf("%-4s %-24s %10.4f %10.4f %+7.2f%% %10.4f %10.4f %+7.2f%% %10.2e  %s\n",
+            base.type.c_str(), base.name.c_str(),
+            comparison.baseMedian, comparison.nextMedian, GetChange(comparison.baseMedian, comparison.nextMedian),
+            comparison.baseP99, comparison.nextP99, GetChange(comparison.baseP99, comparison.nextP99),
+            std::min(comparison.test.pGreater, comparison.test.pLess), verdict);
+        numCompared++;
+    }
+
+    // A stat missing from the candidate can't be checked, so it fails the comparison
+    if (numMissing > 0)
+    {
+        fprintf(stderr, "Error: %u stat(s) of the baseline are missing from the candidate!\n", numMissing);
+        return ExitError;
+    }
+
+    if (numCompared == 0)
+    {
+        fprintf(stderr, "Error: no stats to compare!\n");
+        return ExitError;
+    }
+
+    printf("\n%u stat(s) compared, %u regression(s)\n", numCompared, numRegressions);
+    return (numRegressions > 0) ? ExitRegression : ExitNoRegression;
+}
@@ -0,0 +1,143 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Unit test of the benchmark comparison statistics: Mann-Whitney U values of fixed samples, percentiles,
+// and the regression / improvement decision.
+// Usage: rtxgi-bench-compare-test
+
+#include "Statistics.h"
+
+#include "UnitTest.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace Statistics;
+
+namespace
+{
+    bool IsNear(double a, double b, double tolerance = 1e-6)
+    {
+        return std::abs(a - b) <= tolerance;
+    }
+
+    /**
+     * Frame times of a run: base plus a small, evenly spread jitter.
+     */
+    std::vector<double> CreateSamples(double base, double scale = 1.0)
+    {
+        std::vector<double> samples;
+        for (int index = 0; index < 30; index++) samples.push_back((base + ((index % 10) * 0.002) + (index * 0.0001)) * scale);
+        return samples;
+    }
+
+    /**
+     * U, z, and p-values of small samples, checked against the textbook formulas (normal approximation with tie
+     * and continuity corrections).
+     */
+    void TestMannWhitneyU()
+    {
+        // b is larger in every pair
+        MannWhitneyResult result = MannWhitneyU({ 1, 2, 3, 4, 5 }, { 6, 7, 8, 9, 10 });
+        EXPECT(result.u == 25.0);
+        EXPECT(result.effectSize == 1.0);
+        EXPECT(IsNear(result.z, 2.6111648393));
+        EXPECT(IsNear(result.pGreater, 0.0060928902));
+        EXPECT(IsNear(result.pLess, 0.9966923245));
+        EXPECT(IsNear(result.pTwoSided, 0.0121857804));
+
+        // Swapping the samples swaps the one-sided p-values
+        MannWhitneyResult swapped = MannWhitneyU({ 6, 7, 8, 9, 10 }, { 1, 2, 3, 4, 5 });
+        EXPECT(swapped.u == 0.0);
+        EXPECT(IsNear(swapped.pGreater, result.pLess));
+        EXPECT(IsNear(swapped.pLess, result.pGreater));
+        EXPECT(IsNear(swapped.pTwoSided, result.pTwoSided));
+
+        // Ties share their average rank and reduce the variance
+        result = MannWhitneyU({ 1, 1, 2, 2 }, { 2, 3, 3, 3 });
+        EXPECT(result.u == 15.0);
+        EXPECT(result.effectSize == 0.9375);
+        EXPECT(IsNear(result.z, 2.1385353243));
+        EXPECT(IsNear(result.pGreater, 0.0235287231));
+        EXPECT(IsNear(result.pTwoSided, 0.0470574463));
+
+        // Interleaved samples
+        result = MannWhitneyU({ 1, 3, 5, 7 }, { 2, 4, 6, 8 });
+        EXPECT(result.u == 10.0);
+        EXPECT(IsNear(result.pGreater, 0.3325027711));
+        EXPECT(IsNear(result.pLess, 0.7647567890));
+
+        // Equal and empty samples have no difference
+        result = MannWhitneyU({ 2, 2, 2 }, { 2, 2 });
+        EXPECT(result.effectSize == 0.5 && result.pGreater == 1.0 && result.pLess == 1.0);
+        result = MannWhitneyU({}, { 1, 2 });
+        EXPECT(result.u == 0.0 && result.pTwoSided == 1.0);
+    }
+
+    /**
+     * Nearest rank percentiles.
+     */
+    void TestPercentile()
+    {
+        std::vector<double> values = { 5, 1, 4, 2, 3 };
+        EXPECT(GetPercentile(values, 0.0) == 1.0);
+        EXPECT(GetPercentile(values, 50.0) == 3.0);
+        EXPECT(GetPercentile(values, 99.0) == 5.0);
+        EXPECT(GetPercentile(values, 100.0) == 5.0);
+        EXPECT(GetPercentile({}, 50.0) == 0.0);
+    }
+
+    /**
+     * Changes must be significant and larger than both the relative and the absolute thresholds.
+     */
+    void TestCompare()
+    {
+        CompareDesc desc;
+        std::vector<double> base = CreateSamples(2.0);
+
+        EXPECT(Compare(base, base, desc).verdict == EVerdict::Unchanged);
+        EXPECT(Compare(base, CreateSamples(2.0, 1.2), desc).verdict == EVerdict::Regression);
+        EXPECT(Compare(base, CreateSamples(2.0, 0.8), desc).verdict == EVerdict::Improvement);
+
+        // Significant, but below the relative threshold (+4%)
+        Comparison comparison = Compare(base, CreateSamples(2.0, 1.04), desc);
+        EXPECT(comparison.test.pGreater < desc.alpha);
+        EXPECT(comparison.verdict == EVerdict::Unchanged);
+
+        desc.threshold = 0.01;
+        EXPECT(Compare(base, CreateSamples(2.0, 1.04), desc).verdict == EVerdict::Regression);
+
+        // Significant and above the relative threshold, but below the absolute threshold (+0.04ms)
+        std::vector<double> small = CreateSamples(0.2);
+        comparison = Compare(small, CreateSamples(0.2, 1.2), desc);
+        EXPECT(comparison.test.pGreater < desc.alpha);
+        EXPECT(comparison.verdict == EVerdict::Unchanged);
+
+        desc.minDelta = 0.01;
+        EXPECT(Compare(small, CreateSamples(0.2, 1.2), desc).verdict == EVerdict::Regression);
+
+        // Large, but not significant at the significance level
+        std::vector<double> next = base;
+        next[29] = 4.0;
+        comparison = Compare(base, next, desc);
+        EXPECT(comparison.nextP99 == 4.0);
+        EXPECT(comparison.test.pGreater >= desc.alpha);
+        EXPECT(comparison.verdict == EVerdict::Unchanged);
+    }
+}
+
+int main()
+{
+    TestMannWhitneyU();
+    TestPercentile();
+    TestCompare();
+
+    return UnitTest::Finish();
+}
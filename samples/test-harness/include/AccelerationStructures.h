@@ -0,0 +1,61 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+#pragma once
+
+#include "Scenes.h"
+
+namespace AccelerationStructures
+{
+    enum class ETLASUpdate
+    {
+        NONE = 0,   // no instance changed, the TLAS is current
+        REFIT,      // update the TLAS in place (refit the existing hierarchy to the changed instances)
+        REBUILD     // build the TLAS from scratch
+    };
+
+    /**
+     * When to rebuild the scene TLAS instead of refitting it.
+     * Refitting keeps the hierarchy of the last build, so its quality degrades as instances move away from where they were built.
+     */
+    struct TLASPolicy
+    {
+        float    maxMotion = 0.5f;      // accumulated instance motion (in scene bounding box diagonals) that triggers a rebuild
+        uint32_t maxRefits = 0;         // number of refits that triggers a rebuild, 0 for no limit
+    };
+
+    struct InstanceRange
+    {
+        uint32_t first = 0;
+        uint32_t count = 0;
+    };
+
+    /**
+     * Tracks the motion of the scene's mesh instances since the TLAS was last built.
+     * The motion of an instance is the distance between its bounding box (center and extents) and its bounding box at the last build.
+     */
+    struct TLASUpdateState
+    {
+        std::vector<rtxgi::AABB>   builtBoxes;          // instance bounding boxes at the last build
+        std::vector<float>         motion;              // motion of each instance since the last build
+        std::vector<InstanceRange> ranges;              // the instances changed in the last update, as contiguous ranges
+        double                     totalMotion = 0.0;   // sum of the instance motion
+        float                      sceneDiagonal = 0.f; // scene bounding box diagonal at the last build
+        uint32_t                   numRefits = 0;       // refits since the last build
+        uint64_t                   numUpdates = 0;      // totals, for statistics
+        uint64_t                   numRebuilds = 0;
+
+        float GetMotion() const { return (sceneDiagonal > 0.f) ? static_cast<float>(totalMotion) / sceneDiagonal : 0.f; }
+    };
+
+    void GetInstanceRanges(const std::vector<uint32_t>& instances, std::vector<InstanceRange>& ranges);
+
+    void Reset(TLASUpdateState& state, const Scenes::Scene& scene);
+    ETLASUpdate Update(TLASUpdateState& state, const TLASPolicy& policy, const Scenes::Scene& scene);
+}
@@ -18,14 +18,25 @@
 
 namespace Benchmark
 {
-    const static uint32_t NumBenchmarkFrames = 1024;
+    const static uint32_t BenchmarkResultsVersion = 1;    // version of the benchmark.json format
 
     struct BenchmarkRun
     {
+        uint32_t numWarmupFrames = 0;
         uint32_t numFramesBenched = 0;
+        uint32_t nextLightEvent = 0;
+        uint32_t nextVolumeEvent = 0;
         std::stringstream cpuTimingCsv;
         std::stringstream gpuTimingCsv;
+
+        // The state the scenario changes, restored when the benchmark ends
+        uint32_t activeCamera = 0;
+        std::vector<Scenes::Camera> cameras;
+        std::vector<Graphics::Light> lights;
+        std::vector<uint8_t> volumeUpdateEnabled;
+        std::vector<rtxgi::float3> volumeScrollAnchors;
     };
-    void StartBenchmark(BenchmarkRun& benchmarkRun, Instrumentation::Performance& perf, Configs::Config& config, Graphics::Globals& gfx);
-    bool UpdateBenchmark(BenchmarkRun& benchmarkRun, Instrumentation::Performance& perf, Configs::Config& config, Graphics::Globals& gfx, std::ofstream& log);
+    void StartBenchmark(BenchmarkRun& benchmarkRun, Instrumentation::Performance& perf, Configs::Config& config, Scenes::Scene& scene, std::vector<rtxgi::DDGIVolumeBase*>& volumes, Graphics::Globals& gfx);
+    void UpdateScenario(BenchmarkRun& benchmarkRun, Configs::Config& config, Scenes::Scene& scene, std::vector<rtxgi::DDGIVolumeBase*>& volumes, Graphics::Globals& gfx);
+    bool UpdateBenchmark(BenchmarkRun& benchmarkRun, Instrumentation::Performance& perf, Configs::Config& config, Scenes::Scene& scene, std::vector<rtxgi::DDGIVolumeBase*>& volumes, Graphics::Globals& gfx, std::ofstream& log);
 }
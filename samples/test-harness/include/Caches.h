@@ -14,6 +14,40 @@
 
 namespace Caches
 {
+    struct StreamedPrimitive
+    {
+        bool     written = false;
+        uint32_t numVertices = 0;
+        uint32_t numIndices = 0;
+        uint64_t vertexOffset = 0;      // in bytes, from the start of the BLOBS section
+        uint64_t indexOffset = 0;       // in bytes, from the start of the BLOBS section
+    };
+
+    /**
+     * A scene cache file that is written while the scene is imported.
+     * Mesh primitive vertex and index data is written to the file as soon as it is converted (WritePrimitive()),
+     * so the scene's geometry is never held in memory in full. Finish() writes the rest of the scene.
+     * The file is written to <filepath>.tmp and replaces the cache file once complete.
+     */
+    struct Stream
+    {
+        std::string                    filepath;
+        std::ofstream                  out;
+        uint64_t                       blobBytes = 0;
+        uint64_t                       numBlobs = 0;
+        std::vector<StreamedPrimitive> primitives;  // indexed by MeshPrimitive::index
+    };
+
+    uint64_t Hash(const void* data, size_t size, uint64_t seed = 0);
+    bool UpdateAsset(const std::string& directory, Scenes::Asset& asset, const Scenes::Asset* previous = nullptr);
+    bool IsCurrent(Scenes::Scene& scene, const std::string& filepath, const std::string& directory, uint64_t configHash, std::ofstream& log);
+
+    bool Open(Stream& stream, const std::string& filepath, std::ofstream& log);
+    bool WritePrimitive(Stream& stream, const Scenes::MeshPrimitive& primitive, const void* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices);
+    bool Finish(Stream& stream, const Scenes::Scene& scene, std::ofstream& log);
+    void Discard(Stream& stream);
+
     bool Serialize(const std::string& filepath, Scenes::Scene& scene, std::ofstream& log);
     bool Deserialize(const std::string& filepath, Scenes::Scene& scene, std::ofstream& log);
+    void Unmap(Scenes::Scene& scene);
 }
@@ -45,6 +45,7 @@ namespace Configs
         bool               probeVariabilityEnabled = false;
         bool               infiniteScrollingEnabled = false;
         bool               clearProbeVariability = false;
+        bool               updateEnabled = true;       // disabled volumes keep (and are shaded with) their current probe data
 
         DirectX::XMFLOAT3  origin = { 0.f, 0.f, 0.f };
         DirectX::XMFLOAT3  eulerAngles = { 0.f, 0.f, 0.f };
@@ -91,6 +92,9 @@ namespace Configs
         bool insertPerfMarkers = true;
         bool shaderExecutionReordering = false;
         uint32_t selectedVolume = 0;
+        uint32_t rayBudget = 0;     // Maximum number of probe rays traced per frame across all volumes (0: no limit)
+        std::string snapshotPath = "";      // Directory of the volume snapshots to load at initialization and to write with the images (empty: disabled)
+        bool snapshotCompression = true;    // Whether volume snapshots are written with compression
         std::vector<DDGIVolume> volumes;
     };
 
@@ -186,11 +190,59 @@ namespace Configs
         std::string screenshotPath = "";
         DirectX::XMFLOAT3 skyColor = { 0.f, 0.f, 0.f };
         float skyIntensity = 1.f;
+        bool optimizeMeshes = true;
+        bool packVertices = false;
+        float tlasRebuildMotion = 0.5f;     // accumulated instance motion (in scene diagonals) that triggers a TLAS rebuild
+        uint32_t tlasRebuildInterval = 0;   // TLAS refits between rebuilds, 0 for no limit
 
         std::vector<Camera> cameras;
         std::vector<Light> lights;
     };
 
+    // --- Benchmark Configuration --------------------
+
+    struct BenchmarkCameraKeyframe
+    {
+        float time = 0.f;                                   // seconds since the start of the measured frames
+        DirectX::XMFLOAT3 position = { 0.f, 0.f, 0.f };
+        float yaw = 0.f;
+        float pitch = 0.f;
+    };
+
+    struct BenchmarkLightEvent
+    {
+        float time = 0.f;
+        std::string light = "";                             // name of the scene light to change
+        bool setPosition = false;
+        bool setDirection = false;
+        bool setColor = false;
+        bool setPower = false;
+        DirectX::XMFLOAT3 position = { 0.f, 0.f, 0.f };
+        DirectX::XMFLOAT3 direction = { 0.f, 0.f, 0.f };
+        DirectX::XMFLOAT3 color = { 1.f, 1.f, 1.f };
+        float power = 1.f;
+    };
+
+    struct BenchmarkVolumeEvent
+    {
+        float time = 0.f;
+        uint32_t volume = 0;                                // index of the DDGIVolume (ddgi.volume.<index>)
+        bool updateEnabled = true;
+    };
+
+    struct Benchmark
+    {
+        uint32_t warmupFrames = 0;      // frames rendered (at the start of the scenario) before measuring
+        uint32_t frames = 1024;         // measured frames
+        float    frameTime = 16.6667f;  // simulated milliseconds per frame, independent of the actual frame time
+        uint32_t camera = 0;            // scene camera the benchmark renders from
+        bool     scrollWithCamera = false;  // infinite scrolling volumes follow the camera
+
+        std::vector<BenchmarkCameraKeyframe> cameraPath;    // sorted by time
+        std::vector<BenchmarkLightEvent> lightEvents;       // sorted by time
+        std::vector<BenchmarkVolumeEvent> volumeEvents;     // sorted by time
+    };
+
     struct Input
     {
         bool  invertPan = true;
@@ -217,6 +269,12 @@ namespace Configs
         bool        showPerf = false;
         bool        benchmarkRunning = false;
 
+        // Command line options
+        bool        headless = false;           // render offscreen, without a window or swap chain (--headless)
+        bool        noGPU = false;              // run the CPU stages only, without a graphics device (--no-gpu)
+        bool        runBenchmark = false;       // start the benchmark scenario with the first frame (--benchmark)
+        uint32_t    numFrames = 0;              // frames to render before writing images and exiting, 0: no limit, ignored with --benchmark (--frames)
+
         uint32_t    benchmarkProgress = 0;
 
         std::string filepath = "";
@@ -239,6 +297,7 @@ namespace Configs
         DDGI          ddgi;
         RTAO          rtao;
         PostProcess   postProcess;
+        Benchmark     benchmark;
     };
 
     bool ParseCommandLine(const std::vector<std::string>& arguments, Config& config, std::ofstream& log);
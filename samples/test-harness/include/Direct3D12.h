@@ -79,6 +79,7 @@ namespace Graphics
             ID3D12Resource* scratch = nullptr;
             ID3D12Resource* instances = nullptr;        // only used in TLAS
             ID3D12Resource* instancesUpload = nullptr;  // only used in TLAS
+            UINT8* instancesUploadPtr = nullptr;        // only used in TLAS, persistently mapped (one region per frame in flight)
 
             void Release()
             {
@@ -86,6 +87,7 @@ namespace Graphics
                 SAFE_RELEASE(scratch);
                 SAFE_RELEASE(instances);
                 SAFE_RELEASE(instancesUpload);
+                instancesUploadPtr = nullptr;
             }
         };
 
@@ -134,6 +136,7 @@ namespace Graphics
             bool                         vsyncChanged = false;
             int                          fullscreen = 0;
             bool                         fullscreenChanged = false;
+            bool                         headless = false;   // render to offscreen back buffers, without a swap chain
 
             bool                         allowTearing = false;
             bool                         supportsShaderExecutionReordering = false;
@@ -177,6 +180,7 @@ namespace Graphics
             // Constant Buffers
             ID3D12Resource*                        cameraCB = nullptr;
             UINT8*                                 cameraCBPtr = nullptr;
+            Camera                                 camera = {};                   // CPU copy of the camera constants
 
             // Structured Buffers
             ID3D12Resource*                        lightsSTB = nullptr;
@@ -210,6 +214,7 @@ namespace Graphics
             // Scene Ray Tracing Acceleration Structures
             std::vector<AccelerationStructure>     blas;
             AccelerationStructure                  tlas;
+            AccelerationStructures::TLASUpdateState tlasUpdate;
 
             // Scene textures
             std::vector<ID3D12Resource*>           sceneTextures;
@@ -243,6 +248,8 @@ namespace Graphics
             ID3D12StateObjectProperties** rtpsoProps);
 
         bool WriteResourceToDisk(Globals& d3d, std::string file, ID3D12Resource* pResource, D3D12_RESOURCE_STATES state);
+        bool ReadResourceTexels(Globals& d3d, ID3D12Resource* pResource, D3D12_RESOURCE_STATES state, uint8_t* data);
+        bool UploadResourceTexels(Globals& d3d, ID3D12GraphicsCommandList* cmdList, ID3D12Resource* pResource, D3D12_RESOURCE_STATES state, const uint8_t* data, ID3D12Resource** ppUpload);
 
         namespace SamplerHeapOffsets
         {
@@ -13,6 +13,46 @@
 
 namespace Geometry
 {
+    /**
+     * Statistics of mesh optimization, accumulated over one or more optimized mesh primitives.
+     * Cache miss ratios (ACMR: vertex cache misses per triangle) are measured with a simulated 16 entry FIFO vertex cache.
+     */
+    struct OptimizeStats
+    {
+        uint64_t numVertices = 0;               // vertices before optimization
+        uint64_t numUniqueVertices = 0;         // vertices after welding duplicates (and removing unused vertices)
+        uint64_t numTriangles = 0;              // triangles before optimization
+        uint64_t numDegenerateTriangles = 0;    // triangles removed because they reference a (welded) vertex more than once
+        uint64_t numCacheMissesBefore = 0;
+        uint64_t numCacheMissesAfter = 0;
+
+        float GetDuplicateVertexRatio() const { return numVertices ? 1.f - (static_cast<float>(numUniqueVertices) / static_cast<float>(numVertices)) : 0.f; }
+        float GetACMRBefore() const { return numTriangles ? static_cast<float>(numCacheMissesBefore) / static_cast<float>(numTriangles) : 0.f; }
+        float GetACMRAfter() const { return (numTriangles > numDegenerateTriangles) ? static_cast<float>(numCacheMissesAfter) / static_cast<float>(numTriangles - numDegenerateTriangles) : 0.f; }
+    };
+
+    /**
+     * Statistics of vertex packing, accumulated over one or more mesh primitives (see PackVertices()).
+     * Errors are the largest round trip errors of the packed mesh primitives; angular errors are in degrees.
+     */
+    struct PackStats
+    {
+        uint64_t numPrimitives = 0;             // mesh primitives considered for packing
+        uint64_t numPackedPrimitives = 0;       // mesh primitives stored in the packed vertex format
+        uint64_t numBytesBefore = 0;            // vertex data size of the packed mesh primitives, in the full vertex format
+        uint64_t numBytesAfter = 0;             // vertex data size of the packed mesh primitives, in the packed vertex format
+        float    maxNormalError = 0.f;
+        float    maxTangentError = 0.f;
+        float    maxUVError = 0.f;
+    };
+
     void CreateSphere(uint32_t latitudes, uint32_t longitudes, Scenes::Mesh& mesh);
+
+    uint64_t GetCacheMisses(const uint32_t* indices, size_t numIndices, size_t numVertices);
+    void Optimize(std::vector<Graphics::Vertex>& vertices, std::vector<uint32_t>& indices, OptimizeStats& stats);
+
+    Graphics::PackedVertex PackVertex(const Graphics::Vertex& vertex);
+    Graphics::Vertex UnpackVertex(const Graphics::PackedVertex& vertex);
+    bool PackVertices(const std::vector<Graphics::Vertex>& vertices, std::vector<Graphics::PackedVertex>& packed, PackStats& stats);
 }
 
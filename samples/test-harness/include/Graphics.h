@@ -13,6 +13,7 @@
 #include "Common.h"
 #include "Shaders.h"
 #include "Scenes.h"
+#include "AccelerationStructures.h"
 #include "Instrumentation.h"
 
 const int MAX_FRAMES_IN_FLIGHT = 2;
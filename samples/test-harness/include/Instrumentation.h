@@ -12,8 +12,7 @@
 
 #include "Common.h"
 
-#include <queue>
-#include <stack>
+#include <atomic>
 #include <iostream>
 
 namespace Instrumentation
@@ -36,6 +35,7 @@ namespace Instrumentation
         TIMESTAMP_END,
         SUBMIT,
         PRESENT,
+        SCENE_JOBS,
     };
 
     enum class EStatType
@@ -44,24 +44,51 @@ namespace Instrumentation
         GPU,
     };
 
+    /**
+     * Stat histograms have log-scaled buckets (like HDR histograms): each power of two of milliseconds, from
+     * HistogramMinValue to HistogramMinValue * 2^HistogramOctaves, is split into HistogramSubBuckets linear
+     * buckets, so values are recorded with a relative error below 1 / (2 * HistogramSubBuckets). Bucket 0 holds
+     * smaller values and the last bucket holds larger values.
+     */
+    const static uint32_t HistogramSubBuckets = 64;
+    const static uint32_t HistogramOctaves = 26;
+    const static uint32_t HistogramBuckets = (HistogramOctaves * HistogramSubBuckets) + 2;
+    const static double HistogramMinValue = 1.0 / 1024.0;  // milliseconds (about 1 microsecond)
+
+    /**
+     * Get the histogram bucket of a value (in milliseconds).
+     */
+    uint32_t GetHistogramBucket(double value);
+
+    /**
+     * Get the value (in milliseconds) that represents the values of a histogram bucket: the middle of the bucket.
+     */
+    double GetHistogramBucketValue(uint32_t bucket);
+
+    /**
+     * Get the current value of the monotonic performance counter (QueryPerformanceCounter() on Windows,
+     * CLOCK_MONOTONIC_RAW on Linux). Neither is affected by changes to the system time.
+     */
+    int64_t GetPerfCounter();
+
+    /**
+     * Convert a number of performance counter ticks to milliseconds.
+     */
+    double GetPerfCounterMilliseconds(int64_t ticks);
+
     struct Stat
     {
         static uint32_t frameGPUQueryCount;
         static void ResetGPUQueryCount() { frameGPUQueryCount = 0; }
 
         Stat() {}
-        Stat(EStatType type) { this->type = type; }
-        Stat(EStatType type, std::string name, uint32_t sampleSize)
-        {
-            this->type = type;
-            this->name = name;
-            this->sampleSize = sampleSize;
-        }
+        Stat(const Stat&) = delete;
+        Stat& operator=(const Stat&) = delete;
 
         const static uint32_t FallbackSampleSize = 10;
 
         std::string name = "";
-        EStatType type;
+        EStatType type = EStatType::CPU;
 
         int32_t gpuQueryStartIndex = -1;
         int32_t gpuQueryEndIndex = -1;
@@ -70,46 +97,102 @@ namespace Instrumentation
         int32_t GetGPUQueryEndIndex();
         void ResetGPUQueryIndices();
 
-        uint64_t timestamp = 0;
+        int64_t timestamp = 0;      // performance counter value at Begin()
         uint32_t sampleSize = FallbackSampleSize;
-        double elapsed = 0; // milliseconds
+        double elapsed = 0;         // milliseconds
         double average = 0;
         double total = 0;
-        std::queue<double> samples;
+
+        // The ring of the last sampleSize samples. The storage is owned by Performance; stats
+        // without storage (e.g. one-off timers) only keep their last sample.
+        double* samples = nullptr;
+        uint32_t sampleHead = 0;    // the next sample to write (the oldest sample once the ring is full)
+        uint32_t sampleCount = 0;
+
+        // Get a sample of the ring, in the order they were resolved (0 is the oldest)
+        double GetSample(uint32_t index) const
+        {
+            uint32_t first = (sampleCount == sampleSize) ? sampleHead : 0;
+            uint32_t ringIndex = first + index;
+            return samples[(ringIndex >= sampleSize) ? ringIndex - sampleSize : ringIndex];
+        }
+
+        // The distribution of all samples since the last Reset(), updated in constant time per sample.
+        // The histogram storage is owned by Performance (stats without storage don't keep a histogram).
+        uint32_t* histogram = nullptr;
+        uint64_t numSamples = 0;
+        double minimum = 0;
+        double maximum = 0;
+        double mean = 0;
+        double m2 = 0;              // sum of squared differences from the mean (Welford's algorithm)
+
+        double GetVariance() const { return (numSamples > 1) ? m2 / static_cast<double>(numSamples - 1) : 0; }
+        double GetStandardDeviation() const { return sqrt(GetVariance()); }
+
+        /**
+         * Get a percentile (in [0, 100]) of the samples since the last Reset(), from the histogram.
+         * Results are within the histogram's precision and clamped to the minimum and maximum samples.
+         */
+        double GetPercentile(double percentile) const;
+
+        // Time recorded by ScopedTimers since the last ResolveScopedTimers(), in performance counter ticks
+        std::atomic<int64_t> scopedTicks = { 0 };
 
         void Reset(uint32_t sampleSize = FallbackSampleSize)
         {
             elapsed = 0;
             average = 0;
             total = 0;
-            samples = {};
+            sampleHead = 0;
+            sampleCount = 0;
+            numSamples = 0;
+            minimum = maximum = mean = m2 = 0;
+            if (histogram) std::fill(histogram, histogram + HistogramBuckets, 0);
+            scopedTicks.store(0, std::memory_order_relaxed);
             this->sampleSize = sampleSize;
         }
 
     };
 
+    /**
+     * Adds the time spent in a scope to a stat. Timers live on the stack of the thread that records them, so job
+     * system workers can time their jobs without locks: the elapsed time is published with a single (relaxed) atomic
+     * add when the scope ends. Resolve the stat once per frame with ResolveScopedTimers().
+     */
+    struct ScopedTimer
+    {
+        explicit ScopedTimer(Stat* s) : stat(s), start(s ? GetPerfCounter() : 0) {}
+        ~ScopedTimer() { if (stat) stat->scopedTicks.fetch_add(GetPerfCounter() - start, std::memory_order_relaxed); }
+
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+        Stat* stat;
+        int64_t start;
+    };
+
+    /**
+     * The CPU and GPU stats. Stats are stored in place (their addresses don't change) and the sample rings (and the
+     * histograms) of all stats share contiguous allocations, so recording and resolving samples never allocates.
+     */
     struct Performance
     {
         std::vector<Stat*> gpuTimes;
         std::vector<Stat*> cpuTimes;
 
         const static uint32_t DefaultSampleSize = 50;
+        const static uint32_t MaxStats = 64;
+
+        Performance();
+        Performance(const Performance&) = delete;
+        Performance& operator=(const Performance&) = delete;
 
         uint32_t GetNumActiveGPUQueries() const { return (Stat::frameGPUQueryCount * 2); }
 
         uint32_t GetNumTotalGPUQueries() const { return static_cast<uint32_t>(gpuTimes.size()) * 2; }
 
-        Stat*& AddCPUStat(std::string name, uint32_t sampleSize = DefaultSampleSize)
-        {
-            cpuTimes.emplace_back(new Stat(EStatType::CPU, name, sampleSize));
-            return cpuTimes.back();
-        }
-
-        Stat*& AddGPUStat(std::string name, uint32_t sampleSize = DefaultSampleSize)
-        {
-            gpuTimes.emplace_back(new Stat(EStatType::GPU, name, sampleSize));
-            return gpuTimes.back();
-        }
+        Stat* AddCPUStat(std::string name, uint32_t sampleSize = DefaultSampleSize);
+        Stat* AddGPUStat(std::string name, uint32_t sampleSize = DefaultSampleSize);
 
         void AddStat(std::string name, Stat*& cpu, Stat*& gpu, uint32_t sampleSize = DefaultSampleSize)
         {
@@ -117,44 +200,28 @@ namespace Instrumentation
             gpu = AddGPUStat(name, sampleSize);
         }
 
-        void Reset(uint32_t sampleSize = DefaultSampleSize)
-        {
-            for (Stat* stat : cpuTimes)
-            {
-                stat->Reset(sampleSize);
-            }
-
-            for (Stat* stat : gpuTimes)
-            {
-                stat->Reset(sampleSize);
-            }
-        }
+        void Reset(uint32_t sampleSize = DefaultSampleSize);
+        void Cleanup();
 
-        void Cleanup()
-        {
-            size_t index;
-            for (index = 0; index < cpuTimes.size(); index++)
-            {
-                delete cpuTimes[index];
-                cpuTimes[index] = nullptr;
-            }
-
-            for (index = 0; index < gpuTimes.size(); index++)
-            {
-                delete gpuTimes[index];
-                gpuTimes[index] = nullptr;
-            }
-
-            cpuTimes.clear();
-            gpuTimes.clear();
-        }
+    private:
+
+        Stat* CreateStat(EStatType type, std::string name, uint32_t sampleSize);
+        void ReserveSamples(uint32_t sampleSize);
+
+        Stat stats[MaxStats];
+        Stat overflow;                  // returned once MaxStats stats exist, not listed or sampled
+        uint32_t numStats = 0;
 
+        uint32_t sampleCapacity = 0;    // the ring size of every stat
+        std::vector<double> samples;    // the sample rings of all stats, MaxStats x sampleCapacity
+        std::vector<uint32_t> histograms; // the histograms of all stats, MaxStats x HistogramBuckets
     };
 
     void Begin(Stat* s);
     void End(Stat* s);
     void Resolve(Stat* s);
     void EndAndResolve(Stat* s);
+    void ResolveScopedTimers(Stat* s);
 
     std::ostream& operator<<(std::ostream& os, Stat& stat);
     std::ostream& operator<<(std::ostream& os, std::vector<Stat*>& stats);
@@ -165,3 +232,4 @@ namespace Instrumentation
 #define CPU_TIMESTAMP_END(x) End(x)
 #define CPU_TIMESTAMP_RESOLVE(x) Resolve(x)
 #define CPU_TIMESTAMP_ENDANDRESOLVE(x) EndAndResolve(x)
+#define CPU_TIMESTAMP_RESOLVESCOPED(x) ResolveScopedTimers(x)
@@ -12,9 +12,12 @@
 #include "Common.h"
 #include "Configs.h"
 #include "Textures.h"
+#include "Instrumentation.h"
 
 #include "graphics/Types.h"
 
+#include <rtxgi/ddgi/DDGIVolumeUpdate.h>
+
 namespace Scenes
 {
 
@@ -24,21 +27,49 @@ namespace Scenes
         int                           material = -1;
         bool                          opaque = true;
         bool                          doubleSided = false;
+        uint32_t                      vertexFormat = Graphics::VERTEX_FORMAT_FULL;
         uint32_t                      vertexByteOffset = 0;
         uint32_t                      indexByteOffset = 0;
         rtxgi::AABB                   boundingBox; // not instanced transformed
-        std::vector<Graphics::Vertex> vertices;
+        std::vector<Graphics::Vertex> vertices;    // full format vertices only
         std::vector<uint32_t>         indices;
+
+        // Read-only vertex (of vertexFormat) and index data of primitives loaded from a memory-mapped scene cache (not owned)
+        const void*                   mappedVertices = nullptr;
+        const uint32_t*               mappedIndices = nullptr;
+        uint32_t                      numMappedVertices = 0;
+        uint32_t                      numMappedIndices = 0;
+
+        const void* GetVertexData() const { return mappedVertices ? mappedVertices : vertices.data(); }
+        const uint32_t* GetIndices() const { return mappedIndices ? mappedIndices : indices.data(); }
+        uint32_t GetNumVertices() const { return mappedVertices ? numMappedVertices : static_cast<uint32_t>(vertices.size()); }
+        uint32_t GetNumIndices() const { return mappedIndices ? numMappedIndices : static_cast<uint32_t>(indices.size()); }
+        uint32_t GetVertexStride() const { return GetVertexStride(vertexFormat); }
+        uint32_t GetVertexDataSize() const { return GetNumVertices() * GetVertexStride(); }
+
+        static uint32_t GetVertexStride(uint32_t format)
+        {
+            return (format == Graphics::VERTEX_FORMAT_PACKED) ? static_cast<uint32_t>(sizeof(Graphics::PackedVertex)) : static_cast<uint32_t>(sizeof(Graphics::Vertex));
+        }
     };
 
     struct Mesh
     {
         int index = -1;
+        uint64_t hash = 0; // hash of the glTF data the mesh is imported from
         std::string name = "";
         uint32_t numIndices = 0;
         uint32_t numVertices = 0;
         rtxgi::AABB boundingBox; // not instance transformed
         std::vector<MeshPrimitive> primitives;
+
+        // Size of the mesh's vertex buffer, its primitives' vertices can have different formats
+        uint32_t GetVertexBufferSize() const
+        {
+            uint32_t size = 0;
+            for (const MeshPrimitive& primitive : primitives) size = std::max(size, primitive.vertexByteOffset + primitive.GetVertexDataSize());
+            return size;
+        }
     };
 
     struct MeshInstance
@@ -90,6 +121,7 @@ namespace Scenes
         int  instance = -1;
         int  camera = -1;
         bool hasMatrix = false;
+        bool dirty = false;     // the local transform changed since the last UpdateTransforms()
         DirectX::XMFLOAT3 translation = DirectX::XMFLOAT3(0.f, 0.f, 0.f);
         DirectX::XMFLOAT4 rotation = DirectX::XMFLOAT4(0.f, 0.f, 0.f, 1.f);
         DirectX::XMFLOAT3 scale = DirectX::XMFLOAT3(1.f, 1.f, 1.f);
@@ -98,6 +130,39 @@ namespace Scenes
         std::vector<int> children;
     };
 
+    /**
+     * The scene graph flattened into topological order (parents before children), with the nodes of each depth stored
+     * contiguously, so world transforms are propagated one level at a time (and in parallel within a level).
+     */
+    struct SceneGraph
+    {
+        std::vector<uint32_t>          nodes;       // scene node index of each slot
+        std::vector<int>               parents;     // parent slot of each slot, -1 for root nodes
+        std::vector<uint32_t>          levels;      // first slot of each depth level, followed by the number of slots
+        std::vector<DirectX::XMMATRIX> transforms;  // world transform of each slot
+        std::vector<uint8_t>           updated;     // 1: the slot's world transform changed in the current update
+        std::vector<uint8_t>           changed;     // 1: the instance's transform changed in the current update, by instance index
+        bool                           dirty = false;
+    };
+
+    enum class EAssetType
+    {
+        SCENE = 0,
+        BUFFER,
+        IMAGE,
+        CONFIG
+    };
+
+    struct Asset
+    {
+        EAssetType type = EAssetType::SCENE;
+        int index = -1;                 // buffer or texture index
+        std::string filepath = "";      // relative to the scene directory
+        uint64_t size = 0;
+        int64_t mtime = 0;
+        uint64_t hash = 0;              // hash of the file contents (or of the import settings)
+    };
+
     struct Scene
     {
         std::string name = "";
@@ -120,13 +185,23 @@ namespace Scenes
         std::vector<Mesh> meshes;
         std::vector<Material> materials;
         std::vector<Textures::Texture> textures;
+        std::vector<Asset> assets;      // the files (and settings) the scene is imported from
+
+        SceneGraph graph;
+        std::vector<uint32_t> changedInstances; // instances whose transform changed in the last UpdateTransforms()
+
+        uint8_t* cache = nullptr;       // memory-mapped scene cache file, released by Cleanup()
+        uint64_t cacheSize = 0;
 
         Camera& GetActiveCamera() { return cameras[activeCamera]; }
         const Camera& GetActiveCamera() const { return cameras[activeCamera]; }
     };
 
     bool Initialize(const Configs::Config& config, Scene& scene, std::ofstream& log);
-    void Traverse(size_t nodeIndex, DirectX::XMMATRIX transform, Scene& scene);
+    void BuildSceneGraph(Scene& scene);
+    void SetNodeTransform(Scene& scene, uint32_t nodeIndex, const DirectX::XMFLOAT3& translation, const DirectX::XMFLOAT4& rotation, const DirectX::XMFLOAT3& scale);
+    void SetNodeTransform(Scene& scene, uint32_t nodeIndex, DirectX::FXMMATRIX matrix);
+    void UpdateTransforms(Scene& scene, rtxgi::DDGIJobSystem* jobSystem = nullptr, Instrumentation::Stat* jobStat = nullptr);
     void UpdateCamera(Camera& camera);
     void Cleanup(Scene& scene);
 
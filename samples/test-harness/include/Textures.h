@@ -43,6 +43,7 @@ namespace Textures
         uint8_t* texels = nullptr;
 
         bool cached = false;
+        bool mapped = false;        // texels point into a memory-mapped scene cache (read-only, not owned)
 
         void SetName(std::string n)
         {
@@ -61,6 +62,7 @@ namespace Textures
 #if defined(__x86_64__) || defined(_M_X64)
     bool Compress(Texture& texture, bool quick = false);
     bool MipmapAndCompress(Texture& texture, bool quick = false);
+    bool Import(Texture** textures, uint32_t numTextures, bool quick = false);
 #endif
 
 }
@@ -121,6 +121,7 @@ namespace Graphics
             VkDeviceMemory instancesMemory = nullptr;       // Only valid for TLAS
             VkBuffer instancesUpload = nullptr;             // Only valid for TLAS
             VkDeviceMemory instancesUploadMemory = nullptr; // Only valid for TLAS
+            uint8_t* instancesUploadPtr = nullptr;          // Only valid for TLAS, persistently mapped (one region per frame in flight)
 
             void Release(VkDevice device)
             {
@@ -143,6 +144,7 @@ namespace Graphics
                 instancesMemory = nullptr;
                 instancesUpload = nullptr;
                 instancesUploadMemory = nullptr;
+                instancesUploadPtr = nullptr;
             }
         };
 
@@ -220,6 +222,8 @@ namespace Graphics
             VkImageView                             swapChainImageView[MAX_FRAMES_IN_FLIGHT] = { nullptr, nullptr };
             VkFormat                                swapChainFormat = VK_FORMAT_UNDEFINED;
             VkColorSpaceKHR                         swapChainColorSpace;
+            VkImageLayout                           swapChainImageLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;   // layout of the back buffers between frames
+            VkDeviceMemory                          swapChainImageMemory[MAX_FRAMES_IN_FLIGHT] = { nullptr, nullptr };   // headless back buffers only
 
             VkRenderPass                            renderPass = nullptr;
             VkFramebuffer                           frameBuffer[MAX_FRAMES_IN_FLIGHT] = { nullptr, nullptr };
@@ -256,6 +260,7 @@ namespace Graphics
             bool                                    vsyncChanged = false;
             int                                     fullscreen = 0;
             bool                                    fullscreenChanged = false;
+            bool                                    headless = false;   // render to offscreen back buffers, without a surface or swap chain
 
             bool                                    supportsShaderExecutionReordering = false;
 
@@ -313,6 +318,7 @@ namespace Graphics
             VkBuffer                                cameraCB = nullptr;
             VkDeviceMemory                          cameraCBMemory = nullptr;
             uint8_t*                                cameraCBPtr = nullptr;
+            Camera                                  camera = {};                   // CPU copy of the camera constants
 
             // Structured Buffers
             VkBuffer                                lightsSTB = nullptr;
@@ -357,6 +363,7 @@ namespace Graphics
             // Scene Ray Tracing Acceleration Structures
             std::vector<AccelerationStructure>      blas;
             AccelerationStructure                   tlas;
+            AccelerationStructures::TLASUpdateState tlasUpdate;
 
             // Scene textures
             std::vector<VkImage>                    sceneTextures;
@@ -416,6 +423,8 @@ namespace Graphics
         void BeginRenderPass(Globals& vk);
 
         bool WriteResourceToDisk(Globals& vk, std::string file, VkImage image, uint32_t width, uint32_t height, uint32_t arraySize, VkFormat imageFormat, VkImageLayout originalLayout);
+        bool ReadResourceTexels(Globals& vk, VkImage image, uint32_t width, uint32_t height, uint32_t arraySize, uint32_t texelSize, VkImageLayout originalLayout, uint8_t* data);
+        bool UploadResourceTexels(Globals& vk, VkCommandBuffer cmdBuffer, VkImage image, uint32_t width, uint32_t height, uint32_t arraySize, uint32_t texelSize, VkImageLayout originalLayout, const uint8_t* data, VkBuffer* uploadBuffer, VkDeviceMemory* uploadMemory);
 
     #ifdef GFX_NAME_OBJECTS
         void SetObjectName(VkDevice device, uint64_t handle, const char* name, VkObjectType type);
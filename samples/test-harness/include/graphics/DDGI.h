@@ -31,12 +31,19 @@ namespace Graphics
         bool Reload(Globals& globals, GlobalResources& gfxResources, Resources& resources, const Configs::Config& config, std::ofstream& log);
         bool Resize(Globals& globals, GlobalResources& gfxResources, Resources& resources, std::ofstream& log);
         void Update(Globals& globals, GlobalResources& gfxResources, Resources& resources, Configs::Config& config);
+        void UpdateSceneChanges(Resources& resources, const Configs::Config& config, const Scenes::Scene& scene);
         void Execute(Globals& globals, GlobalResources& gfxResources, Resources& resources);
         void Cleanup(Globals& globals, Resources& resources);
 
+        void GetDDGIVolumeDesc(const Configs::DDGIVolume& config, DDGIVolumeDesc& volumeDesc);
         void AddCommonShaderDefines(Shaders::ShaderProgram& shader, const DDGIVolumeDesc& volumeDesc, bool spirv);
         bool CompileDDGIVolumeShaders(Globals& vk, const DDGIVolumeDesc& volumeDesc, std::vector<Shaders::ShaderProgram>& volumeShaders, bool spirv, std::ofstream& log);
 
         bool WriteVolumesToDisk(Globals& globals, GlobalResources& gfxResources, Resources& resources, std::string directory);
+
+        std::string GetVolumeSnapshotFile(const std::string& directory, const DDGIVolumeBase* volume);
+        bool WriteVolumeSnapshot(DDGIVolumeSnapshot& snapshot, const std::string& file, bool compress);
+        bool ReadVolumeSnapshot(DDGIVolumeBase* volume, const std::string& directory, DDGIVolumeSnapshot& snapshot, std::ofstream& log);
+        bool WriteVolumeSnapshots(Globals& globals, GlobalResources& gfxResources, Resources& resources, std::string directory, bool compress);
     }
 }
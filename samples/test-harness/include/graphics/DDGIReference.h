@@ -0,0 +1,31 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#pragma once
+
+#include "Configs.h"
+
+#include <fstream>
+
+namespace Graphics
+{
+    namespace DDGI
+    {
+        namespace Reference
+        {
+            /**
+             * Update and blend the config's DDGIVolumes with the RTXGI SDK's CPU probe blending (no graphics device required).
+             * Probe rays are not traced; every ray misses and returns the scene's sky radiance.
+             * Writes the blended irradiance and distance texture arrays of each volume to the scene's screenshot path.
+             */
+            bool Run(const Configs::Config& config, uint32_t numFrames, std::ofstream& log);
+        }
+    }
+}
@@ -12,6 +12,9 @@
 
 #include "Graphics.h"
 #include <rtxgi/ddgi/gfx/DDGIVolume_D3D12.h>
+#include <rtxgi/ddgi/DDGIVolumeScheduler.h>
+#include <rtxgi/ddgi/DDGIVolumeUpdate.h>
+#include <rtxgi/ddgi/DDGIVolumeSnapshot.h>
 
 namespace Graphics
 {
@@ -57,13 +60,33 @@ namespace Graphics
                 ID3D12Resource*              volumeResourceIndicesSTB = nullptr;
                 ID3D12Resource*              volumeResourceIndicesSTBUpload = nullptr;
                 UINT                         volumeResourceIndicesSTBSizeInBytes = 0;
+                UINT8*                       volumeResourceIndicesSTBUploadPtr = nullptr;
 
                 ID3D12Resource*              volumeConstantsSTB = nullptr;
                 ID3D12Resource*              volumeConstantsSTBUpload = nullptr;
                 UINT                         volumeConstantsSTBSizeInBytes = 0;
+                UINT8*                       volumeConstantsSTBUploadPtr = nullptr;
 
                 // Variability Tracking
                 std::vector<uint32_t>        numVolumeVariabilitySamples;
+                std::vector<uint64_t>        volumeVariabilityFrames;           // Frame of the last variability readback used by each volume
+                uint64_t                     variabilityFrameIndex = 0;         // Monotonic frame counter for variability readbacks
+
+                // Scene Change Tracking
+                std::vector<rtxgi::AABB>     sceneInstanceBoxes;                // Mesh instance bounding boxes at the last scene change update
+                std::vector<Light>           sceneLights;                       // Lights at the last scene change update
+                float3                       sceneSkyRadiance = {};             // Sky radiance at the last scene change update
+                bool                         sceneTracked = false;              // Whether the scene is tracked (see UpdateSceneChanges())
+
+                // Volume Snapshots
+                std::vector<ID3D12Resource*> snapshotUploadBuffers;             // Snapshot texture uploads recorded at initialization (released on the first update)
+
+                // Update Scheduling
+                rtxgi::DDGIVolumeScheduler   volumeScheduler;
+                std::vector<uint8_t>         volumeUpdateEnabled;
+                std::vector<uint32_t>        scheduledVolumeIndices;
+                std::vector<rtxgi::DDGIVolumeDescGPUPacked> selectedVolumeDescs;   // Packed constants of the selected volumes
+                rtxgi::DDGIThreadPool        volumeUpdateThreadPool;
 
                 // Performance Stats
                 Instrumentation::Stat*       cpuStat = nullptr;
@@ -12,6 +12,9 @@
 
 #include "Graphics.h"
 #include <rtxgi/ddgi/gfx/DDGIVolume_VK.h>
+#include <rtxgi/ddgi/DDGIVolumeScheduler.h>
+#include <rtxgi/ddgi/DDGIVolumeUpdate.h>
+#include <rtxgi/ddgi/DDGIVolumeSnapshot.h>
 
 namespace Graphics
 {
@@ -69,15 +72,36 @@ namespace Graphics
                 VkDeviceMemory                  volumeResourceIndicesSTBMemory = nullptr;
                 VkDeviceMemory                  volumeResourceIndicesSTBUploadMemory = nullptr;
                 uint64_t                        volumeResourceIndicesSTBSizeInBytes = 0;
+                uint8_t*                        volumeResourceIndicesSTBUploadPtr = nullptr;
 
                 VkBuffer                        volumeConstantsSTB = nullptr;
                 VkBuffer                        volumeConstantsSTBUpload = nullptr;
                 VkDeviceMemory                  volumeConstantsSTBMemory = nullptr;
                 VkDeviceMemory                  volumeConstantsSTBUploadMemory = nullptr;
                 uint64_t                        volumeConstantsSTBSizeInBytes = 0;
+                uint8_t*                        volumeConstantsSTBUploadPtr = nullptr;
 
                 // Variability Tracking
                 std::vector<uint32_t>           numVolumeVariabilitySamples;
+                std::vector<uint64_t>           volumeVariabilityFrames;           // Frame of the last variability readback used by each volume
+                uint64_t                        variabilityFrameIndex = 0;         // Monotonic frame counter for variability readbacks
+
+                // Scene Change Tracking
+                std::vector<rtxgi::AABB>        sceneInstanceBoxes;                // Mesh instance bounding boxes at the last scene change update
+                std::vector<Light>              sceneLights;                       // Lights at the last scene change update
+                float3                          sceneSkyRadiance = {};             // Sky radiance at the last scene change update
+                bool                            sceneTracked = false;              // Whether the scene is tracked (see UpdateSceneChanges())
+
+                // Volume Snapshots
+                std::vector<VkBuffer>           snapshotUploadBuffers;             // Snapshot texture uploads recorded at initialization (released on the first update)
+                std::vector<VkDeviceMemory>     snapshotUploadMemory;
+
+                // Update Scheduling
+                rtxgi::DDGIVolumeScheduler      volumeScheduler;
+                std::vector<uint8_t>            volumeUpdateEnabled;
+                std::vector<uint32_t>           scheduledVolumeIndices;
+                std::vector<rtxgi::DDGIVolumeDescGPUPacked> selectedVolumeDescs;   // Packed constants of the selected volumes
+                rtxgi::DDGIThreadPool           volumeUpdateThreadPool;
 
                 Instrumentation::Stat*          cpuStat = nullptr;
                 Instrumentation::Stat*          gpuStat = nullptr;
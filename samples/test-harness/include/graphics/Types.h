@@ -44,6 +44,12 @@ namespace Graphics
         POSTPROCESS_FLAG_USE_GAMMA = 0x8,
     };
 
+    enum VERTEX_FORMAT
+    {
+        VERTEX_FORMAT_FULL = 0,         // Vertex
+        VERTEX_FORMAT_PACKED = 1        // PackedVertex
+    };
+
     struct Payload
     {                                         // Byte Offset
         float3  albedo;                       // 12
@@ -96,11 +102,23 @@ namespace Graphics
         float2 uv0;
     };
 
+    struct PackedVertex
+    {                                  // Byte Offset        Data Format
+        float3 position;               // 0               X: Position X
+                                       // 4               Y: Position Y
+                                       // 8               Z: Position Z
+        uint   normal;                 // 12                 16: Octahedral X      16: Octahedral Y       (unorm)
+        uint   tangent;                // 16                 16: Octahedral X      15: Octahedral Y       (unorm)    1: Bitangent Sign
+        uint   uv0;                    // 20                 16: U                 16: V                  (half)
+                                       // 24
+    };
+
     struct GeometryData
     {
         uint materialIndex;
         uint indexByteAddress;
         uint vertexByteAddress;
+        uint vertexFormat;      // VERTEX_FORMAT
     };
 
     struct Camera
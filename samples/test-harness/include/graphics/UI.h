@@ -28,6 +28,7 @@ namespace Graphics
     namespace UI
     {
         extern bool s_initialized;
+        extern bool s_headless;     // message boxes print to stderr instead of waiting for the user
 
         bool Initialize(Graphics::Globals& gfx, Graphics::GlobalResources& gfxResources, Resources& resources, Instrumentation::Performance& perf, std::ofstream& log);
         void Update(Graphics::Globals& gfx, Resources& resources, Configs::Config& config, Inputs::Input& input, Scenes::Scene& scene, std::vector<DDGIVolumeBase*>& volumes, const Instrumentation::Performance& performance);
@@ -120,11 +120,12 @@ StructuredBuffer<Light> GetLights() { return Lights; }
 void GetGeometryData(uint meshIndex, uint geometryIndex, out GeometryData geometry)
 {
     uint address = ByteAddrBuffer[MESH_OFFSETS_INDEX].Load(meshIndex * 4); // address of the Mesh in the GeometryData buffer
-    address += geometryIndex * 12; // offset to mesh primitive geometry, GeometryData stride is 12 bytes
+    address += geometryIndex * 16; // offset to mesh primitive geometry, GeometryData stride is 16 bytes
 
     geometry.materialIndex = ByteAddrBuffer[GEOMETRY_DATA_INDEX].Load(address);
     geometry.indexByteAddress = ByteAddrBuffer[GEOMETRY_DATA_INDEX].Load(address + 4);
     geometry.vertexByteAddress = ByteAddrBuffer[GEOMETRY_DATA_INDEX].Load(address + 8);
+    geometry.vertexFormat = ByteAddrBuffer[GEOMETRY_DATA_INDEX].Load(address + 12);
 }
 Material GetMaterial(GeometryData geometry) { return Materials[geometry.materialIndex]; }
 
@@ -194,13 +195,14 @@ StructuredBuffer<Light> GetLights() { return StructuredBuffer<Light>(ResourceDes
 
 void GetGeometryData(uint meshIndex, uint geometryIndex, out GeometryData geometry)
 {
-    uint address = ByteAddressBuffer(ResourceDescriptorHeap[MESH_OFFSETS_INDEX]).Load(meshIndex * 4) * 12; // offset to start of mesh, GeometryData is 12 bytes
-    address += geometryIndex * 12; // offset to mesh primitive geometry
+    uint address = ByteAddressBuffer(ResourceDescriptorHeap[MESH_OFFSETS_INDEX]).Load(meshIndex * 4) * 16; // offset to start of mesh, GeometryData is 16 bytes
+    address += geometryIndex * 16; // offset to mesh primitive geometry
 
     ByteAddressBuffer geometryData = ByteAddressBuffer(ResourceDescriptorHeap[GEOMETRY_DATA_INDEX]);
     geometry.materialIndex = geometryData.Load(address);
     geometry.indexByteAddress = geometryData.Load(address + 4);
     geometry.vertexByteAddress = geometryData.Load(address + 8);
+    geometry.vertexFormat = geometryData.Load(address + 12);
 }
 Material GetMaterial(GeometryData geometry) { return StructuredBuffer<Material>(ResourceDescriptorHeap[MATERIALS_INDEX]).Load(geometry.materialIndex); }
 
@@ -78,6 +78,51 @@ uint3 LoadIndices(uint meshIndex, uint primitiveIndex, GeometryData geometry)
     return GetIndexBuffer(meshIndex).Load3(address); // Mesh index buffers start at index 4 and alternate with vertex buffer pointers
 }
 
+/**
+ * Map a point of the [-1, 1] square to a unit vector (octahedral projection).
+ * Matches DecodeOctahedral() in Geometry.cpp.
+ */
+float3 DecodeOctahedral(float2 e)
+{
+    float3 v = float3(e.x, e.y, 1.f - abs(e.x) - abs(e.y));
+    if (v.z < 0.f)
+    {
+        float x = v.x;
+        v.x = (1.f - abs(v.y)) * (x >= 0.f ? 1.f : -1.f);
+        v.y = (1.f - abs(x)) * (v.y >= 0.f ? 1.f : -1.f);
+    }
+    return normalize(v);
+}
+
+/**
+ * Unpack a packed vertex normal (see PackedVertex).
+ */
+float3 UnpackVertexNormal(uint packed)
+{
+    if (packed == 0) return float3(0.f, 0.f, 0.f);
+    float2 e = float2(packed & 0xFFFF, packed >> 16) / 65535.f;
+    return DecodeOctahedral(e * 2.f - 1.f);
+}
+
+/**
+ * Unpack a packed vertex tangent (see PackedVertex).
+ */
+float4 UnpackVertexTangent(uint packed)
+{
+    float w = (packed & 0x80000000) ? -1.f : 1.f;
+    if ((packed & 0x7FFFFFFF) == 0) return float4(0.f, 0.f, 0.f, w);
+    float2 e = float2((packed & 0xFFFF) / 65535.f, ((packed >> 16) & 0x7FFF) / 32767.f);
+    return float4(DecodeOctahedral(e * 2.f - 1.f), w);
+}
+
+/**
+ * Unpack packed vertex texture coordinates (see PackedVertex).
+ */
+float2 UnpackVertexUV0(uint packed)
+{
+    return float2(f16tof32(packed), f16tof32(packed >> 16));
+}
+
 /**
  * Load a triangle's vertex data (all: position, normal, tangent, uv0).
  */
@@ -91,6 +136,22 @@ void LoadVertices(uint meshIndex, uint primitiveIndex, GeometryData geometry, ou
     for (uint i = 0; i < 3; i++)
     {
         vertices[i] = (Vertex)0;
+        if (geometry.vertexFormat == VERTEX_FORMAT_PACKED)
+        {
+            address = geometry.vertexByteAddress + (indices[i] * 6) * 4;   // Packed vertices contain 6 values / 24 bytes
+
+            // Load the position
+            vertices[i].position = asfloat(GetVertexBuffer(meshIndex).Load3(address));
+            address += 12;
+
+            // Load and unpack the normal, tangent, and texture coordinates
+            uint3 packed = GetVertexBuffer(meshIndex).Load3(address);
+            vertices[i].normal = UnpackVertexNormal(packed.x);
+            vertices[i].tangent = UnpackVertexTangent(packed.y);
+            vertices[i].uv0 = UnpackVertexUV0(packed.z);
+            continue;
+        }
+
         address = geometry.vertexByteAddress + (indices[i] * 12) * 4;  // Vertices contain 12 floats / 48 bytes
 
         // Load the position
@@ -123,6 +184,19 @@ void LoadVerticesPosUV0(uint meshIndex, uint primitiveIndex, GeometryData geomet
     for (uint i = 0; i < 3; i++)
     {
         vertices[i] = (Vertex)0;
+        if (geometry.vertexFormat == VERTEX_FORMAT_PACKED)
+        {
+            address = geometry.vertexByteAddress + (indices[i] * 6) * 4;   // Packed vertices contain 6 values / 24 bytes
+
+            // Load the position
+            vertices[i].position = asfloat(GetVertexBuffer(meshIndex).Load3(address));
+            address += 20; // skip normal and tangent
+
+            // Load and unpack the texture coordinates
+            vertices[i].uv0 = UnpackVertexUV0(GetVertexBuffer(meshIndex).Load(address));
+            continue;
+        }
+
         address = geometry.vertexByteAddress + (indices[i] * 12) * 4;  // Vertices contain 12 floats / 48 bytes
 
         // Load the position
@@ -147,6 +221,14 @@ float2 LoadAndInterpolateUV0(uint meshIndex, uint primitiveIndex, GeometryData g
     float2 uv0 = float2(0.f, 0.f);
     for (uint i = 0; i < 3; i++)
     {
+        if (geometry.vertexFormat == VERTEX_FORMAT_PACKED)
+        {
+            address = geometry.vertexByteAddress + (indices[i] * 6) * 4;   // 6 values (3: pos, 1: normal, 1: tangent, 1: uv0)
+            address += 20;                                                // 20 bytes (5 * 4): skip position, normal, and tangent
+            uv0 += UnpackVertexUV0(GetVertexBuffer(meshIndex).Load(address)) * barycentrics[i];
+            continue;
+        }
+
         address = geometry.vertexByteAddress + (indices[i] * 12) * 4;  // 12 floats (3: pos, 3: normals, 4:tangent, 2:uv0)
         address += 40;                                                // 40 bytes (10 * 4): skip position, normal, and tangent
         uv0 += asfloat(GetVertexBuffer(meshIndex).Load2(address)) * barycentrics[i];
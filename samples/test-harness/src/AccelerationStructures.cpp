@@ -0,0 +1,121 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "AccelerationStructures.h"
+
+#include <cmath>
+
+namespace AccelerationStructures
+{
+
+    //----------------------------------------------------------------------------------------------------------
+    // Private Functions
+    //----------------------------------------------------------------------------------------------------------
+
+    float GetLength(float x, float y, float z)
+    {
+        return sqrtf((x * x) + (y * y) + (z * z));
+    }
+
+    float GetDiagonal(const rtxgi::AABB& box)
+    {
+        return GetLength(box.max.x - box.min.x, box.max.y - box.min.y, box.max.z - box.min.z);
+    }
+
+    /**
+     * Get the distance between two bounding boxes: the distance between their centers plus the change of their (half) extents.
+     */
+    float GetMotion(const rtxgi::AABB& from, const rtxgi::AABB& to)
+    {
+        float centerX = ((to.max.x + to.min.x) - (from.max.x + from.min.x)) * 0.5f;
+        float centerY = ((to.max.y + to.min.y) - (from.max.y + from.min.y)) * 0.5f;
+        float centerZ = ((to.max.z + to.min.z) - (from.max.z + from.min.z)) * 0.5f;
+        float extentX = ((to.max.x - to.min.x) - (from.max.x - from.min.x)) * 0.5f;
+        float extentY = ((to.max.y - to.min.y) - (from.max.y - from.min.y)) * 0.5f;
+        float extentZ = ((to.max.z - to.min.z) - (from.max.z - from.min.z)) * 0.5f;
+        return GetLength(centerX, centerY, centerZ) + GetLength(extentX, extentY, extentZ);
+    }
+
+    //----------------------------------------------------------------------------------------------------------
+    // Public Functions
+    //----------------------------------------------------------------------------------------------------------
+
+    /**
+     * Coalesce a list of instance indices (in ascending order) into contiguous ranges.
+     */
+    void GetInstanceRanges(const std::vector<uint32_t>& instances, std::vector<InstanceRange>& ranges)
+    {
+        ranges.clear();
+        for (uint32_t instanceIndex : instances)
+        {
+            if (!ranges.empty() && (ranges.back().first + ranges.back().count) == instanceIndex) ranges.back().count++;
+            else ranges.push_back({ instanceIndex, 1 });
+        }
+    }
+
+    /**
+     * Record the scene's instance bounding boxes as the TLAS build state. Call when the TLAS is built.
+     */
+    void Reset(TLASUpdateState& state, const Scenes::Scene& scene)
+    {
+        size_t numInstances = scene.instances.size();
+        state.builtBoxes.resize(numInstances);
+        for (size_t instanceIndex = 0; instanceIndex < numInstances; instanceIndex++)
+        {
+            state.builtBoxes[instanceIndex] = scene.instances[instanceIndex].boundingBox;
+        }
+        state.motion.assign(numInstances, 0.f);
+        state.totalMotion = 0.0;
+        state.sceneDiagonal = GetDiagonal(scene.boundingBox);
+        state.numRefits = 0;
+    }
+
+    /**
+     * Decide how to update the scene TLAS after Scenes::UpdateTransforms(), based on the instances it changed
+     * (scene.changedInstances). Lists the changed instances as contiguous ranges in state.ranges.
+     * A rebuild resets the update state to the current instance bounding boxes.
+     */
+    ETLASUpdate Update(TLASUpdateState& state, const TLASPolicy& policy, const Scenes::Scene& scene)
+    {
+        GetInstanceRanges(scene.changedInstances, state.ranges);
+        if (state.ranges.empty()) return ETLASUpdate::NONE;
+
+        state.numUpdates++;
+
+        // The TLAS was built for a different set of instances
+        if (state.builtBoxes.size() != scene.instances.size())
+        {
+            Reset(state, scene);
+            state.numRebuilds++;
+            return ETLASUpdate::REBUILD;
+        }
+
+        // Accumulate the motion of the changed instances
+        for (uint32_t instanceIndex : scene.changedInstances)
+        {
+            float motion = GetMotion(state.builtBoxes[instanceIndex], scene.instances[instanceIndex].boundingBox);
+            state.totalMotion += static_cast<double>(motion) - static_cast<double>(state.motion[instanceIndex]);
+            state.motion[instanceIndex] = motion;
+        }
+
+        bool rebuild = (state.GetMotion() > policy.maxMotion);
+        if (policy.maxRefits > 0 && state.numRefits >= policy.maxRefits) rebuild = true;
+        if (rebuild)
+        {
+            Reset(state, scene);
+            state.numRebuilds++;
+            return ETLASUpdate::REBUILD;
+        }
+
+        state.numRefits++;
+        return ETLASUpdate::REFIT;
+    }
+
+}
@@ -10,20 +10,384 @@
 
 #include "Benchmark.h"
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
+#include <iomanip>
+
+#ifndef GIT_HASH
+#define GIT_HASH "unknown"
+#endif
 
 namespace Benchmark
 {
-    void StartBenchmark(BenchmarkRun& benchmarkRun, Instrumentation::Performance& perf, Configs::Config& config, Graphics::Globals& gfx)
+
+    //----------------------------------------------------------------------------------------------------------
+    // Private Functions
+    //----------------------------------------------------------------------------------------------------------
+
+    // The percentiles reported for each stat
+    const static double Percentiles[] = { 50.0, 90.0, 99.0, 99.9 };
+    const static char* PercentileNames[] = { "P50", "P90", "P99", "P99.9" };
+    const static char* PercentileKeys[] = { "p50", "p90", "p99", "p99.9" };
+    const static uint32_t NumPercentiles = 4;
+
+    /**
+     * Append a csv row with a label and one value per stat.
+     */
+    template<typename Function>
+    void AppendStatRow(std::string& csv, const char* label, const std::vector<Instrumentation::Stat*>& stats, Function value)
+    {
+        csv.append(label);
+        csv.append(",");
+        for (const Instrumentation::Stat* stat : stats)
+        {
+            csv.append(std::to_string(value(stat)));
+            csv.append(",");
+        }
+        csv.append("\n");
+    }
+
+    /**
+     * Append a csv header row with a label and the name of each stat.
+     */
+    void AppendStatHeader(std::string& csv, const char* label, const std::vector<Instrumentation::Stat*>& stats)
+    {
+        csv.append(label);
+        csv.append(",");
+        for (const Instrumentation::Stat* stat : stats)
+        {
+            csv.append(stat->name);
+            csv.append(",");
+        }
+        csv.append("\n");
+    }
+
+    /**
+     * Write the summary csv (average, distribution statistics, and percentiles) of the stats: a header row with the
+     * stat names, then one row per statistic.
+     */
+    bool WriteStatSummaryCSV(const std::string& file, const std::vector<Instrumentation::Stat*>& stats)
+    {
+        std::string csv = "";
+        AppendStatHeader(csv, "Statistic", stats);
+        AppendStatRow(csv, "Average", stats, [](const Instrumentation::Stat* s) { return s->average; });
+        AppendStatRow(csv, "Minimum", stats, [](const Instrumentation::Stat* s) { return s->minimum; });
+        AppendStatRow(csv, "Maximum", stats, [](const Instrumentation::Stat* s) { return s->maximum; });
+        AppendStatRow(csv, "StdDev", stats, [](const Instrumentation::Stat* s) { return s->GetStandardDeviation(); });
+        AppendStatRow(csv, "Variance", stats, [](const Instrumentation::Stat* s) { return s->GetVariance(); });
+        for (uint32_t index = 0; index < NumPercentiles; index++)
+        {
+            double percentile = Percentiles[index];
+            AppendStatRow(csv, PercentileNames[index], stats, [percentile](const Instrumentation::Stat* s) { return s->GetPercentile(percentile); });
+        }
+
+        std::ofstream out(file, std::ios::out);
+        if (!out.is_open()) return false;
+        out << csv;
+        return out.good();
+    }
+
+    void WriteJSONString(std::ostream& out, const std::string& value)
+    {
+        out << "\"";
+        for (char c : value)
+        {
+            if (c == '"' || c == '\\') out << '\\' << c;
+            else if (static_cast<unsigned char>(c) < 0x20) out << ' ';
+            else out << c;
+        }
+        out << "\"";
+    }
+
+    void WriteJSONFloat3(std::ostream& out, const DirectX::XMFLOAT3& value)
+    {
+        out << "[" << value.x << ", " << value.y << ", " << value.z << "]";
+    }
+
+    /**
+     * Write the run's metadata (build, config, GPU, and DDGIVolume descriptors) as a JSON object.
+     */
+    void WriteJSONMetadata(std::ostream& out, const BenchmarkRun& benchmarkRun, const Configs::Config& config)
+    {
+        out << "{\n    \"git\": ";
+        WriteJSONString(out, GIT_HASH);
+        out << ",\n    \"config\": ";
+        WriteJSONString(out, config.app.filepath);
+        out << ",\n    \"scene\": ";
+        WriteJSONString(out, config.scene.name);
+        out << ",\n    \"api\": ";
+        WriteJSONString(out, config.app.api);
+        out << ",\n    \"gpu\": ";
+        WriteJSONString(out, config.app.gpuName);
+        out << ",\n    \"width\": " << config.app.width;
+        out << ",\n    \"height\": " << config.app.height;
+        out << ",\n    \"vsync\": " << (config.app.vsync ? "true" : "false");
+        out << ",\n    \"renderMode\": " << static_cast<int>(config.app.renderMode);
+        out << ",\n    \"frames\": " << benchmarkRun.numFramesBenched;
+        out << ",\n    \"scenario\": {";
+        out << "\n      \"warmupFrames\": " << config.benchmark.warmupFrames;
+        out << ",\n      \"frameTime\": " << config.benchmark.frameTime;
+        out << ",\n      \"camera\": " << config.benchmark.camera;
+        out << ",\n      \"scrollWithCamera\": " << (config.benchmark.scrollWithCamera ? "true" : "false");
+        out << ",\n      \"cameraKeyframes\": " << config.benchmark.cameraPath.size();
+        out << ",\n      \"lightEvents\": " << config.benchmark.lightEvents.size();
+        out << ",\n      \"volumeEvents\": " << config.benchmark.volumeEvents.size();
+        out << "\n    }";
+        out << ",\n    \"volumes\": [";
+        for (size_t volumeIndex = 0; volumeIndex < config.ddgi.volumes.size(); volumeIndex++)
+        {
+            const Configs::DDGIVolume& volume = config.ddgi.volumes[volumeIndex];
+            out << (volumeIndex > 0 ? "," : "") << "\n      {\n        \"name\": ";
+            WriteJSONString(out, volume.name);
+            out << ",\n        \"origin\": ";
+            WriteJSONFloat3(out, volume.origin);
+            out << ",\n        \"eulerAngles\": ";
+            WriteJSONFloat3(out, volume.eulerAngles);
+            out << ",\n        \"probeSpacing\": ";
+            WriteJSONFloat3(out, volume.probeSpacing);
+            out << ",\n        \"probeCounts\": [" << volume.probeCounts.x << ", " << volume.probeCounts.y << ", " << volume.probeCounts.z << "]";
+            out << ",\n        \"probeNumRays\": " << volume.probeNumRays;
+            out << ",\n        \"probeNumIrradianceTexels\": " << volume.probeNumIrradianceTexels;
+            out << ",\n        \"probeNumDistanceTexels\": " << volume.probeNumDistanceTexels;
+            out << ",\n        \"probeHysteresis\": " << volume.probeHysteresis;
+            out << ",\n        \"probeMaxRayDistance\": " << volume.probeMaxRayDistance;
+            out << ",\n        \"probeRelocationEnabled\": " << (volume.probeRelocationEnabled ? "true" : "false");
+            out << ",\n        \"probeClassificationEnabled\": " << (volume.probeClassificationEnabled ? "true" : "false");
+            out << ",\n        \"probeVariabilityEnabled\": " << (volume.probeVariabilityEnabled ? "true" : "false");
+            out << ",\n        \"infiniteScrollingEnabled\": " << (volume.infiniteScrollingEnabled ? "true" : "false");
+            out << ",\n        \"textureFormats\": ["
+                << static_cast<int>(volume.textureFormats.rayDataFormat) << ", "
+                << static_cast<int>(volume.textureFormats.irradianceFormat) << ", "
+                << static_cast<int>(volume.textureFormats.distanceFormat) << ", "
+                << static_cast<int>(volume.textureFormats.dataFormat) << ", "
+                << static_cast<int>(volume.textureFormats.variabilityFormat) << "]";
+            out << "\n      }";
+        }
+        out << "\n    ]\n  }";
+    }
+
+    /**
+     * Write the distribution statistics, the (non-empty) histogram buckets, and the per-frame samples of the stats
+     * as a JSON array.
+     */
+    void WriteJSONStats(std::ostream& out, const std::vector<Instrumentation::Stat*>& stats)
+    {
+        out << "[";
+        for (size_t index = 0; index < stats.size(); index++)
+        {
+            const Instrumentation::Stat* stat = stats[index];
+            out << (index > 0 ? "," : "") << "\n    {\n      \"name\": ";
+            WriteJSONString(out, stat->name);
+            out << ",\n      \"count\": " << stat->numSamples;
+            out << ",\n      \"average\": " << stat->average;
+            out << ",\n      \"mean\": " << stat->mean;
+            out << ",\n      \"minimum\": " << stat->minimum;
+            out << ",\n      \"maximum\": " << stat->maximum;
+            out << ",\n      \"stddev\": " << stat->GetStandardDeviation();
+            out << ",\n      \"variance\": " << stat->GetVariance();
+            for (uint32_t percentileIndex = 0; percentileIndex < NumPercentiles; percentileIndex++)
+            {
+                out << ",\n      \"" << PercentileKeys[percentileIndex] << "\": " << stat->GetPercentile(Percentiles[percentileIndex]);
+            }
+
+            // Histogram buckets as [value, count] pairs, where value is the middle of the bucket (in milliseconds)
+            out << ",\n      \"histogram\": [";
+            bool first = true;
+            for (uint32_t bucket = 0; stat->histogram && bucket < Instrumentation::HistogramBuckets; bucket++)
+            {
+                if (stat->histogram[bucket] == 0) continue;
+                out << (first ? "" : ", ") << "[" << Instrumentation::GetHistogramBucketValue(bucket) << ", " << stat->histogram[bucket] << "]";
+                first = false;
+            }
+            out << "]";
+
+            // Per-frame samples (the last sampleSize frames), oldest first
+            out << ",\n      \"samples\": [";
+            for (uint32_t sampleIndex = 0; stat->samples && sampleIndex < stat->sampleCount; sampleIndex++)
+            {
+                out << (sampleIndex > 0 ? ", " : "") << stat->GetSample(sampleIndex);
+            }
+            out << "]\n    }";
+        }
+        out << "\n  ]";
+    }
+
+    /**
+     * Write the benchmark results (metadata and the distributions and samples of the CPU and GPU times) to a JSON file.
+     */
+    bool WriteBenchmarkJSON(const std::string& file, const BenchmarkRun& benchmarkRun, const Instrumentation::Performance& perf, const Configs::Config& config)
+    {
+        std::ofstream json(file, std::ios::out);
+        if (!json.is_open()) return false;
+
+        json << std::fixed << std::setprecision(6);
+        json << "{\n  \"format\": \"rtxgi-benchmark\"";
+        json << ",\n  \"version\": " << BenchmarkResultsVersion;
+        json << ",\n  \"metadata\": ";
+        WriteJSONMetadata(json, benchmarkRun, config);
+        json << ",\n  \"cpu\": ";
+        WriteJSONStats(json, perf.cpuTimes);
+        json << ",\n  \"gpu\": ";
+        WriteJSONStats(json, perf.gpuTimes);
+        json << "\n}\n";
+        return json.good();
+    }
+
+    //----------------------------------------------------------------------------------------------------------
+    // Scenario
+    //----------------------------------------------------------------------------------------------------------
+
+    XMVECTOR LoadKeyframe(const Configs::BenchmarkCameraKeyframe& keyframe, bool angles)
+    {
+        if (angles) return XMVectorSet(keyframe.yaw, keyframe.pitch, 0.f, 0.f);
+        return XMLoadFloat3(&keyframe.position);
+    }
+
+    /**
+     * Get the (Catmull-Rom) tangent of the camera path at a keyframe, per second.
+     * Keyframes with the same time are cuts, the tangents don't cross them.
+     */
+    XMVECTOR GetKeyframeTangent(const std::vector<Configs::BenchmarkCameraKeyframe>& path, size_t index, bool angles)
+    {
+        size_t prev = (index > 0 && path[index - 1].time < path[index].time) ? index - 1 : index;
+        size_t next = (index + 1 < path.size() && path[index + 1].time > path[index].time) ? index + 1 : index;
+
+        float duration = path[next].time - path[prev].time;
+        if (duration <= 0.f) return XMVectorZero();
+        return XMVectorScale(XMVectorSubtract(LoadKeyframe(path[next], angles), LoadKeyframe(path[prev], angles)), 1.f / duration);
+    }
+
+    /**
+     * Evaluate the camera path (a spline through the keyframes' positions and angles) at the given time.
+     * The camera holds the first keyframe before the path starts and the last keyframe after it ends.
+     */
+    void EvaluateCameraPath(const std::vector<Configs::BenchmarkCameraKeyframe>& path, float time, XMFLOAT3& position, float& yaw, float& pitch)
+    {
+        const Configs::BenchmarkCameraKeyframe* keyframe = nullptr;
+        if (time <= path.front().time) keyframe = &path.front();
+        else if (time >= path.back().time) keyframe = &path.back();
+        if (keyframe)
+        {
+            position = keyframe->position;
+            yaw = keyframe->yaw;
+            pitch = keyframe->pitch;
+            return;
+        }
+
+        // Find the keyframes before and after the time
+        size_t next = static_cast<size_t>(std::upper_bound(path.begin(), path.end(), time, [](float t, const Configs::BenchmarkCameraKeyframe& k) { return t < k.time; }) - path.begin());
+        size_t prev = next - 1;
+
+        // Interpolate with cubic Hermite curves, the tangents are scaled to the segment's duration
+        float duration = path[next].time - path[prev].time;
+        float t = (time - path[prev].time) / duration;
+
+        XMVECTOR p = XMVectorHermite(
+            LoadKeyframe(path[prev], false), XMVectorScale(GetKeyframeTangent(path, prev, false), duration),
+            LoadKeyframe(path[next], false), XMVectorScale(GetKeyframeTangent(path, next, false), duration), t);
+        XMVECTOR a = XMVectorHermite(
+            LoadKeyframe(path[prev], true), XMVectorScale(GetKeyframeTangent(path, prev, true), duration),
+            LoadKeyframe(path[next], true), XMVectorScale(GetKeyframeTangent(path, next, true), duration), t);
+
+        XMStoreFloat3(&position, p);
+        yaw = XMVectorGetX(a);
+        pitch = XMVectorGetY(a);
+    }
+
+    /**
+     * Apply a scenario light change to the scene lights with the event's light name.
+     */
+    void ApplyLightEvent(const Configs::BenchmarkLightEvent& event, Scenes::Scene& scene)
     {
+        for (Scenes::Light& light : scene.lights)
+        {
+            if (light.name != event.light) continue;
+
+            if (event.setPosition) light.data.position = { event.position.x, event.position.y, event.position.z };
+            if (event.setDirection) light.data.direction = { event.direction.x, event.direction.y, event.direction.z };
+            if (event.setColor) light.data.color = { event.color.x, event.color.y, event.color.z };
+            if (event.setPower) light.data.power = event.power;
+            light.dirty = true;
+        }
+    }
+
+    /**
+     * Restore the camera, lights, volume update toggles, and scroll anchors the scenario changed.
+     */
+    void RestoreScenarioState(BenchmarkRun& benchmarkRun, Configs::Config& config, Scenes::Scene& scene, std::vector<rtxgi::DDGIVolumeBase*>& volumes, Graphics::Globals& gfx)
+    {
+        if (benchmarkRun.cameras.size() == scene.cameras.size())
+        {
+            scene.cameras = benchmarkRun.cameras;
+            scene.activeCamera = benchmarkRun.activeCamera;
+        }
+
+        for (size_t lightIndex = 0; lightIndex < std::min(benchmarkRun.lights.size(), scene.lights.size()); lightIndex++)
+        {
+            if (memcmp(&scene.lights[lightIndex].data, &benchmarkRun.lights[lightIndex], sizeof(Graphics::Light)) == 0) continue;
+            scene.lights[lightIndex].data = benchmarkRun.lights[lightIndex];
+            scene.lights[lightIndex].dirty = true;
+        }
+
+        for (size_t volumeIndex = 0; volumeIndex < std::min(benchmarkRun.volumeUpdateEnabled.size(), config.ddgi.volumes.size()); volumeIndex++)
+        {
+            config.ddgi.volumes[volumeIndex].updateEnabled = (benchmarkRun.volumeUpdateEnabled[volumeIndex] != 0);
+        }
+
+        // Infinite scrolling volumes return to where they were before the scenario moved them (see scrollWithCamera)
+        for (size_t volumeIndex = 0; volumeIndex < std::min(benchmarkRun.volumeScrollAnchors.size(), volumes.size()); volumeIndex++)
+        {
+            if (volumes[volumeIndex]->GetMovementType() == rtxgi::EDDGIVolumeMovementType::Scrolling) volumes[volumeIndex]->SetScrollAnchor(benchmarkRun.volumeScrollAnchors[volumeIndex]);
+        }
+
+        gfx.frameNumber = 1; // path tracer accumulation reset
+    }
+
+    //----------------------------------------------------------------------------------------------------------
+    // Public Functions
+    //----------------------------------------------------------------------------------------------------------
+
+    void StartBenchmark(BenchmarkRun& benchmarkRun, Instrumentation::Performance& perf, Configs::Config& config, Scenes::Scene& scene, std::vector<rtxgi::DDGIVolumeBase*>& volumes, Graphics::Globals& gfx)
+    {
+        const Configs::Benchmark& scenario = config.benchmark;
+
         std::filesystem::create_directories(config.scene.screenshotPath.c_str());
 
+        benchmarkRun.numWarmupFrames = 0;
         benchmarkRun.numFramesBenched = 0;
+        benchmarkRun.nextLightEvent = 0;
+        benchmarkRun.nextVolumeEvent = 0;
         benchmarkRun.cpuTimingCsv.str("");
         benchmarkRun.gpuTimingCsv.str("");
 
+        // Store the state the scenario changes
+        benchmarkRun.activeCamera = scene.activeCamera;
+        benchmarkRun.cameras = scene.cameras;
+        benchmarkRun.lights.resize(scene.lights.size());
+        for (size_t lightIndex = 0; lightIndex < scene.lights.size(); lightIndex++) benchmarkRun.lights[lightIndex] = scene.lights[lightIndex].data;
+        benchmarkRun.volumeUpdateEnabled.resize(config.ddgi.volumes.size());
+        for (size_t volumeIndex = 0; volumeIndex < config.ddgi.volumes.size(); volumeIndex++) benchmarkRun.volumeUpdateEnabled[volumeIndex] = config.ddgi.volumes[volumeIndex].updateEnabled ? 1 : 0;
+        benchmarkRun.volumeScrollAnchors.resize(volumes.size());
+        for (size_t volumeIndex = 0; volumeIndex < volumes.size(); volumeIndex++) benchmarkRun.volumeScrollAnchors[volumeIndex] = volumes[volumeIndex]->GetScrollAnchor();
+
+        // Render from the scenario's camera, not from wherever the camera was left
+        if (scenario.camera < static_cast<uint32_t>(scene.cameras.size()))
+        {
+            scene.activeCamera = scenario.camera;
+            if (scenario.cameraPath.empty() && scenario.camera < static_cast<uint32_t>(config.scene.cameras.size()))
+            {
+                // Without a camera path, start from the camera's configured position and orientation
+                const Configs::Camera& camera = config.scene.cameras[scenario.camera];
+                scene.GetActiveCamera().data.position = { camera.position.x, camera.position.y, camera.position.z };
+                scene.GetActiveCamera().yaw = camera.yaw;
+                scene.GetActiveCamera().pitch = camera.pitch;
+                Scenes::UpdateCamera(scene.GetActiveCamera());
+            }
+        }
+
         // Clear timer history when starting benchmark mode
-        perf.Reset(NumBenchmarkFrames);
+        perf.Reset(scenario.frames);
         if (config.app.renderMode == ERenderMode::DDGI)
         {
             // Reload ddgi configs to reset the RNG state
@@ -33,68 +397,104 @@ namespace Benchmark
         config.app.benchmarkRunning = true;
     }
 
-    bool UpdateBenchmark(BenchmarkRun& benchmarkRun, Instrumentation::Performance& perf, Configs::Config& config, Graphics::Globals& gfx, std::ofstream& log)
+    /**
+     * Advance the benchmark scenario: move the camera along its path and apply the light and volume events.
+     * Call each frame of a benchmark run, before the scene and DDGIVolumes are updated.
+     */
+    void UpdateScenario(BenchmarkRun& benchmarkRun, Configs::Config& config, Scenes::Scene& scene, std::vector<rtxgi::DDGIVolumeBase*>& volumes, Graphics::Globals& gfx)
+    {
+        const Configs::Benchmark& scenario = config.benchmark;
+
+        // Warm-up frames hold the scenario at its start, measured frames advance it by the fixed frame time
+        // (the scenario doesn't depend on the actual frame times, so runs are repeatable)
+        double frame = (benchmarkRun.numWarmupFrames < scenario.warmupFrames) ? 0.0 : static_cast<double>(benchmarkRun.numFramesBenched);
+        float time = static_cast<float>((frame * static_cast<double>(scenario.frameTime)) / 1000.0);
+
+        // Camera path
+        if (!scenario.cameraPath.empty() && !scene.cameras.empty())
+        {
+            Scenes::Camera& camera = scene.GetActiveCamera();
+
+            XMFLOAT3 position;
+            float yaw, pitch;
+            EvaluateCameraPath(scenario.cameraPath, time, position, yaw, pitch);
+            if (position.x != camera.data.position.x || position.y != camera.data.position.y || position.z != camera.data.position.z || yaw != camera.yaw || pitch != camera.pitch)
+            {
+                camera.data.position = { position.x, position.y, position.z };
+                camera.yaw = yaw;
+                camera.pitch = pitch;
+                Scenes::UpdateCamera(camera);
+                gfx.frameNumber = 1; // path tracer accumulation reset
+            }
+        }
+
+        // Light changes
+        while (benchmarkRun.nextLightEvent < static_cast<uint32_t>(scenario.lightEvents.size()) && scenario.lightEvents[benchmarkRun.nextLightEvent].time <= time)
+        {
+            ApplyLightEvent(scenario.lightEvents[benchmarkRun.nextLightEvent], scene);
+            benchmarkRun.nextLightEvent++;
+        }
+
+        // Volume update toggles
+        while (benchmarkRun.nextVolumeEvent < static_cast<uint32_t>(scenario.volumeEvents.size()) && scenario.volumeEvents[benchmarkRun.nextVolumeEvent].time <= time)
+        {
+            const Configs::BenchmarkVolumeEvent& event = scenario.volumeEvents[benchmarkRun.nextVolumeEvent];
+            config.ddgi.volumes[event.volume].updateEnabled = event.updateEnabled;
+            benchmarkRun.nextVolumeEvent++;
+        }
+
+        // Infinite scrolling volumes follow the camera
+        if (scenario.scrollWithCamera && !scene.cameras.empty())
+        {
+            const Graphics::Camera& camera = scene.GetActiveCamera().data;
+            for (rtxgi::DDGIVolumeBase* volume : volumes)
+            {
+                if (volume->GetMovementType() == rtxgi::EDDGIVolumeMovementType::Scrolling) volume->SetScrollAnchor({ camera.position.x, camera.position.y, camera.position.z });
+            }
+        }
+    }
+
+    bool UpdateBenchmark(BenchmarkRun& benchmarkRun, Instrumentation::Performance& perf, Configs::Config& config, Scenes::Scene& scene, std::vector<rtxgi::DDGIVolumeBase*>& volumes, Graphics::Globals& gfx, std::ofstream& log)
     {
-        config.app.benchmarkProgress = (uint32_t)(((float)benchmarkRun.numFramesBenched / (float)NumBenchmarkFrames) * 100.f);
+        const Configs::Benchmark& scenario = config.benchmark;
+        config.app.benchmarkProgress = (uint32_t)(((float)(benchmarkRun.numWarmupFrames + benchmarkRun.numFramesBenched) / (float)(scenario.warmupFrames + scenario.frames)) * 100.f);
+
+        // Warm-up frames aren't measured, clear the timer history when they're done
+        if (benchmarkRun.numWarmupFrames < scenario.warmupFrames)
+        {
+            benchmarkRun.numWarmupFrames++;
+            if (benchmarkRun.numWarmupFrames == scenario.warmupFrames) perf.Reset(scenario.frames);
+            return false;
+        }
 
         // If the benchmark is currently running, make a row for the frame's timings
-        if(benchmarkRun.numFramesBenched < NumBenchmarkFrames)
+        if(benchmarkRun.numFramesBenched < scenario.frames)
         {
-            benchmarkRun.cpuTimingCsv << gfx.frameNumber << ",";
-            benchmarkRun.gpuTimingCsv << gfx.frameNumber << ",";
+            benchmarkRun.cpuTimingCsv << benchmarkRun.numFramesBenched << ",";
+            benchmarkRun.gpuTimingCsv << benchmarkRun.numFramesBenched << ",";
             benchmarkRun.cpuTimingCsv << perf.cpuTimes;
             benchmarkRun.gpuTimingCsv << perf.gpuTimes;
         }
         else
         {
             // If the benchmark is done, write the timing results to disk
-            size_t index;
             std::string cpuHeader = "";
             std::string gpuHeader = "";
 
-            std::vector<float> cpuAverages;
-            std::vector<float> gpuAverages;
-
-            // Generate the average timing rows for the CPU
-            cpuHeader.append("Average,");
-            for (index = 0; index < perf.cpuTimes.size(); index++)
-            {
-                cpuHeader.append(std::to_string(perf.cpuTimes[index]->average));
-                cpuHeader.append(",");
-            }
-
-            // Generate the header rows for the CPU time categories
-            cpuHeader.append("\n");
-            cpuHeader.append("FrameIndex,");
-            for (index = 0; index < perf.cpuTimes.size(); index++)
-            {
-                cpuHeader.append(perf.cpuTimes[index]->name.c_str());
-                cpuHeader.append(",");
-            }
-
-            // Generate the average timing rows for the GPU
-            gpuHeader.append("Average,");
-            for (index = 0; index < perf.gpuTimes.size(); index++)
-            {
-                gpuHeader.append(std::to_string(perf.gpuTimes[index]->average));
-                gpuHeader.append(",");
-            }
+            // Generate the average timing row and the header row for the CPU time categories
+            AppendStatRow(cpuHeader, "Average", perf.cpuTimes, [](const Instrumentation::Stat* s) { return s->average; });
+            AppendStatHeader(cpuHeader, "FrameIndex", perf.cpuTimes);
 
-            // Generate the header rows for the GPU time categories
-            gpuHeader.append("\n");
-            gpuHeader.append("FrameIndex,");
-            for (index = 0; index < perf.gpuTimes.size(); index++)
-            {
-                gpuHeader.append(perf.gpuTimes[index]->name);
-                gpuHeader.append(",");
-            }
+            // Generate the average timing row and the header row for the GPU time categories
+            AppendStatRow(gpuHeader, "Average", perf.gpuTimes, [](const Instrumentation::Stat* s) { return s->average; });
+            AppendStatHeader(gpuHeader, "FrameIndex", perf.gpuTimes);
 
             // Write the CPU times to file
             std::ofstream csv;
             csv.open(config.scene.screenshotPath + "/benchmarkCpu.csv", std::ios::out);
             if (csv.is_open())
             {
-                csv << cpuHeader << std::endl << benchmarkRun.cpuTimingCsv.str();
+                csv << cpuHeader << benchmarkRun.cpuTimingCsv.str();
             }
             csv.close();
 
@@ -102,22 +502,30 @@ namespace Benchmark
             csv.open(config.scene.screenshotPath + "/benchmarkGpu.csv", std::ios::out);
             if (csv.is_open())
             {
-                csv << gpuHeader << std::endl << benchmarkRun.gpuTimingCsv.str();
+                csv << gpuHeader << benchmarkRun.gpuTimingCsv.str();
             }
             csv.close();
+
+            // Write the distribution statistics and percentiles of the CPU and GPU times to separate files
+            WriteStatSummaryCSV(config.scene.screenshotPath + "/benchmarkCpuSummary.csv", perf.cpuTimes);
+            WriteStatSummaryCSV(config.scene.screenshotPath + "/benchmarkGpuSummary.csv", perf.gpuTimes);
             log << "Wrote benchmark results to csv." << std::endl;
 
-            // Print averages to the log file
+            // Write the machine-readable results (see rtxgi-bench-compare) to file
+            if (WriteBenchmarkJSON(config.scene.screenshotPath + "/benchmark.json", benchmarkRun, perf, config)) log << "Wrote benchmark results to json." << std::endl;
+
+            // Print averages (and the 99th percentiles) to the log file
             log << "Benchmark Timings:" << std::endl;
             for (Instrumentation::Stat* stat : perf.cpuTimes)
             {
-                log << "\t" << stat->name << "=" << stat->average << "ms(CPU)" << std::endl;
+                log << "\t" << stat->name << "=" << stat->average << "ms(CPU), p99=" << stat->GetPercentile(99.0) << "ms" << std::endl;
             }
             for (Instrumentation::Stat* stat : perf.gpuTimes)
             {
-                log << "\t" << stat->name << "=" << stat->average << "ms(GPU)" << std::endl;
+                log << "\t" << stat->name << "=" << stat->average << "ms(GPU), p99=" << stat->GetPercentile(99.0) << "ms" << std::endl;
             }
 
+            RestoreScenarioState(benchmarkRun, config, scene, volumes, gfx);
             config.app.benchmarkRunning = false;
             return true;
         }
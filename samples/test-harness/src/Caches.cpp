@@ -10,321 +10,725 @@
 
 #include "Caches.h"
 
+#include <filesystem>
+
+#if __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace DirectX;
 
-#define SCENE_CACHE_VERSION 4
+#define SCENE_CACHE_VERSION 7
+#define SCENE_CACHE_ALIGNMENT 256
 
 namespace Caches
 {
 
     //----------------------------------------------------------------------------------------------------------
-    // Private Deserialization Functions
+    // Scene Cache File Format
+    //
+    // [CacheHeader][CacheSection table][BLOBS section][other sections...]
+    //
+    // Every section starts at a SCENE_CACHE_ALIGNMENT aligned file offset. Sections hold arrays of fixed size
+    // records; strings and node child indices are stored in the STRINGS and NODE_CHILDREN sections. The ASSETS
+    // section lists the files (and import settings) the scene was imported from, see IsCurrent(). Vertex, index,
+    // and texel data is stored in the BLOBS section, with each blob aligned to SCENE_CACHE_ALIGNMENT, so the data
+    // can be used in place (or copied straight to GPU upload buffers) from the memory-mapped file.
+    //
+    // The BLOBS section is written first, so mesh data can be streamed to the file during import (see Stream).
+    // Readers locate sections through the section table only and make no assumptions about their order.
     //----------------------------------------------------------------------------------------------------------
 
-    void Read(std::ifstream& in, uint32_t* value)
+    enum ECacheSection
     {
-        in.read((char*)value, sizeof(uint32_t));
-        in.seekg(in.tellg());
-    }
+        SECTION_SCENE = 0,
+        SECTION_ROOT_NODES,
+        SECTION_NODES,
+        SECTION_NODE_CHILDREN,
+        SECTION_CAMERAS,
+        SECTION_LIGHTS,
+        SECTION_INSTANCES,
+        SECTION_MESHES,
+        SECTION_PRIMITIVES,
+        SECTION_MATERIALS,
+        SECTION_TEXTURES,
+        SECTION_ASSETS,
+        SECTION_STRINGS,
+        SECTION_BLOBS,
+        SECTION_COUNT
+    };
+
+    struct CacheHeader
+    {
+        uint32_t version;           // SCENE_CACHE_VERSION (first, so caches of all versions are detected)
+        uint32_t coordinateSystem;
+        uint32_t numSections;       // SECTION_COUNT
+        uint32_t alignment;         // SCENE_CACHE_ALIGNMENT
+        uint64_t fileSize;
+    };
+
+    struct CacheSection
+    {
+        uint64_t offset;            // in bytes, from the start of the file
+        uint64_t size;              // in bytes
+        uint64_t count;             // number of records (or blobs)
+    };
 
-    void Read(std::ifstream& in, void* value, size_t size)
+    struct StringRef
     {
-        in.read((char*)value, size);
-        in.seekg(in.tellg());
-    }
+        uint32_t offset;            // in bytes, from the start of the STRINGS section
+        uint32_t length;
+    };
 
-    void ReadTexture(std::ifstream& in, Textures::Texture& texture)
-    {
-        // Texture name
-        uint32_t numChars;
-        Read(in, &numChars);
-
-        char* buffer = new char[numChars];
-        in.read(buffer, numChars);
-        in.seekg(in.tellg());
-        texture.name = std::string(buffer);
-        delete[] buffer;
-
-        // Texture filepath
-        Read(in, &numChars);
-
-        buffer = new char[numChars];
-        in.read(buffer, numChars);
-        in.seekg(in.tellg());
-        texture.filepath = std::string(buffer);
-        delete[] buffer;
-
-        // Texture metadata
-        Read(in, &texture.type, sizeof(Textures::ETextureType));
-        Read(in, &texture.format, sizeof(Textures::ETextureFormat));
-        Read(in, &texture.width);
-        Read(in, &texture.height);
-        Read(in, &texture.stride);
-        Read(in, &texture.mips);
-        Read(in, &texture.texelBytes, sizeof(uint64_t));
-
-        texture.texels = new uint8_t[texture.texelBytes];
-        memset(texture.texels, 0, texture.texelBytes);
-        Read(in, texture.texels, texture.texelBytes);
-
-        texture.cached = true;
-    }
+    struct SceneRecord
+    {
+        uint32_t activeCamera;
+        uint32_t numMeshPrimitives;
+        uint32_t numTriangles;
+        uint32_t hasDirectionalLight;
+        uint32_t numPointLights;
+        uint32_t numSpotLights;
+        rtxgi::AABB boundingBox;
+    };
+
+    struct NodeRecord
+    {
+        int instance;
+        int camera;
+        XMFLOAT3 translation;
+        XMFLOAT4 rotation;
+        XMFLOAT3 scale;
+        uint32_t firstChild;        // index into the NODE_CHILDREN section
+        uint32_t numChildren;
+    };
+
+    struct CameraRecord
+    {
+        StringRef name;
+        Graphics::Camera data;
+    };
+
+    struct LightRecord
+    {
+        StringRef name;
+        Graphics::Light data;
+    };
+
+    struct InstanceRecord
+    {
+        StringRef name;
+        int meshIndex;
+        rtxgi::AABB boundingBox;
+        float transform[3][4];
+    };
+
+    struct MeshRecord
+    {
+        StringRef name;
+        uint64_t hash;
+        int index;
+        uint32_t numIndices;
+        uint32_t numVertices;
+        rtxgi::AABB boundingBox;
+        uint32_t firstPrimitive;    // index into the PRIMITIVES section
+        uint32_t numPrimitives;
+        uint32_t pad0;
+    };
 
-    void ReadMaterial(std::ifstream& in, Scenes::Material& material)
+    struct PrimitiveRecord
+    {
+        int index;
+        int material;
+        uint32_t opaque;
+        uint32_t doubleSided;
+        uint32_t indexByteOffset;
+        uint32_t vertexByteOffset;
+        rtxgi::AABB boundingBox;
+        uint32_t vertexFormat;      // Graphics::VERTEX_FORMAT of the vertex data
+        uint32_t numVertices;
+        uint32_t numIndices;
+        uint32_t pad0;
+        uint64_t vertexOffset;      // in bytes, from the start of the BLOBS section
+        uint64_t indexOffset;       // in bytes, from the start of the BLOBS section
+    };
+
+    struct MaterialRecord
+    {
+        StringRef name;
+        Graphics::Material data;
+    };
+
+    struct TextureRecord
+    {
+        StringRef name;
+        StringRef filepath;
+        uint32_t type;
+        uint32_t format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t stride;
+        uint32_t mips;
+        uint64_t texelBytes;
+        uint64_t texelOffset;       // in bytes, from the start of the BLOBS section
+    };
+
+    struct AssetRecord
     {
-        uint32_t numChars = 0;
-        Read(in, &numChars);
+        uint32_t type;
+        int index;
+        StringRef filepath;
+        uint64_t size;
+        int64_t mtime;
+        uint64_t hash;
+    };
 
-        char* buffer = new char[numChars];
-        in.read(buffer, numChars);
-        in.seekg(in.tellg());
-        material.name = std::string(buffer);
-        delete[] buffer;
+    //----------------------------------------------------------------------------------------------------------
+    // Private File Mapping Functions
+    //----------------------------------------------------------------------------------------------------------
 
-        Read(in, &material.data, material.GetGPUDataSize());
+    /**
+     * Map a file into (read-only) memory.
+     */
+    bool MapFile(const std::string& filepath, uint8_t** data, uint64_t& size)
+    {
+    #if defined(_WIN32) || defined(WIN32)
+        HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        // The view keeps the file mapping alive once the handles are closed
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr) return false;
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (view == nullptr) return false;
+
+        *data = static_cast<uint8_t*>(view);
+        size = static_cast<uint64_t>(fileSize.QuadPart);
+        return true;
+    #elif __linux__
+        int file = open(filepath.c_str(), O_RDONLY);
+        if (file < 0) return false;
+
+        struct stat status = {};
+        if (fstat(file, &status) != 0 || status.st_size <= 0)
+        {
+            close(file);
+            return false;
+        }
+
+        // The mapping remains valid once the file is closed
+        void* view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        close(file);
+        if (view == MAP_FAILED) return false;
+
+        // Start reading the file in ahead of use
+        madvise(view, static_cast<size_t>(status.st_size), MADV_WILLNEED);
+
+        *data = static_cast<uint8_t*>(view);
+        size = static_cast<uint64_t>(status.st_size);
+        return true;
+    #else
+        return false;
+    #endif
     }
 
-    void ReadMesh(std::ifstream& in, Scenes::Mesh& mesh)
+    /**
+     * Release a file mapping.
+     */
+    void UnmapFile(uint8_t* data, uint64_t size)
     {
-        uint32_t numChars = 0;
-        Read(in, &numChars);
+        if (data == nullptr) return;
+    #if defined(_WIN32) || defined(WIN32)
+        UnmapViewOfFile(data);
+    #elif __linux__
+        munmap(data, static_cast<size_t>(size));
+    #endif
+    }
 
-        char* buffer = new char[numChars];
-        in.read(buffer, numChars);
-        in.seekg(in.tellg());
-        mesh.name = std::string(buffer);
-        delete[] buffer;
+    //----------------------------------------------------------------------------------------------------------
+    // Private Deserialization Functions
+    //----------------------------------------------------------------------------------------------------------
 
-        Read(in, &mesh.index, sizeof(uint32_t));
-        Read(in, &mesh.numIndices, sizeof(uint32_t));
-        Read(in, &mesh.numVertices, sizeof(uint32_t));
+    /**
+     * Get a validated view of a scene cache's sections.
+     */
+    struct CacheView
+    {
+        const uint8_t* data = nullptr;
+        const CacheSection* sections = nullptr;
 
-        // Read mesh bounding box
-        Read(in, &mesh.boundingBox, sizeof(rtxgi::AABB));
+        template<typename T>
+        const T* GetRecords(uint32_t section) const { return reinterpret_cast<const T*>(data + sections[section].offset); }
 
-        // Read MeshPrimitives
-        uint32_t numPrimitives;
-        Read(in, &numPrimitives);
-        mesh.primitives.resize(numPrimitives);
-        for (uint32_t primitiveIndex = 0; primitiveIndex < numPrimitives; primitiveIndex++)
+        uint32_t GetCount(uint32_t section) const { return static_cast<uint32_t>(sections[section].count); }
+
+        bool IsValidString(const StringRef& ref) const
         {
-            uint32_t numVertices = 0;
-            uint32_t numIndices = 0;
+            return (static_cast<uint64_t>(ref.offset) + ref.length) <= sections[SECTION_STRINGS].size;
+        }
 
-            Scenes::MeshPrimitive& mp = mesh.primitives[primitiveIndex];
+        std::string GetString(const StringRef& ref) const
+        {
+            return std::string(reinterpret_cast<const char*>(data + sections[SECTION_STRINGS].offset + ref.offset), ref.length);
+        }
 
-            // Read the mesh primitive data
-            Read(in, &mp.index, sizeof(int));
-            Read(in, &mp.material, sizeof(int));
-            Read(in, &mp.opaque, sizeof(bool));
-            Read(in, &mp.doubleSided, sizeof(bool));
-            Read(in, &mp.indexByteOffset, sizeof(uint32_t));
-            Read(in, &mp.vertexByteOffset, sizeof(uint32_t));
-            Read(in, &mp.boundingBox, sizeof(rtxgi::AABB)); // post-transform bounding box
+        bool IsValidBlob(uint64_t offset, uint64_t size) const
+        {
+            const CacheSection& blobs = sections[SECTION_BLOBS];
+            return (offset % SCENE_CACHE_ALIGNMENT) == 0 && offset <= blobs.size && size <= (blobs.size - offset);
+        }
+
+        const uint8_t* GetBlob(uint64_t offset) const { return data + sections[SECTION_BLOBS].offset + offset; }
+
+        bool IsValidIndex(int index, uint32_t section) const
+        {
+            return index >= 0 && static_cast<uint32_t>(index) < GetCount(section);
+        }
+    };
+
+    /**
+     * Get the texel bytes (aligned, all mips) the texture loader produces for a texture's format, dimensions, and mips.
+     * Returns 0 when the loader doesn't produce textures with the given description.
+     */
+    uint64_t GetTexelBytes(const TextureRecord& record)
+    {
+        const uint32_t maxDimension = 16384;    // D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION
+        if (record.width == 0 || record.height == 0 || record.width > maxDimension || record.height > maxDimension) return 0;
 
-            Read(in, &numVertices);
-            mp.vertices.resize(numVertices);
-            Read(in, mp.vertices.data(), sizeof(Graphics::Vertex) * numVertices);
+        if (record.format == static_cast<uint32_t>(Textures::ETextureFormat::UNCOMPRESSED))
+        {
+            // RGBA8 texels, padded to 4x4 texels, with rows aligned to 256B (see FormatTexture())
+            if (record.stride != 4 || record.mips != 1 || (record.width % 4) != 0 || (record.height % 4) != 0) return 0;
+            return static_cast<uint64_t>(ALIGN(256, record.width * record.stride)) * record.height;
+        }
 
-            Read(in, &numIndices);
-            mp.indices.resize(numIndices);
-            Read(in, mp.indices.data(), sizeof(uint32_t) * numIndices);
+        if (record.format == static_cast<uint32_t>(Textures::ETextureFormat::BC7))
+        {
+            // Aligned BC7 mip levels, the last mip level is a single block (see FormatCompressedTexture())
+            uint32_t maxMips = 1;
+            while ((std::max(record.width, record.height) >> maxMips) > 0) maxMips++;
+            if (record.stride != 1 || record.mips == 0 || record.mips > maxMips) return 0;
 
-            // Update the mesh bounding box
-            mesh.boundingBox.min = { fmin(mesh.boundingBox.min.x, mp.boundingBox.min.x), fmin(mesh.boundingBox.min.y, mp.boundingBox.min.y) };
-            mesh.boundingBox.max = { fmax(mesh.boundingBox.max.x, mp.boundingBox.max.x), fmax(mesh.boundingBox.max.y, mp.boundingBox.max.y) };
+            uint64_t texelBytes = 0;
+            for (uint32_t mipIndex = 0; mipIndex < record.mips; mipIndex++)
+            {
+                if (record.mips > 1 && (mipIndex + 1) == record.mips)
+                {
+                    texelBytes += 16;
+                    break;
+                }
+
+                uint32_t alignedWidth = ALIGN(4, std::max(record.width >> mipIndex, 1u));
+                uint32_t alignedHeight = ALIGN(4, std::max(record.height >> mipIndex, 1u));
+                texelBytes += Textures::GetBC7TextureSizeInBytes(alignedWidth, alignedHeight);
+            }
+            return texelBytes;
         }
+
+        return 0;
     }
 
-    void ReadMeshInstance(std::ifstream& in, Scenes::MeshInstance& instance)
+    /**
+     * Check that the section table describes sections that are inside the file and hold whole records.
+     */
+    bool ValidateSections(const CacheView& view, uint64_t fileSize)
     {
-        uint32_t numChars = 0;
-        Read(in, &numChars);
-
-        char* buffer = new char[numChars];
-        in.read(buffer, numChars);
-        in.seekg(in.tellg());
-        instance.name = std::string(buffer);
-        delete[] buffer;
+        const uint64_t recordSizes[SECTION_COUNT] =
+        {
+            sizeof(SceneRecord),
+            sizeof(int),
+            sizeof(NodeRecord),
+            sizeof(int),
+            sizeof(CameraRecord),
+            sizeof(LightRecord),
+            sizeof(InstanceRecord),
+            sizeof(MeshRecord),
+            sizeof(PrimitiveRecord),
+            sizeof(MaterialRecord),
+            sizeof(TextureRecord),
+            sizeof(AssetRecord),
+            0,  // strings
+            0   // blobs
+        };
+
+        for (uint32_t sectionIndex = 0; sectionIndex < SECTION_COUNT; sectionIndex++)
+        {
+            const CacheSection& section = view.sections[sectionIndex];
+            if ((section.offset % SCENE_CACHE_ALIGNMENT) != 0) return false;
+            if (section.offset > fileSize || section.size > (fileSize - section.offset)) return false;
+            if (recordSizes[sectionIndex] > 0 && section.size != (section.count * recordSizes[sectionIndex])) return false;
+            if (section.count > UINT32_MAX) return false;
+        }
 
-        Read(in, &instance.meshIndex, sizeof(int));
-        Read(in, &instance.boundingBox, sizeof(rtxgi::AABB));
-        Read(in, &instance.transform, sizeof(float) * 12);
+        return (view.GetCount(SECTION_SCENE) == 1);
     }
 
-    void ReadLight(std::ifstream& in, Scenes::Light& light)
+    bool ReadSceneNodes(const CacheView& view, Scenes::Scene& scene)
     {
-        uint32_t numChars = 0;
-        Read(in, &numChars);
+        // Root nodes
+        const int* rootNodes = view.GetRecords<int>(SECTION_ROOT_NODES);
+        scene.rootNodes.assign(rootNodes, rootNodes + view.GetCount(SECTION_ROOT_NODES));
+        for (int rootNode : scene.rootNodes)
+        {
+            if (!view.IsValidIndex(rootNode, SECTION_NODES)) return false;
+        }
 
-        char* buffer = new char[numChars];
-        in.read(buffer, numChars);
-        in.seekg(in.tellg());
-        light.name = std::string(buffer);
-        delete[] buffer;
+        // Scene nodes and their child node indices
+        const NodeRecord* nodes = view.GetRecords<NodeRecord>(SECTION_NODES);
+        const int* children = view.GetRecords<int>(SECTION_NODE_CHILDREN);
+        uint32_t numChildren = view.GetCount(SECTION_NODE_CHILDREN);
 
-        Read(in, &light.data, light.GetGPUDataSize());
+        scene.nodes.resize(view.GetCount(SECTION_NODES));
+        for (uint32_t nodeIndex = 0; nodeIndex < static_cast<uint32_t>(scene.nodes.size()); nodeIndex++)
+        {
+            const NodeRecord& record = nodes[nodeIndex];
+            if (record.firstChild > numChildren || record.numChildren > (numChildren - record.firstChild)) return false;
+            if (record.instance != -1 && !view.IsValidIndex(record.instance, SECTION_INSTANCES)) return false;
+            if (record.camera != -1 && !view.IsValidIndex(record.camera, SECTION_CAMERAS)) return false;
+            for (uint32_t childIndex = 0; childIndex < record.numChildren; childIndex++)
+            {
+                if (!view.IsValidIndex(children[record.firstChild + childIndex], SECTION_NODES)) return false;
+            }
+
+            Scenes::SceneNode& node = scene.nodes[nodeIndex];
+            node.instance = record.instance;
+            node.camera = record.camera;
+            node.translation = record.translation;
+            node.rotation = record.rotation;
+            node.scale = record.scale;
+            node.children.assign(children + record.firstChild, children + record.firstChild + record.numChildren);
+        }
+        return true;
     }
 
-    void ReadCamera(std::ifstream& in, Scenes::Camera& camera)
+    bool ReadCamerasAndLights(const CacheView& view, Scenes::Scene& scene)
     {
-        uint32_t numChars = 0;
-        Read(in, &numChars);
-
-        char* buffer = new char[numChars];
-        in.read(buffer, numChars);
-        in.seekg(in.tellg());
-        camera.name = std::string(buffer);
-        delete[] buffer;
+        const CameraRecord* cameras = view.GetRecords<CameraRecord>(SECTION_CAMERAS);
+        scene.cameras.resize(view.GetCount(SECTION_CAMERAS));
+        for (uint32_t cameraIndex = 0; cameraIndex < static_cast<uint32_t>(scene.cameras.size()); cameraIndex++)
+        {
+            if (!view.IsValidString(cameras[cameraIndex].name)) return false;
+            scene.cameras[cameraIndex].name = view.GetString(cameras[cameraIndex].name);
+            scene.cameras[cameraIndex].data = cameras[cameraIndex].data;
+        }
 
-        Read(in, &camera.data, camera.GetGPUDataSize());
+        const LightRecord* lights = view.GetRecords<LightRecord>(SECTION_LIGHTS);
+        scene.lights.resize(view.GetCount(SECTION_LIGHTS));
+        for (uint32_t lightIndex = 0; lightIndex < static_cast<uint32_t>(scene.lights.size()); lightIndex++)
+        {
+            if (!view.IsValidString(lights[lightIndex].name)) return false;
+            scene.lights[lightIndex].name = view.GetString(lights[lightIndex].name);
+            scene.lights[lightIndex].data = lights[lightIndex].data;
+        }
+        return true;
     }
 
-    void ReadSceneNode(std::ifstream& in, Scenes::SceneNode& node)
+    bool ReadMeshes(const CacheView& view, Scenes::Scene& scene)
     {
-        Read(in, &node.instance, sizeof(int));
-        Read(in, &node.camera, sizeof(int));
-        Read(in, &node.translation, sizeof(XMFLOAT3));
-        Read(in, &node.rotation, sizeof(XMFLOAT4));
-        Read(in, &node.scale, sizeof(XMFLOAT3));
+        // Mesh instances
+        const InstanceRecord* instances = view.GetRecords<InstanceRecord>(SECTION_INSTANCES);
+        scene.instances.resize(view.GetCount(SECTION_INSTANCES));
+        for (uint32_t instanceIndex = 0; instanceIndex < static_cast<uint32_t>(scene.instances.size()); instanceIndex++)
+        {
+            const InstanceRecord& record = instances[instanceIndex];
+            if (!view.IsValidString(record.name)) return false;
+            if (!view.IsValidIndex(record.meshIndex, SECTION_MESHES)) return false;
+
+            Scenes::MeshInstance& instance = scene.instances[instanceIndex];
+            instance.name = view.GetString(record.name);
+            instance.meshIndex = record.meshIndex;
+            instance.boundingBox = record.boundingBox;
+            memcpy(instance.transform, record.transform, sizeof(float) * 12);
+        }
 
-        // Read child node indices
-        uint32_t numChildren;
-        Read(in, &numChildren);
-        if (numChildren <= 0) return;
+        // Meshes and mesh primitives
+        const MeshRecord* meshes = view.GetRecords<MeshRecord>(SECTION_MESHES);
+        const PrimitiveRecord* primitives = view.GetRecords<PrimitiveRecord>(SECTION_PRIMITIVES);
+        uint32_t numPrimitives = view.GetCount(SECTION_PRIMITIVES);
 
-        node.children.resize(numChildren);
-        Read(in, node.children.data(), (sizeof(int) * numChildren));
+        scene.meshes.resize(view.GetCount(SECTION_MESHES));
+        for (uint32_t meshIndex = 0; meshIndex < static_cast<uint32_t>(scene.meshes.size()); meshIndex++)
+        {
+            const MeshRecord& record = meshes[meshIndex];
+            if (!view.IsValidString(record.name)) return false;
+            if (record.firstPrimitive > numPrimitives || record.numPrimitives > (numPrimitives - record.firstPrimitive)) return false;
+
+            Scenes::Mesh& mesh = scene.meshes[meshIndex];
+            mesh.name = view.GetString(record.name);
+            mesh.hash = record.hash;
+            mesh.index = record.index;
+            mesh.numIndices = record.numIndices;
+            mesh.numVertices = record.numVertices;
+            mesh.boundingBox = record.boundingBox;
+
+            mesh.primitives.resize(record.numPrimitives);
+            for (uint32_t primitiveIndex = 0; primitiveIndex < record.numPrimitives; primitiveIndex++)
+            {
+                const PrimitiveRecord& pr = primitives[record.firstPrimitive + primitiveIndex];
+                if (pr.vertexFormat != Graphics::VERTEX_FORMAT_FULL && pr.vertexFormat != Graphics::VERTEX_FORMAT_PACKED) return false;
+                if (!view.IsValidIndex(pr.material, SECTION_MATERIALS)) return false;
+                if (!view.IsValidBlob(pr.vertexOffset, Scenes::MeshPrimitive::GetVertexStride(pr.vertexFormat) * static_cast<uint64_t>(pr.numVertices))) return false;
+                if (!view.IsValidBlob(pr.indexOffset, sizeof(uint32_t) * static_cast<uint64_t>(pr.numIndices))) return false;
+
+                Scenes::MeshPrimitive& mp = mesh.primitives[primitiveIndex];
+                mp.index = pr.index;
+                mp.material = pr.material;
+                mp.opaque = (pr.opaque != 0);
+                mp.doubleSided = (pr.doubleSided != 0);
+                mp.vertexFormat = pr.vertexFormat;
+                mp.indexByteOffset = pr.indexByteOffset;
+                mp.vertexByteOffset = pr.vertexByteOffset;
+                mp.boundingBox = pr.boundingBox;
+
+                // Point at the vertex and index data in the mapped file
+                mp.mappedVertices = view.GetBlob(pr.vertexOffset);
+                mp.mappedIndices = reinterpret_cast<const uint32_t*>(view.GetBlob(pr.indexOffset));
+                mp.numMappedVertices = pr.numVertices;
+                mp.numMappedIndices = pr.numIndices;
+            }
+        }
+        return true;
     }
 
-    //----------------------------------------------------------------------------------------------------------
-    // Private Serialization Functions
-    //----------------------------------------------------------------------------------------------------------
-
-    void Write(std::ofstream& out, void* value, size_t size = sizeof(uint32_t))
+    bool ReadMaterialsAndTextures(const CacheView& view, Scenes::Scene& scene)
     {
-        out.write(reinterpret_cast<char*>(value), size);
-        out.seekp(out.tellp());
+        const MaterialRecord* materials = view.GetRecords<MaterialRecord>(SECTION_MATERIALS);
+        scene.materials.resize(view.GetCount(SECTION_MATERIALS));
+        for (uint32_t materialIndex = 0; materialIndex < static_cast<uint32_t>(scene.materials.size()); materialIndex++)
+        {
+            if (!view.IsValidString(materials[materialIndex].name)) return false;
+            scene.materials[materialIndex].name = view.GetString(materials[materialIndex].name);
+            scene.materials[materialIndex].data = materials[materialIndex].data;
+        }
+
+        const TextureRecord* textures = view.GetRecords<TextureRecord>(SECTION_TEXTURES);
+        scene.textures.resize(view.GetCount(SECTION_TEXTURES));
+        for (uint32_t textureIndex = 0; textureIndex < static_cast<uint32_t>(scene.textures.size()); textureIndex++)
+        {
+            const TextureRecord& record = textures[textureIndex];
+            if (!view.IsValidString(record.name) || !view.IsValidString(record.filepath)) return false;
+            if (!view.IsValidBlob(record.texelOffset, record.texelBytes)) return false;
+            if (record.type != static_cast<uint32_t>(Textures::ETextureType::ENGINE) && record.type != static_cast<uint32_t>(Textures::ETextureType::SCENE)) return false;
+            if (record.texelBytes == 0 || record.texelBytes != GetTexelBytes(record)) return false;
+
+            Textures::Texture& texture = scene.textures[textureIndex];
+            texture.name = view.GetString(record.name);
+            texture.filepath = view.GetString(record.filepath);
+            texture.type = static_cast<Textures::ETextureType>(record.type);
+            texture.format = static_cast<Textures::ETextureFormat>(record.format);
+            texture.width = record.width;
+            texture.height = record.height;
+            texture.stride = record.stride;
+            texture.mips = record.mips;
+            texture.texelBytes = record.texelBytes;
+
+            // Point at the texel data in the mapped file
+            texture.texels = const_cast<uint8_t*>(view.GetBlob(record.texelOffset));
+            texture.mapped = true;
+            texture.cached = true;
+        }
+        return true;
     }
 
-    void WriteTexture(std::ofstream& out, Textures::Texture& texture)
-    {
-        // Texture name
-        uint32_t numChars = static_cast<uint32_t>(strlen(texture.name.c_str())) + 1;
-        Write(out, &numChars);
-        out.write(texture.name.c_str(), numChars);
-        out.seekp(out.tellp());
-
-        // Texture filepath
-        numChars = static_cast<uint32_t>(strlen(texture.filepath.c_str())) + 1;
-        Write(out, &numChars);
-        out.write(texture.filepath.c_str(), numChars);
-        out.seekp(out.tellp());
-
-        // Texture metadata
-        Write(out, &texture.type);
-        Write(out, &texture.format);
-        Write(out, &texture.width);
-        Write(out, &texture.height);
-        Write(out, &texture.stride);
-        Write(out, &texture.mips);
-        Write(out, &texture.texelBytes, sizeof(uint64_t));
-
-        // Texels
-        Write(out, texture.texels, texture.texelBytes);
+    bool ReadAssets(const CacheView& view, Scenes::Scene& scene)
+    {
+        const AssetRecord* assets = view.GetRecords<AssetRecord>(SECTION_ASSETS);
+        scene.assets.resize(view.GetCount(SECTION_ASSETS));
+        for (uint32_t assetIndex = 0; assetIndex < static_cast<uint32_t>(scene.assets.size()); assetIndex++)
+        {
+            const AssetRecord& record = assets[assetIndex];
+            if (!view.IsValidString(record.filepath)) return false;
+
+            Scenes::Asset& asset = scene.assets[assetIndex];
+            asset.type = static_cast<Scenes::EAssetType>(record.type);
+            asset.index = record.index;
+            asset.filepath = view.GetString(record.filepath);
+            asset.size = record.size;
+            asset.mtime = record.mtime;
+            asset.hash = record.hash;
+        }
+        return true;
     }
 
-    void WriteMaterial(std::ofstream& out, Scenes::Material& material)
+    /**
+     * Overwrite the sizes and modification times of the asset records in a scene's (memory-mapped) cache file.
+     * The records stay the same size, so the file is updated in place.
+     */
+    bool WriteAssetRecords(const std::string& filepath, const Scenes::Scene& scene)
     {
-        uint32_t numChars = static_cast<uint32_t>(strlen(material.name.c_str())) + 1;
-        Write(out, &numChars);
-        out.write(material.name.c_str(), numChars);
-        out.seekp(out.tellp());
+        if (scene.cache == nullptr) return false;
 
-        Write(out, &material.data, material.GetGPUDataSize());
-    }
+        CacheView view = { scene.cache, reinterpret_cast<const CacheSection*>(scene.cache + sizeof(CacheHeader)) };
+        if (view.GetCount(SECTION_ASSETS) != scene.assets.size()) return false;
 
-    void WriteMesh(std::ofstream& out, Scenes::Mesh& mesh)
-    {
-        uint32_t numChars = static_cast<uint32_t>(strlen(mesh.name.c_str())) + 1;
-        Write(out, &numChars);
-        out.write(mesh.name.c_str(), numChars);
-        out.seekp(out.tellp());
-
-        Write(out, &mesh.index, sizeof(uint32_t));
-        Write(out, &mesh.numIndices, sizeof(uint32_t));
-        Write(out, &mesh.numVertices, sizeof(uint32_t));
-
-        // Mesh bounding box
-        Write(out, &mesh.boundingBox, sizeof(rtxgi::AABB));
-
-        // Write MeshPrimitives
-        uint32_t numPrimitives = static_cast<uint32_t>(mesh.primitives.size());
-        Write(out, &numPrimitives);
-        for (uint32_t primitiveIndex = 0; primitiveIndex < numPrimitives; primitiveIndex++)
-        {
-            Scenes::MeshPrimitive primitive = mesh.primitives[primitiveIndex];
-            uint32_t numVertices = static_cast<uint32_t>(primitive.vertices.size());
-            uint32_t numIndices = static_cast<uint32_t>(primitive.indices.size());
-            Write(out, &primitive.index, sizeof(int));
-            Write(out, &primitive.material, sizeof(int));
-            Write(out, &primitive.opaque, sizeof(bool));
-            Write(out, &primitive.doubleSided, sizeof(bool));
-            Write(out, &primitive.indexByteOffset, sizeof(uint32_t));
-            Write(out, &primitive.vertexByteOffset, sizeof(uint32_t));
-            Write(out, &primitive.boundingBox, sizeof(rtxgi::AABB));
-            Write(out, &numVertices);
-            Write(out, primitive.vertices.data(), sizeof(Graphics::Vertex) * numVertices);
-            Write(out, &numIndices);
-            Write(out, primitive.indices.data(), sizeof(uint32_t) * numIndices);
+        std::vector<AssetRecord> records(view.GetRecords<AssetRecord>(SECTION_ASSETS), view.GetRecords<AssetRecord>(SECTION_ASSETS) + scene.assets.size());
+        for (size_t assetIndex = 0; assetIndex < records.size(); assetIndex++)
+        {
+            records[assetIndex].size = scene.assets[assetIndex].size;
+            records[assetIndex].mtime = scene.assets[assetIndex].mtime;
         }
 
+        std::fstream file(filepath, std::ios::in | std::ios::out | std::ios::binary);
+        if (!file.is_open()) return false;
+
+        file.seekp(static_cast<std::streamoff>(view.sections[SECTION_ASSETS].offset));
+        file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(sizeof(AssetRecord) * records.size()));
+        return file.good();
     }
 
-    void WriteMeshInstance(std::ofstream& out, Scenes::MeshInstance& instance)
-    {
-        uint32_t numChars = static_cast<uint32_t>(strlen(instance.name.c_str())) + 1;
-        Write(out, &numChars);
-        out.write(instance.name.c_str(), numChars);
-        out.seekp(out.tellp());
+    //----------------------------------------------------------------------------------------------------------
+    // Private Serialization Functions
+    //----------------------------------------------------------------------------------------------------------
 
-        Write(out, &instance.meshIndex, sizeof(int));
-        Write(out, &instance.boundingBox, sizeof(rtxgi::AABB));
-        Write(out, &instance.transform, sizeof(float) * 12);
+    /**
+     * Offset of the BLOBS section, which follows the header and section table.
+     */
+    const uint64_t c_blobsOffset = ALIGN(SCENE_CACHE_ALIGNMENT, sizeof(CacheHeader) + (sizeof(CacheSection) * SECTION_COUNT));
+
+    void WritePadding(std::ofstream& out, uint64_t size)
+    {
+        static const char zeros[SCENE_CACHE_ALIGNMENT] = {};
+        while (size > 0)
+        {
+            uint64_t bytes = std::min(size, static_cast<uint64_t>(SCENE_CACHE_ALIGNMENT));
+            out.write(zeros, static_cast<std::streamsize>(bytes));
+            size -= bytes;
+        }
     }
 
-    void WriteLight(std::ofstream& out, Scenes::Light& light)
+    /**
+     * Append a blob to the stream's BLOBS section. Returns the blob's offset in the section.
+     */
+    uint64_t WriteBlob(Stream& stream, const void* data, uint64_t size)
     {
-        uint32_t numChars = static_cast<uint32_t>(strlen(light.name.c_str())) + 1;
-        Write(out, &numChars);
-        out.write(light.name.c_str(), numChars);
-        out.seekp(out.tellp());
+        uint64_t offset = stream.blobBytes;
+        if (size > 0) stream.out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        WritePadding(stream.out, ALIGN(SCENE_CACHE_ALIGNMENT, size) - size);
 
-        Write(out, &light.data, light.GetGPUDataSize());
+        stream.blobBytes += ALIGN(SCENE_CACHE_ALIGNMENT, size);
+        stream.numBlobs++;
+        return offset;
     }
 
-    void WriteCamera(std::ofstream& out, Scenes::Camera& camera)
+    /**
+     * Collects the sections of a scene cache file before they are written. Blobs are written to the stream immediately.
+     */
+    struct CacheWriter
     {
-        uint32_t numChars = static_cast<uint32_t>(strlen(camera.name.c_str())) + 1;
-        Write(out, &numChars);
-        out.write(camera.name.c_str(), numChars);
-        out.seekp(out.tellp());
+        Stream& stream;
 
-        Write(out, &camera.data, camera.GetGPUDataSize());
+        std::vector<uint8_t> sections[SECTION_COUNT];
+        uint64_t counts[SECTION_COUNT] = {};
+
+        explicit CacheWriter(Stream& stream) : stream(stream) {}
+
+        template<typename T>
+        void Add(uint32_t section, const T* records, size_t count = 1)
+        {
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(records);
+            sections[section].insert(sections[section].end(), bytes, bytes + (sizeof(T) * count));
+            counts[section] += count;
+        }
+
+        StringRef AddString(const std::string& value)
+        {
+            StringRef ref = { static_cast<uint32_t>(sections[SECTION_STRINGS].size()), static_cast<uint32_t>(value.size()) };
+            sections[SECTION_STRINGS].insert(sections[SECTION_STRINGS].end(), value.begin(), value.end());
+            return ref;
+        }
+
+        uint64_t AddBlob(const void* data, uint64_t size) { return WriteBlob(stream, data, size); }
+    };
+
+    void WriteSceneNode(CacheWriter& writer, const Scenes::SceneNode& node)
+    {
+        NodeRecord record = {};
+        record.instance = node.instance;
+        record.camera = node.camera;
+        record.translation = node.translation;
+        record.rotation = node.rotation;
+        record.scale = node.scale;
+        record.firstChild = static_cast<uint32_t>(writer.counts[SECTION_NODE_CHILDREN]);
+        record.numChildren = static_cast<uint32_t>(node.children.size());
+
+        writer.Add(SECTION_NODE_CHILDREN, node.children.data(), node.children.size());
+        writer.Add(SECTION_NODES, &record);
     }
 
-    void WriteSceneNode(std::ofstream& out, Scenes::SceneNode& node)
+    void WriteMesh(CacheWriter& writer, const Scenes::Mesh& mesh)
     {
-        Write(out, &node.instance, sizeof(int));
-        Write(out, &node.camera, sizeof(int));
-        Write(out, &node.translation, sizeof(XMFLOAT3));
-        Write(out, &node.rotation, sizeof(XMFLOAT4));
-        Write(out, &node.scale, sizeof(XMFLOAT3));
+        MeshRecord record = {};
+        record.name = writer.AddString(mesh.name);
+        record.hash = mesh.hash;
+        record.index = mesh.index;
+        record.numIndices = mesh.numIndices;
+        record.numVertices = mesh.numVertices;
+        record.boundingBox = mesh.boundingBox;
+        record.firstPrimitive = static_cast<uint32_t>(writer.counts[SECTION_PRIMITIVES]);
+        record.numPrimitives = static_cast<uint32_t>(mesh.primitives.size());
+        writer.Add(SECTION_MESHES, &record);
+
+        for (uint32_t primitiveIndex = 0; primitiveIndex < record.numPrimitives; primitiveIndex++)
+        {
+            const Scenes::MeshPrimitive& primitive = mesh.primitives[primitiveIndex];
+
+            PrimitiveRecord pr = {};
+            pr.index = primitive.index;
+            pr.material = primitive.material;
+            pr.opaque = primitive.opaque ? 1 : 0;
+            pr.doubleSided = primitive.doubleSided ? 1 : 0;
+            pr.vertexFormat = primitive.vertexFormat;
+            pr.indexByteOffset = primitive.indexByteOffset;
+            pr.vertexByteOffset = primitive.vertexByteOffset;
+            pr.boundingBox = primitive.boundingBox;
+
+            uint32_t index = static_cast<uint32_t>(primitive.index);
+            if (primitive.index >= 0 && index < static_cast<uint32_t>(writer.stream.primitives.size()) && writer.stream.primitives[index].written)
+            {
+                // The primitive's data was streamed to the file during import
+                const StreamedPrimitive& streamed = writer.stream.primitives[index];
+                pr.numVertices = streamed.numVertices;
+                pr.numIndices = streamed.numIndices;
+                pr.vertexOffset = streamed.vertexOffset;
+                pr.indexOffset = streamed.indexOffset;
+            }
+            else
+            {
+                pr.numVertices = primitive.GetNumVertices();
+                pr.numIndices = primitive.GetNumIndices();
+                pr.vertexOffset = writer.AddBlob(primitive.GetVertexData(), primitive.GetVertexStride() * static_cast<uint64_t>(pr.numVertices));
+                pr.indexOffset = writer.AddBlob(primitive.GetIndices(), sizeof(uint32_t) * static_cast<uint64_t>(pr.numIndices));
+            }
+            writer.Add(SECTION_PRIMITIVES, &pr);
+        }
+    }
 
-        // Write children node indices
-        uint32_t numChildren = static_cast<uint32_t>(node.children.size());
-        Write(out, &numChildren);
-        Write(out, node.children.data(), (sizeof(int) * numChildren));
+    void WriteTexture(CacheWriter& writer, const Textures::Texture& texture)
+    {
+        TextureRecord record = {};
+        record.name = writer.AddString(texture.name);
+        record.filepath = writer.AddString(texture.filepath);
+        record.type = static_cast<uint32_t>(texture.type);
+        record.format = static_cast<uint32_t>(texture.format);
+        record.width = texture.width;
+        record.height = texture.height;
+        record.stride = texture.stride;
+        record.mips = texture.mips;
+        record.texelBytes = texture.texelBytes;
+        record.texelOffset = writer.AddBlob(texture.texels, texture.texelBytes);
+        writer.Add(SECTION_TEXTURES, &record);
     }
 
     //----------------------------------------------------------------------------------------------------------
@@ -332,241 +736,423 @@ namespace Caches
     //----------------------------------------------------------------------------------------------------------
 
     /**
-     * Write the scene cache file to disk.
+     * Hash a block of memory (64-bit, non-cryptographic).
      */
-    bool Serialize(const std::string& filepath, Scenes::Scene& scene, std::ofstream& log)
+    uint64_t Hash(const void* data, size_t size, uint64_t seed)
     {
-        std::ofstream out;
-        out.open(filepath, std::ios::out | std::ios::binary);
-        if (out.is_open())
+        const uint64_t prime0 = 0x9E3779B185EBCA87ull;
+        const uint64_t prime1 = 0xC2B2AE3D27D4EB4Full;
+
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        uint64_t hash = seed ^ (static_cast<uint64_t>(size) * prime0);
+
+        // Mix in 8 bytes at a time
+        size_t offset = 0;
+        for (; (offset + 8) <= size; offset += 8)
         {
-            log << "\n\tWriting scene cache file \'" + filepath + "\'...";
+            uint64_t word;
+            memcpy(&word, bytes + offset, sizeof(uint64_t));
+            word *= prime1;
+            word = (word << 31) | (word >> 33);
+            hash = (hash ^ (word * prime0));
+            hash = ((hash << 27) | (hash >> 37)) * prime0 + prime1;
+        }
 
-            out.seekp(0, std::ios::beg);
+        // Mix in the remaining bytes
+        for (; offset < size; offset++)
+        {
+            hash = (hash ^ (bytes[offset] * prime0));
+            hash = ((hash << 11) | (hash >> 53)) * prime1;
+        }
 
-            // Header
-            uint32_t cacheVersion = SCENE_CACHE_VERSION;
-            Write(out, &cacheVersion);
+        // Finalize (avalanche the bits)
+        hash ^= hash >> 33;
+        hash *= 0xFF51AFD7ED558CCDull;
+        hash ^= hash >> 33;
+        hash *= 0xC4CEB9FE1A85EC53ull;
+        hash ^= hash >> 33;
+        return hash;
+    }
 
-            uint32_t coordinateSystem = COORDINATE_SYSTEM;
-            Write(out, &coordinateSystem);
+    /**
+     * Update an asset's size, modification time, and content hash from its file in the given directory.
+     * When the file's size and modification time match the previous version of the asset, its hash is reused
+     * instead of reading the file.
+     */
+    bool UpdateAsset(const std::string& directory, Scenes::Asset& asset, const Scenes::Asset* previous)
+    {
+        std::error_code error;
+        std::filesystem::path path(directory + asset.filepath);
 
-            Write(out, &scene.activeCamera);
-            Write(out, &scene.numMeshPrimitives);
-            Write(out, &scene.numTriangles);
-            Write(out, &scene.hasDirectionalLight);
-            Write(out, &scene.numPointLights);
-            Write(out, &scene.numSpotLights);
+        uint64_t size = static_cast<uint64_t>(std::filesystem::file_size(path, error));
+        if (error) return false;
 
-            Write(out, &scene.boundingBox, sizeof(rtxgi::AABB));
+        std::filesystem::file_time_type time = std::filesystem::last_write_time(path, error);
+        if (error) return false;
 
-            // Root Nodes
-            uint32_t numElements = static_cast<uint32_t>(scene.rootNodes.size());
-            Write(out, &numElements);
-            if (numElements > 0)
-            {
-                Write(out, scene.rootNodes.data(), sizeof(int) * numElements);
-            }
+        asset.size = size;
+        asset.mtime = static_cast<int64_t>(time.time_since_epoch().count());
 
-            // Scene Nodes
-            numElements = static_cast<uint32_t>(scene.nodes.size());
-            Write(out, &numElements);
-            for (uint32_t nodeIndex = 0; nodeIndex < numElements; nodeIndex++)
-            {
-                WriteSceneNode(out, scene.nodes[nodeIndex]);
-            }
+        if (previous && previous->size == asset.size && previous->mtime == asset.mtime)
+        {
+            asset.hash = previous->hash;
+            return true;
+        }
 
-            // Cameras
-            numElements = static_cast<uint32_t>(scene.cameras.size());
-            Write(out, &numElements);
-            for (uint32_t cameraIndex = 0; cameraIndex < numElements; cameraIndex++)
-            {
-                WriteCamera(out, scene.cameras[cameraIndex]);
-            }
+        // Hash the file contents
+        std::ifstream in(path, std::ios::in | std::ios::binary);
+        if (!in.is_open()) return false;
 
-            // Lights
-            numElements = static_cast<uint32_t>(scene.lights.size());
-            Write(out, &numElements);
-            for (uint32_t lightIndex = 0; lightIndex < numElements; lightIndex++)
-            {
-                WriteLight(out, scene.lights[lightIndex]);
-            }
+        const size_t chunkSize = 1 << 20;
+        std::vector<char> chunk(chunkSize);
+
+        asset.hash = 0;
+        while (in)
+        {
+            in.read(chunk.data(), chunkSize);
+            size_t bytes = static_cast<size_t>(in.gcount());
+            if (bytes == 0) break;
+            asset.hash = Hash(chunk.data(), bytes, asset.hash);
+        }
+        return !in.bad();
+    }
 
-            // MeshInstances
-            numElements = static_cast<uint32_t>(scene.instances.size());
-            Write(out, &numElements);
-            for (uint32_t instanceIndex = 0; instanceIndex < numElements; instanceIndex++)
+    /**
+     * Check if a scene deserialized from the given cache file is current: its assets are unchanged and it was imported
+     * with the given settings. Assets whose files have a new size or modification time but unchanged contents are updated
+     * in the scene and its cache file, so the files aren't hashed again on the next load.
+     */
+    bool IsCurrent(Scenes::Scene& scene, const std::string& filepath, const std::string& directory, uint64_t configHash, std::ofstream& log)
+    {
+        if (scene.assets.empty()) return false;
+
+        bool refreshed = false;
+        for (Scenes::Asset& asset : scene.assets)
+        {
+            if (asset.type == Scenes::EAssetType::CONFIG)
             {
-                WriteMeshInstance(out, scene.instances[instanceIndex]);
+                if (asset.hash == configHash) continue;
+                log << "\n\tScene import settings changed";
+                return false;
             }
 
-            // Meshes
-            numElements = static_cast<uint32_t>(scene.meshes.size());
-            Write(out, &numElements);
-            for (uint32_t meshIndex = 0; meshIndex < numElements; meshIndex++)
+            Scenes::Asset current = asset;
+            if (!UpdateAsset(directory, current, &asset))
             {
-                WriteMesh(out, scene.meshes[meshIndex]);
+                log << "\n\tScene file \'" << asset.filepath << "\' is missing";
+                return false;
             }
 
-            // Materials
-            numElements = static_cast<uint32_t>(scene.materials.size());
-            Write(out, &numElements, sizeof(uint32_t));
-            for (uint32_t materialIndex = 0; materialIndex < numElements; materialIndex++)
+            if (current.hash != asset.hash)
             {
-                WriteMaterial(out, scene.materials[materialIndex]);
+                log << "\n\tScene file \'" << asset.filepath << "\' changed";
+                return false;
             }
 
-            // Textures
-            numElements = static_cast<uint32_t>(scene.textures.size());
-            Write(out, &numElements, sizeof(uint32_t));
-            for (uint32_t textureIndex = 0; textureIndex < numElements; textureIndex++)
+            if (current.size != asset.size || current.mtime != asset.mtime)
             {
-                WriteTexture(out, scene.textures[textureIndex]);
+                asset.size = current.size;
+                asset.mtime = current.mtime;
+                refreshed = true;
             }
-
-            out.close();
-            return true;
         }
 
-        log << "\nFailed to write cache file \'" + filepath + "\'";
-        return false;
+        if (refreshed && !WriteAssetRecords(filepath, scene))
+        {
+            log << "\n\tWarning: failed to update the scene cache file's asset records";
+        }
+        return true;
     }
 
     /**
-     * Read the scene cache file from disk.
+     * Start writing a scene cache file.
      */
-    bool Deserialize(const std::string& filepath, Scenes::Scene& scene, std::ofstream& log)
+    bool Open(Stream& stream, const std::string& filepath, std::ofstream& log)
     {
-        std::ifstream in;
-        in.open(filepath, std::ios::in | std::ios::binary);
-        if (in.is_open())
+        stream.filepath = filepath;
+        stream.blobBytes = 0;
+        stream.numBlobs = 0;
+        stream.primitives.clear();
+
+        stream.out.open(filepath + ".tmp", std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!stream.out.is_open())
         {
-            in.seekg(0, std::ios::beg);
+            log << "\nFailed to write cache file \'" + filepath + "\'";
+            return false;
+        }
 
-            // Header
-            uint32_t cacheVersion;
-            Read(in, &cacheVersion, sizeof(uint32_t));
-            if(cacheVersion != SCENE_CACHE_VERSION)
-            {
-                log << "\n\tWarning: scene cache version '" << cacheVersion << "' does not match expected version '" << SCENE_CACHE_VERSION << "'";
-                log << "\n\tRebuilding scene cache...";
-                return false;
-            }
+        log << "\n\tWriting scene cache file \'" + filepath + "\'...";
 
-            uint32_t coordinateSystem;
-            Read(in, &coordinateSystem, sizeof(uint32_t));
-            if(coordinateSystem != COORDINATE_SYSTEM)
-            {
-                log << "\n\tWarning: scene cache coordinate system '" << GetCoordinateSystemName(coordinateSystem);
-                log << "' does not match current coordinate system '" << GetCoordinateSystemName(COORDINATE_SYSTEM) << "'";
-                log << "\n\tRebuilding scene cache...";
-                return false;
-            }
+        // Reserve space for the header and section table, written by Finish()
+        WritePadding(stream.out, c_blobsOffset);
+        return stream.out.good();
+    }
 
-            Read(in, &scene.activeCamera);
-            Read(in, &scene.numMeshPrimitives);
-            Read(in, &scene.numTriangles);
-            Read(in, &scene.hasDirectionalLight);
-            Read(in, &scene.numPointLights);
-            Read(in, &scene.numSpotLights);
+    /**
+     * Write a mesh primitive's vertex (in the primitive's vertex format) and index data to the scene cache file.
+     * The data is not retained; Finish() records the primitive's (streamed) data in the cache.
+     */
+    bool WritePrimitive(Stream& stream, const Scenes::MeshPrimitive& primitive, const void* vertices, uint32_t numVertices, const uint32_t* indices, uint32_t numIndices)
+    {
+        if (primitive.index < 0) return false;
+
+        uint32_t index = static_cast<uint32_t>(primitive.index);
+        if (index >= static_cast<uint32_t>(stream.primitives.size())) stream.primitives.resize(index + 1);
+
+        StreamedPrimitive& streamed = stream.primitives[index];
+        streamed.written = true;
+        streamed.numVertices = numVertices;
+        streamed.numIndices = numIndices;
+        streamed.vertexOffset = WriteBlob(stream, vertices, primitive.GetVertexStride() * static_cast<uint64_t>(numVertices));
+        streamed.indexOffset = WriteBlob(stream, indices, sizeof(uint32_t) * static_cast<uint64_t>(numIndices));
+        return stream.out.good();
+    }
 
-            Read(in, &scene.boundingBox, sizeof(rtxgi::AABB));
+    /**
+     * Write the rest of the scene to the scene cache file and replace the existing cache file with it.
+     * Mesh primitives that were not streamed with WritePrimitive() are written from their vertex and index arrays.
+     */
+    bool Finish(Stream& stream, const Scenes::Scene& scene, std::ofstream& log)
+    {
+        CacheWriter writer(stream);
+
+        // Scene
+        SceneRecord sceneRecord = {};
+        sceneRecord.activeCamera = scene.activeCamera;
+        sceneRecord.numMeshPrimitives = scene.numMeshPrimitives;
+        sceneRecord.numTriangles = scene.numTriangles;
+        sceneRecord.hasDirectionalLight = scene.hasDirectionalLight;
+        sceneRecord.numPointLights = scene.numPointLights;
+        sceneRecord.numSpotLights = scene.numSpotLights;
+        sceneRecord.boundingBox = scene.boundingBox;
+        writer.Add(SECTION_SCENE, &sceneRecord);
+
+        // Root Nodes and Scene Nodes
+        writer.Add(SECTION_ROOT_NODES, scene.rootNodes.data(), scene.rootNodes.size());
+        for (const Scenes::SceneNode& node : scene.nodes) WriteSceneNode(writer, node);
+
+        // Cameras
+        for (const Scenes::Camera& camera : scene.cameras)
+        {
+            CameraRecord record = { writer.AddString(camera.name), camera.data };
+            writer.Add(SECTION_CAMERAS, &record);
+        }
 
-            uint32_t numElements = 0;
+        // Lights
+        for (const Scenes::Light& light : scene.lights)
+        {
+            LightRecord record = { writer.AddString(light.name), light.data };
+            writer.Add(SECTION_LIGHTS, &record);
+        }
 
-            // Root Nodes
-            Read(in, &numElements);
-            if (numElements > 0)
-            {
-                scene.rootNodes.resize(numElements);
-                Read(in, reinterpret_cast<char*>(scene.rootNodes.data()), sizeof(int) * numElements);
-            }
+        // MeshInstances
+        for (const Scenes::MeshInstance& instance : scene.instances)
+        {
+            InstanceRecord record = {};
+            record.name = writer.AddString(instance.name);
+            record.meshIndex = instance.meshIndex;
+            record.boundingBox = instance.boundingBox;
+            memcpy(record.transform, instance.transform, sizeof(float) * 12);
+            writer.Add(SECTION_INSTANCES, &record);
+        }
 
-            // Scene Nodes
-            Read(in, &numElements);
-            if (numElements > 0)
-            {
-                scene.nodes.resize(numElements);
-                for (uint32_t nodeIndex = 0; nodeIndex < numElements; nodeIndex++)
-                {
-                    ReadSceneNode(in, scene.nodes[nodeIndex]);
-                }
-            }
+        // Meshes and MeshPrimitives
+        for (const Scenes::Mesh& mesh : scene.meshes) WriteMesh(writer, mesh);
 
-            // Cameras
-            Read(in, &numElements);
-            if (numElements > 0)
-            {
-                scene.cameras.resize(numElements);
-                for (uint32_t cameraIndex = 0; cameraIndex < numElements; cameraIndex++)
-                {
-                    ReadCamera(in, scene.cameras[cameraIndex]);
-                }
-            }
+        // Materials
+        for (const Scenes::Material& material : scene.materials)
+        {
+            MaterialRecord record = { writer.AddString(material.name), material.data };
+            writer.Add(SECTION_MATERIALS, &record);
+        }
 
-            // Lights
-            Read(in, &numElements);
-            if (numElements > 0)
-            {
-                scene.lights.resize(numElements);
-                for (uint32_t lightIndex = 0; lightIndex < numElements; lightIndex++)
-                {
-                    ReadLight(in, scene.lights[lightIndex]);
-                }
-            }
+        // Textures
+        for (const Textures::Texture& texture : scene.textures) WriteTexture(writer, texture);
 
-            // MeshInstances
-            Read(in, &numElements);
-            if (numElements > 0)
-            {
-                scene.instances.resize(numElements);
-                for (uint32_t instanceIndex = 0; instanceIndex < numElements; instanceIndex++)
-                {
-                    ReadMeshInstance(in, scene.instances[instanceIndex]);
-                }
-            }
+        // Assets
+        for (const Scenes::Asset& asset : scene.assets)
+        {
+            AssetRecord record = {};
+            record.type = static_cast<uint32_t>(asset.type);
+            record.index = asset.index;
+            record.filepath = writer.AddString(asset.filepath);
+            record.size = asset.size;
+            record.mtime = asset.mtime;
+            record.hash = asset.hash;
+            writer.Add(SECTION_ASSETS, &record);
+        }
 
-            // Meshes
-            Read(in, &numElements);
-            if (numElements > 0)
-            {
-                scene.meshes.resize(numElements);
-                for (uint32_t meshIndex = 0; meshIndex < numElements; meshIndex++)
-                {
-                    ReadMesh(in, scene.meshes[meshIndex]);
-                }
-            }
+        // Lay out the sections (after the blobs, which are all written now)
+        CacheSection sections[SECTION_COUNT] = {};
+        sections[SECTION_BLOBS] = { c_blobsOffset, stream.blobBytes, stream.numBlobs };
 
-            // Materials
-            Read(in, &numElements);
-            if (numElements > 0)
-            {
-                scene.materials.resize(numElements);
-                for (uint32_t materialIndex = 0; materialIndex < numElements; materialIndex++)
-                {
-                    ReadMaterial(in, scene.materials[materialIndex]);
-                }
-            }
+        uint64_t offset = c_blobsOffset + stream.blobBytes;
+        for (uint32_t sectionIndex = 0; sectionIndex < SECTION_COUNT; sectionIndex++)
+        {
+            if (sectionIndex == SECTION_BLOBS) continue;
+            sections[sectionIndex].offset = offset;
+            sections[sectionIndex].size = writer.sections[sectionIndex].size();
+            sections[sectionIndex].count = writer.counts[sectionIndex];
+            offset = ALIGN(SCENE_CACHE_ALIGNMENT, offset + sections[sectionIndex].size);
+        }
 
-            // Textures
-            Read(in, &numElements);
-            if (numElements > 0)
-            {
-                scene.textures.resize(numElements);
-                for (uint32_t textureIndex = 0; textureIndex < numElements; textureIndex++)
-                {
-                    ReadTexture(in, scene.textures[textureIndex]);
-                }
-            }
+        CacheHeader header = {};
+        header.version = SCENE_CACHE_VERSION;
+        header.coordinateSystem = COORDINATE_SYSTEM;
+        header.numSections = SECTION_COUNT;
+        header.alignment = SCENE_CACHE_ALIGNMENT;
+        header.fileSize = offset;
 
-            in.close();
-            return true;
+        // Sections
+        uint64_t written = c_blobsOffset + stream.blobBytes;
+        for (uint32_t sectionIndex = 0; sectionIndex < SECTION_COUNT; sectionIndex++)
+        {
+            if (sectionIndex == SECTION_BLOBS) continue;
+            WritePadding(stream.out, sections[sectionIndex].offset - written);
+            stream.out.write(reinterpret_cast<const char*>(writer.sections[sectionIndex].data()), static_cast<std::streamsize>(sections[sectionIndex].size));
+            written = sections[sectionIndex].offset + sections[sectionIndex].size;
         }
-        else
+        WritePadding(stream.out, header.fileSize - written);
+
+        // Header and section table
+        stream.out.seekp(0);
+        stream.out.write(reinterpret_cast<const char*>(&header), sizeof(CacheHeader));
+        stream.out.write(reinterpret_cast<const char*>(sections), sizeof(sections));
+
+        bool result = stream.out.good();
+        stream.out.close();
+        result &= !stream.out.fail();
+
+        // Replace the existing cache file
+        if (result)
         {
-            log << "\n\tWarning: no scene cache file exists!";
+            std::error_code error;
+            std::filesystem::rename(stream.filepath + ".tmp", stream.filepath, error);
+            if (!error) return true;
         }
+
+        Discard(stream);
+        log << "\nFailed to write cache file \'" + stream.filepath + "\'";
         return false;
     }
 
+    /**
+     * Stop writing a scene cache file and delete the partially written file. The existing cache file is unchanged.
+     */
+    void Discard(Stream& stream)
+    {
+        if (stream.out.is_open()) stream.out.close();
+        if (stream.filepath.empty()) return;
+
+        std::error_code error;
+        std::filesystem::remove(stream.filepath + ".tmp", error);
+        stream.primitives.clear();
+    }
+
+    /**
+     * Write the scene cache file to disk.
+     */
+    bool Serialize(const std::string& filepath, Scenes::Scene& scene, std::ofstream& log)
+    {
+        Stream stream;
+        if (!Open(stream, filepath, log)) return false;
+        return Finish(stream, scene, log);
+    }
+
+    /**
+     * Read the scene cache file from disk.
+     * The file is memory-mapped and remains mapped until Unmap() is called (by Scenes::Cleanup()):
+     * mesh primitive vertex / index data and texture texels point directly into the mapping.
+     */
+    bool Deserialize(const std::string& filepath, Scenes::Scene& scene, std::ofstream& log)
+    {
+        uint8_t* data = nullptr;
+        uint64_t size = 0;
+        if (!MapFile(filepath, &data, size))
+        {
+            log << "\n\tWarning: no scene cache file exists!";
+            return false;
+        }
+
+        // Header
+        CacheHeader header = {};
+        memcpy(&header, data, std::min(size, static_cast<uint64_t>(sizeof(CacheHeader))));
+
+        if (header.version != SCENE_CACHE_VERSION)
+        {
+            log << "\n\tWarning: scene cache version '" << header.version << "' does not match expected version '" << SCENE_CACHE_VERSION << "'";
+            log << "\n\tRebuilding scene cache...";
+            UnmapFile(data, size);
+            return false;
+        }
+
+        if (header.coordinateSystem != COORDINATE_SYSTEM)
+        {
+            log << "\n\tWarning: scene cache coordinate system '" << GetCoordinateSystemName(header.coordinateSystem);
+            log << "' does not match current coordinate system '" << GetCoordinateSystemName(COORDINATE_SYSTEM) << "'";
+            log << "\n\tRebuilding scene cache...";
+            UnmapFile(data, size);
+            return false;
+        }
+
+        CacheView view = { data, reinterpret_cast<const CacheSection*>(data + sizeof(CacheHeader)) };
+        bool valid = (header.numSections == SECTION_COUNT)
+            && (header.alignment == SCENE_CACHE_ALIGNMENT)
+            && (header.fileSize == size)
+            && (size >= sizeof(CacheHeader) + (sizeof(CacheSection) * SECTION_COUNT))
+            && ValidateSections(view, size);
+
+        if (valid)
+        {
+            const SceneRecord& record = view.GetRecords<SceneRecord>(SECTION_SCENE)[0];
+            scene.activeCamera = record.activeCamera;
+            scene.numMeshPrimitives = record.numMeshPrimitives;
+            scene.numTriangles = record.numTriangles;
+            scene.hasDirectionalLight = record.hasDirectionalLight;
+            scene.numPointLights = record.numPointLights;
+            scene.numSpotLights = record.numSpotLights;
+            scene.boundingBox = record.boundingBox;
+
+            valid = ReadSceneNodes(view, scene)
+                && ReadCamerasAndLights(view, scene)
+                && ReadMeshes(view, scene)
+                && ReadMaterialsAndTextures(view, scene)
+                && ReadAssets(view, scene);
+        }
+
+        if (!valid)
+        {
+            log << "\n\tWarning: scene cache file is corrupt";
+            log << "\n\tRebuilding scene cache...";
+
+            // Drop the (partially) read scene data, it may point into the mapping
+            scene.rootNodes.clear();
+            scene.nodes.clear();
+            scene.cameras.clear();
+            scene.lights.clear();
+            scene.instances.clear();
+            scene.meshes.clear();
+            scene.materials.clear();
+            scene.textures.clear();
+            scene.assets.clear();
+            UnmapFile(data, size);
+            return false;
+        }
+
+        scene.cache = data;
+        scene.cacheSize = size;
+        return true;
+    }
+
+    /**
+     * Release the scene's cache file mapping.
+     * Mesh primitive and texture data that points into the mapping is no longer valid.
+     */
+    void Unmap(Scenes::Scene& scene)
+    {
+        UnmapFile(scene.cache, scene.cacheSize);
+        scene.cache = nullptr;
+        scene.cacheSize = 0;
+    }
+
 }
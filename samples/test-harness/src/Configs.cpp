@@ -12,6 +12,7 @@
 
 #include <rtxgi/ddgi/DDGIVolume.h>
 
+#include <algorithm>
 #include <sstream>
 #include <stdlib.h>
 #include <filesystem>
@@ -211,6 +212,10 @@ namespace Configs
         std::string data;
         PARSE_CHECK(Extract(rhs, data), lineNumber, log);
 
+        if (tokens[1].compare("rayBudget") == 0) { Store(data, config.ddgi.rayBudget); return true; }
+        if (tokens[1].compare("snapshotPath") == 0) { config.ddgi.snapshotPath = data; return true; }
+        if (tokens[1].compare("snapshotCompression") == 0) { Store(data, config.ddgi.snapshotCompression); return true; }
+
         if (tokens[1].compare("volume") == 0)
         {
             int volumeIndex = stoi(tokens[2]);
@@ -279,6 +284,15 @@ namespace Configs
                 }
             }
 
+            if (tokens[3].compare("update") == 0)
+            {
+                if (tokens.size() == 5 && tokens[4].compare("enabled") == 0)
+                {
+                    Store(data, config.ddgi.volumes[volumeIndex].updateEnabled);
+                    return true;
+                }
+            }
+
             if (tokens[3].compare("textures") == 0)
             {
                 if (tokens[4].compare("rayData") == 0 && tokens[5].compare("format") == 0)
@@ -422,6 +436,74 @@ namespace Configs
         return false;
     }
 
+    /*
+    * Parse a benchmark scenario configuration entry.
+    */
+    bool ParseConfigBenchmarkEntry(const std::vector<std::string>& tokens, const std::string& rhs, Config& config, uint32_t lineNumber, std::ofstream& log)
+    {
+        // Benchmark entries have no more than 4 tokens
+        PARSE_CHECK((tokens.size() <= 4), lineNumber, log);
+
+        // Extract the data from the rhs, stripping out unnecessary characters
+        std::string data;
+        PARSE_CHECK(Extract(rhs, data), lineNumber, log);
+
+        if (tokens.size() == 2)
+        {
+            if (tokens[1].compare("warmupFrames") == 0) { Store(data, config.benchmark.warmupFrames); return true; }
+            if (tokens[1].compare("frames") == 0) { Store(data, config.benchmark.frames); return true; }
+            if (tokens[1].compare("frameTime") == 0) { Store(data, config.benchmark.frameTime); return true; }
+            if (tokens[1].compare("camera") == 0) { Store(data, config.benchmark.camera); return true; }
+            if (tokens[1].compare("scrollWithCamera") == 0) { Store(data, config.benchmark.scrollWithCamera); return true; }
+        }
+
+        if (tokens.size() == 4)
+        {
+            uint32_t index = static_cast<uint32_t>(stoi(tokens[2]));
+
+            // Camera path keyframes
+            if (tokens[1].compare("cameraPath") == 0)
+            {
+                if (index >= config.benchmark.cameraPath.size()) config.benchmark.cameraPath.resize(index + 1);
+
+                BenchmarkCameraKeyframe& keyframe = config.benchmark.cameraPath[index];
+                if (tokens[3].compare("time") == 0) { Store(data, keyframe.time); return true; }
+                if (tokens[3].compare("position") == 0) { StoreWorldVector(data, keyframe.position); return true; }
+                if (tokens[3].compare("yaw") == 0) { Store(data, keyframe.yaw); return true; }
+                if (tokens[3].compare("pitch") == 0) { Store(data, keyframe.pitch); return true; }
+            }
+
+            // Light changes
+            if (tokens[1].compare("lights") == 0)
+            {
+                if (index >= config.benchmark.lightEvents.size()) config.benchmark.lightEvents.resize(index + 1);
+
+                BenchmarkLightEvent& event = config.benchmark.lightEvents[index];
+                if (tokens[3].compare("time") == 0) { Store(data, event.time); return true; }
+                if (tokens[3].compare("name") == 0) { event.light = data; return true; }
+                if (tokens[3].compare("position") == 0) { StoreWorldVector(data, event.position); event.setPosition = true; return true; }
+                if (tokens[3].compare("direction") == 0) { StoreWorldVector(data, event.direction); event.setDirection = true; return true; }
+                if (tokens[3].compare("color") == 0) { Store(data, event.color); event.setColor = true; return true; }
+                if (tokens[3].compare("power") == 0) { Store(data, event.power); event.setPower = true; return true; }
+            }
+
+            // Volume update toggles
+            if (tokens[1].compare("volumes") == 0)
+            {
+                if (index >= config.benchmark.volumeEvents.size()) config.benchmark.volumeEvents.resize(index + 1);
+
+                BenchmarkVolumeEvent& event = config.benchmark.volumeEvents[index];
+                if (tokens[3].compare("time") == 0) { Store(data, event.time); return true; }
+                if (tokens[3].compare("volume") == 0) { Store(data, event.volume); return true; }
+                if (tokens[3].compare("updateEnabled") == 0) { Store(data, event.updateEnabled); return true; }
+            }
+        }
+
+        log << "\nUnsupported configuration value specified!";
+        PARSE_CHECK(0, lineNumber, log);
+        return false;
+    }
+
     /*
     * Parse an input configuration entry.
     */
@@ -464,6 +546,10 @@ namespace Configs
             if (tokens[1].compare("screenshotPath") == 0) { config.scene.screenshotPath = data; return true; }
             if (tokens[1].compare("skyColor") == 0) { Store(data, config.scene.skyColor); return true; }
             if (tokens[1].compare("skyIntensity") == 0) { Store(data, config.scene.skyIntensity); return true; }
+            if (tokens[1].compare("optimizeMeshes") == 0) { Store(data, config.scene.optimizeMeshes); return true; }
+            if (tokens[1].compare("packVertices") == 0) { Store(data, config.scene.packVertices); return true; }
+            if (tokens[1].compare("tlasRebuildMotion") == 0) { Store(data, config.scene.tlasRebuildMotion); return true; }
+            if (tokens[1].compare("tlasRebuildInterval") == 0) { Store(data, config.scene.tlasRebuildInterval); return true; }
         }
 
         // Lights
@@ -606,8 +692,29 @@ namespace Configs
             if (tokens[0].compare("ddgi") == 0) { CHECK(ParseConfigDDGIEntry(tokens, expression[1], config, lineNumber, log), "parse config ddgi entry!", log); continue; };
             if (tokens[0].compare("rtao") == 0) { CHECK(ParseConfigRTAOEntry(tokens, expression[1], config, lineNumber, log), "parse config rtao entry!", log); continue; };
             if (tokens[0].compare("pp") == 0) { CHECK(ParseConfigPostProcessEntry(tokens, expression[1], config, lineNumber, log), "parse config post process entry!", log); continue; };
+            if (tokens[0].compare("benchmark") == 0) { CHECK(ParseConfigBenchmarkEntry(tokens, expression[1], config, lineNumber, log), "parse config benchmark entry!", log); continue; };
+        }
+
+        // Check the benchmark scenario
+        if (config.benchmark.frames == 0 || config.benchmark.frameTime <= 0.f)
+        {
+            log << "\nError: benchmark.frames and benchmark.frameTime must be greater than zero!";
+            return false;
+        }
+        for (const BenchmarkVolumeEvent& event : config.benchmark.volumeEvents)
+        {
+            if (event.volume >= static_cast<uint32_t>(config.ddgi.volumes.size()))
+            {
+                log << "\nError: a benchmark volume event references DDGIVolume " << event.volume << ", which doesn't exist!";
+                return false;
+            }
         }
 
+        // Order the keyframes and events by time (stable, so simultaneous events apply in file order)
+        std::stable_sort(config.benchmark.cameraPath.begin(), config.benchmark.cameraPath.end(), [](const BenchmarkCameraKeyframe& a, const BenchmarkCameraKeyframe& b) { return a.time < b.time; });
+        std::stable_sort(config.benchmark.lightEvents.begin(), config.benchmark.lightEvents.end(), [](const BenchmarkLightEvent& a, const BenchmarkLightEvent& b) { return a.time < b.time; });
+        std::stable_sort(config.benchmark.volumeEvents.begin(), config.benchmark.volumeEvents.end(), [](const BenchmarkVolumeEvent& a, const BenchmarkVolumeEvent& b) { return a.time < b.time; });
+
         // Check the probe ray counts for each volume
         for (uint32_t volumeIndex = 0; volumeIndex < static_cast<uint32_t>(config.ddgi.volumes.size()); volumeIndex++)
         {
@@ -629,22 +736,57 @@ namespace Configs
      */
     bool ParseCommandLine(const std::vector<std::string>& arguments, Config& config, std::ofstream& log)
     {
-        if (arguments.size() == 0)
+        // Usage: <config file> [--headless] [--no-gpu] [--benchmark] [--frames <count>]
+        for (size_t argumentIndex = 0; argumentIndex < arguments.size(); argumentIndex++)
+        {
+            const std::string& argument = arguments[argumentIndex];
+            if (argument.compare("--headless") == 0) config.app.headless = true;
+            else if (argument.compare("--no-gpu") == 0) config.app.noGPU = config.app.headless = true;
+            else if (argument.compare("--benchmark") == 0) config.app.runBenchmark = true;
+            else if (argument.compare("--frames") == 0)
+            {
+                std::string count = (argumentIndex + 1 < arguments.size()) ? arguments[argumentIndex + 1] : "";
+                if (count.empty() || count.size() > 9 || count.find_first_not_of("0123456789") != std::string::npos)
+                {
+                    log << "\nError: --frames must be followed by the number of frames to render!\n";
+                    return false;
+                }
+                Store(arguments[++argumentIndex], config.app.numFrames);
+            }
+            else if (argument.compare(0, 2, "--") == 0)
+            {
+                log << "\nError: unknown command line option '" << argument << "'!\n";
+                return false;
+            }
+            else if (config.app.filepath.empty()) config.app.filepath = argument;
+            else
+            {
+                // Early out, there must be a single configuration file
+                log << "\nError: incorrect command line usage! A single configuration file must be specified.\n";
+                return false;
+            }
+        }
+
+        if (config.app.filepath.empty())
         {
             // Early out, a configuration file is not specified
             log << "\nError: a configuration file must be specified!\n";
             return false;
         }
 
-        if (arguments.size() > 1)
+        // Headless runs have to end on their own
+        if (config.app.headless && config.app.numFrames == 0 && !config.app.runBenchmark)
         {
-            // Early out, there must be a single argument after the executable path
-            log << "\nError: incorrect command line usage! A single argument - the path to the configuration file - must be specified.\n";
+            log << "\nError: headless runs must specify --frames <count> or --benchmark!\n";
             return false;
         }
 
-        // Set the config file path
-        config.app.filepath = arguments[0];
+        // The benchmark measures GPU work
+        if (config.app.noGPU && config.app.runBenchmark)
+        {
+            log << "\nError: --benchmark can't be used with --no-gpu!\n";
+            return false;
+        }
 
         return true;
     }
@@ -260,6 +260,9 @@ namespace Graphics
          */
         bool CreateSwapChain(Globals& d3d)
         {
+            // Headless back buffers are created without a swap chain (see CreateBackBuffer)
+            if (d3d.headless) return true;
+
             // Describe the swap chain
             DXGI_SWAP_CHAIN_DESC1 desc = {};
             desc.BufferCount = MAX_FRAMES_IN_FLIGHT;
@@ -300,7 +303,16 @@ namespace Graphics
             D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle = resources.rtvDescHeapStart;
             for (UINT bufferIndex = 0; bufferIndex < MAX_FRAMES_IN_FLIGHT; bufferIndex++)
             {
-                D3DCHECK(d3d.swapChain->GetBuffer(bufferIndex, IID_PPV_ARGS(&d3d.backBuffer[bufferIndex])));
+                if (d3d.headless)
+                {
+                    // Offscreen back buffers are created in the common state (the same as present)
+                    TextureDesc desc = { static_cast<UINT>(d3d.width), static_cast<UINT>(d3d.height), 1, 1, DXGI_FORMAT_R8G8B8A8_UNORM, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET };
+                    if (!CreateTexture(d3d, desc, &d3d.backBuffer[bufferIndex])) return false;
+                }
+                else
+                {
+                    D3DCHECK(d3d.swapChain->GetBuffer(bufferIndex, IID_PPV_ARGS(&d3d.backBuffer[bufferIndex])));
+                }
             #ifdef GFX_NAME_OBJECTS
                 std::wstring name = L"Back Buffer " + std::to_wstring(bufferIndex);
                 d3d.backBuffer[bufferIndex]->SetName(name.c_str());
@@ -507,8 +519,8 @@ namespace Graphics
                 // Get the mesh primitive and copy its indices to the upload buffer
                 const Scenes::MeshPrimitive& primitive = mesh.primitives[primitiveIndex];
 
-                UINT size = static_cast<UINT>(primitive.indices.size()) * sizeof(UINT);
-                memcpy(pData + primitive.indexByteOffset, primitive.indices.data(), size);
+                UINT size = primitive.GetNumIndices() * sizeof(UINT);
+                memcpy(pData + primitive.indexByteOffset, primitive.GetIndices(), size);
             }
             (*upload)->Unmap(0, nullptr);
 
@@ -535,8 +547,9 @@ namespace Graphics
         bool CreateVertexBuffer(Globals& d3d, const Scenes::Mesh& mesh, ID3D12Resource** device, ID3D12Resource** upload, D3D12_VERTEX_BUFFER_VIEW& view)
         {
             // Create the vertex buffer upload resource
+            // Mesh primitives store their vertices in either the full or packed vertex format (see Scenes::MeshPrimitive::vertexFormat)
             UINT stride = sizeof(Vertex);
-            UINT sizeInBytes = mesh.numVertices * stride;
+            UINT sizeInBytes = mesh.GetVertexBufferSize();
             BufferDesc desc = { sizeInBytes, 0, EHeapType::UPLOAD, D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_FLAG_NONE };
             if (!CreateBuffer(d3d, desc, upload)) return false;
 
@@ -559,8 +572,7 @@ namespace Graphics
                 // Get the mesh primitive and copy its vertices to the upload buffer
                 const Scenes::MeshPrimitive& primitive = mesh.primitives[primitiveIndex];
 
-                UINT size = static_cast<UINT>(primitive.vertices.size()) * stride;
-                memcpy(pData + primitive.vertexByteOffset, primitive.vertices.data(), size);
+                memcpy(pData + primitive.vertexByteOffset, primitive.GetVertexData(), primitive.GetVertexDataSize());
             }
             (*upload)->Unmap(0, nullptr);
 
@@ -596,12 +608,12 @@ namespace Graphics
                 const Scenes::MeshPrimitive& primitive = mesh.primitives[primitiveIndex];
 
                 desc.Triangles.VertexBuffer.StartAddress = resources.sceneVBs[mesh.index]->GetGPUVirtualAddress() + primitive.vertexByteOffset;
-                desc.Triangles.VertexBuffer.StrideInBytes = resources.sceneVBViews[mesh.index].StrideInBytes;
-                desc.Triangles.VertexCount = static_cast<UINT>(primitive.vertices.size());
+                desc.Triangles.VertexBuffer.StrideInBytes = primitive.GetVertexStride(); // positions are the first element of both vertex formats
+                desc.Triangles.VertexCount = primitive.GetNumVertices();
                 desc.Triangles.VertexFormat = DXGI_FORMAT_R32G32B32_FLOAT;
                 desc.Triangles.IndexBuffer = resources.sceneIBs[mesh.index]->GetGPUVirtualAddress() + primitive.indexByteOffset;
                 desc.Triangles.IndexFormat = resources.sceneIBViews[mesh.index].Format;
-                desc.Triangles.IndexCount = static_cast<UINT>(primitive.indices.size());
+                desc.Triangles.IndexCount = primitive.GetNumIndices();
                 desc.Flags = primitive.opaque ? D3D12_RAYTRACING_GEOMETRY_FLAG_OPAQUE : D3D12_RAYTRACING_GEOMETRY_FLAG_NONE;
 
                 primitives.push_back(desc);
@@ -665,24 +677,62 @@ namespace Graphics
         }
 
         /**
-         * Create a top level acceleration structure for a scene.
+         * Describe the build inputs of the scene's top level acceleration structure.
+         * The TLAS allows updates, so moving instances can be refit instead of rebuilt.
          */
-        bool CreateTLAS(Globals& d3d, Resources& resources, const std::vector<D3D12_RAYTRACING_INSTANCE_DESC>& instances, const std::string debugName = "")
+        D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS GetTLASInputs(Resources& resources, UINT numInstances)
         {
-            D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAGS buildFlags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE;
+            D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAGS buildFlags = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PREFER_FAST_TRACE | D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_ALLOW_UPDATE;
 
-            // Get the size requirements for the TLAS buffers
             D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS ASInputs = {};
             ASInputs.Type = D3D12_RAYTRACING_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL;
             ASInputs.DescsLayout = D3D12_ELEMENTS_LAYOUT_ARRAY;
             ASInputs.InstanceDescs = resources.tlas.instances->GetGPUVirtualAddress();
-            ASInputs.NumDescs = static_cast<UINT>(instances.size());
+            ASInputs.NumDescs = numInstances;
             ASInputs.Flags = buildFlags;
+            return ASInputs;
+        }
+
+        /**
+         * Schedule a GPU build of the scene's top level acceleration structure.
+         * When updating, the TLAS is refit in place to the (moved) instances of its last build.
+         */
+        void BuildTLAS(Globals& d3d, Resources& resources, UINT numInstances, bool update)
+        {
+            // Describe and build the TLAS
+            D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC buildDesc = {};
+            buildDesc.Inputs = GetTLASInputs(resources, numInstances);
+            buildDesc.ScratchAccelerationStructureData = resources.tlas.scratch->GetGPUVirtualAddress();
+            buildDesc.DestAccelerationStructureData = resources.tlas.as->GetGPUVirtualAddress();
+            if (update)
+            {
+                buildDesc.Inputs.Flags |= D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAG_PERFORM_UPDATE;
+                buildDesc.SourceAccelerationStructureData = buildDesc.DestAccelerationStructureData;
+            }
+
+            d3d.cmdList[d3d.frameIndex]->BuildRaytracingAccelerationStructure(&buildDesc, 0, nullptr);
+
+            // Wait for the TLAS build to complete
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
+            barrier.UAV.pResource = resources.tlas.as;
+
+            d3d.cmdList[d3d.frameIndex]->ResourceBarrier(1, &barrier);
+        }
+
+        /**
+         * Create a top level acceleration structure for a scene.
+         * Scratch memory is allocated for both builds and updates.
+         */
+        bool CreateTLAS(Globals& d3d, Resources& resources, const std::vector<D3D12_RAYTRACING_INSTANCE_DESC>& instances, const std::string debugName = "")
+        {
+            // Get the size requirements for the TLAS buffers
+            D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS ASInputs = GetTLASInputs(resources, static_cast<UINT>(instances.size()));
 
             D3D12_RAYTRACING_ACCELERATION_STRUCTURE_PREBUILD_INFO ASPreBuildInfo = {};
             d3d.device->GetRaytracingAccelerationStructurePrebuildInfo(&ASInputs, &ASPreBuildInfo);
             ASPreBuildInfo.ResultDataMaxSizeInBytes = ALIGN(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT, ASPreBuildInfo.ResultDataMaxSizeInBytes);
-            ASPreBuildInfo.ScratchDataSizeInBytes = ALIGN(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT, ASPreBuildInfo.ScratchDataSizeInBytes);
+            ASPreBuildInfo.ScratchDataSizeInBytes = ALIGN(D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BYTE_ALIGNMENT, std::max(ASPreBuildInfo.ScratchDataSizeInBytes, ASPreBuildInfo.UpdateScratchDataSizeInBytes));
 
             // Create TLAS scratch buffer resource
             BufferDesc desc =
@@ -706,20 +756,8 @@ namespace Graphics
             resources.tlas.as->SetName(L"Scene TLAS");
         #endif
 
-            // Describe and build the TLAS
-            D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_DESC buildDesc = {};
-            buildDesc.Inputs = ASInputs;
-            buildDesc.ScratchAccelerationStructureData = resources.tlas.scratch->GetGPUVirtualAddress();
-            buildDesc.DestAccelerationStructureData = resources.tlas.as->GetGPUVirtualAddress();
-
-            d3d.cmdList[d3d.frameIndex]->BuildRaytracingAccelerationStructure(&buildDesc, 0, nullptr);
-
-            // Wait for the TLAS build to complete
-            D3D12_RESOURCE_BARRIER barrier = {};
-            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_UAV;
-            barrier.UAV.pResource = resources.tlas.as;
-
-            d3d.cmdList[d3d.frameIndex]->ResourceBarrier(1, &barrier);
+            // Schedule the TLAS build
+            BuildTLAS(d3d, resources, ASInputs.NumDescs, false);
 
             return true;
         }
@@ -1255,7 +1293,7 @@ namespace Graphics
         void Cleanup(Globals& d3d)
         {
             // Leave fullscreen mode if necessary
-            if (d3d.fullscreen) d3d.swapChain->SetFullscreenState(FALSE, nullptr);
+            if (d3d.fullscreen && d3d.swapChain) d3d.swapChain->SetFullscreenState(FALSE, nullptr);
 
             Shaders::Cleanup(d3d.shaderCompiler);
 
@@ -1519,6 +1557,7 @@ namespace Graphics
                     data.materialIndex = primitive.material;
                     data.indexByteAddress = primitive.indexByteOffset;
                     data.vertexByteAddress = primitive.vertexByteOffset;
+                    data.vertexFormat = primitive.vertexFormat;
                     memcpy(geometryDataAddress, &data, sizeof(GeometryData));
 
                     geometryDataAddress += sizeof(GeometryData);
@@ -1570,12 +1609,14 @@ namespace Graphics
 
         /**
          * Create the scene TLAS instances buffers.
+         * The upload buffer stays mapped and holds a copy of the instances for each frame in flight, so the instances that
+         * change in a frame can be written without waiting on the GPU (see UpdateSceneTLAS()).
          */
         bool CreateSceneInstancesBuffer(Globals& d3d, Resources& resources, const std::vector<D3D12_RAYTRACING_INSTANCE_DESC>& instances)
         {
             // Create the TLAS instance upload buffer resource
             UINT size = ALIGN(D3D12_RAYTRACING_INSTANCE_DESCS_BYTE_ALIGNMENT, static_cast<UINT>(instances.size()) * sizeof(D3D12_RAYTRACING_INSTANCE_DESC));
-            BufferDesc desc = { size, 0, EHeapType::UPLOAD, D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_FLAG_NONE };
+            BufferDesc desc = { size * MAX_FRAMES_IN_FLIGHT, 0, EHeapType::UPLOAD, D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_FLAG_NONE };
             if (!CreateBuffer(d3d, desc, &resources.tlas.instancesUpload)) return false;
         #ifdef GFX_NAME_OBJECTS
             resources.tlas.instancesUpload->SetName(L"TLAS Instance Descriptors Upload Buffer");
@@ -1588,12 +1629,13 @@ namespace Graphics
             resources.tlas.instances->SetName(L"TLAS Instance Descriptors Buffer");
         #endif
 
-            // Copy the instance data to the upload buffer
-            UINT8* pData = nullptr;
+            // Copy the instance data to each region of the upload buffer. Leave the buffer mapped for updates.
             D3D12_RANGE readRange = {};
-            D3DCHECK(resources.tlas.instancesUpload->Map(0, &readRange, reinterpret_cast<void**>(&pData)));
-            memcpy(pData, instances.data(), desc.size);
-            resources.tlas.instancesUpload->Unmap(0, nullptr);
+            D3DCHECK(resources.tlas.instancesUpload->Map(0, &readRange, reinterpret_cast<void**>(&resources.tlas.instancesUploadPtr)));
+            for (UINT frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++)
+            {
+                memcpy(resources.tlas.instancesUploadPtr + (frameIndex * size), instances.data(), instances.size() * sizeof(D3D12_RAYTRACING_INSTANCE_DESC));
+            }
 
             // Schedule a copy of the upload buffer to the device buffer
             d3d.cmdList[d3d.frameIndex]->CopyBufferRegion(resources.tlas.instances, 0, resources.tlas.instancesUpload, 0, size);
@@ -1694,7 +1736,7 @@ namespace Graphics
                 D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
                 srvDesc.ViewDimension = D3D12_SRV_DIMENSION_BUFFER;
                 srvDesc.Format = DXGI_FORMAT_R32_TYPELESS;
-                srvDesc.Buffer.NumElements = (sizeof(Vertex) * mesh.numVertices) / 4;
+                srvDesc.Buffer.NumElements = mesh.GetVertexBufferSize() / 4;
                 srvDesc.Buffer.Flags = D3D12_BUFFER_SRV_FLAG_RAW;
                 srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
 
@@ -1761,6 +1803,7 @@ namespace Graphics
 
             // Build the TLAS
             if (!CreateTLAS(d3d, resources, instances, "TLAS")) return false;
+            AccelerationStructures::Reset(resources.tlasUpdate, scene);
 
             // Add the TLAS SRV to the descriptor heap
             D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
@@ -1775,6 +1818,52 @@ namespace Graphics
             return true;
         }
 
+        /**
+         * Update the scene's top level acceleration structure for the mesh instances moved by Scenes::UpdateTransforms().
+         * Writes the changed instance transforms to the current frame's region of the (mapped) instances upload buffer,
+         * copies the changed ranges to the device buffer, and refits or rebuilds the TLAS (see AccelerationStructures::Update()).
+         */
+        void UpdateSceneTLAS(Globals& d3d, Resources& resources, const Configs::Config& config, const Scenes::Scene& scene)
+        {
+            AccelerationStructures::TLASPolicy policy = { config.scene.tlasRebuildMotion, config.scene.tlasRebuildInterval };
+            AccelerationStructures::ETLASUpdate update = AccelerationStructures::Update(resources.tlasUpdate, policy, scene);
+            if (update == AccelerationStructures::ETLASUpdate::NONE) return;
+
+            // Transition the instances device buffer to a copy destination
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            barrier.Transition.pResource = resources.tlas.instances;
+            barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_GENERIC_READ;
+            barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+            barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+
+            d3d.cmdList[d3d.frameIndex]->ResourceBarrier(1, &barrier);
+
+            // Write the changed instance transforms to the current frame's region of the upload buffer
+            const UINT64 instanceSize = sizeof(D3D12_RAYTRACING_INSTANCE_DESC);
+            const UINT64 regionOffset = d3d.frameIndex * ALIGN(D3D12_RAYTRACING_INSTANCE_DESCS_BYTE_ALIGNMENT, static_cast<UINT>(scene.instances.size()) * sizeof(D3D12_RAYTRACING_INSTANCE_DESC));
+            for (const AccelerationStructures::InstanceRange& range : resources.tlasUpdate.ranges)
+            {
+                for (UINT instanceIndex = range.first; instanceIndex < (range.first + range.count); instanceIndex++)
+                {
+                    D3D12_RAYTRACING_INSTANCE_DESC* desc = reinterpret_cast<D3D12_RAYTRACING_INSTANCE_DESC*>(resources.tlas.instancesUploadPtr + regionOffset + (instanceIndex * instanceSize));
+                    memcpy(desc->Transform, scene.instances[instanceIndex].transform, sizeof(XMFLOAT4) * 3);
+                }
+
+                // The other regions were last written by frames still in flight, so the whole range is copied from this region
+                d3d.cmdList[d3d.frameIndex]->CopyBufferRegion(resources.tlas.instances, range.first * instanceSize, resources.tlas.instancesUpload, regionOffset + (range.first * instanceSize), range.count * instanceSize);
+            }
+
+            // Transition the instances device buffer to generic read after the copies are complete
+            barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+            barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
+
+            d3d.cmdList[d3d.frameIndex]->ResourceBarrier(1, &barrier);
+
+            // Refit or rebuild the TLAS
+            BuildTLAS(d3d, resources, static_cast<UINT>(scene.instances.size()), (update == AccelerationStructures::ETLASUpdate::REFIT));
+        }
+
         /**
          * Create the scene textures.
          */
@@ -2030,6 +2119,161 @@ namespace Graphics
             return result;
         }
 
+        /**
+         * Copy the texels of a texture (all array slices) to memory. Texels are tightly packed: rows, then array slices.
+         */
+        bool ReadResourceTexels(Globals& d3d, ID3D12Resource* pResource, D3D12_RESOURCE_STATES state, uint8_t* data)
+        {
+            // Create a command allocator, command list, and fence
+            ID3D12CommandAllocator* commandAlloc = nullptr;
+            D3DCHECK(d3d.device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAlloc)));
+
+            ID3D12GraphicsCommandList* commandList = nullptr;
+            D3DCHECK(d3d.device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAlloc, nullptr, IID_PPV_ARGS(&commandList)));
+
+            ID3D12Fence* fence = nullptr;
+            D3DCHECK(d3d.device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence)));
+
+            // Get the copy footprints of the subresources (array slices)
+            const D3D12_RESOURCE_DESC desc = pResource->GetDesc();
+            UINT numSubresources = desc.DepthOrArraySize;
+            std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints(numSubresources);
+            std::vector<UINT> numRows(numSubresources);
+            std::vector<UINT64> rowSizeInBytes(numSubresources);
+            UINT64 sizeInBytes = 0;
+            d3d.device->GetCopyableFootprints(&desc, 0, numSubresources, 0, footprints.data(), numRows.data(), rowSizeInBytes.data(), &sizeInBytes);
+
+            // Create the staging (read-back) buffer
+            ID3D12Resource* staging = nullptr;
+            BufferDesc bufferDesc = { sizeInBytes, 0, EHeapType::READBACK, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_FLAG_NONE };
+            if (!CreateBuffer(d3d, bufferDesc, &staging)) return false;
+
+            // Transition the source texture resource to a copy source
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            barrier.Transition.pResource = pResource;
+            barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            barrier.Transition.StateBefore = state;
+            barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_SOURCE;
+            commandList->ResourceBarrier(1, &barrier);
+
+            // Copy the subresources to the staging buffer
+            for (UINT subresourceIndex = 0; subresourceIndex < numSubresources; subresourceIndex++)
+            {
+                D3D12_TEXTURE_COPY_LOCATION copySrc = {};
+                copySrc.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+                copySrc.pResource = pResource;
+                copySrc.SubresourceIndex = subresourceIndex;
+
+                D3D12_TEXTURE_COPY_LOCATION copyDest = {};
+                copyDest.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+                copyDest.pResource = staging;
+                copyDest.PlacedFootprint = footprints[subresourceIndex];
+
+                commandList->CopyTextureRegion(&copyDest, 0, 0, 0, &copySrc, nullptr);
+            }
+
+            // Transition the source texture resource to the specified state
+            barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE;
+            barrier.Transition.StateAfter = state;
+            commandList->ResourceBarrier(1, &barrier);
+
+            // Execute the command list and block until the copy is complete
+            D3DCHECK(commandList->Close());
+            d3d.cmdQueue->ExecuteCommandLists(1, reinterpret_cast<ID3D12CommandList**>(&commandList));
+            D3DCHECK(d3d.cmdQueue->Signal(fence, 1));
+            while (fence->GetCompletedValue() < 1) SwitchToThread();
+
+            // Copy the staging buffer to memory, removing the row padding
+            UINT8* pData = nullptr;
+            D3D12_RANGE readRange = { 0, static_cast<size_t>(sizeInBytes) };
+            D3DCHECK(staging->Map(0, &readRange, (void**)&pData));
+            for (UINT subresourceIndex = 0; subresourceIndex < numSubresources; subresourceIndex++)
+            {
+                const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint = footprints[subresourceIndex];
+                for (UINT rowIndex = 0; rowIndex < numRows[subresourceIndex]; rowIndex++)
+                {
+                    memcpy(data, pData + footprint.Offset + (rowIndex * footprint.Footprint.RowPitch), static_cast<size_t>(rowSizeInBytes[subresourceIndex]));
+                    data += rowSizeInBytes[subresourceIndex];
+                }
+            }
+            staging->Unmap(0, nullptr);
+
+            // Clean up
+            SAFE_RELEASE(staging);
+            SAFE_RELEASE(fence);
+            SAFE_RELEASE(commandList);
+            SAFE_RELEASE(commandAlloc);
+
+            return true;
+        }
+
+        /**
+         * Record a copy of texels (all array slices, tightly packed: rows, then array slices) to a texture.
+         * Release the upload buffer after the command list executes.
+         */
+        bool UploadResourceTexels(Globals& d3d, ID3D12GraphicsCommandList* cmdList, ID3D12Resource* pResource, D3D12_RESOURCE_STATES state, const uint8_t* data, ID3D12Resource** ppUpload)
+        {
+            // Get the copy footprints of the subresources (array slices)
+            const D3D12_RESOURCE_DESC desc = pResource->GetDesc();
+            UINT numSubresources = desc.DepthOrArraySize;
+            std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints(numSubresources);
+            std::vector<UINT> numRows(numSubresources);
+            std::vector<UINT64> rowSizeInBytes(numSubresources);
+            UINT64 sizeInBytes = 0;
+            d3d.device->GetCopyableFootprints(&desc, 0, numSubresources, 0, footprints.data(), numRows.data(), rowSizeInBytes.data(), &sizeInBytes);
+
+            // Create the upload buffer and copy the texels to it, adding the row padding
+            BufferDesc bufferDesc = { sizeInBytes, 0, EHeapType::UPLOAD, D3D12_RESOURCE_STATE_GENERIC_READ, D3D12_RESOURCE_FLAG_NONE };
+            if (!CreateBuffer(d3d, bufferDesc, ppUpload)) return false;
+
+            UINT8* pData = nullptr;
+            D3D12_RANGE readRange = {};
+            D3DCHECK((*ppUpload)->Map(0, &readRange, (void**)&pData));
+            for (UINT subresourceIndex = 0; subresourceIndex < numSubresources; subresourceIndex++)
+            {
+                const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& footprint = footprints[subresourceIndex];
+                for (UINT rowIndex = 0; rowIndex < numRows[subresourceIndex]; rowIndex++)
+                {
+                    memcpy(pData + footprint.Offset + (rowIndex * footprint.Footprint.RowPitch), data, static_cast<size_t>(rowSizeInBytes[subresourceIndex]));
+                    data += rowSizeInBytes[subresourceIndex];
+                }
+            }
+            (*ppUpload)->Unmap(0, nullptr);
+
+            // Transition the texture resource to a copy destination
+            D3D12_RESOURCE_BARRIER barrier = {};
+            barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+            barrier.Transition.pResource = pResource;
+            barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+            barrier.Transition.StateBefore = state;
+            barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+            cmdList->ResourceBarrier(1, &barrier);
+
+            // Copy the subresources from the upload buffer
+            for (UINT subresourceIndex = 0; subresourceIndex < numSubresources; subresourceIndex++)
+            {
+                D3D12_TEXTURE_COPY_LOCATION copySrc = {};
+                copySrc.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+                copySrc.pResource = *ppUpload;
+                copySrc.PlacedFootprint = footprints[subresourceIndex];
+
+                D3D12_TEXTURE_COPY_LOCATION copyDest = {};
+                copyDest.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+                copyDest.pResource = pResource;
+                copyDest.SubresourceIndex = subresourceIndex;
+
+                cmdList->CopyTextureRegion(&copyDest, 0, 0, 0, &copySrc, nullptr);
+            }
+
+            // Transition the texture resource to the specified state
+            barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+            barrier.Transition.StateAfter = state;
+            cmdList->ResourceBarrier(1, &barrier);
+
+            return true;
+        }
+
         //----------------------------------------------------------------------------------------------------------
         // Public Functions
         //----------------------------------------------------------------------------------------------------------
@@ -2080,6 +2324,8 @@ namespace Graphics
             NvAPI_Initialize();
         #endif
 
+            d3d.headless = config.app.headless;
+
             // Create a DXGI factory
             if (FAILED(CreateDXGIFactory2(0, IID_PPV_ARGS(&d3d.factory)))) return false;
 
@@ -2520,7 +2766,6 @@ namespace Graphics
             SAFE_RELEASE(resources.materialsSTBUpload);
             SAFE_RELEASE(resources.meshOffsetsRBUpload);
             SAFE_RELEASE(resources.geometryDataRBUpload);
-            SAFE_RELEASE(resources.tlas.instancesUpload);
 
             // Release scene geometry upload buffers
             UINT resourceIndex;
@@ -2569,7 +2814,7 @@ namespace Graphics
         }
 
         /**
-         * Update constant buffers.
+         * Update constant buffers and the scene TLAS.
          */
         void Update(Globals& d3d, Resources& resources, const Configs::Config& config, Scenes::Scene& scene)
         {
@@ -2583,6 +2828,7 @@ namespace Graphics
             camera.data.resolution.y = (float)d3d.height;
             camera.data.aspect = camera.data.resolution.x / camera.data.resolution.y;
             memcpy(resources.cameraCBPtr, camera.GetGPUData(), camera.GetGPUDataSize());
+            resources.camera = camera.data;
 
             // Update the lights buffer for lights that have been modified
             UINT lastDirtyLight = 0;
@@ -2620,6 +2866,9 @@ namespace Graphics
 
                 d3d.cmdList[d3d.frameIndex]->ResourceBarrier(1, &barrier);
             }
+
+            // Update the scene TLAS for moved mesh instances
+            UpdateSceneTLAS(d3d, resources, config, scene);
         }
 
         /**
@@ -2708,6 +2957,12 @@ namespace Graphics
          */
         bool Present(Globals& d3d)
         {
+            if (d3d.headless)
+            {
+                d3d.frameNumber++;
+                return true;
+            }
+
             HRESULT hr;
             if (!d3d.vsync && d3d.allowTearing) hr = d3d.swapChain->Present(0, DXGI_PRESENT_ALLOW_TEARING);
             else hr = d3d.swapChain->Present(d3d.vsync, 0);
@@ -2754,7 +3009,8 @@ namespace Graphics
         bool MoveToNextFrame(Globals& d3d)
         {
             // Set the frame index for the next frame
-            d3d.frameIndex = d3d.swapChain->GetCurrentBackBufferIndex();
+            if (d3d.headless) d3d.frameIndex = (d3d.frameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+            else d3d.frameIndex = d3d.swapChain->GetCurrentBackBufferIndex();
             return true;
         }
 
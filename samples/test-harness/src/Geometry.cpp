@@ -10,6 +10,10 @@
 
 #include "Geometry.h"
 
+#include <algorithm>
+
+#include <DirectXPackedVector.h>
+
 //----------------------------------------------------------------------------------------------------------
 // Private Functions
 //----------------------------------------------------------------------------------------------------------
@@ -122,6 +126,384 @@ namespace Geometry
         return indices;
     }
 
+    //----------------------------------------------------------------------------------------------------------
+    // Private Mesh Optimization Functions
+    //----------------------------------------------------------------------------------------------------------
+
+    const uint32_t c_fifoCacheSize = 16;        // vertex cache size used to measure cache misses
+    const uint32_t c_lruCacheSize = 32;         // vertex cache size modeled when ordering triangles
+    const uint32_t c_clusterTriangles = 256;    // triangles per spatially coherent cluster
+    const uint32_t c_invalid = UINT32_MAX;
+
+    uint32_t HashVertex(const Graphics::Vertex& vertex)
+    {
+        uint32_t words[sizeof(Graphics::Vertex) / sizeof(uint32_t)];
+        memcpy(words, &vertex, sizeof(words));
+
+        uint32_t hash = 0;
+        for (uint32_t word : words)
+        {
+            hash = (hash ^ word) * 0x9E3779B1u;
+            hash ^= hash >> 16;
+        }
+        return hash;
+    }
+
+    /**
+     * Find bitwise identical vertices. Writes the index of each vertex's first occurrence to remap.
+     */
+    void WeldVertices(const std::vector<Graphics::Vertex>& vertices, std::vector<uint32_t>& remap)
+    {
+        uint32_t numVertices = static_cast<uint32_t>(vertices.size());
+        remap.resize(numVertices);
+
+        // Open addressing hash table of vertex indices, at most half full
+        size_t tableSize = 1;
+        while (tableSize < (static_cast<size_t>(numVertices) * 2)) tableSize <<= 1;
+        std::vector<uint32_t> table(tableSize, c_invalid);
+
+        for (uint32_t vertexIndex = 0; vertexIndex < numVertices; vertexIndex++)
+        {
+            size_t slot = HashVertex(vertices[vertexIndex]) & (tableSize - 1);
+            for (;;)
+            {
+                uint32_t entry = table[slot];
+                if (entry == c_invalid)
+                {
+                    table[slot] = vertexIndex;
+                    remap[vertexIndex] = vertexIndex;
+                    break;
+                }
+                if (memcmp(&vertices[entry], &vertices[vertexIndex], sizeof(Graphics::Vertex)) == 0)
+                {
+                    remap[vertexIndex] = entry;
+                    break;
+                }
+                slot = (slot + 1) & (tableSize - 1);
+            }
+        }
+    }
+
+    /**
+     * Spread the lower 10 bits of a value to every third bit.
+     */
+    uint32_t SpreadBits(uint32_t value)
+    {
+        value = (value * 0x00010001u) & 0xFF0000FFu;
+        value = (value * 0x00000101u) & 0x0F00F00Fu;
+        value = (value * 0x00000011u) & 0xC30C30C3u;
+        value = (value * 0x00000005u) & 0x49249249u;
+        return value;
+    }
+
+    /**
+     * Sort triangles along a Morton (Z-order) curve through their centroids, so triangles that are close in the
+     * index buffer are close in space.
+     */
+    void SortTriangles(const std::vector<Graphics::Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        uint32_t numTriangles = static_cast<uint32_t>(indices.size() / 3);
+
+        std::vector<float3> centroids(numTriangles);
+        float3 min = { FLT_MAX, FLT_MAX, FLT_MAX };
+        float3 max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+        for (uint32_t triangleIndex = 0; triangleIndex < numTriangles; triangleIndex++)
+        {
+            const uint32_t* triangle = &indices[triangleIndex * 3];
+            float3 centroid = (vertices[triangle[0]].position + vertices[triangle[1]].position + vertices[triangle[2]].position) / 3.f;
+            centroids[triangleIndex] = centroid;
+            min = rtxgi::Min(min, centroid);
+            max = rtxgi::Max(max, centroid);
+        }
+
+        float3 extent = max - min;
+        float3 scale =
+        {
+            (extent.x > 0.f) ? 1023.f / extent.x : 0.f,
+            (extent.y > 0.f) ? 1023.f / extent.y : 0.f,
+            (extent.z > 0.f) ? 1023.f / extent.z : 0.f
+        };
+
+        // Sort by Morton code (ties keep their authored order)
+        std::vector<uint64_t> keys(numTriangles);
+        for (uint32_t triangleIndex = 0; triangleIndex < numTriangles; triangleIndex++)
+        {
+            float3 p = (centroids[triangleIndex] - min) * scale;
+            uint32_t x = std::min(static_cast<uint32_t>(p.x), 1023u);
+            uint32_t y = std::min(static_cast<uint32_t>(p.y), 1023u);
+            uint32_t z = std::min(static_cast<uint32_t>(p.z), 1023u);
+            uint32_t code = (SpreadBits(x) << 2) | (SpreadBits(y) << 1) | SpreadBits(z);
+            keys[triangleIndex] = (static_cast<uint64_t>(code) << 32) | triangleIndex;
+        }
+        std::sort(keys.begin(), keys.end());
+
+        std::vector<uint32_t> sorted(indices.size());
+        for (uint32_t triangleIndex = 0; triangleIndex < numTriangles; triangleIndex++)
+        {
+            memcpy(&sorted[triangleIndex * 3], &indices[static_cast<uint32_t>(keys[triangleIndex]) * 3], sizeof(uint32_t) * 3);
+        }
+        indices.swap(sorted);
+    }
+
+    float GetVertexScore(uint32_t cachePosition, uint32_t numRemainingTriangles)
+    {
+        if (numRemainingTriangles == 0) return -1.f;
+
+        float score = 0.f;
+        if (cachePosition < 3) score = 0.75f; // vertices of the last triangle
+        else if (cachePosition < c_lruCacheSize) score = powf(1.f - (static_cast<float>(cachePosition - 3) / static_cast<float>(c_lruCacheSize - 3)), 1.5f);
+
+        // Favor vertices with few remaining triangles, to finish off vertices
+        return score + (2.f / sqrtf(static_cast<float>(numRemainingTriangles)));
+    }
+
+    /**
+     * Reorder triangles for post-transform vertex cache locality.
+     * Greedily emits the triangle whose vertices score highest, based on their position in a simulated LRU cache
+     * and their number of remaining triangles (T. Forsyth, "Linear-Speed Vertex Cache Optimisation").
+     * The localIndex array has an entry for each vertex of the mesh and must contain c_invalid, which is restored on return.
+     */
+    void OptimizeTriangleOrder(uint32_t* indices, uint32_t numTriangles, std::vector<uint32_t>& localIndex)
+    {
+        uint32_t numIndices = numTriangles * 3;
+
+        // Number the triangles' vertices locally
+        std::vector<uint32_t> vertices;
+        std::vector<uint32_t> local(numIndices);
+        for (uint32_t index = 0; index < numIndices; index++)
+        {
+            uint32_t& entry = localIndex[indices[index]];
+            if (entry == c_invalid)
+            {
+                entry = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(indices[index]);
+            }
+            local[index] = entry;
+        }
+        for (uint32_t vertex : vertices) localIndex[vertex] = c_invalid;
+
+        uint32_t numVertices = static_cast<uint32_t>(vertices.size());
+
+        // Build the vertex to triangle adjacency
+        std::vector<uint32_t> numRemaining(numVertices, 0);
+        for (uint32_t index = 0; index < numIndices; index++) numRemaining[local[index]]++;
+
+        std::vector<uint32_t> firstAdjacent(numVertices, 0);
+        for (uint32_t vertex = 1; vertex < numVertices; vertex++) firstAdjacent[vertex] = firstAdjacent[vertex - 1] + numRemaining[vertex - 1];
+
+        std::vector<uint32_t> adjacency(numIndices);
+        std::vector<uint32_t> numAdjacent(numVertices, 0);
+        for (uint32_t index = 0; index < numIndices; index++)
+        {
+            uint32_t vertex = local[index];
+            adjacency[firstAdjacent[vertex] + numAdjacent[vertex]++] = index / 3;
+        }
+
+        // Initial scores
+        std::vector<uint32_t> cachePosition(numVertices, c_invalid);
+        std::vector<float> vertexScores(numVertices);
+        for (uint32_t vertex = 0; vertex < numVertices; vertex++) vertexScores[vertex] = GetVertexScore(c_invalid, numRemaining[vertex]);
+
+        std::vector<float> triangleScores(numTriangles);
+        std::vector<uint8_t> emitted(numTriangles, 0);
+        uint32_t bestTriangle = 0;
+        for (uint32_t triangle = 0; triangle < numTriangles; triangle++)
+        {
+            const uint32_t* t = &local[triangle * 3];
+            triangleScores[triangle] = vertexScores[t[0]] + vertexScores[t[1]] + vertexScores[t[2]];
+            if (triangleScores[triangle] > triangleScores[bestTriangle]) bestTriangle = triangle;
+        }
+
+        uint32_t cache[c_lruCacheSize + 3];
+        uint32_t cacheSize = 0;
+        uint32_t nextTriangle = 0;
+
+        std::vector<uint32_t> output;
+        output.reserve(numIndices);
+        for (uint32_t numEmitted = 0; numEmitted < numTriangles; numEmitted++)
+        {
+            // No triangle in the cache has a score, continue with the next triangle in order
+            if (bestTriangle == c_invalid)
+            {
+                while (emitted[nextTriangle]) nextTriangle++;
+                bestTriangle = nextTriangle;
+            }
+
+            // Emit the triangle and remove it from its vertices' adjacency
+            const uint32_t* t = &local[bestTriangle * 3];
+            emitted[bestTriangle] = 1;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                uint32_t vertex = t[k];
+                output.push_back(vertex);
+
+                uint32_t* adjacent = &adjacency[firstAdjacent[vertex]];
+                uint32_t count = numRemaining[vertex];
+                for (uint32_t a = 0; a < count; a++)
+                {
+                    if (adjacent[a] != bestTriangle) continue;
+                    adjacent[a] = adjacent[count - 1];
+                    break;
+                }
+                numRemaining[vertex]--;
+            }
+
+            // Move the triangle's vertices to the front of the cache
+            uint32_t newCache[c_lruCacheSize + 3];
+            uint32_t newCacheSize = 0;
+            for (uint32_t k = 0; k < 3; k++) newCache[newCacheSize++] = t[k];
+            for (uint32_t c = 0; c < cacheSize; c++)
+            {
+                uint32_t vertex = cache[c];
+                if (vertex != t[0] && vertex != t[1] && vertex != t[2]) newCache[newCacheSize++] = vertex;
+            }
+
+            // Update the scores of the cached (and evicted) vertices
+            for (uint32_t c = 0; c < newCacheSize; c++)
+            {
+                uint32_t vertex = newCache[c];
+                cachePosition[vertex] = (c < c_lruCacheSize) ? c : c_invalid;
+                vertexScores[vertex] = GetVertexScore(cachePosition[vertex], numRemaining[vertex]);
+            }
+
+            // Update the scores of their remaining triangles and pick the best one
+            bestTriangle = c_invalid;
+            float bestScore = -1.f;
+            for (uint32_t c = 0; c < newCacheSize; c++)
+            {
+                uint32_t vertex = newCache[c];
+                const uint32_t* adjacent = &adjacency[firstAdjacent[vertex]];
+                for (uint32_t a = 0; a < numRemaining[vertex]; a++)
+                {
+                    uint32_t triangle = adjacent[a];
+                    const uint32_t* tt = &local[triangle * 3];
+                    triangleScores[triangle] = vertexScores[tt[0]] + vertexScores[tt[1]] + vertexScores[tt[2]];
+                    if (triangleScores[triangle] > bestScore)
+                    {
+                        bestScore = triangleScores[triangle];
+                        bestTriangle = triangle;
+                    }
+                }
+            }
+
+            cacheSize = std::min(newCacheSize, c_lruCacheSize);
+            memcpy(cache, newCache, sizeof(uint32_t) * cacheSize);
+        }
+
+        for (uint32_t index = 0; index < numIndices; index++) indices[index] = vertices[output[index]];
+    }
+
+    /**
+     * Order vertices by their first use in the index buffer and remove unused vertices.
+     */
+    void ReorderVertices(std::vector<Graphics::Vertex>& vertices, std::vector<uint32_t>& indices)
+    {
+        std::vector<uint32_t> remap(vertices.size(), c_invalid);
+        std::vector<Graphics::Vertex> reordered;
+        reordered.reserve(vertices.size());
+        for (uint32_t& index : indices)
+        {
+            if (remap[index] == c_invalid)
+            {
+                remap[index] = static_cast<uint32_t>(reordered.size());
+                reordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+        vertices.swap(reordered);
+    }
+
+    //----------------------------------------------------------------------------------------------------------
+    // Private Vertex Packing Functions
+    //----------------------------------------------------------------------------------------------------------
+
+    const float c_maxPackedAngleError = 0.01f;      // degrees, normals and tangents (16 bit octahedral encoding is accurate to ~0.006)
+    const float c_maxPackedUVError = 1.f / 2048.f;  // texture coordinates up to +/-2 are within this error when stored as half floats
+
+    /**
+     * Map a (non-zero) direction to the [-1, 1] square with an octahedral projection.
+     */
+    float2 EncodeOctahedral(float3 v)
+    {
+        float length = fabsf(v.x) + fabsf(v.y) + fabsf(v.z);
+        float2 e = { v.x / length, v.y / length };
+        if (v.z < 0.f)
+        {
+            float x = e.x;
+            e.x = (1.f - fabsf(e.y)) * (x >= 0.f ? 1.f : -1.f);
+            e.y = (1.f - fabsf(x)) * (e.y >= 0.f ? 1.f : -1.f);
+        }
+        return e;
+    }
+
+    /**
+     * Map a point of the [-1, 1] square to a unit vector.
+     * Complement of EncodeOctahedral(), matches DecodeOctahedral() in RayTracing.hlsl.
+     */
+    float3 DecodeOctahedral(float2 e)
+    {
+        float3 v = { e.x, e.y, 1.f - fabsf(e.x) - fabsf(e.y) };
+        if (v.z < 0.f)
+        {
+            float x = v.x;
+            v.x = (1.f - fabsf(v.y)) * (x >= 0.f ? 1.f : -1.f);
+            v.y = (1.f - fabsf(x)) * (v.y >= 0.f ? 1.f : -1.f);
+        }
+        float length = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+        return { v.x / length, v.y / length, v.z / length };
+    }
+
+    uint32_t QuantizeUnorm(float value, uint32_t max)
+    {
+        value = value * 0.5f + 0.5f;
+        if (!(value > 0.f)) return 0; // NaN quantizes to zero
+        value = std::min(value, 1.f);
+        return static_cast<uint32_t>(value * static_cast<float>(max) + 0.5f);
+    }
+
+    float DequantizeUnorm(uint32_t value, uint32_t max)
+    {
+        return (static_cast<float>(value) / static_cast<float>(max)) * 2.f - 1.f;
+    }
+
+    /**
+     * Pack a direction into 16 bits of octahedral X and 16 (or 15) bits of octahedral Y.
+     * Zero is reserved for the zero vector (octahedral (-1, -1) is the same direction as (1, 1)).
+     */
+    uint32_t PackOctahedral(float3 v, uint32_t maxY)
+    {
+        if (v.x == 0.f && v.y == 0.f && v.z == 0.f) return 0;
+
+        float2 e = EncodeOctahedral(v);
+        uint32_t x = QuantizeUnorm(e.x, 0xFFFF);
+        uint32_t y = QuantizeUnorm(e.y, maxY);
+        if (x == 0 && y == 0) { x = 0xFFFF; y = maxY; }
+        return x | (y << 16);
+    }
+
+    float3 UnpackOctahedral(uint32_t packed, uint32_t maxY)
+    {
+        if (packed == 0) return { 0.f, 0.f, 0.f };
+        return DecodeOctahedral({ DequantizeUnorm(packed & 0xFFFF, 0xFFFF), DequantizeUnorm(packed >> 16, maxY) });
+    }
+
+    /**
+     * Get the angle between two directions, in degrees.
+     * Zero vectors only match zero vectors.
+     */
+    float GetAngleError(float3 a, float3 b)
+    {
+        float lengthA = sqrtf(a.x * a.x + a.y * a.y + a.z * a.z);
+        float lengthB = sqrtf(b.x * b.x + b.y * b.y + b.z * b.z);
+        if (lengthA == 0.f || lengthB == 0.f) return (lengthA == lengthB) ? 0.f : 180.f;
+
+        // atan2 of the cross and dot products is accurate for small angles (unlike acos of the dot product)
+        float3 cross = { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+        float sine = sqrtf(cross.x * cross.x + cross.y * cross.y + cross.z * cross.z);
+        float cosine = a.x * b.x + a.y * b.y + a.z * b.z;
+        return atan2f(sine, cosine) * (180.f / XM_PI);
+    }
+
     //----------------------------------------------------------------------------------------------------------
     // Public Functions
     //----------------------------------------------------------------------------------------------------------
@@ -136,4 +518,164 @@ namespace Geometry
         mesh.numIndices = static_cast<int>(primitive.indices.size());
     }
 
+    /**
+     * Count the vertex cache misses of a triangle list, with a simulated FIFO cache.
+     */
+    uint64_t GetCacheMisses(const uint32_t* indices, size_t numIndices, size_t numVertices)
+    {
+        // A vertex is in the cache if fewer than c_fifoCacheSize misses happened since it was loaded
+        std::vector<uint32_t> loaded(numVertices, 0);
+        uint32_t time = c_fifoCacheSize + 1;
+
+        uint64_t misses = 0;
+        for (size_t index = 0; index < numIndices; index++)
+        {
+            uint32_t vertex = indices[index];
+            if (vertex >= numVertices || (time - loaded[vertex]) > c_fifoCacheSize)
+            {
+                if (vertex < numVertices) loaded[vertex] = time;
+                time++;
+                misses++;
+            }
+        }
+        return misses;
+    }
+
+    /**
+     * Optimize a triangle list mesh for rendering and ray tracing.
+     * Welds duplicate vertices, removes degenerate triangles, sorts triangles spatially (for coherent BLAS builds),
+     * orders the triangles of each cluster of c_clusterTriangles sorted triangles for vertex cache locality, and
+     * orders vertices by first use (for vertex fetch locality). Meshes with out of range indices are not changed.
+     */
+    void Optimize(std::vector<Graphics::Vertex>& vertices, std::vector<uint32_t>& indices, OptimizeStats& stats)
+    {
+        uint64_t cacheMisses = GetCacheMisses(indices.data(), indices.size(), vertices.size());
+        stats.numVertices += vertices.size();
+        stats.numTriangles += indices.size() / 3;
+        stats.numCacheMissesBefore += cacheMisses;
+
+        bool valid = (indices.size() % 3) == 0 && vertices.size() < c_invalid;
+        for (size_t index = 0; valid && index < indices.size(); index++) valid = (indices[index] < vertices.size());
+        if (!valid)
+        {
+            stats.numUniqueVertices += vertices.size();
+            stats.numCacheMissesAfter += cacheMisses;
+            return;
+        }
+
+        // Weld duplicate vertices and remove degenerate triangles
+        std::vector<uint32_t> remap;
+        WeldVertices(vertices, remap);
+
+        size_t numIndices = 0;
+        for (size_t index = 0; index < indices.size(); index += 3)
+        {
+            uint32_t a = remap[indices[index]];
+            uint32_t b = remap[indices[index + 1]];
+            uint32_t c = remap[indices[index + 2]];
+            if (a == b || b == c || a == c)
+            {
+                stats.numDegenerateTriangles++;
+                continue;
+            }
+            indices[numIndices++] = a;
+            indices[numIndices++] = b;
+            indices[numIndices++] = c;
+        }
+        indices.resize(numIndices);
+
+        // Sort the triangles spatially, then order the triangles of each cluster for the vertex cache
+        SortTriangles(vertices, indices);
+
+        uint32_t numTriangles = static_cast<uint32_t>(numIndices / 3);
+        std::vector<uint32_t> localIndex(vertices.size(), c_invalid);
+        for (uint32_t firstTriangle = 0; firstTriangle < numTriangles; firstTriangle += c_clusterTriangles)
+        {
+            OptimizeTriangleOrder(&indices[firstTriangle * 3], std::min(c_clusterTriangles, numTriangles - firstTriangle), localIndex);
+        }
+
+        // Order the vertices by first use (welded and unused vertices are removed)
+        ReorderVertices(vertices, indices);
+
+        stats.numUniqueVertices += vertices.size();
+        stats.numCacheMissesAfter += GetCacheMisses(indices.data(), indices.size(), vertices.size());
+    }
+
+    /**
+     * Pack a vertex into the packed vertex format (see Graphics::PackedVertex).
+     * Positions are not quantized, so ray tracing acceleration structures are built from the same positions in either format.
+     */
+    Graphics::PackedVertex PackVertex(const Graphics::Vertex& vertex)
+    {
+        Graphics::PackedVertex packed;
+        packed.position = vertex.position;
+        packed.normal = PackOctahedral(vertex.normal, 0xFFFF);
+        packed.tangent = PackOctahedral({ vertex.tangent.x, vertex.tangent.y, vertex.tangent.z }, 0x7FFF) | ((vertex.tangent.w < 0.f) ? 0x80000000 : 0);
+        packed.uv0 = static_cast<uint32_t>(PackedVector::XMConvertFloatToHalf(vertex.uv0.x));
+        packed.uv0 |= static_cast<uint32_t>(PackedVector::XMConvertFloatToHalf(vertex.uv0.y)) << 16;
+        return packed;
+    }
+
+    /**
+     * Unpack a packed vertex into the full vertex format.
+     * Complement of PackVertex(), matches the vertex loads in RayTracing.hlsl.
+     */
+    Graphics::Vertex UnpackVertex(const Graphics::PackedVertex& packed)
+    {
+        Graphics::Vertex vertex;
+        vertex.position = packed.position;
+        vertex.normal = UnpackOctahedral(packed.normal, 0xFFFF);
+
+        float3 tangent = UnpackOctahedral(packed.tangent & 0x7FFFFFFF, 0x7FFF);
+        vertex.tangent = { tangent.x, tangent.y, tangent.z, (packed.tangent & 0x80000000) ? -1.f : 1.f };
+        vertex.uv0.x = PackedVector::XMConvertHalfToFloat(static_cast<PackedVector::HALF>(packed.uv0 & 0xFFFF));
+        vertex.uv0.y = PackedVector::XMConvertHalfToFloat(static_cast<PackedVector::HALF>(packed.uv0 >> 16));
+        return vertex;
+    }
+
+    /**
+     * Pack a mesh primitive's vertices and validate the packed vertices against the originals.
+     * Returns false (and the vertices should be stored in the full vertex format) when a normal or tangent direction,
+     * tangent handedness, or texture coordinate does not survive the round trip within the error limits.
+     */
+    bool PackVertices(const std::vector<Graphics::Vertex>& vertices, std::vector<Graphics::PackedVertex>& packed, PackStats& stats)
+    {
+        stats.numPrimitives++;
+
+        float maxNormalError = 0.f;
+        float maxTangentError = 0.f;
+        float maxUVError = 0.f;
+
+        packed.resize(vertices.size());
+        for (size_t vertexIndex = 0; vertexIndex < vertices.size(); vertexIndex++)
+        {
+            const Graphics::Vertex& vertex = vertices[vertexIndex];
+            packed[vertexIndex] = PackVertex(vertex);
+
+            Graphics::Vertex unpacked = UnpackVertex(packed[vertexIndex]);
+            float3 tangent = { vertex.tangent.x, vertex.tangent.y, vertex.tangent.z };
+            float3 unpackedTangent = { unpacked.tangent.x, unpacked.tangent.y, unpacked.tangent.z };
+
+            float normalError = GetAngleError(vertex.normal, unpacked.normal);
+            float tangentError = GetAngleError(tangent, unpackedTangent);
+            if ((packed[vertexIndex].tangent & 0x7FFFFFFF) != 0 && vertex.tangent.w != unpacked.tangent.w) tangentError = 180.f;
+            float uvError = std::max(fabsf(vertex.uv0.x - unpacked.uv0.x), fabsf(vertex.uv0.y - unpacked.uv0.y));
+
+            // Errors that are not numbers (from non-finite inputs) fail the comparisons below
+            if (!(normalError <= c_maxPackedAngleError) || !(tangentError <= c_maxPackedAngleError) || !(uvError <= c_maxPackedUVError)) return false;
+
+            maxNormalError = std::max(maxNormalError, normalError);
+            maxTangentError = std::max(maxTangentError, tangentError);
+            maxUVError = std::max(maxUVError, uvError);
+        }
+
+        stats.numPackedPrimitives++;
+        stats.numBytesBefore += vertices.size() * sizeof(Graphics::Vertex);
+        stats.numBytesAfter += packed.size() * sizeof(Graphics::PackedVertex);
+        stats.maxNormalError = std::max(stats.maxNormalError, maxNormalError);
+        stats.maxTangentError = std::max(stats.maxTangentError, maxTangentError);
+        stats.maxUVError = std::max(stats.maxUVError, maxUVError);
+        return true;
+    }
+
 }
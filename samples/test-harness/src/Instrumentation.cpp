@@ -20,23 +20,6 @@ namespace Instrumentation
     // Private Functions
     //----------------------------------------------------------------------------------------------------------
 
-    int64_t GetPerfCounter()
-    {
-    #if defined(_WIN32) || defined(WIN32)
-        LARGE_INTEGER value;
-        QueryPerformanceCounter(&value);
-        return value.QuadPart;
-    #elif __linux__
-        timespec ts;
-        int result = -1;
-        while(result < 0)
-        {
-            result = clock_gettime(CLOCK_REALTIME, &ts);
-        }
-        return (ts.tv_sec * 1.0e9) + ts.tv_nsec;
-    #endif
-    }
-
 #if defined(_WIN32) || defined(WIN32)
     int64_t GetPerfCounterFrequency()
     {
@@ -45,28 +28,84 @@ namespace Instrumentation
         return value.QuadPart;
     }
 
-    static int64_t frequency = GetPerfCounterFrequency();
+    // Frequency is ticks per second
+    static const double millisecondsPerTick = 1000.0 / static_cast<double>(GetPerfCounterFrequency());
+#elif __linux__
+    // Performance counter ticks are nanoseconds on Linux
+    static const double millisecondsPerTick = 0.000001;
 #endif
 
     /**
-     * Get the number of milliseconds between the timer's start and the current time.
+     * Add a sample to the stat's distribution.
      */
-    void GetElapsed(Stat* s)
+    void Record(Stat* s, double value)
     {
-    #if defined(_WIN32) || defined(WIN32)
-        // Frequency is ticks per second, so elapsed ticks / frequency = seconds
-        uint64_t seconds = (GetPerfCounter() - s->timestamp);
-        s->elapsed += (static_cast<double>(seconds) / static_cast<double>(frequency)) * 1000;
-    #elif __linux__
-        // GetPerfCounter times are in nanoseconds on Linux
-        s->elapsed += (GetPerfCounter() - s->timestamp) * 0.000001;
-    #endif
+        s->numSamples++;
+        if (s->numSamples == 1)
+        {
+            s->minimum = s->maximum = value;
+        }
+        else
+        {
+            s->minimum = std::min(s->minimum, value);
+            s->maximum = std::max(s->maximum, value);
+        }
+
+        double delta = value - s->mean;
+        s->mean += delta / static_cast<double>(s->numSamples);
+        s->m2 += delta * (value - s->mean);
+
+        if (s->histogram) s->histogram[GetHistogramBucket(value)]++;
     }
 
     //----------------------------------------------------------------------------------------------------------
     // Public Functions
     //----------------------------------------------------------------------------------------------------------
 
+    uint32_t GetHistogramBucket(double value)
+    {
+        double scaled = value / HistogramMinValue;
+        if (!(scaled >= 1.0)) return 0;     // also NaN
+
+        // scaled = mantissa * 2^exponent, with mantissa in [0.5, 1)
+        int exponent;
+        double mantissa = frexp(scaled, &exponent);
+        uint32_t octave = static_cast<uint32_t>(exponent - 1);
+        if (octave >= HistogramOctaves) return HistogramBuckets - 1;
+
+        uint32_t subBucket = std::min(static_cast<uint32_t>(((mantissa * 2.0) - 1.0) * HistogramSubBuckets), HistogramSubBuckets - 1);
+        return 1 + (octave * HistogramSubBuckets) + subBucket;
+    }
+
+    double GetHistogramBucketValue(uint32_t bucket)
+    {
+        if (bucket == 0) return 0;
+        if (bucket >= HistogramBuckets - 1) return ldexp(HistogramMinValue, HistogramOctaves);
+
+        uint32_t octave = (bucket - 1) / HistogramSubBuckets;
+        uint32_t subBucket = (bucket - 1) % HistogramSubBuckets;
+        return ldexp(HistogramMinValue, static_cast<int>(octave)) * (1.0 + ((subBucket + 0.5) / HistogramSubBuckets));
+    }
+
+    int64_t GetPerfCounter()
+    {
+    #if defined(_WIN32) || defined(WIN32)
+        LARGE_INTEGER value;
+        QueryPerformanceCounter(&value);
+        return value.QuadPart;
+    #elif __linux__
+        // CLOCK_MONOTONIC_RAW isn't slewed by NTP (unlike CLOCK_REALTIME, which also jumps when the time is set)
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        return (static_cast<int64_t>(ts.tv_sec) * 1000000000) + ts.tv_nsec;
+    #endif
+    }
+
+    double GetPerfCounterMilliseconds(int64_t ticks)
+    {
+        return static_cast<double>(ticks) * millisecondsPerTick;
+    }
+
     uint32_t Stat::frameGPUQueryCount = 0;
 
     int32_t Stat::GetGPUQueryBeginIndex()
@@ -87,6 +126,106 @@ namespace Instrumentation
         gpuQueryStartIndex = gpuQueryEndIndex = -1;
     }
 
+    double Stat::GetPercentile(double percentile) const
+    {
+        if (numSamples == 0) return 0;
+        if (histogram == nullptr) return (percentile < 50) ? minimum : maximum;
+
+        // The rank of the percentile's sample (nearest rank)
+        double rank = ceil((std::min(std::max(percentile, (double)0), (double)100) / 100) * static_cast<double>(numSamples));
+        uint64_t target = std::max(static_cast<uint64_t>(rank), static_cast<uint64_t>(1));
+        if (target == 1) return minimum;
+        if (target >= numSamples) return maximum;
+
+        uint64_t count = 0;
+        for (uint32_t bucket = 0; bucket < HistogramBuckets; bucket++)
+        {
+            count += histogram[bucket];
+            if (count >= target) return std::min(std::max(GetHistogramBucketValue(bucket), minimum), maximum);
+        }
+        return maximum;
+    }
+
+    Performance::Performance()
+    {
+        cpuTimes.reserve(MaxStats);
+        gpuTimes.reserve(MaxStats);
+        histograms.assign(static_cast<size_t>(MaxStats) * HistogramBuckets, 0);
+        ReserveSamples(DefaultSampleSize);
+    }
+
+    /**
+     * Grow the sample rings to hold at least sampleSize samples per stat. Growing discards the stats' samples.
+     */
+    void Performance::ReserveSamples(uint32_t sampleSize)
+    {
+        if (sampleSize <= sampleCapacity) return;
+
+        sampleCapacity = sampleSize;
+        samples.assign(static_cast<size_t>(MaxStats) * sampleCapacity, 0);
+        for (uint32_t statIndex = 0; statIndex < numStats; statIndex++)
+        {
+            stats[statIndex].samples = &samples[static_cast<size_t>(statIndex) * sampleCapacity];
+            stats[statIndex].Reset(stats[statIndex].sampleSize);
+        }
+    }
+
+    Stat* Performance::CreateStat(EStatType type, std::string name, uint32_t sampleSize)
+    {
+        assert(numStats < MaxStats);
+        if (numStats >= MaxStats) return &overflow;
+
+        ReserveSamples(sampleSize);
+
+        Stat* stat = &stats[numStats];
+        stat->name = name;
+        stat->type = type;
+        stat->samples = &samples[static_cast<size_t>(numStats) * sampleCapacity];
+        stat->histogram = &histograms[static_cast<size_t>(numStats) * HistogramBuckets];
+        stat->Reset(sampleSize);
+        stat->ResetGPUQueryIndices();
+        numStats++;
+        return stat;
+    }
+
+    Stat* Performance::AddCPUStat(std::string name, uint32_t sampleSize)
+    {
+        Stat* stat = CreateStat(EStatType::CPU, name, sampleSize);
+        if (stat != &overflow) cpuTimes.push_back(stat);
+        return stat;
+    }
+
+    Stat* Performance::AddGPUStat(std::string name, uint32_t sampleSize)
+    {
+        Stat* stat = CreateStat(EStatType::GPU, name, sampleSize);
+        if (stat != &overflow) gpuTimes.push_back(stat);
+        return stat;
+    }
+
+    void Performance::Reset(uint32_t sampleSize)
+    {
+        ReserveSamples(sampleSize);
+        for (uint32_t statIndex = 0; statIndex < numStats; statIndex++)
+        {
+            stats[statIndex].Reset(sampleSize);
+        }
+    }
+
+    void Performance::Cleanup()
+    {
+        for (uint32_t statIndex = 0; statIndex < numStats; statIndex++)
+        {
+            stats[statIndex].name = "";
+            stats[statIndex].samples = nullptr;
+            stats[statIndex].histogram = nullptr;
+            stats[statIndex].Reset();
+        }
+        numStats = 0;
+
+        cpuTimes.clear();
+        gpuTimes.clear();
+    }
+
     void Begin(Stat* s)
     {
         s->elapsed = 0;
@@ -95,19 +234,36 @@ namespace Instrumentation
 
     void End(Stat* s)
     {
-        GetElapsed(s);
+        s->elapsed += GetPerfCounterMilliseconds(GetPerfCounter() - s->timestamp);
     }
 
     void Resolve(Stat* s)
     {
+        Record(s, s->elapsed);
+
+        // Stats without a sample ring average their last sample
+        if (s->samples == nullptr || s->sampleSize == 0)
+        {
+            s->total = s->average = std::max(s->elapsed, (double)0);
+            return;
+        }
+
+        // Replace the oldest sample once the ring is full
+        if (s->sampleCount == s->sampleSize) s->total -= s->samples[s->sampleHead];
+        else s->sampleCount++;
+
+        s->samples[s->sampleHead] = s->elapsed;
         s->total += s->elapsed;
-        if (static_cast<uint32_t>(s->samples.size()) >= s->sampleSize)
+        s->sampleHead = (s->sampleHead + 1 == s->sampleSize) ? 0 : s->sampleHead + 1;
+
+        // Sum the samples once per pass over the ring, so rounding errors of the running total don't accumulate
+        if (s->sampleHead == 0)
         {
-            s->total -= s->samples.front();
-            s->samples.pop();
+            s->total = 0;
+            for (uint32_t sampleIndex = 0; sampleIndex < s->sampleCount; sampleIndex++) s->total += s->samples[sampleIndex];
         }
-        s->samples.push(s->elapsed);
-        s->average = std::max(s->total / s->samples.size(), (double)0);
+
+        s->average = std::max(s->total / s->sampleCount, (double)0);
     }
 
     void EndAndResolve(Stat* s)
@@ -116,6 +272,16 @@ namespace Instrumentation
         Resolve(s);
     }
 
+    /**
+     * Collect the time recorded by ScopedTimers (on any thread) since the last call as a sample of the stat.
+     * Call from one thread, once per frame, after the timed jobs have completed.
+     */
+    void ResolveScopedTimers(Stat* s)
+    {
+        s->elapsed = GetPerfCounterMilliseconds(s->scopedTicks.exchange(0, std::memory_order_relaxed));
+        Resolve(s);
+    }
+
     std::ostream& operator<<(std::ostream& os, Stat* stat)
     {
         if(stat) os << stat->elapsed;
@@ -9,6 +9,7 @@
 */
 
 #include "Caches.h"
+#include "Geometry.h"
 #include "Scenes.h"
 #include "UI.h"
 
@@ -185,14 +186,6 @@ namespace Scenes
             // Add the new node to the scene graph
             scene.nodes.push_back(node);
         }
-
-        // Traverse the scene graph and update instance transforms
-        for (size_t rootIndex = 0; rootIndex < scene.rootNodes.size(); rootIndex++)
-        {
-            XMMATRIX transform = XMMatrixIdentity();
-            int nodeIndex = scene.rootNodes[rootIndex];
-            Traverse(nodeIndex, transform, scene);
-        }
     }
 
     /**
@@ -255,11 +248,49 @@ namespace Scenes
         }
     }
 
+    /**
+     * Hash the configuration settings that affect how a scene is imported.
+     */
+    uint64_t GetImportConfigHash(const Configs::Config& config)
+    {
+        uint64_t hash = Caches::Hash(config.scene.file.c_str(), config.scene.file.size());
+
+    #if defined(__x86_64__) || defined(_M_X64)
+        uint32_t compressTextures = 1;
+    #else
+        uint32_t compressTextures = 0;
+    #endif
+        hash = Caches::Hash(&compressTextures, sizeof(uint32_t), hash);
+
+        uint32_t optimizeMeshes = config.scene.optimizeMeshes ? 1 : 0;
+        hash = Caches::Hash(&optimizeMeshes, sizeof(uint32_t), hash);
+
+        uint32_t packVertices = config.scene.packVertices ? 1 : 0;
+        return Caches::Hash(&packVertices, sizeof(uint32_t), hash);
+    }
+
+    /**
+     * Find the asset of the given type and filepath in the (previously cached) scene.
+     */
+    const Asset* FindAsset(const Scene& scene, EAssetType type, const std::string& filepath)
+    {
+        for (const Asset& asset : scene.assets)
+        {
+            if (asset.type == type && asset.filepath == filepath) return &asset;
+        }
+        return nullptr;
+    }
+
     /**
      * Parse glTF textures and load the images.
+     * Textures whose image files are unchanged since the previous import are copied from the previous scene.
+     * The other textures are loaded, mipmapped, and compressed in parallel.
      */
-    bool ParseGLFTextures(const tinygltf::Model& gltfData, const Configs::Config& config, Scene& scene)
+    bool ParseGLFTextures(const tinygltf::Model& gltfData, const Configs::Config& config, const Scene& previous, bool reuse, Scene& scene)
     {
+        std::string directory = config.app.root + config.scene.path;
+        std::vector<uint32_t> imports;
+
         for (uint32_t textureIndex = 0; textureIndex < static_cast<uint32_t>(gltfData.textures.size()); textureIndex++)
         {
             // Get the GLTF texture
@@ -277,31 +308,227 @@ namespace Scenes
             texture.SetName(gltfTexture.name);
 
             // Construct the texture image filepath
-            texture.filepath = config.app.root + config.scene.path + ParseURI(gltfImage.uri);
+            texture.filepath = directory + ParseURI(gltfImage.uri);
 
-            // Load the texture from disk
-            if (!Textures::Load(texture)) return false;
+            // Hash the texture image file
+            Asset asset;
+            asset.type = EAssetType::IMAGE;
+            asset.index = static_cast<int>(scene.textures.size());
+            asset.filepath = ParseURI(gltfImage.uri);
 
-        #if defined(WIN32) && defined(__x86_64__) || defined(_M_X64)
-            // Generate mipmaps and compress the texture (Windows only)
-            if(!Textures::MipmapAndCompress(texture)) return false;
-        #endif
+            const Asset* previousAsset = FindAsset(previous, EAssetType::IMAGE, asset.filepath);
+            if (!Caches::UpdateAsset(directory, asset, previousAsset)) previousAsset = nullptr;
+
+            if (reuse && previousAsset && previousAsset->hash == asset.hash && previousAsset->index < static_cast<int>(previous.textures.size()))
+            {
+                // The image is unchanged, copy the previously imported (mipmapped and compressed) texture
+                const Textures::Texture& cached = previous.textures[previousAsset->index];
+                texture.type = cached.type;
+                texture.format = cached.format;
+                texture.width = cached.width;
+                texture.height = cached.height;
+                texture.stride = cached.stride;
+                texture.mips = cached.mips;
+                texture.texelBytes = cached.texelBytes;
+                texture.texels = new uint8_t[texture.texelBytes];
+                memcpy(texture.texels, cached.texels, texture.texelBytes);
+                texture.cached = true;
+            }
+            else
+            {
+                // The image is new or changed, import it below
+                imports.push_back(static_cast<uint32_t>(scene.textures.size()));
+            }
 
             // Add the texture to the scene
             scene.textures.push_back(texture);
+            scene.assets.push_back(asset);
         }
+
+        if (imports.empty()) return true;
+
+    #if defined(__x86_64__) || defined(_M_X64)
+        // Load, generate mipmaps for, and compress the new and changed textures
+        std::vector<Textures::Texture*> textures;
+        for (uint32_t textureIndex : imports) textures.push_back(&scene.textures[textureIndex]);
+        return Textures::Import(textures.data(), static_cast<uint32_t>(textures.size()));
+    #else
+        std::string msg = "\nScene texture mipmapping and compression not supported on ARM64. Load a scene cache file instead of *.gltf!\n";
+        Graphics::UI::MessageBox(msg);
+        return false;
+    #endif
+    }
+
+    /**
+     * The elements of a glTF accessor: count elements of elementSize bytes, stride bytes apart.
+     */
+    struct AccessorData
+    {
+        const uint8_t* data = nullptr;
+        size_t elementSize = 0;
+        size_t stride = 0;
+        size_t count = 0;
+    };
+
+    /**
+     * Get the accessor index of a mesh primitive's vertex attribute, or -1 if the primitive doesn't have the attribute.
+     */
+    int GetAttributeAccessor(const tinygltf::Primitive& p, const char* attribute)
+    {
+        auto it = p.attributes.find(attribute);
+        return (it == p.attributes.end()) ? -1 : it->second;
+    }
+
+    /**
+     * Get the location and layout of an accessor's elements in its buffer. Handles tightly packed and interleaved buffer views.
+     */
+    bool GetAccessorData(const tinygltf::Model& gltfData, int accessorIndex, AccessorData& accessorData)
+    {
+        accessorData = {};
+        if (accessorIndex < 0 || accessorIndex >= static_cast<int>(gltfData.accessors.size())) return false;
+
+        const tinygltf::Accessor& accessor = gltfData.accessors[accessorIndex];
+        if (accessor.bufferView < 0 || accessor.bufferView >= static_cast<int>(gltfData.bufferViews.size())) return false;
+
+        const tinygltf::BufferView& bufferView = gltfData.bufferViews[accessor.bufferView];
+        if (bufferView.buffer < 0 || bufferView.buffer >= static_cast<int>(gltfData.buffers.size())) return false;
+
+        const tinygltf::Buffer& buffer = gltfData.buffers[bufferView.buffer];
+
+        int elementSize = tinygltf::GetComponentSizeInBytes(accessor.componentType) * tinygltf::GetNumComponentsInType(accessor.type);
+        if (elementSize <= 0) return false;
+
+        size_t stride = (bufferView.byteStride > 0) ? bufferView.byteStride : static_cast<size_t>(elementSize);
+        size_t offset = bufferView.byteOffset + accessor.byteOffset;
+        size_t size = (accessor.count > 0) ? ((accessor.count - 1) * stride) + elementSize : 0;
+        if (offset > buffer.data.size() || size > (buffer.data.size() - offset)) return false;
+
+        accessorData.data = buffer.data.data() + offset;
+        accessorData.elementSize = static_cast<size_t>(elementSize);
+        accessorData.stride = stride;
+        accessorData.count = accessor.count;
         return true;
     }
 
+    /**
+     * Copy count elements of Size bytes between strided arrays, e.g. from a (possibly interleaved) glTF buffer view to
+     * one attribute of packed vertices. The fixed size copies compile to one or two vector loads and stores per element.
+     */
+    template<size_t Size>
+    void CopyStrided(uint8_t* dst, size_t dstStride, const uint8_t* src, size_t srcStride, size_t count)
+    {
+        for (size_t index = 0; index < count; index++)
+        {
+            memcpy(dst, src, Size);
+            dst += dstStride;
+            src += srcStride;
+        }
+    }
+
+    /**
+     * Convert count indices of type T to full precision (for easy use on GPU).
+     */
+    template<typename T>
+    void WidenIndices(uint32_t* dst, const uint8_t* src, size_t srcStride, size_t count)
+    {
+        for (size_t index = 0; index < count; index++)
+        {
+            T value;
+            memcpy(&value, src, sizeof(T));
+            dst[index] = static_cast<uint32_t>(value);
+            src += srcStride;
+        }
+    }
+
+    /**
+     * Convert vertices from the glTF coordinate system to the chosen coordinate system and compute their bounding box.
+     */
+    void ConvertVertices(Graphics::Vertex* vertices, size_t numVertices, rtxgi::AABB& boundingBox)
+    {
+        for (size_t vertexIndex = 0; vertexIndex < numVertices; vertexIndex++)
+        {
+            Graphics::Vertex& v = vertices[vertexIndex];
+
+        #if (COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT) || (COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT_Z_UP)
+            // Invert the z-coordinate to convert from right hand to left hand
+            v.position.z *= -1.f;
+            v.normal.z *= -1.f;
+            v.tangent.z *= -1.f;
+        #endif
+
+        #if COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT_Z_UP
+            // Convert to left hand, z-up (unreal)
+            v.position = { v.position.z, v.position.x, v.position.y };
+            v.normal = { v.normal.z, v.normal.x, v.normal.y };
+            v.tangent = { v.tangent.z, v.tangent.x, v.tangent.y, v.tangent.w };
+        #elif COORDINATE_SYSTEM == COORDINATE_SYSTEM_RIGHT_Z_UP
+            // Convert to right hand, z-up
+            v.position = { v.position.x, -v.position.z, v.position.y };
+            v.normal = { v.normal.x, -v.normal.z, v.normal.y };
+            v.tangent = { v.tangent.x, -v.tangent.z, v.tangent.y, v.tangent.w };
+        #endif
+
+            boundingBox.min = rtxgi::Min(boundingBox.min, v.position);
+            boundingBox.max = rtxgi::Max(boundingBox.max, v.position);
+        }
+    }
+
+    /**
+     * Hash the glTF data a mesh is imported from: its primitives' materials and vertex / index data.
+     */
+    uint64_t HashGLTFMesh(const tinygltf::Model& gltfData, const tinygltf::Mesh& gltfMesh, const Scene& scene)
+    {
+        const char* attributes[] = { "POSITION", "NORMAL", "TANGENT", "TEXCOORD_0" };
+
+        uint64_t hash = 0;
+        for (const tinygltf::Primitive& p : gltfMesh.primitives)
+        {
+            // Material (and its alpha mode, which determines opacity)
+            int material = (p.material == -1) ? 0 : p.material;
+            int alphaMode = (material < static_cast<int>(scene.materials.size())) ? scene.materials[material].data.alphaMode : 0;
+            hash = Caches::Hash(&material, sizeof(int), hash);
+            hash = Caches::Hash(&alphaMode, sizeof(int), hash);
+
+            // Vertex attributes and indices
+            for (uint32_t attributeIndex = 0; attributeIndex <= 4; attributeIndex++)
+            {
+                int accessorIndex = (attributeIndex < 4) ? GetAttributeAccessor(p, attributes[attributeIndex]) : p.indices;
+                hash = Caches::Hash(&accessorIndex, sizeof(int), hash);
+
+                AccessorData accessorData;
+                if (!GetAccessorData(gltfData, accessorIndex, accessorData)) continue;
+
+                const tinygltf::Accessor& accessor = gltfData.accessors[accessorIndex];
+                size_t size = (accessorData.count > 0) ? ((accessorData.count - 1) * accessorData.stride) + accessorData.elementSize : 0;
+
+                uint64_t layout[] = { static_cast<uint64_t>(accessor.componentType), static_cast<uint64_t>(accessor.type), accessor.count };
+                hash = Caches::Hash(layout, sizeof(layout), hash);
+                hash = Caches::Hash(accessorData.data, size, hash);
+            }
+        }
+        return hash;
+    }
+
     /**
      * Parse the glTF meshes.
+     * Vertex attributes are converted straight from the glTF buffers into packed vertices, one mesh primitive at a time,
+     * and each primitive's data is streamed to the scene cache file. Only one primitive's vertices and indices are held
+     * in memory at once; the scene's mesh data is read back from the (memory-mapped) cache file once the import completes.
+     * When enabled, each mesh primitive is optimized (see Geometry::Optimize()) and its vertices are packed
+     * (see Geometry::PackVertices()) before it is streamed.
+     * Meshes whose glTF data is unchanged since the previous import are streamed from the previous scene.
      */
-    void ParseGLTFMeshes(const tinygltf::Model& gltfData, Scene& scene)
+    bool ParseGLTFMeshes(const tinygltf::Model& gltfData, const Configs::Config& config, const Scene& previous, bool reuse, Caches::Stream& stream, Scene& scene, Geometry::OptimizeStats& stats, Geometry::PackStats& packStats)
     {
         // Note: GTLF 2.0's default coordinate system is Right Handed, Y-Up
         // https://github.com/KhronosGroup/glTF/tree/master/specification/2.0#coordinate-system-and-units
         // Meshes are converted from this coordinate system to the chosen coordinate system.
 
+        // Vertex and index data of the mesh primitive being converted (reused by all primitives)
+        std::vector<Graphics::Vertex> vertices;
+        std::vector<Graphics::PackedVertex> packedVertices;
+        std::vector<uint32_t> indices;
+
         uint32_t geometryIndex = 0;
         for (uint32_t meshIndex = 0; meshIndex < static_cast<uint32_t>(gltfData.meshes.size()); meshIndex++)
         {
@@ -317,6 +544,40 @@ namespace Scenes
             mesh.boundingBox.min = { FLT_MAX, FLT_MAX, FLT_MAX };
             mesh.boundingBox.max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
 
+            mesh.hash = HashGLTFMesh(gltfData, gltfMesh, scene);
+            if (reuse && meshIndex < static_cast<uint32_t>(previous.meshes.size()) && previous.meshes[meshIndex].hash == mesh.hash)
+            {
+                // The mesh is unchanged, stream the previously imported mesh primitives
+                const Mesh& cached = previous.meshes[meshIndex];
+                for (const MeshPrimitive& primitive : cached.primitives)
+                {
+                    MeshPrimitive mp;
+                    mp.index = geometryIndex;
+                    mp.material = primitive.material;
+                    mp.opaque = primitive.opaque;
+                    mp.doubleSided = primitive.doubleSided;
+                    mp.vertexFormat = primitive.vertexFormat;
+                    mp.vertexByteOffset = primitive.vertexByteOffset;
+                    mp.indexByteOffset = primitive.indexByteOffset;
+                    mp.boundingBox = primitive.boundingBox;
+                    if (!Caches::WritePrimitive(stream, mp, primitive.GetVertexData(), primitive.GetNumVertices(), primitive.GetIndices(), primitive.GetNumIndices())) return false;
+
+                    mesh.numVertices += primitive.GetNumVertices();
+                    mesh.numIndices += primitive.GetNumIndices();
+                    scene.numTriangles += mesh.numIndices / 3;
+
+                    mesh.boundingBox.min = rtxgi::Min(mesh.boundingBox.min, mp.boundingBox.min);
+                    mesh.boundingBox.max = rtxgi::Max(mesh.boundingBox.max, mp.boundingBox.max);
+
+                    mesh.primitives.push_back(mp);
+                    geometryIndex++;
+                }
+
+                mesh.index = static_cast<int>(scene.meshes.size());
+                scene.meshes.push_back(mesh);
+                continue;
+            }
+
             uint32_t vertexByteOffset = 0;
             uint32_t indexByteOffset = 0;
             for (uint32_t primitiveIndex = 0; primitiveIndex < static_cast<uint32_t>(gltfMesh.primitives.size()); primitiveIndex++)
@@ -342,211 +603,78 @@ namespace Scenes
                 const Material& mat = scene.materials[mp.material];
                 if (mat.data.alphaMode != 0) mp.opaque = false;
 
-                // Get data indices
-                int indicesIndex = p.indices;
-                int positionIndex = -1;
-                int normalIndex = -1;
-                int tangentIndex = -1;
-                int uv0Index = -1;
-
-                if (p.attributes.count("POSITION") > 0)
-                {
-                    positionIndex = p.attributes.at("POSITION");
-                }
-
-                if (p.attributes.count("NORMAL") > 0)
-                {
-                    normalIndex = p.attributes.at("NORMAL");
-                }
-
-                if (p.attributes.count("TANGENT"))
-                {
-                    tangentIndex = p.attributes.at("TANGENT");
-                }
-
-                if (p.attributes.count("TEXCOORD_0") > 0)
-                {
-                    uv0Index = p.attributes.at("TEXCOORD_0");
-                }
-
-                // Vertex positions
-                const tinygltf::Accessor& positionAccessor = gltfData.accessors[positionIndex];
-                const tinygltf::BufferView& positionBufferView = gltfData.bufferViews[positionAccessor.bufferView];
-                const tinygltf::Buffer& positionBuffer = gltfData.buffers[positionBufferView.buffer];
-                const uint8_t* positionBufferAddress = positionBuffer.data.data();
-                int positionStride = tinygltf::GetComponentSizeInBytes(positionAccessor.componentType) * tinygltf::GetNumComponentsInType(positionAccessor.type);
-                assert(positionStride == 12);
-
-                // Vertex indices
-                const tinygltf::Accessor& indexAccessor = gltfData.accessors[indicesIndex];
-                const tinygltf::BufferView& indexBufferView = gltfData.bufferViews[indexAccessor.bufferView];
-                const tinygltf::Buffer& indexBuffer = gltfData.buffers[indexBufferView.buffer];
-                const uint8_t* indexBufferAddress = indexBuffer.data.data();
-                int indexStride = tinygltf::GetComponentSizeInBytes(indexAccessor.componentType) * tinygltf::GetNumComponentsInType(indexAccessor.type);
-                mp.indices.resize(indexAccessor.count);
-
-                // Vertex normals
-                tinygltf::Accessor normalAccessor;
-                tinygltf::BufferView normalBufferView;
-                const uint8_t* normalBufferAddress = nullptr;
-                int normalStride = -1;
-                if (normalIndex > -1)
+                // Get the vertex attribute data (positions are required, other attributes are optional)
+                AccessorData positions, normals, tangents, uv0s;
+                if (!GetAccessorData(gltfData, GetAttributeAccessor(p, "POSITION"), positions) || positions.elementSize != sizeof(float3)) return false;
+                GetAccessorData(gltfData, GetAttributeAccessor(p, "NORMAL"), normals);
+                GetAccessorData(gltfData, GetAttributeAccessor(p, "TANGENT"), tangents);
+                GetAccessorData(gltfData, GetAttributeAccessor(p, "TEXCOORD_0"), uv0s);
+
+                // Convert the vertex attributes into packed vertices
+                size_t numVertices = positions.count;
+                vertices.assign(numVertices, Graphics::Vertex());
+
+                uint8_t* base = reinterpret_cast<uint8_t*>(vertices.data());
+                const size_t vertexStride = sizeof(Graphics::Vertex);
+                CopyStrided<sizeof(float3)>(base + offsetof(Graphics::Vertex, position), vertexStride, positions.data, positions.stride, numVertices);
+                if (normals.elementSize == sizeof(float3))
                 {
-                    normalAccessor = gltfData.accessors[normalIndex];
-                    normalBufferView = gltfData.bufferViews[normalAccessor.bufferView];
-                    normalStride = tinygltf::GetComponentSizeInBytes(normalAccessor.componentType) * tinygltf::GetNumComponentsInType(normalAccessor.type);
-                    assert(normalStride == 12);
-
-                    const tinygltf::Buffer& normalBuffer = gltfData.buffers[normalBufferView.buffer];
-                    normalBufferAddress = normalBuffer.data.data();
+                    CopyStrided<sizeof(float3)>(base + offsetof(Graphics::Vertex, normal), vertexStride, normals.data, normals.stride, std::min(normals.count, numVertices));
                 }
-
-                // Vertex tangents
-                tinygltf::Accessor tangentAccessor;
-                tinygltf::BufferView tangentBufferView;
-                const uint8_t* tangentBufferAddress = nullptr;
-                int tangentStride = -1;
-                if (tangentIndex > -1)
+                if (tangents.elementSize == sizeof(float4))
                 {
-                    tangentAccessor = gltfData.accessors[tangentIndex];
-                    tangentBufferView = gltfData.bufferViews[tangentAccessor.bufferView];
-                    tangentStride = tinygltf::GetComponentSizeInBytes(tangentAccessor.componentType) * tinygltf::GetNumComponentsInType(tangentAccessor.type);
-                    assert(tangentStride == 16);
-
-                    const tinygltf::Buffer& tangentBuffer = gltfData.buffers[tangentBufferView.buffer];
-                    tangentBufferAddress = tangentBuffer.data.data();
+                    CopyStrided<sizeof(float4)>(base + offsetof(Graphics::Vertex, tangent), vertexStride, tangents.data, tangents.stride, std::min(tangents.count, numVertices));
                 }
-
-                // Vertex texture coordinates
-                tinygltf::Accessor uv0Accessor;
-                tinygltf::BufferView uv0BufferView;
-                const uint8_t* uv0BufferAddress = nullptr;
-                int uv0Stride = -1;
-                if (uv0Index > -1)
+                if (uv0s.elementSize == sizeof(float2))
                 {
-                    uv0Accessor = gltfData.accessors[uv0Index];
-                    uv0BufferView = gltfData.bufferViews[uv0Accessor.bufferView];
-                    uv0Stride = tinygltf::GetComponentSizeInBytes(uv0Accessor.componentType) * tinygltf::GetNumComponentsInType(uv0Accessor.type);
-                    assert(uv0Stride == 8);
-
-                    const tinygltf::Buffer& uv0Buffer = gltfData.buffers[uv0BufferView.buffer];
-                    uv0BufferAddress = uv0Buffer.data.data();
-                }
-
-                // Get the vertex data
-                for (uint32_t vertexIndex = 0; vertexIndex < static_cast<uint32_t>(positionAccessor.count); vertexIndex++)
-                {
-                    Graphics::Vertex v;
-
-                    const uint8_t* address = positionBufferAddress + positionBufferView.byteOffset + positionAccessor.byteOffset + (vertexIndex * positionStride);
-                    memcpy(&v.position, address, positionStride);
-
-                #if (COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT) || (COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT_Z_UP)
-                    // Invert z-coordinate to convert from right hand to left hand
-                    v.position.z *= -1.f;
-                #endif
-
-                #if COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT_Z_UP
-                    // Convert to left hand, z-up (unreal)
-                    v.position = { v.position.z, v.position.x, v.position.y };
-                #elif COORDINATE_SYSTEM == COORDINATE_SYSTEM_RIGHT_Z_UP
-                    // Convert to right hand, z-up
-                    v.position = { v.position.x, -v.position.z, v.position.y };
-                #endif
-
-                    if (normalIndex > -1)
-                    {
-                        address = normalBufferAddress + normalBufferView.byteOffset + normalAccessor.byteOffset + (vertexIndex * normalStride);
-                        memcpy(&v.normal, address, normalStride);
-
-                    #if (COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT) || (COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT_Z_UP)
-                        // Invert the z-coordinate to convert from right hand to left hand
-                        v.normal.z *= -1.f;
-                    #endif
-
-                    #if COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT_Z_UP
-                        // Convert to left hand, z-up (unreal)
-                        v.normal = { v.normal.z, v.normal.x, v.normal.y };
-                    #elif COORDINATE_SYSTEM == COORDINATE_SYSTEM_RIGHT_Z_UP
-                        // Convert to right hand, z-up
-                        v.normal = { v.normal.x, -v.normal.z, v.normal.y };
-                    #endif
-                    }
-
-                    if (tangentIndex > -1)
-                    {
-                        address = tangentBufferAddress + tangentBufferView.byteOffset + tangentAccessor.byteOffset + (vertexIndex * tangentStride);
-                        memcpy(&v.tangent, address, tangentStride);
-
-                    #if COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT || COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT_Z_UP
-                        // Invert the z-coordinate to convert from right hand to left hand
-                        v.tangent.z *= -1.f;
-                    #endif
-
-                    #if COORDINATE_SYSTEM == COORDINATE_SYSTEM_LEFT_Z_UP
-                        // Convert to left hand, z-up (unreal)
-                        v.tangent = { v.tangent.z, v.tangent.x, v.tangent.y, v.tangent.w };
-                    #elif COORDINATE_SYSTEM == COORDINATE_SYSTEM_RIGHT_Z_UP
-                        // Convert to right hand, z-up
-                        v.tangent = { v.tangent.x, -v.tangent.z, v.tangent.y, v.tangent.w };
-                    #endif
-                    }
-
-                    if (uv0Index > -1)
-                    {
-                        address = uv0BufferAddress + uv0BufferView.byteOffset + uv0Accessor.byteOffset + (vertexIndex * uv0Stride);
-                        memcpy(&v.uv0, address, uv0Stride);
-                    }
-
-                    // Update the mesh primitive's bounding box
-                    mp.boundingBox.min = rtxgi::Min(mp.boundingBox.min, v.position);
-                    mp.boundingBox.max = rtxgi::Max(mp.boundingBox.max, v.position);
-
-                    mp.vertices.push_back(v);
-                    mesh.numVertices++;
+                    CopyStrided<sizeof(float2)>(base + offsetof(Graphics::Vertex, uv0), vertexStride, uv0s.data, uv0s.stride, std::min(uv0s.count, numVertices));
                 }
+                ConvertVertices(vertices.data(), numVertices, mp.boundingBox);
 
                 // Get the index data
                 // Indices can be either unsigned char, unsigned short, or unsigned long
                 // Converting to full precision for easy use on GPU
-                const uint8_t* baseAddress = indexBufferAddress + indexBufferView.byteOffset + indexAccessor.byteOffset;
-                if (indexStride == 1)
+                AccessorData indexData;
+                if (p.indices >= 0)
                 {
-                    std::vector<uint8_t> quarter;
-                    quarter.resize(indexAccessor.count);
-
-                    memcpy(quarter.data(), baseAddress, (indexAccessor.count * indexStride));
+                    if (!GetAccessorData(gltfData, p.indices, indexData)) return false;
 
-                    // Convert quarter precision indices to full precision
-                    for (size_t i = 0; i < indexAccessor.count; i++)
-                    {
-                        mp.indices[i] = quarter[i];
-                    }
+                    indices.resize(indexData.count);
+                    if (indexData.elementSize == sizeof(uint8_t)) WidenIndices<uint8_t>(indices.data(), indexData.data, indexData.stride, indexData.count);
+                    else if (indexData.elementSize == sizeof(uint16_t)) WidenIndices<uint16_t>(indices.data(), indexData.data, indexData.stride, indexData.count);
+                    else if (indexData.elementSize == sizeof(uint32_t)) WidenIndices<uint32_t>(indices.data(), indexData.data, indexData.stride, indexData.count);
+                    else return false;
                 }
-                else if (indexStride == 2)
+                else
                 {
-                    std::vector<uint16_t> half;
-                    half.resize(indexAccessor.count);
+                    // Non-indexed primitive
+                    indices.resize(numVertices);
+                    for (size_t index = 0; index < numVertices; index++) indices[index] = static_cast<uint32_t>(index);
+                }
 
-                    memcpy(half.data(), baseAddress, (indexAccessor.count * indexStride));
+                // Weld, sort, and reorder the mesh primitive's vertices and triangles
+                if (config.scene.optimizeMeshes) Geometry::Optimize(vertices, indices, stats);
 
-                    // Convert half precision indices to full precision
-                    for (size_t i = 0; i < indexAccessor.count; i++)
-                    {
-                        mp.indices[i] = half[i];
-                    }
-                }
-                else
+                // Pack the mesh primitive's vertices, unless the packed vertices are not accurate enough
+                const void* vertexData = vertices.data();
+                if (config.scene.packVertices && Geometry::PackVertices(vertices, packedVertices, packStats))
                 {
-                    memcpy(mp.indices.data(), baseAddress, (indexAccessor.count * indexStride));
+                    mp.vertexFormat = Graphics::VERTEX_FORMAT_PACKED;
+                    vertexData = packedVertices.data();
                 }
 
+                // Stream the mesh primitive's data to the scene cache file
+                uint32_t numPrimitiveVertices = static_cast<uint32_t>(vertices.size());
+                uint32_t numPrimitiveIndices = static_cast<uint32_t>(indices.size());
+                if (!Caches::WritePrimitive(stream, mp, vertexData, numPrimitiveVertices, indices.data(), numPrimitiveIndices)) return false;
+
                 // Update byte offsets
-                vertexByteOffset += static_cast<uint32_t>(mp.vertices.size()) * sizeof(Graphics::Vertex);
-                indexByteOffset += static_cast<uint32_t>(mp.indices.size()) * sizeof(UINT);
+                vertexByteOffset += numPrimitiveVertices * mp.GetVertexStride();
+                indexByteOffset += numPrimitiveIndices * sizeof(UINT);
 
-                // Increment the triangle count
-                mesh.numIndices += static_cast<int>(indexAccessor.count);
+                // Increment the vertex and triangle counts
+                mesh.numVertices += numPrimitiveVertices;
+                mesh.numIndices += numPrimitiveIndices;
                 scene.numTriangles += mesh.numIndices / 3;
 
                 // Update the mesh's bounding box
@@ -564,67 +692,124 @@ namespace Scenes
         }
 
         scene.numMeshPrimitives = geometryIndex;
+        return true;
     }
 
+    //----------------------------------------------------------------------------------------------------------
+    // Private Scene Graph Functions
+    //----------------------------------------------------------------------------------------------------------
+
+    const uint32_t c_transformJobSize = 1024;   // scene graph slots updated per job
+
     /**
-     * Update the scene mesh's bounding boxes, accounting for the mesh instances and instance transforms.
+     * Get a scene node's local transform.
      */
-    void UpdateSceneBoundingBoxes(Scene& scene)
+    XMMATRIX GetLocalTransform(const SceneNode& node)
     {
-        // Initialize the scene bounding box
-        scene.boundingBox.min = { FLT_MAX, FLT_MAX };
-        scene.boundingBox.max = { -FLT_MAX, -FLT_MAX };
+        if (node.hasMatrix) return node.matrix;
 
-        XMFLOAT4 r3  = XMFLOAT4(0.f, 0.f, 0.f, 1.f);
-        for(uint32_t instanceIndex = 0; instanceIndex < static_cast<uint32_t>(scene.instances.size()); instanceIndex++)
-        {
-            // Get the mesh instance and mesh
-            Scenes::MeshInstance& instance = scene.instances[instanceIndex];
-            const Scenes::Mesh& mesh = scene.meshes[instance.meshIndex];
-
-            // Initialize the mesh instance bounding box
-            instance.boundingBox.min = { FLT_MAX, FLT_MAX };
-            instance.boundingBox.max = { -FLT_MAX, -FLT_MAX };
+        // Compose the node's local transform, M = T * R * S
+        XMMATRIX t = XMMatrixTranslation(node.translation.x, node.translation.y, node.translation.z);
+        XMMATRIX r = XMMatrixRotationQuaternion(XMLoadFloat4(&node.rotation));
+        XMMATRIX s = XMMatrixScaling(node.scale.x, node.scale.y, node.scale.z);    // Note: do not use negative scale factors! This will flip the object inside and cause incorrect normals.
+        return XMMatrixMultiply(XMMatrixMultiply(s, r), t);
+    }
 
-            // Instance transform rows
-            XMFLOAT4 instanceXformR0 = XMFLOAT4(&instance.transform[0][0]);
-            XMFLOAT4 instanceXformR1 = XMFLOAT4(&instance.transform[1][0]);
-            XMFLOAT4 instanceXformR2 = XMFLOAT4(&instance.transform[2][0]);
+    /**
+     * Update a mesh instance's bounding box from its mesh's bounding box and the instance transform.
+     * The box's center is transformed and its half extents are transformed by the absolute value of the rotation and scale.
+     */
+    void UpdateInstanceBoundingBox(MeshInstance& instance, const Mesh& mesh, FXMMATRIX transform)
+    {
+        XMFLOAT3 min = XMFLOAT3(mesh.boundingBox.min.x, mesh.boundingBox.min.y, mesh.boundingBox.min.z);
+        XMFLOAT3 max = XMFLOAT3(mesh.boundingBox.max.x, mesh.boundingBox.max.y, mesh.boundingBox.max.z);
+        XMVECTOR center = XMVectorScale(XMVectorAdd(XMLoadFloat3(&min), XMLoadFloat3(&max)), 0.5f);
+        XMVECTOR extents = XMVectorScale(XMVectorSubtract(XMLoadFloat3(&max), XMLoadFloat3(&min)), 0.5f);
+
+        center = XMVector3Transform(center, transform);
+        extents = XMVectorMultiplyAdd(XMVectorSplatX(extents), XMVectorAbs(transform.r[0]),
+                  XMVectorMultiplyAdd(XMVectorSplatY(extents), XMVectorAbs(transform.r[1]),
+                  XMVectorMultiply(XMVectorSplatZ(extents), XMVectorAbs(transform.r[2]))));
+
+        XMStoreFloat3(&min, XMVectorSubtract(center, extents));
+        XMStoreFloat3(&max, XMVectorAdd(center, extents));
+        instance.boundingBox.min = { min.x, min.y, min.z };
+        instance.boundingBox.max = { max.x, max.y, max.z };
+    }
 
-            // Instance transform matrix
-            XMMATRIX xform;
-            xform.r[0] = DirectX::XMLoadFloat4(&instanceXformR0);
-            xform.r[1] = DirectX::XMLoadFloat4(&instanceXformR1);
-            xform.r[2] = DirectX::XMLoadFloat4(&instanceXformR2);
-            xform.r[3] = DirectX::XMLoadFloat4(&r3);
+    /**
+     * Update the scene's bounding box from the mesh instance bounding boxes.
+     */
+    void UpdateSceneBoundingBox(Scene& scene)
+    {
+        scene.boundingBox.min = { FLT_MAX, FLT_MAX, FLT_MAX };
+        scene.boundingBox.max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+        for (const MeshInstance& instance : scene.instances)
+        {
+            scene.boundingBox.min = rtxgi::Min(scene.boundingBox.min, instance.boundingBox.min);
+            scene.boundingBox.max = rtxgi::Max(scene.boundingBox.max, instance.boundingBox.max);
+        }
+    }
 
-            // Remove the transpose (transforms are transposed for copying to GPU)
-            XMMATRIX transpose = XMMatrixTranspose(xform);
+    /**
+     * Update the world transforms of a range of scene graph slots (of one depth level).
+     * A slot is updated when its node is dirty or its parent slot was updated. Slots only write their own node,
+     * world transform, and mesh instance, so the slots of a level can be updated in parallel.
+     */
+    void UpdateSlots(Scene& scene, uint32_t firstSlot, uint32_t numSlots)
+    {
+        SceneGraph& graph = scene.graph;
+        for (uint32_t slot = firstSlot; slot < (firstSlot + numSlots); slot++)
+        {
+            SceneNode& node = scene.nodes[graph.nodes[slot]];
+            int parent = graph.parents[slot];
 
-            // Get the mesh bounding box vertices
-            XMFLOAT3 min = XMFLOAT3(mesh.boundingBox.min.x, mesh.boundingBox.min.y, mesh.boundingBox.min.z);
-            XMFLOAT3 max = XMFLOAT3(mesh.boundingBox.max.x, mesh.boundingBox.max.y, mesh.boundingBox.max.z);
+            graph.updated[slot] = (node.dirty || (parent >= 0 && graph.updated[parent])) ? 1 : 0;
+            if (!graph.updated[slot]) continue;
+            node.dirty = false;
 
-            // Transform the mesh bounding box vertices
-            DirectX::XMStoreFloat3(&min, XMVector3Transform(DirectX::XMLoadFloat3(&min), transpose));
-            DirectX::XMStoreFloat3(&max, XMVector3Transform(DirectX::XMLoadFloat3(&max), transpose));
+            // Compose the world transform
+            XMMATRIX transform = GetLocalTransform(node);
+            if (parent >= 0) transform = XMMatrixMultiply(transform, graph.transforms[parent]);
+            graph.transforms[slot] = transform;
 
-            // Update the mesh instance bounding box
-            instance.boundingBox.min = rtxgi::Min(instance.boundingBox.min, { max.x, max.y, max.z });
-            instance.boundingBox.min = rtxgi::Min(instance.boundingBox.min, { min.x, min.y, min.z });
-            instance.boundingBox.max = rtxgi::Max(instance.boundingBox.max, { max.x, max.y, max.z });
-            instance.boundingBox.max = rtxgi::Max(instance.boundingBox.max, { min.x, min.y, min.z });
+            // Update the mesh instance's transform data (transposed for copying to the GPU) and bounding box
+            // Not currently supporting nested transforms for camera nodes
+            if (node.instance >= 0 && node.instance < static_cast<int>(scene.instances.size()))
+            {
+                MeshInstance& instance = scene.instances[node.instance];
+                XMMATRIX transpose = XMMatrixTranspose(transform);
+                memcpy(instance.transform, &transpose, sizeof(XMFLOAT4) * 3);
 
-            // Update the scene bounding box
-            scene.boundingBox.min = rtxgi::Min(scene.boundingBox.min, instance.boundingBox.min);
-            scene.boundingBox.max = rtxgi::Max(scene.boundingBox.min, instance.boundingBox.max);
+                if (instance.meshIndex >= 0 && instance.meshIndex < static_cast<int>(scene.meshes.size()))
+                {
+                    UpdateInstanceBoundingBox(instance, scene.meshes[instance.meshIndex], transform);
+                }
+                graph.changed[node.instance] = 1;
+            }
         }
     }
 
+    struct TransformJobs
+    {
+        Scene*   scene;
+        uint32_t firstSlot;
+        uint32_t numSlots;
+        Instrumentation::Stat* stat;
+    };
+
+    void UpdateSlotsJob(uint32_t jobIndex, void* context)
+    {
+        TransformJobs* jobs = static_cast<TransformJobs*>(context);
+        Instrumentation::ScopedTimer timer(jobs->stat);
+        uint32_t first = jobIndex * c_transformJobSize;
+        UpdateSlots(*jobs->scene, jobs->firstSlot + first, std::min(c_transformJobSize, jobs->numSlots - first));
+    }
+
     /**
      * Parse the various data of a GLTF file.
      */
-    bool ParseGLTF(const tinygltf::Model& gltfData, const Configs::Config& config, const bool binary, Scene& scene, std::ofstream& log)
+    bool ParseGLTF(const tinygltf::Model& gltfData, const Configs::Config& config, const bool binary, const Scene& previous, Caches::Stream& stream, Scene& scene, std::ofstream& log)
     {
         if (binary && gltfData.textures.size() > 0)
         {
@@ -633,15 +818,6 @@ namespace Scenes
             return false;
         }
 
-    #if defined(__aarch64__) || defined(_M_ARM64)
-        if(gltfData.textures.size() > 0)
-        {
-            std::string msg = "\nScene texture mipmapping and compression not supported on ARM64. Load a scene cache file instead of *.gltf!\n";
-            Graphics::UI::MessageBox(msg);
-            return false;
-        }
-    #endif
-
         // Parse Cameras
         ParseGLTFCameras(gltfData, scene);
 
@@ -651,14 +827,32 @@ namespace Scenes
         // Parse Materials
         ParseGLTFMaterials(gltfData, scene);
 
-        // Parse and Load Textures
-        if (!ParseGLFTextures(gltfData, config, scene)) return false;
+        // Parse and Load Textures (previously imported textures and meshes are only reused when the import settings match)
+        const Asset* previousConfig = FindAsset(previous, EAssetType::CONFIG, "");
+        bool reuse = (previousConfig != nullptr && previousConfig->hash == GetImportConfigHash(config));
+        if (!ParseGLFTextures(gltfData, config, previous, reuse, scene)) return false;
 
-        // Parse Meshes
-        ParseGLTFMeshes(gltfData, scene);
+        // Parse Meshes (and stream their data to the scene cache file)
+        Geometry::OptimizeStats stats;
+        Geometry::PackStats packStats;
+        if (!ParseGLTFMeshes(gltfData, config, previous, reuse, stream, scene, stats, packStats)) return false;
+
+        if (stats.numVertices > 0)
+        {
+            log << "\n\tOptimized meshes: " << stats.numVertices << " -> " << stats.numUniqueVertices << " vertices (";
+            log << (stats.GetDuplicateVertexRatio() * 100.f) << "% duplicates), " << stats.numDegenerateTriangles << " degenerate triangles removed, ";
+            log << "ACMR " << stats.GetACMRBefore() << " -> " << stats.GetACMRAfter();
+        }
+
+        if (packStats.numPrimitives > 0)
+        {
+            log << "\n\tPacked vertices: " << packStats.numPackedPrimitives << " of " << packStats.numPrimitives << " mesh primitives, ";
+            log << packStats.numBytesBefore << " -> " << packStats.numBytesAfter << " bytes, max error (normal: " << packStats.maxNormalError << " deg, ";
+            log << "tangent: " << packStats.maxTangentError << " deg, uv0: " << packStats.maxUVError << ")";
+        }
 
-        // Update the scene's bounding boxes, based on the instance transforms
-        UpdateSceneBoundingBoxes(scene);
+        // Flatten the scene graph and compute the instance transforms and bounding boxes
+        BuildSceneGraph(scene);
 
         return true;
     }
@@ -788,11 +982,23 @@ namespace Scenes
         }
 
         // Load the scene cache file, if it exists
-        std::string sceneCache = config.app.root + config.scene.path + cacheName + ".cache";
-        if (Caches::Deserialize(sceneCache, scene, log))
+        std::string directory = config.app.root + config.scene.path;
+        std::string sceneCache = directory + cacheName + ".cache";
+        uint64_t configHash = GetImportConfigHash(config);
+
+        Scene previous;
+        if (Caches::Deserialize(sceneCache, previous, log))
         {
-            ParseConfigCamerasLights(config, scene);
-            return true;
+            // Use the cached scene when the scene files and import settings are unchanged
+            if (Caches::IsCurrent(previous, sceneCache, directory, configHash, log))
+            {
+                previous.name = scene.name;
+                scene = std::move(previous);
+                BuildSceneGraph(scene);
+                ParseConfigCamerasLights(config, scene);
+                return true;
+            }
+            log << "\n\tRe-importing changed meshes and textures...";
         }
 
         // Load the scene GLTF (no cache file exists or the existing cache file is invalid)
@@ -813,6 +1019,7 @@ namespace Scenes
             // An error occurred
             std::string msg = std::string(err.begin(), err.end());
             Graphics::UI::MessageBox(msg);
+            Caches::Unmap(previous);
             return false;
         }
         else if (warn.length() > 0)
@@ -820,14 +1027,59 @@ namespace Scenes
             // Warning
             std::string msg = std::string(warn.begin(), warn.end());
             Graphics::UI::MessageBox(msg);
+            Caches::Unmap(previous);
+            return false;
+        }
+
+        // Start writing the new scene cache file
+        Caches::Stream stream;
+        if (!Caches::Open(stream, sceneCache, log))
+        {
+            Caches::Unmap(previous);
             return false;
         }
 
-        // Parse the GLTF data
-        CHECK(ParseGLTF(gltfData, config, binary, scene, log), "parse scene file!\n", log);
+        // Parse the GLTF data (unchanged meshes and textures are copied from the previous scene cache)
+        // Mesh data is streamed to the new scene cache file as it is converted
+        bool parsed = ParseGLTF(gltfData, config, binary, previous, stream, scene, log);
+        Caches::Unmap(previous);
+        if (!parsed) Caches::Discard(stream);
+        CHECK(parsed, "parse scene file!\n", log);
+
+        // Record the scene file, its external buffers, and the import settings (images are recorded by ParseGLFTextures())
+        Asset asset;
+        asset.filepath = config.scene.file;
+        if (Caches::UpdateAsset(directory, asset)) scene.assets.push_back(asset);
+
+        for (uint32_t bufferIndex = 0; bufferIndex < static_cast<uint32_t>(gltfData.buffers.size()); bufferIndex++)
+        {
+            const std::string& uri = gltfData.buffers[bufferIndex].uri;
+            if (uri.empty() || uri.compare(0, 5, "data:") == 0) continue;
+
+            asset = {};
+            asset.type = EAssetType::BUFFER;
+            asset.index = static_cast<int>(bufferIndex);
+            asset.filepath = ParseURI(uri);
+            if (Caches::UpdateAsset(directory, asset)) scene.assets.push_back(asset);
+        }
+
+        asset = {};
+        asset.type = EAssetType::CONFIG;
+        asset.hash = configHash;
+        scene.assets.push_back(asset);
+
+        // Release the glTF buffers, the mesh data is in the scene cache file now
+        for (tinygltf::Buffer& buffer : gltfData.buffers) std::vector<unsigned char>().swap(buffer.data);
 
-        // Serialize the scene and store a cache file to speed up future loads
-        if (!Caches::Serialize(sceneCache, scene, log)) return false;
+        // Write the rest of the scene to the cache file to speed up future loads
+        if (!Caches::Finish(stream, scene, log)) return false;
+
+        // Load the scene from the new cache file (mesh primitives and textures use the memory-mapped data)
+        Cleanup(scene);
+        scene = Scene();
+        scene.name = config.scene.name;
+        CHECK(Caches::Deserialize(sceneCache, scene, log), "load scene cache file!\n", log);
+        BuildSceneGraph(scene);
 
         // Add config specific cameras and lights
         ParseConfigCamerasLights(config, scene);
@@ -836,47 +1088,112 @@ namespace Scenes
     }
 
     /**
-     * Traverse the scene graph and update the instance transforms.
+     * Flatten the scene graph (see SceneGraph) and compute the world transforms of all nodes.
+     * Nodes that are not reachable from the root nodes (or reachable more than once) are not part of the graph.
      */
-    void Traverse(size_t nodeIndex, XMMATRIX transform, Scene& scene)
+    void BuildSceneGraph(Scene& scene)
     {
-        // Get the node
-        SceneNode node = scene.nodes[nodeIndex];
+        SceneGraph& graph = scene.graph;
+        graph = SceneGraph();
 
-        // Get the node's local transform
-        XMMATRIX nodeTransform;
-        if(node.hasMatrix)
+        // Breadth first traversal from the root nodes, one depth level at a time
+        std::vector<uint8_t> visited(scene.nodes.size(), 0);
+        for (int nodeIndex : scene.rootNodes)
         {
-            nodeTransform = node.matrix;
+            if (nodeIndex < 0 || nodeIndex >= static_cast<int>(scene.nodes.size()) || visited[nodeIndex]) continue;
+            visited[nodeIndex] = 1;
+            graph.nodes.push_back(static_cast<uint32_t>(nodeIndex));
+            graph.parents.push_back(-1);
         }
-        else
+
+        uint32_t firstSlot = 0;
+        while (firstSlot < static_cast<uint32_t>(graph.nodes.size()))
         {
-            // Compose the node's local transform, M = T * R * S
-            XMMATRIX t = XMMatrixTranslation(node.translation.x, node.translation.y, node.translation.z);
-            XMMATRIX r = XMMatrixRotationQuaternion(XMLoadFloat4(&node.rotation));
-            XMMATRIX s = XMMatrixScaling(node.scale.x, node.scale.y, node.scale.z);    // Note: do not use negative scale factors! This will flip the object inside and cause incorrect normals.
-            nodeTransform = XMMatrixMultiply(XMMatrixMultiply(s, r), t);
+            uint32_t endSlot = static_cast<uint32_t>(graph.nodes.size());
+            graph.levels.push_back(firstSlot);
+            for (uint32_t slot = firstSlot; slot < endSlot; slot++)
+            {
+                for (int child : scene.nodes[graph.nodes[slot]].children)
+                {
+                    if (child < 0 || child >= static_cast<int>(scene.nodes.size()) || visited[child]) continue;
+                    visited[child] = 1;
+                    graph.nodes.push_back(static_cast<uint32_t>(child));
+                    graph.parents.push_back(static_cast<int>(slot));
+                }
+            }
+            firstSlot = endSlot;
         }
+        graph.levels.push_back(static_cast<uint32_t>(graph.nodes.size()));
+
+        graph.transforms.resize(graph.nodes.size(), XMMatrixIdentity());
+        graph.updated.resize(graph.nodes.size(), 0);
+        graph.changed.resize(scene.instances.size(), 0);
+
+        // Compute all world transforms
+        for (uint32_t nodeIndex : graph.nodes) scene.nodes[nodeIndex].dirty = true;
+        graph.dirty = true;
+        UpdateTransforms(scene);
+        scene.changedInstances.clear();
+    }
+
+    /**
+     * Set a scene node's local transform (translation, rotation quaternion, and scale).
+     * The transforms of the node and its descendants are updated by the next UpdateTransforms().
+     */
+    void SetNodeTransform(Scene& scene, uint32_t nodeIndex, const XMFLOAT3& translation, const XMFLOAT4& rotation, const XMFLOAT3& scale)
+    {
+        SceneNode& node = scene.nodes[nodeIndex];
+        node.hasMatrix = false;
+        node.translation = translation;
+        node.rotation = rotation;
+        node.scale = scale;
+        node.dirty = true;
+        scene.graph.dirty = true;
+    }
 
-        // Compose the global transform
-        transform = XMMatrixMultiply(nodeTransform, transform);
+    /**
+     * Set a scene node's local transform matrix.
+     * The transforms of the node and its descendants are updated by the next UpdateTransforms().
+     */
+    void SetNodeTransform(Scene& scene, uint32_t nodeIndex, FXMMATRIX matrix)
+    {
+        SceneNode& node = scene.nodes[nodeIndex];
+        node.hasMatrix = true;
+        node.matrix = matrix;
+        node.dirty = true;
+        scene.graph.dirty = true;
+    }
 
-        // When at a leaf node with a mesh, update the mesh instance's transform
-        // Not currently supporting nested transforms for camera nodes
-        if (node.children.size() == 0 && node.instance > -1)
+    /**
+     * Propagate the transforms of dirty scene nodes to their descendants, one depth level at a time.
+     * Updates the transforms and bounding boxes of the affected mesh instances and lists them in scene.changedInstances
+     * (in ascending order), for acceleration structure updates. Levels with many nodes are split into jobs that run on
+     * the job system, when one is provided. The time spent in jobs (on all threads) is added to jobStat, when provided.
+     */
+    void UpdateTransforms(Scene& scene, rtxgi::DDGIJobSystem* jobSystem, Instrumentation::Stat* jobStat)
+    {
+        SceneGraph& graph = scene.graph;
+        scene.changedInstances.clear();
+        if (!graph.dirty) return;
+        graph.dirty = false;
+
+        for (size_t level = 0; (level + 1) < graph.levels.size(); level++)
         {
-            // Update the instance's transform data
-            MeshInstance* instance = &scene.instances[node.instance];
-            XMMATRIX transpose = XMMatrixTranspose(transform);
-            memcpy(instance->transform, &transpose, sizeof(XMFLOAT4) * 3);
-            return;
+            TransformJobs jobs = { &scene, graph.levels[level], graph.levels[level + 1] - graph.levels[level], jobStat };
+            uint32_t numJobs = (jobs.numSlots + c_transformJobSize - 1) / c_transformJobSize;
+            if (jobSystem && numJobs > 1) jobSystem->Run(numJobs, UpdateSlotsJob, &jobs);
+            else UpdateSlots(scene, jobs.firstSlot, jobs.numSlots);
         }
 
-        // Recursively traverse the scene graph
-        for (size_t i = 0; i < node.children.size(); i++)
+        // Gather the changed mesh instances
+        for (uint32_t instanceIndex = 0; instanceIndex < static_cast<uint32_t>(graph.changed.size()); instanceIndex++)
         {
-            Traverse(node.children[i], transform, scene);
+            if (!graph.changed[instanceIndex]) continue;
+            graph.changed[instanceIndex] = 0;
+            scene.changedInstances.push_back(instanceIndex);
         }
+
+        if (!scene.changedInstances.empty()) UpdateSceneBoundingBox(scene);
     }
 
     /**
@@ -931,6 +1248,9 @@ namespace Scenes
         {
             Textures::Unload(scene.textures[textureIndex]);
         }
+
+        // Release the scene cache mapping
+        Caches::Unmap(scene);
     }
 
 }
@@ -22,6 +22,10 @@
 #include "Textures.h"
 #include "UI.h"
 
+#include <rtxgi/ddgi/DDGIVolumeUpdate.h>
+
+#include <atomic>
+
 #if defined(GPU_COMPRESSION)
 #include <d3d11.h>
 static ID3D11Device* d3d11Device = nullptr;
@@ -92,11 +96,27 @@ namespace Textures
         return (texture.texelBytes > 0);
     }
 
+    /**
+     * Decode an uncompressed (PNG, JPG) texture file with stb_image and prep it for compression and use on the GPU.
+     */
+    bool Decode(Texture& texture)
+    {
+        // Load the uncompressed texture with stb_image (require 4 component RGBA)
+        texture.texels = stbi_load(texture.filepath.c_str(), (int*)&(texture.width), (int*)&texture.height, (int*)&texture.stride, STBI_rgb_alpha);
+        if (!texture.texels) return false;
+
+        texture.stride = 4;
+        texture.mips = 1;
+
+        return FormatTexture(texture);
+    }
+
 #if defined(__x86_64__) || defined(_M_X64)
     /**
      * Copy a compressed BC7 texture into our format, aligned for GPU use.
+     * Writes a message to error when the texture format isn't supported (safe to call from worker threads).
      */
-    bool FormatCompressedTexture(ScratchImage& src, Texture& dst)
+    bool FormatCompressedTexture(ScratchImage& src, Texture& dst, std::string& error)
     {
         bool result = false;
 
@@ -106,8 +126,7 @@ namespace Textures
         // Check if the texture's format is supported
         if (metadata.format != DXGI_FORMAT_BC7_UNORM && metadata.format != DXGI_FORMAT_BC7_UNORM_SRGB && metadata.format != DXGI_FORMAT_BC7_TYPELESS)
         {
-            std::string msg = "Error: unsupported compressed texture format for: \'" + dst.name + "\' \'" + dst.filepath + "\'\n. Compressed textures must be in BC7 format";
-            Graphics::UI::MessageBox(msg);
+            error = "Error: unsupported compressed texture format for: \'" + dst.name + "\' \'" + dst.filepath + "\'\n. Compressed textures must be in BC7 format";
             return false;
         }
 
@@ -185,6 +204,129 @@ namespace Textures
         src.Release();
         return result;
     }
+
+    /**
+     * Copy a compressed BC7 texture into our format, aligned for GPU use. Shows a message box on errors.
+     */
+    bool FormatCompressedTexture(ScratchImage& src, Texture& dst)
+    {
+        std::string error;
+        if (FormatCompressedTexture(src, dst, error)) return true;
+        if (!error.empty()) Graphics::UI::MessageBox(error);
+        return false;
+    }
+
+    // Number of textures imported at once (bounds the memory used by decoded images and mipmap chains)
+    const uint32_t c_importBatchSize = 16;
+
+    // Number of texel rows of a mip level compressed by one job (a multiple of the 4x4 BC7 block size)
+    const uint32_t c_compressRowsPerJob = 64;
+
+    struct TextureImport
+    {
+        Texture*          texture = nullptr;
+        ScratchImage      mips;
+        ScratchImage      compressed;
+        std::atomic<bool> failed = { false };
+        std::string       error;             // Written by the FormatImport job, reported by Import()
+    };
+
+    struct CompressJob
+    {
+        TextureImport* import;
+        uint32_t       mipIndex;
+        uint32_t       firstRow;
+        uint32_t       numRows;
+    };
+
+    struct ImportContext
+    {
+        TextureImport*           imports = nullptr;
+        std::vector<CompressJob> jobs;
+        TEX_COMPRESS_FLAGS       flags = TEX_COMPRESS_DEFAULT;
+    };
+
+    /**
+     * Import job: decode a texture file and generate its mipmap chain (with the DirectXTex filters).
+     */
+    void DecodeAndMipmap(uint32_t jobIndex, void* data)
+    {
+        TextureImport& import = static_cast<ImportContext*>(data)->imports[jobIndex];
+        Texture& texture = *import.texture;
+
+        if (!Decode(texture))
+        {
+            import.failed = true;
+            return;
+        }
+
+        Image source = {};
+        source.width = texture.width;
+        source.height = texture.height;
+        source.rowPitch = (texture.width * texture.stride);
+        source.slicePitch = (source.rowPitch * source.height);
+        source.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        source.pixels = texture.texels;
+
+        // Generate the mipmap chain (WIC filtering isn't available on Linux or without COM initialized on worker threads)
+        if (FAILED(DirectX::GenerateMipMaps(source, TEX_FILTER_DEFAULT | TEX_FILTER_FORCE_NON_WIC, 0, import.mips)))
+        {
+            import.failed = true;
+            return;
+        }
+
+    #if !defined(GPU_COMPRESSION)
+        // Allocate the compressed mipmap chain, filled in by the CompressBlocks jobs
+        const TexMetadata& metadata = import.mips.GetMetadata();
+        if (FAILED(import.compressed.Initialize2D(DXGI_FORMAT_BC7_UNORM, metadata.width, metadata.height, 1, metadata.mipLevels))) import.failed = true;
+    #endif
+    }
+
+    /**
+     * Import job: BC7 compress a strip of a mip level and copy its block rows into the compressed mipmap chain.
+     */
+    void CompressBlocks(uint32_t jobIndex, void* data)
+    {
+        const ImportContext& context = *static_cast<ImportContext*>(data);
+        const CompressJob& job = context.jobs[jobIndex];
+        if (job.import->failed) return;
+
+        const Image* mip = job.import->mips.GetImage(job.mipIndex, 0, 0);
+
+        Image strip = *mip;
+        strip.height = job.numRows;
+        strip.slicePitch = (mip->rowPitch * job.numRows);
+        strip.pixels = mip->pixels + (mip->rowPitch * job.firstRow);
+
+        ScratchImage blocks;
+        if (FAILED(DirectX::Compress(strip, DXGI_FORMAT_BC7_UNORM, context.flags, TEX_THRESHOLD_DEFAULT, blocks)))
+        {
+            job.import->failed = true;
+            return;
+        }
+
+        const Image* src = blocks.GetImage(0, 0, 0);
+        const Image* dst = job.import->compressed.GetImage(job.mipIndex, 0, 0);
+
+        size_t numBlockRows = (job.numRows + 3) / 4;
+        for (size_t rowIndex = 0; rowIndex < numBlockRows; rowIndex++)
+        {
+            memcpy(dst->pixels + (dst->rowPitch * ((job.firstRow / 4) + rowIndex)), src->pixels + (src->rowPitch * rowIndex), std::min(src->rowPitch, dst->rowPitch));
+        }
+    }
+
+    /**
+     * Import job: copy a compressed texture into our format.
+     */
+    void FormatImport(uint32_t jobIndex, void* data)
+    {
+        TextureImport& import = static_cast<ImportContext*>(data)->imports[jobIndex];
+        if (import.failed) return;
+
+        import.mips.Release();
+        import.texture->format = ETextureFormat::BC7;
+        if (!FormatCompressedTexture(import.compressed, *import.texture, import.error)) import.failed = true;
+    }
 #endif
 
     //----------------------------------------------------------------------------------------------------------
@@ -199,7 +341,10 @@ namespace Textures
     {
         D3D_FEATURE_LEVEL requested = D3D_FEATURE_LEVEL_11_1;
         D3D_FEATURE_LEVEL supported;
-        if(FAILED(D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, 0, &requested, 1, D3D11_SDK_VERSION, &d3d11Device, &supported, nullptr))) return false;
+        if(SUCCEEDED(D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, 0, &requested, 1, D3D11_SDK_VERSION, &d3d11Device, &supported, nullptr))) return true;
+
+        // Fall back to the software rasterizer (e.g. on machines without a GPU)
+        if(FAILED(D3D11CreateDevice(nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0, &requested, 1, D3D11_SDK_VERSION, &d3d11Device, &supported, nullptr))) return false;
         return true;
     }
 
@@ -217,20 +362,13 @@ namespace Textures
     {
         if(texture.format == ETextureFormat::UNCOMPRESSED)
         {
-            // Load the uncompressed texture with stb_image (require 4 component RGBA)
-            texture.texels = stbi_load(texture.filepath.c_str(), (int*)&(texture.width), (int*)&texture.height, (int*)&texture.stride, STBI_rgb_alpha);
-            if (!texture.texels)
+            if (!Decode(texture))
             {
                 std::string msg = "Error: failed to load texture: \'" + texture.name + "\' \'" + texture.filepath + "\'";
                 Graphics::UI::MessageBox(msg);
                 return false;
             }
-
-            texture.stride = 4;
-            texture.mips = 1;
-
-            // Prep the texture for compression and use on the GPU
-            return FormatTexture(texture);
+            return true;
         }
     #if defined(__x86_64__) || defined(_M_X64)
         else if(texture.format == ETextureFormat::BC7)
@@ -289,7 +427,9 @@ namespace Textures
     #ifdef GPU_COMPRESSION
         if (FAILED(DirectX::Compress(d3d11Device, source, DXGI_FORMAT_BC7_UNORM, flags, 1.f, destination))) return false;
     #else
-        flags |= TEX_COMPRESS_PARALLEL;
+    #if defined(_OPENMP)
+        flags |= TEX_COMPRESS_PARALLEL; // DirectXTex only parallelizes compression with OpenMP
+    #endif
         if (FAILED(DirectX::Compress(source, DXGI_FORMAT_BC7_UNORM, flags, TEX_THRESHOLD_DEFAULT, destination))) return false;
     #endif
 
@@ -333,7 +473,9 @@ namespace Textures
     #ifdef GPU_COMPRESSION
         if (FAILED(DirectX::Compress(d3d11Device, mips.GetImages(), mips.GetImageCount(), mips.GetMetadata(), DXGI_FORMAT_BC7_UNORM, flags, 1.f, compressed))) return false;
     #else
-        flags |= TEX_COMPRESS_PARALLEL;
+    #if defined(_OPENMP)
+        flags |= TEX_COMPRESS_PARALLEL; // DirectXTex only parallelizes compression with OpenMP
+    #endif
         if (FAILED(DirectX::Compress(mips.GetImages(), mips.GetImageCount(), mips.GetMetadata(), DXGI_FORMAT_BC7_UNORM, flags, TEX_THRESHOLD_DEFAULT, compressed))) return false;
     #endif
 
@@ -344,6 +486,69 @@ namespace Textures
         return FormatCompressedTexture(compressed, texture);
     }
 
+    /**
+     * Load, generate the mipmap chains of, and BC7 compress uncompressed (PNG, JPG) textures in parallel.
+     * Textures are decoded and mipmapped in parallel; with CPU compression, every mip level is split into strips of
+     * BC7 block rows and the strips of all textures in a batch are compressed in parallel.
+     */
+    bool Import(Texture** textures, uint32_t numTextures, bool quick)
+    {
+        rtxgi::DDGIThreadPool threadPool;
+
+        for (uint32_t batchStart = 0; batchStart < numTextures; batchStart += c_importBatchSize)
+        {
+            uint32_t batchSize = std::min(c_importBatchSize, numTextures - batchStart);
+
+            std::vector<TextureImport> imports(batchSize);
+            for (uint32_t importIndex = 0; importIndex < batchSize; importIndex++) imports[importIndex].texture = textures[batchStart + importIndex];
+
+            ImportContext context;
+            context.imports = imports.data();
+            if (quick) context.flags = TEX_COMPRESS_BC7_QUICK;
+
+            // Decode the textures and generate their mipmap chains
+            threadPool.Run(batchSize, DecodeAndMipmap, &context);
+
+        #if defined(GPU_COMPRESSION)
+            // Compress the mipmap chains on the GPU (one texture at a time, the D3D11 immediate context isn't thread-safe)
+            for (TextureImport& import : imports)
+            {
+                if (import.failed) continue;
+                if (FAILED(DirectX::Compress(d3d11Device, import.mips.GetImages(), import.mips.GetImageCount(), import.mips.GetMetadata(), DXGI_FORMAT_BC7_UNORM, context.flags, 1.f, import.compressed))) import.failed = true;
+            }
+        #else
+            // Split the mip levels into strips and compress all strips in parallel
+            for (TextureImport& import : imports)
+            {
+                if (import.failed) continue;
+                for (uint32_t mipIndex = 0; mipIndex < static_cast<uint32_t>(import.mips.GetMetadata().mipLevels); mipIndex++)
+                {
+                    uint32_t height = static_cast<uint32_t>(import.mips.GetImage(mipIndex, 0, 0)->height);
+                    for (uint32_t row = 0; row < height; row += c_compressRowsPerJob)
+                    {
+                        context.jobs.push_back({ &import, mipIndex, row, std::min(c_compressRowsPerJob, height - row) });
+                    }
+                }
+            }
+            threadPool.Run(static_cast<uint32_t>(context.jobs.size()), CompressBlocks, &context);
+        #endif
+
+            // Copy the compressed textures into our format, prepping them for use on the GPU
+            threadPool.Run(batchSize, FormatImport, &context);
+
+            // Report errors (message boxes are shown from this thread)
+            for (const TextureImport& import : imports)
+            {
+                if (!import.failed) continue;
+                std::string msg = import.error;
+                if (msg.empty()) msg = "Error: failed to import texture: \'" + import.texture->name + "\' \'" + import.texture->filepath + "\'";
+                Graphics::UI::MessageBox(msg);
+                return false;
+            }
+        }
+        return true;
+    }
+
 #endif
 
     /**
@@ -351,7 +556,7 @@ namespace Textures
      */
     void Unload(Texture& texture)
     {
-        delete[] texture.texels;
+        if (!texture.mapped) delete[] texture.texels;
         texture = {};
     }
 
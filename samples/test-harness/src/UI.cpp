@@ -27,6 +27,7 @@ namespace Graphics
     namespace UI
     {
         bool s_initialized = false;
+        bool s_headless = false;
 
         static int prevRes = 0;
         static int curRes = 0;
@@ -325,7 +326,7 @@ namespace Graphics
                     ImGui::SameLine();
                     ImGui::Text("Running...%d%%", config.app.benchmarkProgress);
                 }
-                ImGui::SameLine(); AddQuestionMark("Runs a benchmark that captures performance information for 1,000 frames. Press 'F4' on the keyboard for a shortcut.");
+                ImGui::SameLine(); AddQuestionMark("Runs the benchmark scenario of the configuration file (1,024 frames from the first camera by default) and captures performance information. Press 'F4' on the keyboard for a shortcut.");
             }
             ImGui::Separator();
 
@@ -952,6 +953,12 @@ namespace Graphics
                         ImGui::Unindent(20.f);
                     }
 
+                    // Probe Updates
+                    {
+                        ImGui::Checkbox("Update Probes", &config.ddgi.volumes[config.ddgi.selectedVolume].updateEnabled);
+                        ImGui::SameLine(); AddQuestionMark("When disabled, the volume does not trace probe rays or update its probes. Lighting continues to use the volume's current probe data.");
+                    }
+
                     // Probe Variability options
                     {
                         if (ImGui::Checkbox("Probe Variability", &config.ddgi.volumes[config.ddgi.selectedVolume].probeVariabilityEnabled))
@@ -1230,6 +1237,7 @@ namespace Graphics
                 Instrumentation::Stat* timestampBeginStat = performance.cpuTimes[Instrumentation::EStatIndex::TIMESTAMP_BEGIN];
                 Instrumentation::Stat* inputStat = performance.cpuTimes[Instrumentation::EStatIndex::INPUT];
                 Instrumentation::Stat* updateStat = performance.cpuTimes[Instrumentation::EStatIndex::UPDATE];
+                Instrumentation::Stat* sceneJobsStat = performance.cpuTimes[Instrumentation::EStatIndex::SCENE_JOBS];
                 Instrumentation::Stat* renderStat = nullptr;
                 Instrumentation::Stat* uiStat = performance.cpuTimes[Instrumentation::EStatIndex::UI];
                 Instrumentation::Stat* timestampEndStat = performance.cpuTimes[Instrumentation::EStatIndex::TIMESTAMP_END];
@@ -1270,6 +1278,7 @@ namespace Graphics
                 // Input, Update
                 ImGui::Text("%s: %.3lf ms", inputStat->name.c_str(), inputStat->average);
                 ImGui::Text("%s: %.3lf ms", updateStat->name.c_str(), updateStat->average);
+                ImGui::Text("  %s: %.3lf ms (all threads)", sceneJobsStat->name.c_str(), sceneJobsStat->average);
 
                 // Timetamp
                 double timestampTotal = (timestampBeginStat->average + timestampEndStat->average);
@@ -1465,6 +1474,13 @@ namespace Graphics
 
         bool MessageBox(std::string message)
         {
+            // Headless runs can't wait for a user to close the message box
+            if (s_headless)
+            {
+                fprintf(stderr, "Error: %s\n", message.c_str());
+                return true;
+            }
+
         #if defined(_WIN32) || defined(WIN32)
             std::wstring wstr = std::wstring(message.begin(), message.end());
             MessageBoxW(NULL, wstr.c_str(), L"Error!", MB_OK);
@@ -1564,6 +1580,12 @@ namespace Graphics
         {
             bool retry = false;
 
+            if (s_headless)
+            {
+                fprintf(stderr, "Error: %s\n", message.c_str());
+                return retry;
+            }
+
         #if defined(_WIN32) || defined(WIN32)
             std::wstring wstr = std::wstring(message.begin(), message.end());
             retry = (MessageBoxW(NULL, wstr.c_str(), L"Error!", MB_RETRYCANCEL) == IDRETRY);
@@ -216,13 +216,15 @@ namespace Graphics
          */
         bool CreateInstance(Globals& vk)
         {
-            // Check if Vulkan exists
-            if(!glfwVulkanSupported()) return false;
-
-            // Get the required extensions
+            // Get the required extensions (headless instances don't present to a window surface)
             uint32_t glfwExtensionCount = 0;
-            const char** glfwExtensions;
-            glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            const char** glfwExtensions = nullptr;
+            if (!vk.headless)
+            {
+                // Check if Vulkan exists
+                if(!glfwVulkanSupported()) return false;
+                glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+            }
 
             // Specify all extensions
             // 0: VK_KHR_SURFACE_EXTENSION_NAME
@@ -339,7 +341,6 @@ namespace Graphics
 
             std::vector<const char*> deviceExtensions =
             {
-                VK_KHR_SWAPCHAIN_EXTENSION_NAME,
                 VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME,
                 VK_KHR_RAY_QUERY_EXTENSION_NAME,
                 VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
@@ -350,6 +351,7 @@ namespace Graphics
                 VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME,
                 VK_KHR_MAINTENANCE3_EXTENSION_NAME
             };
+            if (!vk.headless) deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
             deviceCreateInfo.ppEnabledExtensionNames = deviceExtensions.data();
             deviceCreateInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
@@ -414,7 +416,7 @@ namespace Graphics
         #ifdef GFX_NAME_OBJECTS
             SetObjectName(vk.device, reinterpret_cast<uint64_t>(vk.device), "VKDevice", VK_OBJECT_TYPE_DEVICE);
             SetObjectName(vk.device, reinterpret_cast<uint64_t>(vk.queue), "VKQueue", VK_OBJECT_TYPE_QUEUE);
-            SetObjectName(vk.device, reinterpret_cast<uint64_t>(vk.surface), "VKSurface", VK_OBJECT_TYPE_SURFACE_KHR);
+            if (vk.surface) SetObjectName(vk.device, reinterpret_cast<uint64_t>(vk.surface), "VKSurface", VK_OBJECT_TYPE_SURFACE_KHR);
         #endif
 
             // Get the properties of the device (include ray tracing properties)
@@ -468,11 +470,52 @@ namespace Graphics
             return true;
         }
 
+        /**
+         * Create the offscreen back buffers used in place of the swap chain when headless.
+         */
+        bool CreateOffscreenBackBuffers(Globals& vk)
+        {
+            vk.swapChainFormat = VK_FORMAT_B8G8R8A8_UNORM;
+            vk.swapChainImageLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+            TextureDesc desc = { static_cast<uint32_t>(vk.width), static_cast<uint32_t>(vk.height), 1, 1, vk.swapChainFormat, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT };
+            for (uint32_t imageIndex = 0; imageIndex < MAX_FRAMES_IN_FLIGHT; imageIndex++)
+            {
+                if (!CreateTexture(vk, desc, &vk.swapChainImage[imageIndex], &vk.swapChainImageMemory[imageIndex], &vk.swapChainImageView[imageIndex])) return false;
+            #ifdef GFX_NAME_OBJECTS
+                std::string imageName = "Back Buffer Image " + std::to_string(imageIndex);
+                SetObjectName(vk.device, reinterpret_cast<uint64_t>(vk.swapChainImage[imageIndex]), imageName.c_str(), VK_OBJECT_TYPE_IMAGE);
+
+                std::string viewName = "Back Buffer Image View " + std::to_string(imageIndex);
+                SetObjectName(vk.device, reinterpret_cast<uint64_t>(vk.swapChainImageView[imageIndex]), viewName.c_str(), VK_OBJECT_TYPE_IMAGE_VIEW);
+            #endif
+            }
+
+            ImageBarrierDesc barrier =
+            {
+                VK_IMAGE_LAYOUT_UNDEFINED,
+                vk.swapChainImageLayout,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
+            };
+
+            // Transition the back buffers to their between-frame layout
+            for (uint32_t imageIndex = 0; imageIndex < MAX_FRAMES_IN_FLIGHT; imageIndex++)
+            {
+                SetImageLayoutBarrier(vk.cmdBuffer[vk.frameIndex], vk.swapChainImage[imageIndex], barrier);
+            }
+
+            return true;
+        }
+
         /**
          * Create the swap chain.
          */
         bool CreateSwapChain(Globals& vk)
         {
+            if (vk.headless) return CreateOffscreenBackBuffers(vk);
+
             // Make sure the surface supports presentation
             VkBool32 presentSupported;
             VKCHECK(vkGetPhysicalDeviceSurfaceSupportKHR(vk.physicalDevice, 0, vk.surface, &presentSupported));
@@ -609,7 +652,7 @@ namespace Graphics
             attachmentDescriptions[0].stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
             attachmentDescriptions[0].stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
             attachmentDescriptions[0].initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-            attachmentDescriptions[0].finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+            attachmentDescriptions[0].finalLayout = vk.swapChainImageLayout;
 
             VkAttachmentReference colorAttachmentReference = {};
             colorAttachmentReference.attachment = 0;
@@ -913,8 +956,8 @@ namespace Graphics
                 // Get the mesh primitive and copy its indices to the upload buffer
                 const Scenes::MeshPrimitive& primitive = mesh.primitives[primitiveIndex];
 
-                uint32_t size = static_cast<uint32_t>(primitive.indices.size()) * sizeof(uint32_t);
-                memcpy(pData + primitive.indexByteOffset, primitive.indices.data(), size);
+                uint32_t size = primitive.GetNumIndices() * sizeof(uint32_t);
+                memcpy(pData + primitive.indexByteOffset, primitive.GetIndices(), size);
             }
             vkUnmapMemory(vk.device, *ibUploadMemory);
 
@@ -933,8 +976,8 @@ namespace Graphics
         bool CreateVertexBuffer(Globals& vk, const Scenes::Mesh& mesh, VkBuffer* vb, VkDeviceMemory* vbMemory, VkBuffer* vbUpload, VkDeviceMemory* vbUploadMemory)
         {
             // Create the vertex buffer upload resource
-            uint32_t stride = sizeof(Vertex);
-            uint32_t sizeInBytes = mesh.numVertices * stride;
+            // Mesh primitives store their vertices in either the full or packed vertex format (see Scenes::MeshPrimitive::vertexFormat)
+            uint32_t sizeInBytes = mesh.GetVertexBufferSize();
             BufferDesc desc = { sizeInBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
             if (!CreateBuffer(vk, desc, vbUpload, vbUploadMemory)) return false;
 
@@ -952,8 +995,7 @@ namespace Graphics
                 // Get the mesh primitive and copy its vertices to the upload buffer
                 const Scenes::MeshPrimitive& primitive = mesh.primitives[primitiveIndex];
 
-                uint32_t size = static_cast<uint32_t>(primitive.vertices.size()) * stride;
-                memcpy(pData + primitive.vertexByteOffset, primitive.vertices.data(), size);
+                memcpy(pData + primitive.vertexByteOffset, primitive.GetVertexData(), primitive.GetVertexDataSize());
             }
             vkUnmapMemory(vk.device, *vbUploadMemory);
 
@@ -990,14 +1032,14 @@ namespace Graphics
                 desc.geometry.triangles.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_TRIANGLES_DATA_KHR;
 
                 desc.geometry.triangles.vertexData = VkDeviceOrHostAddressConstKHR{ GetBufferDeviceAddress(vk.device, resources.sceneVBs[mesh.index]) + primitive.vertexByteOffset };
-                desc.geometry.triangles.vertexStride = sizeof(Vertex);
-                desc.geometry.triangles.maxVertex = static_cast<uint32_t>(primitive.vertices.size());
+                desc.geometry.triangles.vertexStride = primitive.GetVertexStride(); // positions are the first element of both vertex formats
+                desc.geometry.triangles.maxVertex = primitive.GetNumVertices();
                 desc.geometry.triangles.vertexFormat = VK_FORMAT_R32G32B32_SFLOAT;
                 desc.geometry.triangles.indexData = VkDeviceOrHostAddressConstKHR{ GetBufferDeviceAddress(vk.device, resources.sceneIBs[mesh.index]) + primitive.indexByteOffset };
                 desc.geometry.triangles.indexType = VK_INDEX_TYPE_UINT32;
                 desc.flags = primitive.opaque ? VK_GEOMETRY_OPAQUE_BIT_KHR : 0;
 
-                uint32_t primitiveCount = static_cast<uint32_t>(primitive.indices.size() / 3);
+                uint32_t primitiveCount = primitive.GetNumIndices() / 3;
 
                 // Describe the geometry for the builder
                 VkAccelerationStructureBuildRangeInfoKHR buildRange = { primitiveCount, 0, 0, 0 };
@@ -1052,15 +1094,15 @@ namespace Graphics
         }
 
         /**
-         * Create a top level acceleration structure.
-         * Allocate scratch memory and schedule a GPU TLAS build.
+         * Describe a top level acceleration structure build that reads its instances from the acceleration structure's instance buffer.
+         * The TLAS allows updates, so moving instances can be refit instead of rebuilt.
          */
-        bool CreateTLAS(Globals& vk, const std::vector<VkAccelerationStructureInstanceKHR>& instances, AccelerationStructure& as)
+        void GetTLASBuildInfo(Globals& vk, const AccelerationStructure& as, VkAccelerationStructureGeometryKHR& geometries, VkAccelerationStructureBuildGeometryInfoKHR& asInputs)
         {
-            VkBuildAccelerationStructureFlagBitsKHR buildFlags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR;
+            VkBuildAccelerationStructureFlagsKHR buildFlags = VK_BUILD_ACCELERATION_STRUCTURE_PREFER_FAST_TRACE_BIT_KHR | VK_BUILD_ACCELERATION_STRUCTURE_ALLOW_UPDATE_BIT_KHR;
 
             // Describe the TLAS geometry instances
-            VkAccelerationStructureGeometryKHR geometries = {};
+            geometries = {};
             geometries.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_KHR;
             geometries.geometryType = VK_GEOMETRY_TYPE_INSTANCES_KHR;
             geometries.geometry.instances.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_GEOMETRY_INSTANCES_DATA_KHR;
@@ -1068,13 +1110,56 @@ namespace Graphics
             geometries.geometry.instances.data = VkDeviceOrHostAddressConstKHR{ GetBufferDeviceAddress(vk.device, as.instances) };
 
             // Describe the top level acceleration structure inputs
-            VkAccelerationStructureBuildGeometryInfoKHR asInputs = {};
+            asInputs = {};
             asInputs.sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_BUILD_GEOMETRY_INFO_KHR;
             asInputs.type = VK_ACCELERATION_STRUCTURE_TYPE_TOP_LEVEL_KHR;
             asInputs.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_BUILD_KHR;
             asInputs.geometryCount = 1;
             asInputs.pGeometries = &geometries;
             asInputs.flags = buildFlags;
+        }
+
+        /**
+         * Schedule a GPU build of a top level acceleration structure.
+         * When updating, the TLAS is refit in place to the (moved) instances of its last build.
+         */
+        void BuildTLAS(Globals& vk, AccelerationStructure& as, uint32_t numInstances, bool update)
+        {
+            VkAccelerationStructureGeometryKHR geometries;
+            VkAccelerationStructureBuildGeometryInfoKHR asInputs;
+            GetTLASBuildInfo(vk, as, geometries, asInputs);
+
+            if (update)
+            {
+                asInputs.mode = VK_BUILD_ACCELERATION_STRUCTURE_MODE_UPDATE_KHR;
+                asInputs.srcAccelerationStructure = as.asKHR;
+            }
+            asInputs.dstAccelerationStructure = as.asKHR;
+            asInputs.scratchData = VkDeviceOrHostAddressKHR{ GetBufferDeviceAddress(vk.device, as.scratch) };
+
+            // Describe and build the TLAS
+            std::vector<const VkAccelerationStructureBuildRangeInfoKHR*> buildRangeInfos(1);
+            VkAccelerationStructureBuildRangeInfoKHR buildInfo = { numInstances, 0, 0, 0 };
+            buildRangeInfos[0] = &buildInfo;
+
+            vkCmdBuildAccelerationStructuresKHR(vk.cmdBuffer[vk.frameIndex], 1, &asInputs, buildRangeInfos.data());
+
+            // Wait for the TLAS build to complete
+            VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+            barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
+            barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
+            vkCmdPipelineBarrier(vk.cmdBuffer[vk.frameIndex], VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        }
+
+        /**
+         * Create a top level acceleration structure.
+         * Allocate scratch memory (for builds and updates) and schedule a GPU TLAS build.
+         */
+        bool CreateTLAS(Globals& vk, const std::vector<VkAccelerationStructureInstanceKHR>& instances, AccelerationStructure& as)
+        {
+            VkAccelerationStructureGeometryKHR geometries;
+            VkAccelerationStructureBuildGeometryInfoKHR asInputs;
+            GetTLASBuildInfo(vk, as, geometries, asInputs);
 
             // Get the size requirements for the TLAS buffer
             uint32_t primitiveCount = static_cast<uint32_t>(instances.size());
@@ -1083,9 +1168,9 @@ namespace Graphics
             vkGetAccelerationStructureBuildSizesKHR(vk.device, VK_ACCELERATION_STRUCTURE_BUILD_TYPE_DEVICE_KHR, &asInputs, &primitiveCount, &asPreBuildInfo);
 
             // Create the TLAS scratch buffer, allocate and bind device memory
-            BufferDesc scratchDesc = { asPreBuildInfo.buildScratchSize, VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
+            VkDeviceSize scratchSize = std::max(asPreBuildInfo.buildScratchSize, asPreBuildInfo.updateScratchSize);
+            BufferDesc scratchDesc = { scratchSize, VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
             if (!CreateBuffer(vk, scratchDesc, &as.scratch, &as.scratchMemory)) return false;
-            asInputs.scratchData = VkDeviceOrHostAddressKHR{ GetBufferDeviceAddress(vk.device, as.scratch) };
 
             // Create the acceleration structure buffer, allocate and bind device memory
             BufferDesc desc = { asPreBuildInfo.accelerationStructureSize, VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT };
@@ -1101,21 +1186,8 @@ namespace Graphics
             // Create the TLAS
             VKCHECK(vkCreateAccelerationStructureKHR(vk.device, &asCreateInfo, nullptr, &as.asKHR));
 
-            // Set the location of the final acceleration structure
-            asInputs.dstAccelerationStructure = as.asKHR;
-
-            // Describe and build the BLAS
-            std::vector<const VkAccelerationStructureBuildRangeInfoKHR*> buildRangeInfos(1);
-            VkAccelerationStructureBuildRangeInfoKHR buildInfo = { primitiveCount, 0, 0, 0 };
-            buildRangeInfos[0] = &buildInfo;
-
-            vkCmdBuildAccelerationStructuresKHR(vk.cmdBuffer[vk.frameIndex], 1, &asInputs, buildRangeInfos.data());
-
-            // Wait for the TLAS build to complete
-            VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
-            barrier.srcAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_WRITE_BIT_KHR;
-            barrier.dstAccessMask = VK_ACCESS_ACCELERATION_STRUCTURE_READ_BIT_KHR;
-            vkCmdPipelineBarrier(vk.cmdBuffer[vk.frameIndex], VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+            // Schedule the TLAS build
+            BuildTLAS(vk, as, primitiveCount, false);
 
             return true;
         }
@@ -1585,8 +1657,13 @@ namespace Graphics
             {
                 vkDestroyFramebuffer(vk.device, vk.frameBuffer[resourceIndex], nullptr);
                 vkDestroyImageView(vk.device, vk.swapChainImageView[resourceIndex], nullptr);
+                if (vk.headless)
+                {
+                    vkDestroyImage(vk.device, vk.swapChainImage[resourceIndex], nullptr);
+                    vkFreeMemory(vk.device, vk.swapChainImageMemory[resourceIndex], nullptr);
+                }
             }
-            vkDestroySwapchainKHR(vk.device, vk.swapChain, nullptr);
+            if (vk.swapChain) vkDestroySwapchainKHR(vk.device, vk.swapChain, nullptr);
         }
 
         /**
@@ -1714,14 +1791,19 @@ namespace Graphics
                 vkDestroyFramebuffer(vk.device, vk.frameBuffer[resourceIndex], nullptr);
                 vkDestroyFence(vk.device, vk.fences[resourceIndex], nullptr);
                 vkDestroyImageView(vk.device, vk.swapChainImageView[resourceIndex], nullptr);
+                if (vk.headless)
+                {
+                    vkDestroyImage(vk.device, vk.swapChainImage[resourceIndex], nullptr);
+                    vkFreeMemory(vk.device, vk.swapChainImageMemory[resourceIndex], nullptr);
+                }
             }
 
             vkFreeCommandBuffers(vk.device, vk.commandPool, MAX_FRAMES_IN_FLIGHT, vk.cmdBuffer);
             vkDestroyCommandPool(vk.device, vk.commandPool, nullptr);
             vkDestroyRenderPass(vk.device, vk.renderPass, nullptr);
             vkDestroyFence(vk.device, vk.immediateFence, nullptr);
-            vkDestroySwapchainKHR(vk.device, vk.swapChain, nullptr);
-            vkDestroySurfaceKHR(vk.instance, vk.surface, nullptr);
+            if (vk.swapChain) vkDestroySwapchainKHR(vk.device, vk.swapChain, nullptr);
+            if (vk.surface) vkDestroySurfaceKHR(vk.instance, vk.surface, nullptr);
             vkDestroyDevice(vk.device, nullptr);
 
         #if _DEBUG
@@ -1915,6 +1997,7 @@ namespace Graphics
                     data.materialIndex = primitive.material;
                     data.indexByteAddress = primitive.indexByteOffset;
                     data.vertexByteAddress = primitive.vertexByteOffset;
+                    data.vertexFormat = primitive.vertexFormat;
                     memcpy(geometryDataAddress, &data, sizeof(GeometryData));
 
                     geometryDataAddress += sizeof(GeometryData);
@@ -1937,15 +2020,22 @@ namespace Graphics
 
         /**
          * Create the scene TLAS instances buffers.
+         * The upload buffer stays mapped and holds a copy of the instances for each frame in flight, so the instances that
+         * change in a frame can be written without waiting on the GPU (see UpdateSceneTLAS()).
          */
         bool CreateSceneInstancesBuffer(Globals& vk, Resources& resources, const std::vector<VkAccelerationStructureInstanceKHR>& instances)
         {
             // Create the TLAS instance upload buffer resource
             uint32_t size = static_cast<uint32_t>(instances.size()) * sizeof(VkAccelerationStructureInstanceKHR);
-            BufferDesc desc = { size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+            BufferDesc desc = { size * MAX_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
             if (!CreateBuffer(vk, desc, &resources.tlas.instancesUpload, &resources.tlas.instancesUploadMemory)) return false;
+        #ifdef GFX_NAME_OBJECTS
+            SetObjectName(vk.device, reinterpret_cast<uint64_t>(resources.tlas.instancesUpload), "TLAS Instance Descriptors Upload Buffer", VK_OBJECT_TYPE_BUFFER);
+            SetObjectName(vk.device, reinterpret_cast<uint64_t>(resources.tlas.instancesUploadMemory), "TLAS Instance Descriptors Upload Buffer Memory", VK_OBJECT_TYPE_DEVICE_MEMORY);
+        #endif
 
             // Create the TLAS instance device buffer resource
+            desc.size = size;
             desc.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR;
             desc.memoryPropertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
             if (!CreateBuffer(vk, desc, &resources.tlas.instances, &resources.tlas.instancesMemory)) return false;
@@ -1954,11 +2044,12 @@ namespace Graphics
             SetObjectName(vk.device, reinterpret_cast<uint64_t>(resources.tlas.instancesMemory), "TLAS Instance Descriptors Memory", VK_OBJECT_TYPE_DEVICE_MEMORY);
         #endif
 
-            // Copy the instance data to the upload buffer
-            uint8_t* pData = nullptr;
-            VKCHECK(vkMapMemory(vk.device, resources.tlas.instancesUploadMemory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&pData)));
-            memcpy(pData, instances.data(), desc.size);
-            vkUnmapMemory(vk.device, resources.tlas.instancesUploadMemory);
+            // Copy the instance data to each region of the upload buffer. Leave the buffer mapped for updates.
+            VKCHECK(vkMapMemory(vk.device, resources.tlas.instancesUploadMemory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&resources.tlas.instancesUploadPtr)));
+            for (uint32_t frameIndex = 0; frameIndex < MAX_FRAMES_IN_FLIGHT; frameIndex++)
+            {
+                memcpy(resources.tlas.instancesUploadPtr + (frameIndex * size), instances.data(), size);
+            }
 
             // Schedule a copy of the upload buffer to the device buffer
             VkBufferCopy bufferCopy = {};
@@ -2110,6 +2201,7 @@ namespace Graphics
 
             // Build the TLAS
             if (!CreateTLAS(vk, instances, resources.tlas)) return false;
+            AccelerationStructures::Reset(resources.tlasUpdate, scene);
         #ifdef GFX_NAME_OBJECTS
             std::string name = "TLAS";
             std::string memory = "TLAS Memory";
@@ -2125,6 +2217,54 @@ namespace Graphics
             return true;
         }
 
+        /**
+         * Update the scene's top level acceleration structure for the mesh instances moved by Scenes::UpdateTransforms().
+         * Writes the changed instance transforms to the current frame's region of the (mapped) instances upload buffer,
+         * copies the changed ranges to the device buffer, and refits or rebuilds the TLAS (see AccelerationStructures::Update()).
+         */
+        void UpdateSceneTLAS(Globals& vk, Resources& resources, const Configs::Config& config, const Scenes::Scene& scene)
+        {
+            AccelerationStructures::TLASPolicy policy = { config.scene.tlasRebuildMotion, config.scene.tlasRebuildInterval };
+            AccelerationStructures::ETLASUpdate update = AccelerationStructures::Update(resources.tlasUpdate, policy, scene);
+            if (update == AccelerationStructures::ETLASUpdate::NONE) return;
+
+            // Write the changed instance transforms to the current frame's region of the upload buffer
+            const VkDeviceSize instanceSize = sizeof(VkAccelerationStructureInstanceKHR);
+            const VkDeviceSize regionOffset = vk.frameIndex * scene.instances.size() * instanceSize;
+
+            std::vector<VkBufferCopy> bufferCopies;
+            for (const AccelerationStructures::InstanceRange& range : resources.tlasUpdate.ranges)
+            {
+                for (uint32_t instanceIndex = range.first; instanceIndex < (range.first + range.count); instanceIndex++)
+                {
+                    VkAccelerationStructureInstanceKHR* desc = reinterpret_cast<VkAccelerationStructureInstanceKHR*>(resources.tlas.instancesUploadPtr + regionOffset + (instanceIndex * instanceSize));
+                    memcpy(desc->transform.matrix, scene.instances[instanceIndex].transform, sizeof(DirectX::XMFLOAT4) * 3);
+                }
+
+                // The other regions were last written by frames still in flight, so the whole range is copied from this region
+                VkBufferCopy bufferCopy = {};
+                bufferCopy.srcOffset = regionOffset + (range.first * instanceSize);
+                bufferCopy.dstOffset = range.first * instanceSize;
+                bufferCopy.size = range.count * instanceSize;
+                bufferCopies.push_back(bufferCopy);
+            }
+
+            // Wait for previous work to finish reading the instances and the TLAS
+            vkCmdPipelineBarrier(vk.cmdBuffer[vk.frameIndex], VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+
+            // Schedule a copy of the changed instances to the device buffer
+            vkCmdCopyBuffer(vk.cmdBuffer[vk.frameIndex], resources.tlas.instancesUpload, resources.tlas.instances, static_cast<uint32_t>(bufferCopies.size()), bufferCopies.data());
+
+            // Wait for the copy to finish before building the TLAS
+            VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+            vkCmdPipelineBarrier(vk.cmdBuffer[vk.frameIndex], VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ACCELERATION_STRUCTURE_BUILD_BIT_KHR, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+            // Refit or rebuild the TLAS
+            BuildTLAS(vk, resources.tlas, static_cast<uint32_t>(scene.instances.size()), (update == AccelerationStructures::ETLASUpdate::REFIT));
+        }
+
         /**
          * Create the scene textures.
          */
@@ -2428,6 +2568,140 @@ namespace Graphics
             return result;
         }
 
+        /**
+         * Copy the texels of a texture (all array slices) to memory. Texels are tightly packed: rows, then array slices.
+         */
+        bool ReadResourceTexels(Globals& vk, VkImage image, uint32_t width, uint32_t height, uint32_t arraySize, uint32_t texelSize, VkImageLayout originalLayout, uint8_t* data)
+        {
+            VkCommandPool commandPool = nullptr;
+            VkCommandBuffer commandBuffer = nullptr;
+
+            // Create a command pool
+            VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+            commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            commandPoolCreateInfo.queueFamilyIndex = vk.queueFamilyIndex;
+            commandPoolCreateInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+            VKCHECK(vkCreateCommandPool(vk.device, &commandPoolCreateInfo, nullptr, &commandPool));
+
+            // Create and begin the command buffer
+            VkCommandBufferAllocateInfo commandBufferAllocateInfo = {};
+            commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+            commandBufferAllocateInfo.commandBufferCount = 1;
+            commandBufferAllocateInfo.commandPool = commandPool;
+            commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            VKCHECK(vkAllocateCommandBuffers(vk.device, &commandBufferAllocateInfo, &commandBuffer));
+
+            VkCommandBufferBeginInfo commandBufferBeginInfo = {};
+            commandBufferBeginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+            VKCHECK(vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo));
+
+            // Create the staging (read-back) buffer
+            VkBuffer stagingBuffer = nullptr;
+            VkDeviceMemory stagingBufferMemory = nullptr;
+            VkDeviceSize sizeInBytes = (VkDeviceSize)width * height * arraySize * texelSize;
+            BufferDesc bufferDesc = { sizeInBytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+            if (!CreateBuffer(vk, bufferDesc, &stagingBuffer, &stagingBufferMemory)) return false;
+
+            // Transition the source resource to a copy source
+            ImageBarrierDesc barrier =
+            {
+                originalLayout,
+                VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, arraySize }
+            };
+            SetImageMemoryBarrier(commandBuffer, image, barrier);
+
+            // Copy all array slices to the buffer
+            VkBufferImageCopy region = {};
+            region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, arraySize };
+            region.imageExtent = { width, height, 1 };
+            vkCmdCopyImageToBuffer(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, stagingBuffer, 1, &region);
+
+            // Transition the source resource back to its original layout
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+            barrier.newLayout = originalLayout;
+            SetImageMemoryBarrier(commandBuffer, image, barrier);
+
+            // Execute GPU work
+            VKCHECK(vkEndCommandBuffer(commandBuffer));
+
+            VkSubmitInfo submitInfo = {};
+            submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &commandBuffer;
+            VKCHECK(vkQueueSubmit(vk.queue, 1, &submitInfo, VK_NULL_HANDLE));
+
+            WaitForGPU(vk);
+
+            // Copy the buffer to memory
+            uint8_t* pData = nullptr;
+            VKCHECK(vkMapMemory(vk.device, stagingBufferMemory, 0, VK_WHOLE_SIZE, 0, (void**)&pData));
+            memcpy(data, pData, static_cast<size_t>(sizeInBytes));
+            vkUnmapMemory(vk.device, stagingBufferMemory);
+
+            // Clean up
+            vkFreeMemory(vk.device, stagingBufferMemory, nullptr);
+            vkDestroyBuffer(vk.device, stagingBuffer, nullptr);
+            vkFreeCommandBuffers(vk.device, commandPool, 1, &commandBuffer);
+            vkDestroyCommandPool(vk.device, commandPool, nullptr);
+
+            return true;
+        }
+
+        /**
+         * Record a copy of texels (all array slices, tightly packed: rows, then array slices) to a texture.
+         * Release the upload buffer and its memory after the command buffer executes.
+         */
+        bool UploadResourceTexels(
+            Globals& vk,
+            VkCommandBuffer cmdBuffer,
+            VkImage image,
+            uint32_t width,
+            uint32_t height,
+            uint32_t arraySize,
+            uint32_t texelSize,
+            VkImageLayout originalLayout,
+            const uint8_t* data,
+            VkBuffer* uploadBuffer,
+            VkDeviceMemory* uploadMemory)
+        {
+            // Create the upload buffer and copy the texels to it
+            VkDeviceSize sizeInBytes = (VkDeviceSize)width * height * arraySize * texelSize;
+            BufferDesc bufferDesc = { sizeInBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT };
+            if (!CreateBuffer(vk, bufferDesc, uploadBuffer, uploadMemory)) return false;
+
+            uint8_t* pData = nullptr;
+            VKCHECK(vkMapMemory(vk.device, *uploadMemory, 0, VK_WHOLE_SIZE, 0, (void**)&pData));
+            memcpy(pData, data, static_cast<size_t>(sizeInBytes));
+            vkUnmapMemory(vk.device, *uploadMemory);
+
+            // Transition the texture to a copy destination
+            ImageBarrierDesc barrier =
+            {
+                originalLayout,
+                VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, arraySize }
+            };
+            SetImageMemoryBarrier(cmdBuffer, image, barrier);
+
+            // Copy all array slices from the upload buffer
+            VkBufferImageCopy region = {};
+            region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, arraySize };
+            region.imageExtent = { width, height, 1 };
+            vkCmdCopyBufferToImage(cmdBuffer, *uploadBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+            // Transition the texture back to its original layout
+            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+            barrier.newLayout = originalLayout;
+            SetImageMemoryBarrier(cmdBuffer, image, barrier);
+
+            return true;
+        }
+
     #ifdef GFX_NAME_OBJECTS
         /**
          * Sets a debug name for an object.
@@ -2497,8 +2771,10 @@ namespace Graphics
          */
         bool CreateDevice(Globals& vk, Configs::Config& config)
         {
+            vk.headless = config.app.headless;
+
             if(!CreateInstance(vk)) return false;
-            if(!CreateSurface(vk)) return false;
+            if(!vk.headless && !CreateSurface(vk)) return false;
             if(!CreateDeviceInternal(vk, config)) return false;
             return true;
         }
@@ -3151,10 +3427,6 @@ namespace Graphics
             vkFreeMemory(vk.device, resources.meshOffsetsRBUploadMemory, nullptr);
             vkDestroyBuffer(vk.device, resources.geometryDataRBUploadBuffer, nullptr);
             vkFreeMemory(vk.device, resources.geometryDataRBUploadMemory, nullptr);
-            vkDestroyBuffer(vk.device, resources.tlas.instancesUpload, nullptr);
-            vkFreeMemory(vk.device, resources.tlas.instancesUploadMemory, nullptr);
-            resources.tlas.instancesUpload = nullptr;
-            resources.tlas.instancesUploadMemory = nullptr;
 
             // Release scene geometry upload buffers
             uint32_t resourceIndex;
@@ -3216,7 +3488,7 @@ namespace Graphics
         }
 
         /**
-         * Update constant buffers.
+         * Update constant buffers and the scene TLAS.
          */
         void Update(Globals& vk, Resources& resources, const Configs::Config& config, Scenes::Scene& scene)
         {
@@ -3230,6 +3502,7 @@ namespace Graphics
             camera.data.resolution.y = (float)vk.height;
             camera.data.aspect = camera.data.resolution.x / camera.data.resolution.y;
             memcpy(resources.cameraCBPtr, camera.GetGPUData(), camera.GetGPUDataSize());
+            resources.camera = camera.data;
 
             // Update the lights buffer for lights that have been modified
             uint32_t lastDirtyLight = 0;
@@ -3252,6 +3525,9 @@ namespace Graphics
                 bufferCopy.size = Scenes::Light::GetGPUDataSize() * lastDirtyLight;
                 vkCmdCopyBuffer(vk.cmdBuffer[vk.frameIndex], resources.lightsSTBUploadBuffer, resources.lightsSTB, 1, &bufferCopy);
             }
+
+            // Update the scene TLAS for moved mesh instances
+            UpdateSceneTLAS(vk, resources, config, scene);
         }
 
         /**
@@ -3343,13 +3619,17 @@ namespace Graphics
 
             VkSubmitInfo submitInfo = {};
             submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-            submitInfo.waitSemaphoreCount = 1;
-            submitInfo.pWaitSemaphores = &vk.imageAcquiredSemaphore[vk.frameIndex];
-            submitInfo.pWaitDstStageMask = &waitDstStageMask;
             submitInfo.commandBufferCount = 1;
             submitInfo.pCommandBuffers = &vk.cmdBuffer[vk.frameIndex];
-            submitInfo.signalSemaphoreCount = 1;
-            submitInfo.pSignalSemaphores = &vk.presentSemaphore[vk.frameIndex];
+            if (!vk.headless)
+            {
+                // Wait for the acquired swap chain image and signal the presentation
+                submitInfo.waitSemaphoreCount = 1;
+                submitInfo.pWaitSemaphores = &vk.imageAcquiredSemaphore[vk.frameIndex];
+                submitInfo.pWaitDstStageMask = &waitDstStageMask;
+                submitInfo.signalSemaphoreCount = 1;
+                submitInfo.pSignalSemaphores = &vk.presentSemaphore[vk.frameIndex];
+            }
 
             // Submit the command buffer to the graphics queue
             VKCHECK(vkQueueSubmit(vk.queue, 1, &submitInfo, vk.fences[vk.frameIndex]));
@@ -3362,6 +3642,14 @@ namespace Graphics
          */
         bool Present(Globals& vk)
         {
+            if (vk.headless)
+            {
+                // Nothing to present, the offscreen back buffers just rotate
+                vk.frameNumber++;
+                vk.frameIndex = (vk.frameIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+                return true;
+            }
+
             // Present
             VkPresentInfoKHR presentInfo = {};
             presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -3435,6 +3723,12 @@ namespace Graphics
          */
         bool MoveToNextFrame(Globals& vk)
         {
+            if (vk.headless)
+            {
+                vk.imageIndex = vk.frameIndex;
+                return true;
+            }
+
             // Get the next available image from the swapchain
             VKCHECK(vkAcquireNextImageKHR(vk.device, vk.swapChain, UINT64_MAX, vk.imageAcquiredSemaphore[vk.frameIndex], VK_NULL_HANDLE, &vk.imageIndex));
             return true;
@@ -3520,7 +3814,7 @@ namespace Graphics
          */
         bool WriteBackBufferToDisk(Globals& vk, std::string directory)
         {
-            return WriteResourceToDisk(vk, directory + "/R-BackBuffer", vk.swapChainImage[vk.frameIndex], vk.width, vk.height, 1, vk.swapChainFormat, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+            return WriteResourceToDisk(vk, directory + "/R-BackBuffer", vk.swapChainImage[vk.frameIndex], vk.width, vk.height, 1, vk.swapChainFormat, vk.swapChainImageLayout);
         }
 
     }
@@ -17,6 +17,56 @@ namespace Graphics
     namespace DDGI
     {
 
+        //----------------------------------------------------------------------------------------------------------
+        // DDGIVolume Creation Helper Functions
+        //----------------------------------------------------------------------------------------------------------
+
+        /**
+         * Populates a DDGIVolumeDesc structure from configuration data.
+         */
+        void GetDDGIVolumeDesc(const Configs::DDGIVolume& config, DDGIVolumeDesc& volumeDesc)
+        {
+            size_t size = config.name.size();
+            volumeDesc.name = new char[size + 1];
+            memset(volumeDesc.name, 0, size + 1);
+            memcpy(volumeDesc.name, config.name.c_str(), size);
+
+            volumeDesc.index = config.index;
+            volumeDesc.rngSeed = config.rngSeed;
+            volumeDesc.origin = { config.origin.x, config.origin.y, config.origin.z };
+            volumeDesc.eulerAngles = { config.eulerAngles.x, config.eulerAngles.y, config.eulerAngles.z, };
+            volumeDesc.probeSpacing = { config.probeSpacing.x, config.probeSpacing.y, config.probeSpacing.z };
+            volumeDesc.probeCounts = { config.probeCounts.x, config.probeCounts.y, config.probeCounts.z, };
+            volumeDesc.probeNumRays = config.probeNumRays;
+            volumeDesc.probeNumIrradianceTexels = config.probeNumIrradianceTexels;
+            volumeDesc.probeNumIrradianceInteriorTexels = (config.probeNumIrradianceTexels - 2);
+            volumeDesc.probeNumDistanceTexels = config.probeNumDistanceTexels;
+            volumeDesc.probeNumDistanceInteriorTexels = (config.probeNumDistanceTexels - 2);
+            volumeDesc.probeHysteresis = config.probeHysteresis;
+            volumeDesc.probeNormalBias = config.probeNormalBias;
+            volumeDesc.probeViewBias = config.probeViewBias;
+            volumeDesc.probeMaxRayDistance = config.probeMaxRayDistance;
+            volumeDesc.probeIrradianceThreshold = config.probeIrradianceThreshold;
+            volumeDesc.probeBrightnessThreshold = config.probeBrightnessThreshold;
+
+            volumeDesc.showProbes = config.showProbes;
+            volumeDesc.probeVisType = config.probeVisType;
+
+            volumeDesc.probeRayDataFormat = config.textureFormats.rayDataFormat;
+            volumeDesc.probeIrradianceFormat = config.textureFormats.irradianceFormat;
+            volumeDesc.probeDistanceFormat = config.textureFormats.distanceFormat;
+            volumeDesc.probeDataFormat = config.textureFormats.dataFormat;
+            volumeDesc.probeVariabilityFormat = config.textureFormats.variabilityFormat;
+
+            volumeDesc.probeRelocationEnabled = config.probeRelocationEnabled;
+            volumeDesc.probeMinFrontfaceDistance = config.probeMinFrontfaceDistance;
+            volumeDesc.probeClassificationEnabled = config.probeClassificationEnabled;
+            volumeDesc.probeVariabilityEnabled = config.probeVariabilityEnabled;
+
+            if (config.infiniteScrollingEnabled) volumeDesc.movementType = EDDGIVolumeMovementType::Scrolling;
+            else volumeDesc.movementType = EDDGIVolumeMovementType::Default;
+        }
+
         //----------------------------------------------------------------------------------------------------------
         // DDGIVolume Shader Compilation
         //----------------------------------------------------------------------------------------------------------
@@ -288,5 +338,137 @@ namespace Graphics
             return true;
         }
 
+        //----------------------------------------------------------------------------------------------------------
+        // Scene Change Events
+        //----------------------------------------------------------------------------------------------------------
+
+        /**
+         * Send the scene changes since the last call (lights, sky, and moved mesh instances) to the DDGIVolumes,
+         * so each volume resets the probes the changes affect in its next update.
+         * Call after Scenes::UpdateTransforms() and before Graphics::Update() (which clears the light dirty flags).
+         */
+        void UpdateSceneChanges(Resources& resources, const Configs::Config& config, const Scenes::Scene& scene)
+        {
+            float3 skyRadiance = { config.scene.skyColor.x * config.scene.skyIntensity, config.scene.skyColor.y * config.scene.skyIntensity, config.scene.skyColor.z * config.scene.skyIntensity };
+
+            // Start tracking the scene when it is first seen (or its lights or instances were added or removed)
+            if (!resources.sceneTracked || resources.sceneLights.size() != scene.lights.size() || resources.sceneInstanceBoxes.size() != scene.instances.size())
+            {
+                resources.sceneLights.resize(scene.lights.size());
+                for (size_t lightIndex = 0; lightIndex < scene.lights.size(); lightIndex++) resources.sceneLights[lightIndex] = scene.lights[lightIndex].data;
+
+                resources.sceneInstanceBoxes.resize(scene.instances.size());
+                for (size_t instanceIndex = 0; instanceIndex < scene.instances.size(); instanceIndex++) resources.sceneInstanceBoxes[instanceIndex] = scene.instances[instanceIndex].boundingBox;
+
+                // A new set of lights or instances changes the whole scene
+                if (resources.sceneTracked)
+                {
+                    for (DDGIVolumeBase* volume : resources.volumes) volume->OnGlobalLightChange();
+                }
+
+                resources.sceneSkyRadiance = skyRadiance;
+                resources.sceneTracked = true;
+                return;
+            }
+
+            // The sky and directional lights affect all probes
+            bool globalChange = (skyRadiance.x != resources.sceneSkyRadiance.x || skyRadiance.y != resources.sceneSkyRadiance.y || skyRadiance.z != resources.sceneSkyRadiance.z);
+            resources.sceneSkyRadiance = skyRadiance;
+
+            // Spot and point lights affect the probes near their previous and current positions
+            for (size_t lightIndex = 0; lightIndex < scene.lights.size(); lightIndex++)
+            {
+                const Scenes::Light& light = scene.lights[lightIndex];
+                if (!light.dirty) continue;
+
+                Light& previous = resources.sceneLights[lightIndex];
+                if (light.type == ELightType::DIRECTIONAL)
+                {
+                    globalChange = true;
+                }
+                else
+                {
+                    for (DDGIVolumeBase* volume : resources.volumes)
+                    {
+                        volume->OnSmallLightChange(previous.position, previous.radius);
+                        volume->OnSmallLightChange(light.data.position, light.data.radius);
+                    }
+                }
+                previous = light.data;
+            }
+
+            if (globalChange)
+            {
+                for (DDGIVolumeBase* volume : resources.volumes) volume->OnGlobalLightChange();
+            }
+
+            // Moved mesh instances affect the probes near their previous and current bounds
+            for (uint32_t instanceIndex : scene.changedInstances)
+            {
+                rtxgi::AABB& previous = resources.sceneInstanceBoxes[instanceIndex];
+                const rtxgi::AABB& current = scene.instances[instanceIndex].boundingBox;
+                rtxgi::AABB bounds = { rtxgi::Min(previous.min, current.min), rtxgi::Max(previous.max, current.max) };
+                for (DDGIVolumeBase* volume : resources.volumes) volume->OnLargeObjectChange(bounds);
+                previous = current;
+            }
+        }
+
+        //----------------------------------------------------------------------------------------------------------
+        // Volume Snapshots
+        //----------------------------------------------------------------------------------------------------------
+
+        std::string GetVolumeSnapshotFile(const std::string& directory, const DDGIVolumeBase* volume)
+        {
+            return directory + "/DDGIVolume[" + volume->GetName() + "].ddgi";
+        }
+
+        /**
+         * Serialize a volume snapshot (with its textures read back from the GPU) and write it to disk.
+         */
+        bool WriteVolumeSnapshot(DDGIVolumeSnapshot& snapshot, const std::string& file, bool compress)
+        {
+            EDDGIVolumeSnapshotCompression compression = compress ? EDDGIVolumeSnapshotCompression::LZ : EDDGIVolumeSnapshotCompression::None;
+            if (snapshot.Serialize(compression) != ERTXGIStatus::OK) return false;
+
+            std::ofstream out(file, std::ios::out | std::ios::binary);
+            if (!out.is_open()) return false;
+
+            out.write(reinterpret_cast<const char*>(snapshot.GetSerializedData()), static_cast<std::streamsize>(snapshot.GetSerializedSizeInBytes()));
+            return out.good();
+        }
+
+        /**
+         * Read a volume's snapshot from disk (if one exists) and restore the volume's state from it.
+         * Returns false when the volume has no snapshot or its snapshot can't be loaded, in which case the volume starts cold.
+         */
+        bool ReadVolumeSnapshot(DDGIVolumeBase* volume, const std::string& directory, DDGIVolumeSnapshot& snapshot, std::ofstream& log)
+        {
+            std::string file = GetVolumeSnapshotFile(directory, volume);
+
+            std::ifstream in(file, std::ios::in | std::ios::binary | std::ios::ate);
+            if (!in.is_open()) return false;
+
+            std::vector<char> data(static_cast<size_t>(in.tellg()));
+            in.seekg(0, std::ios::beg);
+            in.read(data.data(), static_cast<std::streamsize>(data.size()));
+            if (!in.good())
+            {
+                log << "\nWarning: failed to read the DDGIVolume snapshot '" << file << "'!";
+                return false;
+            }
+
+            // Validate the snapshot and check that it matches the volume
+            ERTXGIStatus status = snapshot.Deserialize(data.data(), static_cast<uint64_t>(data.size()));
+            if (status == ERTXGIStatus::OK) status = snapshot.Restore(volume);
+            if (status != ERTXGIStatus::OK)
+            {
+                log << "\nWarning: the DDGIVolume snapshot '" << file << "' can't be loaded (error " << status << ")!";
+                return false;
+            }
+
+            log << "\nLoaded the DDGIVolume snapshot '" << file << "'.";
+            return true;
+        }
+
     } // namespace Graphics::DDGI
 }
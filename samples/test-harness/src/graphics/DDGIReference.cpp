@@ -0,0 +1,255 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+#include "graphics/DDGIReference.h"
+#include "graphics/DDGI.h"
+#include "ImageCapture.h"
+#include "Instrumentation.h"
+
+#include <rtxgi/Math.h>
+#include <rtxgi/ddgi/DDGIProbeBlending.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <random>
+
+using namespace rtxgi;
+
+namespace Graphics
+{
+    namespace DDGI
+    {
+        namespace Reference
+        {
+
+            //----------------------------------------------------------------------------------------------------------
+            // Private Functions
+            //----------------------------------------------------------------------------------------------------------
+
+            /**
+             * A DDGIVolume without graphics resources. Computes the volume's per-frame state (probe ray rotations,
+             * scrolling, and probe resets) with DDGIVolumeBase::Update(), like the D3D12 and Vulkan volumes.
+             */
+            class ReferenceVolume : public DDGIVolumeBase
+            {
+            public:
+                void Create(const DDGIVolumeDesc& desc)
+                {
+                    m_desc = desc;
+
+                    // Store the volume rotation
+                    m_rotationMatrix = EulerAnglesToRotationMatrix(desc.eulerAngles);
+                    m_rotationQuaternion = RotationMatrixToQuaternion(m_rotationMatrix);
+
+                    // Set the default scroll anchor to the origin
+                    m_probeScrollAnchor = m_desc.origin;
+
+                    // Initialize the random number generator if a seed is provided, otherwise use std::random_device()
+                    if (desc.rngSeed != 0)
+                    {
+                        SeedRNG((int)desc.rngSeed);
+                    }
+                    else
+                    {
+                        std::random_device rd;
+                        SeedRNG((int)rd());
+                    }
+                }
+
+                void Destroy() {}
+            };
+
+            /**
+             * The CPU copies of a volume's texture arrays.
+             */
+            struct VolumeTextures
+            {
+                uint32_t irradianceWidth = 0;
+                uint32_t irradianceHeight = 0;
+                uint32_t distanceWidth = 0;
+                uint32_t distanceHeight = 0;
+                uint32_t arraySize = 0;
+
+                std::vector<float4> rayData;
+                std::vector<float4> irradiance;
+                std::vector<float2> distance;
+            };
+
+            /**
+             * Allocate a volume's texture arrays and fill its ray data with sky (miss) rays.
+             */
+            void CreateVolumeTextures(const DDGIVolumeDescGPU& volume, const Configs::Config& config, VolumeTextures& textures)
+            {
+                uint32_t width, height;
+                cpu::GetDDGIVolumeTextureDimensions(volume, EDDGIVolumeTextureType::RayData, width, height, textures.arraySize);
+
+                // Rays that miss return the sky radiance and a large hit distance (see ProbeTraceRGS.hlsl)
+                const float4 miss =
+                {
+                    config.scene.skyColor.x * config.scene.skyIntensity,
+                    config.scene.skyColor.y * config.scene.skyIntensity,
+                    config.scene.skyColor.z * config.scene.skyIntensity,
+                    1e27f
+                };
+                textures.rayData.assign(static_cast<size_t>(width) * height * textures.arraySize, miss);
+
+                cpu::GetDDGIVolumeTextureDimensions(volume, EDDGIVolumeTextureType::Irradiance, textures.irradianceWidth, textures.irradianceHeight, textures.arraySize);
+                textures.irradiance.assign(static_cast<size_t>(textures.irradianceWidth) * textures.irradianceHeight * textures.arraySize, { 0.f, 0.f, 0.f, 0.f });
+
+                cpu::GetDDGIVolumeTextureDimensions(volume, EDDGIVolumeTextureType::Distance, textures.distanceWidth, textures.distanceHeight, textures.arraySize);
+                textures.distance.assign(static_cast<size_t>(textures.distanceWidth) * textures.distanceHeight * textures.arraySize, { 0.f, 0.f });
+            }
+
+            /**
+             * Returns true when all irradiance and distance texels are finite.
+             */
+            bool IsFinite(const VolumeTextures& textures)
+            {
+                for (const float4& texel : textures.irradiance)
+                {
+                    if (!std::isfinite(texel.x) || !std::isfinite(texel.y) || !std::isfinite(texel.z) || !std::isfinite(texel.w)) return false;
+                }
+                for (const float2& texel : textures.distance)
+                {
+                    if (!std::isfinite(texel.x) || !std::isfinite(texel.y)) return false;
+                }
+                return true;
+            }
+
+            /**
+             * Write one channel set of a texture array to disk, one PNG file per array slice.
+             * The convert function returns the RGB values (in [0, 1]) of a texel.
+             */
+            template<typename T, typename F>
+            bool WriteTextureArray(const std::string& file, const std::vector<T>& texels, uint32_t width, uint32_t height, uint32_t arraySize, F convert)
+            {
+                bool result = true;
+                std::vector<unsigned char> converted(static_cast<size_t>(width) * height * ImageCapture::NumChannels);
+                for (uint32_t slice = 0; slice < arraySize; slice++)
+                {
+                    const T* source = &texels[static_cast<size_t>(slice) * width * height];
+                    for (size_t texelIndex = 0; texelIndex < static_cast<size_t>(width) * height; texelIndex++)
+                    {
+                        float3 rgb = convert(source[texelIndex]);
+                        converted[texelIndex * 4 + 0] = static_cast<unsigned char>(std::clamp(rgb.x, 0.f, 1.f) * 255.f + 0.5f);
+                        converted[texelIndex * 4 + 1] = static_cast<unsigned char>(std::clamp(rgb.y, 0.f, 1.f) * 255.f + 0.5f);
+                        converted[texelIndex * 4 + 2] = static_cast<unsigned char>(std::clamp(rgb.z, 0.f, 1.f) * 255.f + 0.5f);
+                        converted[texelIndex * 4 + 3] = 255;
+                    }
+
+                    std::string filename = file;
+                    if (arraySize > 1) filename += "-Layer-" + std::to_string(slice);
+                    filename.append(".png");
+                    result &= ImageCapture::CapturePng(filename, width, height, converted.data());
+                }
+                return result;
+            }
+
+            /**
+             * Write a volume's irradiance and distance texture arrays to disk.
+             */
+            bool WriteVolumeTextures(const std::string& directory, const DDGIVolumeDesc& desc, const VolumeTextures& textures)
+            {
+                std::string file = directory + "/DDGIVolume[" + desc.name + "]-CPU";
+
+                // Irradiance texels are already gamma encoded
+                bool result = WriteTextureArray(file + "-Irradiance", textures.irradiance, textures.irradianceWidth, textures.irradianceHeight, textures.arraySize,
+                    [](const float4& texel) { return float3{ texel.x, texel.y, texel.z }; });
+
+                // Normalize the mean distances by the largest mean distance
+                float maxDistance = 0.f;
+                for (const float2& texel : textures.distance) maxDistance = std::max(maxDistance, texel.x);
+                const float scale = (maxDistance > 0.f) ? (1.f / maxDistance) : 0.f;
+
+                result &= WriteTextureArray(file + "-Distance", textures.distance, textures.distanceWidth, textures.distanceHeight, textures.arraySize,
+                    [scale](const float2& texel) { float value = texel.x * scale; return float3{ value, value, value }; });
+
+                return result;
+            }
+
+            //----------------------------------------------------------------------------------------------------------
+            // Public Functions
+            //----------------------------------------------------------------------------------------------------------
+
+            bool Run(const Configs::Config& config, uint32_t numFrames, std::ofstream& log)
+            {
+                std::filesystem::create_directories(config.scene.screenshotPath.c_str());
+
+                cpu::ProbeBlendingDesc blendingDesc = {};
+                bool result = true;
+                for (const Configs::DDGIVolume& volumeConfig : config.ddgi.volumes)
+                {
+                    DDGIVolumeDesc volumeDesc;
+                    Graphics::DDGI::GetDDGIVolumeDesc(volumeConfig, volumeDesc);
+
+                    // Without ray traced geometry there is nothing to relocate, classify, or adapt the ray counts to.
+                    // Ray data is stored at full precision.
+                    volumeDesc.probeRelocationEnabled = false;
+                    volumeDesc.probeClassificationEnabled = false;
+                    volumeDesc.probeVariabilityEnabled = false;
+                    volumeDesc.probeAdaptiveRaysEnabled = false;
+                    volumeDesc.probeRayDataFormat = EDDGIVolumeTextureFormat::F32x4;
+
+                    ReferenceVolume volume;
+                    volume.Create(volumeDesc);
+
+                    VolumeTextures textures;
+                    CreateVolumeTextures(volume.GetDescGPU(), config, textures);
+
+                    cpu::ProbeBlendingTextures blendingTextures = {};
+                    blendingTextures.rayData = textures.rayData.data();
+                    blendingTextures.probeIrradiance = textures.irradiance.data();
+                    blendingTextures.probeDistance = textures.distance.data();
+
+                    blendingDesc.probeDistanceFormat = volumeDesc.probeDistanceFormat;
+
+                    Instrumentation::Stat blendStat;
+                    ERTXGIStatus status = ERTXGIStatus::OK;
+                    for (uint32_t frameIndex = 0; frameIndex < numFrames && status == ERTXGIStatus::OK; frameIndex++)
+                    {
+                        volume.Update();
+
+                        CPU_TIMESTAMP_BEGIN(&blendStat);
+                        status = cpu::BlendDDGIVolumeProbes(volume.GetDescGPU(), blendingDesc, blendingTextures);
+                        CPU_TIMESTAMP_ENDANDRESOLVE(&blendStat);
+                    }
+
+                    if (status != ERTXGIStatus::OK)
+                    {
+                        log << "\nError: failed to blend the probes of DDGIVolume[" << volumeConfig.index << "] (\"" << volumeConfig.name << "\"), status " << static_cast<int>(status) << "!";
+                        result = false;
+                    }
+                    else if (!IsFinite(textures))
+                    {
+                        log << "\nError: DDGIVolume[" << volumeConfig.index << "] (\"" << volumeConfig.name << "\") has non-finite probe texels!";
+                        result = false;
+                    }
+                    else
+                    {
+                        log << "\n\tDDGIVolume[" << volumeConfig.index << "] (\"" << volumeConfig.name << "\"): " << numFrames << " frames, probe blending mean="
+                            << blendStat.mean << "ms, min=" << blendStat.minimum << "ms, max=" << blendStat.maximum << "ms";
+                        if (!WriteVolumeTextures(config.scene.screenshotPath, volumeDesc, textures))
+                        {
+                            log << "\nError: failed to write the probe textures of DDGIVolume[" << volumeConfig.index << "]!";
+                            result = false;
+                        }
+                    }
+
+                    delete[] volumeDesc.name;
+                }
+                std::flush(log);
+
+                return result;
+            }
+
+        } // namespace Graphics::DDGI::Reference
+    } // namespace Graphics::DDGI
+} // namespace Graphics
@@ -136,7 +136,7 @@ namespace Graphics
                         std::wstring name = L"DDGIVolume[" + std::to_wstring(volumeDesc.index) + L"], Probe Variability Average";
                         volumeResources.unmanaged.probeVariabilityAverage->SetName(name.c_str());
                     #endif
-                        BufferDesc readbackDesc = { sizeof(float)*2, 0, EHeapType::READBACK, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_FLAG_NONE };
+                        BufferDesc readbackDesc = { rtxgi::d3d12::GetDDGIVolumeVariabilityReadbackSizeInBytes(), 0, EHeapType::READBACK, D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_FLAG_NONE };
                         CHECK(CreateBuffer(d3d, readbackDesc, &volumeResources.unmanaged.probeVariabilityReadback), "create DDGIVolume Probe variability readback buffer!", log);
                     #ifdef GFX_NAME_OBJECTS
                         name = L"DDGIVolume[" + std::to_wstring(volumeDesc.index) + L"], Probe Variability Readback";
@@ -408,52 +408,6 @@ namespace Graphics
             // DDGIVolume Creation Helper Functions
             //----------------------------------------------------------------------------------------------------------
 
-            /**
-             * Populates a DDGIVolumeDesc structure from configuration data.
-             */
-            void GetDDGIVolumeDesc(const Configs::DDGIVolume& config, DDGIVolumeDesc& volumeDesc)
-            {
-                size_t size = config.name.size();
-                volumeDesc.name = new char[size + 1];
-                memset(volumeDesc.name, 0, size + 1);
-                memcpy(volumeDesc.name, config.name.c_str(), size);
-
-                volumeDesc.index = config.index;
-                volumeDesc.rngSeed = config.rngSeed;
-                volumeDesc.origin = { config.origin.x, config.origin.y, config.origin.z };
-                volumeDesc.eulerAngles = { config.eulerAngles.x, config.eulerAngles.y, config.eulerAngles.z, };
-                volumeDesc.probeSpacing = { config.probeSpacing.x, config.probeSpacing.y, config.probeSpacing.z };
-                volumeDesc.probeCounts = { config.probeCounts.x, config.probeCounts.y, config.probeCounts.z, };
-                volumeDesc.probeNumRays = config.probeNumRays;
-                volumeDesc.probeNumIrradianceTexels = config.probeNumIrradianceTexels;
-                volumeDesc.probeNumIrradianceInteriorTexels = (config.probeNumIrradianceTexels - 2);
-                volumeDesc.probeNumDistanceTexels = config.probeNumDistanceTexels;
-                volumeDesc.probeNumDistanceInteriorTexels = (config.probeNumDistanceTexels - 2);
-                volumeDesc.probeHysteresis = config.probeHysteresis;
-                volumeDesc.probeNormalBias = config.probeNormalBias;
-                volumeDesc.probeViewBias = config.probeViewBias;
-                volumeDesc.probeMaxRayDistance = config.probeMaxRayDistance;
-                volumeDesc.probeIrradianceThreshold = config.probeIrradianceThreshold;
-                volumeDesc.probeBrightnessThreshold = config.probeBrightnessThreshold;
-
-                volumeDesc.showProbes = config.showProbes;
-                volumeDesc.probeVisType = config.probeVisType;
-
-                volumeDesc.probeRayDataFormat = config.textureFormats.rayDataFormat;
-                volumeDesc.probeIrradianceFormat = config.textureFormats.irradianceFormat;
-                volumeDesc.probeDistanceFormat = config.textureFormats.distanceFormat;
-                volumeDesc.probeDataFormat = config.textureFormats.dataFormat;
-                volumeDesc.probeVariabilityFormat = config.textureFormats.variabilityFormat;
-
-                volumeDesc.probeRelocationEnabled = config.probeRelocationEnabled;
-                volumeDesc.probeMinFrontfaceDistance = config.probeMinFrontfaceDistance;
-                volumeDesc.probeClassificationEnabled = config.probeClassificationEnabled;
-                volumeDesc.probeVariabilityEnabled = config.probeVariabilityEnabled;
-
-                if (config.infiniteScrollingEnabled) volumeDesc.movementType = EDDGIVolumeMovementType::Scrolling;
-                else volumeDesc.movementType = EDDGIVolumeMovementType::Default;
-            }
-
             /**
              * Populates a DDGIVolumeResource structure.
              * In unmanaged resource mode, the application creates DDGIVolume graphics resources in CreateDDGIVolumeResources().
@@ -502,6 +456,7 @@ namespace Graphics
                 volumeResources.constantsBuffer = resources.volumeConstantsSTB;
                 volumeResources.constantsBufferUpload = resources.volumeConstantsSTBUpload;
                 volumeResources.constantsBufferSizeInBytes = resources.volumeConstantsSTBSizeInBytes;
+                volumeResources.constantsBufferUploadPtr = resources.volumeConstantsSTBUploadPtr;
 
                 // The Test Harness *always* accesses resources bindlessly when ray tracing, see RayTraceVolume().
                 // We store the bindless resource indices with the DDGIVolume so we can use the UploadDDGIVolumeResourceIndices() helper
@@ -519,6 +474,7 @@ namespace Graphics
                 volumeResources.bindless.resourceIndicesBuffer = resources.volumeResourceIndicesSTB;
                 volumeResources.bindless.resourceIndicesBufferUpload = resources.volumeResourceIndicesSTBUpload;
                 volumeResources.bindless.resourceIndicesBufferSizeInBytes = resources.volumeResourceIndicesSTBSizeInBytes;
+                volumeResources.bindless.resourceIndicesBufferUploadPtr = resources.volumeResourceIndicesSTBUploadPtr;
 
                 // Set the resource array indices of volume resources
                 DDGIVolumeResourceIndices& resourceIndices = volumeResources.bindless.resourceIndices;
@@ -606,6 +562,7 @@ namespace Graphics
                         SAFE_DELETE(resources.volumeDescs[volumeConfig.index].name);
                         SAFE_DELETE(resources.volumes[volumeConfig.index]);
                         resources.numVolumeVariabilitySamples[volumeConfig.index] = 0;
+                        resources.volumeVariabilityFrames[volumeConfig.index] = RTXGI_DDGI_VARIABILITY_READBACK_INVALID_FRAME;
                     }
                 }
                 else
@@ -613,11 +570,12 @@ namespace Graphics
                     resources.volumeDescs.emplace_back();
                     resources.volumes.emplace_back();
                     resources.numVolumeVariabilitySamples.emplace_back();
+                    resources.volumeVariabilityFrames.emplace_back(RTXGI_DDGI_VARIABILITY_READBACK_INVALID_FRAME);
                 }
 
                 // Describe the DDGIVolume's properties
                 DDGIVolumeDesc& volumeDesc = resources.volumeDescs[volumeConfig.index];
-                GetDDGIVolumeDesc(volumeConfig, volumeDesc);
+                Graphics::DDGI::GetDDGIVolumeDesc(volumeConfig, volumeDesc);
 
                 // Describe the DDGIVolume's resources and shaders
                 DDGIVolumeResources volumeResources;
@@ -683,6 +641,10 @@ namespace Graphics
                 resources.volumeResourceIndicesSTBUpload->SetName(L"DDGIVolume Resource Indices Upload Structured Buffer");
             #endif
 
+                // Persistently map the upload buffer
+                D3D12_RANGE readRange = {};
+                D3DCHECK(resources.volumeResourceIndicesSTBUpload->Map(0, &readRange, reinterpret_cast<void**>(&resources.volumeResourceIndicesSTBUploadPtr)));
+
                 // Create the DDGIVolume resource indices device buffer resource
                 desc = { resources.volumeResourceIndicesSTBSizeInBytes, 0, EHeapType::DEFAULT, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_FLAG_NONE };
                 CHECK(CreateBuffer(d3d, desc, &resources.volumeResourceIndicesSTB), "create DDGIVolume resource indices structured buffer!\n", log);
@@ -720,6 +682,10 @@ namespace Graphics
                 resources.volumeConstantsSTBUpload->SetName(L"DDGIVolume Constants Upload Structured Buffer");
             #endif
 
+                // Persistently map the upload buffer
+                D3D12_RANGE readRange = {};
+                D3DCHECK(resources.volumeConstantsSTBUpload->Map(0, &readRange, reinterpret_cast<void**>(&resources.volumeConstantsSTBUploadPtr)));
+
                 // Create the DDGIVolume constants device buffer resource
                 desc = { resources.volumeConstantsSTBSizeInBytes, 0, EHeapType::DEFAULT, D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_FLAG_NONE };
                 CHECK(CreateBuffer(d3d, desc, &resources.volumeConstantsSTB), "create DDGIVolume constants structured buffer!\n", log);
@@ -1112,6 +1078,64 @@ namespace Graphics
             #endif
             }
 
+            /**
+             * Get the volume's texture of the given type.
+             */
+            ID3D12Resource* GetDDGIVolumeTexture(const DDGIVolume* volume, EDDGIVolumeTextureType type)
+            {
+                if (type == EDDGIVolumeTextureType::Irradiance) return volume->GetProbeIrradiance();
+                if (type == EDDGIVolumeTextureType::Distance) return volume->GetProbeDistance();
+                if (type == EDDGIVolumeTextureType::Data) return volume->GetProbeData();
+                if (type == EDDGIVolumeTextureType::Variability) return volume->GetProbeVariability();
+                return nullptr;
+            }
+
+            /**
+             * Get the state of the volume's texture of the given type between frames.
+             */
+            D3D12_RESOURCE_STATES GetDDGIVolumeTextureState(EDDGIVolumeTextureType type)
+            {
+                if (type == EDDGIVolumeTextureType::Variability) return D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+                return D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+            }
+
+            /**
+             * Load the volume's snapshot (if one exists) and record the upload of its textures to the global command list.
+             * Volumes without a (loadable) snapshot start from cleared probes.
+             */
+            bool LoadVolumeSnapshot(Globals& d3d, Resources& resources, DDGIVolume* volume, const std::string& directory, std::ofstream& log)
+            {
+                DDGIVolumeSnapshot snapshot;
+                if (!Graphics::DDGI::ReadVolumeSnapshot(volume, directory, snapshot, log)) return true;
+
+                for (UINT textureIndex = 0; textureIndex < static_cast<UINT>(EDDGIVolumeTextureType::Count); textureIndex++)
+                {
+                    EDDGIVolumeTextureType type = static_cast<EDDGIVolumeTextureType>(textureIndex);
+                    if (!snapshot.HasTexture(type)) continue;
+
+                    ID3D12Resource* upload = nullptr;
+                    if (!UploadResourceTexels(d3d, d3d.cmdList[d3d.frameIndex], GetDDGIVolumeTexture(volume, type), GetDDGIVolumeTextureState(type), snapshot.GetTextureData(type), &upload))
+                    {
+                        log << "\nError: failed to upload the DDGIVolume snapshot textures!";
+                        return false;
+                    }
+                    resources.snapshotUploadBuffers.push_back(upload);
+                }
+                return true;
+            }
+
+            /**
+             * Release the snapshot texture upload buffers.
+             */
+            void ReleaseVolumeSnapshotUploads(Resources& resources)
+            {
+                for (size_t bufferIndex = 0; bufferIndex < resources.snapshotUploadBuffers.size(); bufferIndex++)
+                {
+                    SAFE_RELEASE(resources.snapshotUploadBuffers[bufferIndex]);
+                }
+                resources.snapshotUploadBuffers.clear();
+            }
+
             //----------------------------------------------------------------------------------------------------------
             // Public Functions
             //----------------------------------------------------------------------------------------------------------
@@ -1153,6 +1177,9 @@ namespace Graphics
                     // Clear the volume's probes at initialization
                     DDGIVolume* volume = static_cast<DDGIVolume*>(resources.volumes[volumeIndex]);
                     volume->ClearProbes(d3d.cmdList[d3d.frameIndex]);
+
+                    // Load the volume's probe data snapshot over the cleared probes
+                    if (!config.ddgi.snapshotPath.empty() && !LoadVolumeSnapshot(d3d, resources, volume, config.ddgi.snapshotPath, log)) return false;
                 }
 
                 // Setup performance stats
@@ -1207,6 +1234,9 @@ namespace Graphics
             {
                 CPU_TIMESTAMP_BEGIN(resources.cpuStat);
 
+                // Snapshot textures uploaded at initialization have completed (see PostInitialize())
+                if (!resources.snapshotUploadBuffers.empty()) ReleaseVolumeSnapshotUploads(resources);
+
                 resources.enabled = config.ddgi.enabled;
                 if (resources.enabled)
                 {
@@ -1226,36 +1256,73 @@ namespace Graphics
                         resources.numVolumeVariabilitySamples[config.ddgi.selectedVolume] = 0;
                     }
 
-                    // Select the active volumes
-                    resources.selectedVolumes.clear();
-                    for (UINT volumeIndex = 0; volumeIndex < static_cast<UINT>(resources.volumes.size()); volumeIndex++)
+                    // Find the volumes that need updates
+                    uint32_t numVolumes = static_cast<uint32_t>(resources.volumes.size());
+                    resources.volumeUpdateEnabled.resize(numVolumes);
+                    resources.scheduledVolumeIndices.resize(numVolumes);
+                    for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
                     {
-                        // TODO: processing to determine which volumes are in-frustum, active, and prioritized for update / render
-
                         // Get the volume
                         DDGIVolume* volume = static_cast<DDGIVolume*>(resources.volumes[volumeIndex]);
 
                         // If the scene's lights, skylight, or geometry have changed *or* the volume moves *or* the probes are reset, reset the variability
                         if (config.ddgi.volumes[volumeIndex].clearProbeVariability) resources.numVolumeVariabilitySamples[volumeIndex] = 0;
 
+                        // Scene changes reset some of the volume's probes (see UpdateSceneChanges()), so the volume is no longer converged
+                        if (volume->GetProbeResetPending()) resources.numVolumeVariabilitySamples[volumeIndex] = 0;
+
                         // Don't update volumes whose variability measurement is low enough to be considered converged
                         // Enforce a minimum of 16 samples to filter out early outliers
                         const uint32_t MinimumVariabilitySamples = 16;
-                        float volumeAverageVariability = volume->GetVolumeAverageVariability();
+                        // Only count variability values that have not been counted before (readbacks lag the GPU by a few frames)
+                        uint64_t variabilityFrame;
+                        float volumeAverageVariability = volume->GetVolumeAverageVariability(variabilityFrame);
+                        if (variabilityFrame != RTXGI_DDGI_VARIABILITY_READBACK_INVALID_FRAME && variabilityFrame != resources.volumeVariabilityFrames[volumeIndex])
+                        {
+                            resources.volumeVariabilityFrames[volumeIndex] = variabilityFrame;
+                            resources.numVolumeVariabilitySamples[volumeIndex]++;
+                        }
+
                         bool isConverged = volume->GetProbeVariabilityEnabled()
-                                                && (resources.numVolumeVariabilitySamples[volumeIndex]++ > MinimumVariabilitySamples)
-                                                && (volumeAverageVariability < config.ddgi.volumes[config.ddgi.selectedVolume].probeVariabilityThreshold);
+                                                && (resources.numVolumeVariabilitySamples[volumeIndex] > MinimumVariabilitySamples)
+                                                && (volumeAverageVariability < config.ddgi.volumes[volumeIndex].probeVariabilityThreshold);
 
-                        // Add the volume to the list of volumes to update (it hasn't converged)
-                        if (!isConverged) resources.selectedVolumes.push_back(volume);
+                        // Volumes with updates disabled (e.g. by a benchmark scenario) keep their current probe data
+                        resources.volumeUpdateEnabled[volumeIndex] = (isConverged || !config.ddgi.volumes[volumeIndex].updateEnabled) ? 0 : 1;
                     }
 
-                    // Update the constants for the selected DDGIVolumes
-                    for (UINT volumeIndex = 0; volumeIndex < static_cast<UINT>(resources.selectedVolumes.size()); volumeIndex++)
+                    // Prioritize the volumes that haven't converged by visibility, distance, variability, and time since their last update
+                    // and select the volumes to update this frame within the ray budget
+                    const Camera& camera = d3dResources.camera;
+                    DDGIVolumeSchedulerInputs schedulerInputs = {};
+                    schedulerInputs.cameraPosition = camera.position;
+                    schedulerInputs.frustum = ComputeDDGIFrustum(camera.position, camera.forward, camera.right, camera.up, camera.tanHalfFovY, camera.aspect);
+                    schedulerInputs.rayBudget = config.ddgi.rayBudget;
+
+                    uint32_t numScheduledVolumes = resources.volumeScheduler.Schedule(
+                        schedulerInputs,
+                        numVolumes,
+                        resources.volumes.data(),
+                        resources.volumeUpdateEnabled.data(),
+                        resources.scheduledVolumeIndices.data());
+
+                    // Add the scheduled volumes to the list of volumes to update (highest priority first)
+                    resources.selectedVolumes.clear();
+                    for (uint32_t scheduledIndex = 0; scheduledIndex < numScheduledVolumes; scheduledIndex++)
                     {
-                        resources.selectedVolumes[volumeIndex]->Update();
+                        uint32_t volumeIndex = resources.scheduledVolumeIndices[scheduledIndex];
+                        resources.selectedVolumes.push_back(static_cast<DDGIVolume*>(resources.volumes[volumeIndex]));
                     }
 
+                    // Update and pack the constants for the selected DDGIVolumes in parallel
+                    resources.selectedVolumeDescs.resize(numScheduledVolumes);
+                    rtxgi::UpdateDDGIVolumes(
+                        resources.volumeUpdateThreadPool,
+                        numScheduledVolumes,
+                        resources.volumes.data(),
+                        resources.scheduledVolumeIndices.data(),
+                        resources.selectedVolumeDescs.data());
+
                 }
                 CPU_TIMESTAMP_END(resources.cpuStat);
             }
@@ -1276,7 +1343,7 @@ namespace Graphics
 
                     // Upload volume resource indices and constants
                     rtxgi::d3d12::UploadDDGIVolumeResourceIndices(d3d.cmdList[d3d.frameIndex], d3d.frameIndex, numVolumes, resources.selectedVolumes.data());
-                    rtxgi::d3d12::UploadDDGIVolumeConstants(d3d.cmdList[d3d.frameIndex], d3d.frameIndex, numVolumes, resources.selectedVolumes.data());
+                    rtxgi::d3d12::UploadDDGIVolumeConstants(d3d.cmdList[d3d.frameIndex], d3d.frameIndex, numVolumes, resources.selectedVolumes.data(), resources.selectedVolumeDescs.data());
 
                     // Trace rays from DDGI probes to sample the environment
                     GPU_TIMESTAMP_BEGIN(resources.rtStat->GetGPUQueryBeginIndex());
@@ -1300,9 +1367,10 @@ namespace Graphics
 
                     // Calculate variability
                     GPU_TIMESTAMP_BEGIN(resources.variabilityStat->GetGPUQueryBeginIndex());
-                    rtxgi::d3d12::CalculateDDGIVolumeVariability(d3d.cmdList[d3d.frameIndex], numVolumes, resources.selectedVolumes.data());
-                    // The readback happens immediately, not recorded on the command list, so will return a value from a previous update
-                    rtxgi::d3d12::ReadbackDDGIVolumeVariability(numVolumes, resources.selectedVolumes.data());
+                    rtxgi::d3d12::CalculateDDGIVolumeVariability(d3d.cmdList[d3d.frameIndex], numVolumes, resources.selectedVolumes.data(), resources.variabilityFrameIndex);
+                    // The readback happens immediately, not recorded on the command list, so will return the newest value the GPU has finished writing
+                    rtxgi::d3d12::ReadbackDDGIVolumeVariability(numVolumes, resources.selectedVolumes.data(), resources.variabilityFrameIndex);
+                    resources.variabilityFrameIndex++;
                     GPU_TIMESTAMP_END(resources.variabilityStat->GetGPUQueryEndIndex());
 
                     // Gather indirect lighting in screen-space
@@ -1324,6 +1392,7 @@ namespace Graphics
             void Cleanup(Resources& resources)
             {
                 SAFE_RELEASE(resources.output);
+                ReleaseVolumeSnapshotUploads(resources);
 
                 SAFE_RELEASE(resources.shaderTable);
                 SAFE_RELEASE(resources.shaderTableUpload);
@@ -1346,10 +1415,12 @@ namespace Graphics
                 SAFE_RELEASE(resources.rtvDescriptorHeap);
                 SAFE_RELEASE(resources.volumeResourceIndicesSTB);
                 SAFE_RELEASE(resources.volumeResourceIndicesSTBUpload);
+                resources.volumeResourceIndicesSTBUploadPtr = nullptr;
 
                 resources.volumeResourceIndicesSTBSizeInBytes = 0;
                 SAFE_RELEASE(resources.volumeConstantsSTB);
                 SAFE_RELEASE(resources.volumeConstantsSTBUpload);
+                resources.volumeConstantsSTBUploadPtr = nullptr;
                 resources.volumeConstantsSTBSizeInBytes = 0;
 
                 // Release volumes
@@ -1406,6 +1477,35 @@ namespace Graphics
                 return success;
             }
 
+            /**
+             * Write snapshots of the DDGI Volumes' probe data to disk.
+             */
+            bool WriteVolumeSnapshots(Globals& d3d, GlobalResources& d3dResources, Resources& resources, std::string directory, bool compress)
+            {
+                bool success = true;
+                for (UINT volumeIndex = 0; volumeIndex < static_cast<UINT>(resources.volumes.size()); volumeIndex++)
+                {
+                    // Get the volume
+                    const DDGIVolume* volume = static_cast<DDGIVolume*>(resources.volumes[volumeIndex]);
+
+                    DDGIVolumeSnapshot snapshot;
+                    if (snapshot.Capture(volume) != ERTXGIStatus::OK) { success = false; continue; }
+
+                    // Read back the volume's textures
+                    bool read = true;
+                    for (UINT textureIndex = 0; textureIndex < static_cast<UINT>(EDDGIVolumeTextureType::Count); textureIndex++)
+                    {
+                        EDDGIVolumeTextureType type = static_cast<EDDGIVolumeTextureType>(textureIndex);
+                        if (!snapshot.HasTexture(type)) continue;
+                        read &= ReadResourceTexels(d3d, GetDDGIVolumeTexture(volume, type), GetDDGIVolumeTextureState(type), snapshot.GetTextureData(type));
+                    }
+
+                    if (read) success &= Graphics::DDGI::WriteVolumeSnapshot(snapshot, Graphics::DDGI::GetVolumeSnapshotFile(directory, volume), compress);
+                    else success = false;
+                }
+                return success;
+            }
+
         } // namespace Graphics::D3D12::RTAO
 
     } // namespace Graphics::D3D12
@@ -1448,5 +1548,10 @@ namespace Graphics
             return Graphics::D3D12::DDGI::WriteVolumesToDisk(d3d, d3dResources, resources, directory);
         }
 
+        bool WriteVolumeSnapshots(Globals& d3d, GlobalResources& d3dResources, Resources& resources, std::string directory, bool compress)
+        {
+            return Graphics::D3D12::DDGI::WriteVolumeSnapshots(d3d, d3dResources, resources, directory, compress);
+        }
+
     } // namespace Graphics::DDGI
 }
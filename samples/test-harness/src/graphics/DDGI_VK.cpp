@@ -249,7 +249,7 @@ namespace Graphics
                         if (width <= 0 || height <= 0) return false;
                         format = GetDDGIVolumeTextureFormat(EDDGIVolumeTextureType::Variability, volumeDesc.probeVariabilityFormat);
 
-                        TextureDesc desc = { width, height, arraySize, 1, format, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT };
+                        TextureDesc desc = { width, height, arraySize, 1, format, VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT };
                         CHECK(CreateTexture(vk, desc, &volumeResources.unmanaged.probeVariability, &volumeResources.unmanaged.probeVariabilityMemory, &volumeResources.unmanaged.probeVariabilityView), "create DDGIVolume Probe variability texture!", log);
                     #ifdef GFX_NAME_OBJECTS
                         std::string n = "DDGIVolume[" + std::to_string(volumeDesc.index) + "], Probe Variability";
@@ -275,7 +275,7 @@ namespace Graphics
                         SetObjectName(vk.device, reinterpret_cast<uint64_t>(volumeResources.unmanaged.probeVariabilityAverageMemory), GetResourceName(n, o, VK_OBJECT_TYPE_DEVICE_MEMORY), VK_OBJECT_TYPE_DEVICE_MEMORY);
                         SetObjectName(vk.device, reinterpret_cast<uint64_t>(volumeResources.unmanaged.probeVariabilityAverageView), GetResourceName(n, o, VK_OBJECT_TYPE_IMAGE_VIEW), VK_OBJECT_TYPE_IMAGE_VIEW);
                     #endif
-                        BufferDesc readbackDesc = { sizeof(float)*2, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT };
+                        BufferDesc readbackDesc = { rtxgi::vulkan::GetDDGIVolumeVariabilityReadbackSizeInBytes(), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT };
                         CHECK(CreateBuffer(vk, readbackDesc, &volumeResources.unmanaged.probeVariabilityReadback, &volumeResources.unmanaged.probeVariabilityReadbackMemory), "create DDGIVolume Probe variability readback buffer!", log);
                     #ifdef GFX_NAME_OBJECTS
                         n = "DDGIVolume[" + std::to_string(volumeDesc.index) + "], Probe Variability Readback";
@@ -582,52 +582,6 @@ namespace Graphics
             // DDGIVolume Creation Helper Functions
             //----------------------------------------------------------------------------------------------------------
 
-            /**
-             * Populates a DDGIVolumeDesc structure from configuration data.
-             */
-            void GetDDGIVolumeDesc(const Configs::DDGIVolume& config, DDGIVolumeDesc& volumeDesc)
-            {
-                size_t size = config.name.size();
-                volumeDesc.name = new char[size + 1];
-                memset(volumeDesc.name, 0, size + 1);
-                memcpy(volumeDesc.name, config.name.c_str(), size);
-
-                volumeDesc.index = config.index;
-                volumeDesc.rngSeed = config.rngSeed;
-                volumeDesc.origin = { config.origin.x, config.origin.y, config.origin.z };
-                volumeDesc.eulerAngles = { config.eulerAngles.x, config.eulerAngles.y, config.eulerAngles.z, };
-                volumeDesc.probeSpacing = { config.probeSpacing.x, config.probeSpacing.y, config.probeSpacing.z };
-                volumeDesc.probeCounts = { config.probeCounts.x, config.probeCounts.y, config.probeCounts.z, };
-                volumeDesc.probeNumRays = config.probeNumRays;
-                volumeDesc.probeNumIrradianceTexels = config.probeNumIrradianceTexels;
-                volumeDesc.probeNumIrradianceInteriorTexels = (config.probeNumIrradianceTexels - 2);
-                volumeDesc.probeNumDistanceTexels = config.probeNumDistanceTexels;
-                volumeDesc.probeNumDistanceInteriorTexels = (config.probeNumDistanceTexels - 2);
-                volumeDesc.probeHysteresis = config.probeHysteresis;
-                volumeDesc.probeNormalBias = config.probeNormalBias;
-                volumeDesc.probeViewBias = config.probeViewBias;
-                volumeDesc.probeMaxRayDistance = config.probeMaxRayDistance;
-                volumeDesc.probeIrradianceThreshold = config.probeIrradianceThreshold;
-                volumeDesc.probeBrightnessThreshold = config.probeBrightnessThreshold;
-
-                volumeDesc.showProbes = config.showProbes;
-                volumeDesc.probeVisType = config.probeVisType;
-
-                volumeDesc.probeRayDataFormat = config.textureFormats.rayDataFormat;
-                volumeDesc.probeIrradianceFormat = config.textureFormats.irradianceFormat;
-                volumeDesc.probeDistanceFormat = config.textureFormats.distanceFormat;
-                volumeDesc.probeDataFormat = config.textureFormats.dataFormat;
-                volumeDesc.probeVariabilityFormat = config.textureFormats.variabilityFormat;
-
-                volumeDesc.probeRelocationEnabled = config.probeRelocationEnabled;
-                volumeDesc.probeMinFrontfaceDistance = config.probeMinFrontfaceDistance;
-                volumeDesc.probeClassificationEnabled = config.probeClassificationEnabled;
-                volumeDesc.probeVariabilityEnabled = config.probeVariabilityEnabled;
-
-                if (config.infiniteScrollingEnabled) volumeDesc.movementType = EDDGIVolumeMovementType::Scrolling;
-                else volumeDesc.movementType = EDDGIVolumeMovementType::Default;
-            }
-
             /**
              * Populates a DDGIVolumeResource structure.
              * In unmanaged resource mode, the application creates DDGIVolume graphics resources in CreateDDGIVolumeResources().
@@ -659,6 +613,7 @@ namespace Graphics
                 volumeResources.constantsBufferUpload = resources.volumeConstantsSTBUpload;
                 volumeResources.constantsBufferUploadMemory = resources.volumeConstantsSTBUploadMemory;
                 volumeResources.constantsBufferSizeInBytes = resources.volumeConstantsSTBSizeInBytes;
+                volumeResources.constantsBufferUploadPtr = resources.volumeConstantsSTBUploadPtr;
 
                 // Regardless of what the host application chooses for resource binding, all SDK shaders can operate in either bound or bindless modes
                 volumeResources.bindless.enabled = (bool)RTXGI_DDGI_BINDLESS_RESOURCES;
@@ -668,6 +623,7 @@ namespace Graphics
                 volumeResources.bindless.resourceIndicesBufferUpload = resources.volumeResourceIndicesSTBUpload;
                 volumeResources.bindless.resourceIndicesBufferUploadMemory = resources.volumeResourceIndicesSTBUploadMemory;
                 volumeResources.bindless.resourceIndicesBufferSizeInBytes = resources.volumeResourceIndicesSTBSizeInBytes;
+                volumeResources.bindless.resourceIndicesBufferUploadPtr = resources.volumeResourceIndicesSTBUploadPtr;
 
                 // Set the resource array indices of volume resources
                 DDGIVolumeResourceIndices& resourceIndices = volumeResources.bindless.resourceIndices;
@@ -745,6 +701,7 @@ namespace Graphics
                         SAFE_DELETE(resources.volumeDescs[volumeConfig.index].name);
                         SAFE_DELETE(resources.volumes[volumeConfig.index]);
                         resources.numVolumeVariabilitySamples[volumeConfig.index] = 0;
+                        resources.volumeVariabilityFrames[volumeConfig.index] = RTXGI_DDGI_VARIABILITY_READBACK_INVALID_FRAME;
                     }
                 }
                 else
@@ -752,11 +709,12 @@ namespace Graphics
                     resources.volumeDescs.emplace_back();
                     resources.volumes.emplace_back();
                     resources.numVolumeVariabilitySamples.emplace_back();
+                    resources.volumeVariabilityFrames.emplace_back(RTXGI_DDGI_VARIABILITY_READBACK_INVALID_FRAME);
                 }
 
                 // Describe the DDGIVolume's properties
                 DDGIVolumeDesc& volumeDesc = resources.volumeDescs[volumeConfig.index];
-                GetDDGIVolumeDesc(volumeConfig, volumeDesc);
+                Graphics::DDGI::GetDDGIVolumeDesc(volumeConfig, volumeDesc);
 
                 // Describe the DDGIVolume's resources and shaders
                 DDGIVolumeResources volumeResources;
@@ -806,6 +764,9 @@ namespace Graphics
                 SetObjectName(vk.device, reinterpret_cast<uint64_t>(resources.volumeResourceIndicesSTBUploadMemory), "DDGIVolume Resource Indices Upload Structured Buffer Memory", VK_OBJECT_TYPE_DEVICE_MEMORY);
             #endif
 
+                // Persistently map the upload buffer
+                VKCHECK(vkMapMemory(vk.device, resources.volumeResourceIndicesSTBUploadMemory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&resources.volumeResourceIndicesSTBUploadPtr)));
+
                 // Create the DDGIVolume resource indices device buffer resources
                 desc.size = resources.volumeResourceIndicesSTBSizeInBytes;
                 desc.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
@@ -835,6 +796,9 @@ namespace Graphics
                 SetObjectName(vk.device, reinterpret_cast<uint64_t>(resources.volumeConstantsSTBUploadMemory), "DDGIVolume Constants Upload Structured Buffer Memory", VK_OBJECT_TYPE_DEVICE_MEMORY);
             #endif
 
+                // Persistently map the upload buffer
+                VKCHECK(vkMapMemory(vk.device, resources.volumeConstantsSTBUploadMemory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&resources.volumeConstantsSTBUploadPtr)));
+
                 // Create the DDGIVolume constants device buffer resources
                 desc.size = resources.volumeConstantsSTBSizeInBytes;
                 desc.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
@@ -1479,6 +1443,63 @@ namespace Graphics
             #endif
             }
 
+            /**
+             * Get the volume's texture of the given type.
+             */
+            VkImage GetDDGIVolumeTexture(const DDGIVolume* volume, EDDGIVolumeTextureType type)
+            {
+                if (type == EDDGIVolumeTextureType::Irradiance) return volume->GetProbeIrradiance();
+                if (type == EDDGIVolumeTextureType::Distance) return volume->GetProbeDistance();
+                if (type == EDDGIVolumeTextureType::Data) return volume->GetProbeData();
+                if (type == EDDGIVolumeTextureType::Variability) return volume->GetProbeVariability();
+                return nullptr;
+            }
+
+            /**
+             * Load the volume's snapshot (if one exists) and record the upload of its textures to the global command buffer.
+             * Volumes without a (loadable) snapshot start from cleared probes.
+             */
+            bool LoadVolumeSnapshot(Globals& vk, Resources& resources, DDGIVolume* volume, const std::string& directory, std::ofstream& log)
+            {
+                DDGIVolumeSnapshot snapshot;
+                if (!Graphics::DDGI::ReadVolumeSnapshot(volume, directory, snapshot, log)) return true;
+
+                for (uint32_t textureIndex = 0; textureIndex < static_cast<uint32_t>(EDDGIVolumeTextureType::Count); textureIndex++)
+                {
+                    EDDGIVolumeTextureType type = static_cast<EDDGIVolumeTextureType>(textureIndex);
+                    if (!snapshot.HasTexture(type)) continue;
+
+                    uint32_t width, height, arraySize;
+                    snapshot.GetTextureDimensions(type, width, height, arraySize);
+                    uint32_t texelSize = GetDDGIVolumeTextureFormatSize(snapshot.GetTextureFormat(type));
+
+                    VkBuffer uploadBuffer = nullptr;
+                    VkDeviceMemory uploadMemory = nullptr;
+                    if (!UploadResourceTexels(vk, vk.cmdBuffer[vk.frameIndex], GetDDGIVolumeTexture(volume, type), width, height, arraySize, texelSize, VK_IMAGE_LAYOUT_GENERAL, snapshot.GetTextureData(type), &uploadBuffer, &uploadMemory))
+                    {
+                        log << "\nError: failed to upload the DDGIVolume snapshot textures!";
+                        return false;
+                    }
+                    resources.snapshotUploadBuffers.push_back(uploadBuffer);
+                    resources.snapshotUploadMemory.push_back(uploadMemory);
+                }
+                return true;
+            }
+
+            /**
+             * Release the snapshot texture upload buffers.
+             */
+            void ReleaseVolumeSnapshotUploads(VkDevice device, Resources& resources)
+            {
+                for (size_t bufferIndex = 0; bufferIndex < resources.snapshotUploadBuffers.size(); bufferIndex++)
+                {
+                    vkDestroyBuffer(device, resources.snapshotUploadBuffers[bufferIndex], nullptr);
+                    vkFreeMemory(device, resources.snapshotUploadMemory[bufferIndex], nullptr);
+                }
+                resources.snapshotUploadBuffers.clear();
+                resources.snapshotUploadMemory.clear();
+            }
+
             //----------------------------------------------------------------------------------------------------------
             // Public Functions
             //----------------------------------------------------------------------------------------------------------
@@ -1528,6 +1549,9 @@ namespace Graphics
                     // Clear the volume's probes at initialization
                     DDGIVolume* volume = static_cast<DDGIVolume*>(resources.volumes[volumeIndex]);
                     volume->ClearProbes(vk.cmdBuffer[vk.frameIndex]);
+
+                    // Load the volume's probe data snapshot over the cleared probes
+                    if (!config.ddgi.snapshotPath.empty() && !LoadVolumeSnapshot(vk, resources, volume, config.ddgi.snapshotPath, log)) return false;
                 }
 
                 // Initialize the shader table and bindless descriptor set
@@ -1599,6 +1623,9 @@ namespace Graphics
             {
                 CPU_TIMESTAMP_BEGIN(resources.cpuStat);
 
+                // Snapshot textures uploaded at initialization have completed (see PostInitialize())
+                if (!resources.snapshotUploadBuffers.empty()) ReleaseVolumeSnapshotUploads(vk.device, resources);
+
                 resources.enabled = config.ddgi.enabled;
                 if (resources.enabled)
                 {
@@ -1616,35 +1643,72 @@ namespace Graphics
                         resources.numVolumeVariabilitySamples[config.ddgi.selectedVolume] = 0;
                     }
 
-                    // Select the active volumes
-                    resources.selectedVolumes.clear();
-                    for (UINT volumeIndex = 0; volumeIndex < static_cast<UINT>(resources.volumes.size()); volumeIndex++)
+                    // Find the volumes that need updates
+                    uint32_t numVolumes = static_cast<uint32_t>(resources.volumes.size());
+                    resources.volumeUpdateEnabled.resize(numVolumes);
+                    resources.scheduledVolumeIndices.resize(numVolumes);
+                    for (uint32_t volumeIndex = 0; volumeIndex < numVolumes; volumeIndex++)
                     {
-                        // TODO: processing to determine which volumes are in-frustum, active, and prioritized for update / render
-
                         // Get the volume
                         DDGIVolume* volume = static_cast<DDGIVolume*>(resources.volumes[volumeIndex]);
 
                         // If the scene's lights, skylight, or geometry have changed *or* the volume moves *or the probes are reset, reset variability
                         if (config.ddgi.volumes[volumeIndex].clearProbeVariability) resources.numVolumeVariabilitySamples[volumeIndex] = 0;
 
+                        // Scene changes reset some of the volume's probes (see UpdateSceneChanges()), so the volume is no longer converged
+                        if (volume->GetProbeResetPending()) resources.numVolumeVariabilitySamples[volumeIndex] = 0;
+
                         // Skip volumes whose variability measurement is low enough to be considered converged
                         // Enforce a minimum of 16 samples to filter out early outliers
                         const uint32_t MinimumVariabilitySamples = 16;
-                        float volumeAverageVariability = volume->GetVolumeAverageVariability();
+                        // Only count variability values that have not been counted before (readbacks lag the GPU by a few frames)
+                        uint64_t variabilityFrame;
+                        float volumeAverageVariability = volume->GetVolumeAverageVariability(variabilityFrame);
+                        if (variabilityFrame != RTXGI_DDGI_VARIABILITY_READBACK_INVALID_FRAME && variabilityFrame != resources.volumeVariabilityFrames[volumeIndex])
+                        {
+                            resources.volumeVariabilityFrames[volumeIndex] = variabilityFrame;
+                            resources.numVolumeVariabilitySamples[volumeIndex]++;
+                        }
+
                         bool isConverged = volume->GetProbeVariabilityEnabled()
-                                                && (resources.numVolumeVariabilitySamples[volumeIndex]++ > MinimumVariabilitySamples)
-                                                && (volumeAverageVariability < config.ddgi.volumes[config.ddgi.selectedVolume].probeVariabilityThreshold);
-                        
-                        // Add the volume to the list of volumes to update (it hasn't converged)
-                        if (!isConverged) resources.selectedVolumes.push_back(volume);
+                                                && (resources.numVolumeVariabilitySamples[volumeIndex] > MinimumVariabilitySamples)
+                                                && (volumeAverageVariability < config.ddgi.volumes[volumeIndex].probeVariabilityThreshold);
+
+                        // Volumes with updates disabled (e.g. by a benchmark scenario) keep their current probe data
+                        resources.volumeUpdateEnabled[volumeIndex] = (isConverged || !config.ddgi.volumes[volumeIndex].updateEnabled) ? 0 : 1;
                     }
 
-                    // Update the DDGIVolume constants
-                    for (uint32_t volumeIndex = 0; volumeIndex < static_cast<uint32_t>(resources.selectedVolumes.size()); volumeIndex++)
+                    // Prioritize the volumes that haven't converged by visibility, distance, variability, and time since their last update
+                    // and select the volumes to update this frame within the ray budget
+                    const Camera& camera = vkResources.camera;
+                    DDGIVolumeSchedulerInputs schedulerInputs = {};
+                    schedulerInputs.cameraPosition = camera.position;
+                    schedulerInputs.frustum = ComputeDDGIFrustum(camera.position, camera.forward, camera.right, camera.up, camera.tanHalfFovY, camera.aspect);
+                    schedulerInputs.rayBudget = config.ddgi.rayBudget;
+
+                    uint32_t numScheduledVolumes = resources.volumeScheduler.Schedule(
+                        schedulerInputs,
+                        numVolumes,
+                        resources.volumes.data(),
+                        resources.volumeUpdateEnabled.data(),
+                        resources.scheduledVolumeIndices.data());
+
+                    // Add the scheduled volumes to the list of volumes to update (highest priority first)
+                    resources.selectedVolumes.clear();
+                    for (uint32_t scheduledIndex = 0; scheduledIndex < numScheduledVolumes; scheduledIndex++)
                     {
-                        resources.selectedVolumes[volumeIndex]->Update();
+                        uint32_t volumeIndex = resources.scheduledVolumeIndices[scheduledIndex];
+                        resources.selectedVolumes.push_back(static_cast<DDGIVolume*>(resources.volumes[volumeIndex]));
                     }
+
+                    // Update and pack the DDGIVolume constants in parallel
+                    resources.selectedVolumeDescs.resize(numScheduledVolumes);
+                    rtxgi::UpdateDDGIVolumes(
+                        resources.volumeUpdateThreadPool,
+                        numScheduledVolumes,
+                        resources.volumes.data(),
+                        resources.scheduledVolumeIndices.data(),
+                        resources.selectedVolumeDescs.data());
                 }
                 CPU_TIMESTAMP_END(resources.cpuStat);
             }
@@ -1665,7 +1729,7 @@ namespace Graphics
 
                     // Upload volume resource indices and constants
                     rtxgi::vulkan::UploadDDGIVolumeResourceIndices(vk.device, vk.cmdBuffer[vk.frameIndex], vk.frameIndex, numVolumes, resources.selectedVolumes.data());
-                    rtxgi::vulkan::UploadDDGIVolumeConstants(vk.device, vk.cmdBuffer[vk.frameIndex], vk.frameIndex, numVolumes, resources.selectedVolumes.data());
+                    rtxgi::vulkan::UploadDDGIVolumeConstants(vk.device, vk.cmdBuffer[vk.frameIndex], vk.frameIndex, numVolumes, resources.selectedVolumes.data(), resources.selectedVolumeDescs.data());
 
                     // Trace rays from DDGI probes to sample the environment
                     GPU_TIMESTAMP_BEGIN(resources.rtStat->GetGPUQueryBeginIndex());
@@ -1689,9 +1753,10 @@ namespace Graphics
 
                     // Calculate variability
                     GPU_TIMESTAMP_BEGIN(resources.variabilityStat->GetGPUQueryBeginIndex());
-                    rtxgi::vulkan::CalculateDDGIVolumeVariability(vk.cmdBuffer[vk.frameIndex], numVolumes, resources.selectedVolumes.data());
-                    // The readback happens immediately, not recorded on the command list, so will return a value from a previous update
-                    rtxgi::vulkan::ReadbackDDGIVolumeVariability(vk.device, numVolumes, resources.selectedVolumes.data());
+                    rtxgi::vulkan::CalculateDDGIVolumeVariability(vk.cmdBuffer[vk.frameIndex], numVolumes, resources.selectedVolumes.data(), resources.variabilityFrameIndex);
+                    // The readback happens immediately, not recorded on the command list, so will return the newest value the GPU has finished writing
+                    rtxgi::vulkan::ReadbackDDGIVolumeVariability(vk.device, numVolumes, resources.selectedVolumes.data(), resources.variabilityFrameIndex);
+                    resources.variabilityFrameIndex++;
                     GPU_TIMESTAMP_END(resources.variabilityStat->GetGPUQueryEndIndex());
 
                     // Render the indirect lighting to screen-space
@@ -1723,6 +1788,9 @@ namespace Graphics
                 vkDestroyBuffer(device, resources.shaderTable, nullptr);
                 vkFreeMemory(device, resources.shaderTableMemory, nullptr);
 
+                // Snapshot Uploads
+                ReleaseVolumeSnapshotUploads(device, resources);
+
                 // Pipelines
                 vkDestroyPipeline(device, resources.rtPipeline, nullptr);
                 vkDestroyPipeline(device, resources.indirectPipeline, nullptr);
@@ -1745,12 +1813,14 @@ namespace Graphics
                 // Resource Indices
                 vkDestroyBuffer(device, resources.volumeResourceIndicesSTBUpload, nullptr);
                 vkFreeMemory(device, resources.volumeResourceIndicesSTBUploadMemory, nullptr);
+                resources.volumeResourceIndicesSTBUploadPtr = nullptr;
                 vkDestroyBuffer(device, resources.volumeResourceIndicesSTB, nullptr);
                 vkFreeMemory(device, resources.volumeResourceIndicesSTBMemory, nullptr);
 
                 // Constants
                 vkDestroyBuffer(device, resources.volumeConstantsSTBUpload, nullptr);
                 vkFreeMemory(device, resources.volumeConstantsSTBUploadMemory, nullptr);
+                resources.volumeConstantsSTBUploadPtr = nullptr;
                 vkDestroyBuffer(device, resources.volumeConstantsSTB, nullptr);
                 vkFreeMemory(device, resources.volumeConstantsSTBMemory, nullptr);
 
@@ -1827,6 +1897,39 @@ namespace Graphics
                 return success;
             }
 
+            /**
+             * Write snapshots of the DDGI Volumes' probe data to disk.
+             */
+            bool WriteVolumeSnapshots(Globals& vk, GlobalResources& vkResources, Resources& resources, std::string directory, bool compress)
+            {
+                bool success = true;
+                for (size_t volumeIndex = 0; volumeIndex < resources.volumes.size(); volumeIndex++)
+                {
+                    // Get the volume
+                    const DDGIVolume* volume = static_cast<DDGIVolume*>(resources.volumes[volumeIndex]);
+
+                    DDGIVolumeSnapshot snapshot;
+                    if (snapshot.Capture(volume) != ERTXGIStatus::OK) { success = false; continue; }
+
+                    // Read back the volume's textures
+                    bool read = true;
+                    for (uint32_t textureIndex = 0; textureIndex < static_cast<uint32_t>(EDDGIVolumeTextureType::Count); textureIndex++)
+                    {
+                        EDDGIVolumeTextureType type = static_cast<EDDGIVolumeTextureType>(textureIndex);
+                        if (!snapshot.HasTexture(type)) continue;
+
+                        uint32_t width, height, arraySize;
+                        snapshot.GetTextureDimensions(type, width, height, arraySize);
+                        uint32_t texelSize = GetDDGIVolumeTextureFormatSize(snapshot.GetTextureFormat(type));
+                        read &= ReadResourceTexels(vk, GetDDGIVolumeTexture(volume, type), width, height, arraySize, texelSize, VK_IMAGE_LAYOUT_GENERAL, snapshot.GetTextureData(type));
+                    }
+
+                    if (read) success &= Graphics::DDGI::WriteVolumeSnapshot(snapshot, Graphics::DDGI::GetVolumeSnapshotFile(directory, volume), compress);
+                    else success = false;
+                }
+                return success;
+            }
+
         } // namespace Graphics::Vulkan::DDGI
 
     } // namespace Graphics::Vulkan
@@ -1869,5 +1972,10 @@ namespace Graphics
             return Graphics::Vulkan::DDGI::WriteVolumesToDisk(vk, vkResources, resources, directory);
         }
 
+        bool WriteVolumeSnapshots(Globals& vk, GlobalResources& vkResources, Resources& resources, std::string directory, bool compress)
+        {
+            return Graphics::Vulkan::DDGI::WriteVolumeSnapshots(vk, vkResources, resources, directory, compress);
+        }
+
     } // namespace Graphics::DDGI
 }
@@ -546,7 +546,7 @@ namespace Graphics
                 // Transition the back buffer layout to transfer destination
                 barrier =
                 {
-                    VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                    vk.swapChainImageLayout,
                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                     VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                     VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
@@ -565,7 +565,7 @@ namespace Graphics
                 barrier =
                 {
                     VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                    VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+                    vk.swapChainImageLayout,
                     VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                     VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
                     { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 }
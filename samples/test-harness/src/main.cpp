@@ -21,6 +21,7 @@
 #include "graphics/PathTracing.h"
 #include "graphics/GBuffer.h"
 #include "graphics/DDGI.h"
+#include "graphics/DDGIReference.h"
 #include "graphics/DDGIVisualizations.h"
 #include "graphics/RTAO.h"
 #include "graphics/Composite.h"
@@ -32,7 +33,7 @@ extern "C" { __declspec(dllexport) extern const UINT D3D12SDKVersion = 606; }
 extern "C" { __declspec(dllexport) extern const char* D3D12SDKPath = u8".\\D3D12\\"; }
 #endif
 
-void StoreImages(
+bool StoreImages(
     Inputs::EInputEvent& event,
     Configs::Config& config,
     Graphics::Globals& gfx,
@@ -40,22 +41,135 @@ void StoreImages(
     Graphics::RTAO::Resources& rtao,
     Graphics::DDGI::Resources& ddgi)
 {
-    if(config.app.benchmarkRunning) return; // Not allowed while benchmark is running
+    if(config.app.benchmarkRunning) return true; // Not allowed while benchmark is running
 
     std::filesystem::create_directories(config.scene.screenshotPath.c_str());
 
+    bool result = true;
     if (event == Inputs::EInputEvent::SCREENSHOT)
     {
-        Graphics::WriteBackBufferToDisk(gfx, config.scene.screenshotPath);
+        result &= Graphics::WriteBackBufferToDisk(gfx, config.scene.screenshotPath);
         event = Inputs::EInputEvent::NONE;
     }
     else if (event == Inputs::EInputEvent::SAVE_IMAGES)
     {
-        Graphics::GBuffer::WriteGBufferToDisk(gfx, gfxResources, config.scene.screenshotPath);
-        Graphics::RTAO::WriteRTAOBuffersToDisk(gfx, gfxResources, rtao, config.scene.screenshotPath);
-        Graphics::DDGI::WriteVolumesToDisk(gfx, gfxResources, ddgi, config.scene.screenshotPath);
+        result &= Graphics::GBuffer::WriteGBufferToDisk(gfx, gfxResources, config.scene.screenshotPath);
+        result &= Graphics::RTAO::WriteRTAOBuffersToDisk(gfx, gfxResources, rtao, config.scene.screenshotPath);
+        result &= Graphics::DDGI::WriteVolumesToDisk(gfx, gfxResources, ddgi, config.scene.screenshotPath);
         event = Inputs::EInputEvent::NONE;
     }
+    return result;
+}
+
+/**
+ * Write the back buffer and the intermediate images (GBuffer, RTAO, and DDGIVolume textures) to disk.
+ */
+bool StoreAllImages(
+    Configs::Config& config,
+    Graphics::Globals& gfx,
+    Graphics::GlobalResources& gfxResources,
+    Graphics::RTAO::Resources& rtao,
+    Graphics::DDGI::Resources& ddgi)
+{
+    Inputs::EInputEvent e = Inputs::EInputEvent::SCREENSHOT;
+    bool result = StoreImages(e, config, gfx, gfxResources, rtao, ddgi);
+
+    e = Inputs::EInputEvent::SAVE_IMAGES;
+    result &= StoreImages(e, config, gfx, gfxResources, rtao, ddgi);
+    return result;
+}
+
+/**
+ * Write snapshots of the DDGIVolumes' probe data, to be loaded at the next initialization.
+ * Only written on user request, so benchmark runs don't change the snapshots they start from.
+ */
+void StoreVolumeSnapshots(
+    Configs::Config& config,
+    Graphics::Globals& gfx,
+    Graphics::GlobalResources& gfxResources,
+    Graphics::DDGI::Resources& ddgi,
+    std::ofstream& log)
+{
+    if (config.app.benchmarkRunning || config.ddgi.snapshotPath.empty()) return;
+
+    std::filesystem::create_directories(config.ddgi.snapshotPath.c_str());
+    if (!Graphics::DDGI::WriteVolumeSnapshots(gfx, gfxResources, ddgi, config.ddgi.snapshotPath, config.ddgi.snapshotCompression))
+    {
+        log << "\nWarning: failed to write the DDGIVolume snapshots!";
+    }
+}
+
+/**
+ * Initialize the graphics workloads.
+ */
+bool InitializeWorkloads(
+    Configs::Config& config,
+    Graphics::Globals& gfx,
+    Graphics::GlobalResources& gfxResources,
+    Graphics::PathTracing::Resources& pt,
+    Graphics::GBuffer::Resources& gbuffer,
+    Graphics::DDGI::Resources& ddgi,
+    Graphics::DDGI::Visualizations::Resources& ddgiVis,
+    Graphics::RTAO::Resources& rtao,
+    Graphics::Composite::Resources& composite,
+    Instrumentation::Performance& perf,
+    std::ofstream& log)
+{
+    CHECK(Graphics::PathTracing::Initialize(gfx, gfxResources, pt, perf, log), "initialize path tracing workload!\n", log);
+    CHECK(Graphics::GBuffer::Initialize(gfx, gfxResources, gbuffer, perf, log), "initialize gbuffer workload!\n", log);
+    CHECK(Graphics::DDGI::Initialize(gfx, gfxResources, ddgi, config, perf, log), "initialize dynamic diffuse global illumination workload!\n", log);
+    CHECK(Graphics::DDGI::Visualizations::Initialize(gfx, gfxResources, ddgi, ddgiVis, perf, config, log), "initialize dynamic diffuse global illumination visualization workload!\n", log);
+    CHECK(Graphics::RTAO::Initialize(gfx, gfxResources, rtao, perf, log), "initialize ray traced ambient occlusion workload!\n", log);
+    CHECK(Graphics::Composite::Initialize(gfx, gfxResources, composite, perf, log), "initialize composition workload!\n", log);
+    return true;
+}
+
+/**
+ * Run the stages that don't need a graphics device (--no-gpu): scene loading and texture compression,
+ * DDGIVolume setup, and the CPU reference probe blending.
+ */
+int RunWithoutGPU(Configs::Config& config, std::ofstream& log)
+{
+    Scenes::Scene scene;
+
+#ifdef GPU_COMPRESSION
+    // Initialize the texture system
+    log << "Initializing texture system...";
+    if (!Textures::Initialize())
+    {
+        log << "\nFailed to initialize texture system!";
+        log.close();
+        return EXIT_FAILURE;
+    }
+    log << "done.\n";
+#endif
+
+    // Initialize the scene
+    log << "Initializing the scene...";
+    bool result = Scenes::Initialize(config, scene, log);
+    if (result)
+    {
+        log << "done.\n";
+
+        // Blend the DDGIVolume probes on the CPU
+        log << "Blending probes on the CPU...";
+        result = Graphics::DDGI::Reference::Run(config, config.app.numFrames, log);
+        log << (result ? "\ndone.\n" : "\nFailed to blend probes on the CPU!\n");
+    }
+    else
+    {
+        log << "\nFailed to initialize the scene!";
+    }
+
+    Scenes::Cleanup(scene);
+#ifdef GPU_COMPRESSION
+    Textures::Cleanup();
+#endif
+
+    log << "Done.\n";
+    log.close();
+
+    return result ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
 /**
@@ -70,6 +184,7 @@ int Run(const std::vector<std::string>& arguments)
     // Global Data Structures
     Configs::Config config;
     Scenes::Scene scene;
+    rtxgi::DDGIThreadPool sceneThreadPool;  // scene graph transform updates
 
     // Graphics Globals
     Graphics::Globals gfx;
@@ -101,7 +216,12 @@ int Run(const std::vector<std::string>& arguments)
 
     // Parse the command line and get the config file path
     log << "Parsing command line...";
-    if (!Configs::ParseCommandLine(arguments, config, log))
+    bool parsed = Configs::ParseCommandLine(arguments, config, log);
+
+    // Headless runs print errors instead of waiting on message boxes
+    Graphics::UI::s_headless = config.app.headless;
+
+    if (!parsed)
     {
         log << "Failed to parse the command line!";
         log.close();
@@ -118,27 +238,42 @@ int Run(const std::vector<std::string>& arguments)
     }
     log << "done.\n";
 
-    // Create a window
-    log << "Creating a window...";
-    if(!Windows::Create(config, gfx.window))
+#ifndef GFX_PERF_INSTRUMENTATION
+    if (config.app.runBenchmark)
     {
-        log << "\nFailed to create the window!";
+        log << "\nError: the benchmark requires GFX_PERF_INSTRUMENTATION!";
         log.close();
         return EXIT_FAILURE;
     }
+#endif
 
-    log << "done.\n";
+    // Run the CPU stages only
+    if (config.app.noGPU) return RunWithoutGPU(config, log);
 
-    // Input
-    log << "Initializing input system...";
     Inputs::Input input;
-    if(!Inputs::Initialize(gfx.window, input, config, scene))
+    if (!config.app.headless)
     {
-        log << "\nFailed to initialize input!";
-        log.close();
-        return EXIT_FAILURE;
+        // Create a window
+        log << "Creating a window...";
+        if(!Windows::Create(config, gfx.window))
+        {
+            log << "\nFailed to create the window!";
+            log.close();
+            return EXIT_FAILURE;
+        }
+
+        log << "done.\n";
+
+        // Input
+        log << "Initializing input system...";
+        if(!Inputs::Initialize(gfx.window, input, config, scene))
+        {
+            log << "\nFailed to initialize input!";
+            log.close();
+            return EXIT_FAILURE;
+        }
+        log << "done.\n";
     }
-    log << "done.\n";
 
     // Create a device
     log << "Creating graphics device...";
@@ -182,22 +317,24 @@ int Run(const std::vector<std::string>& arguments)
     }
 
     // Initialize the graphics workloads
-    CHECK(Graphics::PathTracing::Initialize(gfx, gfxResources, pt, perf, log), "initialize path tracing workload!\n", log);
-    CHECK(Graphics::GBuffer::Initialize(gfx, gfxResources, gbuffer, perf, log), "initialize gbuffer workload!\n", log);
-    CHECK(Graphics::DDGI::Initialize(gfx, gfxResources, ddgi, config, perf, log), "initialize dynamic diffuse global illumination workload!\n", log);
-    CHECK(Graphics::DDGI::Visualizations::Initialize(gfx, gfxResources, ddgi, ddgiVis, perf, config, log), "initialize dynamic diffuse global illumination visualization workload!\n", log);
-    CHECK(Graphics::RTAO::Initialize(gfx, gfxResources, rtao, perf, log), "initialize ray traced ambient occlusion workload!\n", log);
-    CHECK(Graphics::Composite::Initialize(gfx, gfxResources, composite, perf, log), "initialize composition workload!\n", log);
-
-    // Initialize the user interface system
-    log << "Initializing user interface...";
-    if (!Graphics::UI::Initialize(gfx, gfxResources, ui, perf, log))
+    if (!InitializeWorkloads(config, gfx, gfxResources, pt, gbuffer, ddgi, ddgiVis, rtao, composite, perf, log))
     {
-        log << "\nFailed to initialize user interface!";
         log.close();
         return EXIT_FAILURE;
     }
-    log << "done.\n";
+
+    if (!config.app.headless)
+    {
+        // Initialize the user interface system
+        log << "Initializing user interface...";
+        if (!Graphics::UI::Initialize(gfx, gfxResources, ui, perf, log))
+        {
+            log << "\nFailed to initialize user interface!";
+            log.close();
+            return EXIT_FAILURE;
+        }
+        log << "done.\n";
+    }
 
     log << "Post initialization...";
     if (!Graphics::PostInitialize(gfx, log))
@@ -212,6 +349,7 @@ int Run(const std::vector<std::string>& arguments)
     Instrumentation::Stat* timestampEndStat = perf.AddCPUStat("TimestampEnd");
     Instrumentation::Stat* submitStat = perf.AddCPUStat("Submit");
     Instrumentation::Stat* presentStat = perf.AddCPUStat("Present");
+    Instrumentation::Stat* sceneJobsStat = perf.AddCPUStat("Scene Jobs");   // recorded by scene update jobs, on all threads
 
     CPU_TIMESTAMP_END(&startupShutdown);
     log << "Startup complete in " << startupShutdown.elapsed << " milliseconds\n";
@@ -219,8 +357,16 @@ int Run(const std::vector<std::string>& arguments)
     log << "Main loop...\n";
     std::flush(log);
 
+    // Start the benchmark with the first frame (--benchmark)
+    if (config.app.runBenchmark) input.event = Inputs::EInputEvent::RUN_BENCHMARK;
+
+    // Runs with --frames or --benchmark fail unless they finish their frames
+    bool scripted = (config.app.numFrames > 0 || config.app.runBenchmark);
+    bool completed = false;
+    uint32_t numFramesRendered = 0;
+
     // Main loop
-    while(!glfwWindowShouldClose(gfx.window))
+    while(config.app.headless || !glfwWindowShouldClose(gfx.window))
     {
         CPU_TIMESTAMP_BEGIN(frameStat);
 
@@ -272,7 +418,7 @@ int Run(const std::vector<std::string>& arguments)
 
         CPU_TIMESTAMP_BEGIN(inputStat);
 
-        glfwPollEvents();
+        if (!config.app.headless) glfwPollEvents();
 
         // Exit the application
         if (input.event == Inputs::EInputEvent::QUIT) break;
@@ -280,12 +426,12 @@ int Run(const std::vector<std::string>& arguments)
         // Initialize the benchmark
         if (!config.app.benchmarkRunning && input.event == Inputs::EInputEvent::RUN_BENCHMARK)
         {
-            Benchmark::StartBenchmark(benchmarkRun, perf, config, gfx);
+            Benchmark::StartBenchmark(benchmarkRun, perf, config, scene, ddgi.volumes, gfx);
             input.event = Inputs::EInputEvent::NONE;
         }
 
         // Handle mouse and keyboard input
-        Inputs::PollInputs(gfx.window);
+        if (!config.app.headless) Inputs::PollInputs(gfx.window);
 
         // Reset the frame number on camera movement (for path tracer accumulation reset)
         if (input.event == Inputs::EInputEvent::CAMERA_MOVEMENT)
@@ -294,10 +440,17 @@ int Run(const std::vector<std::string>& arguments)
             input.event = Inputs::EInputEvent::NONE;
         }
 
+        // Advance the benchmark scenario (camera path, light changes, and volume toggles)
+        if (config.app.benchmarkRunning) Benchmark::UpdateScenario(benchmarkRun, config, scene, ddgi.volumes, gfx);
+
         CPU_TIMESTAMP_ENDANDRESOLVE(inputStat);
 
         // Update the simulation / constant buffers
         CPU_TIMESTAMP_BEGIN(updateStat);
+        Scenes::UpdateTransforms(scene, &sceneThreadPool, sceneJobsStat);
+        CPU_TIMESTAMP_RESOLVESCOPED(sceneJobsStat);
+        if (!scene.changedInstances.empty()) gfx.frameNumber = 1; // path tracer accumulation reset
+        Graphics::DDGI::UpdateSceneChanges(ddgi, config, scene);
         Graphics::Update(gfx, gfxResources, config, scene);
         CPU_TIMESTAMP_ENDANDRESOLVE(updateStat);
 
@@ -329,11 +482,14 @@ int Run(const std::vector<std::string>& arguments)
             Graphics::Composite::Execute(gfx, gfxResources, composite);
         }
 
-        // UI
-        CPU_TIMESTAMP_BEGIN(perf.cpuTimes[Instrumentation::EStatIndex::UI]);
-        Graphics::UI::Update(gfx, ui, config, input, scene, ddgi.volumes, perf);
-        Graphics::UI::Execute(gfx, gfxResources, ui, config);
-        CPU_TIMESTAMP_ENDANDRESOLVE(perf.cpuTimes[Instrumentation::EStatIndex::UI]);
+        // UI (headless runs don't have a UI, or its CPU stat)
+        if (!config.app.headless)
+        {
+            CPU_TIMESTAMP_BEGIN(perf.cpuTimes[Instrumentation::EStatIndex::UI]);
+            Graphics::UI::Update(gfx, ui, config, input, scene, ddgi.volumes, perf);
+            Graphics::UI::Execute(gfx, gfxResources, ui, config);
+            CPU_TIMESTAMP_ENDANDRESOLVE(perf.cpuTimes[Instrumentation::EStatIndex::UI]);
+        }
 
         // GPU Timestamps
         CPU_TIMESTAMP_BEGIN(timestampEndStat);
@@ -390,23 +546,35 @@ int Run(const std::vector<std::string>& arguments)
         // Image Capture (user triggered)
         if (input.event == Inputs::EInputEvent::SAVE_IMAGES || input.event == Inputs::EInputEvent::SCREENSHOT)
         {
+            if (input.event == Inputs::EInputEvent::SAVE_IMAGES) StoreVolumeSnapshots(config, gfx, gfxResources, ddgi, log);
             StoreImages(input.event, config, gfx, gfxResources, rtao, ddgi);
         }
 
     #ifdef GFX_PERF_INSTRUMENTATION
         if (config.app.benchmarkRunning)
         {
-            if (Benchmark::UpdateBenchmark(benchmarkRun, perf, config, gfx, log))
+            if (Benchmark::UpdateBenchmark(benchmarkRun, perf, config, scene, ddgi.volumes, gfx, log))
             {
                 // Store intermediate images when the benchmark ends
-                Inputs::EInputEvent e = Inputs::EInputEvent::SCREENSHOT;
-                StoreImages(e, config, gfx, gfxResources, rtao, ddgi);
-
-                e = Inputs::EInputEvent::SAVE_IMAGES;
-                StoreImages(e, config, gfx, gfxResources, rtao, ddgi);
+                bool stored = StoreAllImages(config, gfx, gfxResources, rtao, ddgi);
+
+                // Exit when the benchmark started from the command line is done
+                if (config.app.runBenchmark)
+                {
+                    completed = stored;
+                    break;
+                }
             }
         }
     #endif
+
+        // Store the images and exit after the requested number of frames (--frames, unless benchmarking)
+        numFramesRendered++;
+        if (!config.app.runBenchmark && numFramesRendered == config.app.numFrames)
+        {
+            completed = StoreAllImages(config, gfx, gfxResources, rtao, ddgi);
+            break;
+        }
     }
 
     Graphics::WaitForGPU(gfx);
@@ -417,7 +585,7 @@ int Run(const std::vector<std::string>& arguments)
 
     perf.Cleanup();
 
-    Graphics::UI::Cleanup();
+    if (!config.app.headless) Graphics::UI::Cleanup();
     Graphics::Composite::Cleanup(gfx, composite);
     Graphics::RTAO::Cleanup(gfx, rtao);
     Graphics::DDGI::Visualizations::Cleanup(gfx, ddgiVis);
@@ -430,15 +598,17 @@ int Run(const std::vector<std::string>& arguments)
     Textures::Cleanup();
 #endif
 
-    Windows::Close(gfx.window);
+    if (!config.app.headless) Windows::Close(gfx.window);
 
     CPU_TIMESTAMP_END(&startupShutdown);
     log << "Shutdown complete in " << startupShutdown.elapsed << " milliseconds\n";
 
+    if (scripted && !completed) log << "Error: the run ended before it completed!\n";
+
     log << "Done.\n";
     log.close();
 
-    return EXIT_SUCCESS;
+    return (scripted && !completed) ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 /**
@@ -490,13 +660,13 @@ int main(int argc, char* argv[])
     // Run the application
     int result = Run(arguments);
 
-    // If an error occurred, spawn a message box
+    // If an error occurred, spawn a message box (headless runs print the message instead)
     if (result != EXIT_SUCCESS)
     {
         std::string msg = "An error occurred. See log.txt for details.";
         Graphics::UI::MessageBox(msg);
     }
 
-    return EXIT_SUCCESS;
+    return result;
 }
 
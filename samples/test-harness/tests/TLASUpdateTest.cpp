@@ -0,0 +1,213 @@
+/*
+* Copyright (c) 2019-2023, NVIDIA CORPORATION.  All rights reserved.
+*
+* NVIDIA CORPORATION and its licensors retain all intellectual property
+* and proprietary rights in and to this software, related documentation
+* and any modifications thereto.  Any use, reproduction, disclosure or
+* distribution of this software and related documentation without an express
+* license agreement from NVIDIA CORPORATION is strictly prohibited.
+*/
+
+// Unit test of the scene TLAS change detection and refit / rebuild policy (AccelerationStructures::Update()).
+// Usage: TestHarness-TLASUpdateTest
+
+#include "AccelerationStructures.h"
+
+#include "UnitTest.h"
+
+using namespace AccelerationStructures;
+
+namespace
+{
+    /**
+     * Returns true when the ranges match the expected { first, count } pairs.
+     */
+    bool IsRanges(const std::vector<InstanceRange>& ranges, const std::vector<InstanceRange>& expected)
+    {
+        if (ranges.size() != expected.size()) return false;
+        for (size_t rangeIndex = 0; rangeIndex < ranges.size(); rangeIndex++)
+        {
+            if (ranges[rangeIndex].first != expected[rangeIndex].first) return false;
+            if (ranges[rangeIndex].count != expected[rangeIndex].count) return false;
+        }
+        return true;
+    }
+
+    /**
+     * A scene of unit cube instances spaced along the X axis. The scene bounding box diagonal is 10.
+     */
+    void CreateScene(Scenes::Scene& scene, uint32_t numInstances)
+    {
+        scene.instances.resize(numInstances);
+        for (uint32_t instanceIndex = 0; instanceIndex < numInstances; instanceIndex++)
+        {
+            float x = static_cast<float>(instanceIndex * 2);
+            scene.instances[instanceIndex].boundingBox = { { x, 0.f, 0.f }, { x + 1.f, 1.f, 1.f } };
+        }
+        scene.boundingBox = { { 0.f, 0.f, 0.f }, { 10.f, 0.f, 0.f } };
+        scene.changedInstances.clear();
+    }
+
+    /**
+     * Move an instance along the X axis (to an offset from its initial position) and mark it changed.
+     */
+    void MoveInstance(Scenes::Scene& scene, uint32_t instanceIndex, float offset)
+    {
+        float x = static_cast<float>(instanceIndex * 2) + offset;
+        scene.instances[instanceIndex].boundingBox = { { x, 0.f, 0.f }, { x + 1.f, 1.f, 1.f } };
+        scene.changedInstances = { instanceIndex };
+    }
+
+    /**
+     * Changed instance indices coalesce into contiguous ranges.
+     */
+    void TestInstanceRanges()
+    {
+        std::vector<InstanceRange> ranges = { { 5, 5 } };
+
+        GetInstanceRanges({}, ranges);
+        EXPECT(ranges.empty());
+
+        GetInstanceRanges({ 0 }, ranges);
+        EXPECT(IsRanges(ranges, { { 0, 1 } }));
+
+        GetInstanceRanges({ 0, 1, 2, 3 }, ranges);
+        EXPECT(IsRanges(ranges, { { 0, 4 } }));
+
+        GetInstanceRanges({ 1, 2, 3, 7, 9, 10 }, ranges);
+        EXPECT(IsRanges(ranges, { { 1, 3 }, { 7, 1 }, { 9, 2 } }));
+
+        GetInstanceRanges({ 2, 4, 6 }, ranges);
+        EXPECT(IsRanges(ranges, { { 2, 1 }, { 4, 1 }, { 6, 1 } }));
+    }
+
+    /**
+     * Unchanged scenes need no update, small motion refits, and motion past tlasRebuildMotion rebuilds.
+     */
+    void TestMotionThreshold()
+    {
+        Scenes::Scene scene;
+        CreateScene(scene, 4);
+
+        TLASUpdateState state;
+        Reset(state, scene);
+
+        TLASPolicy policy;
+        policy.maxMotion = 0.5f;
+
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::NONE);
+        EXPECT(state.ranges.empty());
+        EXPECT(state.numUpdates == 0);
+
+        // 0.2 scene diagonals
+        MoveInstance(scene, 1, 2.f);
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REFIT);
+        EXPECT(IsRanges(state.ranges, { { 1, 1 } }));
+        EXPECT(state.GetMotion() == 0.2f);
+        EXPECT(state.numRefits == 1);
+
+        // Motion is measured from the last build, not accumulated per update: moving back removes it
+        MoveInstance(scene, 1, 0.f);
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REFIT);
+        EXPECT(state.GetMotion() == 0.f);
+
+        // Exactly at the threshold still refits
+        MoveInstance(scene, 2, 5.f);
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REFIT);
+        EXPECT(state.GetMotion() == 0.5f);
+        EXPECT(state.numRefits == 3);
+
+        // Motion of several instances adds up past the threshold
+        MoveInstance(scene, 3, 1.f);
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REBUILD);
+        EXPECT(state.numRebuilds == 1);
+        EXPECT(state.numUpdates == 4);
+    }
+
+    /**
+     * A rebuild makes the current instance bounding boxes the new reference for motion.
+     */
+    void TestResetAfterRebuild()
+    {
+        Scenes::Scene scene;
+        CreateScene(scene, 4);
+
+        TLASUpdateState state;
+        Reset(state, scene);
+
+        TLASPolicy policy;
+        policy.maxMotion = 0.5f;
+
+        MoveInstance(scene, 0, 6.f);
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REBUILD);
+        EXPECT(state.numRefits == 0);
+        EXPECT(state.GetMotion() == 0.f);
+        EXPECT(state.builtBoxes[0].min.x == 6.f);
+
+        // Small motion relative to the rebuilt TLAS refits
+        MoveInstance(scene, 0, 7.f);
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REFIT);
+        EXPECT(state.GetMotion() == 0.1f);
+
+        // Instances added or removed rebuild
+        CreateScene(scene, 5);
+        scene.changedInstances = { 4 };
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REBUILD);
+        EXPECT(state.builtBoxes.size() == 5);
+        EXPECT(state.motion.size() == 5);
+        EXPECT(state.numRefits == 0);
+        EXPECT(state.numRebuilds == 2);
+    }
+
+    /**
+     * tlasRebuildInterval rebuilds after a number of refits, whatever the motion. 0 doesn't limit refits.
+     */
+    void TestRefitInterval()
+    {
+        Scenes::Scene scene;
+        CreateScene(scene, 4);
+
+        TLASUpdateState state;
+        Reset(state, scene);
+
+        TLASPolicy policy;
+        policy.maxMotion = 0.5f;
+        policy.maxRefits = 3;
+
+        MoveInstance(scene, 2, 0.1f);
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REFIT);
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REFIT);
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REFIT);
+        EXPECT(state.numRefits == 3);
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REBUILD);
+        EXPECT(state.numRefits == 0);
+
+        // The interval restarts after the rebuild
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::REFIT);
+        EXPECT(state.numRefits == 1);
+
+        // Unchanged frames don't count as refits
+        scene.changedInstances.clear();
+        EXPECT(Update(state, policy, scene) == ETLASUpdate::NONE);
+        EXPECT(state.numRefits == 1);
+
+        policy.maxRefits = 0;
+        scene.changedInstances = { 2 };
+        for (uint32_t updateIndex = 0; updateIndex < 100; updateIndex++)
+        {
+            EXPECT(Update(state, policy, scene) == ETLASUpdate::REFIT);
+        }
+        EXPECT(state.numRefits == 101);
+        EXPECT(state.numRebuilds == 1);
+    }
+}
+
+int main()
+{
+    TestInstanceRanges();
+    TestMotionThreshold();
+    TestResetAfterRebuild();
+    TestRefitInterval();
+
+    return UnitTest::Finish();
+}